@@ -0,0 +1,117 @@
+/**
+ * @file ChannelHopper.h
+ * @brief Saut de canal synchronisé sur l'heure GPS (bateau)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Saut de canal synchronisé sur l'heure GPS (clés de configuration 21 et
+ * 22, plan commun dans lib/BoatProtocol/ChannelHop.h).
+ *
+ * L'heure vient de l'horloge disciplinée de TimeBeacon : à chaque loop(),
+ * le canal de la seconde GPS courante est appliqué s'il a changé. Sans
+ * heure GPS (pas encore de fix, maintien épuisé), le bateau reste sur le
+ * canal de la clé 3, celui des appareils qui ne sautent pas.
+ *
+ * Le groupe du bateau est son slot TDMA modulo le nombre de groupes : la
+ * table de slots envoyée par le comité (clé 6) répartit aussi les groupes.
+ *
+ * Aucune trame de position ni balise horaire ne part à moins de
+ * ChannelHop::GUARD_US d'un changement de seconde : canTransmit() la
+ * retarde de quelques ms. Les autres trames restent dans les files
+ * d'émission (TxScheduler), retenues par update() pendant la garde.
+ */
+
+#ifndef CHANNEL_HOPPER_H
+#define CHANNEL_HOPPER_H
+
+#include <Arduino.h>
+#include <ChannelHop.h>
+#include "Communication.h"
+#include "TimeBeacon.h"
+
+/**
+ * @brief Follows the GPS-time channel hopping schedule on the boat
+ */
+class ChannelHopper {
+public:
+    /**
+     * @brief Constructor (no hopping, channel 1)
+     */
+    ChannelHopper();
+
+    /**
+     * @brief Apply the fleet config
+     * @param channelMask Hop channels, bit n = channel n (0 = fixed home channel)
+     * @param groups Groups spread over the channels
+     * @param slotIndex TDMA slot of this boat (group = slotIndex % groups)
+     * @param homeChannel Channel without hopping or without GPS time
+     */
+    void configure(uint16_t channelMask, uint8_t groups, uint8_t slotIndex, uint8_t homeChannel);
+
+    /**
+     * @brief Hopping configured
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Switch to the channel of the current GPS second (every loop(), before sending)
+     *
+     * Holds the transmit queues of comm within the guard of a hop.
+     * @param comm Radio
+     * @param clock GNSS-disciplined clock
+     */
+    void update(Communication& comm, const TimeBeacon& clock);
+
+    /**
+     * @brief Sending allowed now (false within ChannelHop::GUARD_US of a hop)
+     * @param clock GNSS-disciplined clock
+     */
+    bool canTransmit(const TimeBeacon& clock);
+
+    /**
+     * @brief millis() of the next hop (PowerManager wake-up)
+     * @param now Current millis()
+     * @return now + 1 s when not hopping
+     */
+    uint32_t getNextHop(uint32_t now) const;
+
+    /**
+     * @brief Print hop statistics (status update, nothing when off)
+     */
+    void printReport();
+
+private:
+    ChannelHop schedule;
+    uint8_t group;                 ///< Group of this boat
+    uint8_t homeChannel;
+    bool synced;                   ///< GPS time at the last update()
+    int64_t nextHopLocalUs;        ///< esp_timer_get_time() of the next hop
+
+    uint32_t hops;                 ///< Channel changes on the schedule
+    uint32_t failures;             ///< esp_wifi_set_channel() errors
+    uint32_t deferred;             ///< Hops that delayed a frame (guard)
+    int64_t lastDeferredSecond;
+    uint32_t lateSumUs;            ///< Hop delay after its GPS second (report window)
+    uint32_t lateMaxUs;
+    uint32_t lateCount;
+};
+
+#endif // CHANNEL_HOPPER_H
@@ -26,10 +26,19 @@
  * transmettre les données GPS à tous les appareils à l'écoute.
  * Chaque bateau est identifié par son adresse MAC unique.
  * 
- * Structure des paquets:
+ * Structure des paquets (lib/BoatProtocol, partagée avec les outils et
+ * le Display):
  * - Alignée avec struct_message_Boat du Display
  * - Contient position, vitesse, cap, nombre de satellites
  * - Timestamp rempli par le Display à la réception
+ * - Cadence courante et qualité du fix (FixFilter) dans les octets de
+ *   bourrage finaux (taille inchangée, 48 octets, ignorés par les
+ *   Display existants)
+ *
+ * Toutes les trames passent par un ordonnanceur par classe de trafic
+ * (TxScheduler.h) : une position ne part jamais derrière une file de
+ * télémétrie ou d'événements. service() lui confie les trames en attente
+ * à chaque loop().
  */
 
 #ifndef COMMUNICATION_H
@@ -39,22 +48,28 @@
 #include <esp_now.h>
 #include <esp_wifi.h>
 #include <WiFi.h>
+#include <BoatProtocol.h>
 #include "GPS.h"
+#include "TxScheduler.h"
+
+/**
+ * @brief Frame received from ESP-NOW, queued for processing in loop()
+ */
+struct ReceivedFrame {
+    uint8_t mac[6];                       ///< Sender MAC address
+    uint8_t len;                          ///< Payload length
+    uint8_t data[ESP_NOW_MAX_DATA_LEN];   ///< Payload
+    uint32_t receivedAt;                  ///< millis() at reception
+};
 
 /**
- * @brief GPS broadcast packet structure (aligned with Display struct_message_Boat)
+ * @brief Outcome of one frame handed to the transmit queues
  */
-struct GPSBroadcastPacket {
-    int8_t messageType;      ///< 1 = Boat, 2 = Anemometer
-     char name[18];     // Custom boat name or MAC address (max 17 chars + null terminator)
-    uint32_t sequenceNumber; ///< Sequence number (incremental counter for packet loss detection)
-    uint32_t gpsTimestamp;   ///< GPS timestamp in milliseconds
-    float latitude;          ///< Latitude in degrees
-    float longitude;         ///< Longitude in degrees
-    float speed;             ///< Speed in knots
-    float heading;           ///< Heading in degrees (0=N, 90=E, 180=S, 270=W)
-    uint8_t satellites;      ///< Number of visible satellites
-    uint8_t ttl;             ///< Time-To-Live: 1=original, 0=already relayed by Hub
+enum TxStatus : uint8_t {
+    TX_SENT = 0,       ///< Accepted by esp_now_send()
+    TX_QUEUED = 1,     ///< Waiting in its class queue, sent by a later service()
+    TX_REFUSED = 2,    ///< Not queued (invalid length, control queue full)
+    TX_FAILED = 3      ///< Refused by esp_now_send() (TxClassStats::failed)
 };
 
 
@@ -71,9 +86,10 @@ public:
 
     /**
      * @brief Initialize ESP-NOW communication
+     * @param channel WiFi channel used for ESP-NOW (1-13)
      * @return true if initialization succeeds
      */
-    bool begin();
+    bool begin(uint8_t channel = 1);
 
     /**
      * @brief Broadcast GPS data with automatic retry
@@ -99,6 +115,101 @@ public:
      */
     bool broadcastGPSData(const GPSData& data, const String& boatName, uint8_t retries = 2);
 
+    /**
+     * @brief Broadcast a raw frame (single attempt)
+     * @param data Frame bytes (first byte = MessageType)
+     * @param len Frame length (max ESP_NOW_MAX_DATA_LEN)
+     * @param txClass Traffic class (queue, priority and airtime budget)
+     * @param frameId Output: id of the frame for isTxDone() (0 if refused), optional
+     * @return true if the frame was handed to the radio or queued
+     */
+    bool sendFrame(const uint8_t* data, size_t len, TxClass txClass, uint32_t* frameId = nullptr);
+
+    /**
+     * @brief Broadcast a frame and measure the end of its transmission
+     * @param data Frame bytes (first byte = MessageType)
+     * @param len Frame length (max ESP_NOW_MAX_DATA_LEN)
+     * @return true if the frame was handed to the radio or queued
+     * 
+     * The send callback of this frame (matched by order: callbacks follow
+     * the send order) records esp_timer_get_time(), read back with
+     * getTimedSendUs(). One timed frame at a time (time beacons, TX_TIME).
+     */
+    bool sendTimedFrame(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Local time of the send callback of the last timed frame
+     * @param localUs esp_timer_get_time() in the callback
+     * @return true once per timed frame, when its callback reported a transmission
+     */
+    bool getTimedSendUs(int64_t& localUs);
+
+    /**
+     * @brief Hand the waiting frames to the radio (every loop())
+     */
+    void service();
+
+    /**
+     * @brief Allow or hold every transmission (channel hop guard)
+     * @param open false = frames stay queued
+     */
+    void setTxOpen(bool open);
+
+    /**
+     * @brief Frames wait in the transmit queues
+     */
+    bool hasPendingTx() const;
+
+    /**
+     * @brief A frame has left: send callback received, refused or given up
+     * @param frameId Id from sendFrame()
+     * @return false while the frame is queued or in the radio
+     */
+    bool isTxDone(uint32_t frameId);
+
+    /**
+     * @brief millis() at which service() may send a waiting frame
+     * @param now millis() courant
+     * @return now + 1 if a frame only waits for the radio, later if for an airtime budget
+     */
+    uint32_t getNextTx(uint32_t now);
+
+    /**
+     * @brief Counters and latencies of a traffic class
+     */
+    const TxClassStats& getTxStats(TxClass txClass) const;
+
+    /**
+     * @brief Print transmit queue report (status update)
+     */
+    void printTxReport();
+
+    /**
+     * @brief Pop the next received frame (non-blocking)
+     * @param frame Output frame
+     * @return true if a frame was available
+     */
+    bool receive(ReceivedFrame& frame);
+
+    /**
+     * @brief Change the ESP-NOW channel
+     * @param channel WiFi channel (1-13)
+     * @return true if the channel was applied
+     */
+    bool setChannel(uint8_t channel);
+
+    /**
+     * @brief Change the channel for channel hopping (every second, no log line)
+     * @param channel WiFi channel (1-13)
+     * @return true if the channel was applied
+     */
+    bool hopChannel(uint8_t channel);
+
+    /**
+     * @brief Current ESP-NOW channel
+     */
+    uint8_t getChannel() const;
+
     /**
      * @brief Get local MAC address
      * @param mac Output buffer for MAC address (6 bytes)
@@ -110,22 +221,87 @@ public:
      * @return Current sequence counter value
      */
     uint32_t getSequenceNumber() const;
+    
+    /**
+     * @brief Set the broadcast rate announced in GPSBroadcastPacket
+     * @param rateDeciHz Rate in 0.1 Hz units (receivers interpolate with it)
+     */
+    void setRateDeciHz(uint8_t rateDeciHz);
+    
+    /**
+     * @brief Get number of received frames dropped (queue full)
+     * @return Drop counter since boot
+     */
+    uint32_t getRxDropped() const;
 
 private:
     uint8_t localMAC[6];
     uint32_t sequenceCounter;        ///< Sequence counter for packet numbering
+    uint8_t rateDeciHz;              ///< Announced broadcast rate (0.1 Hz)
+    uint8_t channel;                 ///< Current WiFi channel
+    QueueHandle_t rxQueue;           ///< Frames received in the WiFi task, consumed by loop()
+    uint32_t rxDropped;              ///< Frames dropped because rxQueue was full
+    uint32_t sendsQueued;            ///< Frames accepted by esp_now_send()
+    volatile uint32_t sendsDone;     ///< Send callbacks (WiFi task)
+    volatile uint32_t timedTicket;   ///< sendsDone value of the timed frame (0 = none)
+    volatile int64_t timedSendUs;    ///< esp_timer_get_time() in its callback
+    volatile bool timedSendOk;       ///< Callback reported a transmission
+    volatile bool timedReady;        ///< timedSendUs written, not read yet
+    
+    static const uint8_t TX_RING = 8;   ///< Frames tracked in the radio, above TxScheduler::IN_FLIGHT_LIVE
+    TxScheduler scheduler;           ///< Class queues in front of esp_now_send()
+    bool txOpen;                     ///< false = hold every frame (hop guard)
+    uint32_t failedId;               ///< Last frame refused by esp_now_send() (TxFrame::id)
+    uint32_t sendsCollected;         ///< Send callbacks whose latency was recorded
+    uint32_t sendsLost;              ///< Frames whose send callback never came
+    uint32_t lastDone;               ///< sendsDone at lastDoneUs
+    int64_t lastDoneUs;              ///< Last send callback seen, or radio idle
+    TxClass ringClass[TX_RING];      ///< Class of the frames in the radio, by ticket % TX_RING
+    uint32_t ringId[TX_RING];        ///< Their TxFrame::id
+    int64_t ringQueuedUs[TX_RING];   ///< Their TxScheduler::push() time
+    volatile int64_t ringDoneUs[TX_RING];  ///< Their send callback time (WiFi task)
+    
+    static const uint8_t RX_QUEUE_DEPTH = 8;
+    static const int64_t SEND_CALLBACK_TIMEOUT_US = 200000;  ///< Send callback given up
     
     static Communication* instance;  ///< Singleton instance for callbacks
     
+    /**
+     * @brief Queue a frame and send what the scheduler allows
+     * @param frameId Output: id of the frame (0 if refused), optional
+     * @return Outcome of this frame only (errors of other frames go to TxClassStats::failed)
+     */
+    TxStatus transmit(TxClass txClass, const uint8_t* data, size_t len, bool timed, uint32_t* frameId = nullptr);
+
+    /**
+     * @brief Frames handed to the radio without send callback
+     */
+    uint8_t getInFlight();
+
+    /**
+     * @brief Record the latencies of the send callbacks received since the last call
+     */
+    void collectSent(int64_t nowUs);
+    
     /**
      * @brief ESP-NOW send callback
      */
     static void onDataSent(const uint8_t* mac, esp_now_send_status_t status);
     
+    /**
+     * @brief ESP-NOW receive callback
+     */
+    static void onDataRecv(const uint8_t* mac, const uint8_t* data, int len);
+    
     /**
      * @brief Handle send callback
      */
     void handleSendCallback(esp_now_send_status_t status);
+    
+    /**
+     * @brief Handle receive callback (runs in the WiFi task)
+     */
+    void handleRecvCallback(const uint8_t* mac, const uint8_t* data, int len);
 };
 
 #endif // COMMUNICATION_H
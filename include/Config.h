@@ -0,0 +1,210 @@
+/**
+ * @file Config.h
+ * @brief Configuration de flotte : valeurs courantes, trames signées et persistance NVS
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Cette classe regroupe les paramètres modifiables à chaud (cadence de
+ * broadcast, canal, table de slots TDMA) et applique les trames de
+ * configuration poussées par le Display du comité ou un outil hôte.
+ *
+ * Fonctionnement:
+ * - Trame ConfigPushPacket signée HMAC-SHA256 (clé NVS "fleet_key")
+ * - Même signature pour les trames de parcours et de compte à rebours (authenticate())
+ * - Adressage à tous les bateaux ou à une liste de MAC
+ * - Deltas clé/valeur appliqués de façon atomique (tout ou rien)
+ * - Numéro de version strictement croissant (anti-rejeu)
+ * - Persistance NVS en un seul blob (namespace "boatgps", clé "config")
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <Arduino.h>
+#include "Communication.h"
+
+/**
+ * @brief Configuration keys carried by ConfigDelta
+ */
+enum ConfigKey : uint8_t {
+    CFG_BROADCAST_INTERVAL_MS = 1,   ///< Base broadcast interval (100-10000 ms)
+    CFG_BROADCAST_JITTER_MS = 2,     ///< Random jitter ± (ms), used when TDMA is disabled
+    CFG_WIFI_CHANNEL = 3,            ///< ESP-NOW channel (1-13)
+    CFG_TDMA_SLOT_COUNT = 4,         ///< Slots per broadcast interval (0 = TDMA disabled)
+    CFG_TDMA_SLOT_INDEX = 5,         ///< Slot of this boat
+    CFG_TDMA_SLOT_FROM_TARGET = 6,   ///< Slot = value + position of this boat in targets[] (slot table)
+    CFG_POWER_PROFILE = 7,           ///< PowerProfile (0 = performance, 1 = balanced, 2 = endurance)
+    CFG_GNSS_POWER_SAVE = 8,         ///< Allow GNSS receiver power save (0/1, only at ≤ 1 Hz)
+    CFG_ADAPTIVE_RATE = 9,           ///< Speed/turn-rate adaptive broadcast rate (0/1)
+    CFG_CHANNEL_BUDGET = 10,         ///< Average broadcast rate budget per boat (0.1 Hz, 5-100)
+    CFG_START_COUNTDOWN_S = 11,      ///< Countdown started by the button (30-900 s)
+    CFG_START_WINDOW_S = 12,         ///< High-rate window before the gun (10-300 s)
+    CFG_START_INTERVAL_MS = 13,      ///< Broadcast interval in the start window (100-1000 ms)
+    CFG_LINE_COMMITTEE_LAT = 14,     ///< Start line committee end latitude (1e-7 deg, 0 = unset)
+    CFG_LINE_COMMITTEE_LON = 15,     ///< Start line committee end longitude (1e-7 deg)
+    CFG_LINE_PIN_LAT = 16,           ///< Start line pin end latitude (1e-7 deg)
+    CFG_LINE_PIN_LON = 17,           ///< Start line pin end longitude (1e-7 deg)
+    CFG_TRACK_TOLERANCE_CM = 18,     ///< Simplified track error tolerance (cm, 0 = every fix)
+    CFG_PROXIMITY_TCPA_S = 19,       ///< Converging boat alert horizon (time to CPA, s, 0 = off)
+    CFG_TIME_BEACON_MS = 20,         ///< GPS time beacon interval (0 = off, 200-60000 ms)
+    CFG_HOP_CHANNELS = 21,           ///< Channel hopping set (bit n = channel n, 0 = fixed wifiChannel)
+    CFG_HOP_GROUPS = 22              ///< Groups spread over the hop channels (1 = whole fleet together)
+};
+
+/**
+ * @brief Result of a config frame, returned in ConfigAckPacket::status
+ */
+enum ConfigStatus : uint8_t {
+    CONFIG_APPLIED = 0,          ///< Deltas applied and persisted
+    CONFIG_ALREADY_APPLIED = 1,  ///< Same version already active (re-broadcast)
+    CONFIG_BAD_SIGNATURE = 2,    ///< HMAC mismatch (no ack sent)
+    CONFIG_STALE_VERSION = 3,    ///< Version older than the active one
+    CONFIG_INVALID_VALUE = 4,    ///< Unknown key or out-of-range value (nothing applied)
+    CONFIG_NO_KEY = 5,           ///< No fleet key provisioned on this boat (no ack sent)
+    CONFIG_PERSIST_FAILED = 6,   ///< Applied in RAM but NVS write failed
+    CONFIG_NOT_ADDRESSED = 7     ///< Frame targets other boats (no ack sent)
+};
+
+/**
+ * @brief Runtime configuration values
+ */
+struct BoatConfig {
+    uint32_t version;              ///< Active configuration version (0 = defaults)
+    uint16_t broadcastIntervalMs;  ///< Base broadcast interval in milliseconds
+    uint16_t broadcastJitterMs;    ///< Random jitter (±) when TDMA is disabled
+    uint8_t wifiChannel;           ///< ESP-NOW channel
+    uint8_t tdmaSlotCount;         ///< Slots per interval (0 = random jitter instead of TDMA)
+    uint8_t tdmaSlotIndex;         ///< Slot assigned to this boat
+    uint8_t powerProfile;          ///< PowerProfile (see PowerManager.h)
+    uint8_t gnssPowerSave;         ///< GNSS receiver power save allowed (see GPS.h)
+    uint8_t adaptiveRate;          ///< Adaptive broadcast rate enabled (see RatePolicy.h)
+    uint8_t channelBudget;         ///< Average broadcast rate budget per boat (0.1 Hz)
+    uint16_t startCountdownS;      ///< Countdown started by the button (see StartSequence.h)
+    uint16_t startWindowS;         ///< High-rate window before the gun
+    uint16_t startIntervalMs;      ///< Broadcast interval in the start window
+    int32_t lineCommitteeLat;      ///< Start line ends (1e-7 deg, all 0 = set with the button)
+    int32_t lineCommitteeLon;
+    int32_t linePinLat;
+    int32_t linePinLon;
+    uint16_t trackToleranceCm;     ///< Simplified track tolerance (see TrackSimplifier.h)
+    uint8_t proximityTcpaS;        ///< Proximity alert horizon (see ProximityMonitor.h)
+    uint16_t timeBeaconMs;         ///< Time beacon interval, 0 = off (see TimeBeacon.h)
+    uint16_t hopChannels;          ///< Channel hopping mask, 0 = off (see ChannelHopper.h)
+    uint8_t hopGroups;             ///< Hop groups (group of this boat = tdmaSlotIndex % hopGroups)
+};
+
+/**
+ * @brief Fleet configuration manager
+ */
+class Config {
+public:
+    /**
+     * @brief Constructor (factory defaults)
+     */
+    Config();
+
+    /**
+     * @brief Load configuration and fleet key from NVS
+     * @return true if a stored configuration was loaded
+     */
+    bool begin();
+
+    /**
+     * @brief Get active configuration
+     * @return Reference to the active values
+     */
+    const BoatConfig& get() const;
+
+    /**
+     * @brief Verify and apply a config frame
+     * @param frame Received ESP-NOW frame
+     * @param localMAC MAC address of this boat (6 bytes)
+     * @param ack Output acknowledgement to broadcast (authenticated frames only, see isAcknowledged())
+     * @return Status of the operation
+     */
+    ConfigStatus applyPush(const ReceivedFrame& frame, const uint8_t* localMAC, ConfigAckPacket& ack);
+
+    /**
+     * @brief Status answered with an ACK
+     * @return false for frames not addressed to this boat or not authenticated
+     */
+    static bool isAcknowledged(ConfigStatus status);
+
+    /**
+     * @brief Authenticate a committee frame (course, countdown) with the fleet key
+     * @param data Received frame
+     * @param signedLen Signed bytes at the start of the frame (offset of the signature)
+     * @param signature Signature carried by the frame (CONFIG_SIGNATURE_LEN bytes)
+     * @return false without fleet key or on mismatch (counted by getRejectedFrames())
+     */
+    bool authenticate(const uint8_t* data, size_t signedLen, const uint8_t* signature);
+
+    /**
+     * @brief Committee frames ignored because not authenticated (no key, bad signature)
+     * @return Counter since boot (config, course and countdown frames)
+     */
+    uint32_t getRejectedFrames() const;
+
+    /**
+     * @brief Sign a config frame with the fleet key (committee side)
+     * @param packet Packet to sign in place
+     * @return false if no fleet key is provisioned
+     */
+    bool sign(ConfigPushPacket& packet) const;
+
+private:
+    BoatConfig current;                 ///< Active configuration
+    uint8_t fleetKey[32];               ///< HMAC key
+    size_t fleetKeyLen;                 ///< HMAC key length (0 = not provisioned)
+    uint32_t rejectedFrames;            ///< Unauthenticated committee frames (no ack)
+
+    static const char* PREF_NAMESPACE;  ///< NVS namespace ("boatgps")
+    static const char* PREF_CONFIG;     ///< NVS blob key ("config")
+    static const char* PREF_FLEET_KEY;  ///< NVS fleet key ("fleet_key")
+
+    /**
+     * @brief Compute truncated HMAC-SHA256 over the signed part of a frame
+     */
+    bool computeSignature(const uint8_t* data, size_t signedLen, uint8_t* out) const;
+
+    /**
+     * @brief Set one value on a candidate configuration with range checks
+     * @return false if key is unknown or value out of range
+     */
+    static bool setValue(BoatConfig& cfg, uint8_t key, int32_t value);
+
+    /**
+     * @brief Read one value from a configuration
+     */
+    static int32_t getValue(const BoatConfig& cfg, uint8_t key);
+
+    /**
+     * @brief Cross-field validation of a candidate configuration
+     */
+    static bool isConsistent(const BoatConfig& cfg);
+
+    /**
+     * @brief Write configuration to NVS as a single key/value blob
+     */
+    bool persist(const BoatConfig& cfg);
+};
+
+#endif // CONFIG_H
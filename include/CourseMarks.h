@@ -0,0 +1,185 @@
+/**
+ * @file CourseMarks.h
+ * @brief Marques du parcours : détection des passages de bouée et des tours
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Parcours: trame CoursePacket du comité (type 8), signée avec la clé de
+ * flotte, enregistrée en NVS (clé "course"). Chaque marque est une zone : cercle autour de la bouée
+ * ou polygone (porte, zone d'arrivée), dans un LocalFrame centré sur la
+ * première marque.
+ *
+ * Coût constant par fix, quel que soit le nombre de marques : une grille
+ * uniforme GRID_SIZE × GRID_SIZE couvre le parcours, chaque case porte le
+ * masque des marques dont l'emprise la touche. Un fix ne teste que les
+ * marques de sa case et celles dans lesquelles il se trouve déjà.
+ *
+ * Passage de marque (hystérésis): entrée dans la zone, puis sortie à plus
+ * de EXIT_MARGIN_MM au-delà. L'instant du passage est celui de la plus
+ * courte distance au centre, interpolée entre deux fixes (précision
+ * meilleure que la période des fixes).
+ *
+ * Tour: passage de la marque de tour (flag COURSE_LAP_MARK, la marque 0
+ * par défaut) après toutes les autres marques. Le premier tour part du
+ * signal de départ s'il est connu, sinon du premier passage de la marque
+ * de tour.
+ */
+
+#ifndef COURSE_MARKS_H
+#define COURSE_MARKS_H
+
+#include <Arduino.h>
+#include "GPS.h"
+#include "Communication.h"
+#include "Geodesy.h"
+
+/**
+ * @brief Course marks (geofences), rounding and lap detection
+ */
+class CourseMarks {
+public:
+    /**
+     * @brief Constructor
+     */
+    CourseMarks();
+
+    /**
+     * @brief Load the course saved in NVS
+     */
+    void begin();
+
+    /**
+     * @brief Apply a course frame from the committee (saved if new)
+     * @param packet Received frame, already authenticated (Config::authenticate())
+     * @return true if the course changed
+     */
+    bool applyCourse(const CoursePacket& packet);
+
+    /**
+     * @brief A course with at least one mark is loaded
+     */
+    bool hasCourse() const;
+
+    /**
+     * @brief Start lap timing (start gun)
+     * @param tod GPS time of day of the gun (ms)
+     */
+    void startLaps(uint32_t tod);
+
+    /**
+     * @brief Test a new fix against nearby marks
+     * @param data New fix
+     * @param fixTod GPS time of day of the fix (ms)
+     * @param events Output events (rounding, lap), eventSequence set by the caller
+     * @param maxEvents Size of events[]
+     * @return Number of events filled
+     */
+    uint8_t update(const GPSData& data, uint32_t fixTod, EventPacket* events, uint8_t maxEvents);
+
+    /**
+     * @brief Completed laps
+     */
+    uint16_t getLaps() const;
+
+    /**
+     * @brief Print course report (status update)
+     */
+    void printReport();
+
+private:
+    enum Shape : uint8_t {
+        SHAPE_CIRCLE = 0,
+        SHAPE_POLYGON = 1
+    };
+
+    struct Mark {
+        uint8_t id;                ///< markId in the course frame (course order)
+        Shape shape;
+        bool lapMark;
+        bool inside;               ///< Entered, not yet left with the margin
+        uint8_t firstVertex;       ///< Polygon vertices in vertices[]
+        uint8_t vertexCount;
+        LocalPoint center;         ///< Circle center / polygon centroid (mm)
+        int32_t radiusMm;          ///< Circle radius (0 for polygons)
+        LocalPoint boxMin;         ///< Footprint including the exit margin
+        LocalPoint boxMax;
+        uint32_t closestMm;        ///< Closest approach while inside
+        uint32_t closestTod;
+        LocalPoint closest;
+    };
+
+    static const uint8_t GRID_SIZE = 16;
+    static const int32_t MIN_CELL_MM = 10000;          ///< 10 m cells at least
+    static const int32_t EXIT_MARGIN_MM = 5000;        ///< Hysteresis: leave 5 m beyond the zone
+
+    CoursePacket course;           ///< Last applied frame (saved in NVS)
+    LocalFrame frame;              ///< Origin at the first entry
+    Mark marks[COURSE_MAX_MARKS];
+    uint8_t markCount;
+    LocalPoint vertices[COURSE_MAX_ENTRIES];
+
+    uint8_t grid[GRID_SIZE * GRID_SIZE];   ///< Mark bitmask per cell
+    LocalPoint gridOrigin;         ///< South-west corner (mm)
+    int32_t cellMm;
+    uint8_t insideMask;            ///< Marks the boat is in
+
+    bool hasPrevious;
+    LocalPoint prevPoint;
+    uint32_t prevTod;
+
+    uint8_t lapMask;               ///< Lap marks (bit = index in marks[])
+    uint8_t roundedMask;           ///< Marks rounded since the lap started
+    bool lapStarted;
+    uint32_t lapStartTod;
+    uint16_t laps;
+    uint16_t roundings;
+    uint32_t lastLapMs;
+    uint32_t bestLapMs;
+
+    uint32_t cyclesSum;            ///< CPU cycles spent in update() (report window)
+    uint32_t cyclesMax;
+    uint32_t cyclesCount;
+
+    /**
+     * @brief Build marks, footprints and grid from the course frame
+     * @return true if at least one valid mark
+     */
+    bool build();
+
+    /**
+     * @brief Point inside the zone of a mark
+     * @param margin Extra distance around the zone (mm)
+     */
+    bool contains(const Mark& mark, const LocalPoint& point, int32_t margin) const;
+
+    /**
+     * @brief Closest approach to the mark center on the segment from the previous fix
+     */
+    void trackClosest(Mark& mark, const LocalPoint& point, uint32_t fixTod);
+
+    /**
+     * @brief Fill a rounding or lap event
+     */
+    void fillEvent(EventPacket& event, EventType type, uint8_t detail, uint32_t tod, int32_t relativeMs,
+                   const LocalPoint& point, float speed) const;
+};
+
+#endif // COURSE_MARKS_H
@@ -0,0 +1,133 @@
+/**
+ * @file CourseSmoother.h
+ * @brief Lissage du cap et de la vitesse fond par statistique circulaire, en virgule fixe
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Le cap fond (RMC) n'a pas de sens à l'arrêt et une moyenne des angles
+ * échoue au passage 359° -> 0°. Chaque fix donne un vecteur vitesse
+ * (vitesse × vecteur unitaire du cap, tables Q15 de Geodesy) : la
+ * moyenne exponentielle porte sur ses composantes est/nord, et le cap
+ * lissé est la direction du vecteur moyen. Un fix lent pèse peu, un fix
+ * arrêté ne pèse rien.
+ * - Vitesse lissée : moyenne exponentielle de la vitesse scalaire (un
+ *   virement ne la fait pas chuter)
+ * - Confiance : longueur résultante moyenne |v moyen| / vitesse moyenne,
+ *   1 pour un cap stable, proche de 0 pour un cap aléatoire
+ *
+ * Constante de temps TAU_MS, poids dt / (TAU_MS + dt) : même lissage à
+ * toutes les cadences GNSS. Entiers uniquement sur le chemin du fix.
+ */
+
+#ifndef COURSE_SMOOTHER_H
+#define COURSE_SMOOTHER_H
+
+#include <Arduino.h>
+#include "GPS.h"
+#include "Geodesy.h"
+
+/**
+ * @brief Streaming circular mean of the course, weighted by speed, and smoothed speed
+ */
+class CourseSmoother {
+public:
+    /**
+     * @brief Constructor
+     */
+    CourseSmoother();
+
+    /**
+     * @brief Feed a new fix
+     * @param data New fix (plausible fixes only)
+     */
+    void update(const GPSData& data);
+
+    /**
+     * @brief Feed a raw sample (host tests and update())
+     * @param speedMmps Speed over ground (mm/s)
+     * @param rawDeci Course over ground (0.1 deg)
+     * @param fixMillis millis() of the fix
+     */
+    void addSample(int32_t speedMmps, int32_t rawDeci, uint32_t fixMillis);
+
+    /**
+     * @brief Smoothed course is meaningful (boat moving, course stable enough)
+     */
+    bool isCourseValid() const;
+
+    /**
+     * @brief Smoothed course over ground (0.1 deg, 0-3599)
+     */
+    uint16_t getCourseDeci() const;
+
+    /**
+     * @brief Smoothed speed over ground (cm/s)
+     */
+    uint16_t getSpeedCms() const;
+
+    /**
+     * @brief Course confidence: mean resultant length (per mille, 1000 = steady course)
+     */
+    uint16_t getConfidencePermille() const;
+
+    /**
+     * @brief Forget the history (next fix restarts the averages)
+     */
+    void reset();
+
+    /**
+     * @brief Print smoothed vs raw course and speed (status update)
+     */
+    void printReport();
+
+private:
+    static const uint32_t TAU_MS = 2000;                ///< Smoothing time constant
+    static const uint32_t GAP_MS = 3000;                ///< Longer without fix: restart
+    static const int32_t COURSE_MMPS = 500;             ///< Below ~1 kn the course is not reported
+    static const uint16_t MIN_CONFIDENCE = 500;         ///< Below: course too unsteady to report
+    static const uint8_t FRACTION_BITS = 8;             ///< Averages kept in mm/s << 8
+
+    bool hasSample;
+    uint32_t lastMillis;
+    int32_t eastQ8;                ///< Smoothed velocity east (mm/s, Q8)
+    int32_t northQ8;               ///< Smoothed velocity north (mm/s, Q8)
+    int32_t speedQ8;               ///< Smoothed scalar speed (mm/s, Q8)
+
+    uint16_t courseDeci;
+    uint16_t speedCms;
+    uint16_t confidence;
+
+    int32_t rawSpeedMmps;          ///< Last raw sample (report)
+    int32_t rawCourseDeci;
+
+    uint32_t samples;
+    uint32_t restarts;             ///< Gaps restarting the averages
+    uint32_t cyclesSum;            ///< CPU cycles spent in update() (report window)
+    uint32_t cyclesMax;
+    uint32_t cyclesCount;
+
+    /**
+     * @brief Integer square root (outputs)
+     */
+    static uint32_t isqrt(uint64_t value);
+};
+
+#endif // COURSE_SMOOTHER_H
@@ -0,0 +1,140 @@
+/**
+ * @file FixFilter.h
+ * @brief Rejet des fixes aberrants (multitrajet, sauts de position) par tests robustes
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Chaque fix est comparé au dernier fix accepté (l'ancre):
+ * - Vitesse: vitesse Doppler au-delà de MAX_SPEED_MMPS, ou déplacement
+ *   au-delà de MAX_SPEED_MMPS × dt plus le bruit de position admis
+ * - Accélération: variation de la vitesse Doppler au-delà de
+ *   MAX_ACCEL_MMPS2
+ * - Position (Hampel): écart entre la position et la position prédite
+ *   (ancre + vitesse Doppler moyenne × dt) au-delà de médiane + 3 × MAD
+ *   des écarts des derniers fixes acceptés, jamais sous MIN_GATE_MM
+ *
+ * Une vitesse RMC corrompue (somme de contrôle valide) est bornée à
+ * MAX_DOPPLER_KN avant la prédiction, calculée en 32 bits ; elle reste
+ * marquée FIX_OUTLIER_SPEED.
+ *
+ * Un fix rejeté n'est pas supprimé : ses drapeaux sont dans
+ * GPSData::quality (émis et enregistrés), l'ancre est conservée. Après
+ * RESEED_MS de rejets consécutifs ou sans fix, le filtre repart du fix
+ * courant (saut réel, réacquisition).
+ */
+
+#ifndef FIX_FILTER_H
+#define FIX_FILTER_H
+
+#include <Arduino.h>
+#include "Geodesy.h"
+
+/**
+ * @brief Fix quality flags (GPSData::quality, GPSBroadcastPacket::quality)
+ */
+enum FixQuality : uint8_t {
+    FIX_GOOD = 0x00,             ///< Plausible fix (or not checked)
+    FIX_OUTLIER_POSITION = 0x01, ///< Position off the prediction (Hampel test)
+    FIX_OUTLIER_SPEED = 0x02,    ///< Doppler or implied speed impossible for a sailboat
+    FIX_OUTLIER_ACCEL = 0x04     ///< Doppler speed change impossible for a sailboat
+};
+
+/**
+ * @brief Outlier and multipath glitch filter on raw fixes
+ */
+class FixFilter {
+public:
+    /**
+     * @brief Constructor
+     */
+    FixFilter();
+
+    /**
+     * @brief Check a new fix
+     * @param latitude Latitude (degrees)
+     * @param longitude Longitude (degrees)
+     * @param speedKn Speed over ground (knots)
+     * @param courseDeg Course over ground (degrees)
+     * @param fixMillis millis() of the fix
+     * @return FixQuality flags (FIX_GOOD = accepted)
+     */
+    uint8_t check(double latitude, double longitude, float speedKn, float courseDeg, uint32_t fixMillis);
+
+    /**
+     * @brief Fixes checked
+     */
+    uint32_t getChecked() const;
+
+    /**
+     * @brief Fixes rejected
+     */
+    uint32_t getRejected() const;
+
+    /**
+     * @brief Print filter report (status update)
+     */
+    void printReport();
+
+private:
+    static const uint8_t RESIDUALS = 9;                 ///< Hampel window (accepted fixes)
+    static const uint8_t MIN_RESIDUALS = 3;             ///< Fewer: MIN_GATE_MM only
+    static const uint32_t MIN_GATE_MM = 8000;           ///< Never reject closer than this to the prediction
+    static const int32_t MAX_SPEED_MMPS = 15000;        ///< 29 kn
+    static const int32_t MAX_ACCEL_MMPS2 = 5000;        ///< 0.5 g
+    static const int32_t MAX_DOPPLER_KN = 60;           ///< Corrupt RMC speed bounded to this (32-bit prediction)
+    static const uint32_t RESEED_MS = 5000;             ///< Rejected run or fix gap restarting the filter
+    static const int32_t RECENTRE_MM = 10000000;        ///< 10 km: move the frame origin
+
+    LocalFrame frame;
+    bool hasAnchor;
+    LocalPoint anchor;             ///< Last accepted fix
+    uint32_t anchorMillis;
+    int32_t anchorVx;              ///< mm/s east
+    int32_t anchorVy;              ///< mm/s north
+    int32_t anchorSpeedMmps;
+
+    uint32_t residuals[RESIDUALS]; ///< Prediction errors of the last accepted fixes (mm)
+    uint8_t residualHead;
+    uint8_t residualCount;
+    uint32_t lastGateMm;
+
+    uint32_t checked;
+    uint32_t rejected;
+    uint32_t positionRejects;
+    uint32_t speedRejects;
+    uint32_t accelRejects;
+    uint32_t reseeds;              ///< Restarts after a rejected run
+    uint32_t cyclesSum;            ///< CPU cycles spent in check() (report window)
+    uint32_t cyclesMax;
+    uint32_t cyclesCount;
+
+    /**
+     * @brief Restart from this fix (first fix, gap, rejected run)
+     */
+    void seed(int32_t latE7, int32_t lonE7, int32_t vx, int32_t vy, int32_t speedMmps, uint32_t fixMillis);
+
+    /**
+     * @brief Hampel gate: median + 3 × 1.4826 × MAD of the residuals (mm)
+     */
+    uint32_t hampelGate() const;
+};
+
+#endif // FIX_FILTER_H
@@ -31,6 +31,8 @@
  * - Parsing NMEA automatique
  * - Validation du fix (≥4 satellites)
  * - Conversion en timestamp Unix
+ * - Modes d'économie d'énergie du récepteur (UBX CFG-PM2/RXM, CASIC $PCAS)
+ * - Marquage des fixes aberrants (FixFilter, GPSData::quality)
  */
 
 #ifndef GPS_H
@@ -38,6 +40,7 @@
 
 #include <Arduino.h>
 #include <TinyGPSPlus.h>
+#include "FixFilter.h"
 
 /**
  * @brief GPS data structure
@@ -57,6 +60,16 @@ struct GPSData {
     uint8_t hour;            ///< GPS hour (0-23)
     uint8_t minute;          ///< GPS minute (0-59)
     uint8_t second;          ///< GPS second (0-59)
+    uint32_t fixMillis;      ///< millis() when this fix was parsed
+    uint8_t quality;         ///< FixQuality flags (FIX_GOOD = plausible, see FixFilter.h)
+};
+
+/**
+ * @brief GNSS receiver power mode
+ */
+enum GnssPowerMode : uint8_t {
+    GNSS_FULL_POWER = 0,     ///< Continuous tracking, all sentences
+    GNSS_POWER_SAVE = 1      ///< NEO-6M: cyclic tracking (PSM) / AT6668: GGA + RMC only, no receiver saving
 };
 
 /**
@@ -106,12 +119,163 @@ public:
      */
     float getHDOP();
 
+    /**
+     * @brief Get current UTC time of day estimated from the last GPS time
+     * @return Milliseconds since 00:00:00 UTC (0 if GPS time not yet known)
+     * 
+     * Extrapolated with millis() since the last NMEA time update. The offset
+     * between the GNSS epoch and NMEA reception is common to all boats using
+     * the same module, so the value can be used to align TDMA slots.
+     */
+    uint32_t getTimeOfDayMs();
+
+    /**
+     * @brief Get millis() of the last byte received from the GPS module
+     */
+    uint32_t getLastRxMillis() const;
+
+    /**
+     * @brief Get millis() of the first byte of the current/last NMEA burst
+     * 
+     * A burst starts after the UART has been quiet for BURST_GAP_MS.
+     * Used by PowerManager to predict the next burst and wake up in time.
+     */
+    uint32_t getBurstStartMillis() const;
+
+    /**
+     * @brief GNSS epoch of the last timed NMEA burst and local time of its first byte
+     * @param gpsUs GPS (UTC) time of the epoch, µs since 1970-01-01
+     * @param localUs esp_timer_get_time() at the first byte of the burst
+     * @return Anchors taken since boot (0 = none yet, outputs unchanged)
+     * 
+     * One anchor per burst, on the RMC sentence. Used by TimeBeacon to
+     * discipline the local clock.
+     */
+    uint32_t getTimeAnchor(int64_t& gpsUs, int64_t& localUs) const;
+
+    /**
+     * @brief Set the navigation update period of the receiver
+     * @param periodMs Fix period in milliseconds (100-1000, NEO-6M: 200-1000)
+     */
+    void setUpdateRate(uint16_t periodMs);
+
+    /**
+     * @brief Allow or forbid automatic receiver power save
+     * @param allowed Power save permitted by configuration
+     * @param updatePeriodMs Fix period required by the broadcast rate
+     * 
+     * Power save is entered after POWER_SAVE_STABLE_FIXES good fixes and
+     * left immediately when HDOP degrades or the boat accelerates.
+     */
+    void setPowerSaveAllowed(bool allowed, uint16_t updatePeriodMs);
+
+    /**
+     * @brief Get current receiver power mode
+     */
+    GnssPowerMode getPowerMode() const;
+
+    /**
+     * @brief Get number of fixes parsed since boot
+     */
+    uint32_t getFixCount() const;
+
+    /**
+     * @brief Nominal receiver current in the current power mode (mA)
+     */
+    float getReceiverCurrentMa() const;
+
+    /**
+     * @brief Print receiver power status (status update)
+     */
+    void printPowerReport();
+
+    /**
+     * @brief Print outlier filter statistics (status update)
+     */
+    void printFilterReport();
+
+    /**
+     * @brief Keep complete NMEA sentences for logging (manoeuvre capture)
+     * @param enabled Capture raw sentences from now on (the queue is emptied when disabled)
+     */
+    void setRawCapture(bool enabled);
+
+    /**
+     * @brief Take the oldest captured NMEA sentence
+     * @param out Sentence without CR/LF, NUL terminated (RAW_SENTENCE_LEN bytes)
+     * @return false if no sentence is waiting
+     */
+    bool readRawSentence(char* out);
+
+    /**
+     * @brief Sentences dropped because the queue was full
+     */
+    uint32_t getRawDropped() const;
+
+    static const uint8_t RAW_SENTENCE_LEN = 96;    ///< NMEA 0183 max is 82 + margin
+
 private:
     TinyGPSPlus gps;
     HardwareSerial* gpsSerial;
     uint8_t rxPin;
     uint8_t txPin;
     GPSData currentData;
+    FixFilter filter;            ///< Flags multipath glitches in currentData.quality
+    uint32_t timeOfDayMs;        ///< GPS time of day at last time update (ms)
+    uint32_t timeSyncMillis;     ///< millis() at last time update (0 = never)
+    uint32_t lastRxMillis;       ///< millis() of last received byte
+    uint32_t burstStartMillis;   ///< millis() of first byte of last NMEA burst
+    int64_t burstStartUs;        ///< esp_timer_get_time() of the same byte
+    bool burstTimed;             ///< Anchor already taken in this burst
+    int64_t anchorGpsUs;         ///< GPS time of the last anchored epoch (µs since 1970)
+    int64_t anchorLocalUs;       ///< burstStartUs of that epoch
+    uint32_t anchorCount;        ///< Anchors taken since boot
+    
+    GnssPowerMode powerMode;     ///< Current receiver power mode
+    bool powerSaveAllowed;       ///< Power save permitted by configuration
+    uint16_t updatePeriodMs;     ///< Fix period requested from the receiver
+    uint8_t stableFixes;         ///< Consecutive good fixes (power save entry)
+    uint32_t powerSaveHoldoff;   ///< millis() before which power save is not re-entered
+    uint32_t powerModeSince;     ///< millis() of last power mode change
+    uint32_t powerSaveExits;     ///< Exits caused by HDOP or acceleration
+    float lastSpeed;             ///< Speed of previous fix (knots)
+    uint32_t lastFixMillis;      ///< millis() of previous fix
+    uint32_t fixCount;           ///< Fixes parsed since boot
+    uint64_t modeTimeMs[2];      ///< Time spent in each GnssPowerMode
+    
+    static const uint8_t RAW_QUEUE = 16;           ///< Sentences waiting for the SD card
+    bool rawCapture;             ///< Raw NMEA capture enabled
+    char rawLine[RAW_SENTENCE_LEN];                ///< Sentence being received
+    uint8_t rawLineLen;
+    char rawQueue[RAW_QUEUE][RAW_SENTENCE_LEN];
+    uint8_t rawHead;             ///< Oldest queued sentence
+    uint8_t rawCount;
+    uint32_t rawDropped;
+    
+    /**
+     * @brief Send a UBX message (checksum computed)
+     */
+    void sendUBX(uint8_t msgClass, uint8_t msgId, const uint8_t* payload, uint16_t len);
+    
+    /**
+     * @brief Send a NMEA command such as "PCAS02,1000" (adds $, checksum, CRLF)
+     */
+    void sendNMEACommand(const char* body);
+    
+    /**
+     * @brief Switch receiver power mode
+     */
+    void setPowerMode(GnssPowerMode mode);
+    
+    /**
+     * @brief Evaluate power save entry/exit on a new fix
+     */
+    void updatePowerPolicy(uint32_t now);
+    
+    /**
+     * @brief Add a received character to the raw sentence being captured
+     */
+    void captureRawChar(char c);
     
     // Baudrate depends on GPS module:
     // - Original GPS (NEO-6M): 9600 bps
@@ -123,6 +287,13 @@ private:
     #endif
     
     static const uint32_t MAX_AGE_MS = 2000;  ///< Maximum age for valid fix
+    static const uint32_t BURST_GAP_MS = 50;  ///< UART silence separating two NMEA bursts
+    
+    static constexpr float POWER_SAVE_MAX_HDOP = 1.5f;    ///< Enter power save below this HDOP
+    static constexpr float POWER_SAVE_EXIT_HDOP = 2.5f;   ///< Return to full power above this HDOP
+    static constexpr float POWER_SAVE_EXIT_ACCEL = 1.0f;  ///< Return to full power above this |dv/dt| (kn/s)
+    static const uint8_t POWER_SAVE_STABLE_FIXES = 10;    ///< Good fixes required before power save
+    static const uint32_t POWER_SAVE_HOLDOFF_MS = 30000;  ///< Full power duration after an exit
 };
 
 #endif // GPS_H
@@ -0,0 +1,185 @@
+/**
+ * @file Gateway.h
+ * @brief Mode station de base : passerelle ESP-NOW vers USB série à haut débit
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Le même firmware, en mode passerelle (clé NVS "mode" = "gateway" ou
+ * option de compilation -DGATEWAY_MODE), n'émet plus : il écoute le
+ * canal configuré et recopie chaque trame de la flotte sur la liaison
+ * série USB, pour un PC du bateau comité.
+ *
+ * Chemin d'une trame :
+ * - Rappel de réception ESP-NOW (tâche WiFi) : horodatage
+ *   esp_timer_get_time(), copie dans un anneau sans verrou (un
+ *   producteur, un consommateur, indices atomiques) ; anneau plein =
+ *   trame comptée perdue, jamais d'attente dans la tâche WiFi
+ * - Rappel de promiscuité (même tâche, juste avant) : RSSI de la trame
+ *   d'action 802.11 qui porte la trame ESP-NOW, apparié par MAC
+ * - loop() : enregistrements encadrés (GatewayLink.h) regroupés dans un
+ *   tampon de 2 Ko, confiés au pilote série selon la place libre, sans
+ *   bloquer ; un hôte qui ne lit plus pendant STALL_MS fait perdre le lot
+ *   en cours (compté)
+ *
+ * Un enregistrement de compteurs part chaque seconde : trames reçues,
+ * transmises, perdues à chaque étage, RSSI manquants, remplissage
+ * maximal de l'anneau.
+ *
+ * Saut de canal (clés 21 et 22) : la passerelle n'a pas de GNSS, elle
+ * suit le plan sur l'heure des balises horaires qu'elle transmet
+ * (BeaconReceiver). Tant qu'elle n'a pas d'heure, elle écoute le canal de
+ * la clé 3 et n'y entend une balise qu'une seconde sur N : une estimation
+ * grossière (horodatage seul, quelques ms) suffit à commencer à suivre le
+ * plan, la balise suivante arrive alors sur le même canal et l'estimation
+ * corrigée prend le relais. Chaque trame porte le canal sur lequel elle a
+ * été reçue.
+ */
+
+#ifndef GATEWAY_H
+#define GATEWAY_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <GatewayLink.h>
+#include <ChannelHop.h>
+#include <TimeSync.h>
+
+/**
+ * @brief ESP-NOW to USB serial gateway (base-station mode)
+ */
+class Gateway {
+public:
+    static const unsigned long SERIAL_BAUD = 1500000;    ///< UART boards (as upload_speed); ignored by USB CDC
+    static const size_t SERIAL_TX_BUFFER = 8192;         ///< Driver TX buffer (setTxBufferSize before begin)
+
+    /**
+     * @brief Constructor
+     */
+    Gateway();
+
+    /**
+     * @brief Take over ESP-NOW reception (after Communication::begin())
+     * @param channel Channel listened to (already set by Communication)
+     * @return true if the receive and sniffer callbacks are registered
+     */
+    bool begin(uint8_t channel);
+
+    /**
+     * @brief Follow the channel hopping schedule (before begin())
+     * @param channelMask Hop channels, bit n = channel n (0 = fixed channel)
+     * @param groups Groups spread over the channels
+     * @param group Group listened to (boats and time beacon of this group are heard)
+     */
+    void setHop(uint16_t channelMask, uint8_t groups, uint8_t group);
+
+    /**
+     * @brief Move received frames to the serial link (call from loop())
+     * @return true if records are still waiting (call again without delay)
+     */
+    bool update();
+
+    /**
+     * @brief Frames lost at any stage (ring full, host not reading)
+     */
+    uint32_t getDropped() const;
+
+private:
+    /**
+     * @brief Frame copied by the receive callback
+     */
+    struct Record {
+        uint64_t timeUs;                      ///< esp_timer_get_time() in the callback
+        uint8_t mac[6];
+        int8_t rssi;
+        uint8_t channel;                      ///< From the sniffer (0 = unknown: current channel)
+        uint8_t len;
+        uint8_t data[ESP_NOW_MAX_DATA_LEN];
+    };
+
+    static const uint32_t RING_SIZE = 128;               ///< Power of 2 (34 KB)
+    static const size_t STAGING_SIZE = 2048;             ///< Records batched per Serial.write()
+    static const uint32_t STALL_MS = 500;                ///< Host not reading: staged records dropped
+    static const uint32_t STATS_INTERVAL_MS = 1000;
+    static const int64_t HOP_HOLDOVER_US = 120000000;    ///< Home channel after this time without beacon
+
+    static Gateway* instance;
+
+    // Single producer (WiFi task) / single consumer (loop task) ring
+    Record ring[RING_SIZE];
+    std::atomic<uint32_t> head;               ///< Next slot written by the callback
+    std::atomic<uint32_t> tail;               ///< Next slot read by update()
+
+    // Sniffer -> receive callback (both run in the WiFi task, sniffer first)
+    uint8_t sniffedMac[6];
+    int8_t sniffedRssi;
+    uint8_t sniffedChannel;
+    bool sniffed;
+
+    uint8_t staging[STAGING_SIZE];
+    size_t stagedLen;
+    size_t stagedSent;
+    uint32_t stagedRecords;
+    uint32_t lastProgress;
+    uint32_t lastStats;
+    uint8_t channel;
+
+    // Callback stage (written by the WiFi task only)
+    std::atomic<uint32_t> received;
+    std::atomic<uint32_t> ringDropped;
+    std::atomic<uint32_t> invalid;
+    std::atomic<uint32_t> rssiMissing;
+    // Serial stage (written by loop() only)
+    uint32_t forwarded;
+    uint32_t serialDropped;
+    uint32_t ringHighWater;
+
+    // Channel hopping (loop() only)
+    ChannelHop schedule;
+    uint8_t hopGroup;
+    uint8_t homeChannel;
+    BeaconReceiver beaconClock;               ///< TX-corrected beacons (once following the schedule)
+    BeaconReceiver beaconCoarse;              ///< Stamps only: acquisition from the home channel
+
+    static void onDataRecv(const uint8_t* mac, const uint8_t* data, int len);
+    static void onSniff(void* buf, wifi_promiscuous_pkt_type_t type);
+    void handleRecv(const uint8_t* mac, const uint8_t* data, int len);
+    void handleSniff(const wifi_promiscuous_pkt_t* packet);
+
+    /**
+     * @brief Hand staged bytes to the driver as room allows
+     * @return true once the staging buffer is empty
+     */
+    bool flushStaging(uint32_t now);
+
+    /**
+     * @brief Append a counters record to the staging buffer
+     */
+    void stageStats();
+
+    /**
+     * @brief Listen on the channel of the current GPS second (beacon time)
+     */
+    void followSchedule();
+};
+
+#endif // GATEWAY_H
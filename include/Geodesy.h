@@ -0,0 +1,214 @@
+/**
+ * @file Geodesy.h
+ * @brief Projection plan local (ENU) en virgule fixe pour toute la géométrie à bord
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * L'ESP32 n'a pas de FPU double : haversine en double coûte plusieurs
+ * milliers de cycles par point. Toute la géométrie à bord (ligne de
+ * départ, filtres, zones, simplification de trace) passe par un repère
+ * local LocalFrame:
+ * - Positions en 1e-7 degré (int32), coordonnées locales en millimètres
+ *   est/nord autour d'une origine (int32, ±2147 km)
+ * - Facteurs d'échelle Q16 (série WGS84, cos(lat) inclus) calculés une
+ *   fois par origine ; chaque point coûte 6 multiplications entières
+ * - Correction du premier ordre de la convergence des méridiens (terme
+ *   en x·y·tan φ / M et x²·tan φ / 2N)
+ * - Distances en float32 (FPU simple précision de l'ESP32)
+ *
+ * Erreur entre deux points projetés, comparée à la géodésique WGS84
+ * (Vincenty, double), toutes directions, origines de -70° à 70°,
+ * positions arrondies à 1e-7 degré:
+ *
+ * | Rayon autour de l'origine | Distance | Haversine (sphère) | Cap (segments ≥ 100 m) |
+ * |---------------------------|----------|--------------------|------------------------|
+ * | 500 m                     | 2,8 mm   | 5,3 m              | 0,07°                  |
+ * | 2 km                      | 7,8 mm   | 21 m               | 0,11°                  |
+ * | 5 km                      | 2,1 cm   | 51 m               | 0,18°                  |
+ * | 10 km                     | 10 cm    | 102 m              | 0,29°                  |
+ *
+ * Le cap est celui du quadrillage : il s'écarte de l'azimut vrai de la
+ * convergence des méridiens (x·tan φ / N) en plus du pas de 0,1°. Au-delà
+ * de 10 km, recentrer l'origine.
+ *
+ * Ces chiffres et le coût par point sont vérifiés sur PC par la suite
+ * geodesy de native-firmware-checks (voir SIMULATOR.md). Sur PC, la FPU
+ * double rend haversine seulement 5 fois plus lent ; sur l'ESP32, voir
+ * printBenchmark().
+ */
+
+#ifndef GEODESY_H
+#define GEODESY_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Point in a local frame (mm east / north of the origin)
+ */
+struct LocalPoint {
+    int32_t x;                     ///< mm east of the origin
+    int32_t y;                     ///< mm north of the origin
+};
+
+/**
+ * @brief Local tangent plane around an origin, fixed point
+ */
+class LocalFrame {
+public:
+    /**
+     * @brief Constructor (no origin)
+     */
+    LocalFrame();
+
+    /**
+     * @brief Set the origin and precompute the scale factors
+     * @param latE7 Origin latitude (1e-7 deg)
+     * @param lonE7 Origin longitude (1e-7 deg)
+     */
+    void setOrigin(int32_t latE7, int32_t lonE7);
+
+    /**
+     * @brief Origin set
+     */
+    bool hasOrigin() const;
+
+    /**
+     * @brief Origin latitude (1e-7 deg)
+     */
+    int32_t getOriginLat() const;
+
+    /**
+     * @brief Origin longitude (1e-7 deg)
+     */
+    int32_t getOriginLon() const;
+
+    /**
+     * @brief Project a position into the frame
+     * @param latE7 Latitude (1e-7 deg)
+     * @param lonE7 Longitude (1e-7 deg)
+     * @return Position in mm east / north of the origin
+     */
+    LocalPoint project(int32_t latE7, int32_t lonE7) const;
+
+    /**
+     * @brief Project many positions (track, geofence vertices)
+     * @param latE7 Latitudes (1e-7 deg)
+     * @param lonE7 Longitudes (1e-7 deg)
+     * @param out Output points (count entries)
+     * @param count Number of positions
+     */
+    void projectBatch(const int32_t* latE7, const int32_t* lonE7, LocalPoint* out, size_t count) const;
+
+    /**
+     * @brief Convert a frame position back to latitude / longitude
+     * @param point Position in the frame (mm)
+     * @param latE7 Output latitude (1e-7 deg)
+     * @param lonE7 Output longitude (1e-7 deg)
+     */
+    void unproject(const LocalPoint& point, int32_t& latE7, int32_t& lonE7) const;
+
+private:
+    int32_t originLat;
+    int32_t originLon;
+    bool valid;
+    int32_t scaleX;                ///< mm per 1e-7 deg of longitude, Q16 (cos(lat) applied)
+    int32_t scaleY;                ///< mm per 1e-7 deg of latitude, Q16
+    int32_t convergenceX;          ///< tan(lat) / M per mm, Q48 (x shrinks northward)
+    int32_t convergenceY;          ///< tan(lat) / 2N per mm, Q48 (parallels curve poleward)
+};
+
+/**
+ * @brief Fixed-point and float32 geometry helpers
+ */
+class Geodesy {
+public:
+    /**
+     * @brief Degrees to 1e-7 degree integer
+     */
+    static int32_t toE7(double degrees);
+
+    /**
+     * @brief Sine in Q15
+     * @param deciDeg Angle in 0.1 degree (any value, wrapped)
+     */
+    static int32_t sinQ15(int32_t deciDeg);
+
+    /**
+     * @brief Cosine in Q15
+     * @param deciDeg Angle in 0.1 degree (any value, wrapped)
+     */
+    static int32_t cosQ15(int32_t deciDeg);
+
+    /**
+     * @brief Bearing of a vector, integer atan2 (table, error < 0.02 degree before rounding)
+     * @param east East component (any unit)
+     * @param north North component (same unit)
+     * @return 0.1 degree in [0, 3600), 0 = north, clockwise (0 for a null vector)
+     */
+    static int32_t bearingDeci(int32_t east, int32_t north);
+
+    /**
+     * @brief Knots to mm/s
+     */
+    static int32_t knotsToMmps(float knots);
+
+    /**
+     * @brief Velocity vector from speed and course
+     * @param speedKnots Speed over ground (knots)
+     * @param courseDeg Course over ground (degrees)
+     * @param vx Output mm/s east
+     * @param vy Output mm/s north
+     */
+    static void velocityMmps(float speedKnots, float courseDeg, int32_t& vx, int32_t& vy);
+
+    /**
+     * @brief Distance between two frame points (mm, float32 math)
+     */
+    static uint32_t distanceMm(const LocalPoint& a, const LocalPoint& b);
+
+    /**
+     * @brief Distances between consecutive points (track legs)
+     * @param points Points (count entries)
+     * @param out Output, out[i] = distance from points[i] to points[i + 1] (count - 1 entries)
+     * @param count Number of points
+     * @return Total length (mm)
+     */
+    static uint32_t distancesMm(const LocalPoint* points, uint32_t* out, size_t count);
+
+    /**
+     * @brief Signed course change from one course to another
+     * @return Degrees in [-180, 180)
+     */
+    static float courseDelta(float fromDeg, float toDeg);
+
+    /**
+     * @brief Great circle distance on a sphere, double math (reference only)
+     * @return Distance in meters
+     */
+    static double haversineM(double lat1, double lon1, double lat2, double lon2);
+
+    /**
+     * @brief Measure projection vs haversine cost on this CPU (boot report)
+     */
+    static void printBenchmark();
+};
+
+#endif // GEODESY_H
@@ -0,0 +1,183 @@
+/**
+ * @file ManoeuvreCapture.h
+ * @brief Détection des manœuvres (virement, empannage) et fenêtres de capture haute cadence
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Déclenchement sur le flux de fixes: vitesse de rotation du cap au-delà
+ * de TRIGGER_DEG_S, ou rotation plus lente avec une perte de vitesse de
+ * plus de 30 % par rapport à la vitesse de référence (moyenne
+ * exponentielle sur 5 s, hors manœuvre).
+ *
+ * La fenêtre de capture commence PRE_ROLL_MS avant le déclenchement
+ * (historique des derniers fixes) et se ferme quand le cap est stable
+ * depuis SETTLE_MS et la vitesse revenue, ou après MAX_CAPTURE_MS.
+ * Pendant la fenêtre, main relève la cadence du récepteur GNSS, enregistre
+ * chaque fix et les trames NMEA brutes.
+ *
+ * Mesures:
+ * - Perte de vitesse: vitesse d'entrée - vitesse minimale
+ * - Temps de relance: déclenchement -> retour à 90 % de la vitesse d'entrée
+ * - Distance perdue: sur la bissectrice des caps d'entrée et de sortie
+ *   (l'axe du vent pour un virement), distance qu'aurait parcourue le
+ *   bateau à sa vitesse d'entrée moins la distance réellement gagnée
+ */
+
+#ifndef MANOEUVRE_CAPTURE_H
+#define MANOEUVRE_CAPTURE_H
+
+#include <Arduino.h>
+#include "GPS.h"
+#include "Communication.h"
+#include "Geodesy.h"
+
+/**
+ * @brief Kind of manoeuvre (EventPacket detail)
+ */
+enum ManoeuvreKind : uint8_t {
+    MANOEUVRE_TURN = 0,      ///< No wind reference
+    MANOEUVRE_TACK = 1,      ///< Bow through the wind
+    MANOEUVRE_GYBE = 2       ///< Stern through the wind
+};
+
+/**
+ * @brief Metrics of a completed manoeuvre
+ */
+struct ManoeuvreRecord {
+    ManoeuvreKind kind;
+    uint32_t startTimestamp;     ///< GPS timestamp of the window start (s)
+    uint32_t startTod;           ///< GPS time of day of the window start (ms, 0 = unknown)
+    uint32_t durationMs;         ///< Window start -> course settled
+    int16_t headingChangeDeci;   ///< Signed course change (0.1 deg, > 0 = to starboard)
+    uint16_t entrySpeedCms;      ///< Reference speed before the manoeuvre (cm/s)
+    uint16_t minSpeedCms;        ///< Lowest speed in the window (cm/s)
+    uint16_t exitSpeedCms;       ///< Speed when the window closed (cm/s)
+    int32_t recoveryMs;          ///< Trigger -> back to 90 % of entry speed (-1 = not recovered)
+    int32_t distanceLostMm;      ///< Lost on the bisector axis vs. entry speed (< 0 = gained)
+    int32_t latitude;            ///< Window start position (1e-7 deg)
+    int32_t longitude;
+};
+
+/**
+ * @brief Manoeuvre detector driving high-rate capture windows
+ */
+class ManoeuvreCapture {
+public:
+    /**
+     * @brief Constructor
+     */
+    ManoeuvreCapture();
+
+    /**
+     * @brief Wind reference for tack / gybe classification
+     * @param fromDeg Direction the wind blows from (degrees), negative = unknown
+     */
+    void setWindDirection(float fromDeg);
+
+    /**
+     * @brief Process a new fix
+     * @param data New fix
+     * @param fixTod GPS time of day of the fix (ms, 0 = unknown)
+     * @param record Filled when a manoeuvre completes
+     * @return true if record was filled
+     */
+    bool update(const GPSData& data, uint32_t fixTod, ManoeuvreRecord& record);
+
+    /**
+     * @brief A capture window is open
+     */
+    bool isCapturing() const;
+
+    /**
+     * @brief Build the real-time event of a manoeuvre (eventSequence set by the caller)
+     */
+    void fillEvent(const ManoeuvreRecord& record, EventPacket& event) const;
+
+    /**
+     * @brief Print manoeuvre report (status update)
+     */
+    void printReport();
+
+private:
+    struct Sample {
+        uint32_t fixMillis;
+        uint32_t timestamp;
+        uint32_t tod;
+        int32_t latitude;
+        int32_t longitude;
+        uint16_t speedCms;
+        uint16_t baselineCms;      ///< Reference speed at this fix
+        int16_t courseDeci;
+    };
+
+    static const uint8_t HISTORY = 32;                  ///< 3 s at 10 Hz
+    static const uint32_t PRE_ROLL_MS = 3000;           ///< Window starts before the trigger
+    static const uint32_t SETTLE_MS = 3000;             ///< Stable course closing the window
+    static const uint32_t MAX_CAPTURE_MS = 20000;       ///< Window length limit
+    static const uint32_t BASELINE_TAU_MS = 5000;       ///< Reference speed time constant
+    static const uint32_t MAX_GAP_MS = 2000;            ///< No turn rate across longer gaps
+    static constexpr float TRIGGER_DEG_S = 12.0f;       ///< Turn rate opening a window
+    static constexpr float SLOW_TRIGGER_DEG_S = 5.0f;   ///< Turn rate opening a window with speed loss
+    static constexpr float SETTLED_DEG_S = 4.0f;        ///< Course considered stable below
+    static const uint16_t MIN_ENTRY_CMS = 77;           ///< 1.5 kn: slower boats are not manoeuvring
+    static const uint16_t COURSE_CMS = 51;              ///< 1 kn: course is noise below
+    static const int16_t MIN_CHANGE_DECI = 450;         ///< Smaller course changes are not reported
+
+    Sample history[HISTORY];
+    uint8_t historyHead;           ///< Oldest sample
+    uint8_t historyCount;
+    uint32_t baselineCms;
+    Sample last;
+    bool hasLast;
+
+    bool capturing;
+    Sample entry;
+    uint32_t triggerMillis;        ///< fixMillis of the trigger (recovery time origin)
+    LocalFrame frame;              ///< Origin at the window start
+    uint16_t minSpeedCms;
+    int32_t recoveryMs;
+    uint32_t settledSince;         ///< fixMillis since the course is stable (0 = turning)
+    int32_t windFromDeci;          ///< Wind reference (-1 = unknown)
+    int16_t minAbsWindAngleDeci;   ///< Closest bow-to-wind angle in the window
+
+    uint16_t windows;              ///< Windows opened
+    uint16_t reported;             ///< Manoeuvres reported
+    uint32_t captureMs;            ///< Time spent in windows
+    ManoeuvreRecord lastRecord;
+
+    /**
+     * @brief Open a window at the oldest sample within PRE_ROLL_MS
+     */
+    void open(const Sample& trigger);
+
+    /**
+     * @brief Close the window and compute the metrics
+     * @return true if the course change is large enough to be reported
+     */
+    bool close(const Sample& exit, ManoeuvreRecord& record);
+
+    /**
+     * @brief Track the closest bow-to-wind angle
+     */
+    void trackWindAngle(int16_t courseDeci);
+};
+
+#endif // MANOEUVRE_CAPTURE_H
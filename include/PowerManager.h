@@ -0,0 +1,154 @@
+/**
+ * @file PowerManager.h
+ * @brief Gestion de l'énergie : fréquence CPU et light sleep entre les fixes
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Remplace le delay(10) de loop() par une attente adaptée au profil:
+ * - PERFORMANCE : 240 MHz, boucle toutes les 10 ms (comportement historique)
+ * - BALANCED    : 80 MHz (DFS vers 40 MHz si esp_pm est disponible)
+ * - ENDURANCE   : 80 MHz + light sleep entre les rafales NMEA et les
+ *                 instants d'émission (réveil timer + GPIO sur RX GPS)
+ *
+ * Le réveil est programmé avant la prochaine échéance radio (slot TDMA
+ * ou instant d'émission) et avant la prochaine rafale NMEA prévue, avec
+ * une marge couvrant la latence de réveil et la remise en route du PHY.
+ *
+ * Statistiques: temps actif / en veille, réveils, latence fix → émission,
+ * courant moyen estimé et énergie par fix (ESP32 + récepteur GNSS,
+ * modèle nominal, voir POWER_MANAGEMENT.md). Les gains des profils sont
+ * des estimations : aucun n'a encore été mesuré sur carte.
+ *
+ * En ENDURANCE, la radio est coupée pendant la veille : les trames
+ * reçues pendant ce temps (configuration, compte à rebours, anémomètre,
+ * positions des autres bateaux) sont perdues, à proportion du temps de
+ * veille.
+ */
+
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+#include "GPS.h"
+
+/**
+ * @brief Power profiles (ConfigKey CFG_POWER_PROFILE)
+ */
+enum PowerProfile : uint8_t {
+    POWER_PERFORMANCE = 0,   ///< 240 MHz, no sleep
+    POWER_BALANCED = 1,      ///< 80 MHz (DFS when available), no sleep
+    POWER_ENDURANCE = 2      ///< 80 MHz + light sleep between fixes (no reception while asleep)
+};
+
+/**
+ * @brief Power manager class
+ */
+class PowerManager {
+public:
+    /**
+     * @brief Constructor
+     */
+    PowerManager();
+
+    /**
+     * @brief Initialize power management
+     * @param gps GPS instance (NMEA activity used to schedule wake-ups)
+     * @param gpsRxPin GPIO receiving GPS data (light sleep wake source)
+     * @param profile Initial profile
+     */
+    void begin(GPS* gps, uint8_t gpsRxPin, PowerProfile profile);
+
+    /**
+     * @brief Change profile (CPU frequency applied immediately)
+     * @param profile New profile
+     */
+    void setProfile(PowerProfile profile);
+
+    /**
+     * @brief Get active profile
+     */
+    PowerProfile getProfile() const;
+
+    /**
+     * @brief Wait until the next loop iteration (replaces delay(10))
+     * @param nextDeadline millis() of the next radio send instant
+     */
+    void idle(uint32_t nextDeadline);
+
+    /**
+     * @brief Record a broadcast for fix-to-air latency statistics
+     * @param fixMillis millis() when the broadcast fix was parsed
+     * @param sendMillis millis() when the frame was handed to ESP-NOW
+     */
+    void recordBroadcast(uint32_t fixMillis, uint32_t sendMillis);
+
+    /**
+     * @brief Print power report (status update) and reset latency window
+     */
+    void printReport();
+
+private:
+    GPS* gps;
+    uint8_t gpsRxPin;
+    PowerProfile profile;
+    bool dfsActive;                 ///< esp_pm dynamic frequency scaling enabled
+
+    uint32_t burstPeriodMs;         ///< Measured period of NMEA bursts (EMA, 0 = unknown)
+    uint32_t lastBurstStart;        ///< Burst start seen at previous idle() call
+
+    uint64_t sleepUs;               ///< Time spent in light sleep since accountingSince
+    int64_t accountingSince;        ///< esp_timer time when accounting (re)started
+    uint32_t accountingFixes;       ///< GPS fix count when accounting (re)started
+    uint32_t timerWakeups;          ///< Light sleep ended by timer
+    uint32_t gpioWakeups;           ///< Light sleep ended by GPS data (first bytes lost)
+
+    uint32_t latencySum;            ///< Fix-to-air latency sum (current report window)
+    uint32_t latencyMax;            ///< Fix-to-air latency max (current report window)
+    uint32_t latencyCount;          ///< Broadcasts in the current report window
+
+    static const uint32_t WAKE_GUARD_MS = 8;     ///< Wake-up + PHY restart margin
+    static const uint32_t MIN_SLEEP_MS = 15;     ///< Shorter waits use delay()
+    static const uint32_t MAX_SLEEP_MS = 1000;   ///< Upper bound of one light sleep
+    static const uint32_t RX_QUIET_MS = 10;      ///< UART quiet time before sleeping
+    static const uint32_t LOOP_DELAY_MS = 10;    ///< Historical loop period
+
+    /**
+     * @brief Apply CPU frequency / DFS for the current profile
+     */
+    void applyFrequency();
+
+    /**
+     * @brief Log the applied profile (ENDURANCE: reception warning)
+     */
+    void printProfile();
+
+    /**
+     * @brief Enter light sleep for the given duration
+     */
+    void lightSleep(uint32_t durationMs);
+
+    /**
+     * @brief Nominal average current for the time spent since boot (mA)
+     */
+    float estimatedCurrentMa() const;
+};
+
+#endif // POWER_MANAGER_H
@@ -0,0 +1,224 @@
+/**
+ * @file ProximityMonitor.h
+ * @brief Alerte de proximité : table de la flotte, hachage spatial et point de plus proche approche
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Table de la flotte: chaque GPSBroadcastPacket reçu met à jour la
+ * position (repère local, mm) et la vitesse (mm/s) de son émetteur. Les
+ * bateaux sont rangés dans une table de hachage par case de 32,8 m du
+ * repère local (listes chaînées d'index, aucune allocation).
+ *
+ * À chaque fix, seules les cases autour du bateau sont parcourues : le
+ * rayon couvre la distance de rapprochement maximale sur l'horizon
+ * d'alerte. Pour chaque voisin, point de plus proche approche (CPA) en
+ * mouvement rectiligne uniforme :
+ * - tCPA = -(r · v) / |v|², r et v relatifs, positions extrapolées à
+ *   l'instant du fix
+ * - dCPA = |r + v × tCPA|
+ *
+ * Niveaux: CONVERGING si dCPA < CPA_DISTANCE_MM dans l'horizon,
+ * DANGER si le CPA est à moins de DANGER_TCPA_MS ou le voisin déjà à
+ * moins de DANGER_DISTANCE_MM.
+ */
+
+#ifndef PROXIMITY_MONITOR_H
+#define PROXIMITY_MONITOR_H
+
+#include <Arduino.h>
+#include "GPS.h"
+#include "Communication.h"
+#include "Geodesy.h"
+
+/**
+ * @brief Proximity alert level (LED colour)
+ */
+enum ProximityLevel : uint8_t {
+    PROXIMITY_CLEAR = 0,         ///< No converging boat
+    PROXIMITY_CONVERGING = 1,    ///< CPA closer than CPA_DISTANCE_MM within the horizon
+    PROXIMITY_DANGER = 2         ///< CPA within DANGER_TCPA_MS, or already very close
+};
+
+/**
+ * @brief Fleet table with a spatial hash and closest point of approach alerts
+ */
+class ProximityMonitor {
+public:
+    /**
+     * @brief Constructor
+     */
+    ProximityMonitor();
+
+    /**
+     * @brief Alert horizon
+     * @param tcpaS Largest time to CPA raising an alert (s, 0 = alerts off, table kept)
+     */
+    void setHorizon(uint8_t tcpaS);
+
+    /**
+     * @brief Update the fleet table with a received position
+     * @param mac Sender MAC address
+     * @param packet Received packet
+     * @param receivedAt millis() at reception
+     * @return true if the position was accepted (not a repeat or a relay)
+     */
+    bool applyBoat(const uint8_t* mac, const GPSBroadcastPacket& packet, uint32_t receivedAt);
+
+    /**
+     * @brief Check the neighbours for a new own fix
+     * @param data New fix
+     * @return Current alert level
+     */
+    ProximityLevel update(const GPSData& data);
+
+    /**
+     * @brief Current alert level
+     */
+    ProximityLevel getLevel() const;
+
+    /**
+     * @brief Name of the most threatening boat (empty when clear)
+     */
+    const char* getThreatName() const;
+
+    /**
+     * @brief Distance at the CPA of the most threatening boat (mm)
+     */
+    uint32_t getThreatCpaMm() const;
+
+    /**
+     * @brief Time to the CPA of the most threatening boat (ms)
+     */
+    uint32_t getThreatTcpaMs() const;
+
+    /**
+     * @brief Boats in the table
+     */
+    uint8_t getBoatCount() const;
+
+    /**
+     * @brief CPA computed by the last update() (boats of the searched cells)
+     */
+    uint32_t getLastChecks() const;
+
+    /**
+     * @brief Table entries walked by the last update() (bucket chains)
+     */
+    uint32_t getLastVisits() const;
+
+    /**
+     * @brief Print proximity report (status update)
+     */
+    void printReport();
+
+private:
+    struct Neighbour {
+        char name[18];
+        uint8_t mac[6];
+        uint16_t bucket;           ///< Hash bucket (FREE = free slot)
+        uint8_t next;              ///< Next boat in the bucket (NONE = end)
+        int16_t cellX;
+        int16_t cellY;
+        int32_t latitude;          ///< 1e-7 deg
+        int32_t longitude;
+        LocalPoint position;       ///< At reception
+        int32_t vx;                ///< mm/s east
+        int32_t vy;                ///< mm/s north
+        uint32_t receivedAt;
+        uint32_t sequenceNumber;
+    };
+
+    static const uint8_t MAX_BOATS = 128;
+    static const uint16_t BUCKETS = 256;                ///< Power of 2, above the 13 × 13 searched cells
+    static const uint8_t NONE = 0xFF;
+    static const uint16_t FREE = 0xFFFF;                ///< bucket of a free slot
+    static const uint8_t CELL_SHIFT = 15;               ///< Cell = 32.8 m (mm >> 15)
+    static const uint8_t MAX_SEARCH_CELLS = 6;          ///< At most 13 × 13 cells per fix
+    static const uint32_t STALE_MS = 5000;              ///< Boats not heard since are dropped
+    static const uint8_t SWEEP_PER_FIX = 4;             ///< Slots checked for staleness per fix
+    static const int32_t MAX_CLOSING_MMPS = 6000;       ///< Search radius: closing speed bound
+    static const int32_t MAX_SPEED_KN = 50;             ///< Larger speeds are rejected
+    static const uint32_t CPA_DISTANCE_MM = 10000;      ///< Converging below this CPA
+    static const uint32_t DANGER_DISTANCE_MM = 3000;    ///< Danger at this distance, whatever the CPA
+    static const uint32_t DANGER_TCPA_MS = 3000;        ///< Danger when the CPA is this close in time
+    static const int32_t RECENTRE_MM = 10000000;        ///< 10 km: move the frame origin
+
+    LocalFrame frame;
+    Neighbour boats[MAX_BOATS];
+    uint8_t heads[BUCKETS];        ///< First boat of each bucket
+    uint8_t boatCount;
+    uint8_t sweepIndex;
+    uint32_t horizonMs;
+    uint8_t searchCells;           ///< Cells searched on each side of the own cell
+
+    ProximityLevel level;
+    char threatName[18];
+    uint32_t threatCpaMm;
+    uint32_t threatTcpaMs;
+
+    uint32_t accepted;             ///< Positions applied
+    uint32_t evicted;              ///< Boats dropped from a full table
+    uint32_t alerts;               ///< Clear -> converging / danger transitions
+    uint32_t checksSum;            ///< CPA computed (report window)
+    uint32_t checksMax;
+    uint32_t lastChecks;           ///< CPA computed by the last update()
+    uint32_t lastVisits;           ///< Entries walked by the last update()
+    uint32_t cyclesSum;            ///< CPU cycles spent in update() (report window)
+    uint32_t cyclesMax;
+    uint32_t cyclesCount;
+
+    /**
+     * @brief Hash bucket of a cell
+     */
+    static uint16_t bucketOf(int16_t cellX, int16_t cellY);
+
+    /**
+     * @brief Cell of a frame position
+     */
+    static int16_t cellOf(int32_t mm);
+
+    /**
+     * @brief Insert a boat in the bucket of its cell
+     */
+    void link(uint8_t index);
+
+    /**
+     * @brief Remove a boat from its bucket
+     */
+    void unlink(uint8_t index);
+
+    /**
+     * @brief Project a boat and move it to its new cell if needed
+     */
+    void place(uint8_t index);
+
+    /**
+     * @brief Free slot, or the boat heard least recently
+     */
+    uint8_t allocate();
+
+    /**
+     * @brief Move the frame origin and re-project the table
+     */
+    void recentre(int32_t latE7, int32_t lonE7);
+};
+
+#endif // PROXIMITY_MONITOR_H
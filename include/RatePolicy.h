@@ -0,0 +1,152 @@
+/**
+ * @file RatePolicy.h
+ * @brief Cadence de broadcast et de log adaptée à la vitesse et au taux de virage
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Choisit la cadence d'émission (et donc de log) à chaque fix:
+ * - Arrêté (< 0,5 nœud)           : 0,5 Hz
+ * - Route stable                  : cadence de base (config, 1 Hz par défaut)
+ * - Rapide (> 6 nœuds)            : 2 Hz
+ * - Manœuvre (virage > 10 °/s)    : 5 Hz (NEO-6M) / 10 Hz (AT6668)
+ *
+ * Une cadence élevée est maintenue RATE_HOLD_MS après le dernier
+ * déclenchement pour éviter les oscillations.
+ *
+ * Budget canal: seau à jetons (cadence moyenne par bateau, config). Les
+ * manœuvres peuvent dépasser la moyenne tant que le seau n'est pas vide,
+ * ensuite la cadence est limitée au budget.
+ *
+ * TDMA: seules les cadences inférieures ou égales à la cadence de base
+ * sont possibles (multiples de l'intervalle, même slot).
+ *
+ * Forçage: une fenêtre coordonnée (procédure de départ) impose son
+ * intervalle, hors budget et hors arrondi TDMA.
+ */
+
+#ifndef RATE_POLICY_H
+#define RATE_POLICY_H
+
+#include <Arduino.h>
+#include "GPS.h"
+
+/**
+ * @brief Speed and turn-rate adaptive broadcast rate
+ */
+class RatePolicy {
+public:
+    /**
+     * @brief Constructor (adaptive rate disabled, 1 Hz)
+     */
+    RatePolicy();
+
+    /**
+     * @brief Apply configuration
+     * @param baseIntervalMs Broadcast interval of a boat on a steady course
+     * @param adaptive Enable speed/turn-rate adaptation
+     * @param budgetDeciHz Average channel budget per boat (0.1 Hz units)
+     * @param tdma TDMA enabled (only slower rates are allowed)
+     */
+    void configure(uint16_t baseIntervalMs, bool adaptive, uint8_t budgetDeciHz, bool tdma);
+
+    /**
+     * @brief Update the policy with a new fix
+     * @param data Fix (fixMillis used as time base)
+     */
+    void update(const GPSData& data);
+
+    /**
+     * @brief Record a broadcast (consumes one token of the channel budget)
+     * @param now millis() of the broadcast
+     */
+    void recordBroadcast(uint32_t now);
+
+    /**
+     * @brief Force an interval (coordinated high-rate window)
+     * @param intervalMs Forced interval, 0 = back to the adaptive policy
+     */
+    void setOverride(uint16_t intervalMs);
+
+    /**
+     * @brief A forced interval is active
+     */
+    bool hasOverride() const;
+
+    /**
+     * @brief Interval until the next broadcast, budget applied
+     * @return Interval in milliseconds
+     */
+    uint16_t getIntervalMs() const;
+
+    /**
+     * @brief Current rate in 0.1 Hz units (carried in GPSBroadcastPacket)
+     */
+    uint8_t getRateDeciHz() const;
+
+    /**
+     * @brief Smoothed turn rate in degrees per second
+     */
+    float getTurnRate() const;
+
+    /**
+     * @brief Print rate report (status update)
+     */
+    void printReport();
+
+private:
+    uint16_t baseIntervalMs;
+    bool adaptive;
+    uint8_t budgetDeciHz;
+    bool tdma;
+
+    uint16_t targetIntervalMs;     ///< Interval chosen from speed / turn rate
+    uint16_t overrideIntervalMs;   ///< Forced interval (0 = none)
+    uint32_t holdUntil;            ///< millis() until which a faster interval is kept
+    float turnRate;                ///< Smoothed turn rate (deg/s, EMA)
+    float lastCourse;              ///< Course of the previous fix
+    uint32_t lastFixMillis;        ///< fixMillis of the previous fix (0 = none)
+
+    uint32_t tokens;               ///< Channel budget bucket (1/1000 frame)
+    uint32_t lastRefill;           ///< millis() of the last bucket refill
+    uint32_t throttled;            ///< Broadcasts limited by the budget since boot
+
+    static const uint16_t STATIONARY_INTERVAL_MS = 2000;   ///< 0.5 Hz
+    static const uint16_t FAST_INTERVAL_MS = 500;          ///< 2 Hz
+#ifdef CONFIG_IDF_TARGET_ESP32S3
+    static const uint16_t MANOEUVRE_INTERVAL_MS = 100;     ///< 10 Hz (AT6668)
+#else
+    static const uint16_t MANOEUVRE_INTERVAL_MS = 200;     ///< 5 Hz (NEO-6M maximum)
+#endif
+    static const uint32_t RATE_HOLD_MS = 3000;             ///< Keep a faster rate this long
+    static const uint32_t TOKEN = 1000;                    ///< One frame in bucket units
+    static const uint32_t BUDGET_BURST_S = 10;             ///< Bucket depth in seconds of budget
+    static constexpr float STATIONARY_SPEED = 0.5f;        ///< Knots
+    static constexpr float FAST_SPEED = 6.0f;              ///< Knots
+    static constexpr float MANOEUVRE_TURN_RATE = 10.0f;    ///< Degrees per second
+    static constexpr float MIN_COURSE_SPEED = 1.0f;        ///< Course is noise below this speed
+
+    /**
+     * @brief Refill the token bucket up to now
+     */
+    void refill(uint32_t now);
+};
+
+#endif // RATE_POLICY_H
@@ -0,0 +1,246 @@
+/**
+ * @file SessionStats.h
+ * @brief Statistiques de session incrémentales : distance, vitesses, virements
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Coût O(1) par fix (pas de relecture des logs):
+ * - Distance parcourue : segments entre fixes dans un LocalFrame, ignorés
+ *   à l'arrêt (dérive GPS)
+ * - Vitesse moyenne glissante sur 2 s et 10 s : anneaux d'échantillons
+ *   avec somme courante
+ * - Vitesse max : maximum de la moyenne 2 s (un fix aberrant isolé ne
+ *   fait pas le record)
+ * - Manœuvres : changement de cap ≥ 70° sur la fenêtre de 10 s
+ * - Virements / empannages et temps sur chaque bord : avec une direction
+ *   de vent de référence (perpendiculaire à la ligne de départ, ou vent
+ *   réel), le bord est le côté d'où vient le vent ; un changement de bord
+ *   par le lit du vent est un virement, par le vent arrière un empannage
+ */
+
+#ifndef SESSION_STATS_H
+#define SESSION_STATS_H
+
+#include <Arduino.h>
+#include "GPS.h"
+#include "Geodesy.h"
+
+/**
+ * @brief Tack side (wind over the starboard or port side)
+ */
+enum TackSide : uint8_t {
+    TACK_UNKNOWN = 0,
+    TACK_STARBOARD = 1,
+    TACK_PORT = 2
+};
+
+/**
+ * @brief Speed samples over a sliding time window, running sum
+ */
+class SpeedWindow {
+public:
+    /**
+     * @brief Constructor
+     * @param windowMs Window length (ms)
+     */
+    explicit SpeedWindow(uint32_t windowMs);
+
+    /**
+     * @brief Empty the window
+     */
+    void clear();
+
+    /**
+     * @brief Add a sample and drop the ones older than the window
+     * @param fixMillis millis() of the fix
+     * @param speedCms Speed (cm/s)
+     * @param courseDeci Course (0.1 deg)
+     */
+    void push(uint32_t fixMillis, uint16_t speedCms, int16_t courseDeci);
+
+    /**
+     * @brief Average speed over the window (cm/s, 0 if empty)
+     */
+    uint16_t getAverageCms() const;
+
+    /**
+     * @brief Oldest sample course in the window (0.1 deg)
+     */
+    int16_t getOldestCourseDeci() const;
+
+    /**
+     * @brief Time span covered by the samples (ms)
+     */
+    uint32_t getSpanMs() const;
+
+private:
+    struct Sample {
+        uint32_t fixMillis;
+        uint16_t speedCms;
+        int16_t courseDeci;
+    };
+
+    static const uint8_t CAPACITY = 104;    ///< 10 s at 10 Hz, with margin
+
+    Sample samples[CAPACITY];
+    uint32_t windowMs;
+    uint8_t head;                  ///< Oldest sample
+    uint8_t count;
+    uint32_t sumCms;
+};
+
+/**
+ * @brief Streaming session statistics, O(1) per fix
+ */
+class SessionStats {
+public:
+    /**
+     * @brief Constructor
+     */
+    SessionStats();
+
+    /**
+     * @brief Start a new session (all counters to zero)
+     */
+    void reset();
+
+    /**
+     * @brief Wind reference for tack sides
+     * @param fromDeg Direction the wind blows from (degrees), negative = unknown
+     */
+    void setWindDirection(float fromDeg);
+
+    /**
+     * @brief Update the statistics with a new fix
+     * @param data New fix
+     */
+    void update(const GPSData& data);
+
+    /**
+     * @brief At least one valid fix in this session
+     */
+    bool hasData() const;
+
+    /**
+     * @brief Unix timestamp of the first fix of the session
+     */
+    uint32_t getStartTimestamp() const;
+
+    /**
+     * @brief Session duration since the first fix (s)
+     */
+    uint32_t getDurationS() const;
+
+    /**
+     * @brief Time spent moving (s)
+     */
+    uint32_t getMovingS() const;
+
+    /**
+     * @brief Distance sailed (m)
+     */
+    uint32_t getDistanceM() const;
+
+    /**
+     * @brief Average speed over the last 2 s (cm/s)
+     */
+    uint16_t getSpeed2sCms() const;
+
+    /**
+     * @brief Average speed over the last 10 s (cm/s)
+     */
+    uint16_t getSpeed10sCms() const;
+
+    /**
+     * @brief Maximum 2 s average speed (cm/s)
+     */
+    uint16_t getMaxSpeedCms() const;
+
+    /**
+     * @brief Session average speed while moving (cm/s)
+     */
+    uint16_t getAverageSpeedCms() const;
+
+    /**
+     * @brief Course changes of 70 degrees or more (with or without wind reference)
+     */
+    uint16_t getManoeuvres() const;
+
+    /**
+     * @brief Tacks (requires a wind reference)
+     */
+    uint16_t getTacks() const;
+
+    /**
+     * @brief Gybes (requires a wind reference)
+     */
+    uint16_t getGybes() const;
+
+    /**
+     * @brief Current tack side
+     */
+    TackSide getSide() const;
+
+    /**
+     * @brief Time spent on a tack side (s)
+     */
+    uint32_t getTackTimeS(TackSide side) const;
+
+    /**
+     * @brief Print statistics report (status update)
+     */
+    void printReport();
+
+private:
+    LocalFrame frame;              ///< Recentred when the boat goes far from the origin
+    int32_t lastLat;               ///< Previous fix (1e-7 deg)
+    int32_t lastLon;
+    uint32_t lastFixMillis;        ///< 0 = no previous fix
+    uint32_t startTimestamp;       ///< Unix time of the first fix
+    uint32_t lastTimestamp;        ///< Unix time of the last fix
+    uint32_t movingMs;
+    uint64_t distanceMm;
+
+    SpeedWindow window2s;
+    SpeedWindow window10s;
+    uint16_t maxSpeedCms;
+
+    int32_t windFromDeci;          ///< Wind reference (0.1 deg, -1 = unknown)
+    uint16_t manoeuvres;
+    uint32_t lastManoeuvreMs;
+    uint16_t tacks;
+    uint16_t gybes;
+    TackSide side;                 ///< Last settled side
+    int16_t minAbsWindAngleDeci;   ///< Smallest |wind angle| since the last settled fix
+    uint32_t tackMs[3];            ///< Time on each side (TackSide index)
+
+    static const uint32_t MAX_LEG_MS = 2000;                ///< Longer gaps are not timed
+    static const uint32_t RECENTRE_MM = 10000000;           ///< 10 km: move the frame origin
+    static const int16_t MANOEUVRE_DECI = 700;              ///< Course change over 10 s
+    static const uint32_t MANOEUVRE_GAP_MS = 10000;         ///< One manoeuvre per window
+    static const int16_t SETTLED_MIN_DECI = 300;            ///< Not head to wind
+    static const int16_t SETTLED_MAX_DECI = 1650;           ///< Not dead downwind
+    static const int16_t REFERENCE_SHIFT_DECI = 450;        ///< Wind shift that invalidates the current side
+    static const uint16_t MOVING_CMS = 26;                  ///< 0.5 knot
+    static const uint16_t COURSE_CMS = 51;                  ///< 1 knot: course is noise below
+};
+
+#endif // SESSION_STATS_H
@@ -0,0 +1,207 @@
+/**
+ * @file StartLine.h
+ * @brief Ligne de départ : distance signée, temps jusqu'à la ligne et OCS à chaque fix
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Extrémités de la ligne:
+ * - Bouton M5 : double clic = bateau comité, triple clic = bouée, à la
+ *   position courante (enregistrées en NVS, clé "start_line")
+ * - Configuration de flotte : clés 14-17 (1e-7 degré), prioritaires
+ * - Trame StartCountdownPacket du comité
+ *
+ * Calcul à chaque fix, en virgule fixe (ESP32 : pas de FPU double):
+ * - Position en 1e-7 degré (int32), projetée en millimètres est/nord
+ *   dans un LocalFrame (Geodesy.h) centré sur le bateau comité
+ * - Distance signée à la ligne (mm, > 0 côté pré-départ)
+ * - Vitesse de rapprochement (mm/s) : composante de la vitesse GPS sur
+ *   la normale à la ligne, sinus/cosinus en table Q15
+ * - Temps jusqu'à la ligne à cette vitesse
+ * - OCS : côté parcours avant le signal, maintenu après le signal
+ *   jusqu'au retour côté pré-départ
+ *
+ * Le coût du calcul (cycles CPU par fix) est mesuré en continu et affiché
+ * dans le rapport d'état.
+ */
+
+#ifndef START_LINE_H
+#define START_LINE_H
+
+#include <Arduino.h>
+#include "GPS.h"
+#include "Geodesy.h"
+
+/**
+ * @brief Line end selector
+ */
+enum LineEnd : uint8_t {
+    LINE_COMMITTEE = 0,      ///< Committee boat (starboard end)
+    LINE_PIN = 1             ///< Pin end (port end)
+};
+
+/**
+ * @brief Start line geometry in fixed point
+ */
+class StartLine {
+public:
+    /**
+     * @brief Constructor
+     */
+    StartLine();
+
+    /**
+     * @brief Load line ends set with the button (NVS)
+     */
+    void begin();
+
+    /**
+     * @brief Set one end at the given position and save it (button)
+     * @param end Line end
+     * @param latitude Latitude in degrees
+     * @param longitude Longitude in degrees
+     */
+    void setEnd(LineEnd end, double latitude, double longitude);
+
+    /**
+     * @brief Set both ends (config frame / committee countdown), not saved
+     * @param committeeLat Committee end latitude (1e-7 deg)
+     * @param committeeLon Committee end longitude (1e-7 deg)
+     * @param pinLat Pin end latitude (1e-7 deg)
+     * @param pinLon Pin end longitude (1e-7 deg)
+     */
+    void setLine(int32_t committeeLat, int32_t committeeLon, int32_t pinLat, int32_t pinLon);
+
+    /**
+     * @brief Both ends are known and at least 1 m apart
+     */
+    bool hasLine() const;
+
+    /**
+     * @brief Compute line metrics for a new fix
+     * @param data New fix
+     * @param beforeGun true while the start countdown is running
+     * @return true if the metrics are valid (line known, valid fix)
+     */
+    bool update(const GPSData& data, bool beforeGun);
+
+    /**
+     * @brief Signed distance to the line (mm, > 0 pre-start side)
+     */
+    int32_t getDistanceMm() const;
+
+    /**
+     * @brief Time to the line at the current closing speed (ms, INT32_MAX = not closing)
+     */
+    int32_t getTimeToLineMs() const;
+
+    /**
+     * @brief Closing speed toward the line (mm/s, > 0 = approaching from pre-start side)
+     */
+    int32_t getClosingMmps() const;
+
+    /**
+     * @brief On course side before the gun (or not yet returned)
+     */
+    bool isOCS() const;
+
+    /**
+     * @brief Last fix, mm east of the committee end
+     */
+    int32_t getX() const;
+
+    /**
+     * @brief Last fix, mm north of the committee end
+     */
+    int32_t getY() const;
+
+    /**
+     * @brief Projection of a point on the line, Q16 (0 = committee end, 65536 = pin end)
+     * @param px mm east of the committee end
+     * @param py mm north of the committee end
+     */
+    int32_t alongLineQ16(int32_t px, int32_t py) const;
+
+    /**
+     * @brief Convert a line frame position back to degrees
+     * @param px mm east of the committee end
+     * @param py mm north of the committee end
+     * @param latitude Output latitude (degrees)
+     * @param longitude Output longitude (degrees)
+     */
+    void toLatLon(int32_t px, int32_t py, double& latitude, double& longitude) const;
+
+    /**
+     * @brief Bearing from the line toward the course side (degrees)
+     *
+     * The committee sets the line square to the wind for an upwind first
+     * leg: this is the usual wind reference when no wind sensor is available.
+     */
+    float getCourseSideBearing() const;
+
+    /**
+     * @brief Line length (m)
+     */
+    float getLengthM() const;
+
+    /**
+     * @brief Print line report (status update)
+     */
+    void printReport();
+
+private:
+    int32_t endLat[2];             ///< Line ends latitude (1e-7 deg, LineEnd index)
+    int32_t endLon[2];             ///< Line ends longitude (1e-7 deg)
+    bool endSet[2];
+    bool valid;
+
+    LocalFrame frame;              ///< Local frame, origin at the committee end
+    int32_t lineX;                 ///< Pin end, mm east of the committee end
+    int32_t lineY;                 ///< Pin end, mm north of the committee end
+    int32_t lengthMm;              ///< Line length (mm)
+    int32_t normalX;               ///< Unit normal toward the pre-start side, Q15
+    int32_t normalY;
+    float courseSideBearing;       ///< Bearing of -normal (degrees)
+
+    int32_t x;                     ///< Last fix, mm east of the committee end
+    int32_t y;                     ///< Last fix, mm north of the committee end
+    int32_t distanceMm;
+    int32_t closingMmps;
+    int32_t timeToLineMs;
+    bool ocs;
+
+    uint32_t cyclesSum;            ///< CPU cycles spent in update() (report window)
+    uint32_t cyclesMax;
+    uint32_t cyclesCount;
+
+    static const int32_t MIN_CLOSING_MMPS = 50;    ///< Slower closing: time to line = INT32_MAX
+
+    /**
+     * @brief Recompute frame origin, line vector and normal
+     */
+    void prepare();
+
+    /**
+     * @brief Save button-set ends to NVS
+     */
+    void save();
+};
+
+#endif // START_LINE_H
@@ -0,0 +1,173 @@
+/**
+ * @file StartSequence.h
+ * @brief Procédure de départ : compte à rebours, cadence rapide et franchissement de ligne
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Déclenchement:
+ * - Bouton M5 (clic simple) : départ dans countdownS secondes ; un
+ *   nouveau clic pendant le compte à rebours le recale à la minute la
+ *   plus proche (comme une montre de régate)
+ * - Trame StartCountdownPacket du comité, signée avec la clé de flotte :
+ *   heure GPS du signal, fenêtre, extrémités de la ligne (1e-7 degré)
+ *
+ * Toutes les heures sont des heures GPS du jour (ms depuis 00:00 UTC) :
+ * tous les bateaux partagent la même référence, ce qui permet un TDMA
+ * rapide coordonné pendant la fenêtre.
+ *
+ * Fenêtre rapide: de windowS secondes avant le signal jusqu'à
+ * POST_START_MS après. Hors fenêtre, la cadence normale reprend.
+ *
+ * Franchissement de ligne: changement de côté entre deux fixes (distance
+ * signée calculée par StartLine), point d'intersection entre les
+ * extrémités, instant interpolé entre les fixes.
+ */
+
+#ifndef START_SEQUENCE_H
+#define START_SEQUENCE_H
+
+#include <Arduino.h>
+#include "GPS.h"
+#include "Communication.h"
+#include "StartLine.h"
+
+/**
+ * @brief Start sequence state
+ */
+enum StartState : uint8_t {
+    START_IDLE = 0,          ///< No start sequence
+    START_COUNTDOWN = 1,     ///< Gun time known, before the gun
+    START_RACING = 2         ///< After the gun, within POST_START_MS
+};
+
+/**
+ * @brief Start countdown, high-rate window and line crossing detection
+ */
+class StartSequence {
+public:
+    /**
+     * @brief Constructor
+     */
+    StartSequence();
+
+    /**
+     * @brief Attach the start line (geometry for crossing detection)
+     * @param line Start line, updated with each fix before update()
+     */
+    void begin(StartLine* line);
+
+    /**
+     * @brief Apply configuration
+     * @param countdownS Countdown started by the button (s)
+     * @param windowS High-rate window before the gun (s)
+     * @param burstIntervalMs Broadcast interval inside the window (ms)
+     */
+    void configure(uint16_t countdownS, uint16_t windowS, uint16_t burstIntervalMs);
+
+    /**
+     * @brief Button press: start the countdown, or sync it to the nearest minute
+     * @param nowTod Current GPS time of day (ms, 0 = unknown)
+     * @return true if the countdown was started or synced
+     */
+    bool buttonPressed(uint32_t nowTod);
+
+    /**
+     * @brief Abandon the start sequence
+     */
+    void cancel();
+
+    /**
+     * @brief Apply a countdown frame from the committee
+     * @param packet Received frame, already authenticated (Config::authenticate())
+     * @param nowTod Current GPS time of day (ms)
+     */
+    void applyCountdown(const StartCountdownPacket& packet, uint32_t nowTod);
+
+    /**
+     * @brief Advance the state (end of the post-start window)
+     * @param nowTod Current GPS time of day (ms)
+     */
+    void tick(uint32_t nowTod);
+
+    /**
+     * @brief Detect line crossings (after StartLine::update() for this fix)
+     * @param data New fix
+     * @param fixTod GPS time of day of the fix (ms)
+     * @param event Output event when the line was crossed (eventSequence set by the caller)
+     * @return true if event was filled
+     */
+    bool update(const GPSData& data, uint32_t fixTod, EventPacket& event);
+
+    /**
+     * @brief High-rate window active
+     * @param nowTod Current GPS time of day (ms)
+     */
+    bool isBurst(uint32_t nowTod) const;
+
+    /**
+     * @brief Broadcast interval inside the high-rate window (ms)
+     */
+    uint16_t getBurstIntervalMs() const;
+
+    /**
+     * @brief Current state
+     */
+    StartState getState() const;
+
+    /**
+     * @brief Time to the gun (ms, negative after the gun)
+     * @param nowTod Current GPS time of day (ms)
+     */
+    int32_t getTimeToGunMs(uint32_t nowTod) const;
+
+    /**
+     * @brief Print start report (status update)
+     * @param nowTod Current GPS time of day (ms)
+     */
+    void printReport(uint32_t nowTod);
+
+    /**
+     * @brief Signed difference a - b between two times of day (handles midnight)
+     * @return Difference in ms, in [-12 h, 12 h)
+     */
+    static int32_t todDiff(uint32_t a, uint32_t b);
+
+private:
+    StartState state;
+    uint32_t gunTod;               ///< GPS time of day of the gun (ms)
+    uint16_t countdownS;           ///< Countdown started by the button (s)
+    uint16_t windowS;              ///< Active high-rate window (s)
+    uint16_t configWindowS;        ///< High-rate window from config (s)
+    uint16_t burstIntervalMs;      ///< Broadcast interval in the window (ms)
+
+    StartLine* line;
+
+    bool hasPrevious;              ///< Previous fix available for crossing detection
+    int32_t prevDistanceMm;        ///< Signed distance of the previous fix (> 0 = pre-start side)
+    int32_t prevX;                 ///< Previous fix in the line frame (mm)
+    int32_t prevY;
+    uint32_t prevTod;
+    uint32_t crossings;            ///< Line crossings since boot
+
+    static const uint32_t POST_START_MS = 60000;   ///< High rate kept after the gun
+};
+
+#endif // START_SEQUENCE_H
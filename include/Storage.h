@@ -45,6 +45,12 @@
 #include <SD.h>
 #include <ArduinoJson.h>
 #include "GPS.h"
+#include "Communication.h"
+#include "SessionStats.h"
+#include "WindPerformance.h"
+#include "CourseSmoother.h"
+#include "TrackSimplifier.h"
+#include "ManoeuvreCapture.h"
 
 /**
  * @class Storage
@@ -76,6 +82,74 @@ public:
      */
     void writeGPSData(const GPSData& data, const uint8_t* macAddress, uint32_t sequenceNumber = 0);
     
+    /**
+     * @brief Feed a fix to the simplified track (every fix, not only broadcasts)
+     * @param data New fix
+     */
+    void writeTrackPoint(const GPSData& data);
+    
+    /**
+     * @brief Simplified track tolerance
+     * @param toleranceCm Maximum error of the simplified track (cm, 0 = every fix)
+     */
+    void setTrackTolerance(uint16_t toleranceCm);
+    
+    /**
+     * @brief Print simplified track report (status update)
+     */
+    void printTrackReport();
+    
+    /**
+     * @brief Write a real-time event (line crossing...) as one JSON line
+     * @param event Event as broadcast
+     * @param timestamp GPS timestamp of the fix that triggered the event
+     */
+    void writeEvent(const EventPacket& event, uint32_t timestamp);
+    
+    /**
+     * @brief Write the metrics of a manoeuvre as one JSON line
+     * @param record Completed manoeuvre
+     * @param eventSequence Sequence of the matching EventPacket
+     */
+    void writeManoeuvre(const ManoeuvreRecord& record, uint16_t eventSequence);
+    
+    /**
+     * @brief Append a raw NMEA sentence to the capture file of the session
+     * @param sentence Sentence without CR/LF
+     */
+    void writeRawNmea(const char* sentence);
+    
+    /**
+     * @brief Attach the session statistics written on rotation and session end
+     * @param stats Session statistics (nullptr = no summary)
+     */
+    void setSessionStats(const SessionStats* stats);
+    
+    /**
+     * @brief Attach the wind / performance values added to each GPS record
+     * @param performance Wind performance (nullptr = no wind fields)
+     */
+    void setWindPerformance(const WindPerformance* performance);
+    
+    /**
+     * @brief Attach the smoothed course / speed added to each GPS record
+     * @param smoother Course smoother (nullptr = raw values only)
+     */
+    void setCourseSmoother(const CourseSmoother* smoother);
+    
+    /**
+     * @brief Write the session summary as one JSON line
+     * @param final true at the end of the session, false on file rotation
+     */
+    void writeSessionSummary(bool final);
+    
+    /**
+     * @brief End the session: write the final summary, close the file and the track
+     * 
+     * The next valid fix opens a new file and a new track.
+     */
+    void endSession();
+    
     /**
      * @brief Check if SD card is available
      * @return true if SD card is mounted and working
@@ -101,11 +175,24 @@ private:
     uint32_t recordCount;                                     ///< Number of records in current file
     String currentFileName;                                   ///< Current file name
     String macAddressStr;                                     ///< MAC address string for filename
+    const SessionStats* sessionStats;                         ///< Summary source (nullptr = none)
+    const WindPerformance* windPerformance;                   ///< Wind fields source (nullptr = none)
+    const CourseSmoother* courseSmoother;                     ///< Smoothed course source (nullptr = none)
+    String sessionBaseName;                                   ///< First log file of the session, without prefix/extension
+    File trackFile;                                           ///< Simplified track of the session (CSV)
+    String trackFileName;
+    TrackSimplifier track;
+    File nmeaFile;                                            ///< Raw NMEA of the capture windows
+    String nmeaFileName;
     
     static const uint32_t MAX_FILE_SIZE = 10 * 1024 * 1024;  ///< 10 MB max file size
     static const uint32_t MAX_RECORDS_PER_FILE = 10000;      ///< Max records per file
     static const char* FILE_PREFIX;                          ///< File name prefix ("/gps_")
     static const char* FILE_EXTENSION;                       ///< File extension (".json")
+    static const char* TRACK_PREFIX;                         ///< Simplified track prefix ("/trk_")
+    static const char* TRACK_EXTENSION;                      ///< Simplified track extension (".csv")
+    static const char* NMEA_PREFIX;                          ///< Raw NMEA prefix ("/nmea_")
+    static const char* NMEA_EXTENSION;                       ///< Raw NMEA extension (".nmea")
     static const uint8_t MESSAGE_TYPE = 1;                   ///< Type 1 = Boat data
     
     /**
@@ -127,6 +214,27 @@ private:
      * @param data GPS data for new file timestamp
      */
     void rotateFile(const GPSData& data);
+    
+    /**
+     * @brief Open the simplified track file, named after the first log file of the session
+     * @return true if file created successfully
+     */
+    bool createTrackFile();
+    
+    /**
+     * @brief Session file name with another prefix and extension
+     */
+    String sessionFileName(const char* prefix, const char* extension) const;
+    
+    /**
+     * @brief Write the last pending track point and close the track file
+     */
+    void closeTrackFile();
+    
+    /**
+     * @brief Append one point to the simplified track (CSV line)
+     */
+    void writeTrackLine(const TrackPoint& point);
 };
 
 #endif // STORAGE_H
@@ -0,0 +1,143 @@
+/**
+ * @file TimeBeacon.h
+ * @brief Balise horaire GPS disciplinée par le récepteur GNSS
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Balise horaire GPS pour les appareils de la flotte sans GNSS
+ * (anémomètres, bouées) : l'horloge locale (esp_timer) est disciplinée par
+ * le récepteur, puis une TimeBeaconPacket part toutes les timeBeaconMs.
+ *
+ * Discipline : chaque rafale NMEA donne un ancrage (GPS::getTimeAnchor) :
+ * époque GNSS et heure locale du premier octet. Le premier octet arrive
+ * après l'époque d'un retard propre au module (calcul, UART), compensé par
+ * NMEA_LATENCY_US, plus le retard de loop() à le voir, toujours positif.
+ * Le meilleur ancrage de chaque période SAMPLE_PERIOD_US alimente un
+ * ClockEstimator en mode enveloppe (lib/BoatProtocol/TimeSync.h).
+ *
+ * Émission : l'horodatage est pris juste avant esp_now_send(). L'attente de
+ * la file d'émission et du canal est mesurée par le rappel d'envoi
+ * (Communication::sendTimedFrame) et part dans la balise suivante.
+ * Sans ancrage depuis HOLDOVER_AFTER_US, la balise est marquée
+ * TIME_HOLDOVER (dérive extrapolée), puis n'est plus émise après
+ * HOLDOVER_MAX_US.
+ */
+
+#ifndef TIME_BEACON_H
+#define TIME_BEACON_H
+
+#include <Arduino.h>
+#include <TimeSync.h>
+#include "GPS.h"
+#include "Communication.h"
+
+/**
+ * @brief GNSS-disciplined clock and periodic GPS time beacon
+ */
+class TimeBeacon {
+public:
+    /**
+     * @brief Constructor (beacon off)
+     */
+    TimeBeacon();
+
+    /**
+     * @brief Beacon interval
+     * @param intervalMs Interval between beacons (0 = off, the clock is still disciplined)
+     */
+    void setInterval(uint16_t intervalMs);
+
+    /**
+     * @brief Beacon enabled
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Take the new time anchor of the GPS, if any (after gps.update())
+     * @param gps GPS receiver
+     */
+    void update(const GPS& gps);
+
+    /**
+     * @brief Send the beacon when due
+     * @param comm Radio
+     * @param now Current millis()
+     * @return true if a beacon was sent
+     */
+    bool service(Communication& comm, uint32_t now);
+
+    /**
+     * @brief millis() of the next beacon (PowerManager wake-up)
+     */
+    uint32_t getNextBeacon() const;
+
+    /**
+     * @brief State of the clock at a local instant
+     * @param localUs esp_timer_get_time()
+     */
+    TimeSyncState getState(int64_t localUs) const;
+
+    /**
+     * @brief GPS time of a local instant
+     * @param localUs esp_timer_get_time()
+     * @param gpsUs GPS (UTC) time, µs since 1970-01-01
+     * @return false if the clock is not synchronised
+     */
+    bool getGpsTimeUs(int64_t localUs, int64_t& gpsUs) const;
+
+    /**
+     * @brief Print clock and beacon statistics (status update, nothing when off)
+     */
+    void printReport();
+
+private:
+    ClockEstimator clock;
+    uint16_t intervalMs;
+    uint32_t nextBeacon;           ///< millis() of the next beacon
+    uint16_t sequence;
+    uint32_t anchorCount;          ///< GPS anchors already read
+    bool bucketOpen;               ///< Anchors of the current sample period
+    int64_t bucketStartUs;
+    int64_t bucketLocalUs;         ///< Best anchor of the period (highest offset)
+    int64_t bucketOffsetUs;
+    int64_t lastStampUs;           ///< GPS time stamped in the last beacon
+    bool stampPending;             ///< Last beacon sent, its correction not read yet
+
+    uint32_t sent;                 ///< Beacons sent
+    uint32_t corrections;          ///< Beacons carrying a correction
+    uint32_t rejected;             ///< Anchors rejected as jumps
+    int64_t correctionSumUs;       ///< Report window
+    int32_t correctionMaxUs;
+    uint32_t correctionCount;
+
+    static const int64_t NMEA_LATENCY_US;                  ///< GNSS epoch to first NMEA byte (module)
+    static const int64_t SAMPLE_PERIOD_US = 900000;        ///< One clock sample per period (best anchor)
+    static const int64_t HOLDOVER_AFTER_US = 3000000;      ///< TIME_GNSS while anchors are this recent
+    static const int64_t HOLDOVER_MAX_US = 120000000;      ///< No beacon after this time without anchor
+    static const uint32_t HOLDOVER_DRIFT_PPM = 20;         ///< Slope error assumed in holdover (accuracy, see time_sync_sim)
+
+    /**
+     * @brief Correction of the last beacon (end of transmission minus stamp)
+     */
+    int32_t takeCorrection(Communication& comm);
+};
+
+#endif // TIME_BEACON_H
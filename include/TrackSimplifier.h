@@ -0,0 +1,150 @@
+/**
+ * @file TrackSimplifier.h
+ * @brief Simplification de trace en flux, mémoire bornée (fenêtre glissante)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Douglas-Peucker en ligne (fenêtre ouvrante): depuis le dernier point
+ * conservé (l'ancre), les fixes sont accumulés tant que tous restent à
+ * moins de la tolérance du segment ancre -> fix courant. Dès qu'un fix
+ * intermédiaire sort de la tolérance, le fix précédent est conservé et
+ * devient la nouvelle ancre.
+ *
+ * Mémoire bornée: au plus WINDOW_SIZE fixes en attente (fenêtre pleine =
+ * point conservé). Un trou de plus de MAX_GAP_MS force aussi un point
+ * (pas de segment inventé pendant une perte de fix).
+ *
+ * Erreur maximale: distance au segment conservé du pire fix abandonné,
+ * mesurée et non seulement bornée.
+ */
+
+#ifndef TRACK_SIMPLIFIER_H
+#define TRACK_SIMPLIFIER_H
+
+#include <Arduino.h>
+#include "GPS.h"
+#include "Geodesy.h"
+
+/**
+ * @brief One fix of the simplified track
+ */
+struct TrackPoint {
+    uint32_t timestamp;      ///< GPS timestamp (s)
+    uint32_t fixMillis;      ///< millis() of the fix
+    int32_t latitude;        ///< 1e-7 degree
+    int32_t longitude;       ///< 1e-7 degree
+    uint16_t speedCms;       ///< Speed over ground (cm/s)
+    uint16_t courseDeci;     ///< Course over ground (0.1 deg)
+};
+
+/**
+ * @brief Streaming line simplification with bounded memory
+ */
+class TrackSimplifier {
+public:
+    /**
+     * @brief Constructor
+     */
+    TrackSimplifier();
+
+    /**
+     * @brief Error tolerance
+     * @param toleranceCm Maximum distance of a dropped fix to the kept track (cm, 0 = keep every fix)
+     */
+    void setTolerance(uint16_t toleranceCm);
+
+    /**
+     * @brief Start a new track (statistics kept)
+     */
+    void reset();
+
+    /**
+     * @brief Add a fix
+     * @param data New fix
+     * @param out Points to keep (room for 2: the fixes on both sides of a gap)
+     * @return Number of points filled in out
+     */
+    uint8_t push(const GPSData& data, TrackPoint* out);
+
+    /**
+     * @brief Last pending fix at the end of the track
+     * @param out Point to keep, if any
+     * @return true if out must be written
+     */
+    bool flush(TrackPoint& out);
+
+    /**
+     * @brief Fixes received
+     */
+    uint32_t getPointsIn() const;
+
+    /**
+     * @brief Points kept
+     */
+    uint32_t getPointsOut() const;
+
+    /**
+     * @brief Largest distance of a dropped fix to the kept track (mm)
+     */
+    uint32_t getMaxErrorMm() const;
+
+    /**
+     * @brief Print simplification report (status update)
+     */
+    void printReport();
+
+private:
+    static const uint8_t WINDOW_SIZE = 64;          ///< Pending fixes (6.4 s at 10 Hz)
+    static const uint32_t MAX_GAP_MS = 2000;        ///< Longer fix gaps always keep a point
+    static const int32_t RECENTRE_MM = 10000000;    ///< 10 km: move the frame origin
+
+    LocalFrame frame;
+    uint32_t toleranceMm;
+
+    bool hasAnchor;
+    LocalPoint anchor;             ///< Last kept point
+    uint32_t anchorFixMillis;
+    TrackPoint pending[WINDOW_SIZE];       ///< Fixes since the anchor, last = floating end
+    LocalPoint pendingPoints[WINDOW_SIZE];
+    uint8_t pendingCount;
+    uint32_t windowErrorMm;                ///< Worst dropped fix against anchor -> last pending
+
+    uint32_t pointsIn;
+    uint32_t pointsOut;
+    uint32_t maxErrorMm;
+
+    uint32_t cyclesSum;            ///< CPU cycles spent in push() (report window)
+    uint32_t cyclesMax;
+    uint32_t cyclesCount;
+
+    /**
+     * @brief Keep a point: it becomes the anchor, pending fixes are dropped
+     */
+    void keep(const TrackPoint& point, const LocalPoint& local, TrackPoint& out);
+
+    /**
+     * @brief Largest distance of the pending fixes to the segment anchor -> end (mm)
+     * @return Early result above the tolerance (the window must be closed anyway)
+     */
+    float windowError(const LocalPoint& end) const;
+};
+
+#endif // TRACK_SIMPLIFIER_H
@@ -0,0 +1,227 @@
+/**
+ * @file TxScheduler.h
+ * @brief Ordonnanceur d'émission par classes de trafic
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Ordonnanceur d'émission placé devant esp_now_send() (Communication).
+ *
+ * Chaque trame est rangée dans la file de sa classe de trafic :
+ * - TX_LIVE : positions, priorité stricte ;
+ * - TX_CONTROL : événements et ACK de configuration, budget de temps
+ *   d'antenne ;
+ * - TX_TIME : balises horaires (l'attente est mesurée et corrigée) ;
+ * - TX_TELEMETRY : télémétrie, budget de temps d'antenne.
+ *
+ * Le pilote ESP-NOW vide sa propre file dans l'ordre d'arrivée : une
+ * position confiée après dix trames de fond attendrait leur émission.
+ * L'ordonnanceur ne confie donc une trame au pilote que s'il a moins de
+ * deux trames en cours (trois pour une position) : une position n'attend
+ * jamais plus d'une trame déjà confiée au pilote, en plus de celle en
+ * cours d'émission.
+ *
+ * Le contrôle et la télémétrie ont un seau à jetons en microsecondes
+ * d'antenne (trame LR : 400 µs + 32 µs par octet, en-têtes compris),
+ * comme le budget de cadence de RatePolicy. Les positions sont bornées
+ * par RatePolicy, les balises horaires par leur période (file d'une
+ * trame). Une file pleine perd sa plus ancienne
+ * trame (position, télémétrie, balise : la suivante la remplace) ou la
+ * nouvelle (contrôle : les événements ne se remplacent pas).
+ *
+ * Aucun appel à ESP-NOW : l'heure et l'occupation du pilote sont passées
+ * en paramètre. La suite tx_scheduler de native-firmware-checks vérifie
+ * sur PC priorités, limites en vol, files pleines et seaux (voir
+ * TX_SCHEDULER.md).
+ */
+
+#ifndef TX_SCHEDULER_H
+#define TX_SCHEDULER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Traffic classes, in priority order
+ */
+enum TxClass : uint8_t {
+    TX_LIVE = 0,        ///< Position broadcasts: strict priority, no budget
+    TX_CONTROL = 1,     ///< Events and config ACKs: airtime budget
+    TX_TIME = 2,        ///< Time beacons (TX time measured, Communication::sendTimedFrame)
+    TX_TELEMETRY = 3,   ///< Telemetry after the positions: airtime budget
+    TX_CLASS_COUNT = 4
+};
+
+/**
+ * @brief Frame waiting in a class queue
+ */
+struct TxFrame {
+    uint8_t data[250];     ///< ESP_NOW_MAX_DATA_LEN
+    uint8_t len;
+    TxClass txClass;
+    bool timed;            ///< Send callback time wanted (time beacon)
+    int64_t queuedUs;      ///< Time of TxScheduler::push()
+    uint32_t id;           ///< Set by TxScheduler::push(), never 0
+};
+
+/**
+ * @brief Counters and latencies of one traffic class
+ */
+struct TxClassStats {
+    uint32_t queued;       ///< Frames pushed
+    uint32_t sent;         ///< Frames handed to the radio
+    uint32_t dropped;      ///< Frames lost because the queue was full
+    uint32_t failed;       ///< Frames refused by the radio
+    uint32_t throttled;    ///< Frames held by the airtime budget
+    uint64_t airtimeUs;    ///< Airtime of the frames sent
+    uint64_t waitSumUs;    ///< Queue wait (push to radio) of the frames sent
+    uint32_t waitMaxUs;
+    uint32_t done;         ///< Frames with a send callback
+    uint64_t doneSumUs;    ///< Push to send callback
+    uint32_t doneMaxUs;
+};
+
+/**
+ * @brief Priority scheduler with airtime budgets in front of the radio
+ */
+class TxScheduler {
+public:
+    /**
+     * @brief Constructor (empty queues, full buckets)
+     */
+    TxScheduler();
+
+    /**
+     * @brief Queue a frame
+     * @param txClass Traffic class
+     * @param data Frame bytes
+     * @param len Frame length (1-250)
+     * @param timed Send callback time wanted (time beacon)
+     * @param nowUs Current time
+     * @return Frame id, 0 if the frame was refused (invalid length, control queue full)
+     */
+    uint32_t push(TxClass txClass, const uint8_t* data, size_t len, bool timed, int64_t nowUs);
+
+    /**
+     * @brief Next frame allowed on the radio
+     * @param nowUs Current time
+     * @param inFlight Frames handed to the radio without send callback
+     * @return Frame at the head of its queue, nullptr if none may go now
+     *
+     * Highest class first; a class waits while the radio holds its
+     * in-flight limit or while its bucket lacks the frame airtime.
+     */
+    const TxFrame* peek(int64_t nowUs, uint8_t inFlight);
+
+    /**
+     * @brief Remove the frame returned by peek()
+     * @param nowUs Current time
+     * @param sent true if the radio accepted it (airtime charged)
+     * @return Class of the frame
+     */
+    TxClass pop(int64_t nowUs, bool sent);
+
+    /**
+     * @brief Record the send callback of a frame
+     * @param txClass Class of the frame
+     * @param latencyUs Push to send callback
+     */
+    void recordDone(TxClass txClass, int64_t latencyUs);
+
+    /**
+     * @brief Frames are waiting
+     */
+    bool hasPending() const;
+
+    /**
+     * @brief A frame still waits in its queue
+     * @param id Frame id returned by push()
+     */
+    bool isQueued(uint32_t id) const;
+
+    /**
+     * @brief Time at which a waiting frame may go at the latest
+     * @param nowUs Current time
+     * @return nowUs if a frame only waits for the radio, INT64_MAX if none waits
+     */
+    int64_t getNextReleaseUs(int64_t nowUs);
+
+    /**
+     * @brief Counters of one class
+     */
+    const TxClassStats& getStats(TxClass txClass) const;
+
+    /**
+     * @brief Class name for reports ("live", "control"...)
+     */
+    static const char* getClassName(TxClass txClass);
+
+    /**
+     * @brief Airtime of a frame (ESP-NOW long range, 250 kbit/s)
+     * @param len ESP-NOW payload length
+     */
+    static uint32_t airtimeUs(size_t len);
+
+    /**
+     * @brief Print one line per class that sent or lost frames (status update)
+     */
+    void printReport();
+
+    static const uint8_t IN_FLIGHT_MAX = 2;        ///< Frames in the radio before a class waits
+    static const uint8_t IN_FLIGHT_LIVE = 3;       ///< Same for positions: one more
+    static const uint8_t POOL_SIZE = 13;           ///< Sum of the queue depths
+
+private:
+    /**
+     * @brief Fixed policy of a class
+     */
+    struct Policy {
+        const char* name;
+        uint8_t depth;            ///< Queue depth
+        bool dropOldest;          ///< Queue full: drop the oldest frame (else the new one)
+        uint8_t inFlightMax;      ///< Frames in the radio before the class waits
+        uint32_t budgetUsPerS;    ///< Airtime budget (0 = unlimited)
+        uint32_t burstUs;         ///< Bucket depth
+    };
+
+    static const Policy POLICIES[TX_CLASS_COUNT];
+
+    TxFrame pool[POOL_SIZE];                  ///< Class queues, one after the other
+    uint8_t first[TX_CLASS_COUNT];            ///< Pool index of the first slot of each class
+    uint8_t head[TX_CLASS_COUNT];             ///< Oldest frame, relative to first[]
+    uint8_t count[TX_CLASS_COUNT];
+    int64_t tokensUs[TX_CLASS_COUNT];         ///< Airtime left in the bucket
+    int64_t lastRefillUs[TX_CLASS_COUNT];
+    bool holding[TX_CLASS_COUNT];             ///< Head frame already counted throttled
+    TxClass peeked;                           ///< Class of the last peek()
+    uint32_t nextId;                          ///< Id of the next frame pushed
+    TxClassStats stats[TX_CLASS_COUNT];
+
+    /**
+     * @brief Refill the bucket of a class up to now
+     */
+    void refill(uint8_t c, int64_t nowUs);
+
+    /**
+     * @brief Frame at the head of a class queue
+     */
+    TxFrame& front(uint8_t c);
+};
+
+#endif // TX_SCHEDULER_H
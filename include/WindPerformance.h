@@ -0,0 +1,157 @@
+/**
+ * @file WindPerformance.h
+ * @brief Vent réel (anémomètre) et performance : TWA, VMG, pourcentage de polaire
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Vent: trames AnemometerPacket (type 2) de l'anémomètre du plan d'eau.
+ * L'anémomètre est fixe : sa mesure est directement le vent réel. Le vent
+ * est lissé par moyenne exponentielle vectorielle (composantes nord/est,
+ * pas d'erreur au passage 359° -> 0°), constante de temps WIND_TAU_MS.
+ * Sans trame depuis WIND_TIMEOUT_MS, le vent est considéré inconnu.
+ *
+ * Par fix, en entiers uniquement (aucun flottant sur le chemin du fix):
+ * - TWA = direction du vent - cap fond, dans [-180°, 180°) (> 0 = vent de tribord)
+ * - VMG = vitesse fond × cos(TWA), table Q15 de Geodesy (> 0 = vers le vent)
+ * - Cible = polaire interpolée bilinéairement (TWS × |TWA|), poids Q8
+ * - Pourcentage de polaire = vitesse / cible, en pour mille
+ *
+ * Le coût par fix (cycles CPU) est mesuré et affiché dans le rapport d'état.
+ */
+
+#ifndef WIND_PERFORMANCE_H
+#define WIND_PERFORMANCE_H
+
+#include <Arduino.h>
+#include "GPS.h"
+#include "Communication.h"
+#include "Geodesy.h"
+
+/**
+ * @brief Smoothed true wind from anemometer frames, per-fix TWA / VMG / polar ratio
+ */
+class WindPerformance {
+public:
+    /**
+     * @brief Constructor
+     */
+    WindPerformance();
+
+    /**
+     * @brief Feed an anemometer frame into the smoothed wind
+     * @param packet Received frame
+     * @param receivedAt millis() at reception
+     * @return true if the frame was valid
+     */
+    bool applyAnemometer(const AnemometerPacket& packet, uint32_t receivedAt);
+
+    /**
+     * @brief Wind known (anemometer heard within WIND_TIMEOUT_MS)
+     * @param now millis()
+     */
+    bool hasWind(uint32_t now) const;
+
+    /**
+     * @brief Compute TWA, VMG and polar ratio for a new fix
+     * @param data New fix
+     */
+    void update(const GPSData& data);
+
+    /**
+     * @brief TWA / VMG / polar values of the last fix are valid (wind known, boat moving)
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Smoothed true wind direction, from (0.1 deg)
+     */
+    uint16_t getDirectionDeci() const;
+
+    /**
+     * @brief Smoothed true wind speed (cm/s)
+     */
+    uint16_t getSpeedCms() const;
+
+    /**
+     * @brief True wind angle of the last fix (0.1 deg, > 0 = wind over starboard)
+     */
+    int16_t getAngleDeci() const;
+
+    /**
+     * @brief Velocity made good toward the wind (cm/s, < 0 = downwind)
+     */
+    int16_t getVmgCms() const;
+
+    /**
+     * @brief Polar target speed for the current wind and angle (cm/s)
+     */
+    uint16_t getTargetCms() const;
+
+    /**
+     * @brief Speed over the polar target (per mille, 1000 = on target)
+     */
+    uint16_t getPolarPermille() const;
+
+    /**
+     * @brief Polar target speed, bilinear interpolation in fixed point
+     * @param twsDeciKn True wind speed (0.1 kn)
+     * @param absAngleDeci Absolute true wind angle (0-1800, 0.1 deg)
+     * @return Target boat speed (cm/s)
+     */
+    static uint16_t targetSpeedCms(uint16_t twsDeciKn, uint16_t absAngleDeci);
+
+    /**
+     * @brief Print wind and performance report (status update)
+     */
+    void printReport();
+
+private:
+    static const uint32_t WIND_TAU_MS = 10000;          ///< Smoothing time constant
+    static const uint32_t WIND_TIMEOUT_MS = 30000;      ///< Wind unknown without frames
+    static const uint16_t COURSE_CMS = 50;              ///< Below ~1 kn the course is noise
+    static const uint16_t MAX_WIND_CMS = 5144;          ///< 100 kn: reject corrupted frames
+
+    // Smoothed wind (float, once per anemometer frame)
+    float windNorth;               ///< Wind vector toward where it comes from (kn)
+    float windEast;
+    float windSpeedKn;
+    uint32_t lastSampleMs;
+    uint32_t sampleCount;
+    uint32_t lastSequence;
+
+    // Integer copies used on every fix
+    uint16_t directionDeci;
+    uint16_t speedCms;
+    uint16_t speedDeciKn;
+
+    // Last fix
+    bool valid;
+    int16_t angleDeci;
+    int16_t vmgCms;
+    uint16_t targetCms;
+    uint16_t polarPermille;
+
+    uint32_t cyclesSum;            ///< CPU cycles spent in update() (report window)
+    uint32_t cyclesMax;
+    uint32_t cyclesCount;
+};
+
+#endif // WIND_PERFORMANCE_H
@@ -0,0 +1,607 @@
+/**
+ * @file BoatCodec.h
+ * @brief Encodage et décodage des trames ESP-NOW de la flotte
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Codec de référence des trames de BoatProtocol.h pour les outils hôtes,
+ * les hubs et le Display : uniquement des fonctions inline, sans
+ * allocation ni exception, compilable en C++11 (ESP32) comme sur PC.
+ *
+ * Chaque champ est lu et écrit à son décalage de la structure *Wire, en
+ * petit-boutiste : le résultat ne dépend ni de l'ordre des octets ni du
+ * bourrage de l'hôte. Sur un hôte petit-boutiste, le compilateur réduit
+ * ces accès à de simples chargements ; le décodage par lot dépasse
+ * plusieurs millions de trames par seconde (tools/protocol_bench).
+ *
+ * Versions :
+ * - GPSBroadcastPacket : les trames des firmwares antérieurs ont
+ *   rateDeciHz et quality à 0 (même taille, 48 octets)
+ * - BoatTelemetryPacket : versions 1 à 4 (24, 40, 52, 56 octets), chaque
+ *   version ajoute des champs en fin de trame ; les champs absents de la
+ *   version reçue valent 0, une version plus récente est lue avec les
+ *   champs connus ici
+ */
+
+#ifndef BOAT_CODEC_H
+#define BOAT_CODEC_H
+
+#include <string.h>
+#include "BoatProtocol.h"
+
+/**
+ * @brief Result of a decode
+ */
+enum DecodeStatus : uint8_t {
+    DECODE_OK = 0,
+    DECODE_EMPTY = 1,            ///< No byte
+    DECODE_UNKNOWN_TYPE = 2,     ///< First byte is not a MessageType
+    DECODE_WRONG_TYPE = 3,       ///< Typed decoder called on another message type
+    DECODE_TOO_SHORT = 4,        ///< Shorter than its layout (version)
+    DECODE_BAD_VERSION = 5,      ///< Telemetry version 0
+    DECODE_BAD_COUNT = 6         ///< Count field beyond the array
+};
+
+/**
+ * @brief Any decoded frame
+ */
+struct BoatMessage {
+    int8_t type;                 ///< MessageType (0 if not decoded)
+    union {
+        GPSBroadcastPacket boat;
+        AnemometerPacket anemometer;
+        ConfigPushPacket configPush;
+        ConfigAckPacket configAck;
+        StartCountdownPacket countdown;
+        EventPacket event;
+        BoatTelemetryPacket telemetry;
+        CoursePacket course;
+        TimeBeaconPacket timeBeacon;
+    };
+};
+
+/**
+ * @brief Frame to decode (bytes owned by the caller)
+ */
+struct FrameView {
+    const uint8_t* data;
+    size_t len;
+};
+
+/**
+ * @brief Codec of the fleet frames, header only, no allocation
+ *
+ * Encoders return the frame length (0 if out is smaller than the
+ * layout); decoders fill the whole packet (fields absent from the frame
+ * version are 0). Bytes after the layout are ignored, as the firmware
+ * does.
+ */
+namespace BoatCodec {
+
+// ---- Little-endian access at any alignment ----
+
+inline uint16_t get16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+inline uint32_t get32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline float getFloat(const uint8_t* p) {
+    uint32_t bits = get32(p);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline void put16(uint8_t* p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+inline void put32(uint8_t* p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+inline void putFloat(uint8_t* p, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put32(p, bits);
+}
+
+/**
+ * @brief Common checks of the typed decoders
+ */
+inline DecodeStatus check(const uint8_t* data, size_t len, MessageType type, size_t size) {
+    if (len == 0) {
+        return DECODE_EMPTY;
+    }
+    if ((int8_t)data[0] != type) {
+        return DECODE_WRONG_TYPE;
+    }
+    return len < size ? DECODE_TOO_SHORT : DECODE_OK;
+}
+
+// ---- GPSBroadcastPacket ----
+
+inline size_t encode(const GPSBroadcastPacket& p, uint8_t* out, size_t size) {
+    if (size < BoatWire::SIZE) {
+        return 0;
+    }
+    memset(out, 0, BoatWire::SIZE);
+    out[BoatWire::TYPE] = (uint8_t)p.messageType;
+    memcpy(out + BoatWire::NAME, p.name, sizeof(p.name));
+    put32(out + BoatWire::SEQUENCE, p.sequenceNumber);
+    put32(out + BoatWire::TIMESTAMP, p.gpsTimestamp);
+    putFloat(out + BoatWire::LATITUDE, p.latitude);
+    putFloat(out + BoatWire::LONGITUDE, p.longitude);
+    putFloat(out + BoatWire::SPEED, p.speed);
+    putFloat(out + BoatWire::HEADING, p.heading);
+    out[BoatWire::SATELLITES] = p.satellites;
+    out[BoatWire::TTL] = p.ttl;
+    out[BoatWire::RATE] = p.rateDeciHz;
+    out[BoatWire::QUALITY] = p.quality;
+    return BoatWire::SIZE;
+}
+
+inline DecodeStatus decode(const uint8_t* data, size_t len, GPSBroadcastPacket& p) {
+    DecodeStatus status = check(data, len, MSG_BOAT, BoatWire::SIZE);
+    if (status != DECODE_OK) {
+        return status;
+    }
+    p.messageType = MSG_BOAT;
+    memcpy(p.name, data + BoatWire::NAME, sizeof(p.name));
+    p.name[sizeof(p.name) - 1] = '\0';  // Never trust the sender for the terminator
+    p.sequenceNumber = get32(data + BoatWire::SEQUENCE);
+    p.gpsTimestamp = get32(data + BoatWire::TIMESTAMP);
+    p.latitude = getFloat(data + BoatWire::LATITUDE);
+    p.longitude = getFloat(data + BoatWire::LONGITUDE);
+    p.speed = getFloat(data + BoatWire::SPEED);
+    p.heading = getFloat(data + BoatWire::HEADING);
+    p.satellites = data[BoatWire::SATELLITES];
+    p.ttl = data[BoatWire::TTL];
+    p.rateDeciHz = data[BoatWire::RATE];
+    p.quality = data[BoatWire::QUALITY];
+    return DECODE_OK;
+}
+
+// ---- AnemometerPacket ----
+
+inline size_t encode(const AnemometerPacket& p, uint8_t* out, size_t size) {
+    if (size < AnemometerWire::SIZE) {
+        return 0;
+    }
+    memset(out, 0, AnemometerWire::SIZE);
+    out[AnemometerWire::TYPE] = (uint8_t)p.messageType;
+    memcpy(out + AnemometerWire::ID, p.anemometerId, sizeof(p.anemometerId));
+    put32(out + AnemometerWire::SEQUENCE, p.sequenceNumber);
+    putFloat(out + AnemometerWire::WIND_SPEED, p.windSpeed);
+    putFloat(out + AnemometerWire::WIND_DIRECTION, p.windDirection);
+    return AnemometerWire::SIZE;
+}
+
+inline DecodeStatus decode(const uint8_t* data, size_t len, AnemometerPacket& p) {
+    DecodeStatus status = check(data, len, MSG_ANEMOMETER, AnemometerWire::SIZE);
+    if (status != DECODE_OK) {
+        return status;
+    }
+    memset(&p, 0, sizeof(p));
+    p.messageType = MSG_ANEMOMETER;
+    memcpy(p.anemometerId, data + AnemometerWire::ID, sizeof(p.anemometerId));
+    p.anemometerId[sizeof(p.anemometerId) - 1] = '\0';
+    p.sequenceNumber = get32(data + AnemometerWire::SEQUENCE);
+    p.windSpeed = getFloat(data + AnemometerWire::WIND_SPEED);
+    p.windDirection = getFloat(data + AnemometerWire::WIND_DIRECTION);
+    return DECODE_OK;
+}
+
+// ---- ConfigPushPacket ----
+
+inline size_t encode(const ConfigPushPacket& p, uint8_t* out, size_t size) {
+    if (size < ConfigPushWire::SIZE) {
+        return 0;
+    }
+    memset(out, 0, ConfigPushWire::SIZE);
+    out[ConfigPushWire::TYPE] = (uint8_t)p.messageType;
+    out[ConfigPushWire::TARGET_COUNT] = p.targetCount;
+    out[ConfigPushWire::DELTA_COUNT] = p.deltaCount;
+    put32(out + ConfigPushWire::VERSION, p.configVersion);
+    memcpy(out + ConfigPushWire::TARGETS, p.targets, sizeof(p.targets));
+    for (uint8_t i = 0; i < CONFIG_MAX_DELTAS; i++) {
+        uint8_t* delta = out + ConfigPushWire::DELTAS + i * ConfigPushWire::DELTA_SIZE;
+        delta[ConfigPushWire::DELTA_KEY] = p.deltas[i].key;
+        put32(delta + ConfigPushWire::DELTA_VALUE, (uint32_t)p.deltas[i].value);
+    }
+    memcpy(out + ConfigPushWire::SIGNATURE, p.signature, sizeof(p.signature));
+    return ConfigPushWire::SIZE;
+}
+
+inline DecodeStatus decode(const uint8_t* data, size_t len, ConfigPushPacket& p) {
+    DecodeStatus status = check(data, len, MSG_CONFIG_PUSH, ConfigPushWire::SIZE);
+    if (status != DECODE_OK) {
+        return status;
+    }
+    if (data[ConfigPushWire::TARGET_COUNT] > CONFIG_MAX_TARGETS || data[ConfigPushWire::DELTA_COUNT] > CONFIG_MAX_DELTAS) {
+        return DECODE_BAD_COUNT;
+    }
+    memset(&p, 0, sizeof(p));
+    p.messageType = MSG_CONFIG_PUSH;
+    p.targetCount = data[ConfigPushWire::TARGET_COUNT];
+    p.deltaCount = data[ConfigPushWire::DELTA_COUNT];
+    p.configVersion = get32(data + ConfigPushWire::VERSION);
+    memcpy(p.targets, data + ConfigPushWire::TARGETS, sizeof(p.targets));
+    for (uint8_t i = 0; i < CONFIG_MAX_DELTAS; i++) {
+        const uint8_t* delta = data + ConfigPushWire::DELTAS + i * ConfigPushWire::DELTA_SIZE;
+        p.deltas[i].key = delta[ConfigPushWire::DELTA_KEY];
+        p.deltas[i].value = (int32_t)get32(delta + ConfigPushWire::DELTA_VALUE);
+    }
+    memcpy(p.signature, data + ConfigPushWire::SIGNATURE, sizeof(p.signature));
+    return DECODE_OK;
+}
+
+// ---- ConfigAckPacket ----
+
+inline size_t encode(const ConfigAckPacket& p, uint8_t* out, size_t size) {
+    if (size < ConfigAckWire::SIZE) {
+        return 0;
+    }
+    memset(out, 0, ConfigAckWire::SIZE);
+    out[ConfigAckWire::TYPE] = (uint8_t)p.messageType;
+    out[ConfigAckWire::STATUS] = p.status;
+    put32(out + ConfigAckWire::REQUESTED_VERSION, p.requestedVersion);
+    put32(out + ConfigAckWire::ACTIVE_VERSION, p.activeVersion);
+    return ConfigAckWire::SIZE;
+}
+
+inline DecodeStatus decode(const uint8_t* data, size_t len, ConfigAckPacket& p) {
+    DecodeStatus status = check(data, len, MSG_CONFIG_ACK, ConfigAckWire::SIZE);
+    if (status != DECODE_OK) {
+        return status;
+    }
+    memset(&p, 0, sizeof(p));
+    p.messageType = MSG_CONFIG_ACK;
+    p.status = data[ConfigAckWire::STATUS];
+    p.requestedVersion = get32(data + ConfigAckWire::REQUESTED_VERSION);
+    p.activeVersion = get32(data + ConfigAckWire::ACTIVE_VERSION);
+    return DECODE_OK;
+}
+
+// ---- StartCountdownPacket ----
+
+inline size_t encode(const StartCountdownPacket& p, uint8_t* out, size_t size) {
+    if (size < CountdownWire::SIZE) {
+        return 0;
+    }
+    out[CountdownWire::TYPE] = (uint8_t)p.messageType;
+    out[CountdownWire::FLAGS] = p.flags;
+    put16(out + CountdownWire::WINDOW, p.windowS);
+    put32(out + CountdownWire::GUN_TIME, p.gunTimeOfDayMs);
+    put32(out + CountdownWire::COMMITTEE_LAT, (uint32_t)p.committeeLat);
+    put32(out + CountdownWire::COMMITTEE_LON, (uint32_t)p.committeeLon);
+    put32(out + CountdownWire::PIN_LAT, (uint32_t)p.pinLat);
+    put32(out + CountdownWire::PIN_LON, (uint32_t)p.pinLon);
+    memcpy(out + CountdownWire::SIGNATURE, p.signature, sizeof(p.signature));
+    return CountdownWire::SIZE;
+}
+
+inline DecodeStatus decode(const uint8_t* data, size_t len, StartCountdownPacket& p) {
+    DecodeStatus status = check(data, len, MSG_START_COUNTDOWN, CountdownWire::SIZE);
+    if (status != DECODE_OK) {
+        return status;
+    }
+    p.messageType = MSG_START_COUNTDOWN;
+    p.flags = data[CountdownWire::FLAGS];
+    p.windowS = get16(data + CountdownWire::WINDOW);
+    p.gunTimeOfDayMs = get32(data + CountdownWire::GUN_TIME);
+    p.committeeLat = (int32_t)get32(data + CountdownWire::COMMITTEE_LAT);
+    p.committeeLon = (int32_t)get32(data + CountdownWire::COMMITTEE_LON);
+    p.pinLat = (int32_t)get32(data + CountdownWire::PIN_LAT);
+    p.pinLon = (int32_t)get32(data + CountdownWire::PIN_LON);
+    memcpy(p.signature, data + CountdownWire::SIGNATURE, sizeof(p.signature));
+    return DECODE_OK;
+}
+
+// ---- EventPacket ----
+
+inline size_t encode(const EventPacket& p, uint8_t* out, size_t size) {
+    if (size < EventWire::SIZE) {
+        return 0;
+    }
+    memset(out, 0, EventWire::SIZE);
+    out[EventWire::TYPE] = (uint8_t)p.messageType;
+    out[EventWire::EVENT_TYPE] = p.eventType;
+    put16(out + EventWire::SEQUENCE, p.eventSequence);
+    out[EventWire::DETAIL] = p.detail;
+    put32(out + EventWire::TIME_OF_DAY, p.timeOfDayMs);
+    put32(out + EventWire::RELATIVE, (uint32_t)p.relativeMs);
+    putFloat(out + EventWire::LATITUDE, p.latitude);
+    putFloat(out + EventWire::LONGITUDE, p.longitude);
+    putFloat(out + EventWire::SPEED, p.speed);
+    return EventWire::SIZE;
+}
+
+inline DecodeStatus decode(const uint8_t* data, size_t len, EventPacket& p) {
+    DecodeStatus status = check(data, len, MSG_EVENT, EventWire::SIZE);
+    if (status != DECODE_OK) {
+        return status;
+    }
+    memset(&p, 0, sizeof(p));
+    p.messageType = MSG_EVENT;
+    p.eventType = data[EventWire::EVENT_TYPE];
+    p.eventSequence = get16(data + EventWire::SEQUENCE);
+    p.detail = data[EventWire::DETAIL];
+    p.timeOfDayMs = get32(data + EventWire::TIME_OF_DAY);
+    p.relativeMs = (int32_t)get32(data + EventWire::RELATIVE);
+    p.latitude = getFloat(data + EventWire::LATITUDE);
+    p.longitude = getFloat(data + EventWire::LONGITUDE);
+    p.speed = getFloat(data + EventWire::SPEED);
+    return DECODE_OK;
+}
+
+// ---- BoatTelemetryPacket (versions 1 to TELEMETRY_VERSION) ----
+
+/**
+ * @brief Encode in the layout of p.version (older versions: shorter frame, for tests of receivers)
+ */
+inline size_t encode(const BoatTelemetryPacket& p, uint8_t* out, size_t size) {
+    size_t frameSize = TelemetryWire::size(p.version);
+    if (frameSize == 0 || size < frameSize) {
+        return 0;
+    }
+    memset(out, 0, frameSize);
+    out[TelemetryWire::TYPE] = (uint8_t)p.messageType;
+    out[TelemetryWire::VERSION] = p.version;
+    out[TelemetryWire::FLAGS] = p.flags;
+    put32(out + TelemetryWire::SEQUENCE, p.sequenceNumber);
+    put32(out + TelemetryWire::LINE_DISTANCE, (uint32_t)p.lineDistanceCm);
+    put32(out + TelemetryWire::TIME_TO_LINE, (uint32_t)p.timeToLineMs);
+    put32(out + TelemetryWire::TIME_TO_GUN, (uint32_t)p.timeToGunMs);
+    put16(out + TelemetryWire::CLOSING, (uint16_t)p.closingCms);
+    if (p.version >= 2) {
+        put16(out + TelemetryWire::SPEED_2S, p.speed2sCms);
+        put32(out + TelemetryWire::DISTANCE, p.distanceM);
+        put16(out + TelemetryWire::SPEED_10S, p.speed10sCms);
+        put16(out + TelemetryWire::MAX_SPEED, p.maxSpeedCms);
+        out[TelemetryWire::TACKS] = p.tacks;
+        out[TelemetryWire::GYBES] = p.gybes;
+        put16(out + TelemetryWire::STARBOARD, p.starboardS);
+        put16(out + TelemetryWire::PORT, p.portS);
+    }
+    if (p.version >= 3) {
+        put16(out + TelemetryWire::TWD, p.twdDeci);
+        put16(out + TelemetryWire::TWA, (uint16_t)p.twaDeci);
+        put16(out + TelemetryWire::TWS, p.twsCms);
+        put16(out + TelemetryWire::VMG, (uint16_t)p.vmgCms);
+        put16(out + TelemetryWire::TARGET, p.targetCms);
+        put16(out + TelemetryWire::POLAR, p.polarPermille);
+    }
+    if (p.version >= 4) {
+        put16(out + TelemetryWire::COG, p.cogDeci);
+        put16(out + TelemetryWire::SOG, p.sogCms);
+        put16(out + TelemetryWire::COG_CONFIDENCE, p.cogConfidence);
+    }
+    return frameSize;
+}
+
+/**
+ * @brief Decode any version; a newer one is read with the fields known here (p.version keeps it)
+ */
+inline DecodeStatus decode(const uint8_t* data, size_t len, BoatTelemetryPacket& p) {
+    DecodeStatus status = check(data, len, MSG_TELEMETRY, TelemetryWire::SIZE_V1);
+    if (status != DECODE_OK) {
+        return status;
+    }
+    uint8_t version = data[TelemetryWire::VERSION];
+    if (version == 0) {
+        return DECODE_BAD_VERSION;
+    }
+    uint8_t known = version < TELEMETRY_VERSION ? version : TELEMETRY_VERSION;
+    if (len < TelemetryWire::size(known)) {
+        return DECODE_TOO_SHORT;
+    }
+    memset(&p, 0, sizeof(p));
+    p.messageType = MSG_TELEMETRY;
+    p.version = version;
+    p.flags = data[TelemetryWire::FLAGS];
+    p.sequenceNumber = get32(data + TelemetryWire::SEQUENCE);
+    p.lineDistanceCm = (int32_t)get32(data + TelemetryWire::LINE_DISTANCE);
+    p.timeToLineMs = (int32_t)get32(data + TelemetryWire::TIME_TO_LINE);
+    p.timeToGunMs = (int32_t)get32(data + TelemetryWire::TIME_TO_GUN);
+    p.closingCms = (int16_t)get16(data + TelemetryWire::CLOSING);
+    if (known >= 2) {
+        p.speed2sCms = get16(data + TelemetryWire::SPEED_2S);
+        p.distanceM = get32(data + TelemetryWire::DISTANCE);
+        p.speed10sCms = get16(data + TelemetryWire::SPEED_10S);
+        p.maxSpeedCms = get16(data + TelemetryWire::MAX_SPEED);
+        p.tacks = data[TelemetryWire::TACKS];
+        p.gybes = data[TelemetryWire::GYBES];
+        p.starboardS = get16(data + TelemetryWire::STARBOARD);
+        p.portS = get16(data + TelemetryWire::PORT);
+    }
+    if (known >= 3) {
+        p.twdDeci = get16(data + TelemetryWire::TWD);
+        p.twaDeci = (int16_t)get16(data + TelemetryWire::TWA);
+        p.twsCms = get16(data + TelemetryWire::TWS);
+        p.vmgCms = (int16_t)get16(data + TelemetryWire::VMG);
+        p.targetCms = get16(data + TelemetryWire::TARGET);
+        p.polarPermille = get16(data + TelemetryWire::POLAR);
+    }
+    if (known >= 4) {
+        p.cogDeci = get16(data + TelemetryWire::COG);
+        p.sogCms = get16(data + TelemetryWire::SOG);
+        p.cogConfidence = get16(data + TelemetryWire::COG_CONFIDENCE);
+    }
+    return DECODE_OK;
+}
+
+// ---- CoursePacket ----
+
+inline size_t encode(const CoursePacket& p, uint8_t* out, size_t size) {
+    if (size < CourseWire::SIZE) {
+        return 0;
+    }
+    memset(out, 0, CourseWire::SIZE);
+    out[CourseWire::TYPE] = (uint8_t)p.messageType;
+    out[CourseWire::COUNT] = p.count;
+    put16(out + CourseWire::COURSE_ID, p.courseId);
+    for (uint8_t i = 0; i < COURSE_MAX_ENTRIES; i++) {
+        uint8_t* mark = out + CourseWire::MARKS + i * CourseWire::MARK_SIZE;
+        put32(mark + CourseWire::MARK_LATITUDE, (uint32_t)p.marks[i].latitude);
+        put32(mark + CourseWire::MARK_LONGITUDE, (uint32_t)p.marks[i].longitude);
+        put16(mark + CourseWire::MARK_RADIUS, p.marks[i].radiusM);
+        mark[CourseWire::MARK_ID] = p.marks[i].markId;
+        mark[CourseWire::MARK_FLAGS] = p.marks[i].flags;
+    }
+    memcpy(out + CourseWire::SIGNATURE, p.signature, sizeof(p.signature));
+    return CourseWire::SIZE;
+}
+
+inline DecodeStatus decode(const uint8_t* data, size_t len, CoursePacket& p) {
+    DecodeStatus status = check(data, len, MSG_COURSE, CourseWire::SIZE);
+    if (status != DECODE_OK) {
+        return status;
+    }
+    if (data[CourseWire::COUNT] > COURSE_MAX_ENTRIES) {
+        return DECODE_BAD_COUNT;
+    }
+    p.messageType = MSG_COURSE;
+    p.count = data[CourseWire::COUNT];
+    p.courseId = get16(data + CourseWire::COURSE_ID);
+    for (uint8_t i = 0; i < COURSE_MAX_ENTRIES; i++) {
+        const uint8_t* mark = data + CourseWire::MARKS + i * CourseWire::MARK_SIZE;
+        p.marks[i].latitude = (int32_t)get32(mark + CourseWire::MARK_LATITUDE);
+        p.marks[i].longitude = (int32_t)get32(mark + CourseWire::MARK_LONGITUDE);
+        p.marks[i].radiusM = get16(mark + CourseWire::MARK_RADIUS);
+        p.marks[i].markId = mark[CourseWire::MARK_ID];
+        p.marks[i].flags = mark[CourseWire::MARK_FLAGS];
+    }
+    memcpy(p.signature, data + CourseWire::SIGNATURE, sizeof(p.signature));
+    return DECODE_OK;
+}
+
+// ---- TimeBeaconPacket ----
+
+inline size_t encode(const TimeBeaconPacket& p, uint8_t* out, size_t size) {
+    if (size < TimeBeaconWire::SIZE) {
+        return 0;
+    }
+    memset(out, 0, TimeBeaconWire::SIZE);
+    out[TimeBeaconWire::TYPE] = (uint8_t)p.messageType;
+    out[TimeBeaconWire::STATE] = p.state;
+    put16(out + TimeBeaconWire::SEQUENCE, p.sequence);
+    put32(out + TimeBeaconWire::SECONDS, p.gpsSeconds);
+    put32(out + TimeBeaconWire::MICROS, p.gpsMicros);
+    put32(out + TimeBeaconWire::CORRECTION, (uint32_t)p.correctionUs);
+    put16(out + TimeBeaconWire::ACCURACY, p.accuracyUs);
+    return TimeBeaconWire::SIZE;
+}
+
+inline DecodeStatus decode(const uint8_t* data, size_t len, TimeBeaconPacket& p) {
+    DecodeStatus status = check(data, len, MSG_TIME_BEACON, TimeBeaconWire::SIZE);
+    if (status != DECODE_OK) {
+        return status;
+    }
+    memset(&p, 0, sizeof(p));
+    p.messageType = MSG_TIME_BEACON;
+    p.state = data[TimeBeaconWire::STATE];
+    p.sequence = get16(data + TimeBeaconWire::SEQUENCE);
+    p.gpsSeconds = get32(data + TimeBeaconWire::SECONDS);
+    p.gpsMicros = get32(data + TimeBeaconWire::MICROS);
+    p.correctionUs = (int32_t)get32(data + TimeBeaconWire::CORRECTION);
+    p.accuracyUs = get16(data + TimeBeaconWire::ACCURACY);
+    return DECODE_OK;
+}
+
+// ---- Any frame ----
+
+/**
+ * @brief Decode a frame of any type into out (out.type = 0 if not decoded)
+ */
+inline DecodeStatus decode(const uint8_t* data, size_t len, BoatMessage& out) {
+    out.type = 0;
+    if (len == 0) {
+        return DECODE_EMPTY;
+    }
+    DecodeStatus status;
+    switch ((int8_t)data[0]) {
+        case MSG_BOAT: status = decode(data, len, out.boat); break;
+        case MSG_ANEMOMETER: status = decode(data, len, out.anemometer); break;
+        case MSG_CONFIG_PUSH: status = decode(data, len, out.configPush); break;
+        case MSG_CONFIG_ACK: status = decode(data, len, out.configAck); break;
+        case MSG_START_COUNTDOWN: status = decode(data, len, out.countdown); break;
+        case MSG_EVENT: status = decode(data, len, out.event); break;
+        case MSG_TELEMETRY: status = decode(data, len, out.telemetry); break;
+        case MSG_COURSE: status = decode(data, len, out.course); break;
+        case MSG_TIME_BEACON: status = decode(data, len, out.timeBeacon); break;
+        default: return DECODE_UNKNOWN_TYPE;
+    }
+    if (status == DECODE_OK) {
+        out.type = (int8_t)data[0];
+    }
+    return status;
+}
+
+/**
+ * @brief Encode out of a BoatMessage (type selects the member)
+ */
+inline size_t encode(const BoatMessage& message, uint8_t* out, size_t size) {
+    switch (message.type) {
+        case MSG_BOAT: return encode(message.boat, out, size);
+        case MSG_ANEMOMETER: return encode(message.anemometer, out, size);
+        case MSG_CONFIG_PUSH: return encode(message.configPush, out, size);
+        case MSG_CONFIG_ACK: return encode(message.configAck, out, size);
+        case MSG_START_COUNTDOWN: return encode(message.countdown, out, size);
+        case MSG_EVENT: return encode(message.event, out, size);
+        case MSG_TELEMETRY: return encode(message.telemetry, out, size);
+        case MSG_COURSE: return encode(message.course, out, size);
+        case MSG_TIME_BEACON: return encode(message.timeBeacon, out, size);
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Decode a batch of frames (hub, host tools)
+ * @param frames Frames to decode
+ * @param count Number of frames
+ * @param out One message per frame (type 0 for a rejected frame)
+ * @param rejected Per-status counters, indexed by DecodeStatus (optional, added to)
+ * @return Number of frames decoded
+ */
+inline size_t decodeBatch(const FrameView* frames, size_t count, BoatMessage* out, uint32_t* rejected = nullptr) {
+    size_t decoded = 0;
+    for (size_t i = 0; i < count; i++) {
+        DecodeStatus status = decode(frames[i].data, frames[i].len, out[i]);
+        if (status == DECODE_OK) {
+            decoded++;
+        } else if (rejected != nullptr) {
+            rejected[status]++;
+        }
+    }
+    return decoded;
+}
+
+}  // namespace BoatCodec
+
+#endif // BOAT_CODEC_H
@@ -0,0 +1,575 @@
+/**
+ * @file BoatProtocol.h
+ * @brief Format des trames ESP-NOW de la flotte (définition unique)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Structures de toutes les trames échangées par les bateaux, le comité,
+ * les anémomètres et les Display, sans dépendance Arduino : le firmware
+ * (include/Communication.h), les outils hôtes et le projet Display
+ * incluent ce même fichier au lieu d'en recopier les structures.
+ *
+ * Le format sur l'air est celui de l'ESP32 : petit-boutiste, chaque champ
+ * aligné sur sa taille. Les décalages de chaque champ sont écrits une fois
+ * (structures *Wire) ; des static_assert vérifient à la compilation que
+ * chaque structure C++ les respecte et que chaque champ est aligné
+ * naturellement, ce qui donne la même disposition sur tout ABI de
+ * récepteur (Xtensa, RISC-V, ARM, x86). Une structure modifiée par erreur
+ * ne compile plus au lieu de décaler les trames en silence.
+ *
+ * Encodage et décodage champ par champ (indépendants de l'hôte) :
+ * BoatCodec.h.
+ */
+
+#ifndef BOAT_PROTOCOL_H
+#define BOAT_PROTOCOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+static const uint8_t BOAT_PROTOCOL_MAX_FRAME = 250;   ///< ESP-NOW payload limit (ESP_NOW_MAX_DATA_LEN)
+
+/**
+ * @brief ESP-NOW message types (first byte of every frame)
+ */
+enum MessageType : int8_t {
+    MSG_BOAT = 1,            ///< GPSBroadcastPacket
+    MSG_ANEMOMETER = 2,      ///< Anemometer broadcast (Display protocol)
+    MSG_CONFIG_PUSH = 3,     ///< ConfigPushPacket (committee -> boats)
+    MSG_CONFIG_ACK = 4,      ///< ConfigAckPacket (boat -> committee)
+    MSG_START_COUNTDOWN = 5, ///< StartCountdownPacket (committee -> boats)
+    MSG_EVENT = 6,           ///< EventPacket (boat -> all)
+    MSG_TELEMETRY = 7,       ///< BoatTelemetryPacket (boat -> all, after each GPSBroadcastPacket)
+    MSG_COURSE = 8,          ///< CoursePacket (committee -> boats)
+    MSG_TIME_BEACON = 9      ///< TimeBeaconPacket (boat -> all, GPS time)
+};
+
+/**
+ * @brief Event types carried in EventPacket
+ */
+enum EventType : uint8_t {
+    EVENT_LINE_CROSSING = 1, ///< Start line crossed (detail: 1 = to course side, 0 = back)
+    EVENT_MARK_ROUNDING = 2, ///< Course mark rounded (detail: mark index, relativeMs: time in the lap)
+    EVENT_LAP = 3,           ///< Lap completed (detail: lap number, relativeMs: lap time)
+    EVENT_MANOEUVRE = 4      ///< Tack / gybe (detail: ManoeuvreKind, relativeMs: recovery time, speed: minimum)
+};
+
+/**
+ * @brief GPS broadcast packet structure (aligned with Display struct_message_Boat)
+ */
+struct GPSBroadcastPacket {
+    int8_t messageType;      ///< 1 = Boat, 2 = Anemometer
+     char name[18];     // Custom boat name or MAC address (max 17 chars + null terminator)
+    uint32_t sequenceNumber; ///< Sequence number (incremental counter for packet loss detection)
+    uint32_t gpsTimestamp;   ///< GPS timestamp in milliseconds
+    float latitude;          ///< Latitude in degrees
+    float longitude;         ///< Longitude in degrees
+    float speed;             ///< Speed in knots
+    float heading;           ///< Heading in degrees (0=N, 90=E, 180=S, 270=W)
+    uint8_t satellites;      ///< Number of visible satellites
+    uint8_t ttl;             ///< Time-To-Live: 1=original, 0=already relayed by Hub
+    uint8_t rateDeciHz;      ///< Current broadcast rate in 0.1 Hz (0 = unknown, older firmware)
+    uint8_t quality;         ///< FixQuality flags (0 = plausible fix, older firmware: always 0)
+};
+
+static const uint8_t CONFIG_MAX_TARGETS = 8;       ///< Max MAC addresses per config frame
+static const uint8_t CONFIG_MAX_DELTAS = 12;       ///< Max key/value deltas per config frame
+static const uint8_t CONFIG_SIGNATURE_LEN = 16;    ///< Truncated HMAC-SHA256 length (config, course, countdown)
+
+/**
+ * @brief One configuration change (key from ConfigKey, see Config.h)
+ */
+struct ConfigDelta {
+    uint8_t key;             ///< ConfigKey identifier
+    uint8_t reserved[3];     ///< Padding (must be 0)
+    int32_t value;           ///< New value
+};
+
+/**
+ * @brief Signed fleet configuration frame broadcast by the committee Display or a host tool
+ */
+struct ConfigPushPacket {
+    int8_t messageType;      ///< MSG_CONFIG_PUSH
+    uint8_t targetCount;     ///< 0 = all boats, otherwise number of MACs in targets[]
+    uint8_t deltaCount;      ///< Number of valid entries in deltas[]
+    uint8_t reserved;        ///< Padding (must be 0)
+    uint32_t configVersion;  ///< Version of the resulting configuration (must increase)
+    uint8_t targets[CONFIG_MAX_TARGETS][6];             ///< Addressed boats (MAC)
+    ConfigDelta deltas[CONFIG_MAX_DELTAS];              ///< Changes to apply atomically
+    uint8_t signature[CONFIG_SIGNATURE_LEN];            ///< HMAC-SHA256 of all previous bytes (truncated)
+};
+
+/**
+ * @brief Compact acknowledgement sent by a boat after a config frame
+ */
+struct ConfigAckPacket {
+    int8_t messageType;      ///< MSG_CONFIG_ACK
+    uint8_t status;          ///< ConfigStatus (see Config.h)
+    uint8_t reserved[2];     ///< Padding
+    uint32_t requestedVersion; ///< Version carried by the config frame
+    uint32_t activeVersion;  ///< Version now active on the boat
+};
+
+static const uint8_t START_FLAG_CANCEL = 0x01;     ///< Abandon the start sequence
+static const uint8_t START_FLAG_HAS_LINE = 0x02;   ///< Line end coordinates are valid
+
+/**
+ * @brief Start countdown broadcast by the committee (repeated during the sequence)
+ */
+struct StartCountdownPacket {
+    int8_t messageType;      ///< MSG_START_COUNTDOWN
+    uint8_t flags;           ///< START_FLAG_* bits
+    uint16_t windowS;        ///< High-rate window before the gun (s, 0 = boat config)
+    uint32_t gunTimeOfDayMs; ///< GPS time of day of the start signal (ms since 00:00 UTC)
+    int32_t committeeLat;    ///< Committee boat end (starboard) latitude (1e-7 deg)
+    int32_t committeeLon;    ///< Committee boat end longitude (1e-7 deg)
+    int32_t pinLat;          ///< Pin end (port) latitude (1e-7 deg)
+    int32_t pinLon;          ///< Pin end longitude (1e-7 deg)
+    uint8_t signature[CONFIG_SIGNATURE_LEN];            ///< HMAC-SHA256 of all previous bytes, fleet key (truncated)
+};  // 40 bytes
+
+/**
+ * @brief Wind broadcast by a fixed anemometer (Display protocol)
+ * 
+ * The anemometer is moored or on shore: its measure is the true wind.
+ * Frames shorter than this structure are ignored.
+ */
+struct AnemometerPacket {
+    int8_t messageType;      ///< MSG_ANEMOMETER
+    char anemometerId[18];   ///< Anemometer name
+    uint32_t sequenceNumber; ///< Incremented per frame
+    float windSpeed;         ///< True wind speed (knots)
+    float windDirection;     ///< True wind direction, from (degrees, 0-360)
+};  // 32 bytes
+
+static const uint8_t COURSE_MAX_ENTRIES = 16;       ///< Mark entries in a CoursePacket
+static const uint8_t COURSE_MAX_MARKS = 8;          ///< Distinct marks (fenceId 0-7)
+static const uint8_t COURSE_LAP_MARK = 0x01;        ///< Rounding this mark completes a lap
+
+/**
+ * @brief One entry of a course: a circle, or one vertex of a polygon
+ * 
+ * Entries with the same markId form one mark: a single entry with a
+ * radius is a circle, 3 or more entries with radius 0 are a polygon
+ * (vertices in order).
+ */
+struct CourseMark {
+    int32_t latitude;        ///< 1e-7 degree
+    int32_t longitude;       ///< 1e-7 degree
+    uint16_t radiusM;        ///< Circle radius (m), 0 = polygon vertex
+    uint8_t markId;          ///< Mark index in course order (0-7)
+    uint8_t flags;           ///< COURSE_* bits
+};
+
+/**
+ * @brief Course marks broadcast by the committee (repeated, saved by the boats)
+ */
+struct CoursePacket {
+    int8_t messageType;      ///< MSG_COURSE
+    uint8_t count;           ///< Valid entries in marks[] (0 = clear the course)
+    uint16_t courseId;       ///< Changes with the course (boats ignore repeats)
+    CourseMark marks[COURSE_MAX_ENTRIES];
+    uint8_t signature[CONFIG_SIGNATURE_LEN];            ///< HMAC-SHA256 of all previous bytes, fleet key (truncated)
+};  // 212 bytes
+
+/**
+ * @brief Real-time event reported by a boat (sent 3 times, same eventSequence)
+ */
+struct EventPacket {
+    int8_t messageType;      ///< MSG_EVENT
+    uint8_t eventType;       ///< EventType
+    uint16_t eventSequence;  ///< Incremented per event (receivers drop repeats)
+    uint8_t detail;          ///< Event specific value
+    uint8_t reserved[3];     ///< Padding (0)
+    uint32_t timeOfDayMs;    ///< GPS time of day of the event, interpolated between fixes
+    int32_t relativeMs;      ///< Line crossing: relative to the gun (< 0 = before the start), see EventType
+    float latitude;          ///< Event position
+    float longitude;
+    float speed;             ///< Speed in knots at the event
+};
+
+/**
+ * @brief State of the clock of a time beacon sender
+ */
+enum TimeSyncState : uint8_t {
+    TIME_UNSYNCED = 0,       ///< No GPS time (never sent by the firmware)
+    TIME_GNSS = 1,           ///< Disciplined by the GNSS receiver
+    TIME_HOLDOVER = 2        ///< GNSS lost: extrapolated with the measured drift
+};
+
+static const int32_t TIME_BEACON_NO_CORRECTION = INT32_MIN;   ///< correctionUs of a beacon whose predecessor was not sent
+
+/**
+ * @brief GPS time broadcast by a boat for devices without GNSS (anemometers, buoys)
+ *
+ * The stamp is taken just before esp_now_send(); the frame then waits in
+ * the TX queue and on the channel. The next beacon carries that wait,
+ * measured up to the send callback (end of transmission): a receiver adds
+ * it to the stamp of the previous beacon and pairs the result with its
+ * own reception time of that beacon.
+ */
+struct TimeBeaconPacket {
+    int8_t messageType;      ///< MSG_TIME_BEACON
+    uint8_t state;           ///< TimeSyncState of the sender clock
+    uint16_t sequence;       ///< Incremented per beacon (correctionUs refers to sequence - 1)
+    uint32_t gpsSeconds;     ///< GPS (UTC) time of the stamp: Unix seconds
+    uint32_t gpsMicros;      ///< and microseconds (0-999999)
+    int32_t correctionUs;    ///< Previous beacon: end of transmission minus its stamp (µs)
+    uint16_t accuracyUs;     ///< Estimated error of the sender clock (µs, saturates at 65535)
+    uint8_t reserved[2];     ///< Padding (0)
+};  // 20 bytes
+
+static const uint8_t TELEMETRY_VERSION = 4;          ///< BoatTelemetryPacket layout version (2: session stats, 3: wind, 4: smoothed course)
+static const uint8_t TELEMETRY_HAS_LINE = 0x01;      ///< Start line fields are valid
+static const uint8_t TELEMETRY_OCS = 0x02;           ///< On course side before the gun
+static const uint8_t TELEMETRY_COUNTDOWN = 0x04;     ///< timeToGunMs is valid
+static const uint8_t TELEMETRY_STARBOARD = 0x08;     ///< On starboard tack (wind reference known)
+static const uint8_t TELEMETRY_PORT = 0x10;          ///< On port tack (wind reference known)
+static const uint8_t TELEMETRY_WIND = 0x20;          ///< twdDeci / twsCms are valid (anemometer heard)
+static const uint8_t TELEMETRY_PERFORMANCE = 0x40;   ///< twaDeci / vmgCms / targetCms / polarPermille are valid
+static const uint8_t TELEMETRY_COURSE = 0x80;        ///< cogDeci is valid (boat moving, course steady)
+
+/**
+ * @brief On-board computed data, sent right after each GPSBroadcastPacket
+ * 
+ * Kept separate so that the 48-byte position packet stays compatible with
+ * existing Displays. Receivers match both frames on sequenceNumber.
+ */
+struct BoatTelemetryPacket {
+    int8_t messageType;      ///< MSG_TELEMETRY
+    uint8_t version;         ///< TELEMETRY_VERSION
+    uint8_t flags;           ///< TELEMETRY_* bits
+    uint8_t reserved;        ///< Padding (0)
+    uint32_t sequenceNumber; ///< Same as the GPSBroadcastPacket sent just before
+    int32_t lineDistanceCm;  ///< Signed distance to the start line (cm, > 0 = pre-start side)
+    int32_t timeToLineMs;    ///< Time to the line at the current closing speed (INT32_MAX = not closing)
+    int32_t timeToGunMs;     ///< Time to the gun (ms, < 0 after the gun)
+    int16_t closingCms;      ///< Closing speed toward the line (cm/s)
+    uint16_t speed2sCms;     ///< Session: average speed over the last 2 s (cm/s)
+    uint32_t distanceM;      ///< Session: distance sailed (m)
+    uint16_t speed10sCms;    ///< Session: average speed over the last 10 s (cm/s)
+    uint16_t maxSpeedCms;    ///< Session: maximum 2 s average speed (cm/s)
+    uint8_t tacks;           ///< Session: tacks (saturates at 255)
+    uint8_t gybes;           ///< Session: gybes (saturates at 255)
+    uint16_t starboardS;     ///< Session: time on starboard tack (s, saturates)
+    uint16_t portS;          ///< Session: time on port tack (s, saturates)
+    uint16_t twdDeci;        ///< Wind: smoothed true wind direction, from (0.1 deg)
+    int16_t twaDeci;         ///< Wind: true wind angle (0.1 deg, > 0 = wind over starboard)
+    uint16_t twsCms;         ///< Wind: smoothed true wind speed (cm/s)
+    int16_t vmgCms;          ///< Wind: velocity made good toward the wind (cm/s, < 0 = downwind)
+    uint16_t targetCms;      ///< Wind: polar target speed (cm/s)
+    uint16_t polarPermille;  ///< Wind: speed over polar target (per mille)
+    uint16_t cogDeci;        ///< Smoothed course over ground (0.1 deg)
+    uint16_t sogCms;         ///< Smoothed speed over ground (cm/s)
+    uint16_t cogConfidence;  ///< Course steadiness: mean resultant length (per mille)
+};  // 56 bytes
+
+// ============================================
+// Wire layout (single definition of the format)
+// ============================================
+
+/**
+ * @brief Byte offsets of GPSBroadcastPacket on the air
+ */
+struct BoatWire {
+    static const size_t TYPE = 0;
+    static const size_t NAME = 1;            ///< char[18], NUL terminated
+    static const size_t SEQUENCE = 20;
+    static const size_t TIMESTAMP = 24;
+    static const size_t LATITUDE = 28;
+    static const size_t LONGITUDE = 32;
+    static const size_t SPEED = 36;
+    static const size_t HEADING = 40;
+    static const size_t SATELLITES = 44;
+    static const size_t TTL = 45;
+    static const size_t RATE = 46;           ///< 0 in frames of older firmware
+    static const size_t QUALITY = 47;        ///< 0 in frames of older firmware
+    static const size_t SIZE = 48;
+};
+
+/**
+ * @brief Byte offsets of AnemometerPacket
+ */
+struct AnemometerWire {
+    static const size_t TYPE = 0;
+    static const size_t ID = 1;              ///< char[18]
+    static const size_t SEQUENCE = 20;
+    static const size_t WIND_SPEED = 24;
+    static const size_t WIND_DIRECTION = 28;
+    static const size_t SIZE = 32;
+};
+
+/**
+ * @brief Byte offsets of ConfigPushPacket (and of one ConfigDelta)
+ */
+struct ConfigPushWire {
+    static const size_t TYPE = 0;
+    static const size_t TARGET_COUNT = 1;
+    static const size_t DELTA_COUNT = 2;
+    static const size_t VERSION = 4;
+    static const size_t TARGETS = 8;         ///< 6 bytes per MAC
+    static const size_t DELTAS = 56;         ///< DELTA_SIZE bytes per delta
+    static const size_t SIGNATURE = 152;     ///< HMAC of bytes [0, SIGNATURE)
+    static const size_t SIZE = 168;
+    static const size_t DELTA_KEY = 0;
+    static const size_t DELTA_VALUE = 4;
+    static const size_t DELTA_SIZE = 8;
+};
+
+/**
+ * @brief Byte offsets of ConfigAckPacket
+ */
+struct ConfigAckWire {
+    static const size_t TYPE = 0;
+    static const size_t STATUS = 1;
+    static const size_t REQUESTED_VERSION = 4;
+    static const size_t ACTIVE_VERSION = 8;
+    static const size_t SIZE = 12;
+};
+
+/**
+ * @brief Byte offsets of StartCountdownPacket
+ */
+struct CountdownWire {
+    static const size_t TYPE = 0;
+    static const size_t FLAGS = 1;
+    static const size_t WINDOW = 2;
+    static const size_t GUN_TIME = 4;
+    static const size_t COMMITTEE_LAT = 8;
+    static const size_t COMMITTEE_LON = 12;
+    static const size_t PIN_LAT = 16;
+    static const size_t PIN_LON = 20;
+    static const size_t SIGNATURE = 24;      ///< HMAC of bytes [0, SIGNATURE)
+    static const size_t SIZE = 40;
+};
+
+/**
+ * @brief Byte offsets of EventPacket
+ */
+struct EventWire {
+    static const size_t TYPE = 0;
+    static const size_t EVENT_TYPE = 1;
+    static const size_t SEQUENCE = 2;
+    static const size_t DETAIL = 4;
+    static const size_t TIME_OF_DAY = 8;
+    static const size_t RELATIVE = 12;
+    static const size_t LATITUDE = 16;
+    static const size_t LONGITUDE = 20;
+    static const size_t SPEED = 24;
+    static const size_t SIZE = 28;
+};
+
+/**
+ * @brief Byte offsets of BoatTelemetryPacket, and frame size of each layout version
+ *
+ * Each version only appends fields: a receiver reads the fields of the
+ * versions it knows from a newer frame.
+ */
+struct TelemetryWire {
+    static const size_t TYPE = 0;
+    static const size_t VERSION = 1;
+    static const size_t FLAGS = 2;
+    static const size_t SEQUENCE = 4;
+    static const size_t LINE_DISTANCE = 8;
+    static const size_t TIME_TO_LINE = 12;
+    static const size_t TIME_TO_GUN = 16;
+    static const size_t CLOSING = 20;
+    static const size_t SIZE_V1 = 24;
+    static const size_t SPEED_2S = 22;       ///< From version 2
+    static const size_t DISTANCE = 24;
+    static const size_t SPEED_10S = 28;
+    static const size_t MAX_SPEED = 30;
+    static const size_t TACKS = 32;
+    static const size_t GYBES = 33;
+    static const size_t STARBOARD = 34;
+    static const size_t PORT = 36;
+    static const size_t SIZE_V2 = 40;
+    static const size_t TWD = 38;            ///< From version 3
+    static const size_t TWA = 40;
+    static const size_t TWS = 42;
+    static const size_t VMG = 44;
+    static const size_t TARGET = 46;
+    static const size_t POLAR = 48;
+    static const size_t SIZE_V3 = 52;
+    static const size_t COG = 50;            ///< From version 4
+    static const size_t SOG = 52;
+    static const size_t COG_CONFIDENCE = 54;
+    static const size_t SIZE_V4 = 56;
+
+    /**
+     * @brief Frame size of a layout version (0 if unknown)
+     */
+    static constexpr size_t size(uint8_t version) {
+        return version == 1 ? SIZE_V1 : version == 2 ? SIZE_V2 : version == 3 ? SIZE_V3 : version == 4 ? SIZE_V4 : 0;
+    }
+};
+
+/**
+ * @brief Byte offsets of CoursePacket (and of one CourseMark)
+ */
+struct CourseWire {
+    static const size_t TYPE = 0;
+    static const size_t COUNT = 1;
+    static const size_t COURSE_ID = 2;
+    static const size_t MARKS = 4;           ///< MARK_SIZE bytes per entry
+    static const size_t SIGNATURE = 196;     ///< HMAC of bytes [0, SIGNATURE)
+    static const size_t SIZE = 212;
+    static const size_t MARK_LATITUDE = 0;
+    static const size_t MARK_LONGITUDE = 4;
+    static const size_t MARK_RADIUS = 8;
+    static const size_t MARK_ID = 10;
+    static const size_t MARK_FLAGS = 11;
+    static const size_t MARK_SIZE = 12;
+};
+
+/**
+ * @brief Byte offsets of TimeBeaconPacket
+ */
+struct TimeBeaconWire {
+    static const size_t TYPE = 0;
+    static const size_t STATE = 1;
+    static const size_t SEQUENCE = 2;
+    static const size_t SECONDS = 4;
+    static const size_t MICROS = 8;
+    static const size_t CORRECTION = 12;
+    static const size_t ACCURACY = 16;
+    static const size_t SIZE = 20;
+};
+
+/**
+ * @brief Field at its wire offset, naturally aligned (same layout on every ABI of the receivers)
+ */
+#define BOAT_WIRE_FIELD(packet, field, offset) \
+    static_assert(offsetof(packet, field) == (offset) && (offset) % alignof(decltype(packet::field)) == 0, \
+                  #packet "." #field " is not at its wire offset")
+
+/**
+ * @brief Packet size equal to the wire size, within an ESP-NOW frame
+ */
+#define BOAT_WIRE_SIZE(packet, size) \
+    static_assert(sizeof(packet) == (size) && (size) <= BOAT_PROTOCOL_MAX_FRAME, \
+                  "sizeof(" #packet ") differs from its wire size")
+
+BOAT_WIRE_SIZE(GPSBroadcastPacket, BoatWire::SIZE);
+BOAT_WIRE_FIELD(GPSBroadcastPacket, messageType, BoatWire::TYPE);
+BOAT_WIRE_FIELD(GPSBroadcastPacket, name, BoatWire::NAME);
+BOAT_WIRE_FIELD(GPSBroadcastPacket, sequenceNumber, BoatWire::SEQUENCE);
+BOAT_WIRE_FIELD(GPSBroadcastPacket, gpsTimestamp, BoatWire::TIMESTAMP);
+BOAT_WIRE_FIELD(GPSBroadcastPacket, latitude, BoatWire::LATITUDE);
+BOAT_WIRE_FIELD(GPSBroadcastPacket, longitude, BoatWire::LONGITUDE);
+BOAT_WIRE_FIELD(GPSBroadcastPacket, speed, BoatWire::SPEED);
+BOAT_WIRE_FIELD(GPSBroadcastPacket, heading, BoatWire::HEADING);
+BOAT_WIRE_FIELD(GPSBroadcastPacket, satellites, BoatWire::SATELLITES);
+BOAT_WIRE_FIELD(GPSBroadcastPacket, ttl, BoatWire::TTL);
+BOAT_WIRE_FIELD(GPSBroadcastPacket, rateDeciHz, BoatWire::RATE);
+BOAT_WIRE_FIELD(GPSBroadcastPacket, quality, BoatWire::QUALITY);
+
+BOAT_WIRE_SIZE(AnemometerPacket, AnemometerWire::SIZE);
+BOAT_WIRE_FIELD(AnemometerPacket, anemometerId, AnemometerWire::ID);
+BOAT_WIRE_FIELD(AnemometerPacket, sequenceNumber, AnemometerWire::SEQUENCE);
+BOAT_WIRE_FIELD(AnemometerPacket, windSpeed, AnemometerWire::WIND_SPEED);
+BOAT_WIRE_FIELD(AnemometerPacket, windDirection, AnemometerWire::WIND_DIRECTION);
+
+BOAT_WIRE_SIZE(ConfigDelta, ConfigPushWire::DELTA_SIZE);
+BOAT_WIRE_FIELD(ConfigDelta, key, ConfigPushWire::DELTA_KEY);
+BOAT_WIRE_FIELD(ConfigDelta, value, ConfigPushWire::DELTA_VALUE);
+BOAT_WIRE_SIZE(ConfigPushPacket, ConfigPushWire::SIZE);
+BOAT_WIRE_FIELD(ConfigPushPacket, targetCount, ConfigPushWire::TARGET_COUNT);
+BOAT_WIRE_FIELD(ConfigPushPacket, deltaCount, ConfigPushWire::DELTA_COUNT);
+BOAT_WIRE_FIELD(ConfigPushPacket, configVersion, ConfigPushWire::VERSION);
+BOAT_WIRE_FIELD(ConfigPushPacket, targets, ConfigPushWire::TARGETS);
+BOAT_WIRE_FIELD(ConfigPushPacket, deltas, ConfigPushWire::DELTAS);
+BOAT_WIRE_FIELD(ConfigPushPacket, signature, ConfigPushWire::SIGNATURE);
+
+BOAT_WIRE_SIZE(ConfigAckPacket, ConfigAckWire::SIZE);
+BOAT_WIRE_FIELD(ConfigAckPacket, status, ConfigAckWire::STATUS);
+BOAT_WIRE_FIELD(ConfigAckPacket, requestedVersion, ConfigAckWire::REQUESTED_VERSION);
+BOAT_WIRE_FIELD(ConfigAckPacket, activeVersion, ConfigAckWire::ACTIVE_VERSION);
+
+BOAT_WIRE_SIZE(StartCountdownPacket, CountdownWire::SIZE);
+BOAT_WIRE_FIELD(StartCountdownPacket, flags, CountdownWire::FLAGS);
+BOAT_WIRE_FIELD(StartCountdownPacket, windowS, CountdownWire::WINDOW);
+BOAT_WIRE_FIELD(StartCountdownPacket, gunTimeOfDayMs, CountdownWire::GUN_TIME);
+BOAT_WIRE_FIELD(StartCountdownPacket, committeeLat, CountdownWire::COMMITTEE_LAT);
+BOAT_WIRE_FIELD(StartCountdownPacket, committeeLon, CountdownWire::COMMITTEE_LON);
+BOAT_WIRE_FIELD(StartCountdownPacket, pinLat, CountdownWire::PIN_LAT);
+BOAT_WIRE_FIELD(StartCountdownPacket, pinLon, CountdownWire::PIN_LON);
+BOAT_WIRE_FIELD(StartCountdownPacket, signature, CountdownWire::SIGNATURE);
+
+BOAT_WIRE_SIZE(EventPacket, EventWire::SIZE);
+BOAT_WIRE_FIELD(EventPacket, eventType, EventWire::EVENT_TYPE);
+BOAT_WIRE_FIELD(EventPacket, eventSequence, EventWire::SEQUENCE);
+BOAT_WIRE_FIELD(EventPacket, detail, EventWire::DETAIL);
+BOAT_WIRE_FIELD(EventPacket, timeOfDayMs, EventWire::TIME_OF_DAY);
+BOAT_WIRE_FIELD(EventPacket, relativeMs, EventWire::RELATIVE);
+BOAT_WIRE_FIELD(EventPacket, latitude, EventWire::LATITUDE);
+BOAT_WIRE_FIELD(EventPacket, longitude, EventWire::LONGITUDE);
+BOAT_WIRE_FIELD(EventPacket, speed, EventWire::SPEED);
+
+BOAT_WIRE_SIZE(BoatTelemetryPacket, TelemetryWire::SIZE_V4);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, version, TelemetryWire::VERSION);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, flags, TelemetryWire::FLAGS);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, sequenceNumber, TelemetryWire::SEQUENCE);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, lineDistanceCm, TelemetryWire::LINE_DISTANCE);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, timeToLineMs, TelemetryWire::TIME_TO_LINE);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, timeToGunMs, TelemetryWire::TIME_TO_GUN);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, closingCms, TelemetryWire::CLOSING);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, speed2sCms, TelemetryWire::SPEED_2S);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, distanceM, TelemetryWire::DISTANCE);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, speed10sCms, TelemetryWire::SPEED_10S);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, maxSpeedCms, TelemetryWire::MAX_SPEED);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, tacks, TelemetryWire::TACKS);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, gybes, TelemetryWire::GYBES);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, starboardS, TelemetryWire::STARBOARD);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, portS, TelemetryWire::PORT);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, twdDeci, TelemetryWire::TWD);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, twaDeci, TelemetryWire::TWA);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, twsCms, TelemetryWire::TWS);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, vmgCms, TelemetryWire::VMG);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, targetCms, TelemetryWire::TARGET);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, polarPermille, TelemetryWire::POLAR);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, cogDeci, TelemetryWire::COG);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, sogCms, TelemetryWire::SOG);
+BOAT_WIRE_FIELD(BoatTelemetryPacket, cogConfidence, TelemetryWire::COG_CONFIDENCE);
+static_assert(TelemetryWire::size(TELEMETRY_VERSION) == sizeof(BoatTelemetryPacket),
+              "TELEMETRY_VERSION changed without its TelemetryWire size");
+
+BOAT_WIRE_SIZE(CourseMark, CourseWire::MARK_SIZE);
+BOAT_WIRE_FIELD(CourseMark, latitude, CourseWire::MARK_LATITUDE);
+BOAT_WIRE_FIELD(CourseMark, longitude, CourseWire::MARK_LONGITUDE);
+BOAT_WIRE_FIELD(CourseMark, radiusM, CourseWire::MARK_RADIUS);
+BOAT_WIRE_FIELD(CourseMark, markId, CourseWire::MARK_ID);
+BOAT_WIRE_FIELD(CourseMark, flags, CourseWire::MARK_FLAGS);
+BOAT_WIRE_SIZE(CoursePacket, CourseWire::SIZE);
+BOAT_WIRE_FIELD(CoursePacket, count, CourseWire::COUNT);
+BOAT_WIRE_FIELD(CoursePacket, courseId, CourseWire::COURSE_ID);
+BOAT_WIRE_FIELD(CoursePacket, marks, CourseWire::MARKS);
+BOAT_WIRE_FIELD(CoursePacket, signature, CourseWire::SIGNATURE);
+
+BOAT_WIRE_SIZE(TimeBeaconPacket, TimeBeaconWire::SIZE);
+BOAT_WIRE_FIELD(TimeBeaconPacket, state, TimeBeaconWire::STATE);
+BOAT_WIRE_FIELD(TimeBeaconPacket, sequence, TimeBeaconWire::SEQUENCE);
+BOAT_WIRE_FIELD(TimeBeaconPacket, gpsSeconds, TimeBeaconWire::SECONDS);
+BOAT_WIRE_FIELD(TimeBeaconPacket, gpsMicros, TimeBeaconWire::MICROS);
+BOAT_WIRE_FIELD(TimeBeaconPacket, correctionUs, TimeBeaconWire::CORRECTION);
+BOAT_WIRE_FIELD(TimeBeaconPacket, accuracyUs, TimeBeaconWire::ACCURACY);
+
+#endif // BOAT_PROTOCOL_H
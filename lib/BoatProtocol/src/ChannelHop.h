@@ -0,0 +1,170 @@
+/**
+ * @file ChannelHop.h
+ * @brief Saut de canal synchronisé sur l'heure GPS
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Saut de canal synchronisé sur l'heure GPS, commun au firmware, à la
+ * passerelle et aux récepteurs qui le suivent (Display, hubs).
+ *
+ * Le plan est un ensemble de canaux (masque, bits 1 à 13) parcouru en
+ * rotation, un canal par seconde GPS. Les bateaux sont répartis en groupes :
+ * à la seconde s, le groupe g est sur le canal d'indice (s + g) modulo le
+ * nombre de canaux. Deux groupes ne sont donc jamais sur le même canal :
+ * - 1 groupe : toute la flotte change de canal ensemble. Un point d'accès
+ *   ou une autre flotte ne gêne qu'une seconde sur N.
+ * - N groupes : la flotte occupe N canaux à la fois, N fois la capacité d'un
+ *   canal. Un récepteur à une radio n'entend qu'un groupe (celui qu'il suit).
+ *
+ * Aucune émission à moins de GUARD_US d'un changement de seconde : les
+ * horloges des appareils diffèrent de quelques centaines de µs (balises
+ * horaires, TimeSync.h) et la file d'émission doit être vide au changement.
+ *
+ * Comme BoatCodec.h : en-tête seul, sans allocation, C++11 et PC
+ * (simulation de la capacité : tools/channel_hop_sim).
+ */
+
+#ifndef CHANNEL_HOP_H
+#define CHANNEL_HOP_H
+
+#include <stdint.h>
+
+/**
+ * @brief GPS-time channel hopping schedule (channel set, groups)
+ *
+ * Times are GPS (UTC) microseconds since 1970-01-01, as given by
+ * BeaconReceiver::toGpsUs() or TimeBeacon::getGpsTimeUs().
+ */
+class ChannelHop {
+public:
+    static const int64_t DWELL_US = 1000000;       ///< One channel per GPS second
+    static const int64_t GUARD_US = 3000;          ///< No transmission this close to a hop
+    static const uint16_t VALID_CHANNELS = 0x3FFE; ///< Bits 1-13
+    static const uint8_t MAX_CHANNELS = 13;
+
+    ChannelHop() : count(0), groups(1) {
+        configure(0, 1);
+    }
+
+    /**
+     * @brief Set the schedule
+     * @param channelMask Bit n = channel n (1-13); 0 = no hopping
+     * @param groupCount Groups spread over the channels (1 = whole fleet together)
+     * @return false if the mask has a bit outside 1-13, a single channel, or more groups than channels
+     *         (schedule then disabled)
+     */
+    bool configure(uint16_t channelMask, uint8_t groupCount) {
+        count = 0;
+        groups = 1;
+        if (channelMask == 0) {
+            return true;
+        }
+        if ((channelMask & ~VALID_CHANNELS) != 0) {
+            return false;
+        }
+        for (uint8_t channel = 1; channel <= MAX_CHANNELS; channel++) {
+            if (channelMask & (1u << channel)) {
+                channels[count++] = channel;
+            }
+        }
+        if (count < 2 || groupCount == 0 || groupCount > count) {
+            count = 0;
+            return false;
+        }
+        groups = groupCount;
+        return true;
+    }
+
+    /**
+     * @brief At least two channels configured
+     */
+    bool isEnabled() const {
+        return count >= 2;
+    }
+
+    /**
+     * @brief Channels in the rotation
+     */
+    uint8_t getCount() const {
+        return count;
+    }
+
+    /**
+     * @brief Channel of a rotation index (ascending channel numbers)
+     */
+    uint8_t getChannel(uint8_t index) const {
+        return channels[index % count];
+    }
+
+    /**
+     * @brief Groups the fleet is spread into
+     */
+    uint8_t getGroups() const {
+        return groups;
+    }
+
+    /**
+     * @brief Channel of a group during the GPS second holding gpsUs (schedule enabled)
+     * @param gpsUs GPS time (µs since 1970-01-01)
+     * @param group Group (taken modulo the group count)
+     */
+    uint8_t channelAt(int64_t gpsUs, uint8_t group) const {
+        uint64_t second = (uint64_t)(gpsUs / DWELL_US);
+        return channels[(second + group % groups) % count];
+    }
+
+    /**
+     * @brief Group heard on a channel during the GPS second holding gpsUs
+     * @return Group, or groups if no group uses the channel in that second
+     */
+    uint8_t groupOn(int64_t gpsUs, uint8_t channel) const {
+        uint64_t second = (uint64_t)(gpsUs / DWELL_US);
+        for (uint8_t index = 0; index < count; index++) {
+            if (channels[index] == channel) {
+                uint8_t group = (uint8_t)((index + count - second % count) % count);
+                return group < groups ? group : groups;
+            }
+        }
+        return groups;
+    }
+
+    /**
+     * @brief GPS time of the next hop after gpsUs
+     */
+    static int64_t nextHopUs(int64_t gpsUs) {
+        return (gpsUs / DWELL_US + 1) * DWELL_US;
+    }
+
+    /**
+     * @brief Within GUARD_US of a hop (before or after): no transmission
+     */
+    static bool inGuard(int64_t gpsUs) {
+        int64_t into = gpsUs % DWELL_US;
+        return into < GUARD_US || into >= DWELL_US - GUARD_US;
+    }
+
+private:
+    uint8_t channels[MAX_CHANNELS];
+    uint8_t count;
+    uint8_t groups;
+};
+
+#endif // CHANNEL_HOP_H
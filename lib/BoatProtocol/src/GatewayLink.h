@@ -0,0 +1,258 @@
+/**
+ * @file GatewayLink.h
+ * @brief Liaison série du mode passerelle : enregistrements horodatés des trames reçues
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * En mode passerelle (station de base), le firmware recopie chaque trame
+ * ESP-NOW reçue sur sa liaison série USB, pour un PC du bateau comité.
+ * Chaque enregistrement est encadré :
+ *
+ *   A5 5A <type> <longueur uint16> <charge> <CRC-16 uint16>
+ *
+ * Le CRC-16/CCITT-FALSE couvre le type, la longueur et la charge ; tous
+ * les entiers sont petit-boutistes. Un lecteur se resynchronise sur les
+ * octets de synchronisation et ignore le texte de démarrage du firmware.
+ *
+ * Charges :
+ * - GATEWAY_RECORD_FRAME : heure de réception (µs depuis le démarrage,
+ *   prise dans le rappel de réception), MAC, RSSI, canal, trame
+ * - GATEWAY_RECORD_STATS : compteurs de la passerelle, une fois par
+ *   seconde (pertes à chaque étage)
+ *
+ * Comme BoatCodec.h : en-tête seul, sans allocation, C++11 et PC.
+ */
+
+#ifndef GATEWAY_LINK_H
+#define GATEWAY_LINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "BoatProtocol.h"
+
+/**
+ * @brief Record types of the gateway serial link
+ */
+enum GatewayRecordType : uint8_t {
+    GATEWAY_RECORD_FRAME = 1,    ///< One received ESP-NOW frame
+    GATEWAY_RECORD_STATS = 2     ///< Gateway counters (every second)
+};
+
+/**
+ * @brief Byte offsets of a record on the serial link
+ */
+struct GatewayLinkWire {
+    static const uint8_t SYNC1 = 0xA5;
+    static const uint8_t SYNC2 = 0x5A;
+    static const size_t TYPE = 2;              ///< GatewayRecordType
+    static const size_t LENGTH = 3;            ///< uint16 payload length
+    static const size_t PAYLOAD = 5;
+    static const size_t OVERHEAD = 7;          ///< Sync, type, length, CRC
+};
+
+/**
+ * @brief Byte offsets of the GATEWAY_RECORD_FRAME payload
+ */
+struct GatewayFrameWire {
+    static const size_t TIME_US = 0;           ///< uint64 esp_timer_get_time() in the receive callback
+    static const size_t MAC = 8;               ///< Sender
+    static const size_t RSSI = 14;             ///< int8 dBm (GATEWAY_RSSI_UNKNOWN if not sniffed)
+    static const size_t CHANNEL = 15;
+    static const size_t DATA = 16;             ///< ESP-NOW frame, up to BOAT_PROTOCOL_MAX_FRAME bytes
+    static const size_t MAX_SIZE = DATA + BOAT_PROTOCOL_MAX_FRAME;
+};
+
+/**
+ * @brief Byte offsets of the GATEWAY_RECORD_STATS payload (counters since boot)
+ */
+struct GatewayStatsWire {
+    static const size_t TIME_US = 0;           ///< uint64 esp_timer_get_time()
+    static const size_t RECEIVED = 8;          ///< Frames seen by the receive callback
+    static const size_t FORWARDED = 12;        ///< Records fully handed to the serial driver
+    static const size_t RING_DROPPED = 16;     ///< Callback found the ring full
+    static const size_t SERIAL_DROPPED = 20;   ///< Records discarded while the host did not read
+    static const size_t INVALID = 24;          ///< Empty or oversized frames
+    static const size_t RSSI_MISSING = 28;     ///< Frames without a sniffed RSSI
+    static const size_t RING_HIGH_WATER = 32;  ///< uint16 most records waiting in the ring
+    static const size_t RING_SIZE = 34;        ///< uint16
+    static const size_t CHANNEL = 36;
+    static const size_t SIZE = 37;
+};
+
+static const int8_t GATEWAY_RSSI_UNKNOWN = -128;
+static const size_t GATEWAY_RECORD_MAX = GatewayLinkWire::OVERHEAD + GatewayFrameWire::MAX_SIZE;
+
+namespace GatewayLink {
+
+/**
+ * @brief CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF)
+ */
+inline uint16_t crc16(uint16_t crc, const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+inline void put64(uint8_t* p, uint64_t value) {
+    for (uint8_t i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+inline uint64_t get64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+        value |= (uint64_t)p[i] << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief Write the sync bytes, type and length of a record
+ * @return Pointer to the payload (payloadLen bytes to fill, then finish())
+ */
+inline uint8_t* begin(uint8_t* out, GatewayRecordType type, uint16_t payloadLen) {
+    out[0] = GatewayLinkWire::SYNC1;
+    out[1] = GatewayLinkWire::SYNC2;
+    out[GatewayLinkWire::TYPE] = type;
+    out[GatewayLinkWire::LENGTH] = (uint8_t)payloadLen;
+    out[GatewayLinkWire::LENGTH + 1] = (uint8_t)(payloadLen >> 8);
+    return out + GatewayLinkWire::PAYLOAD;
+}
+
+/**
+ * @brief Append the CRC of a record prepared by begin()
+ * @return Record length on the link
+ */
+inline size_t finish(uint8_t* out) {
+    uint16_t payloadLen = (uint16_t)(out[GatewayLinkWire::LENGTH] | (out[GatewayLinkWire::LENGTH + 1] << 8));
+    size_t end = GatewayLinkWire::PAYLOAD + payloadLen;
+    uint16_t crc = crc16(0xFFFF, out + GatewayLinkWire::TYPE, end - GatewayLinkWire::TYPE);
+    out[end] = (uint8_t)crc;
+    out[end + 1] = (uint8_t)(crc >> 8);
+    return end + 2;
+}
+
+/**
+ * @brief Byte-by-byte record parser (host side)
+ *
+ * Bytes outside records (boot messages of the firmware) are skipped;
+ * a CRC error resumes the search at the byte after the first sync byte.
+ */
+class Parser {
+public:
+    Parser() : state(WAIT_SYNC1), count(0), expected(0), skipped(0), crcErrors(0) {}
+
+    /**
+     * @brief Feed one byte
+     * @return true when a record is complete (type(), payload(), length())
+     */
+    bool push(uint8_t byte) {
+        switch (state) {
+            case WAIT_SYNC1:
+                if (byte == GatewayLinkWire::SYNC1) {
+                    state = WAIT_SYNC2;
+                } else {
+                    skipped++;
+                }
+                return false;
+            case WAIT_SYNC2:
+                if (byte == GatewayLinkWire::SYNC2) {
+                    buffer[0] = GatewayLinkWire::SYNC1;
+                    buffer[1] = GatewayLinkWire::SYNC2;
+                    count = 2;
+                    state = READ_HEADER;
+                } else if (byte != GatewayLinkWire::SYNC1) {
+                    skipped += 2;
+                    state = WAIT_SYNC1;
+                } else {
+                    skipped++;
+                }
+                return false;
+            case READ_HEADER:
+                buffer[count++] = byte;
+                if (count == GatewayLinkWire::PAYLOAD) {
+                    size_t payloadLen = buffer[GatewayLinkWire::LENGTH] | (buffer[GatewayLinkWire::LENGTH + 1] << 8);
+                    if (payloadLen > GatewayFrameWire::MAX_SIZE) {
+                        resync();
+                        return false;
+                    }
+                    expected = GatewayLinkWire::PAYLOAD + payloadLen + 2;
+                    state = READ_BODY;
+                }
+                return false;
+            case READ_BODY:
+                buffer[count++] = byte;
+                if (count < expected) {
+                    return false;
+                }
+                {
+                    uint16_t crc = crc16(0xFFFF, buffer + GatewayLinkWire::TYPE, expected - 2 - GatewayLinkWire::TYPE);
+                    if (buffer[expected - 2] != (uint8_t)crc || buffer[expected - 1] != (uint8_t)(crc >> 8)) {
+                        resync();
+                        return false;
+                    }
+                }
+                state = WAIT_SYNC1;
+                return true;
+        }
+        return false;
+    }
+
+    uint8_t type() const { return buffer[GatewayLinkWire::TYPE]; }
+    const uint8_t* payload() const { return buffer + GatewayLinkWire::PAYLOAD; }
+    size_t length() const { return expected - GatewayLinkWire::OVERHEAD; }
+
+    uint32_t getSkipped() const { return skipped; }      ///< Bytes outside records
+    uint32_t getCrcErrors() const { return crcErrors; }  ///< Candidate records rejected
+
+private:
+    enum State : uint8_t { WAIT_SYNC1, WAIT_SYNC2, READ_HEADER, READ_BODY };
+
+    State state;
+    size_t count;
+    size_t expected;
+    uint32_t skipped;
+    uint32_t crcErrors;
+    uint8_t buffer[GATEWAY_RECORD_MAX];
+
+    /**
+     * @brief Bad header or CRC: search again from the byte after SYNC1
+     */
+    void resync() {
+        crcErrors++;
+        size_t length = count;
+        state = WAIT_SYNC1;
+        count = 0;
+        skipped++;
+        for (size_t i = 1; i < length; i++) {
+            push(buffer[i]);
+        }
+    }
+};
+
+}  // namespace GatewayLink
+
+#endif // GATEWAY_LINK_H
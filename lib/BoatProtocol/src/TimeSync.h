@@ -0,0 +1,427 @@
+/**
+ * @file TimeSync.h
+ * @brief Estimation de l'heure GPS d'une horloge locale (balises horaires)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Estimation de l'écart entre une horloge locale (esp_timer, µs depuis le
+ * démarrage) et l'heure GPS, commune au firmware (bateau discipliné par le
+ * récepteur GNSS) et aux appareils sans GNSS qui écoutent ses balises
+ * horaires (anémomètres, bouées, Display).
+ *
+ * ClockEstimator : régression linéaire sur une fenêtre glissante des
+ * derniers échantillons (heure locale, écart), qui donne l'écart et la
+ * dérive du quartz (quelques dizaines de ppm). Deux modes :
+ * - MEAN : bruit symétrique (réception d'une balise corrigée). Les points à
+ *   plus de 3 écarts-types sont écartés une fois, puis la droite est
+ *   recalculée.
+ * - ENVELOPE : retards toujours positifs (début d'une rafale NMEA vu par
+ *   loop()). La droite est l'arête de l'enveloppe convexe supérieure des
+ *   points située au-dessus de leur heure moyenne : aucun point au-dessus,
+ *   et la plus proche d'eux en moyenne. Elle passe par les points de plus
+ *   petit retard.
+ * Un saut d'écart au-delà de STEP_US est ignoré, puis accepté comme nouvelle
+ * référence s'il se répète (changement d'heure de l'émetteur).
+ *
+ * BeaconReceiver : côté récepteur. À la balise N, la correction portée par
+ * la balise N (fin d'émission de N-1 moins son horodatage) s'ajoute à
+ * l'horodatage de N-1 et forme, avec l'heure locale de réception de N-1, un
+ * échantillon sans l'attente de la file d'émission ni l'occupation du canal.
+ * Une seule source suivie, remplacée après SOURCE_TIMEOUT_US de silence.
+ *
+ * Comme BoatCodec.h : en-tête seul, sans allocation, C++11 et PC
+ * (simulation de la précision : tools/time_sync_sim).
+ */
+
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "BoatProtocol.h"
+
+/**
+ * @brief Windowed least-squares estimate of the offset and drift of a local clock
+ *
+ * Samples are (local time, reference - local) in microseconds. The fit
+ * is recomputed at each sample (WINDOW points, a few µs on an ESP32).
+ */
+class ClockEstimator {
+public:
+    /**
+     * @brief Noise model of the samples
+     */
+    enum Mode : uint8_t {
+        MEAN = 0,                ///< Symmetric noise: least squares through the points
+        ENVELOPE = 1             ///< Delays only (offset never above the truth): line through the highest points
+    };
+
+    static const uint8_t WINDOW = 32;            ///< Samples kept
+    static const uint8_t MIN_SAMPLES = 4;        ///< Samples before isValid() (and before the drift is used)
+    static const int64_t STEP_US = 50000;        ///< Larger jumps are outliers, a clock step if repeated
+    static const uint8_t STEP_CONFIRM = 3;       ///< Consecutive jumps that restart the estimate
+    static constexpr double MAX_DRIFT = 200e-6;  ///< Drift bound (crystal tolerance with margin)
+
+    explicit ClockEstimator(Mode mode = MEAN) : mode(mode) {
+        reset();
+    }
+
+    /**
+     * @brief Forget every sample
+     */
+    void reset() {
+        head = 0;
+        count = 0;
+        steps = 0;
+        baseLocal = 0;
+        baseOffset = 0;
+        slope = 0.0;
+        uncertaintyUs = 0;
+    }
+
+    /**
+     * @brief Add a sample and refit
+     * @param localUs Local time of the sample
+     * @param offsetUs Reference time minus local time at localUs
+     * @return false if the sample was rejected as a jump
+     */
+    bool addSample(int64_t localUs, int64_t offsetUs) {
+        if (count > 0) {
+            int64_t error = offsetUs - offsetAt(localUs);
+            if (error > STEP_US || error < -STEP_US) {
+                if (++steps < STEP_CONFIRM) {
+                    return false;
+                }
+                reset();
+            }
+        }
+        steps = 0;
+        locals[head] = localUs;
+        offsets[head] = offsetUs;
+        head = (uint8_t)((head + 1) % WINDOW);
+        if (count < WINDOW) {
+            count++;
+        }
+        fit(localUs, offsetUs);
+        return true;
+    }
+
+    /**
+     * @brief Enough samples for offset and drift
+     */
+    bool isValid() const {
+        return count >= MIN_SAMPLES;
+    }
+
+    /**
+     * @brief Reference minus local time at a local instant (extrapolated with the drift)
+     */
+    int64_t offsetAt(int64_t localUs) const {
+        return baseOffset + (int64_t)llround(slope * (double)(localUs - baseLocal));
+    }
+
+    /**
+     * @brief Reference time of a local instant
+     */
+    int64_t toReference(int64_t localUs) const {
+        return localUs + offsetAt(localUs);
+    }
+
+    /**
+     * @brief Drift of the local clock (ppm, > 0 = local clock slow)
+     */
+    double getDriftPpm() const {
+        return slope * 1e6;
+    }
+
+    /**
+     * @brief Estimated error of the offset at the last sample (µs)
+     *
+     * MEAN: standard error of the fit. ENVELOPE: expected smallest delay
+     * of the window for uniform delays (2 × mean depth / (n + 1)).
+     */
+    uint32_t getUncertaintyUs() const {
+        return uncertaintyUs;
+    }
+
+    /**
+     * @brief Samples in the window
+     */
+    uint8_t getCount() const {
+        return count;
+    }
+
+    /**
+     * @brief Local time of the last sample
+     */
+    int64_t getLastSampleUs() const {
+        return baseLocal;
+    }
+
+private:
+    Mode mode;
+    int64_t locals[WINDOW];
+    int64_t offsets[WINDOW];
+    uint8_t head;
+    uint8_t count;
+    uint8_t steps;                 ///< Consecutive jumps
+    int64_t baseLocal;             ///< Fit origin: last sample
+    int64_t baseOffset;            ///< Offset at baseLocal
+    double slope;                  ///< d(offset)/d(local)
+    uint32_t uncertaintyUs;
+
+    /**
+     * @brief Least squares over the points selected by keep
+     * @return Number of points used
+     */
+    uint8_t fitLine(const double* x, const double* y, const bool* keep, double& a, double& b) const {
+        double sx = 0, sy = 0;
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            if (keep[i]) {
+                sx += x[i];
+                sy += y[i];
+                n++;
+            }
+        }
+        if (n == 0) {
+            return 0;
+        }
+        double mx = sx / n, my = sy / n, sxx = 0, sxy = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            if (keep[i]) {
+                sxx += (x[i] - mx) * (x[i] - mx);
+                sxy += (x[i] - mx) * (y[i] - my);
+            }
+        }
+        a = (n >= MIN_SAMPLES && sxx > 0) ? sxy / sxx : 0.0;
+        a = a > MAX_DRIFT ? MAX_DRIFT : (a < -MAX_DRIFT ? -MAX_DRIFT : a);
+        b = my - a * mx;
+        return n;
+    }
+
+    void fit(int64_t lastLocal, int64_t lastOffset) {
+        double x[WINDOW], y[WINDOW];
+        bool keep[WINDOW];
+        for (uint8_t i = 0; i < count; i++) {
+            x[i] = (double)(locals[i] - lastLocal);
+            y[i] = (double)(offsets[i] - lastOffset);
+            keep[i] = true;
+        }
+        double a = 0, b = 0;
+
+        if (mode == MEAN) {
+            fitLine(x, y, keep, a, b);
+            double sum = 0;
+            for (uint8_t i = 0; i < count; i++) {
+                double r = y[i] - (a * x[i] + b);
+                sum += r * r;
+            }
+            double limit = 3.0 * sqrt(sum / count);
+            bool dropped = false;
+            for (uint8_t i = 0; i < count; i++) {
+                keep[i] = fabs(y[i] - (a * x[i] + b)) <= limit || count < MIN_SAMPLES;
+                dropped |= !keep[i];
+            }
+            uint8_t n = dropped ? fitLine(x, y, keep, a, b) : count;
+            sum = 0;
+            for (uint8_t i = 0; i < count; i++) {
+                if (keep[i]) {
+                    double r = y[i] - (a * x[i] + b);
+                    sum += r * r;
+                }
+            }
+            uncertaintyUs = n > 1 ? (uint32_t)(sqrt(sum / (n - 1)) / sqrt((double)n)) : 0;
+        } else {
+            // Upper convex hull (samples in time order), edge above the mean time
+            double hx[WINDOW], hy[WINDOW];
+            uint8_t hull = 0;
+            double mx = 0;
+            for (uint8_t k = 0; k < count; k++) {
+                uint8_t i = (uint8_t)((head + WINDOW - count + k) % WINDOW);
+                mx += x[i];
+                while (hull >= 2 && (hx[hull - 1] - hx[hull - 2]) * (y[i] - hy[hull - 2]) -
+                                            (hy[hull - 1] - hy[hull - 2]) * (x[i] - hx[hull - 2]) >= 0) {
+                    hull--;
+                }
+                hx[hull] = x[i];
+                hy[hull] = y[i];
+                hull++;
+            }
+            mx /= count;
+            a = 0;
+            b = hy[0];
+            for (uint8_t k = 0; k + 1 < hull && count >= MIN_SAMPLES; k++) {
+                if (hx[k + 1] >= mx) {
+                    a = (hy[k + 1] - hy[k]) / (hx[k + 1] - hx[k]);
+                    break;
+                }
+            }
+            a = a > MAX_DRIFT ? MAX_DRIFT : (a < -MAX_DRIFT ? -MAX_DRIFT : a);
+            double highest = -1e18, depth = 0;
+            for (uint8_t i = 0; i < count; i++) {
+                double level = y[i] - a * x[i];
+                if (level > highest) {
+                    highest = level;
+                }
+            }
+            b = highest;
+            for (uint8_t i = 0; i < count; i++) {
+                depth += b - (y[i] - a * x[i]);
+            }
+            uncertaintyUs = (uint32_t)(2.0 * depth / count / (count + 1));
+        }
+        slope = a;
+        baseLocal = lastLocal;
+        baseOffset = lastOffset + (int64_t)llround(b);
+    }
+};
+
+/**
+ * @brief GPS time of a device without GNSS, from the time beacons of one boat
+ */
+class BeaconReceiver {
+public:
+    static const int64_t SOURCE_TIMEOUT_US = 10000000;   ///< Another boat is followed after this silence
+    static const int32_t MAX_CORRECTION_US = 100000;     ///< Larger corrections are ignored
+
+    /**
+     * @param useCorrections Pair each stamp with the TX time of the next beacon
+     *        (false: stamp and reception time of the same beacon, TX wait included)
+     */
+    explicit BeaconReceiver(bool useCorrections = true) : clock(ClockEstimator::MEAN), useCorrections(useCorrections) {
+        reset();
+    }
+
+    /**
+     * @brief Forget the source and the estimate
+     */
+    void reset() {
+        clock.reset();
+        hasSource = false;
+        hasPrevious = false;
+        memset(source, 0, sizeof(source));
+        lastHeardUs = 0;
+        previousSequence = 0;
+        previousStampUs = 0;
+        previousLocalUs = 0;
+        samples = 0;
+    }
+
+    /**
+     * @brief GPS time of a beacon stamp (µs since 1970-01-01 UTC)
+     */
+    static int64_t stampUs(const TimeBeaconPacket& beacon) {
+        return (int64_t)beacon.gpsSeconds * 1000000 + beacon.gpsMicros;
+    }
+
+    /**
+     * @brief Apply a decoded beacon
+     * @param mac Sender MAC address
+     * @param beacon Decoded beacon
+     * @param localRxUs Local time taken in the receive callback
+     * @return true if a sample was added
+     */
+    bool apply(const uint8_t* mac, const TimeBeaconPacket& beacon, int64_t localRxUs) {
+        if (beacon.state == TIME_UNSYNCED) {
+            return false;
+        }
+        if (hasSource && memcmp(mac, source, sizeof(source)) != 0) {
+            if (localRxUs - lastHeardUs < SOURCE_TIMEOUT_US) {
+                return false;
+            }
+            reset();
+        }
+        if (!hasSource) {
+            memcpy(source, mac, sizeof(source));
+            hasSource = true;
+        }
+        lastHeardUs = localRxUs;
+
+        bool added = false;
+        int64_t stamp = stampUs(beacon);
+        if (!useCorrections) {
+            added = clock.addSample(localRxUs, stamp - localRxUs);
+        } else if (hasPrevious && beacon.sequence == (uint16_t)(previousSequence + 1) &&
+                   beacon.correctionUs != TIME_BEACON_NO_CORRECTION &&
+                   beacon.correctionUs >= 0 && beacon.correctionUs <= MAX_CORRECTION_US) {
+            added = clock.addSample(previousLocalUs, previousStampUs + beacon.correctionUs - previousLocalUs);
+        }
+        hasPrevious = true;
+        previousSequence = beacon.sequence;
+        previousStampUs = stamp;
+        previousLocalUs = localRxUs;
+        if (added) {
+            samples++;
+        }
+        return added;
+    }
+
+    /**
+     * @brief GPS time available
+     */
+    bool isSynced() const {
+        return clock.isValid();
+    }
+
+    /**
+     * @brief GPS time (µs since 1970-01-01 UTC) of a local instant
+     */
+    int64_t toGpsUs(int64_t localUs) const {
+        return clock.toReference(localUs);
+    }
+
+    /**
+     * @brief Estimate (drift, uncertainty)
+     */
+    const ClockEstimator& getClock() const {
+        return clock;
+    }
+
+    /**
+     * @brief Followed boat (valid once a beacon was applied)
+     */
+    const uint8_t* getSource() const {
+        return source;
+    }
+
+    /**
+     * @brief Samples added since the source was chosen
+     */
+    uint32_t getSamples() const {
+        return samples;
+    }
+
+private:
+    ClockEstimator clock;
+    bool useCorrections;
+    bool hasSource;
+    bool hasPrevious;
+    uint8_t source[6];
+    int64_t lastHeardUs;
+    uint16_t previousSequence;
+    int64_t previousStampUs;
+    int64_t previousLocalUs;
+    uint32_t samples;
+};
+
+#endif // TIME_SYNC_H
@@ -0,0 +1,49 @@
+/**
+ * @file Esp.h
+ * @brief Simulateur : objet ESP (compteur de cycles virtuel)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIM_ESP_H
+#define SIM_ESP_H
+
+#include <stdint.h>
+
+/**
+ * @brief Arduino-ESP32 ESP object
+ */
+class EspClass {
+public:
+    /**
+     * @brief Virtual cycle counter: 240 cycles per virtual µs
+     *
+     * Code does not consume virtual time, so measured costs read 0.
+     */
+    uint32_t getCycleCount();
+    uint32_t getFreeHeap() { return 200000; }
+    uint32_t getHeapSize() { return 320000; }
+    uint32_t getCpuFreqMHz();
+    void restart();
+};
+
+extern EspClass ESP;
+
+#endif // SIM_ESP_H
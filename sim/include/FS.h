@@ -0,0 +1,73 @@
+/**
+ * @file FS.h
+ * @brief Simulateur : fichiers Arduino sur le système de fichiers hôte
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIM_FS_H
+#define SIM_FS_H
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+struct SimFileHandle;
+
+/**
+ * @brief Arduino File (copyable handle, closed with the last copy or close())
+ */
+class File : public Stream {
+public:
+    File() {}
+    File(std::shared_ptr<SimFileHandle> handle) : handle(handle) {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t read(uint8_t* buffer, size_t size);
+    void flush() override;
+    bool seek(uint32_t position, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void close();
+    const char* name() const;
+    const char* path() const;
+    bool isDirectory() const { return false; }
+    operator bool() const;
+
+private:
+    std::shared_ptr<SimFileHandle> handle;
+};
+
+#endif // SIM_FS_H
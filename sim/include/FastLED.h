@@ -0,0 +1,85 @@
+/**
+ * @file FastLED.h
+ * @brief Simulateur : LED RGB (changements de couleur tracés avec --led)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIM_FASTLED_H
+#define SIM_FASTLED_H
+
+#include <Arduino.h>
+
+enum EOrder { RGB = 0012, GRB = 0102 };
+
+/**
+ * @brief FastLED colour
+ */
+struct CRGB {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+    CRGB(uint32_t colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+    CRGB& operator=(uint32_t colorcode) {
+        *this = CRGB(colorcode);
+        return *this;
+    }
+    bool operator==(const CRGB& other) const { return r == other.r && g == other.g && b == other.b; }
+    bool operator!=(const CRGB& other) const { return !(*this == other); }
+
+    enum {
+        Black = 0x000000,
+        White = 0xFFFFFF,
+        Red = 0xFF0000,
+        Green = 0x008000,
+        Blue = 0x0000FF
+    };
+};
+
+template <uint8_t DATA_PIN, EOrder ORDER = RGB> class WS2812 {};
+
+/**
+ * @brief FastLED controller: keeps the strip, reports the first LED on show()
+ */
+class CFastLED {
+public:
+    template <template <uint8_t, EOrder> class CHIPSET, uint8_t DATA_PIN, EOrder ORDER>
+    void addLeds(CRGB* data, int count) {
+        leds = data;
+        ledCount = count;
+    }
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    void show();
+    void clear(bool writeData = false);
+
+private:
+    CRGB* leds = nullptr;
+    int ledCount = 0;
+    uint8_t brightness = 255;
+    CRGB shown;
+    bool hasShown = false;
+};
+
+extern CFastLED FastLED;
+
+#endif // SIM_FASTLED_H
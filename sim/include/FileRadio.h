@@ -0,0 +1,83 @@
+/**
+ * @file FileRadio.h
+ * @brief Simulateur : support radio sur fichiers (capture et trames à recevoir)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Format texte, une trame par ligne, identique en capture et en entrée :
+ *
+ *     <ms virtuelles> <canal> <MAC émetteur> <octets en hexadécimal>
+ *     1234.567 1 02:00:00:00:00:01 01a0...
+ *
+ * La capture d'une instance peut être rejouée en entrée d'une autre
+ * (flotte simulée) ; les lignes vides et celles commençant par # sont
+ * ignorées.
+ */
+
+#ifndef SIM_FILE_RADIO_H
+#define SIM_FILE_RADIO_H
+
+#include <stdio.h>
+#include <vector>
+#include "Sim.h"
+
+/**
+ * @brief Radio medium backed by a capture file and an input file
+ */
+class FileRadio : public RadioLink {
+public:
+    FileRadio();
+    ~FileRadio();
+
+    /**
+     * @brief Capture the sent frames
+     * @param path Output file ("-" = standard output)
+     * @return false if the file cannot be created
+     */
+    bool openCapture(const char* path);
+
+    /**
+     * @brief Load the frames to receive (sorted by time)
+     * @return false if the file cannot be read or a line is malformed
+     */
+    bool loadInput(const char* path);
+
+    void transmit(const SimFrame& frame) override;
+    uint64_t nextArrivalUs() const override;
+    bool poll(uint64_t nowUs, SimFrame& frame) override;
+
+    /**
+     * @brief Format a frame as a capture line (without newline)
+     */
+    static void formatFrame(const SimFrame& frame, char* out, size_t size);
+
+    /**
+     * @brief Parse a capture line
+     */
+    static bool parseFrame(const char* line, SimFrame& frame);
+
+private:
+    FILE* capture;
+    std::vector<SimFrame> input;
+    size_t next;
+};
+
+#endif // SIM_FILE_RADIO_H
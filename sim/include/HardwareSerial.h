@@ -0,0 +1,108 @@
+/**
+ * @file HardwareSerial.h
+ * @brief Simulateur : UART de la console et du GPS
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Serial écrit sur la sortie standard. Serial2 reçoit les octets d'une
+ * UartSource au débit de l'UART (10 bits par octet) ; les octets non lus
+ * au-delà du tampon de réception sont perdus, comme sur l'ESP32.
+ *
+ * Émission de la console : les octets partent au débit de l'UART depuis
+ * un tampon d'émission (setTxBufferSize(), FIFO de 128 octets par
+ * défaut). availableForWrite() rend la place libre ; write() ne bloque
+ * jamais (les messages texte ne décalent pas l'horloge virtuelle).
+ * openOutput() envoie les octets bruts dans un fichier, sans horodatage
+ * ni retouche : sortie binaire du mode passerelle.
+ */
+
+#ifndef SIM_HARDWARE_SERIAL_H
+#define SIM_HARDWARE_SERIAL_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "Stream.h"
+
+#define SERIAL_8N1 0x800001c
+
+/**
+ * @brief Simulated UART
+ */
+class HardwareSerial : public Stream {
+public:
+    /**
+     * @param console true: output to stdout; false: input from Sim::gpsSource()
+     */
+    explicit HardwareSerial(bool console);
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+    void end() {}
+    void updateBaudRate(unsigned long baud);
+    unsigned long baudRate() const { return baud; }
+    size_t setRxBufferSize(size_t size);
+    size_t setTxBufferSize(size_t size);
+    operator bool() const { return true; }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int availableForWrite() override;
+    void flush() override;
+
+    /**
+     * @brief Console: raw bytes to this file instead of stdout (simulator only)
+     * @return false if the file cannot be created
+     */
+    bool openOutput(const char* path);
+
+private:
+    static const size_t DEFAULT_RX_BUFFER = 256;        ///< Arduino-ESP32 default
+    static const size_t DEFAULT_TX_BUFFER = 128;        ///< Hardware FIFO only
+
+    bool console;
+    unsigned long baud;
+    size_t rxCapacity;
+    uint8_t* rxBuffer;
+    uint64_t* rxArrivalUs;         ///< Arrival time of each byte in the RX buffer
+    uint64_t beganUs;              ///< begin() time: earlier bytes wait from there
+    size_t rxHead;
+    size_t rxCount;
+    bool overrunning;              ///< Last byte received was lost (burst counting)
+    bool late;                     ///< Last byte read had waited over the fill time
+    bool lineStart;                ///< Console: next byte starts a line (timestamp prefix)
+    size_t txCapacity;
+    uint64_t txBusyUntilUs;        ///< Console: time the last queued byte is sent
+    FILE* output;                  ///< Console: raw output file (nullptr = stdout)
+
+    /**
+     * @brief Move the bytes arrived by now into the RX buffer
+     */
+    void receive();
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif // SIM_HARDWARE_SERIAL_H
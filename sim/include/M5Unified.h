@@ -0,0 +1,76 @@
+/**
+ * @file M5Unified.h
+ * @brief Simulateur : M5Unified (bouton jamais appuyé)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIM_M5UNIFIED_H
+#define SIM_M5UNIFIED_H
+
+#include <Arduino.h>
+
+namespace m5 {
+
+class Button_Class {
+public:
+    bool isPressed() const { return false; }
+    bool isReleased() const { return true; }
+    bool wasPressed() const { return false; }
+    bool wasReleased() const { return false; }
+    bool wasClicked() const { return false; }
+    bool wasHold() const { return false; }
+    bool wasSingleClicked() const { return false; }
+    bool wasDoubleClicked() const { return false; }
+    bool wasDecideClickCount() const { return false; }
+    uint8_t getClickCount() const { return 0; }
+    bool pressedFor(uint32_t ms) const { (void)ms; return false; }
+    bool releasedFor(uint32_t ms) const { (void)ms; return true; }
+    void setHoldThresh(uint32_t ms) { (void)ms; }
+    void setDebounceThresh(uint32_t ms) { (void)ms; }
+};
+
+struct config_t {
+    bool clear_display = true;
+    bool output_power = true;
+    bool pmic_button = true;
+    bool internal_imu = true;
+    bool internal_rtc = true;
+    bool internal_spk = true;
+    bool internal_mic = true;
+    bool external_imu = false;
+    bool external_rtc = false;
+    uint8_t led_brightness = 0;
+    int serial_baudrate = 115200;
+};
+
+class M5Unified {
+public:
+    Button_Class BtnA;
+    config_t config() const { return config_t(); }
+    void begin(const config_t& cfg = config_t()) { (void)cfg; }
+    void update() {}
+};
+
+}  // namespace m5
+
+extern m5::M5Unified M5;
+
+#endif // SIM_M5UNIFIED_H
@@ -0,0 +1,94 @@
+/**
+ * @file NmeaFile.h
+ * @brief Simulateur : GPS rejoué depuis un fichier NMEA
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Chaque phrase est émise à l'heure UTC qu'elle porte (RMC, GGA, GLL,
+ * GNS, ZDA), relative à la première ; les phrases sans heure (GSA, GSV,
+ * VTG...) suivent la précédente. Les octets se succèdent au débit de
+ * l'UART réglé par le firmware (10 bits par octet) : une salve de 1 Hz à
+ * 9600 bauds dure ~450 ms, comme sur le récepteur réel.
+ *
+ * Les lignes défectueuses (octets parasites, phrases tronquées ou
+ * collées, voir NmeaGenerator) sont transmises telles quelles.
+ *
+ * Les commandes envoyées au récepteur (cadence UBX / PCAS) sont ignorées :
+ * la cadence est celle du fichier.
+ */
+
+#ifndef SIM_NMEA_FILE_H
+#define SIM_NMEA_FILE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Sim.h"
+
+/**
+ * @brief UART source replaying an NMEA log at its own pace
+ */
+class NmeaFile : public UartSource {
+public:
+    NmeaFile();
+
+    /**
+     * @brief Load a log
+     * @param path NMEA file (one sentence per line)
+     * @param startUs Virtual time of the first sentence
+     * @return false if the file cannot be read or holds no timed sentence
+     */
+    bool load(const char* path, uint64_t startUs);
+
+    /**
+     * @brief Sentences loaded
+     */
+    size_t getSentenceCount() const;
+
+    void setBaud(unsigned long baud) override;
+    uint64_t nextArrivalUs() const override;
+    bool poll(uint64_t nowUs, uint8_t& byte) override;
+    uint64_t endUs() const override;
+
+private:
+    struct Sentence {
+        std::string text;              ///< With \r\n
+        uint64_t releaseUs;            ///< From the UTC time of the epoch
+    };
+
+    std::vector<Sentence> sentences;
+    unsigned long baud;
+    size_t current;                    ///< Sentence being sent
+    size_t offset;                     ///< Next byte in it
+    uint64_t sentenceStartUs;          ///< First bit of the current sentence
+
+    /**
+     * @brief UTC time of a sentence (ms of day, -1 = none)
+     */
+    static int32_t sentenceTimeMs(const std::string& text);
+
+    /**
+     * @brief Start the current sentence (after the previous one on the wire)
+     */
+    void startSentence(uint64_t lineFreeUs);
+};
+
+#endif // SIM_NMEA_FILE_H
@@ -0,0 +1,290 @@
+/**
+ * @file NmeaGenerator.h
+ * @brief Générateur NMEA synthétique : trajectoire, cadence 1-50 Hz et défauts injectés
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Trajectory : points horodatés (position, vitesse, cap) issus d'un log
+ * enregistré (NMEA RMC / GGA ou trace CSV trk_*.csv) ou d'un parcours
+ * paramétrique (bords cap / vitesse / durée, virages à taux constant),
+ * interpolés à l'instant demandé.
+ *
+ * NmeaGenerator : une salve de phrases par époque (1 à 50 Hz) avec le
+ * talker et le jeu de phrases choisis, et des défauts tirés au hasard
+ * (graine fixe, reproductible) : phrase perdue, somme de contrôle fausse,
+ * ligne tronquée, salve d'octets parasites (débit UART faux).
+ *
+ * Bibliothèque hôte sans dépendance Arduino : utilisée par l'outil
+ * tools/nmea_gen et compilable dans le simulateur.
+ */
+
+#ifndef SIM_NMEA_GENERATOR_H
+#define SIM_NMEA_GENERATOR_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Trajectory point
+ */
+struct TrackPoint {
+    double timeS;              ///< Seconds from the start of the trajectory
+    double latitude;           ///< Degrees
+    double longitude;          ///< Degrees
+    double speedKn;            ///< Speed over ground (knots)
+    double courseDeg;          ///< Course over ground (degrees)
+};
+
+/**
+ * @brief Parametric course leg
+ */
+struct CourseLeg {
+    double courseDeg;
+    double speedKn;
+    double durationS;
+};
+
+/**
+ * @brief Timed trajectory, recorded or parametric, sampled at any time
+ */
+class Trajectory {
+public:
+    Trajectory();
+
+    /**
+     * @brief Load a recorded log
+     * @param path NMEA log (RMC / GGA) or track CSV (timestamp,latitude,longitude,...)
+     * @return false if the file cannot be read or holds fewer than 2 fixes
+     */
+    bool loadLog(const char* path);
+
+    /**
+     * @brief Build a parametric course
+     * @param latitude Start latitude (degrees)
+     * @param longitude Start longitude (degrees)
+     * @param legs Legs sailed in order
+     * @param loops Times the legs are repeated
+     * @param turnRateDps Turn rate between legs (degrees/s)
+     */
+    void buildCourse(double latitude, double longitude, const std::vector<CourseLeg>& legs, unsigned loops,
+                     double turnRateDps);
+
+    /**
+     * @brief Parse a leg list "course:speed:duration,..." (degrees, knots, seconds)
+     */
+    static bool parseLegs(const char* text, std::vector<CourseLeg>& legs);
+
+    /**
+     * @brief Interpolated point (position linear, course along the shortest turn)
+     * @return false after the end of the trajectory
+     */
+    bool sample(double timeS, TrackPoint& point);
+
+    /**
+     * @brief Trajectory length (s)
+     */
+    double getDuration() const;
+
+    /**
+     * @brief Points loaded or built
+     */
+    size_t getPointCount() const;
+
+    /**
+     * @brief UTC time of the start (ms since 1970, from the log or set)
+     */
+    int64_t getStartUtcMs() const;
+    void setStartUtcMs(int64_t utcMs);
+
+private:
+    static const double STEP_S;            ///< Parametric integration step
+    static const double SPEED_RAMP_KNPS;   ///< Parametric speed change rate
+
+    std::vector<TrackPoint> points;
+    size_t cursor;                         ///< Segment of the last sample
+    int64_t startUtcMs;
+
+    bool loadNmea(FILE* file);
+    bool loadCsv(FILE* file);
+
+    /**
+     * @brief Speed and course of each point from the segment to the next one
+     */
+    void deriveMotion();
+};
+
+/**
+ * @brief Sentences of the generated set
+ */
+enum NmeaSentence : uint16_t {
+    NMEA_RMC = 0x01,
+    NMEA_GGA = 0x02,
+    NMEA_VTG = 0x04,
+    NMEA_GLL = 0x08,
+    NMEA_ZDA = 0x10,
+    NMEA_GSA = 0x20,           ///< Once per second, like a receiver
+    NMEA_GSV = 0x40            ///< Once per second, like a receiver
+};
+
+/**
+ * @brief Fault probabilities (% of the sentences)
+ */
+struct NmeaFaults {
+    double dropPct;            ///< Sentence not sent
+    double badChecksumPct;     ///< Checksum off by one
+    double truncatePct;        ///< Line cut, next sentence glued to it
+    double glitchPct;          ///< Burst of garbage bytes before the sentence
+};
+
+/**
+ * @brief NMEA stream generator over a trajectory
+ */
+class NmeaGenerator {
+public:
+    /**
+     * @brief Generator counters
+     */
+    struct Counters {
+        uint32_t epochs;
+        uint32_t sentences;
+        uint32_t dropped;
+        uint32_t badChecksums;
+        uint32_t truncated;
+        uint32_t glitches;
+        uint64_t bytes;
+    };
+
+    explicit NmeaGenerator(Trajectory& trajectory);
+
+    /**
+     * @brief Epoch rate (1-50 Hz)
+     */
+    void setRate(double hz);
+
+    /**
+     * @brief Epoch period (20-1000 ms), from the next epoch on (receiver rate command)
+     */
+    void setPeriodMs(uint32_t periodMs);
+    uint32_t getPeriodMs() const;
+
+    /**
+     * @brief Talker ID (GP, GN, GL, GA, BD...)
+     */
+    void setTalker(const char* talker);
+
+    /**
+     * @brief Sentence set (NmeaSentence flags)
+     */
+    void setSentences(uint16_t mask);
+    uint16_t getSentences() const;
+
+    /**
+     * @brief Parse a sentence list "RMC,GGA,..."
+     */
+    static bool parseSentences(const char* text, uint16_t& mask);
+
+    /**
+     * @brief Reported fix quality
+     */
+    void setFix(uint8_t satellites, double hdop);
+
+    void setFaults(const NmeaFaults& faults);
+    void setSeed(uint32_t seed);
+
+    /**
+     * @brief Next epoch
+     * @param out Bytes of the epoch (sentences with their faults)
+     * @param timeS Epoch time from the start of the trajectory
+     * @return false after the end of the trajectory
+     */
+    bool next(std::string& out, double& timeS);
+
+    /**
+     * @brief Complete sentence: "$" body "*" checksum CR LF
+     */
+    static std::string frame(const std::string& body);
+
+    /**
+     * @brief Trajectory point of the last epoch
+     */
+    const TrackPoint& getLastPoint() const;
+
+    const Counters& getCounters() const;
+
+private:
+    Trajectory& trajectory;
+    TrackPoint lastPoint;
+    uint32_t periodMs;
+    uint64_t nextMs;               ///< Time of the next epoch from the start
+    uint64_t lastMs;
+    char talker[3];
+    uint16_t sentences;
+    uint8_t satellites;
+    double hdop;
+    NmeaFaults faults;
+    uint32_t randomState;
+    Counters counters;
+
+    uint32_t random32();
+    bool chance(double pct);
+
+    /**
+     * @brief Append a sentence body with the drawn faults
+     */
+    void emit(const std::string& body, std::string& out);
+};
+
+/**
+ * @brief Command line options shared by the host tools (trajectory, stream, faults)
+ */
+struct NmeaGenOptions {
+    static const char* USAGE;      ///< Help lines of these options
+
+    const char* logPath = nullptr;
+    double latitude = 43.5;
+    double longitude = 3.9;
+    const char* legs = "45:5:60,135:5:60,225:5:60,315:5:60";
+    unsigned loops = 1;
+    double turnRateDps = 20;
+    int64_t startUtcMs = -1;       ///< -1 = from the log, or the default start
+    double rateHz = 1;
+    const char* talker = "GP";
+    uint16_t sentences = NMEA_RMC | NMEA_GGA;
+    unsigned satellites = 9;
+    double hdop = 0.9;
+    NmeaFaults faults = {};
+    uint32_t seed = 1;
+
+    /**
+     * @brief Parse the option at argv[index] (and its value)
+     * @return 1 = parsed, 0 = not one of these options, -1 = bad value
+     */
+    int parse(int argc, char** argv, int& index);
+
+    /**
+     * @brief Build the trajectory and set up the generator (errors on stderr)
+     */
+    bool apply(Trajectory& trajectory, NmeaGenerator& generator) const;
+};
+
+#endif // SIM_NMEA_GENERATOR_H
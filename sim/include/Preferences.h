@@ -0,0 +1,81 @@
+/**
+ * @file Preferences.h
+ * @brief Simulateur : NVS en mémoire (préremplie par --nvs)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIM_PREFERENCES_H
+#define SIM_PREFERENCES_H
+
+#include <Arduino.h>
+#include <string>
+
+/**
+ * @brief Arduino-ESP32 Preferences on an in-memory store (one per process)
+ */
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putString(const char* key, const char* value);
+    size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+    String getString(const char* key, const String& defaultValue = String());
+    size_t getString(const char* key, char* value, size_t maxLen);
+    size_t putBytes(const char* key, const void* value, size_t len);
+    size_t getBytes(const char* key, void* buffer, size_t maxLen);
+    size_t getBytesLength(const char* key);
+
+    size_t putUChar(const char* key, uint8_t value) { return putBytes(key, &value, sizeof(value)); }
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return getValue(key, defaultValue); }
+    size_t putBool(const char* key, bool value) { return putUChar(key, value ? 1 : 0); }
+    bool getBool(const char* key, bool defaultValue = false) { return getUChar(key, defaultValue ? 1 : 0) != 0; }
+    size_t putUShort(const char* key, uint16_t value) { return putBytes(key, &value, sizeof(value)); }
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0) { return getValue(key, defaultValue); }
+    size_t putInt(const char* key, int32_t value) { return putBytes(key, &value, sizeof(value)); }
+    int32_t getInt(const char* key, int32_t defaultValue = 0) { return getValue(key, defaultValue); }
+    size_t putUInt(const char* key, uint32_t value) { return putBytes(key, &value, sizeof(value)); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return getValue(key, defaultValue); }
+    size_t putFloat(const char* key, float value) { return putBytes(key, &value, sizeof(value)); }
+    float getFloat(const char* key, float defaultValue = NAN) { return getValue(key, defaultValue); }
+
+    /**
+     * @brief Preset a string before setup() ("namespace.key=value")
+     * @return false if the entry is malformed
+     */
+    static bool preset(const char* entry);
+
+private:
+    std::string space;
+    bool opened = false;
+    bool readOnly = true;
+
+    template <typename T>
+    T getValue(const char* key, T defaultValue) {
+        T value;
+        return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : defaultValue;
+    }
+};
+
+#endif // SIM_PREFERENCES_H
@@ -0,0 +1,86 @@
+/**
+ * @file SD.h
+ * @brief Simulateur : carte SD dans un répertoire de l'hôte
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Racine : --sd DIR, ou un répertoire temporaire créé au démarrage
+ * (affiché sur stderr). --no-sd simule l'absence de carte.
+ *
+ * Défauts injectés (SdFaultOptions, --sd-*) : latence des secteurs écrits
+ * et des flush, blocages du ramasse-miettes de la carte, carte pleine,
+ * écritures tronquées, retrait de la carte. Une latence fait avancer
+ * l'horloge virtuelle dans l'appel, comme l'attente SPI bloque loop().
+ */
+
+#ifndef SIM_SD_H
+#define SIM_SD_H
+
+#include <Arduino.h>
+#include "FS.h"
+#include "SPI.h"
+
+typedef enum {
+    CARD_NONE,
+    CARD_MMC,
+    CARD_SD,
+    CARD_SDHC,
+    CARD_UNKNOWN
+} sdcard_type_t;
+
+/**
+ * @brief Arduino-ESP32 SD object
+ */
+class SDFS {
+public:
+    bool begin(uint8_t ssPin = 5, SPIClass& spi = SPI, uint32_t frequency = 4000000,
+               const char* mountpoint = "/sd", uint8_t maxFiles = 5, bool formatIfEmpty = false);
+    void end();
+    sdcard_type_t cardType();
+    uint64_t cardSize();
+    uint64_t totalBytes();
+    uint64_t usedBytes();
+
+    File open(const char* path, const char* mode = FILE_READ, bool create = false);
+    File open(const String& path, const char* mode = FILE_READ, bool create = false) {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rename(const char* from, const char* to);
+    bool mkdir(const char* path);
+    bool rmdir(const char* path);
+
+    /**
+     * @brief Host path of a card path
+     */
+    std::string hostPath(const char* path) const;
+
+private:
+    bool mounted = false;
+    std::string root;
+};
+
+extern SDFS SD;
+
+#endif // SIM_SD_H
@@ -0,0 +1,67 @@
+/**
+ * @file SerialPort.h
+ * @brief Outils hôte : port série ou pseudo-terminal en mode brut
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Partagé par les outils (nmea_gen, virtual_gps) et le simulateur
+ * (récepteur GPS sur un port série, voir SIMULATOR.md).
+ */
+
+#ifndef SIM_SERIAL_PORT_H
+#define SIM_SERIAL_PORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace SerialPort {
+    /**
+     * @brief Open a serial device or pseudo-terminal, raw 8N1
+     * @param path Device
+     * @param baud Speed (ignored by pseudo-terminals)
+     * @param flags open() flags (O_RDWR, O_NONBLOCK...)
+     * @return File descriptor, -1 on error (message on stderr)
+     */
+    int open(const char* path, unsigned long baud, int flags);
+
+    /**
+     * @brief Raw 8N1 mode at this speed
+     * @return false if the speed is not supported or fd is not a terminal
+     */
+    bool configure(int fd, unsigned long baud);
+
+    /**
+     * @brief Write all bytes (retries on EINTR and short writes)
+     */
+    bool writeAll(int fd, const void* data, size_t len);
+
+    /**
+     * @brief Monotonic time (µs)
+     */
+    uint64_t monotonicUs();
+
+    /**
+     * @brief Sleep until a monotonic time (µs)
+     */
+    void sleepUntilUs(uint64_t us);
+}
+
+#endif // SIM_SERIAL_PORT_H
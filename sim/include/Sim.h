@@ -0,0 +1,284 @@
+/**
+ * @file Sim.h
+ * @brief Simulateur Linux : horloge virtuelle, options et résumé d'exécution
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Le firmware complet (setup() / loop() de main.cpp et tous les modules)
+ * tourne comme un processus Linux. millis(), delay() et le light sleep
+ * font avancer une horloge virtuelle sans attendre : une régate de
+ * plusieurs heures est rejouée en quelques secondes, toujours de la même
+ * façon pour les mêmes entrées.
+ *
+ * En temps réel (récepteur GPS sur un port série, radio UDP), l'horloge
+ * suit l'horloge murale : délais et light sleep attendent vraiment, par
+ * tranches de REALTIME_SLICE_US pour recevoir trames et octets.
+ *
+ * Les périphériques simulés (UART du GPS, radio ESP-NOW, carte SD, NVS)
+ * sont décrits dans SIMULATOR.md.
+ *
+ * Échéances : un appel bloquant (écriture SD lente) fait avancer
+ * l'horloge pendant que loop() ne tourne pas ; les trames de position
+ * en retard sur leur cadence et les octets GPS restés trop longtemps
+ * dans le tampon de réception sont comptés (Counters, résumé).
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief SD card faults injected by the SD shim (all off by default)
+ */
+struct SdFaultOptions {
+    uint32_t sectorMinUs = 0;          ///< Latency of a 512-byte sector written to the card (uniform)
+    uint32_t sectorMaxUs = 0;
+    uint32_t flushMinUs = 0;           ///< Latency of a flush, close or file creation (uniform)
+    uint32_t flushMaxUs = 0;
+    uint8_t stallPct = 0;              ///< Garbage collection stall on a card write (%)
+    uint32_t stallMinMs = 0;
+    uint32_t stallMaxMs = 0;
+    uint64_t fullBytes = 0;            ///< ENOSPC once this many bytes are written (0 = never)
+    uint8_t tornPct = 0;               ///< write() calls cut short (%)
+    uint64_t removeUs = 0;             ///< Card pulled out at this virtual time (0 = never)
+    uint64_t insertUs = 0;             ///< Card put back (0 = never)
+
+    bool any() const {
+        return sectorMaxUs > 0 || flushMaxUs > 0 || stallPct > 0 || fullBytes > 0 || tornPct > 0 || removeUs > 0;
+    }
+};
+
+/**
+ * @brief Command line options of the simulator
+ */
+struct SimOptions {
+    std::string nmeaPath;              ///< GPS input (empty = no GPS data)
+    std::string sdPath;                ///< SD card root directory (empty = new temp directory)
+    bool sdEnabled = true;
+    std::string radioOutPath;          ///< Sent frames capture (empty = none)
+    std::string radioInPath;           ///< Frames to receive (empty = none)
+    uint8_t radioLossPct = 0;          ///< Received frames dropped (%)
+    bool radioAirtime = false;         ///< Sends take the airtime of an LR frame, one after the other
+    uint8_t mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+    std::vector<std::string> nvs;      ///< Preset NVS strings, "namespace.key=value"
+    uint32_t seed = 1;
+    uint64_t durationUs = 0;           ///< 0 = end of the NMEA input + LINGER_US
+    bool timestamps = false;           ///< Prefix console lines with the virtual time
+    bool quiet = false;                ///< No console output
+    std::string consoleOutPath;        ///< Raw console bytes to this file (binary output, empty = stdout)
+    bool traceLed = false;             ///< Log LED colour changes
+    bool realtime = false;             ///< Clock locked to the wall clock
+    std::string gpsDevice;             ///< GPS on a serial device or pseudo-terminal (real time)
+    std::string radioUdp;              ///< Radio over UDP multicast, "group:port" (real time)
+    SdFaultOptions sdFaults;
+    uint32_t deadlineSlackMs = 50;     ///< Position frame gap allowed over interval + jitter
+    bool failOnMiss = false;           ///< Exit code 3 if a deadline was missed
+};
+
+/**
+ * @brief Byte source behind a simulated UART (GPS receiver)
+ */
+class UartSource {
+public:
+    virtual ~UartSource() {}
+
+    /**
+     * @brief Arrival time of the next byte (UINT64_MAX = none)
+     */
+    virtual uint64_t nextArrivalUs() const = 0;
+
+    /**
+     * @brief Next byte if it has arrived
+     * @param nowUs Virtual time
+     * @param byte Output
+     * @return false if no byte is due yet
+     */
+    virtual bool poll(uint64_t nowUs, uint8_t& byte) = 0;
+
+    /**
+     * @brief UART baud rate set by the firmware (byte pacing)
+     */
+    virtual void setBaud(unsigned long baud) = 0;
+
+    /**
+     * @brief Bytes written by the firmware (receiver commands)
+     */
+    virtual void write(const uint8_t* data, size_t len) { (void)data; (void)len; }
+
+    /**
+     * @brief Virtual time of the last byte (0 = endless source)
+     */
+    virtual uint64_t endUs() const = 0;
+};
+
+/**
+ * @brief Frame on the simulated radio medium
+ */
+struct SimFrame {
+    uint64_t timeUs;                   ///< Virtual time of the transmission
+    uint8_t channel;                   ///< WiFi channel
+    uint8_t mac[6];                    ///< Sender
+    uint8_t len;
+    uint8_t data[250];
+};
+
+/**
+ * @brief Radio medium behind the ESP-NOW shim
+ */
+class RadioLink {
+public:
+    virtual ~RadioLink() {}
+
+    /**
+     * @brief Frame sent by the firmware
+     */
+    virtual void transmit(const SimFrame& frame) = 0;
+
+    /**
+     * @brief Arrival time of the next received frame (UINT64_MAX = none)
+     */
+    virtual uint64_t nextArrivalUs() const = 0;
+
+    /**
+     * @brief Next received frame if it has arrived
+     * @param nowUs Virtual time
+     * @param frame Output
+     * @return false if no frame is due yet
+     */
+    virtual bool poll(uint64_t nowUs, SimFrame& frame) = 0;
+};
+
+namespace Sim {
+    static const uint64_t LINGER_US = 10000000ULL;   ///< Run kept after the end of the NMEA input
+    static const uint64_t REALTIME_SLICE_US = 1000;  ///< Real time: longest wait between two polls
+
+    /**
+     * @brief Options of this run
+     */
+    SimOptions& options();
+
+    /**
+     * @brief Start the run (options parsed): seed the PRNG, start the wall clock, catch Ctrl-C
+     */
+    void begin();
+
+    /**
+     * @brief Virtual time since boot (µs)
+     */
+    uint64_t nowUs();
+
+    /**
+     * @brief Move the virtual clock forward
+     *
+     * Received radio frames are delivered at their own time on the way;
+     * the run ends (summary, exit) when the end time is reached.
+     */
+    void advanceUs(uint64_t us);
+
+    /**
+     * @brief Virtual time ending the run (0 = endless)
+     */
+    void setEndUs(uint64_t endUs);
+
+    /**
+     * @brief Deterministic pseudo-random number (seed and MAC)
+     */
+    uint32_t random32();
+
+    /**
+     * @brief GPS UART source (nullptr = none)
+     */
+    UartSource* gpsSource();
+    void setGpsSource(UartSource* source);
+
+    /**
+     * @brief Radio medium (nullptr = frames dropped)
+     */
+    RadioLink* radio();
+    void setRadio(RadioLink* link);
+
+    /**
+     * @brief Deliver due frames to the ESP-NOW receive callback (esp_now.cpp)
+     */
+    void deliverRadio(uint64_t nowUs);
+
+    /**
+     * @brief Time of the next send callback (UINT64_MAX = none, esp_now.cpp)
+     */
+    uint64_t nextSendCallbackUs();
+
+    /**
+     * @brief Check the cadence of a sent frame against its deadline (Deadlines.cpp)
+     */
+    void frameSent(const SimFrame& frame);
+
+    /**
+     * @brief Run counters (summary)
+     */
+    struct Counters {
+        uint32_t framesSent;
+        uint32_t framesReceived;
+        uint32_t framesLost;
+        uint32_t framesOffChannel;
+        uint32_t uartBytes;
+        uint32_t uartOverruns;         ///< Bytes lost in a full UART RX buffer
+        uint64_t sleepUs;
+
+        uint32_t broadcasts;           ///< Position frames sent
+        uint32_t broadcastsLate;       ///< Gaps over interval + jitter + slack
+        uint32_t broadcastWorstGapMs;  ///< Largest gap over its deadline
+        uint32_t broadcastWorstDeadlineMs;
+        uint32_t uartLateReads;        ///< Stalls leaving a GPS byte longer than the RX buffer fill time
+        uint32_t uartWorstWaitMs;      ///< Longest wait of a GPS byte in the RX buffer
+        uint32_t uartOverrunBursts;    ///< Runs of lost bytes
+
+        uint32_t sdSectors;            ///< Sectors written to the card
+        uint32_t sdFlushes;
+        uint32_t sdStalls;
+        uint32_t sdWorstStallMs;
+        uint32_t sdFullWrites;         ///< write() refused or cut by ENOSPC
+        uint32_t sdTornWrites;
+        uint32_t sdFailedCalls;        ///< Calls on a removed card
+        uint64_t sdBusyUs;             ///< Virtual time spent in SD calls
+    };
+    Counters& counters();
+
+    /**
+     * @brief At least one deadline missed (broadcast gap, GPS byte wait or overrun)
+     */
+    bool deadlineMissed();
+
+    /**
+     * @brief Diagnostic line on stderr, prefixed with the virtual time
+     */
+    void log(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+    /**
+     * @brief Print the summary and exit (code 3 with failOnMiss and a missed deadline)
+     */
+    void finish(int code);
+}
+
+#endif // SIM_H
@@ -0,0 +1,95 @@
+/**
+ * @file TimerWheel.h
+ * @brief Outils hôte : roue de temporisation (échéancier à seaux)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Une case par tic (1 ms par défaut) sur un tour de SLOTS cases ; une
+ * échéance plus lointaine qu'un tour attend dans sa case les tours
+ * suivants (elle garde son tic absolu). Planifier et déclencher coûtent
+ * O(1) quel que soit le nombre d'échéances en attente : des milliers de
+ * trames par seconde restent tenables (tools/log_replay).
+ *
+ * Une échéance déjà passée est placée au tic courant : elle part au
+ * prochain advance(), sans être perdue.
+ */
+
+#ifndef SIM_TIMER_WHEEL_H
+#define SIM_TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/**
+ * @brief Hashed timer wheel, one bucket per tick
+ */
+class TimerWheel {
+public:
+    static const uint32_t SLOTS = 4096;        ///< Buckets per turn (4.1 s at 1 ms)
+
+    /**
+     * @brief Fired event
+     */
+    struct Event {
+        uint64_t dueUs;                        ///< Exact due time
+        uint32_t id;                           ///< Caller identifier
+    };
+
+    /**
+     * @param tickUs Tick length (µs)
+     */
+    explicit TimerWheel(uint32_t tickUs = 1000);
+
+    /**
+     * @brief Schedule an event (a time before the current tick fires at the next advance())
+     */
+    void schedule(uint32_t id, uint64_t dueUs);
+
+    /**
+     * @brief Fire the events of the current tick, then move to the next one
+     * @param fired Events of the tick, sorted by due time (cleared first)
+     */
+    void advance(std::vector<Event>& fired);
+
+    /**
+     * @brief Start of the current tick (µs)
+     */
+    uint64_t currentTickUs() const;
+
+    /**
+     * @brief Events waiting
+     */
+    size_t size() const;
+
+private:
+    struct Entry {
+        uint64_t tick;
+        Event event;
+    };
+
+    uint32_t tickUs;
+    uint64_t tick;
+    size_t pending;
+    std::vector<std::vector<Entry>> slots;
+};
+
+#endif // SIM_TIMER_WHEEL_H
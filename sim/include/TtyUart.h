@@ -0,0 +1,81 @@
+/**
+ * @file TtyUart.h
+ * @brief Simulateur : UART du GPS sur un port série ou un pseudo-terminal
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Temps réel : le firmware lit les octets d'un récepteur virtuel
+ * (tools/virtual_gps) ou d'un vrai récepteur branché par un adaptateur
+ * USB-série, et ses commandes (UBX, $PCAS) lui sont envoyées. Le débit
+ * réglé par le firmware est appliqué au port (sans effet sur un
+ * pseudo-terminal).
+ */
+
+#ifndef SIM_TTY_UART_H
+#define SIM_TTY_UART_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Sim.h"
+
+/**
+ * @brief UART source reading a serial device in real time
+ */
+class TtyUart : public UartSource {
+public:
+    TtyUart();
+    ~TtyUart();
+
+    /**
+     * @brief Open the device (non-blocking, raw)
+     * @return false on error (message on stderr)
+     */
+    bool open(const char* path);
+
+    void setBaud(unsigned long baud) override;
+
+    /**
+     * @brief Now (0) if bytes are waiting, UINT64_MAX otherwise
+     */
+    uint64_t nextArrivalUs() const override;
+    bool poll(uint64_t nowUs, uint8_t& byte) override;
+    void write(const uint8_t* data, size_t len) override;
+
+    /**
+     * @brief Endless source
+     */
+    uint64_t endUs() const override;
+
+private:
+    static const size_t BUFFER_SIZE = 256;
+
+    int fd;
+    mutable uint8_t buffer[BUFFER_SIZE];
+    mutable size_t head;
+    mutable size_t count;
+
+    /**
+     * @brief Read the waiting bytes (non-blocking)
+     */
+    void fill() const;
+};
+
+#endif // SIM_TTY_UART_H
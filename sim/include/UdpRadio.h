@@ -0,0 +1,93 @@
+/**
+ * @file UdpRadio.h
+ * @brief Simulateur : radio ESP-NOW sur UDP multicast
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Temps réel : chaque trame émise part dans un datagramme vers un groupe
+ * multicast, reçu par les autres instances du simulateur (flotte sur une
+ * ou plusieurs machines) et par tools/virtual_gps (mesure de latence).
+ *
+ * Datagramme : "BG", canal, MAC de l'émetteur (6 octets), données de la
+ * trame ESP-NOW. Les trames de l'instance elle-même (boucle multicast)
+ * sont écartées par Sim::deliverRadio(), comme en fichier.
+ */
+
+#ifndef SIM_UDP_RADIO_H
+#define SIM_UDP_RADIO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <netinet/in.h>
+#include "Sim.h"
+
+/**
+ * @brief Radio medium over UDP multicast
+ */
+class UdpRadio : public RadioLink {
+public:
+    static const size_t HEADER_SIZE = 9;       ///< "BG", channel, MAC
+    static const size_t MAX_DATAGRAM = HEADER_SIZE + 250;
+
+    UdpRadio();
+    ~UdpRadio();
+
+    /**
+     * @brief Join a multicast group
+     * @param address "group:port", e.g. 239.255.0.42:5042
+     * @return false on error (message on stderr)
+     */
+    bool open(const char* address);
+
+    void transmit(const SimFrame& frame) override;
+
+    /**
+     * @brief Unknown in advance (UINT64_MAX): polled in real time
+     */
+    uint64_t nextArrivalUs() const override;
+
+    /**
+     * @brief Next waiting datagram, stamped nowUs
+     */
+    bool poll(uint64_t nowUs, SimFrame& frame) override;
+
+    /**
+     * @brief Datagram of a frame
+     * @return Datagram length
+     */
+    static size_t encode(const SimFrame& frame, uint8_t* out);
+
+    /**
+     * @brief Frame of a datagram
+     */
+    static bool decode(const uint8_t* data, size_t len, SimFrame& frame);
+
+    /**
+     * @brief Socket (poll() of the tools), -1 if not open
+     */
+    int getFd() const;
+
+private:
+    int fd;
+    struct sockaddr_in group;
+};
+
+#endif // SIM_UDP_RADIO_H
@@ -0,0 +1,135 @@
+/**
+ * @file WString.h
+ * @brief Simulateur : classe String de l'Arduino sur std::string
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIM_WSTRING_H
+#define SIM_WSTRING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class __FlashStringHelper;
+#define F(string_literal) (string_literal)
+
+/**
+ * @brief Arduino String (subset used by the firmware and its libraries)
+ */
+class String {
+public:
+    String(const char* cstr = "");
+    explicit String(const std::string& str);
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = DEC);
+    explicit String(int value, unsigned char base = DEC);
+    explicit String(unsigned int value, unsigned char base = DEC);
+    explicit String(long value, unsigned char base = DEC);
+    explicit String(unsigned long value, unsigned char base = DEC);
+    explicit String(long long value, unsigned char base = DEC);
+    explicit String(unsigned long long value, unsigned char base = DEC);
+    explicit String(float value, unsigned int decimalPlaces = 2);
+    explicit String(double value, unsigned int decimalPlaces = 2);
+
+    String& operator=(const char* cstr);
+
+    unsigned int length() const { return (unsigned int)buffer.size(); }
+    bool isEmpty() const { return buffer.empty(); }
+    const char* c_str() const { return buffer.c_str(); }
+    bool reserve(unsigned int size);
+
+    bool concat(const String& str);
+    bool concat(const char* cstr);
+    bool concat(const char* cstr, unsigned int length);
+    bool concat(char c);
+    bool concat(unsigned char value);
+    bool concat(int value);
+    bool concat(unsigned int value);
+    bool concat(long value);
+    bool concat(unsigned long value);
+    bool concat(float value);
+    bool concat(double value);
+
+    template <typename T>
+    String& operator+=(const T& value) {
+        concat(value);
+        return *this;
+    }
+
+    friend String operator+(const String& lhs, const String& rhs);
+    friend String operator+(const String& lhs, const char* rhs);
+    friend String operator+(const char* lhs, const String& rhs);
+    friend String operator+(const String& lhs, char rhs);
+    friend String operator+(const String& lhs, int rhs);
+    friend String operator+(const String& lhs, unsigned int rhs);
+    friend String operator+(const String& lhs, long rhs);
+    friend String operator+(const String& lhs, unsigned long rhs);
+    friend String operator+(const String& lhs, float rhs);
+    friend String operator+(const String& lhs, double rhs);
+
+    bool equals(const String& other) const { return buffer == other.buffer; }
+    bool equals(const char* cstr) const { return buffer == (cstr ? cstr : ""); }
+    bool equalsIgnoreCase(const String& other) const;
+    bool operator==(const String& other) const { return equals(other); }
+    bool operator==(const char* cstr) const { return equals(cstr); }
+    bool operator!=(const String& other) const { return !equals(other); }
+    bool operator!=(const char* cstr) const { return !equals(cstr); }
+    bool operator<(const String& other) const { return buffer < other.buffer; }
+    bool operator>(const String& other) const { return buffer > other.buffer; }
+    int compareTo(const String& other) const { return buffer.compare(other.buffer); }
+    bool startsWith(const String& prefix) const;
+    bool endsWith(const String& suffix) const;
+
+    char charAt(unsigned int index) const { return index < buffer.size() ? buffer[index] : 0; }
+    void setCharAt(unsigned int index, char c);
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return buffer[index]; }
+
+    int indexOf(char c, unsigned int fromIndex = 0) const;
+    int indexOf(const String& str, unsigned int fromIndex = 0) const;
+    int lastIndexOf(char c) const;
+    int lastIndexOf(const String& str) const;
+    String substring(unsigned int beginIndex) const;
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    void replace(char find, char replacement);
+    void replace(const String& find, const String& replacement);
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+
+private:
+    std::string buffer;
+};
+
+#endif // SIM_WSTRING_H
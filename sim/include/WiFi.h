@@ -0,0 +1,48 @@
+/**
+ * @file WiFi.h
+ * @brief Simulateur : objet WiFi (mode station, adresse MAC)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+#include <Arduino.h>
+#include "esp_wifi.h"
+
+#define WIFI_OFF 0
+#define WIFI_STA 1
+#define WIFI_AP 2
+
+/**
+ * @brief Arduino-ESP32 WiFi object (MAC from --mac)
+ */
+class WiFiClass {
+public:
+    bool mode(int mode) { (void)mode; return true; }
+    bool disconnect(bool wifiOff = false) { (void)wifiOff; return true; }
+    uint8_t* macAddress(uint8_t* mac);
+    String macAddress();
+};
+
+extern WiFiClass WiFi;
+
+#endif // SIM_WIFI_H
@@ -0,0 +1,74 @@
+/**
+ * @file esp_now.h
+ * @brief Simulateur : ESP-NOW sur le support radio de Sim.h
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * esp_now_send() remet la trame au RadioLink ; le rappel d'envoi est
+ * appelé au prochain pas de l'horloge virtuelle, comme depuis la tâche
+ * WiFi. Les trames reçues sur le canal courant sont remises au rappel de
+ * réception à leur heure d'arrivée.
+ */
+
+#ifndef SIM_ESP_NOW_H
+#define SIM_ESP_NOW_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#define ESP_NOW_ETH_ALEN 6
+#define ESP_NOW_KEY_LEN 16
+#define ESP_NOW_MAX_DATA_LEN 250
+
+typedef enum {
+    ESP_NOW_SEND_SUCCESS = 0,
+    ESP_NOW_SEND_FAIL
+} esp_now_send_status_t;
+
+typedef enum {
+    WIFI_IF_STA = 0,
+    WIFI_IF_AP
+} wifi_interface_t;
+
+typedef struct {
+    uint8_t peer_addr[ESP_NOW_ETH_ALEN];
+    uint8_t lmk[ESP_NOW_KEY_LEN];
+    uint8_t channel;
+    wifi_interface_t ifidx;
+    bool encrypt;
+    void* priv;
+} esp_now_peer_info_t;
+
+typedef void (*esp_now_send_cb_t)(const uint8_t* mac, esp_now_send_status_t status);
+typedef void (*esp_now_recv_cb_t)(const uint8_t* mac, const uint8_t* data, int len);
+
+esp_err_t esp_now_init();
+esp_err_t esp_now_deinit();
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t cb);
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb);
+esp_err_t esp_now_unregister_recv_cb();
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer);
+esp_err_t esp_now_del_peer(const uint8_t* peerAddr);
+bool esp_now_is_peer_exist(const uint8_t* peerAddr);
+esp_err_t esp_now_send(const uint8_t* peerAddr, const uint8_t* data, size_t len);
+
+#endif // SIM_ESP_NOW_H
@@ -0,0 +1,43 @@
+/**
+ * @file esp_pm.h
+ * @brief Simulateur : gestion d'énergie ESP-IDF (DFS indisponible)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIM_ESP_PM_H
+#define SIM_ESP_PM_H
+
+#include "esp_err.h"
+
+typedef struct {
+    int max_freq_mhz;
+    int min_freq_mhz;
+    bool light_sleep_enable;
+} esp_pm_config_esp32_t;
+
+typedef esp_pm_config_esp32_t esp_pm_config_esp32s3_t;
+
+/**
+ * @brief Always ESP_ERR_NOT_SUPPORTED (SDK without CONFIG_PM_ENABLE): fixed frequency
+ */
+esp_err_t esp_pm_configure(const void* config);
+
+#endif // SIM_ESP_PM_H
@@ -0,0 +1,110 @@
+/**
+ * @file esp_wifi.h
+ * @brief Simulateur : réglages radio ESP-IDF (canal, protocole, puissance)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Le mode promiscuité remet au rappel une trame d'action 802.11
+ * reconstruite avant chaque trame ESP-NOW reçue (même ordre que la tâche
+ * WiFi) : en-tête, élément fournisseur Espressif, trame. Le simulateur
+ * n'a pas de modèle de propagation : RSSI fixe (SIM_RSSI_DBM).
+ */
+
+#ifndef SIM_ESP_WIFI_H
+#define SIM_ESP_WIFI_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_now.h"
+
+#define WIFI_PROTOCOL_11B 1
+#define WIFI_PROTOCOL_11G 2
+#define WIFI_PROTOCOL_11N 4
+#define WIFI_PROTOCOL_LR 8
+
+typedef enum {
+    WIFI_SECOND_CHAN_NONE = 0,
+    WIFI_SECOND_CHAN_ABOVE,
+    WIFI_SECOND_CHAN_BELOW
+} wifi_second_chan_t;
+
+typedef enum {
+    WIFI_PS_NONE,
+    WIFI_PS_MIN_MODEM,
+    WIFI_PS_MAX_MODEM
+} wifi_ps_type_t;
+
+/**
+ * @brief Promiscuous packet type
+ */
+typedef enum {
+    WIFI_PKT_MGMT,
+    WIFI_PKT_CTRL,
+    WIFI_PKT_DATA,
+    WIFI_PKT_MISC
+} wifi_promiscuous_pkt_type_t;
+
+#define WIFI_PROMIS_FILTER_MASK_MGMT (1 << 0)
+
+typedef struct {
+    uint32_t filter_mask;
+} wifi_promiscuous_filter_t;
+
+/**
+ * @brief Receive metadata (subset of the ESP-IDF bit fields)
+ */
+typedef struct {
+    signed rssi : 8;
+    unsigned rate : 5;
+    unsigned : 19;
+    unsigned channel : 4;
+    unsigned sig_len : 12;
+    unsigned : 16;
+} wifi_pkt_rx_ctrl_t;
+
+/**
+ * @brief Sniffed packet: 802.11 header and body, FCS included in sig_len
+ */
+typedef struct {
+    wifi_pkt_rx_ctrl_t rx_ctrl;
+    uint8_t payload[0];
+} wifi_promiscuous_pkt_t;
+
+typedef void (*wifi_promiscuous_cb_t)(void* buf, wifi_promiscuous_pkt_type_t type);
+
+esp_err_t esp_wifi_set_protocol(wifi_interface_t ifx, uint8_t protocolBitmap);
+esp_err_t esp_wifi_get_protocol(wifi_interface_t ifx, uint8_t* protocolBitmap);
+esp_err_t esp_wifi_set_max_tx_power(int8_t power);
+esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t second);
+esp_err_t esp_wifi_get_channel(uint8_t* primary, wifi_second_chan_t* second);
+esp_err_t esp_wifi_set_ps(wifi_ps_type_t type);
+esp_err_t esp_wifi_set_promiscuous(bool enable);
+esp_err_t esp_wifi_set_promiscuous_filter(const wifi_promiscuous_filter_t* filter);
+esp_err_t esp_wifi_set_promiscuous_rx_cb(wifi_promiscuous_cb_t cb);
+
+static const int8_t SIM_RSSI_DBM = -50;  ///< RSSI of every sniffed frame
+
+/**
+ * @brief Current channel (simulator: frames on other channels are not received)
+ */
+uint8_t simWifiChannel();
+
+#endif // SIM_ESP_WIFI_H
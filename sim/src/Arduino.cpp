@@ -0,0 +1,292 @@
+/**
+ * @file Arduino.cpp
+ * @brief Simulateur : temps, aléa, GPIO, sommeil et périphériques sans effet
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * delay() et le light sleep avancent l'horloge virtuelle ; le reste
+ * (GPIO, fréquence CPU, M5, SPI) garde seulement l'état demandé.
+ */
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include <M5Unified.h>
+#include <FastLED.h>
+#include <SPI.h>
+#include <deque>
+#include <vector>
+#include "Sim.h"
+
+EspClass ESP;
+SPIClass SPI;
+m5::M5Unified M5;
+CFastLED FastLED;
+
+static uint32_t cpuFrequencyMhz = 240;
+static uint64_t sleepTimerUs = 0;
+static bool gpioWakeupSource = false;
+static bool gpioWakeupPin = false;
+static esp_sleep_wakeup_cause_t wakeupCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+// ============================================================================
+// Time
+// ============================================================================
+
+uint32_t millis() {
+    return (uint32_t)(Sim::nowUs() / 1000);
+}
+
+uint32_t micros() {
+    return (uint32_t)Sim::nowUs();
+}
+
+void delay(uint32_t ms) {
+    Sim::advanceUs((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+    Sim::advanceUs(us);
+}
+
+void yield() {
+}
+
+int64_t esp_timer_get_time() {
+    return (int64_t)Sim::nowUs();
+}
+
+// ============================================================================
+// Random
+// ============================================================================
+
+long random(long howBig) {
+    if (howBig <= 0) {
+        return 0;
+    }
+    return (long)(Sim::random32() % (uint32_t)howBig);
+}
+
+long random(long howSmall, long howBig) {
+    if (howSmall >= howBig) {
+        return howSmall;
+    }
+    return howSmall + random(howBig - howSmall);
+}
+
+void randomSeed(unsigned long seed) {
+    (void)seed;  // Deterministic run: --seed only
+}
+
+uint32_t esp_random() {
+    return Sim::random32();
+}
+
+// ============================================================================
+// GPIO, CPU
+// ============================================================================
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+void digitalWrite(uint8_t pin, uint8_t value) { (void)pin; (void)value; }
+int digitalRead(uint8_t pin) { (void)pin; return HIGH; }
+int analogRead(uint8_t pin) { (void)pin; return 0; }
+int digitalPinToInterrupt(uint8_t pin) { return pin; }
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) { (void)pin; (void)handler; (void)mode; }
+void detachInterrupt(uint8_t pin) { (void)pin; }
+
+bool setCpuFrequencyMhz(uint32_t mhz) {
+    cpuFrequencyMhz = mhz;
+    return true;
+}
+
+uint32_t getCpuFrequencyMhz() {
+    return cpuFrequencyMhz;
+}
+
+uint32_t getXtalFrequencyMhz() {
+    return 40;
+}
+
+uint32_t getApbFrequency() {
+    return 80000000;
+}
+
+uint32_t EspClass::getCycleCount() {
+    return (uint32_t)(Sim::nowUs() * 240);
+}
+
+uint32_t EspClass::getCpuFreqMHz() {
+    return cpuFrequencyMhz;
+}
+
+void EspClass::restart() {
+    Sim::log("ESP.restart()");
+    Sim::finish(2);
+}
+
+// ============================================================================
+// Power management, light sleep
+// ============================================================================
+
+esp_err_t esp_pm_configure(const void* config) {
+    (void)config;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t gpio_wakeup_enable(gpio_num_t pin, gpio_int_type_t type) {
+    (void)pin;
+    (void)type;
+    gpioWakeupPin = true;
+    return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_disable(gpio_num_t pin) {
+    (void)pin;
+    gpioWakeupPin = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs) {
+    sleepTimerUs = timeUs;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_gpio_wakeup() {
+    gpioWakeupSource = true;
+    return ESP_OK;
+}
+
+/**
+ * @brief Light sleep : jusqu'au réveil timer, ou jusqu'au prochain octet du GPS
+ *
+ * @details
+ * En temps réel, l'arrivée des octets n'est pas connue d'avance : la
+ * source est interrogée à chaque tranche d'attente.
+ */
+esp_err_t esp_light_sleep_start() {
+    uint64_t now = Sim::nowUs();
+    uint64_t wake = now + sleepTimerUs;
+    wakeupCause = ESP_SLEEP_WAKEUP_TIMER;
+    UartSource* source = Sim::gpsSource();
+    if (Sim::options().realtime) {
+        while (Sim::nowUs() < wake) {
+            if (gpioWakeupSource && gpioWakeupPin && source != nullptr && source->nextArrivalUs() <= Sim::nowUs()) {
+                wakeupCause = ESP_SLEEP_WAKEUP_GPIO;
+                break;
+            }
+            Sim::advanceUs(std::min(Sim::REALTIME_SLICE_US, wake - Sim::nowUs()));
+        }
+        Sim::counters().sleepUs += Sim::nowUs() - now;
+        return ESP_OK;
+    }
+    if (gpioWakeupSource && gpioWakeupPin && source != nullptr) {
+        uint64_t next = source->nextArrivalUs();
+        if (next < wake) {
+            wake = (next > now) ? next : now;
+            wakeupCause = ESP_SLEEP_WAKEUP_GPIO;
+        }
+    }
+    Sim::counters().sleepUs += wake - now;
+    Sim::advanceUs(wake - now);
+    return ESP_OK;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() {
+    return wakeupCause;
+}
+
+// ============================================================================
+// FreeRTOS queues (single thread: never blocks)
+// ============================================================================
+
+struct SimQueue {
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    std::deque<std::vector<uint8_t>> items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    SimQueue* queue = new SimQueue();
+    queue->length = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    (void)ticksToWait;
+    if (queue->items.size() >= queue->length) {
+        return pdFALSE;
+    }
+    const uint8_t* bytes = (const uint8_t*)item;
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    return pdTRUE;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken != nullptr) {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+    return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticksToWait) {
+    (void)ticksToWait;
+    if (queue->items.empty()) {
+        return pdFALSE;
+    }
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    return (UBaseType_t)queue->items.size();
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    delete queue;
+}
+
+// ============================================================================
+// LED
+// ============================================================================
+
+void CFastLED::show() {
+    if (leds == nullptr || ledCount == 0) {
+        return;
+    }
+    if (Sim::options().traceLed && (!hasShown || leds[0] != shown)) {
+        Sim::log("LED #%02X%02X%02X", leds[0].r, leds[0].g, leds[0].b);
+    }
+    shown = leds[0];
+    hasShown = true;
+}
+
+void CFastLED::clear(bool writeData) {
+    for (int i = 0; i < ledCount; i++) {
+        leds[i] = CRGB();
+    }
+    if (writeData) {
+        show();
+    }
+}
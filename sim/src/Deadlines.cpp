@@ -0,0 +1,74 @@
+/**
+ * @file Deadlines.cpp
+ * @brief Simulateur : échéance de la cadence de diffusion
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Chaque trame de position porte la cadence courante (rateDeciHz). Entre
+ * deux trames, le firmware attend l'intervalle plus une gigue d'au plus un
+ * quart d'intervalle (scheduleNextBroadcast()) : au-delà, plus la marge
+ * deadlineSlackMs, la trame est en retard. Sur un changement de cadence,
+ * l'intervalle le plus long des deux trames fait foi.
+ *
+ * Un trou pendant une perte de fix (pas de diffusion sans position
+ * valide) compte aussi comme retard : les tests d'échéance se font sur
+ * une entrée GPS continue.
+ */
+
+#include "Sim.h"
+#include <string.h>
+#include "Communication.h"
+
+static uint64_t lastBroadcastUs = 0;
+static uint32_t lastIntervalMs = 0;
+
+/**
+ * @brief Vérifie l'écart depuis la trame de position précédente
+ */
+void Sim::frameSent(const SimFrame& frame) {
+    if (frame.len != sizeof(GPSBroadcastPacket) || (int8_t)frame.data[0] != MSG_BOAT) {
+        return;
+    }
+    GPSBroadcastPacket packet;
+    memcpy(&packet, frame.data, sizeof(packet));
+    if (packet.ttl == 0) {
+        return;  // Relayed copy
+    }
+    Counters& run = counters();
+    run.broadcasts++;
+
+    uint32_t intervalMs = (packet.rateDeciHz > 0) ? 10000 / packet.rateDeciHz : 0;
+    if (lastBroadcastUs != 0 && intervalMs > 0 && lastIntervalMs > 0) {
+        uint32_t slowest = (intervalMs > lastIntervalMs) ? intervalMs : lastIntervalMs;
+        uint32_t deadlineMs = slowest + slowest / 4 + options().deadlineSlackMs;
+        uint32_t gapMs = (uint32_t)((frame.timeUs - lastBroadcastUs) / 1000);
+        if (gapMs > deadlineMs) {
+            run.broadcastsLate++;
+            if (gapMs - deadlineMs > run.broadcastWorstGapMs - run.broadcastWorstDeadlineMs) {  // Largest overshoot
+                run.broadcastWorstGapMs = gapMs;
+                run.broadcastWorstDeadlineMs = deadlineMs;
+            }
+            log("deadline: position frame %u ms after the previous one (deadline %u ms)", gapMs, deadlineMs);
+        }
+    }
+    lastBroadcastUs = frame.timeUs;
+    lastIntervalMs = intervalMs;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file FileRadio.cpp
+ * @brief Simulateur : implémentation du support radio sur fichiers
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "FileRadio.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+FileRadio::FileRadio() : capture(nullptr), next(0) {}
+
+FileRadio::~FileRadio() {
+    if (capture != nullptr && capture != stdout) {
+        fclose(capture);
+    }
+}
+
+bool FileRadio::openCapture(const char* path) {
+    capture = (strcmp(path, "-") == 0) ? stdout : fopen(path, "w");
+    return capture != nullptr;
+}
+
+bool FileRadio::loadInput(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+    char line[640];
+    unsigned lineNumber = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        lineNumber++;
+        size_t len = strcspn(line, "\r\n");
+        line[len] = 0;
+        if (len == 0 || line[0] == '#') {
+            continue;
+        }
+        SimFrame frame;
+        if (!parseFrame(line, frame)) {
+            fprintf(stderr, "%s:%u: malformed frame\n", path, lineNumber);
+            ok = false;
+            break;
+        }
+        input.push_back(frame);
+    }
+    fclose(file);
+    std::stable_sort(input.begin(), input.end(),
+                     [](const SimFrame& a, const SimFrame& b) { return a.timeUs < b.timeUs; });
+    next = 0;
+    return ok;
+}
+
+void FileRadio::transmit(const SimFrame& frame) {
+    if (capture == nullptr) {
+        return;
+    }
+    char line[640];
+    formatFrame(frame, line, sizeof(line));
+    fputs(line, capture);
+    fputc('\n', capture);
+}
+
+uint64_t FileRadio::nextArrivalUs() const {
+    return next < input.size() ? input[next].timeUs : UINT64_MAX;
+}
+
+bool FileRadio::poll(uint64_t nowUs, SimFrame& frame) {
+    if (next >= input.size() || input[next].timeUs > nowUs) {
+        return false;
+    }
+    frame = input[next++];
+    return true;
+}
+
+void FileRadio::formatFrame(const SimFrame& frame, char* out, size_t size) {
+    int pos = snprintf(out, size, "%llu.%03u %u %02x:%02x:%02x:%02x:%02x:%02x ",
+                       (unsigned long long)(frame.timeUs / 1000), (unsigned)(frame.timeUs % 1000), frame.channel,
+                       frame.mac[0], frame.mac[1], frame.mac[2], frame.mac[3], frame.mac[4], frame.mac[5]);
+    for (uint8_t i = 0; i < frame.len && pos + 3 < (int)size; i++) {
+        pos += snprintf(out + pos, size - pos, "%02x", frame.data[i]);
+    }
+}
+
+bool FileRadio::parseFrame(const char* line, SimFrame& frame) {
+    char* end;
+    double ms = strtod(line, &end);
+    if (end == line || ms < 0) {
+        return false;
+    }
+    frame.timeUs = (uint64_t)(ms * 1000.0 + 0.5);
+    unsigned channel;
+    unsigned mac[6];
+    int consumed = 0;
+    if (sscanf(end, " %u %x:%x:%x:%x:%x:%x %n", &channel, &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5],
+               &consumed) < 7 || consumed == 0) {
+        return false;
+    }
+    frame.channel = (uint8_t)channel;
+    for (int i = 0; i < 6; i++) {
+        frame.mac[i] = (uint8_t)mac[i];
+    }
+    const char* hex = end + consumed;
+    size_t digits = strlen(hex);
+    if (digits == 0 || digits % 2 != 0 || digits / 2 > sizeof(frame.data)) {
+        return false;
+    }
+    frame.len = (uint8_t)(digits / 2);
+    for (uint8_t i = 0; i < frame.len; i++) {
+        char byte[3] = {hex[2 * i], hex[2 * i + 1], 0};
+        char* stop;
+        frame.data[i] = (uint8_t)strtoul(byte, &stop, 16);
+        if (*stop != 0) {
+            return false;
+        }
+    }
+    return true;
+}
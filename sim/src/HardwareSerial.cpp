@@ -0,0 +1,206 @@
+/**
+ * @file HardwareSerial.cpp
+ * @brief Simulateur : UART de la console et du GPS
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Console : sortie standard, \r\n ramené à \n, préfixe d'heure virtuelle
+ * en début de ligne avec --timestamps. GPS : les octets de la source
+ * arrivés à l'heure virtuelle courante passent dans le tampon de
+ * réception, au-delà de sa capacité ils sont perdus et comptés.
+ *
+ * Échéance de lecture : un octet ne doit pas attendre dans le tampon plus
+ * que le temps de le remplir au débit de la ligne (256 octets à 9600
+ * bauds : 267 ms). Au-delà, le même arrêt de loop() sur un flux continu
+ * l'aurait débordé : l'attente est comptée comme lecture en retard.
+ */
+
+#include "HardwareSerial.h"
+#include "Sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+HardwareSerial Serial(true);
+HardwareSerial Serial1(false);
+HardwareSerial Serial2(false);
+
+HardwareSerial::HardwareSerial(bool console)
+    : console(console), baud(115200), rxCapacity(DEFAULT_RX_BUFFER), rxBuffer(nullptr), rxArrivalUs(nullptr),
+      beganUs(0), rxHead(0), rxCount(0), overrunning(false), late(false), lineStart(true),
+      txCapacity(DEFAULT_TX_BUFFER), txBusyUntilUs(0), output(nullptr) {
+}
+
+void HardwareSerial::begin(unsigned long baudRate, uint32_t config, int8_t rxPin, int8_t txPin) {
+    (void)config;
+    (void)rxPin;
+    (void)txPin;
+    updateBaudRate(baudRate);
+    if (rxBuffer == nullptr) {
+        rxBuffer = (uint8_t*)malloc(rxCapacity);
+        rxArrivalUs = (uint64_t*)malloc(rxCapacity * sizeof(uint64_t));
+        beganUs = Sim::nowUs();
+    }
+}
+
+void HardwareSerial::updateBaudRate(unsigned long baudRate) {
+    baud = baudRate;
+    if (!console && this == &Serial2 && Sim::gpsSource() != nullptr) {
+        Sim::gpsSource()->setBaud(baud);
+    }
+}
+
+size_t HardwareSerial::setRxBufferSize(size_t size) {
+    if (rxBuffer != nullptr) {
+        return 0;  // Arduino-ESP32: only before begin()
+    }
+    rxCapacity = size;
+    return size;
+}
+
+/**
+ * @brief Octets arrivés depuis la dernière lecture (UART du GPS seulement)
+ */
+void HardwareSerial::receive() {
+    UartSource* source = Sim::gpsSource();
+    if (console || this != &Serial2 || source == nullptr || rxBuffer == nullptr) {
+        return;
+    }
+    uint64_t now = Sim::nowUs();
+    uint8_t byte;
+    for (;;) {
+        uint64_t arrival = source->nextArrivalUs();
+        if (!source->poll(now, byte)) {
+            break;
+        }
+        Sim::counters().uartBytes++;
+        if (arrival == 0 || arrival > now) {
+            arrival = now;  // Device bytes: waiting, time unknown
+        }
+        if (rxCount < rxCapacity) {
+            size_t slot = (rxHead + rxCount) % rxCapacity;
+            rxBuffer[slot] = byte;
+            rxArrivalUs[slot] = (arrival < beganUs) ? beganUs : arrival;
+            rxCount++;
+            overrunning = false;
+        } else {
+            Sim::counters().uartOverruns++;
+            if (!overrunning && arrival >= beganUs) {  // Not the backlog sent before begin()
+                Sim::counters().uartOverrunBursts++;
+                Sim::log("deadline: GPS RX buffer overrun (%zu bytes)", rxCapacity);
+            }
+            overrunning = true;
+        }
+    }
+}
+
+int HardwareSerial::available() {
+    receive();
+    return (int)rxCount;
+}
+
+int HardwareSerial::read() {
+    receive();
+    if (rxCount == 0) {
+        return -1;
+    }
+    uint8_t byte = rxBuffer[rxHead];
+    uint64_t waitUs = Sim::nowUs() - rxArrivalUs[rxHead];
+    uint64_t fillUs = (uint64_t)rxCapacity * 10000000ULL / baud;
+    Sim::Counters& counters = Sim::counters();
+    if (waitUs / 1000 > counters.uartWorstWaitMs) {
+        counters.uartWorstWaitMs = (uint32_t)(waitUs / 1000);
+    }
+    if (waitUs > fillUs && !late) {
+        counters.uartLateReads++;
+        Sim::log("deadline: GPS byte read after %u ms (RX buffer fill time %u ms)", (unsigned)(waitUs / 1000),
+                 (unsigned)(fillUs / 1000));
+    }
+    late = (waitUs > fillUs);
+    rxHead = (rxHead + 1) % rxCapacity;
+    rxCount--;
+    return byte;
+}
+
+int HardwareSerial::peek() {
+    receive();
+    return rxCount > 0 ? rxBuffer[rxHead] : -1;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::setTxBufferSize(size_t size) {
+    txCapacity = size > DEFAULT_TX_BUFFER ? size : DEFAULT_TX_BUFFER;
+    return txCapacity;
+}
+
+bool HardwareSerial::openOutput(const char* path) {
+    output = fopen(path, "wb");
+    return output != nullptr;
+}
+
+int HardwareSerial::availableForWrite() {
+    uint64_t now = Sim::nowUs();
+    if (txBusyUntilUs <= now) {
+        return (int)txCapacity;
+    }
+    uint64_t queued = ((txBusyUntilUs - now) * baud / 10 + 999999) / 1000000;
+    return queued >= txCapacity ? 0 : (int)(txCapacity - queued);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (!console) {
+        if (this == &Serial2 && Sim::gpsSource() != nullptr) {
+            Sim::gpsSource()->write(buffer, size);
+        }
+        return size;
+    }
+    uint64_t now = Sim::nowUs();
+    txBusyUntilUs = (txBusyUntilUs > now ? txBusyUntilUs : now) + (uint64_t)size * 10000000ULL / baud;
+    if (output != nullptr) {
+        fwrite(buffer, 1, size, output);
+        return size;
+    }
+    if (Sim::options().quiet) {
+        return size;
+    }
+    for (size_t i = 0; i < size; i++) {
+        uint8_t c = buffer[i];
+        if (c == '\r') {
+            continue;
+        }
+        if (lineStart && Sim::options().timestamps) {
+            uint64_t ms = Sim::nowUs() / 1000;
+            ::printf("[%02u:%02u:%02u.%03u] ", (unsigned)(ms / 3600000), (unsigned)(ms / 60000 % 60),
+                   (unsigned)(ms / 1000 % 60), (unsigned)(ms % 1000));
+        }
+        putchar(c);
+        lineStart = (c == '\n');
+    }
+    return size;
+}
+
+void HardwareSerial::flush() {
+    if (console) {
+        fflush(output != nullptr ? output : stdout);
+    }
+}
@@ -0,0 +1,165 @@
+/**
+ * @file NmeaFile.cpp
+ * @brief Simulateur : implémentation du GPS rejoué depuis un fichier NMEA
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Horodatage : l'heure UTC de chaque époque, ramenée à la première ; un
+ * passage de minuit ajoute 24 h, un recul d'heure (fichier concaténé) est
+ * ramené à l'époque précédente.
+ */
+
+#include "NmeaFile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+NmeaFile::NmeaFile() : baud(9600), current(0), offset(0), sentenceStartUs(0) {}
+
+bool NmeaFile::load(const char* path, uint64_t startUs) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+
+    char* line = nullptr;
+    size_t capacity = 0;
+    ssize_t read;
+    int64_t firstMs = -1;
+    int64_t lastMs = 0;
+    int64_t dayOffsetMs = 0;
+    int32_t previousTime = -1;
+    while ((read = getline(&line, &capacity, file)) >= 0) {
+        std::string text(line, (size_t)read);
+        while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) {
+            text.pop_back();
+        }
+        if (text.empty()) {
+            continue;
+        }
+        Sentence sentence;
+        sentence.text = text + "\r\n";  // Faulty lines too (generator, see NMEA_GENERATOR.md)
+
+        int32_t timeMs = sentenceTimeMs(sentence.text);
+        if (timeMs >= 0) {
+            if (previousTime >= 0 && timeMs < previousTime - 43200000) {
+                dayOffsetMs += 86400000;  // Midnight
+            }
+            previousTime = timeMs;
+            int64_t absoluteMs = timeMs + dayOffsetMs;
+            if (firstMs < 0) {
+                firstMs = absoluteMs;
+            }
+            lastMs = std::max(lastMs, absoluteMs - firstMs);  // Never back in time
+        }
+        sentence.releaseUs = startUs + (uint64_t)lastMs * 1000;  // Untimed: with the previous epoch
+        sentences.push_back(sentence);
+    }
+    free(line);
+    fclose(file);
+
+    current = 0;
+    offset = 0;
+    if (!sentences.empty()) {
+        startSentence(startUs);
+    }
+    return firstMs >= 0;
+}
+
+size_t NmeaFile::getSentenceCount() const {
+    return sentences.size();
+}
+
+void NmeaFile::setBaud(unsigned long newBaud) {
+    if (newBaud > 0) {
+        baud = newBaud;
+    }
+}
+
+/**
+ * @brief Heure UTC du champ 1 (RMC, GGA, GNS, ZDA) ou 5 (GLL), en ms du jour
+ */
+int32_t NmeaFile::sentenceTimeMs(const std::string& text) {
+    size_t start = text.find('$');  // After garbage bytes
+    if (start == std::string::npos || text.size() < start + 7) {
+        return -1;
+    }
+    std::string line = text.substr(start);
+    std::string type = line.substr(3, 3);
+    int field;
+    if (type == "RMC" || type == "GGA" || type == "GNS" || type == "ZDA") {
+        field = 1;
+    } else if (type == "GLL") {
+        field = 5;
+    } else {
+        return -1;
+    }
+    size_t pos = 0;
+    for (int i = 0; i < field; i++) {
+        pos = line.find(',', pos);
+        if (pos == std::string::npos) {
+            return -1;
+        }
+        pos++;
+    }
+    const char* value = line.c_str() + pos;
+    if (strlen(value) < 6 || value[0] < '0' || value[0] > '9') {
+        return -1;
+    }
+    int hours = (value[0] - '0') * 10 + (value[1] - '0');
+    int minutes = (value[2] - '0') * 10 + (value[3] - '0');
+    double seconds = atof(value + 4);
+    return (int32_t)((hours * 3600 + minutes * 60) * 1000 + (int32_t)(seconds * 1000 + 0.5));
+}
+
+void NmeaFile::startSentence(uint64_t lineFreeUs) {
+    const Sentence& sentence = sentences[current];
+    sentenceStartUs = std::max(sentence.releaseUs, lineFreeUs);
+    offset = 0;
+}
+
+uint64_t NmeaFile::nextArrivalUs() const {
+    if (current >= sentences.size()) {
+        return UINT64_MAX;
+    }
+    return sentenceStartUs + (uint64_t)(offset + 1) * 10000000ULL / baud;
+}
+
+bool NmeaFile::poll(uint64_t nowUs, uint8_t& byte) {
+    if (current >= sentences.size() || nextArrivalUs() > nowUs) {
+        return false;
+    }
+    byte = (uint8_t)sentences[current].text[offset];
+    offset++;
+    if (offset >= sentences[current].text.size()) {
+        uint64_t lineFreeUs = sentenceStartUs + (uint64_t)offset * 10000000ULL / baud;
+        current++;
+        if (current < sentences.size()) {
+            startSentence(lineFreeUs);
+        }
+    }
+    return true;
+}
+
+uint64_t NmeaFile::endUs() const {
+    return sentences.empty() ? 0 : sentences.back().releaseUs + 1000000ULL;
+}
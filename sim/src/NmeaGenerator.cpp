@@ -0,0 +1,721 @@
+/**
+ * @file NmeaGenerator.cpp
+ * @brief Implémentation du générateur NMEA synthétique
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Calculs en double sur l'hôte : repère plan local autour de chaque
+ * point (111 319,5 m par degré de latitude), largement suffisant entre
+ * deux points d'une trajectoire. Les positions sont écrites au 1e-5 de
+ * minute (1,8 cm), comme le NEO-6M.
+ */
+
+#include "NmeaGenerator.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <algorithm>
+
+static const double METRES_PER_DEGREE = 111319.5;
+static const double MPS_PER_KNOT = 0.514444;
+static const int64_t DEFAULT_START_UTC_MS = 1748779200000LL;  // 2025-06-01 12:00:00 UTC
+
+const double Trajectory::STEP_S = 0.1;
+const double Trajectory::SPEED_RAMP_KNPS = 1.0;
+
+/**
+ * @brief Écart de cap ramené dans [-180, 180[
+ */
+static double courseDifference(double from, double to) {
+    double diff = fmod(to - from + 540.0, 360.0) - 180.0;
+    return diff;
+}
+
+static double normaliseCourse(double course) {
+    course = fmod(course, 360.0);
+    return (course < 0) ? course + 360.0 : course;
+}
+
+// ============================================================================
+// Trajectory
+// ============================================================================
+
+Trajectory::Trajectory() : cursor(0), startUtcMs(DEFAULT_START_UTC_MS) {}
+
+/**
+ * @brief Charge un log enregistré
+ *
+ * @details
+ * Format reconnu à la première ligne utile : phrase NMEA ('$') ou trace
+ * CSV (en-tête "timestamp,latitude,longitude,..."). Vitesse et cap : ceux
+ * des RMC (Doppler) ; calculés entre points successifs pour un log GGA
+ * seul ou une trace CSV simplifiée (points espacés, segments droits).
+ */
+bool Trajectory::loadLog(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+    int first = fgetc(file);
+    while (first == '\r' || first == '\n' || first == ' ') {
+        first = fgetc(file);
+    }
+    ungetc(first, file);
+
+    points.clear();
+    bool loaded = (first == '$') ? loadNmea(file) : loadCsv(file);
+    fclose(file);
+    cursor = 0;
+    return loaded && points.size() >= 2;
+}
+
+/**
+ * @brief Coordonnée NMEA (ddmm.mmmm + hémisphère) en degrés
+ */
+static double parseCoordinate(const char* value, const char* hemisphere) {
+    double raw = atof(value);
+    int degrees = (int)(raw / 100);
+    double result = degrees + (raw - degrees * 100) / 60.0;
+    return (hemisphere[0] == 'S' || hemisphere[0] == 'W') ? -result : result;
+}
+
+/**
+ * @brief Découpe une phrase valide (somme de contrôle vérifiée) en champs
+ */
+static bool splitSentence(const char* line, std::vector<std::string>& fields) {
+    const char* start = strchr(line, '$');
+    if (start == nullptr) {
+        return false;
+    }
+    const char* star = strchr(start, '*');
+    if (star == nullptr) {
+        return false;
+    }
+    uint8_t checksum = 0;
+    for (const char* c = start + 1; c < star; c++) {
+        checksum ^= (uint8_t)*c;
+    }
+    if (strtoul(star + 1, nullptr, 16) != checksum) {
+        return false;
+    }
+    fields.clear();
+    std::string field;
+    for (const char* c = start + 1; c < star; c++) {
+        if (*c == ',') {
+            fields.push_back(field);
+            field.clear();
+        } else {
+            field += *c;
+        }
+    }
+    fields.push_back(field);
+    return fields[0].size() == 5;
+}
+
+/**
+ * @brief Heure hhmmss.ss en ms du jour
+ */
+static int64_t parseTimeOfDay(const std::string& text) {
+    if (text.size() < 6) {
+        return -1;
+    }
+    int hours = atoi(text.substr(0, 2).c_str());
+    int minutes = atoi(text.substr(2, 2).c_str());
+    double seconds = atof(text.c_str() + 4);
+    return (int64_t)(hours * 3600 + minutes * 60) * 1000 + llround(seconds * 1000);
+}
+
+bool Trajectory::loadNmea(FILE* file) {
+    std::vector<std::pair<int64_t, TrackPoint>> rmc;
+    std::vector<std::pair<int64_t, TrackPoint>> gga;
+    int64_t dayUtcMs = DEFAULT_START_UTC_MS - DEFAULT_START_UTC_MS % 86400000;
+    int64_t previousGgaMs = -1;
+    int64_t ggaDayOffsetMs = 0;
+
+    char line[512];
+    std::vector<std::string> fields;
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        if (!splitSentence(line, fields)) {
+            continue;
+        }
+        std::string type = fields[0].substr(2);
+        TrackPoint point = {};
+        if (type == "RMC" && fields.size() >= 10 && fields[2] == "A" && fields[9].size() == 6) {
+            struct tm date = {};
+            date.tm_mday = atoi(fields[9].substr(0, 2).c_str());
+            date.tm_mon = atoi(fields[9].substr(2, 2).c_str()) - 1;
+            date.tm_year = 100 + atoi(fields[9].substr(4, 2).c_str());
+            dayUtcMs = (int64_t)timegm(&date) * 1000;
+            int64_t timeMs = parseTimeOfDay(fields[1]);
+            if (timeMs < 0) {
+                continue;
+            }
+            point.latitude = parseCoordinate(fields[3].c_str(), fields[4].c_str());
+            point.longitude = parseCoordinate(fields[5].c_str(), fields[6].c_str());
+            point.speedKn = atof(fields[7].c_str());
+            point.courseDeg = atof(fields[8].c_str());
+            rmc.push_back(std::make_pair(dayUtcMs + timeMs, point));
+        } else if (type == "GGA" && fields.size() >= 7 && atoi(fields[6].c_str()) > 0) {
+            int64_t timeMs = parseTimeOfDay(fields[1]);
+            if (timeMs < 0) {
+                continue;
+            }
+            if (previousGgaMs >= 0 && timeMs < previousGgaMs - 43200000) {
+                ggaDayOffsetMs += 86400000;  // Midnight
+            }
+            previousGgaMs = timeMs;
+            point.latitude = parseCoordinate(fields[2].c_str(), fields[3].c_str());
+            point.longitude = parseCoordinate(fields[4].c_str(), fields[5].c_str());
+            gga.push_back(std::make_pair(dayUtcMs + ggaDayOffsetMs + timeMs, point));
+        }
+    }
+
+    const std::vector<std::pair<int64_t, TrackPoint>>& fixes = rmc.empty() ? gga : rmc;
+    for (const std::pair<int64_t, TrackPoint>& fix : fixes) {
+        if (points.empty()) {
+            startUtcMs = fix.first;
+        }
+        TrackPoint point = fix.second;
+        point.timeS = (fix.first - startUtcMs) / 1000.0;
+        if (!points.empty() && point.timeS <= points.back().timeS) {
+            continue;  // Repeated epoch
+        }
+        points.push_back(point);
+    }
+    if (rmc.empty()) {
+        deriveMotion();
+    }
+    return true;
+}
+
+bool Trajectory::loadCsv(FILE* file) {
+    char line[256];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        double timestamp;
+        TrackPoint point = {};
+        if (sscanf(line, "%lf,%lf,%lf", &timestamp, &point.latitude, &point.longitude) != 3) {
+            continue;  // Header
+        }
+        if (points.empty()) {
+            startUtcMs = llround(timestamp * 1000);
+        }
+        point.timeS = timestamp - startUtcMs / 1000.0;
+        if (!points.empty() && point.timeS <= points.back().timeS) {
+            continue;
+        }
+        points.push_back(point);
+    }
+    deriveMotion();
+    return true;
+}
+
+/**
+ * @brief Vitesse et cap de chaque point vers le suivant
+ *
+ * @details
+ * Sur place (moins de 5 cm), le cap précédent est conservé.
+ */
+void Trajectory::deriveMotion() {
+    double course = 0;
+    for (size_t i = 0; i + 1 < points.size(); i++) {
+        const TrackPoint& a = points[i];
+        const TrackPoint& b = points[i + 1];
+        double north = (b.latitude - a.latitude) * METRES_PER_DEGREE;
+        double east = (b.longitude - a.longitude) * METRES_PER_DEGREE * cos(a.latitude * M_PI / 180.0);
+        double distance = sqrt(north * north + east * east);
+        if (distance >= 0.05) {
+            course = normaliseCourse(atan2(east, north) * 180.0 / M_PI);
+        }
+        points[i].speedKn = distance / (b.timeS - a.timeS) / MPS_PER_KNOT;
+        points[i].courseDeg = course;
+    }
+    if (points.size() >= 2) {
+        points.back().speedKn = points[points.size() - 2].speedKn;
+        points.back().courseDeg = course;
+    }
+}
+
+/**
+ * @brief Construit un parcours paramétrique
+ *
+ * @details
+ * Intégration par pas de STEP_S : le cap tourne vers celui du bord au
+ * plus de turnRateDps, la vitesse varie d'au plus SPEED_RAMP_KNPS par
+ * seconde (accélération plausible pour FixFilter).
+ */
+void Trajectory::buildCourse(double latitude, double longitude, const std::vector<CourseLeg>& legs, unsigned loops,
+                             double turnRateDps) {
+    points.clear();
+    cursor = 0;
+    if (legs.empty()) {
+        return;
+    }
+
+    TrackPoint point = {0, latitude, longitude, legs[0].speedKn, normaliseCourse(legs[0].courseDeg)};
+    points.push_back(point);
+    for (unsigned loop = 0; loop < loops; loop++) {
+        for (const CourseLeg& leg : legs) {
+            double endS = point.timeS + leg.durationS;
+            while (point.timeS < endS - 1e-9) {
+                double dt = std::min(STEP_S, endS - point.timeS);
+                double turn = courseDifference(point.courseDeg, leg.courseDeg);
+                double maxTurn = turnRateDps * dt;
+                point.courseDeg = normaliseCourse(point.courseDeg + std::max(-maxTurn, std::min(maxTurn, turn)));
+                double accel = leg.speedKn - point.speedKn;
+                double maxAccel = SPEED_RAMP_KNPS * dt;
+                point.speedKn += std::max(-maxAccel, std::min(maxAccel, accel));
+
+                double distance = point.speedKn * MPS_PER_KNOT * dt;
+                double radians = point.courseDeg * M_PI / 180.0;
+                point.latitude += distance * cos(radians) / METRES_PER_DEGREE;
+                point.longitude += distance * sin(radians) / (METRES_PER_DEGREE * cos(point.latitude * M_PI / 180.0));
+                point.timeS += dt;
+                points.push_back(point);
+            }
+        }
+    }
+}
+
+bool Trajectory::parseLegs(const char* text, std::vector<CourseLeg>& legs) {
+    legs.clear();
+    const char* position = text;
+    while (*position != 0) {
+        CourseLeg leg;
+        int consumed = 0;
+        if (sscanf(position, "%lf:%lf:%lf%n", &leg.courseDeg, &leg.speedKn, &leg.durationS, &consumed) != 3 ||
+            leg.speedKn < 0 || leg.durationS <= 0) {
+            return false;
+        }
+        legs.push_back(leg);
+        position += consumed;
+        if (*position == ',') {
+            position++;
+        } else if (*position != 0) {
+            return false;
+        }
+    }
+    return !legs.empty();
+}
+
+/**
+ * @brief Point interpolé à l'instant demandé
+ *
+ * @details
+ * Les instants sont demandés dans l'ordre : le segment courant est gardé
+ * d'un appel à l'autre (recherche depuis le début seulement en arrière).
+ */
+bool Trajectory::sample(double timeS, TrackPoint& point) {
+    if (points.size() < 2 || timeS > points.back().timeS || timeS < 0) {
+        return false;
+    }
+    if (cursor >= points.size() - 1 || points[cursor].timeS > timeS) {
+        cursor = 0;
+    }
+    while (cursor + 2 < points.size() && points[cursor + 1].timeS <= timeS) {
+        cursor++;
+    }
+
+    const TrackPoint& a = points[cursor];
+    const TrackPoint& b = points[cursor + 1];
+    double f = (timeS - a.timeS) / (b.timeS - a.timeS);
+    point.timeS = timeS;
+    point.latitude = a.latitude + (b.latitude - a.latitude) * f;
+    point.longitude = a.longitude + (b.longitude - a.longitude) * f;
+    point.speedKn = a.speedKn + (b.speedKn - a.speedKn) * f;
+    point.courseDeg = normaliseCourse(a.courseDeg + courseDifference(a.courseDeg, b.courseDeg) * f);
+    return true;
+}
+
+double Trajectory::getDuration() const {
+    return points.empty() ? 0 : points.back().timeS;
+}
+
+size_t Trajectory::getPointCount() const {
+    return points.size();
+}
+
+int64_t Trajectory::getStartUtcMs() const {
+    return startUtcMs;
+}
+
+void Trajectory::setStartUtcMs(int64_t utcMs) {
+    startUtcMs = utcMs;
+}
+
+// ============================================================================
+// NmeaGenerator
+// ============================================================================
+
+NmeaGenerator::NmeaGenerator(Trajectory& trajectory)
+    : trajectory(trajectory), lastPoint(), periodMs(1000), nextMs(0), lastMs(0), sentences(NMEA_RMC | NMEA_GGA),
+      satellites(9), hdop(0.9), faults(), randomState(1), counters() {
+    strcpy(talker, "GP");
+}
+
+void NmeaGenerator::setRate(double hz) {
+    setPeriodMs((uint32_t)lround(1000.0 / std::max(1.0, std::min(50.0, hz))));
+}
+
+void NmeaGenerator::setPeriodMs(uint32_t ms) {
+    periodMs = std::max<uint32_t>(20, std::min<uint32_t>(1000, ms));
+}
+
+uint32_t NmeaGenerator::getPeriodMs() const {
+    return periodMs;
+}
+
+void NmeaGenerator::setTalker(const char* id) {
+    strncpy(talker, id, 2);
+    talker[2] = 0;
+}
+
+void NmeaGenerator::setSentences(uint16_t mask) {
+    sentences = mask;
+}
+
+uint16_t NmeaGenerator::getSentences() const {
+    return sentences;
+}
+
+bool NmeaGenerator::parseSentences(const char* text, uint16_t& mask) {
+    static const struct { const char* name; uint16_t flag; } NAMES[] = {
+        {"RMC", NMEA_RMC}, {"GGA", NMEA_GGA}, {"VTG", NMEA_VTG}, {"GLL", NMEA_GLL},
+        {"ZDA", NMEA_ZDA}, {"GSA", NMEA_GSA}, {"GSV", NMEA_GSV}
+    };
+    mask = 0;
+    std::string list(text);
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        std::string name = list.substr(start, end - start);
+        bool known = false;
+        for (const auto& entry : NAMES) {
+            if (strcasecmp(name.c_str(), entry.name) == 0) {
+                mask |= entry.flag;
+                known = true;
+            }
+        }
+        if (!known) {
+            return false;
+        }
+        start = end + 1;
+    }
+    return mask != 0;
+}
+
+void NmeaGenerator::setFix(uint8_t satelliteCount, double fixHdop) {
+    satellites = std::min<uint8_t>(satelliteCount, 12);
+    hdop = fixHdop;
+}
+
+void NmeaGenerator::setFaults(const NmeaFaults& newFaults) {
+    faults = newFaults;
+}
+
+void NmeaGenerator::setSeed(uint32_t seed) {
+    randomState = (seed == 0) ? 1 : seed;
+}
+
+const TrackPoint& NmeaGenerator::getLastPoint() const {
+    return lastPoint;
+}
+
+const NmeaGenerator::Counters& NmeaGenerator::getCounters() const {
+    return counters;
+}
+
+uint32_t NmeaGenerator::random32() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+bool NmeaGenerator::chance(double pct) {
+    return pct > 0 && random32() % 100000 < (uint32_t)(pct * 1000);
+}
+
+std::string NmeaGenerator::frame(const std::string& body) {
+    uint8_t checksum = 0;
+    for (char c : body) {
+        checksum ^= (uint8_t)c;
+    }
+    char tail[8];
+    snprintf(tail, sizeof(tail), "*%02X\r\n", checksum);
+    return "$" + body + tail;
+}
+
+/**
+ * @brief Ajoute une phrase avec les défauts tirés
+ *
+ * @details
+ * Octets parasites : ni '$' ni fin de ligne, la structure des lignes
+ * reste intacte (un fichier généré reste lisible ligne à ligne). Ligne
+ * tronquée : coupée avant la somme de contrôle, sans CR LF, la phrase
+ * suivante commence dans la même ligne comme après une coupure réelle.
+ */
+void NmeaGenerator::emit(const std::string& body, std::string& out) {
+    if (chance(faults.dropPct)) {
+        counters.dropped++;
+        return;
+    }
+    std::string text = frame(body);
+    if (chance(faults.badChecksumPct)) {
+        size_t star = text.size() - 5;
+        uint8_t checksum = (uint8_t)strtoul(text.c_str() + star + 1, nullptr, 16) + 1;
+        char hex[3];
+        snprintf(hex, sizeof(hex), "%02X", checksum);
+        text.replace(star + 1, 2, hex);
+        counters.badChecksums++;
+    }
+    if (chance(faults.truncatePct)) {
+        text.resize(1 + random32() % (text.size() - 5));
+        counters.truncated++;
+    }
+    if (chance(faults.glitchPct)) {
+        std::string burst;
+        size_t length = 3 + random32() % 10;
+        while (burst.size() < length) {
+            char c = (char)(random32() & 0xFF);
+            if (c != '$' && c != '\r' && c != '\n') {
+                burst += c;
+            }
+        }
+        text = burst + text;
+        counters.glitches++;
+    }
+    counters.sentences++;
+    counters.bytes += text.size();
+    out += text;
+}
+
+/**
+ * @brief Coordonnée NMEA au 1e-5 de minute
+ */
+static std::string formatCoordinate(double degrees, bool latitude) {
+    int64_t units = llround(fabs(degrees) * 60.0 * 100000.0);
+    int64_t whole = units / 6000000;
+    int64_t minutes = units % 6000000;
+    char text[24];
+    snprintf(text, sizeof(text), latitude ? "%02lld%02lld.%05lld,%c" : "%03lld%02lld.%05lld,%c",
+             (long long)whole, (long long)(minutes / 100000), (long long)(minutes % 100000),
+             latitude ? (degrees < 0 ? 'S' : 'N') : (degrees < 0 ? 'W' : 'E'));
+    return text;
+}
+
+/**
+ * @brief Époque suivante
+ *
+ * @details
+ * Ordre d'une salve u-blox : RMC, VTG, GGA, GSA, GSV, GLL, ZDA. GSA et
+ * GSV seulement à la première époque de chaque seconde, comme un
+ * récepteur réglé à plus de 1 Hz. Période entière en ms, comme le
+ * measRate du récepteur : elle peut changer en cours de flux.
+ */
+bool NmeaGenerator::next(std::string& out, double& timeS) {
+    out.clear();
+    timeS = nextMs / 1000.0;
+    TrackPoint point;
+    if (!trajectory.sample(timeS, point)) {
+        return false;
+    }
+    lastPoint = point;
+    bool firstOfSecond = (counters.epochs == 0) || (nextMs / 1000 != lastMs / 1000);
+    lastMs = nextMs;
+    nextMs += periodMs;
+    counters.epochs++;
+
+    int64_t utcMs = trajectory.getStartUtcMs() + (int64_t)lastMs;
+    utcMs -= utcMs % 10;
+    time_t seconds = (time_t)(utcMs / 1000);
+    struct tm utc;
+    gmtime_r(&seconds, &utc);
+    char timeText[16];
+    snprintf(timeText, sizeof(timeText), "%02d%02d%02d.%02d", utc.tm_hour, utc.tm_min, utc.tm_sec,
+             (int)(utcMs % 1000) / 10);
+    std::string latitude = formatCoordinate(point.latitude, true);
+    std::string longitude = formatCoordinate(point.longitude, false);
+    char body[160];
+
+    if (sentences & NMEA_RMC) {
+        snprintf(body, sizeof(body), "%sRMC,%s,A,%s,%s,%.3f,%.2f,%02d%02d%02d,,,A", talker, timeText,
+                 latitude.c_str(), longitude.c_str(), point.speedKn, point.courseDeg,
+                 utc.tm_mday, utc.tm_mon + 1, utc.tm_year % 100);
+        emit(body, out);
+    }
+    if (sentences & NMEA_VTG) {
+        snprintf(body, sizeof(body), "%sVTG,%.2f,T,,M,%.3f,N,%.3f,K,A", talker, point.courseDeg, point.speedKn,
+                 point.speedKn * 1.852);
+        emit(body, out);
+    }
+    if (sentences & NMEA_GGA) {
+        snprintf(body, sizeof(body), "%sGGA,%s,%s,%s,1,%02u,%.2f,2.0,M,48.0,M,,", talker, timeText,
+                 latitude.c_str(), longitude.c_str(), satellites, hdop);
+        emit(body, out);
+    }
+    if ((sentences & NMEA_GSA) && firstOfSecond) {
+        std::string prns;
+        for (uint8_t i = 0; i < 12; i++) {
+            char prn[4] = "";
+            if (i < satellites) {
+                snprintf(prn, sizeof(prn), "%02u", 2 * i + 1);
+            }
+            prns += std::string(prn) + ",";
+        }
+        snprintf(body, sizeof(body), "%sGSA,A,3,%s%.2f,%.2f,%.2f", talker, prns.c_str(), hdop * 1.6, hdop,
+                 hdop * 1.3);
+        emit(body, out);
+    }
+    if ((sentences & NMEA_GSV) && firstOfSecond) {
+        uint8_t messages = (uint8_t)std::max(1, (satellites + 3) / 4);
+        for (uint8_t message = 0; message < messages; message++) {
+            std::string text = talker + std::string("GSV,");
+            char header[24];
+            snprintf(header, sizeof(header), "%u,%u,%02u", messages, message + 1, satellites);
+            text += header;
+            for (uint8_t i = message * 4; i < std::min<uint8_t>(satellites, message * 4 + 4); i++) {
+                unsigned prn = 2 * i + 1;
+                char sat[24];
+                snprintf(sat, sizeof(sat), ",%02u,%02u,%03u,%02u", prn, 10 + prn * 37 % 80, prn * 71 % 360,
+                         30 + prn % 15);
+                text += sat;
+            }
+            emit(text, out);
+        }
+    }
+    if (sentences & NMEA_GLL) {
+        snprintf(body, sizeof(body), "%sGLL,%s,%s,%s,A,A", talker, latitude.c_str(), longitude.c_str(), timeText);
+        emit(body, out);
+    }
+    if (sentences & NMEA_ZDA) {
+        snprintf(body, sizeof(body), "%sZDA,%s,%02d,%02d,%04d,00,00", talker, timeText, utc.tm_mday,
+                 utc.tm_mon + 1, utc.tm_year + 1900);
+        emit(body, out);
+    }
+    return true;
+}
+
+// ============================================================================
+// NmeaGenOptions
+// ============================================================================
+
+const char* NmeaGenOptions::USAGE =
+    "Trajectory:\n"
+    "  --log FILE           Recorded NMEA log (RMC / GGA) or track CSV (trk_*.csv)\n"
+    "  --origin LAT,LON     Parametric course start (default 43.5,3.9)\n"
+    "  --legs C:S:T,...     Parametric legs: course (deg), speed (kn), duration (s)\n"
+    "                       (default 45:5:60,135:5:60,225:5:60,315:5:60)\n"
+    "  --loops N            Repeat the legs (default 1)\n"
+    "  --turn-rate DPS      Turn rate between legs (default 20)\n"
+    "  --start UTC          Start time, YYYY-MM-DDTHH:MM:SS (default: log time, or 2025-06-01T12:00:00)\n"
+    "Stream:\n"
+    "  --rate HZ            Epochs per second, 1-50 (default 1)\n"
+    "  --talker ID          GP, GN, GL, GA, BD... (default GP)\n"
+    "  --sentences LIST     RMC,GGA,VTG,GLL,ZDA,GSA,GSV (default RMC,GGA)\n"
+    "  --satellites N       Reported satellites (default 9)\n"
+    "  --hdop X             Reported HDOP (default 0.9)\n"
+    "Faults (% of the sentences):\n"
+    "  --drop PCT           Sentence not sent\n"
+    "  --bad-checksum PCT   Wrong checksum\n"
+    "  --truncate PCT       Line cut, next sentence glued to it\n"
+    "  --glitch PCT         Garbage bytes before the sentence (wrong baud rate)\n"
+    "  --seed N             Random seed (default 1)\n";
+
+int NmeaGenOptions::parse(int argc, char** argv, int& index) {
+    const char* arg = argv[index];
+    if (index + 1 >= argc) {
+        return 0;
+    }
+    const char* value = argv[index + 1];
+    if (strcmp(arg, "--log") == 0) {
+        logPath = value;
+    } else if (strcmp(arg, "--origin") == 0) {
+        if (sscanf(value, "%lf,%lf", &latitude, &longitude) != 2) return -1;
+    } else if (strcmp(arg, "--legs") == 0) {
+        legs = value;
+    } else if (strcmp(arg, "--loops") == 0) {
+        loops = (unsigned)atoi(value);
+    } else if (strcmp(arg, "--turn-rate") == 0) {
+        turnRateDps = atof(value);
+    } else if (strcmp(arg, "--start") == 0) {
+        struct tm utc = {};
+        if (strptime(value, "%Y-%m-%dT%H:%M:%S", &utc) == nullptr) return -1;
+        startUtcMs = (int64_t)timegm(&utc) * 1000;
+    } else if (strcmp(arg, "--rate") == 0) {
+        rateHz = atof(value);
+        if (rateHz < 1 || rateHz > 50) return -1;
+    } else if (strcmp(arg, "--talker") == 0) {
+        talker = value;
+        if (strlen(talker) != 2) return -1;
+    } else if (strcmp(arg, "--sentences") == 0) {
+        if (!NmeaGenerator::parseSentences(value, sentences)) return -1;
+    } else if (strcmp(arg, "--satellites") == 0) {
+        satellites = (unsigned)atoi(value);
+    } else if (strcmp(arg, "--hdop") == 0) {
+        hdop = atof(value);
+    } else if (strcmp(arg, "--drop") == 0) {
+        faults.dropPct = atof(value);
+    } else if (strcmp(arg, "--bad-checksum") == 0) {
+        faults.badChecksumPct = atof(value);
+    } else if (strcmp(arg, "--truncate") == 0) {
+        faults.truncatePct = atof(value);
+    } else if (strcmp(arg, "--glitch") == 0) {
+        faults.glitchPct = atof(value);
+    } else if (strcmp(arg, "--seed") == 0) {
+        seed = (uint32_t)strtoul(value, nullptr, 0);
+    } else {
+        return 0;
+    }
+    index++;
+    return 1;
+}
+
+bool NmeaGenOptions::apply(Trajectory& trajectory, NmeaGenerator& generator) const {
+    if (logPath != nullptr) {
+        if (!trajectory.loadLog(logPath)) {
+            fprintf(stderr, "Cannot read a trajectory from %s\n", logPath);
+            return false;
+        }
+    } else {
+        std::vector<CourseLeg> courseLegs;
+        if (!Trajectory::parseLegs(legs, courseLegs)) {
+            fprintf(stderr, "Bad leg list: %s\n", legs);
+            return false;
+        }
+        trajectory.buildCourse(latitude, longitude, courseLegs, loops, turnRateDps);
+    }
+    if (startUtcMs >= 0) {
+        trajectory.setStartUtcMs(startUtcMs);
+    }
+
+    generator.setRate(rateHz);
+    generator.setTalker(talker);
+    generator.setSentences(sentences);
+    generator.setFix((uint8_t)std::min(satellites, 12u), hdop);
+    generator.setFaults(faults);
+    generator.setSeed(seed);
+    return true;
+}
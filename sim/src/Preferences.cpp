@@ -0,0 +1,136 @@
+/**
+ * @file Preferences.cpp
+ * @brief Simulateur : NVS en mémoire
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Valeurs stockées en octets bruts par espace de noms, comme la NVS de
+ * l'ESP32 ; une instance du simulateur démarre avec une NVS vide, sauf
+ * les chaînes données par --nvs.
+ */
+
+#include <Preferences.h>
+#include <map>
+#include <vector>
+
+typedef std::map<std::string, std::vector<uint8_t>> Namespace;
+static std::map<std::string, Namespace> store;
+
+bool Preferences::begin(const char* name, bool readOnlyMode, const char* partitionLabel) {
+    (void)partitionLabel;
+    if (name == nullptr || strlen(name) > 15) {
+        return false;
+    }
+    space = name;
+    readOnly = readOnlyMode;
+    opened = true;
+    return true;
+}
+
+void Preferences::end() {
+    opened = false;
+}
+
+bool Preferences::clear() {
+    if (!opened || readOnly) {
+        return false;
+    }
+    store[space].clear();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!opened || readOnly) {
+        return false;
+    }
+    return store[space].erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    return opened && store[space].count(key) > 0;
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    return putBytes(key, value, strlen(value));
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    if (!opened || store[space].count(key) == 0) {
+        return defaultValue;
+    }
+    const std::vector<uint8_t>& bytes = store[space][key];
+    return String(std::string(bytes.begin(), bytes.end()));
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLen) {
+    if (!opened || store[space].count(key) == 0 || maxLen == 0) {
+        return 0;
+    }
+    const std::vector<uint8_t>& bytes = store[space][key];
+    size_t len = std::min(bytes.size(), maxLen - 1);
+    memcpy(value, bytes.data(), len);
+    value[len] = 0;
+    return len + 1;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    if (!opened || readOnly || key == nullptr || strlen(key) > 15) {
+        return 0;
+    }
+    const uint8_t* bytes = (const uint8_t*)value;
+    store[space][key] = std::vector<uint8_t>(bytes, bytes + len);
+    return len;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLen) {
+    if (!opened || store[space].count(key) == 0) {
+        return 0;
+    }
+    const std::vector<uint8_t>& bytes = store[space][key];
+    if (bytes.size() > maxLen) {
+        return 0;
+    }
+    memcpy(buffer, bytes.data(), bytes.size());
+    return bytes.size();
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!opened || store[space].count(key) == 0) {
+        return 0;
+    }
+    return store[space][key].size();
+}
+
+/**
+ * @brief Chaîne préremplie "espace.clé=valeur"
+ */
+bool Preferences::preset(const char* entry) {
+    std::string text = entry;
+    size_t dot = text.find('.');
+    size_t equals = text.find('=');
+    if (dot == std::string::npos || equals == std::string::npos || dot == 0 || equals < dot + 2) {
+        return false;
+    }
+    std::string value = text.substr(equals + 1);
+    store[text.substr(0, dot)][text.substr(dot + 1, equals - dot - 1)] =
+        std::vector<uint8_t>(value.begin(), value.end());
+    return true;
+}
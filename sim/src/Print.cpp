@@ -0,0 +1,143 @@
+/**
+ * @file Print.cpp
+ * @brief Simulateur : implémentation de Print et Stream
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * printf() : le firmware est écrit pour l'ESP32, où long fait 32 bits
+ * (%lu pour un uint32_t). Sur Linux 64 bits, le modificateur l est retiré
+ * avant vsnprintf : chaque argument variadique occupe un mot de 64 bits
+ * dont les 32 bits de poids faible portent la valeur, qu'il ait été passé
+ * en int ou en long.
+ */
+
+#include "Print.h"
+#include "Stream.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string>
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (size-- > 0) {
+        written += write(*buffer++);
+    }
+    return written;
+}
+
+/**
+ * @brief Format ESP32 vers format Linux : %l[dioux] -> %[dioux] (%ll conservé)
+ */
+static std::string nativeFormat(const char* format) {
+    std::string out;
+    for (const char* p = format; *p != 0; p++) {
+        out += *p;
+        if (*p != '%') {
+            continue;
+        }
+        p++;
+        if (*p == '%') {
+            out += *p;
+            continue;
+        }
+        // Flags, width, precision
+        while (*p != 0 && strchr("-+ #0123456789.*", *p) != nullptr) {
+            out += *p++;
+        }
+        if (p[0] == 'l' && p[1] != 'l' && p[1] != 0 && strchr("diouxX", p[1]) != nullptr) {
+            p++;  // 32-bit long
+        }
+        if (*p == 0) {
+            break;
+        }
+        out += *p;
+    }
+    return out;
+}
+
+size_t Print::printf(const char* format, ...) {
+    std::string native = nativeFormat(format);
+    char small[256];
+    va_list args;
+    va_start(args, format);
+    va_list copy;
+    va_copy(copy, args);
+    int len = vsnprintf(small, sizeof(small), native.c_str(), args);
+    va_end(args);
+    if (len < 0) {
+        va_end(copy);
+        return 0;
+    }
+    if ((size_t)len < sizeof(small)) {
+        va_end(copy);
+        return write((const uint8_t*)small, len);
+    }
+    std::string large(len + 1, 0);
+    vsnprintf(&large[0], large.size(), native.c_str(), copy);
+    va_end(copy);
+    return write((const uint8_t*)large.data(), len);
+}
+
+size_t Print::print(const String& str) { return write(str.c_str(), str.length()); }
+size_t Print::print(const char str[]) { return write(str); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned char value, int base) { return print(String(value, (unsigned char)base)); }
+size_t Print::print(int value, int base) { return print(String(value, (unsigned char)base)); }
+size_t Print::print(unsigned int value, int base) { return print(String(value, (unsigned char)base)); }
+size_t Print::print(long value, int base) { return print(String(value, (unsigned char)base)); }
+size_t Print::print(unsigned long value, int base) { return print(String(value, (unsigned char)base)); }
+size_t Print::print(long long value, int base) { return print(String(value, (unsigned char)base)); }
+size_t Print::print(unsigned long long value, int base) { return print(String(value, (unsigned char)base)); }
+size_t Print::print(double value, int digits) { return print(String(value, (unsigned int)digits)); }
+
+size_t Print::println(void) { return write("\r\n"); }
+size_t Print::println(const String& str) { return print(str) + println(); }
+size_t Print::println(const char str[]) { return print(str) + println(); }
+size_t Print::println(char c) { return print(c) + println(); }
+size_t Print::println(unsigned char value, int base) { return print(value, base) + println(); }
+size_t Print::println(int value, int base) { return print(value, base) + println(); }
+size_t Print::println(unsigned int value, int base) { return print(value, base) + println(); }
+size_t Print::println(long value, int base) { return print(value, base) + println(); }
+size_t Print::println(unsigned long value, int base) { return print(value, base) + println(); }
+size_t Print::println(long long value, int base) { return print(value, base) + println(); }
+size_t Print::println(unsigned long long value, int base) { return print(value, base) + println(); }
+size_t Print::println(double value, int digits) { return print(value, digits) + println(); }
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = read();
+        if (c < 0) {
+            break;
+        }
+        buffer[count++] = (char)c;
+    }
+    return count;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String out;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) {
+        out.concat((char)c);
+    }
+    return out;
+}
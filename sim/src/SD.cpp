@@ -0,0 +1,410 @@
+/**
+ * @file SD.cpp
+ * @brief Simulateur : carte SD et fichiers dans un répertoire de l'hôte
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Défauts : les octets écrits sont comptés par secteur de 512 octets
+ * (tampon de secteur de FatFs) ; chaque secteur plein coûte une latence
+ * d'écriture, chaque flush ou close après écriture une latence de
+ * synchronisation (secteur partiel, FAT, entrée de répertoire). Chaque
+ * accès à la carte peut déclencher un blocage du ramasse-miettes. Les
+ * tirages ont leur propre générateur : sans défaut configuré, rien n'est
+ * tiré et une exécution reste identique à l'octet près.
+ */
+
+#include <SD.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <ftw.h>
+#include "Sim.h"
+
+SDFS SD;
+
+struct SimFileHandle {
+    FILE* fp;
+    std::string path;                  ///< Card path ("/BOAT.json")
+    std::string name;                  ///< Last path component
+    uint32_t generation = 0;           ///< Card insertion the file was opened on
+    size_t sectorFill = 0;             ///< Bytes in the current sector
+    bool dirty = false;                ///< Written since the last flush
+
+    ~SimFileHandle() {
+        if (fp != nullptr) {
+            fclose(fp);
+        }
+    }
+};
+
+// ============================================================================
+// Injected faults
+// ============================================================================
+
+static const size_t SECTOR_SIZE = 512;
+
+static uint32_t faultState = 0;
+static uint32_t cardGeneration = 1;    // Bumped when the card is pulled out: open files go stale
+static bool cardOut = false;
+static uint64_t bytesWritten = 0;
+
+/**
+ * @brief Tirage des défauts : xorshift32 propre à la carte
+ */
+static uint32_t faultRandom() {
+    if (faultState == 0) {
+        faultState = Sim::options().seed * 2246822519u + 374761393u;
+        if (faultState == 0) {
+            faultState = 1;
+        }
+    }
+    faultState ^= faultState << 13;
+    faultState ^= faultState >> 17;
+    faultState ^= faultState << 5;
+    return faultState;
+}
+
+static uint32_t uniform(uint32_t low, uint32_t high) {
+    return (high <= low) ? low : low + faultRandom() % (high - low + 1);
+}
+
+static bool draw(uint8_t pct) {
+    return pct > 0 && faultRandom() % 100 < pct;
+}
+
+/**
+ * @brief Carte en place à l'heure virtuelle courante
+ *
+ * @details
+ * Au retrait, la carte est démontée et les fichiers ouverts deviennent
+ * invalides ; remise en place, elle attend un nouveau SD.begin().
+ */
+static bool cardPresent() {
+    const SdFaultOptions& faults = Sim::options().sdFaults;
+    uint64_t now = Sim::nowUs();
+    bool out = faults.removeUs > 0 && now >= faults.removeUs && (faults.insertUs == 0 || now < faults.insertUs);
+    if (out != cardOut) {
+        cardOut = out;
+        if (out) {
+            cardGeneration++;
+            SD.end();
+            Sim::log("SD: card removed");
+        } else {
+            Sim::log("SD: card inserted");
+        }
+    }
+    return !out;
+}
+
+/**
+ * @brief Fichier utilisable : carte en place, ouvert depuis la dernière insertion
+ */
+static bool usable(const SimFileHandle& handle) {
+    if (cardPresent() && handle.generation == cardGeneration) {
+        return true;
+    }
+    Sim::counters().sdFailedCalls++;
+    return false;
+}
+
+/**
+ * @brief Accès à la carte : latence tirée, blocage éventuel (loop() attend)
+ */
+static void cardAccess(uint32_t minUs, uint32_t maxUs) {
+    const SdFaultOptions& faults = Sim::options().sdFaults;
+    Sim::Counters& counters = Sim::counters();
+    uint64_t us = uniform(minUs, maxUs);
+    if (draw(faults.stallPct)) {
+        uint32_t stallMs = uniform(faults.stallMinMs, faults.stallMaxMs);
+        counters.sdStalls++;
+        if (stallMs > counters.sdWorstStallMs) {
+            counters.sdWorstStallMs = stallMs;
+        }
+        Sim::log("SD: stall %u ms", stallMs);
+        us += stallMs * 1000ULL;
+    }
+    if (us > 0) {
+        counters.sdBusyUs += us;
+        Sim::advanceUs(us);
+    }
+}
+
+// ============================================================================
+// File
+// ============================================================================
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+/**
+ * @brief Écriture : carte pleine (ENOSPC) et écriture tronquée rendent un compte court
+ */
+size_t File::write(const uint8_t* buffer, size_t size) {
+    if (!handle || handle->fp == nullptr || !usable(*handle)) {
+        return 0;
+    }
+    const SdFaultOptions& faults = Sim::options().sdFaults;
+    Sim::Counters& counters = Sim::counters();
+    if (faults.fullBytes > 0 && bytesWritten + size > faults.fullBytes) {
+        size = (size_t)(faults.fullBytes - bytesWritten);
+        if (counters.sdFullWrites++ == 0) {
+            Sim::log("SD: card full (ENOSPC)");
+        }
+        errno = ENOSPC;
+    }
+    if (size > 1 && draw(faults.tornPct)) {
+        size = faultRandom() % size;
+        counters.sdTornWrites++;
+    }
+    size_t written = fwrite(buffer, 1, size, handle->fp);
+    bytesWritten += written;
+    handle->dirty = handle->dirty || written > 0;
+    handle->sectorFill += written;
+    while (handle->sectorFill >= SECTOR_SIZE) {
+        handle->sectorFill -= SECTOR_SIZE;
+        counters.sdSectors++;
+        cardAccess(faults.sectorMinUs, faults.sectorMaxUs);
+    }
+    return written;
+}
+
+int File::available() {
+    if (!handle || handle->fp == nullptr) {
+        return 0;
+    }
+    return (int)(size() - position());
+}
+
+int File::read() {
+    if (!handle || handle->fp == nullptr) {
+        return -1;
+    }
+    int c = fgetc(handle->fp);
+    return c == EOF ? -1 : c;
+}
+
+int File::peek() {
+    if (!handle || handle->fp == nullptr) {
+        return -1;
+    }
+    int c = fgetc(handle->fp);
+    if (c == EOF) {
+        return -1;
+    }
+    ungetc(c, handle->fp);
+    return c;
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+    if (!handle || handle->fp == nullptr) {
+        return 0;
+    }
+    return fread(buffer, 1, size, handle->fp);
+}
+
+void File::flush() {
+    if (!handle || handle->fp == nullptr || !usable(*handle)) {
+        return;
+    }
+    fflush(handle->fp);
+    if (handle->dirty) {
+        handle->dirty = false;
+        Sim::counters().sdFlushes++;
+        cardAccess(Sim::options().sdFaults.flushMinUs, Sim::options().sdFaults.flushMaxUs);
+    }
+}
+
+bool File::seek(uint32_t position, SeekMode mode) {
+    if (!handle || handle->fp == nullptr) {
+        return false;
+    }
+    static const int WHENCE[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+    return fseek(handle->fp, position, WHENCE[mode]) == 0;
+}
+
+size_t File::position() const {
+    if (!handle || handle->fp == nullptr) {
+        return 0;
+    }
+    long pos = ftell(handle->fp);
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+    if (!handle || handle->fp == nullptr) {
+        return 0;
+    }
+    fflush(handle->fp);
+    struct stat st;
+    return fstat(fileno(handle->fp), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::close() {
+    if (handle && handle->dirty) {
+        flush();
+    }
+    handle.reset();
+}
+
+const char* File::name() const {
+    return handle ? handle->name.c_str() : "";
+}
+
+const char* File::path() const {
+    return handle ? handle->path.c_str() : "";
+}
+
+File::operator bool() const {
+    return handle && handle->fp != nullptr;
+}
+
+// ============================================================================
+// SD
+// ============================================================================
+
+/**
+ * @brief Monte la carte : répertoire --sd, ou répertoire temporaire
+ */
+bool SDFS::begin(uint8_t ssPin, SPIClass& spi, uint32_t frequency, const char* mountpoint, uint8_t maxFiles,
+                 bool formatIfEmpty) {
+    (void)ssPin; (void)spi; (void)frequency; (void)mountpoint; (void)maxFiles; (void)formatIfEmpty;
+    if (!Sim::options().sdEnabled || !cardPresent()) {
+        return false;
+    }
+    if (mounted) {
+        return true;
+    }
+    root = Sim::options().sdPath;
+    if (root.empty()) {
+        char pattern[] = "/tmp/boatgps-sd-XXXXXX";
+        if (mkdtemp(pattern) == nullptr) {
+            return false;
+        }
+        root = pattern;
+        Sim::options().sdPath = root;
+    } else {
+        ::mkdir(root.c_str(), 0755);
+    }
+    struct stat st;
+    if (stat(root.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+        Sim::log("SD: %s is not a directory", root.c_str());
+        return false;
+    }
+    Sim::log("SD card: %s", root.c_str());
+    mounted = true;
+    return true;
+}
+
+void SDFS::end() {
+    mounted = false;
+}
+
+sdcard_type_t SDFS::cardType() {
+    return (cardPresent() && mounted) ? CARD_SDHC : CARD_NONE;
+}
+
+uint64_t SDFS::cardSize() {
+    return mounted ? 16ULL * 1024 * 1024 * 1024 : 0;
+}
+
+uint64_t SDFS::totalBytes() {
+    return cardSize();
+}
+
+static uint64_t usedTotal;
+
+static int addFileSize(const char* path, const struct stat* st, int type, struct FTW* ftw) {
+    (void)path; (void)ftw;
+    if (type == FTW_F) {
+        usedTotal += st->st_size;
+    }
+    return 0;
+}
+
+uint64_t SDFS::usedBytes() {
+    if (!mounted) {
+        return 0;
+    }
+    usedTotal = 0;
+    nftw(root.c_str(), addFileSize, 8, FTW_PHYS);
+    return usedTotal;
+}
+
+std::string SDFS::hostPath(const char* path) const {
+    std::string card = (path != nullptr) ? path : "";
+    if (card.empty() || card[0] != '/') {
+        card = "/" + card;
+    }
+    return root + card;
+}
+
+File SDFS::open(const char* path, const char* mode, bool create) {
+    (void)create;
+    if (path == nullptr || !cardPresent() || !mounted) {
+        return File();
+    }
+    std::string host = hostPath(path);
+    const char* hostMode = "rb";
+    if (strcmp(mode, FILE_WRITE) == 0) {
+        hostMode = "wb+";
+    } else if (strcmp(mode, FILE_APPEND) == 0) {
+        hostMode = "ab+";
+    }
+    FILE* fp = fopen(host.c_str(), hostMode);
+    if (fp == nullptr) {
+        return File();
+    }
+    if (strcmp(hostMode, "rb") != 0) {
+        cardAccess(Sim::options().sdFaults.flushMinUs, Sim::options().sdFaults.flushMaxUs);  // Directory entry
+    }
+    std::shared_ptr<SimFileHandle> handle = std::make_shared<SimFileHandle>();
+    handle->fp = fp;
+    handle->path = path;
+    handle->generation = cardGeneration;
+    size_t slash = handle->path.rfind('/');
+    handle->name = (slash == std::string::npos) ? handle->path : handle->path.substr(slash + 1);
+    return File(handle);
+}
+
+bool SDFS::exists(const char* path) {
+    struct stat st;
+    return cardPresent() && mounted && stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool SDFS::remove(const char* path) {
+    return cardPresent() && mounted && unlink(hostPath(path).c_str()) == 0;
+}
+
+bool SDFS::rename(const char* from, const char* to) {
+    return cardPresent() && mounted && ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool SDFS::mkdir(const char* path) {
+    return cardPresent() && mounted && ::mkdir(hostPath(path).c_str(), 0755) == 0;
+}
+
+bool SDFS::rmdir(const char* path) {
+    return cardPresent() && mounted && ::rmdir(hostPath(path).c_str()) == 0;
+}
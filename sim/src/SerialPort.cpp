@@ -0,0 +1,108 @@
+/**
+ * @file SerialPort.cpp
+ * @brief Implémentation des outils port série hôte
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "SerialPort.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Constante termios d'un débit (0 = non supporté)
+ */
+static speed_t baudConstant(unsigned long baud) {
+    switch (baud) {
+        case 4800: return B4800;
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        default: return 0;
+    }
+}
+
+bool SerialPort::configure(int fd, unsigned long baud) {
+    speed_t speed = baudConstant(baud);
+    struct termios tty;
+    if (speed == 0 || tcgetattr(fd, &tty) != 0) {
+        return false;
+    }
+    cfmakeraw(&tty);
+    cfsetispeed(&tty, speed);
+    cfsetospeed(&tty, speed);
+    tty.c_cflag |= CLOCAL | CREAD;
+    tty.c_cflag &= ~(CSTOPB | CRTSCTS);
+    return tcsetattr(fd, TCSANOW, &tty) == 0;
+}
+
+int SerialPort::open(const char* path, unsigned long baud, int flags) {
+    int fd = ::open(path, flags | O_NOCTTY);
+    if (fd < 0) {
+        fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    if (!configure(fd, baud)) {
+        fprintf(stderr, "%s: not a serial port, or %lu baud not supported\n", path, baud);
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool SerialPort::writeAll(int fd, const void* data, size_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    size_t written = 0;
+    while (written < len) {
+        ssize_t n = ::write(fd, bytes + written, len - written);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written += (size_t)n;
+    }
+    return true;
+}
+
+uint64_t SerialPort::monotonicUs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000ULL + (uint64_t)now.tv_nsec / 1000;
+}
+
+void SerialPort::sleepUntilUs(uint64_t us) {
+    struct timespec target;
+    target.tv_sec = (time_t)(us / 1000000ULL);
+    target.tv_nsec = (long)(us % 1000000ULL) * 1000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR) {
+    }
+}
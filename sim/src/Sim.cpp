@@ -0,0 +1,263 @@
+/**
+ * @file Sim.cpp
+ * @brief Simulateur : horloge virtuelle, aléa déterministe et résumé
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * L'horloge ne dépend que des délais demandés par le firmware : deux
+ * exécutions avec les mêmes entrées et la même graine donnent la même
+ * sortie, octet pour octet. Les trames radio sont remises à leur heure
+ * exacte, y compris au milieu d'un long delay() ou d'un light sleep.
+ *
+ * Temps réel : l'horloge est l'horloge murale depuis begin(). Une attente
+ * dort par tranches de REALTIME_SLICE_US, en remettant les trames reçues
+ * entre deux tranches. Ctrl-C termine l'exécution avec le résumé.
+ */
+
+#include "Sim.h"
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+
+static SimOptions simOptions;
+static uint64_t clockUs = 0;
+static uint64_t endAtUs = 0;
+static uint32_t randomState = 1;
+static UartSource* uartSource = nullptr;
+static RadioLink* radioLink = nullptr;
+static Sim::Counters runCounters = {};
+static struct timespec wallStart;
+static volatile sig_atomic_t interrupted = 0;
+
+/**
+ * @brief Heure virtuelle hh:mm:ss.mmm
+ */
+static void formatTime(uint64_t us, char* out, size_t size) {
+    uint64_t ms = us / 1000;
+    snprintf(out, size, "%02u:%02u:%02u.%03u", (unsigned)(ms / 3600000), (unsigned)(ms / 60000 % 60),
+             (unsigned)(ms / 1000 % 60), (unsigned)(ms % 1000));
+}
+
+SimOptions& Sim::options() {
+    return simOptions;
+}
+
+/**
+ * @brief Temps écoulé depuis begin() (µs)
+ */
+static uint64_t wallElapsedUs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - wallStart.tv_sec) * 1000000ULL + now.tv_nsec / 1000 - wallStart.tv_nsec / 1000;
+}
+
+static void onInterrupt(int signal) {
+    (void)signal;
+    interrupted = 1;
+}
+
+uint64_t Sim::nowUs() {
+    if (simOptions.realtime) {
+        uint64_t wall = wallElapsedUs();
+        if (wall > clockUs) {
+            clockUs = wall;
+        }
+    }
+    return clockUs;
+}
+
+void Sim::setEndUs(uint64_t endUs) {
+    endAtUs = endUs;
+}
+
+/**
+ * @brief Début de l'exécution : graine de l'aléa (graine et MAC), horloge murale
+ */
+void Sim::begin() {
+    clock_gettime(CLOCK_MONOTONIC, &wallStart);
+    signal(SIGINT, onInterrupt);
+    signal(SIGTERM, onInterrupt);
+    randomState = simOptions.seed * 2654435761u;
+    for (int i = 0; i < 6; i++) {
+        randomState = (randomState ^ simOptions.mac[i]) * 16777619u;
+    }
+    if (randomState == 0) {
+        randomState = 1;
+    }
+}
+
+/**
+ * @brief Attente en temps réel, trames remises entre deux tranches
+ */
+static void advanceRealtime(uint64_t target) {
+    for (;;) {
+        uint64_t now = Sim::nowUs();
+        if (interrupted || (endAtUs != 0 && now >= endAtUs)) {
+            Sim::finish(0);
+        }
+        Sim::deliverRadio(now);
+        if (now >= target) {
+            return;
+        }
+        uint64_t wake = std::min(target, now + Sim::REALTIME_SLICE_US);
+        struct timespec until = wallStart;
+        until.tv_sec += (time_t)(wake / 1000000ULL);
+        until.tv_nsec += (long)(wake % 1000000ULL) * 1000;
+        if (until.tv_nsec >= 1000000000L) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, nullptr);
+    }
+}
+
+/**
+ * @brief Avance l'horloge virtuelle
+ *
+ * @details
+ * L'horloge s'arrête à chaque arrivée de trame radio pour que
+ * ReceivedFrame::receivedAt soit exact, et avec --radio-airtime à chaque
+ * fin d'émission (heure du rappel d'envoi).
+ */
+void Sim::advanceUs(uint64_t us) {
+    if (interrupted) {
+        finish(0);
+    }
+    if (simOptions.realtime) {
+        advanceRealtime(nowUs() + us);
+        return;
+    }
+    uint64_t target = clockUs + us;
+    for (;;) {
+        uint64_t next = radioLink != nullptr ? radioLink->nextArrivalUs() : UINT64_MAX;
+        if (simOptions.radioAirtime) {
+            next = std::min(next, nextSendCallbackUs());
+        }
+        if (next > target) {
+            break;
+        }
+        if (next > clockUs) {
+            clockUs = next;
+        }
+        if (endAtUs != 0 && clockUs >= endAtUs) {
+            finish(0);
+        }
+        deliverRadio(clockUs);
+    }
+    clockUs = target;
+    if (endAtUs != 0 && clockUs >= endAtUs) {
+        finish(0);
+    }
+    deliverRadio(clockUs);
+}
+
+/**
+ * @brief Xorshift32 : même suite pour la même graine et la même MAC
+ */
+uint32_t Sim::random32() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+UartSource* Sim::gpsSource() {
+    return uartSource;
+}
+
+void Sim::setGpsSource(UartSource* source) {
+    uartSource = source;
+}
+
+RadioLink* Sim::radio() {
+    return radioLink;
+}
+
+void Sim::setRadio(RadioLink* link) {
+    radioLink = link;
+}
+
+Sim::Counters& Sim::counters() {
+    return runCounters;
+}
+
+void Sim::log(const char* format, ...) {
+    char stamp[24];
+    formatTime(clockUs, stamp, sizeof(stamp));
+    fprintf(stderr, "[sim %s] ", stamp);
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+bool Sim::deadlineMissed() {
+    return runCounters.broadcastsLate > 0 || runCounters.uartLateReads > 0 || runCounters.uartOverrunBursts > 0;
+}
+
+/**
+ * @brief Résumé de l'exécution (stderr) puis sortie
+ *
+ * @details
+ * Exemple:
+ * sim: 03:00:00.000 virtual in 4.21 s (x2565) | radio 64812 sent, 21544 received, 1077 lost, 0 off channel | GPS 5184000 bytes, 0 overrun | sleep 61.2%
+ * sim: deadlines: broadcast 43190 frames, 0 late | GPS 0 late reads (worst wait 180 ms), 0 overrun bursts
+ *
+ * Avec des défauts SD, une troisième ligne :
+ * sim: SD: 8120 sectors, 21600 flushes, 213 stalls (worst 498 ms), busy 3.2% | 0 ENOSPC, 0 torn, 0 failed (removed)
+ */
+void Sim::finish(int code) {
+    struct timespec wallEnd;
+    clock_gettime(CLOCK_MONOTONIC, &wallEnd);
+    double wall = (wallEnd.tv_sec - wallStart.tv_sec) + (wallEnd.tv_nsec - wallStart.tv_nsec) / 1e9;
+    char stamp[24];
+    formatTime(clockUs, stamp, sizeof(stamp));
+
+    fflush(stdout);
+    fprintf(stderr, "sim: %s virtual in %.2f s (x%.0f) | radio %u sent, %u received, %u lost, %u off channel"
+                    " | GPS %u bytes, %u overrun | sleep %.1f%%\n",
+            stamp, wall, wall > 0 ? clockUs / 1e6 / wall : 0.0,
+            runCounters.framesSent, runCounters.framesReceived, runCounters.framesLost, runCounters.framesOffChannel,
+            runCounters.uartBytes, runCounters.uartOverruns,
+            clockUs > 0 ? runCounters.sleepUs * 100.0 / clockUs : 0.0);
+    fprintf(stderr, "sim: deadlines: broadcast %u frames, %u late", runCounters.broadcasts, runCounters.broadcastsLate);
+    if (runCounters.broadcastsLate > 0) {
+        fprintf(stderr, " (worst %u ms for %u ms)", runCounters.broadcastWorstGapMs,
+                runCounters.broadcastWorstDeadlineMs);
+    }
+    fprintf(stderr, " | GPS %u late reads (worst wait %u ms), %u overrun bursts\n", runCounters.uartLateReads,
+            runCounters.uartWorstWaitMs, runCounters.uartOverrunBursts);
+    if (simOptions.sdFaults.any()) {
+        fprintf(stderr, "sim: SD: %u sectors, %u flushes, %u stalls (worst %u ms), busy %.1f%% | %u ENOSPC, %u torn,"
+                        " %u failed (removed)\n",
+                runCounters.sdSectors, runCounters.sdFlushes, runCounters.sdStalls, runCounters.sdWorstStallMs,
+                clockUs > 0 ? runCounters.sdBusyUs * 100.0 / clockUs : 0.0, runCounters.sdFullWrites,
+                runCounters.sdTornWrites, runCounters.sdFailedCalls);
+    }
+    if (code == 0 && simOptions.failOnMiss && deadlineMissed()) {
+        code = 3;
+    }
+    exit(code);
+}
@@ -0,0 +1,323 @@
+/**
+ * @file SimMain.cpp
+ * @brief Simulateur : point d'entrée, options et boucle setup() / loop()
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Remplace le main() du cœur Arduino-ESP32 : lecture des options,
+ * préparation des périphériques simulés, puis setup() et loop() de
+ * main.cpp jusqu'à la fin de l'entrée NMEA (plus LINGER_US) ou de la
+ * durée demandée (en temps réel sans fichier NMEA : jusqu'à Ctrl-C).
+ * Une itération de loop() qui n'a pas fait avancer l'horloge l'avance de
+ * 1 ms (la boucle réelle attend toujours au moins autant dans
+ * PowerManager::idle()) ; en temps réel, l'horloge avance toujours un
+ * peu : l'itération est complétée jusqu'à 1 ms.
+ */
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Sim.h"
+#include "NmeaFile.h"
+#include "FileRadio.h"
+#include "TtyUart.h"
+#include "UdpRadio.h"
+
+void setup();
+void loop();
+
+static const char* USAGE =
+    "Usage: %s [options]\n"
+    "  --nmea FILE          GPS input, replayed at its UTC times and the UART baud rate\n"
+    "  --duration T         Run length (s, or with m / h suffix; default: NMEA end + 10 s, else 60 s)\n"
+    "  --sd DIR             SD card directory (default: new /tmp/boatgps-sd-XXXXXX)\n"
+    "  --no-sd              No SD card\n"
+    "  --radio-out FILE     Capture the sent frames (- = stdout)\n"
+    "  --radio-in FILE      Frames to receive (same format as the capture)\n"
+    "  --radio-loss PCT     Received frames dropped (%%)\n"
+    "  --radio-airtime      Sends take the airtime of an LR frame; send callback at its end\n"
+    "  --mac AA:BB:CC:DD:EE:FF  Own MAC address (default 02:00:00:00:00:01)\n"
+    "  --nvs NS.KEY=VALUE   Preset an NVS string (repeatable), e.g. boatgps.boat_name=FRA42\n"
+    "  --seed N             Random seed (default 1)\n"
+    "  --timestamps         Prefix console lines with the virtual time\n"
+    "  --quiet              No console output (summary only)\n"
+    "  --console-out FILE   Raw console bytes to FILE (binary output of the gateway mode)\n"
+    "  --led                Log LED colour changes\n"
+    "Real time (clock locked to the wall clock, Ctrl-C ends the run):\n"
+    "  --realtime           Real time with the file inputs\n"
+    "  --gps-device DEV     GPS on a serial device or pseudo-terminal (tools/virtual_gps)\n"
+    "  --radio-udp G:PORT   Radio over UDP multicast, e.g. 239.255.0.42:5042\n"
+    "SD card faults (the call blocks loop() for the latency):\n"
+    "  --sd-write US[-US]   Latency of each 512-byte sector written\n"
+    "  --sd-flush US[-US]   Latency of each flush, close or file creation\n"
+    "  --sd-stall PCT:MS[-MS]  Garbage collection stall on a card access\n"
+    "  --sd-full SIZE       ENOSPC after SIZE bytes written (k / M suffix)\n"
+    "  --sd-torn PCT        write() calls cut short\n"
+    "  --sd-remove T[:T2]   Card pulled out at T, put back at T2 (durations as --duration)\n"
+    "Deadlines:\n"
+    "  --deadline-slack MS  Position frame gap allowed over interval + jitter (default 50)\n"
+    "  --fail-on-miss       Exit code 3 if a deadline was missed\n";
+
+/**
+ * @brief Durée : secondes, ou suffixe m / h
+ */
+static bool parseDuration(const char* text, uint64_t& us) {
+    char* end;
+    double value = strtod(text, &end);
+    if (end == text || value <= 0) {
+        return false;
+    }
+    if (*end == 'h') {
+        value *= 3600;
+    } else if (*end == 'm') {
+        value *= 60;
+    } else if (*end != 0 && *end != 's') {
+        return false;
+    }
+    us = (uint64_t)(value * 1e6);
+    return true;
+}
+
+/**
+ * @brief Plage "MIN-MAX" ou valeur seule
+ */
+static bool parseRange(const char* text, uint32_t& low, uint32_t& high) {
+    char* end;
+    low = (uint32_t)strtoul(text, &end, 10);
+    if (end == text) {
+        return false;
+    }
+    high = low;
+    if (*end == '-') {
+        const char* second = end + 1;
+        high = (uint32_t)strtoul(second, &end, 10);
+        if (end == second || high < low) {
+            return false;
+        }
+    }
+    return *end == 0;
+}
+
+/**
+ * @brief Taille en octets, suffixe k / M
+ */
+static bool parseSize(const char* text, uint64_t& bytes) {
+    char* end;
+    double value = strtod(text, &end);
+    if (end == text || value <= 0) {
+        return false;
+    }
+    if (*end == 'k') {
+        value *= 1024;
+    } else if (*end == 'M') {
+        value *= 1024 * 1024;
+    } else if (*end != 0) {
+        return false;
+    }
+    bytes = (uint64_t)value;
+    return true;
+}
+
+static bool parseMac(const char* text, uint8_t* mac) {
+    unsigned bytes[6];
+    if (sscanf(text, "%x:%x:%x:%x:%x:%x", &bytes[0], &bytes[1], &bytes[2], &bytes[3], &bytes[4], &bytes[5]) != 6) {
+        return false;
+    }
+    for (int i = 0; i < 6; i++) {
+        if (bytes[i] > 0xFF) {
+            return false;
+        }
+        mac[i] = (uint8_t)bytes[i];
+    }
+    return true;
+}
+
+static void usage(const char* program, int code) {
+    fprintf(code == 0 ? stdout : stderr, USAGE, program);
+    exit(code);
+}
+
+int main(int argc, char** argv) {
+    SimOptions& options = Sim::options();
+    SdFaultOptions& faults = options.sdFaults;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            usage(argv[0], 0);
+        } else if (strcmp(arg, "--nmea") == 0 && hasValue) {
+            options.nmeaPath = argv[++i];
+        } else if (strcmp(arg, "--duration") == 0 && hasValue) {
+            if (!parseDuration(argv[++i], options.durationUs)) usage(argv[0], 1);
+        } else if (strcmp(arg, "--sd") == 0 && hasValue) {
+            options.sdPath = argv[++i];
+        } else if (strcmp(arg, "--no-sd") == 0) {
+            options.sdEnabled = false;
+        } else if (strcmp(arg, "--radio-out") == 0 && hasValue) {
+            options.radioOutPath = argv[++i];
+        } else if (strcmp(arg, "--radio-in") == 0 && hasValue) {
+            options.radioInPath = argv[++i];
+        } else if (strcmp(arg, "--radio-loss") == 0 && hasValue) {
+            int lossPct = atoi(argv[++i]);
+            options.radioLossPct = (uint8_t)constrain(lossPct, 0, 100);
+        } else if (strcmp(arg, "--radio-airtime") == 0) {
+            options.radioAirtime = true;
+        } else if (strcmp(arg, "--mac") == 0 && hasValue) {
+            if (!parseMac(argv[++i], options.mac)) usage(argv[0], 1);
+        } else if (strcmp(arg, "--nvs") == 0 && hasValue) {
+            options.nvs.push_back(argv[++i]);
+        } else if (strcmp(arg, "--seed") == 0 && hasValue) {
+            options.seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else if (strcmp(arg, "--timestamps") == 0) {
+            options.timestamps = true;
+        } else if (strcmp(arg, "--quiet") == 0) {
+            options.quiet = true;
+        } else if (strcmp(arg, "--console-out") == 0 && hasValue) {
+            options.consoleOutPath = argv[++i];
+        } else if (strcmp(arg, "--led") == 0) {
+            options.traceLed = true;
+        } else if (strcmp(arg, "--realtime") == 0) {
+            options.realtime = true;
+        } else if (strcmp(arg, "--gps-device") == 0 && hasValue) {
+            options.gpsDevice = argv[++i];
+            options.realtime = true;
+        } else if (strcmp(arg, "--radio-udp") == 0 && hasValue) {
+            options.radioUdp = argv[++i];
+            options.realtime = true;
+        } else if (strcmp(arg, "--sd-write") == 0 && hasValue) {
+            if (!parseRange(argv[++i], faults.sectorMinUs, faults.sectorMaxUs)) usage(argv[0], 1);
+        } else if (strcmp(arg, "--sd-flush") == 0 && hasValue) {
+            if (!parseRange(argv[++i], faults.flushMinUs, faults.flushMaxUs)) usage(argv[0], 1);
+        } else if (strcmp(arg, "--sd-stall") == 0 && hasValue) {
+            const char* value = argv[++i];
+            const char* colon = strchr(value, ':');
+            int stallPct = atoi(value);
+            if (colon == nullptr || stallPct <= 0 || stallPct > 100 ||
+                !parseRange(colon + 1, faults.stallMinMs, faults.stallMaxMs)) {
+                usage(argv[0], 1);
+            }
+            faults.stallPct = (uint8_t)stallPct;
+        } else if (strcmp(arg, "--sd-full") == 0 && hasValue) {
+            if (!parseSize(argv[++i], faults.fullBytes)) usage(argv[0], 1);
+        } else if (strcmp(arg, "--sd-torn") == 0 && hasValue) {
+            int tornPct = atoi(argv[++i]);
+            faults.tornPct = (uint8_t)constrain(tornPct, 0, 100);
+        } else if (strcmp(arg, "--sd-remove") == 0 && hasValue) {
+            std::string value = argv[++i];
+            size_t colon = value.find(':');
+            if (!parseDuration(value.substr(0, colon).c_str(), faults.removeUs) ||
+                (colon != std::string::npos && !parseDuration(value.c_str() + colon + 1, faults.insertUs)) ||
+                (faults.insertUs != 0 && faults.insertUs <= faults.removeUs)) {
+                usage(argv[0], 1);
+            }
+        } else if (strcmp(arg, "--deadline-slack") == 0 && hasValue) {
+            options.deadlineSlackMs = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(arg, "--fail-on-miss") == 0) {
+            options.failOnMiss = true;
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            usage(argv[0], 1);
+        }
+    }
+
+    if (!options.gpsDevice.empty() && !options.nmeaPath.empty()) {
+        fprintf(stderr, "--gps-device and --nmea are exclusive\n");
+        return 1;
+    }
+    if (!options.radioUdp.empty() && (!options.radioOutPath.empty() || !options.radioInPath.empty())) {
+        fprintf(stderr, "--radio-udp and the radio files are exclusive\n");
+        return 1;
+    }
+
+    Sim::begin();
+    for (const std::string& entry : options.nvs) {
+        if (!Preferences::preset(entry.c_str())) {
+            fprintf(stderr, "Bad --nvs entry: %s\n", entry.c_str());
+            return 1;
+        }
+    }
+
+    if (!options.consoleOutPath.empty() && !Serial.openOutput(options.consoleOutPath.c_str())) {
+        fprintf(stderr, "Cannot create %s\n", options.consoleOutPath.c_str());
+        return 1;
+    }
+
+    // GPS: the receiver starts sending at power-on, like the real module
+    static NmeaFile nmea;
+    if (!options.nmeaPath.empty()) {
+        if (!nmea.load(options.nmeaPath.c_str(), 0)) {
+            fprintf(stderr, "Cannot read timed NMEA sentences from %s\n", options.nmeaPath.c_str());
+            return 1;
+        }
+        Sim::setGpsSource(&nmea);
+        Sim::log("NMEA: %zu sentences from %s", nmea.getSentenceCount(), options.nmeaPath.c_str());
+    }
+
+    static TtyUart device;
+    if (!options.gpsDevice.empty()) {
+        if (!device.open(options.gpsDevice.c_str())) {
+            return 1;
+        }
+        Sim::setGpsSource(&device);
+        Sim::log("GPS: %s", options.gpsDevice.c_str());
+    }
+
+    static FileRadio radio;
+    static UdpRadio udpRadio;
+    if (!options.radioUdp.empty()) {
+        if (!udpRadio.open(options.radioUdp.c_str())) {
+            return 1;
+        }
+        Sim::setRadio(&udpRadio);
+        Sim::log("Radio: UDP %s", options.radioUdp.c_str());
+    } else {
+        if (!options.radioOutPath.empty() && !radio.openCapture(options.radioOutPath.c_str())) {
+            fprintf(stderr, "Cannot create %s\n", options.radioOutPath.c_str());
+            return 1;
+        }
+        if (!options.radioInPath.empty() && !radio.loadInput(options.radioInPath.c_str())) {
+            fprintf(stderr, "Cannot read frames from %s\n", options.radioInPath.c_str());
+            return 1;
+        }
+        Sim::setRadio(&radio);
+    }
+
+    // Real time without an NMEA file: until Ctrl-C
+    uint64_t endUs = options.durationUs;
+    if (endUs == 0 && !options.nmeaPath.empty()) {
+        endUs = nmea.endUs() + Sim::LINGER_US;
+    } else if (endUs == 0 && !options.realtime) {
+        endUs = 60000000ULL;
+    }
+    Sim::setEndUs(endUs);
+
+    setup();
+    for (;;) {
+        uint64_t before = Sim::nowUs();
+        loop();
+        uint64_t elapsed = Sim::nowUs() - before;
+        if (options.realtime ? elapsed < 1000 : elapsed == 0) {
+            Sim::advanceUs(1000 - elapsed);
+        }
+    }
+}
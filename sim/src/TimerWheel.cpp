@@ -0,0 +1,63 @@
+/**
+ * @file TimerWheel.cpp
+ * @brief Outils hôte : implémentation de la roue de temporisation
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TimerWheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel(uint32_t tickUs) : tickUs(tickUs), tick(0), pending(0), slots(SLOTS) {}
+
+void TimerWheel::schedule(uint32_t id, uint64_t dueUs) {
+    uint64_t dueTick = std::max(dueUs / tickUs, tick);
+    Entry entry = {dueTick, {dueUs, id}};
+    slots[dueTick % SLOTS].push_back(entry);
+    pending++;
+}
+
+void TimerWheel::advance(std::vector<Event>& fired) {
+    fired.clear();
+    std::vector<Entry>& slot = slots[tick % SLOTS];
+    // Entries of later turns stay in the bucket (swap-remove, order restored by the sort)
+    for (size_t i = 0; i < slot.size();) {
+        if (slot[i].tick == tick) {
+            fired.push_back(slot[i].event);
+            slot[i] = slot.back();
+            slot.pop_back();
+        } else {
+            i++;
+        }
+    }
+    pending -= fired.size();
+    std::sort(fired.begin(), fired.end(), [](const Event& a, const Event& b) {
+        return a.dueUs != b.dueUs ? a.dueUs < b.dueUs : a.id < b.id;
+    });
+    tick++;
+}
+
+uint64_t TimerWheel::currentTickUs() const {
+    return tick * tickUs;
+}
+
+size_t TimerWheel::size() const {
+    return pending;
+}
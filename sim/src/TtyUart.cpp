@@ -0,0 +1,102 @@
+/**
+ * @file TtyUart.cpp
+ * @brief Simulateur : implémentation de l'UART du GPS sur port série
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TtyUart.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "SerialPort.h"
+
+TtyUart::TtyUart() : fd(-1), head(0), count(0) {}
+
+TtyUart::~TtyUart() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool TtyUart::open(const char* path) {
+    fd = SerialPort::open(path, 9600, O_RDWR | O_NONBLOCK);
+    return fd >= 0;
+}
+
+/**
+ * @brief Réglage de l'UART par le firmware (Serial2.begin)
+ *
+ * @details
+ * Les octets arrivés avant sont écartés : une UART pas encore
+ * configurée ne reçoit rien, ils ne doivent pas déborder d'un coup le
+ * tampon de réception au démarrage.
+ */
+void TtyUart::setBaud(unsigned long baud) {
+    if (fd < 0) {
+        return;
+    }
+    if (!SerialPort::configure(fd, baud)) {
+        Sim::log("GPS device: %lu baud not supported", baud);
+    }
+    tcflush(fd, TCIFLUSH);
+    count = 0;
+}
+
+void TtyUart::fill() const {
+    if (fd < 0 || count > 0) {
+        return;
+    }
+    ssize_t n = read(fd, buffer, BUFFER_SIZE);
+    if (n > 0) {
+        head = 0;
+        count = (size_t)n;
+    }
+}
+
+uint64_t TtyUart::nextArrivalUs() const {
+    fill();
+    return count > 0 ? 0 : UINT64_MAX;
+}
+
+bool TtyUart::poll(uint64_t nowUs, uint8_t& byte) {
+    (void)nowUs;
+    fill();
+    if (count == 0) {
+        return false;
+    }
+    byte = buffer[head++];
+    count--;
+    return true;
+}
+
+/**
+ * @brief Commandes du firmware vers le récepteur
+ */
+void TtyUart::write(const uint8_t* data, size_t len) {
+    if (fd >= 0 && !SerialPort::writeAll(fd, data, len) && errno != EAGAIN) {
+        Sim::log("GPS device: write error");
+    }
+}
+
+uint64_t TtyUart::endUs() const {
+    return 0;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file UdpRadio.cpp
+ * @brief Simulateur : implémentation de la radio sur UDP multicast
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Socket non bloquante liée au port du groupe (SO_REUSEADDR : plusieurs
+ * instances sur la même machine), boucle multicast active, TTL 1 (réseau
+ * local seulement).
+ */
+
+#include "UdpRadio.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+UdpRadio::UdpRadio() : fd(-1) {
+    memset(&group, 0, sizeof(group));
+}
+
+UdpRadio::~UdpRadio() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool UdpRadio::open(const char* address) {
+    char host[64];
+    unsigned port;
+    if (sscanf(address, "%63[^:]:%u", host, &port) != 2 || port == 0 || port > 65535) {
+        fprintf(stderr, "Bad UDP address (group:port): %s\n", address);
+        return false;
+    }
+    group.sin_family = AF_INET;
+    group.sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, host, &group.sin_addr) != 1 || !IN_MULTICAST(ntohl(group.sin_addr.s_addr))) {
+        fprintf(stderr, "Not a multicast group: %s\n", host);
+        return false;
+    }
+
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return false;
+    }
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    struct sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_port = group.sin_port;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(fd, (struct sockaddr*)&local, sizeof(local)) != 0) {
+        perror("bind");
+        return false;
+    }
+    struct ip_mreq membership;
+    membership.imr_multiaddr = group.sin_addr;
+    membership.imr_interface.s_addr = htonl(INADDR_ANY);
+    if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+        perror("IP_ADD_MEMBERSHIP");
+        return false;
+    }
+    unsigned char loop = 1;
+    unsigned char ttl = 1;
+    setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+size_t UdpRadio::encode(const SimFrame& frame, uint8_t* out) {
+    out[0] = 'B';
+    out[1] = 'G';
+    out[2] = frame.channel;
+    memcpy(out + 3, frame.mac, 6);
+    memcpy(out + HEADER_SIZE, frame.data, frame.len);
+    return HEADER_SIZE + frame.len;
+}
+
+bool UdpRadio::decode(const uint8_t* data, size_t len, SimFrame& frame) {
+    if (len < HEADER_SIZE || len > MAX_DATAGRAM || data[0] != 'B' || data[1] != 'G') {
+        return false;
+    }
+    frame.channel = data[2];
+    memcpy(frame.mac, data + 3, 6);
+    frame.len = (uint8_t)(len - HEADER_SIZE);
+    memcpy(frame.data, data + HEADER_SIZE, frame.len);
+    return true;
+}
+
+void UdpRadio::transmit(const SimFrame& frame) {
+    if (fd < 0) {
+        return;
+    }
+    uint8_t datagram[MAX_DATAGRAM];
+    size_t len = encode(frame, datagram);
+    if (sendto(fd, datagram, len, 0, (struct sockaddr*)&group, sizeof(group)) < 0 && errno != EAGAIN) {
+        fprintf(stderr, "UDP radio: %s\n", strerror(errno));
+    }
+}
+
+int UdpRadio::getFd() const {
+    return fd;
+}
+
+uint64_t UdpRadio::nextArrivalUs() const {
+    return UINT64_MAX;
+}
+
+bool UdpRadio::poll(uint64_t nowUs, SimFrame& frame) {
+    if (fd < 0) {
+        return false;
+    }
+    uint8_t datagram[MAX_DATAGRAM + 1];
+    for (;;) {
+        ssize_t len = recv(fd, datagram, sizeof(datagram), 0);
+        if (len < 0) {
+            return false;
+        }
+        if (decode(datagram, (size_t)len, frame)) {
+            frame.timeUs = nowUs;
+            return true;
+        }
+    }
+}
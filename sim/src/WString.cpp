@@ -0,0 +1,241 @@
+/**
+ * @file WString.cpp
+ * @brief Simulateur : implémentation de String
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "WString.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Entier dans une base (2 à 16), comme ltoa/ultoa
+ */
+static std::string formatInteger(unsigned long long magnitude, bool negative, unsigned char base) {
+    if (base < 2 || base > 16) {
+        base = 10;
+    }
+    char digits[72];
+    int pos = sizeof(digits);
+    digits[--pos] = 0;
+    do {
+        digits[--pos] = "0123456789abcdef"[magnitude % base];
+        magnitude /= base;
+    } while (magnitude != 0);
+    if (negative) {
+        digits[--pos] = '-';
+    }
+    return std::string(&digits[pos]);
+}
+
+static std::string formatSigned(long long value, unsigned char base) {
+    // Arduino prints negative values in a base other than 10 as unsigned
+    if (value < 0 && base == 10) {
+        return formatInteger((unsigned long long)(-(value + 1)) + 1, true, base);
+    }
+    return formatInteger((unsigned long long)value, false, base);
+}
+
+static std::string formatFloat(double value, unsigned int decimalPlaces) {
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", (int)decimalPlaces, value);
+    return std::string(text);
+}
+
+String::String(const char* cstr) : buffer(cstr ? cstr : "") {}
+String::String(const std::string& str) : buffer(str) {}
+String::String(char c) : buffer(1, c) {}
+String::String(unsigned char value, unsigned char base) : buffer(formatInteger(value, false, base)) {}
+String::String(int value, unsigned char base) : buffer(formatSigned(value, base)) {}
+String::String(unsigned int value, unsigned char base) : buffer(formatInteger(value, false, base)) {}
+String::String(long value, unsigned char base) : buffer(formatSigned(value, base)) {}
+String::String(unsigned long value, unsigned char base) : buffer(formatInteger(value, false, base)) {}
+String::String(long long value, unsigned char base) : buffer(formatSigned(value, base)) {}
+String::String(unsigned long long value, unsigned char base) : buffer(formatInteger(value, false, base)) {}
+String::String(float value, unsigned int decimalPlaces) : buffer(formatFloat(value, decimalPlaces)) {}
+String::String(double value, unsigned int decimalPlaces) : buffer(formatFloat(value, decimalPlaces)) {}
+
+String& String::operator=(const char* cstr) {
+    buffer = cstr ? cstr : "";
+    return *this;
+}
+
+bool String::reserve(unsigned int size) {
+    buffer.reserve(size);
+    return true;
+}
+
+bool String::concat(const String& str) { buffer += str.buffer; return true; }
+bool String::concat(const char* cstr) { if (cstr) buffer += cstr; return cstr != nullptr; }
+bool String::concat(const char* cstr, unsigned int length) { if (cstr) buffer.append(cstr, length); return cstr != nullptr; }
+bool String::concat(char c) { buffer += c; return true; }
+bool String::concat(unsigned char value) { return concat(String(value)); }
+bool String::concat(int value) { return concat(String(value)); }
+bool String::concat(unsigned int value) { return concat(String(value)); }
+bool String::concat(long value) { return concat(String(value)); }
+bool String::concat(unsigned long value) { return concat(String(value)); }
+bool String::concat(float value) { return concat(String(value)); }
+bool String::concat(double value) { return concat(String(value)); }
+
+String operator+(const String& lhs, const String& rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, const char* rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const char* lhs, const String& rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, char rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, int rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, unsigned int rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, long rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, unsigned long rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, float rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, double rhs) { String s(lhs); s.concat(rhs); return s; }
+
+bool String::equalsIgnoreCase(const String& other) const {
+    if (buffer.size() != other.buffer.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < buffer.size(); i++) {
+        if (tolower((unsigned char)buffer[i]) != tolower((unsigned char)other.buffer[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool String::startsWith(const String& prefix) const {
+    return buffer.compare(0, prefix.buffer.size(), prefix.buffer) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    return buffer.size() >= suffix.buffer.size() &&
+           buffer.compare(buffer.size() - suffix.buffer.size(), suffix.buffer.size(), suffix.buffer) == 0;
+}
+
+void String::setCharAt(unsigned int index, char c) {
+    if (index < buffer.size()) {
+        buffer[index] = c;
+    }
+}
+
+int String::indexOf(char c, unsigned int fromIndex) const {
+    size_t pos = buffer.find(c, fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+    size_t pos = buffer.find(str.buffer, fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const {
+    size_t pos = buffer.rfind(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(const String& str) const {
+    size_t pos = buffer.rfind(str.buffer);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int beginIndex) const {
+    return substring(beginIndex, length());
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if (beginIndex > endIndex) {
+        unsigned int swap = beginIndex;
+        beginIndex = endIndex;
+        endIndex = swap;
+    }
+    if (beginIndex >= buffer.size()) {
+        return String();
+    }
+    if (endIndex > buffer.size()) {
+        endIndex = buffer.size();
+    }
+    return String(buffer.substr(beginIndex, endIndex - beginIndex));
+}
+
+void String::replace(char find, char replacement) {
+    for (char& c : buffer) {
+        if (c == find) {
+            c = replacement;
+        }
+    }
+}
+
+void String::replace(const String& find, const String& replacement) {
+    if (find.buffer.empty()) {
+        return;
+    }
+    size_t pos = 0;
+    while ((pos = buffer.find(find.buffer, pos)) != std::string::npos) {
+        buffer.replace(pos, find.buffer.size(), replacement.buffer);
+        pos += replacement.buffer.size();
+    }
+}
+
+void String::remove(unsigned int index) {
+    if (index < buffer.size()) {
+        buffer.erase(index);
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index < buffer.size()) {
+        buffer.erase(index, count);
+    }
+}
+
+void String::toLowerCase() {
+    for (char& c : buffer) {
+        c = (char)tolower((unsigned char)c);
+    }
+}
+
+void String::toUpperCase() {
+    for (char& c : buffer) {
+        c = (char)toupper((unsigned char)c);
+    }
+}
+
+void String::trim() {
+    size_t begin = 0;
+    while (begin < buffer.size() && isspace((unsigned char)buffer[begin])) {
+        begin++;
+    }
+    size_t end = buffer.size();
+    while (end > begin && isspace((unsigned char)buffer[end - 1])) {
+        end--;
+    }
+    buffer = buffer.substr(begin, end - begin);
+}
+
+long String::toInt() const {
+    return atol(buffer.c_str());
+}
+
+float String::toFloat() const {
+    return (float)atof(buffer.c_str());
+}
+
+double String::toDouble() const {
+    return atof(buffer.c_str());
+}
@@ -0,0 +1,310 @@
+/**
+ * @file esp_now.cpp
+ * @brief Simulateur : ESP-NOW, canal WiFi et adresse MAC
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Les trames envoyées partent vers le RadioLink avec l'heure virtuelle et
+ * le canal courant. Les trames reçues sont filtrées par canal, perdues
+ * selon --radio-loss (aléa séparé de celui du firmware : le taux de perte
+ * ne décale pas la gigue des émissions), puis remises au rappel de
+ * réception comme depuis la tâche WiFi. En mode promiscuité, la trame
+ * d'action 802.11 qui la porte passe d'abord au rappel de promiscuité.
+ *
+ * Avec --radio-airtime, les trames envoyées occupent l'antenne l'une après
+ * l'autre (durée d'une trame LR) : la capture porte l'heure de début
+ * d'émission, le rappel d'envoi arrive à la fin, comme la file du pilote.
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <deque>
+#include <set>
+#include <string>
+#include "Sim.h"
+
+#define ESP_ERR_ESPNOW_NOT_INIT 0x3069
+
+WiFiClass WiFi;
+
+static bool initialized = false;
+static esp_now_send_cb_t sendCallback = nullptr;
+static esp_now_recv_cb_t recvCallback = nullptr;
+static std::deque<uint64_t> sendCallbackUs;    // Send callback times, in send order
+static uint64_t airBusyUntilUs = 0;             // End of the last frame on air (--radio-airtime)
+static std::set<std::string> peers;
+static uint8_t wifiChannel = 1;
+static uint8_t wifiProtocol = WIFI_PROTOCOL_11B | WIFI_PROTOCOL_11G | WIFI_PROTOCOL_11N;
+static uint32_t lossState = 0;
+static bool promiscuous = false;
+static uint32_t promiscuousMask = WIFI_PROMIS_FILTER_MASK_MGMT;
+static wifi_promiscuous_cb_t promiscuousCallback = nullptr;
+
+/**
+ * @brief Tirage de perte : xorshift32 propre à la radio
+ */
+static bool frameLost() {
+    uint8_t pct = Sim::options().radioLossPct;
+    if (pct == 0) {
+        return false;
+    }
+    if (lossState == 0) {
+        lossState = Sim::options().seed * 747796405u + 2891336453u;
+        if (lossState == 0) {
+            lossState = 1;
+        }
+    }
+    lossState ^= lossState << 13;
+    lossState ^= lossState >> 17;
+    lossState ^= lossState << 5;
+    return lossState % 100 < pct;
+}
+
+/**
+ * @brief Trame d'action 802.11 qui porte une trame ESP-NOW, remise au
+ * rappel de promiscuité
+ */
+static void sniff(const SimFrame& frame) {
+    static const uint8_t ESPRESSIF_OUI[3] = {0x18, 0xFE, 0x34};
+    static const size_t BODY = 24 + 1 + 3 + 4 + 7;  // Header, category, OUI, random, vendor element
+    if (!promiscuous || promiscuousCallback == nullptr || (promiscuousMask & WIFI_PROMIS_FILTER_MASK_MGMT) == 0) {
+        return;
+    }
+    uint8_t buffer[sizeof(wifi_promiscuous_pkt_t) + BODY + ESP_NOW_MAX_DATA_LEN + 4] = {};
+    wifi_promiscuous_pkt_t* packet = (wifi_promiscuous_pkt_t*)buffer;
+    packet->rx_ctrl.rssi = SIM_RSSI_DBM;
+    packet->rx_ctrl.channel = frame.channel;
+    packet->rx_ctrl.sig_len = BODY + frame.len + 4;
+    uint8_t* p = packet->payload;
+    p[0] = 0xD0;                                    // Action frame
+    memset(p + 4, 0xFF, 6);                         // Destination: broadcast
+    memcpy(p + 10, frame.mac, 6);                   // Source
+    memset(p + 16, 0xFF, 6);                        // BSSID
+    p[24] = 0x7F;                                   // Vendor-specific category
+    memcpy(p + 25, ESPRESSIF_OUI, 3);
+    p[32] = 0xDD;                                   // Vendor element
+    p[33] = (uint8_t)(5 + frame.len);
+    memcpy(p + 34, ESPRESSIF_OUI, 3);
+    p[37] = 0x04;                                   // ESP-NOW
+    p[38] = 0x01;                                   // Version
+    memcpy(p + BODY, frame.data, frame.len);
+    promiscuousCallback(buffer, WIFI_PKT_MGMT);
+}
+
+// ============================================================================
+// ESP-NOW
+// ============================================================================
+
+esp_err_t esp_now_init() {
+    initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_deinit() {
+    initialized = false;
+    sendCallback = nullptr;
+    recvCallback = nullptr;
+    peers.clear();
+    return ESP_OK;
+}
+
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t cb) {
+    sendCallback = cb;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb) {
+    recvCallback = cb;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_unregister_recv_cb() {
+    recvCallback = nullptr;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer) {
+    if (!initialized) {
+        return ESP_ERR_ESPNOW_NOT_INIT;
+    }
+    peers.insert(std::string((const char*)peer->peer_addr, ESP_NOW_ETH_ALEN));
+    return ESP_OK;
+}
+
+esp_err_t esp_now_del_peer(const uint8_t* peerAddr) {
+    peers.erase(std::string((const char*)peerAddr, ESP_NOW_ETH_ALEN));
+    return ESP_OK;
+}
+
+bool esp_now_is_peer_exist(const uint8_t* peerAddr) {
+    return peers.count(std::string((const char*)peerAddr, ESP_NOW_ETH_ALEN)) > 0;
+}
+
+esp_err_t esp_now_send(const uint8_t* peerAddr, const uint8_t* data, size_t len) {
+    if (!initialized) {
+        return ESP_ERR_ESPNOW_NOT_INIT;
+    }
+    if (data == nullptr || len == 0 || len > ESP_NOW_MAX_DATA_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    (void)peerAddr;  // Broadcast medium: every listener on the channel hears it
+
+    SimFrame frame;
+    frame.timeUs = Sim::nowUs();
+    uint64_t doneUs = frame.timeUs;
+    if (Sim::options().radioAirtime) {
+        // LR frame: 400 us preamble, 32 us per byte with 43 bytes of 802.11 and ESP-NOW headers
+        frame.timeUs = std::max(frame.timeUs, airBusyUntilUs);
+        doneUs = frame.timeUs + 400 + (len + 43) * 32;
+        airBusyUntilUs = doneUs;
+    }
+    frame.channel = wifiChannel;
+    memcpy(frame.mac, Sim::options().mac, 6);
+    frame.len = (uint8_t)len;
+    memcpy(frame.data, data, len);
+    if (Sim::radio() != nullptr) {
+        Sim::radio()->transmit(frame);
+    }
+    Sim::counters().framesSent++;
+    Sim::frameSent(frame);
+    sendCallbackUs.push_back(doneUs);
+    return ESP_OK;
+}
+
+/**
+ * @brief Heure du prochain rappel d'envoi (UINT64_MAX = aucun)
+ */
+uint64_t Sim::nextSendCallbackUs() {
+    return sendCallbackUs.empty() ? UINT64_MAX : sendCallbackUs.front();
+}
+
+/**
+ * @brief Rappels d'envoi en attente puis trames reçues arrivées
+ */
+void Sim::deliverRadio(uint64_t nowUs) {
+    static const uint8_t BROADCAST[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    while (!sendCallbackUs.empty() && sendCallbackUs.front() <= nowUs) {
+        sendCallbackUs.pop_front();
+        if (sendCallback != nullptr) {
+            sendCallback(BROADCAST, ESP_NOW_SEND_SUCCESS);
+        }
+    }
+
+    RadioLink* link = radio();
+    if (link == nullptr) {
+        return;
+    }
+    SimFrame frame;
+    while (link->poll(nowUs, frame)) {
+        if (memcmp(frame.mac, options().mac, 6) == 0) {
+            continue;  // Own frame (capture fed back)
+        }
+        if (frame.channel != wifiChannel) {
+            counters().framesOffChannel++;
+            continue;
+        }
+        if (frameLost()) {
+            counters().framesLost++;
+            continue;
+        }
+        counters().framesReceived++;
+        sniff(frame);
+        if (initialized && recvCallback != nullptr) {
+            recvCallback(frame.mac, frame.data, frame.len);
+        }
+    }
+}
+
+// ============================================================================
+// WiFi
+// ============================================================================
+
+esp_err_t esp_wifi_set_protocol(wifi_interface_t ifx, uint8_t protocolBitmap) {
+    (void)ifx;
+    wifiProtocol = protocolBitmap;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_protocol(wifi_interface_t ifx, uint8_t* protocolBitmap) {
+    (void)ifx;
+    *protocolBitmap = wifiProtocol;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_max_tx_power(int8_t power) {
+    (void)power;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t second) {
+    (void)second;
+    if (primary < 1 || primary > 13) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    wifiChannel = primary;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_channel(uint8_t* primary, wifi_second_chan_t* second) {
+    *primary = wifiChannel;
+    if (second != nullptr) {
+        *second = WIFI_SECOND_CHAN_NONE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_ps(wifi_ps_type_t type) {
+    (void)type;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_promiscuous(bool enable) {
+    promiscuous = enable;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_promiscuous_filter(const wifi_promiscuous_filter_t* filter) {
+    promiscuousMask = filter->filter_mask;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_promiscuous_rx_cb(wifi_promiscuous_cb_t cb) {
+    promiscuousCallback = cb;
+    return ESP_OK;
+}
+
+uint8_t simWifiChannel() {
+    return wifiChannel;
+}
+
+uint8_t* WiFiClass::macAddress(uint8_t* mac) {
+    memcpy(mac, Sim::options().mac, 6);
+    return mac;
+}
+
+String WiFiClass::macAddress() {
+    const uint8_t* mac = Sim::options().mac;
+    char text[18];
+    snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    return String(text);
+}
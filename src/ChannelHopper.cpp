@@ -0,0 +1,169 @@
+/**
+ * @file ChannelHopper.cpp
+ * @brief Implémentation du saut de canal du bateau
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Le canal est choisi à chaque loop() sur l'heure disciplinée : le
+ * changement de seconde est vu au plus tard au loop() suivant, que
+ * PowerManager réveille à l'heure (getNextHop()). Le retard de chaque saut
+ * sur sa seconde GPS est mesuré et affiché avec l'état.
+ */
+
+#include "ChannelHopper.h"
+#include <esp_timer.h>
+
+/**
+ * @brief Constructeur : pas de saut, canal 1
+ */
+ChannelHopper::ChannelHopper()
+    : group(0), homeChannel(1), synced(false), nextHopLocalUs(0), hops(0), failures(0), deferred(0),
+      lastDeferredSecond(-1), lateSumUs(0), lateMaxUs(0), lateCount(0) {
+}
+
+/**
+ * @brief Applique la configuration de flotte
+ * @param channelMask Canaux parcourus (0 = canal fixe)
+ * @param groups Nombre de groupes
+ * @param slotIndex Slot TDMA du bateau
+ * @param homeChannel Canal sans saut ou sans heure GPS
+ *
+ * @details
+ * Config::isConsistent() a déjà refusé un masque d'un seul canal ou plus
+ * de groupes que de canaux : un plan invalide ici désactive le saut.
+ */
+void ChannelHopper::configure(uint16_t channelMask, uint8_t groups, uint8_t slotIndex, uint8_t homeChannel) {
+    if (!schedule.configure(channelMask, groups)) {
+        schedule.configure(0, 1);
+    }
+    group = slotIndex % schedule.getGroups();
+    this->homeChannel = homeChannel;
+    if (schedule.isEnabled()) {
+        Serial.printf("✓ Channel hop: %u channels, group %u/%u\n", schedule.getCount(), group,
+                      schedule.getGroups());
+    }
+}
+
+/**
+ * @brief Saut de canal configuré
+ */
+bool ChannelHopper::isEnabled() const {
+    return schedule.isEnabled();
+}
+
+/**
+ * @brief Passe sur le canal de la seconde GPS courante
+ * @param comm Radio
+ * @param clock Horloge disciplinée
+ *
+ * @details
+ * Sans saut ou sans heure GPS : canal de la clé 3. Le retard d'un saut
+ * n'est compté que s'il suit une seconde déjà synchronisée (le premier
+ * saut après la synchronisation tombe n'importe où dans la seconde).
+ * Pendant la garde, les files d'émission de Communication sont retenues.
+ */
+void ChannelHopper::update(Communication& comm, const TimeBeacon& clock) {
+    int64_t localUs = esp_timer_get_time();
+    int64_t gpsUs = 0;
+    bool wasSynced = synced;
+    synced = schedule.isEnabled() && clock.getGpsTimeUs(localUs, gpsUs);
+
+    uint8_t target = homeChannel;
+    int64_t intoSecond = 0;
+    if (synced) {
+        target = schedule.channelAt(gpsUs, group);
+        intoSecond = gpsUs % ChannelHop::DWELL_US;
+        nextHopLocalUs = localUs + ChannelHop::DWELL_US - intoSecond;
+    }
+    comm.setTxOpen(!synced || !ChannelHop::inGuard(gpsUs));
+    if (target == comm.getChannel()) {
+        return;
+    }
+    if (!comm.hopChannel(target)) {
+        failures++;
+        return;
+    }
+    if (synced && wasSynced) {
+        hops++;
+        lateSumUs += (uint32_t)intoSecond;
+        lateCount++;
+        if ((uint32_t)intoSecond > lateMaxUs) {
+            lateMaxUs = (uint32_t)intoSecond;
+        }
+    }
+}
+
+/**
+ * @brief Émission permise maintenant
+ * @param clock Horloge disciplinée
+ * @return false à moins de ChannelHop::GUARD_US d'un saut
+ *
+ * @details
+ * Appelée à chaque loop() tant que la trame attend : un seul report
+ * compté par saut.
+ */
+bool ChannelHopper::canTransmit(const TimeBeacon& clock) {
+    int64_t gpsUs = 0;
+    if (!schedule.isEnabled() || !clock.getGpsTimeUs(esp_timer_get_time(), gpsUs) ||
+        !ChannelHop::inGuard(gpsUs)) {
+        return true;
+    }
+    int64_t hopSecond = (gpsUs + ChannelHop::GUARD_US) / ChannelHop::DWELL_US;
+    if (hopSecond != lastDeferredSecond) {
+        lastDeferredSecond = hopSecond;
+        deferred++;
+    }
+    return false;
+}
+
+/**
+ * @brief Retourne millis() du prochain saut
+ * @param now millis() courant
+ */
+uint32_t ChannelHopper::getNextHop(uint32_t now) const {
+    if (!synced) {
+        return now + 1000;
+    }
+    int64_t untilUs = nextHopLocalUs - esp_timer_get_time();
+    if (untilUs <= 0) {
+        return now;
+    }
+    return now + (uint32_t)((untilUs + 999) / 1000);
+}
+
+/**
+ * @brief Affiche les statistiques de saut (rien sans saut)
+ */
+void ChannelHopper::printReport() {
+    if (!schedule.isEnabled()) {
+        return;
+    }
+    Serial.printf("Channel hop: group %u/%u on %u channels, %s, %lu hops (%lu failed), %lu frames delayed",
+                  group, schedule.getGroups(), schedule.getCount(), synced ? "GPS time" : "home channel",
+                  hops, failures, deferred);
+    if (lateCount > 0) {
+        Serial.printf(", hop delay avg %lu us max %lu us", lateSumUs / lateCount, lateMaxUs);
+    }
+    Serial.println();
+    lateSumUs = 0;
+    lateMaxUs = 0;
+    lateCount = 0;
+}
@@ -30,9 +30,11 @@
  * - Retry automatique en cas d'échec de transmission
  * - Numéro de séquence pour détection de perte de paquets
  * - Puissance TX maximale (21 dBm) pour portée optimale
+ * - Ordonnanceur par classe de trafic devant esp_now_send() (TxScheduler)
  */
 
 #include "Communication.h"
+#include <esp_timer.h>
 
 // Static member initialization
 Communication* Communication::instance = nullptr;
@@ -45,9 +47,13 @@ Communication* Communication::instance = nullptr;
  * le buffer MAC. Le pointeur statique d'instance est
  * utilisé pour le callback ESP-NOW.
  */
-Communication::Communication() : sequenceCounter(0) {
+Communication::Communication()
+    : sequenceCounter(0), rateDeciHz(10), channel(1), rxQueue(nullptr), rxDropped(0), sendsQueued(0), sendsDone(0),
+      timedTicket(0), timedSendUs(0), timedSendOk(false), timedReady(false), txOpen(true), failedId(0),
+      sendsCollected(0), sendsLost(0), lastDone(0), lastDoneUs(0) {
     instance = this;
     memset(localMAC, 0, sizeof(localMAC));
+    memset(ringId, 0, sizeof(ringId));
 }
 
 /**
@@ -58,15 +64,15 @@ Communication::Communication() : sequenceCounter(0) {
  * Configuration:
  * - WiFi en mode Station (sans connexion)
  * - Puissance TX maximale (84 = 21 dBm)
- * - Canal WiFi 1 (modifiable pour éviter interférences)
+ * - Canal WiFi configurable (1 par défaut, modifiable par config flotte)
  * - Adresse broadcast FF:FF:FF:FF:FF:FF
- * - Callback d'envoi enregistré
+ * - Callbacks d'envoi et de réception enregistrés
  * 
  * Note: En mode broadcast, ESP-NOW ne fournit PAS d'ACK
  * des récepteurs. Le callback indique uniquement si le
  * paquet a été transmis par la couche radio.
  */
-bool Communication::begin() {
+bool Communication::begin(uint8_t channel) {
     // Configure WiFi in Station mode
     WiFi.mode(WIFI_STA);
     WiFi.disconnect();
@@ -88,8 +94,9 @@ bool Communication::begin() {
     // Set maximum TX power for best range (84 = 21 dBm = maximum power)
     esp_wifi_set_max_tx_power(84);
     
-    // Set WiFi to channel 1 for consistency (can be changed to avoid interference)
-    esp_wifi_set_channel(1, WIFI_SECOND_CHAN_NONE);
+    // Set WiFi channel (1 by default, can be changed by fleet config to avoid interference)
+    esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE);
+    this->channel = channel;
     
     // Get local MAC address
     WiFi.macAddress(localMAC);
@@ -111,6 +118,14 @@ bool Communication::begin() {
     // Register send callback
     esp_now_register_send_cb(onDataSent);
     
+    // Register receive callback (frames are queued and processed in loop())
+    rxQueue = xQueueCreate(RX_QUEUE_DEPTH, sizeof(ReceivedFrame));
+    if (rxQueue == nullptr) {
+        Serial.println("✗ ESP-NOW: Failed to create receive queue");
+        return false;
+    }
+    esp_now_register_recv_cb(onDataRecv);
+    
     // Add broadcast peer
     esp_now_peer_info_t peerInfo = {};
     memset(&peerInfo, 0, sizeof(peerInfo));
@@ -158,7 +173,8 @@ bool Communication::broadcastGPSData(const GPSData& data, const String& boatName
     
     // Prepare broadcast packet
     GPSBroadcastPacket packet;
-    packet.messageType = 1;           // 1 = Boat GPS data
+    memset(&packet, 0, sizeof(packet));
+    packet.messageType = MSG_BOAT;    // 1 = Boat GPS data
     
     // Use custom boat name or MAC address
     strncpy(packet.name, boatName.c_str(), sizeof(packet.name) - 1);
@@ -171,9 +187,8 @@ bool Communication::broadcastGPSData(const GPSData& data, const String& boatName
     packet.heading = data.course;
     packet.satellites = data.satellites;
     packet.ttl = 1; // Original packet, can be relayed once by Hub
-    
-    // Broadcast address
-    uint8_t broadcastAddr[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    packet.rateDeciHz = rateDeciHz;  // Tail padding byte: size unchanged for the Display
+    packet.quality = data.quality;   // Outlier flags, last padding byte
     
     // Try to send with retries
     bool success = false;
@@ -181,9 +196,9 @@ bool Communication::broadcastGPSData(const GPSData& data, const String& boatName
     
     for (attempt = 0; attempt <= retries; attempt++) {
         // Send via ESP-NOW
-        esp_err_t result = esp_now_send(broadcastAddr, (uint8_t*)&packet, sizeof(packet));
+        TxStatus result = transmit(TX_LIVE, (const uint8_t*)&packet, sizeof(packet), false);
         
-        if (result == ESP_OK) {
+        if (result == TX_SENT || result == TX_QUEUED) {
             success = true;
             if (attempt > 0) {
                 Serial.printf("→ Broadcast #%lu: %.6f,%.6f (%.1fkts, %d°, %d sats) [retry %d]\n",
@@ -205,7 +220,8 @@ bool Communication::broadcastGPSData(const GPSData& data, const String& boatName
             }
             break;  // Success, exit loop
         } else {
-            Serial.printf("✗ Broadcast attempt %d failed (error: %d)\n", attempt + 1, result);
+            Serial.printf("✗ Broadcast attempt %d failed (%s)\n", attempt + 1,
+                          result == TX_FAILED ? "radio" : "queue");
             if (attempt < retries) {
                 delay(random(15, 50));  // Random delay before retry (15-50ms) to reduce collision probability
             }
@@ -219,6 +235,314 @@ bool Communication::broadcastGPSData(const GPSData& data, const String& boatName
     return success;
 }
 
+/**
+ * @brief Diffuse une trame brute (une seule tentative)
+ * @param data Octets de la trame (premier octet = MessageType)
+ * @param len Longueur de la trame
+ * @param txClass Classe de trafic (file, priorité, budget d'antenne)
+ * @param frameId Sortie facultative : identifiant de la trame pour
+ *        isTxDone() (0 si refusée)
+ * @return true si la trame a été confiée à la couche radio ou mise en file
+ */
+bool Communication::sendFrame(const uint8_t* data, size_t len, TxClass txClass, uint32_t* frameId) {
+    if (frameId != nullptr) {
+        *frameId = 0;
+    }
+    if (len == 0 || len > ESP_NOW_MAX_DATA_LEN) {
+        return false;
+    }
+    
+    TxStatus result = transmit(txClass, data, len, false, frameId);
+    if (result == TX_REFUSED || result == TX_FAILED) {
+        Serial.printf("✗ Frame type %d send failed (%s)\n", (int8_t)data[0],
+                      result == TX_FAILED ? "radio" : "queue full");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Diffuse une trame et mesure la fin de son émission
+ * @param data Octets de la trame (premier octet = MessageType)
+ * @param len Longueur de la trame
+ * @return true si la trame a été confiée à la couche radio ou mise en file
+ * 
+ * @details
+ * Les rappels d'envoi arrivent dans l'ordre des envois acceptés : le
+ * ticket est le numéro d'ordre du rappel de cette trame. Il est posé par
+ * service() juste avant esp_now_send(), le rappel pouvant arriver avant
+ * son retour (autre cœur). L'attente en file (classe TX_TIME) fait partie
+ * de l'attente d'émission mesurée.
+ */
+bool Communication::sendTimedFrame(const uint8_t* data, size_t len) {
+    if (len == 0 || len > ESP_NOW_MAX_DATA_LEN) {
+        return false;
+    }
+    
+    TxStatus result = transmit(TX_TIME, data, len, true);
+    if (result == TX_REFUSED || result == TX_FAILED) {
+        Serial.printf("✗ Frame type %d send failed (%s)\n", (int8_t)data[0],
+                      result == TX_FAILED ? "radio" : "queue full");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Heure locale du rappel d'envoi de la dernière trame horodatée
+ * @param localUs esp_timer_get_time() dans le rappel
+ * @return true une fois par trame, si le rappel a signalé une émission
+ */
+bool Communication::getTimedSendUs(int64_t& localUs) {
+    if (!timedReady) {
+        return false;
+    }
+    localUs = timedSendUs;
+    timedReady = false;
+    return timedSendOk;
+}
+
+/**
+ * @brief Range une trame dans sa classe et envoie ce que l'ordonnanceur permet
+ * @param txClass Classe de trafic
+ * @param data Octets de la trame
+ * @param len Longueur de la trame
+ * @param timed Heure du rappel d'envoi demandée (sendTimedFrame())
+ * @param frameId Sortie facultative : identifiant de la trame (0 si refusée)
+ * @return Sort de cette trame seulement : une erreur du pilote sur une
+ *         autre trame, envoyée par le même appel, est comptée dans les
+ *         statistiques de sa classe (failed)
+ */
+TxStatus Communication::transmit(TxClass txClass, const uint8_t* data, size_t len, bool timed,
+                                 uint32_t* frameId) {
+    uint32_t id = scheduler.push(txClass, data, len, timed, esp_timer_get_time());
+    if (frameId != nullptr) {
+        *frameId = id;
+    }
+    if (id == 0) {
+        return TX_REFUSED;
+    }
+    service();
+    if (scheduler.isQueued(id)) {
+        return TX_QUEUED;
+    }
+    return failedId == id ? TX_FAILED : TX_SENT;
+}
+
+/**
+ * @brief Confie au pilote les trames que l'ordonnanceur laisse partir
+ * 
+ * @details
+ * Seules les trames acceptées donnent un rappel d'envoi : le compteur
+ * permet d'associer un rappel à sa trame (sendTimedFrame(), latences).
+ * Une trame refusée par le pilote est perdue (comptée failed) ; les
+ * suivantes attendent le prochain appel.
+ */
+void Communication::service() {
+    int64_t nowUs = esp_timer_get_time();
+    collectSent(nowUs);
+    if (!txOpen) {
+        return;
+    }
+    
+    uint8_t broadcastAddr[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    const TxFrame* frame;
+    while ((frame = scheduler.peek(nowUs, getInFlight())) != nullptr) {
+        uint32_t ticket = sendsQueued + 1;
+        ringClass[ticket % TX_RING] = frame->txClass;
+        ringId[ticket % TX_RING] = frame->id;
+        ringQueuedUs[ticket % TX_RING] = frame->queuedUs;
+        if (frame->timed) {
+            timedReady = false;
+            timedTicket = ticket;
+        }
+        uint32_t id = frame->id;
+        esp_err_t result = esp_now_send(broadcastAddr, frame->data, frame->len);
+        scheduler.pop(nowUs, result == ESP_OK);
+        if (result != ESP_OK) {
+            failedId = id;
+            if (timedTicket == ticket) {
+                timedTicket = 0;
+            }
+            break;
+        }
+        sendsQueued++;
+    }
+}
+
+/**
+ * @brief Autorise ou retient toutes les émissions (garde du saut de canal)
+ * @param open false = les trames restent en file
+ */
+void Communication::setTxOpen(bool open) {
+    txOpen = open;
+}
+
+/**
+ * @brief Des trames attendent dans les files d'émission
+ */
+bool Communication::hasPendingTx() const {
+    return scheduler.hasPending();
+}
+
+/**
+ * @brief Une trame est partie : rappel d'envoi reçu, refusée ou abandonnée
+ * @param frameId Identifiant rendu par sendFrame()
+ * @return false tant que la trame est en file ou chez le pilote
+ * 
+ * @details
+ * Les trames chez le pilote sont les getInFlight() derniers tickets : une
+ * trame dont le rappel est compté perdu (collectSent()) est partie.
+ */
+bool Communication::isTxDone(uint32_t frameId) {
+    collectSent(esp_timer_get_time());
+    if (scheduler.isQueued(frameId)) {
+        return false;
+    }
+    uint8_t inFlight = getInFlight();
+    for (uint8_t i = 0; i < inFlight && i < TX_RING; i++) {
+        if (ringId[(sendsQueued - i) % TX_RING] == frameId) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief millis() auquel service() pourra envoyer une trame en attente
+ * @param now millis() courant
+ * @return now + 1 si une trame n'attend que le pilote, plus tard si elle attend un budget
+ */
+uint32_t Communication::getNextTx(uint32_t now) {
+    int64_t nowUs = esp_timer_get_time();
+    int64_t at = scheduler.getNextReleaseUs(nowUs);
+    if (at == INT64_MAX) {
+        return now + 1000;
+    }
+    int64_t untilMs = (at - nowUs + 999) / 1000;
+    return now + (uint32_t)(untilMs < 1 ? 1 : untilMs);
+}
+
+/**
+ * @brief Compteurs et latences d'une classe de trafic
+ */
+const TxClassStats& Communication::getTxStats(TxClass txClass) const {
+    return scheduler.getStats(txClass);
+}
+
+/**
+ * @brief Affiche le rapport des files d'émission (mise à jour d'état)
+ */
+void Communication::printTxReport() {
+    scheduler.printReport();
+    if (sendsLost != 0) {
+        Serial.printf("TX: %lu send callbacks missing\n", sendsLost);
+    }
+}
+
+/**
+ * @brief Trames confiées au pilote sans rappel d'envoi
+ * 
+ * @details
+ * Un rappel arrivé après SEND_CALLBACK_TIMEOUT_US (trame comptée perdue
+ * par collectSent()) réduit d'autant le nombre de trames perdues.
+ */
+uint8_t Communication::getInFlight() {
+    uint32_t pending = sendsQueued - sendsDone;
+    if (pending < sendsLost) {
+        sendsLost = pending;
+    }
+    pending -= sendsLost;
+    return pending > 255 ? 255 : (uint8_t)pending;
+}
+
+/**
+ * @brief Note les latences des rappels d'envoi arrivés depuis le dernier appel
+ * @param nowUs esp_timer_get_time()
+ * 
+ * @details
+ * Sans rappel pendant SEND_CALLBACK_TIMEOUT_US alors que des trames sont
+ * chez le pilote, elles sont comptées perdues : l'ordonnanceur ne reste
+ * pas bloqué sur un rappel qui ne viendra pas.
+ */
+void Communication::collectSent(int64_t nowUs) {
+    uint32_t done = sendsDone;
+    while (sendsCollected != done) {
+        sendsCollected++;
+        uint8_t slot = sendsCollected % TX_RING;
+        scheduler.recordDone(ringClass[slot], ringDoneUs[slot] - ringQueuedUs[slot]);
+    }
+    
+    if (done != lastDone || getInFlight() == 0) {
+        lastDone = done;
+        lastDoneUs = nowUs;
+    } else if (nowUs - lastDoneUs > SEND_CALLBACK_TIMEOUT_US) {
+        sendsLost = sendsQueued - done;
+        lastDoneUs = nowUs;
+    }
+}
+
+/**
+ * @brief Récupère la prochaine trame reçue (non bloquant)
+ * @param frame Trame de sortie
+ * @return true si une trame était disponible
+ */
+bool Communication::receive(ReceivedFrame& frame) {
+    if (rxQueue == nullptr) {
+        return false;
+    }
+    return xQueueReceive(rxQueue, &frame, 0) == pdTRUE;
+}
+
+/**
+ * @brief Change le canal ESP-NOW
+ * @param channel Canal WiFi (1-13)
+ * @return true si le canal a été appliqué
+ * 
+ * @details
+ * Le peer broadcast est enregistré avec channel = 0 (canal courant),
+ * il suit donc automatiquement le nouveau canal.
+ */
+bool Communication::setChannel(uint8_t channel) {
+    if (channel < 1 || channel > 13) {
+        return false;
+    }
+    if (esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE) != ESP_OK) {
+        Serial.printf("✗ ESP-NOW: Failed to switch to channel %d\n", channel);
+        return false;
+    }
+    Serial.printf("✓ ESP-NOW: Channel %d\n", channel);
+    this->channel = channel;
+    return true;
+}
+
+/**
+ * @brief Change de canal pour le saut de canal
+ * @param channel Canal WiFi (1-13)
+ * @return true si le canal a été appliqué
+ * 
+ * @details
+ * Comme setChannel(), sans ligne de journal : appelé à chaque seconde
+ * GPS par ChannelHopper.
+ */
+bool Communication::hopChannel(uint8_t channel) {
+    if (channel < 1 || channel > 13) {
+        return false;
+    }
+    if (esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE) != ESP_OK) {
+        return false;
+    }
+    this->channel = channel;
+    return true;
+}
+
+/**
+ * @brief Retourne le canal ESP-NOW courant
+ */
+uint8_t Communication::getChannel() const {
+    return channel;
+}
+
 /**
  * @brief Copie l'adresse MAC locale dans le buffer fourni
  * @param mac Buffer de sortie (6 octets)
@@ -235,9 +559,25 @@ uint32_t Communication::getSequenceNumber() const {
     return sequenceCounter;
 }
 
+/**
+ * @brief Règle la cadence annoncée dans les paquets GPS
+ * @param rateDeciHz Cadence en 0,1 Hz
+ */
+void Communication::setRateDeciHz(uint8_t rateDeciHz) {
+    this->rateDeciHz = rateDeciHz;
+}
+
+/**
+ * @brief Retourne le nombre de trames reçues perdues (file pleine)
+ * @return Compteur de pertes depuis le démarrage
+ */
+uint32_t Communication::getRxDropped() const {
+    return rxDropped;
+}
+
 /**
  * @brief Callback ESP-NOW appelé après tentative d'envoi
- * @param mac Adresse MAC du destinataire
+ * @param mac Adresse MAC du destinataire (inutilisée : un seul pair, broadcast)
  * @param status Statut de l'envoi (ESP_NOW_SEND_SUCCESS ou ESP_NOW_SEND_FAIL)
  * 
  * @details
@@ -246,6 +586,7 @@ uint32_t Communication::getSequenceNumber() const {
  * a été transmis par la couche radio, pas s'il a été reçu.
  */
 void Communication::onDataSent(const uint8_t* mac, esp_now_send_status_t status) {
+    (void)mac;
     if (instance) {
         instance->handleSendCallback(status);
     }
@@ -257,12 +598,65 @@ void Communication::onDataSent(const uint8_t* mac, esp_now_send_status_t status)
  * 
  * @details
  * Affiche un avertissement si la transmission a échoué au niveau radio.
- * Cette fonction peut être étendue pour implémenter des statistiques
- * d'envoi ou des actions de récupération.
+ * L'heure de fin d'émission est prise en premier (tâche WiFi) : latence
+ * de la trame pour l'ordonnanceur, heure d'émission de la trame horodatée.
  */
 void Communication::handleSendCallback(esp_now_send_status_t status) {
+    int64_t nowUs = esp_timer_get_time();
+    uint32_t done = sendsDone + 1;
+    ringDoneUs[done % TX_RING] = nowUs;
+    sendsDone = done;
+    if (done == timedTicket) {
+        timedSendUs = nowUs;
+        timedSendOk = (status == ESP_NOW_SEND_SUCCESS);
+        timedTicket = 0;
+        timedReady = true;
+    }
+    
     // Optional: handle send status
     if (status != ESP_NOW_SEND_SUCCESS) {
         Serial.println("⚠️  ESP-NOW: Send callback reported failure");
     }
 }
+
+/**
+ * @brief Callback ESP-NOW appelé à la réception d'une trame
+ * @param mac Adresse MAC de l'émetteur
+ * @param data Données reçues
+ * @param len Longueur des données
+ * 
+ * @details
+ * Fonction statique servant de pont vers la méthode d'instance.
+ */
+void Communication::onDataRecv(const uint8_t* mac, const uint8_t* data, int len) {
+    if (instance) {
+        instance->handleRecvCallback(mac, data, len);
+    }
+}
+
+/**
+ * @brief Gère le callback de réception ESP-NOW
+ * @param mac Adresse MAC de l'émetteur
+ * @param data Données reçues
+ * @param len Longueur des données
+ * 
+ * @details
+ * Exécuté dans la tâche WiFi : la trame est seulement copiée dans
+ * la file de réception, le traitement se fait dans loop().
+ * Aucun affichage Serial ici pour ne pas bloquer la pile radio.
+ */
+void Communication::handleRecvCallback(const uint8_t* mac, const uint8_t* data, int len) {
+    if (rxQueue == nullptr || len <= 0 || len > ESP_NOW_MAX_DATA_LEN) {
+        return;
+    }
+    
+    ReceivedFrame frame;
+    memcpy(frame.mac, mac, 6);
+    frame.len = (uint8_t)len;
+    memcpy(frame.data, data, len);
+    frame.receivedAt = millis();
+    
+    if (xQueueSend(rxQueue, &frame, 0) != pdTRUE) {
+        rxDropped++;
+    }
+}
@@ -0,0 +1,519 @@
+/**
+ * @file Config.cpp
+ * @brief Implémentation de la configuration de flotte
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Vérifie, applique et persiste les trames ConfigPushPacket.
+ *
+ * Séquence de traitement d'une trame:
+ * 1. Contrôle de taille et d'adressage (tous / liste de MAC)
+ * 2. Vérification HMAC-SHA256 tronqué (16 octets) avec la clé de flotte
+ * 3. Contrôle de version (strictement croissante)
+ * 4. Application des deltas sur une copie, validation croisée
+ * 5. Écriture NVS (un seul blob → atomique) puis bascule en RAM
+ *
+ * Format du blob NVS "config":
+ * - uint32_t version
+ * - N × ConfigDelta (clé, valeur) pour chaque clé persistée
+ * Les clés inconnues au chargement sont ignorées, les clés absentes
+ * gardent leur valeur par défaut (compatibilité entre versions firmware).
+ */
+
+#include "Config.h"
+#include <Preferences.h>
+#include <mbedtls/md.h>
+#include <ChannelHop.h>
+
+// Static constants
+const char* Config::PREF_NAMESPACE = "boatgps";
+const char* Config::PREF_CONFIG = "config";
+const char* Config::PREF_FLEET_KEY = "fleet_key";
+
+// Keys written to NVS (CFG_TDMA_SLOT_FROM_TARGET is resolved into CFG_TDMA_SLOT_INDEX)
+static const uint8_t PERSISTED_KEYS[] = {
+    CFG_BROADCAST_INTERVAL_MS,
+    CFG_BROADCAST_JITTER_MS,
+    CFG_WIFI_CHANNEL,
+    CFG_TDMA_SLOT_COUNT,
+    CFG_TDMA_SLOT_INDEX,
+    CFG_POWER_PROFILE,
+    CFG_GNSS_POWER_SAVE,
+    CFG_ADAPTIVE_RATE,
+    CFG_CHANNEL_BUDGET,
+    CFG_START_COUNTDOWN_S,
+    CFG_START_WINDOW_S,
+    CFG_START_INTERVAL_MS,
+    CFG_LINE_COMMITTEE_LAT,
+    CFG_LINE_COMMITTEE_LON,
+    CFG_LINE_PIN_LAT,
+    CFG_LINE_PIN_LON,
+    CFG_TRACK_TOLERANCE_CM,
+    CFG_PROXIMITY_TCPA_S,
+    CFG_TIME_BEACON_MS,
+    CFG_HOP_CHANNELS,
+    CFG_HOP_GROUPS
+};
+static const size_t PERSISTED_KEY_COUNT = sizeof(PERSISTED_KEYS) / sizeof(PERSISTED_KEYS[0]);
+static const size_t MAX_STORED_KEYS = 64;  // Upper bound when reading blobs from newer firmware
+
+/**
+ * @brief Constructeur : valeurs usine
+ *
+ * @details
+ * Valeurs identiques au comportement historique du firmware:
+ * 1 Hz, jitter ±100 ms, canal 1, TDMA désactivé, 240 MHz sans veille.
+ */
+Config::Config() : fleetKeyLen(0), rejectedFrames(0) {
+    current.version = 0;
+    current.broadcastIntervalMs = 1000;
+    current.broadcastJitterMs = 100;
+    current.wifiChannel = 1;
+    current.tdmaSlotCount = 0;
+    current.tdmaSlotIndex = 0;
+    current.powerProfile = 0;  // POWER_PERFORMANCE
+    current.gnssPowerSave = 0;
+    current.adaptiveRate = 0;
+    current.channelBudget = 20;  // 2 Hz average
+    current.startCountdownS = 300;
+    current.startWindowS = 60;
+    current.startIntervalMs = 200;
+    current.lineCommitteeLat = 0;  // Line set with the button
+    current.lineCommitteeLon = 0;
+    current.linePinLat = 0;
+    current.linePinLon = 0;
+    current.trackToleranceCm = 200;  // 2 m
+    current.proximityTcpaS = 10;
+    current.timeBeaconMs = 0;  // No time beacon
+    current.hopChannels = 0;   // Fixed channel
+    current.hopGroups = 1;
+    memset(fleetKey, 0, sizeof(fleetKey));
+}
+
+/**
+ * @brief Charge la configuration et la clé de flotte depuis la NVS
+ * @return true si une configuration enregistrée a été chargée
+ *
+ * @details
+ * La clé de flotte ("fleet_key") est provisionnée via M5Burner.
+ * Sans clé, les trames de configuration sont refusées (CONFIG_NO_KEY).
+ */
+bool Config::begin() {
+    Preferences prefs;
+    prefs.begin(PREF_NAMESPACE, true);  // Read-only
+
+    String key = prefs.getString(PREF_FLEET_KEY, "");
+    fleetKeyLen = key.length() < sizeof(fleetKey) ? key.length() : sizeof(fleetKey);
+    memcpy(fleetKey, key.c_str(), fleetKeyLen);
+
+    bool loaded = false;
+    size_t blobLen = prefs.getBytesLength(PREF_CONFIG);
+    if (blobLen >= sizeof(uint32_t)) {
+        uint8_t blob[sizeof(uint32_t) + MAX_STORED_KEYS * sizeof(ConfigDelta)];
+        size_t len = prefs.getBytes(PREF_CONFIG, blob, blobLen < sizeof(blob) ? blobLen : sizeof(blob));
+
+        BoatConfig stored = current;
+        memcpy(&stored.version, blob, sizeof(uint32_t));
+
+        size_t count = (len - sizeof(uint32_t)) / sizeof(ConfigDelta);
+        for (size_t i = 0; i < count; i++) {
+            ConfigDelta entry;
+            memcpy(&entry, blob + sizeof(uint32_t) + i * sizeof(ConfigDelta), sizeof(entry));
+            setValue(stored, entry.key, entry.value);  // Unknown keys are skipped
+        }
+
+        if (isConsistent(stored)) {
+            current = stored;
+            loaded = true;
+        }
+    }
+    prefs.end();
+
+    Serial.printf("✓ Config: version %lu, %u ms ±%u ms, channel %d, TDMA %d/%d%s\n",
+                  current.version, current.broadcastIntervalMs, current.broadcastJitterMs,
+                  current.wifiChannel, current.tdmaSlotIndex, current.tdmaSlotCount,
+                  loaded ? "" : " (defaults)");
+    if (fleetKeyLen == 0) {
+        Serial.println("  No fleet key - remote configuration disabled");
+    }
+
+    return loaded;
+}
+
+/**
+ * @brief Retourne la configuration active
+ */
+const BoatConfig& Config::get() const {
+    return current;
+}
+
+/**
+ * @brief Vérifie et applique une trame de configuration
+ * @param frame Trame ESP-NOW reçue
+ * @param localMAC Adresse MAC locale (6 octets)
+ * @param ack Acquittement à diffuser (trames authentifiées seulement)
+ * @return Statut du traitement
+ *
+ * @details
+ * Les deltas sont appliqués sur une copie; la configuration active n'est
+ * remplacée que si tous les deltas sont valides (application atomique).
+ * Une trame déjà appliquée (même version) est acquittée sans effet, ce qui
+ * permet au comité de rediffuser la même trame jusqu'à recevoir tous les ACK.
+ *
+ * Une trame non authentifiée (pas de clé, signature fausse) n'est pas
+ * acquittée : n'importe qui pourrait sinon faire émettre toute la flotte
+ * avec une seule trame adressée à tous, autant de fois qu'il le veut.
+ */
+ConfigStatus Config::applyPush(const ReceivedFrame& frame, const uint8_t* localMAC, ConfigAckPacket& ack) {
+    ConfigPushPacket packet;
+    if (frame.len != sizeof(packet)) {
+        return CONFIG_NOT_ADDRESSED;  // Malformed: not worth an ack
+    }
+    memcpy(&packet, frame.data, sizeof(packet));
+
+    // Addressing: all boats or explicit MAC list
+    int targetPosition = -1;
+    if (packet.targetCount > CONFIG_MAX_TARGETS || packet.deltaCount > CONFIG_MAX_DELTAS) {
+        return CONFIG_NOT_ADDRESSED;
+    }
+    for (uint8_t i = 0; i < packet.targetCount; i++) {
+        if (memcmp(packet.targets[i], localMAC, 6) == 0) {
+            targetPosition = i;
+            break;
+        }
+    }
+    if (packet.targetCount > 0 && targetPosition < 0) {
+        return CONFIG_NOT_ADDRESSED;
+    }
+
+    if (fleetKeyLen == 0) {
+        rejectedFrames++;
+        return CONFIG_NO_KEY;
+    }
+    if (!authenticate(frame.data, offsetof(ConfigPushPacket, signature), packet.signature)) {
+        return CONFIG_BAD_SIGNATURE;
+    }
+
+    ack.messageType = MSG_CONFIG_ACK;
+    ack.reserved[0] = 0;
+    ack.reserved[1] = 0;
+    ack.requestedVersion = packet.configVersion;
+
+    ConfigStatus status;
+    if (packet.configVersion == current.version) {
+        status = CONFIG_ALREADY_APPLIED;
+    } else if (packet.configVersion < current.version) {
+        status = CONFIG_STALE_VERSION;
+    } else {
+        // Apply all deltas to a candidate copy
+        BoatConfig candidate = current;
+        candidate.version = packet.configVersion;
+        bool valid = true;
+        for (uint8_t i = 0; i < packet.deltaCount && valid; i++) {
+            const ConfigDelta& delta = packet.deltas[i];
+            if (delta.key == CFG_TDMA_SLOT_FROM_TARGET) {
+                valid = (targetPosition >= 0) &&
+                        setValue(candidate, CFG_TDMA_SLOT_INDEX, delta.value + targetPosition);
+            } else {
+                valid = setValue(candidate, delta.key, delta.value);
+            }
+        }
+
+        if (!valid || !isConsistent(candidate)) {
+            status = CONFIG_INVALID_VALUE;
+        } else {
+            status = persist(candidate) ? CONFIG_APPLIED : CONFIG_PERSIST_FAILED;
+            current = candidate;  // RAM switch even if NVS failed (reported in ack)
+        }
+    }
+
+    ack.status = status;
+    ack.activeVersion = current.version;
+    return status;
+}
+
+/**
+ * @brief Statut auquel répond un ACK
+ * @return false pour une trame adressée à d'autres bateaux ou non authentifiée
+ */
+bool Config::isAcknowledged(ConfigStatus status) {
+    return status != CONFIG_NOT_ADDRESSED && status != CONFIG_BAD_SIGNATURE && status != CONFIG_NO_KEY;
+}
+
+/**
+ * @brief Authentifie une trame du comité avec la clé de flotte
+ * @param data Trame reçue
+ * @param signedLen Octets signés en début de trame (position de la signature)
+ * @param signature Signature portée par la trame (CONFIG_SIGNATURE_LEN octets)
+ * @return false sans clé de flotte ou si la signature est fausse
+ *
+ * @details
+ * Même HMAC que les trames de configuration : le parcours et le compte à
+ * rebours ne sont appliqués (et le parcours enregistré en NVS) que par les
+ * bateaux de la flotte. Comparaison en temps constant.
+ */
+bool Config::authenticate(const uint8_t* data, size_t signedLen, const uint8_t* signature) {
+    uint8_t expected[CONFIG_SIGNATURE_LEN] = {0};
+    uint8_t diff = 0;
+    if (fleetKeyLen == 0 || !computeSignature(data, signedLen, expected)) {
+        diff = 1;
+    }
+    for (uint8_t i = 0; i < CONFIG_SIGNATURE_LEN; i++) {
+        diff |= expected[i] ^ signature[i];
+    }
+    if (diff != 0) {
+        rejectedFrames++;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Trames du comité ignorées faute d'authentification
+ * @return Compteur depuis le démarrage (configuration, parcours, départ)
+ */
+uint32_t Config::getRejectedFrames() const {
+    return rejectedFrames;
+}
+
+/**
+ * @brief Signe une trame de configuration avec la clé de flotte
+ * @param packet Trame à signer (signature écrite en place)
+ * @return false si aucune clé n'est provisionnée
+ */
+bool Config::sign(ConfigPushPacket& packet) const {
+    if (fleetKeyLen == 0) {
+        return false;
+    }
+    return computeSignature((const uint8_t*)&packet, offsetof(ConfigPushPacket, signature), packet.signature);
+}
+
+/**
+ * @brief Calcule le HMAC-SHA256 tronqué de la partie signée
+ * @param data Trame
+ * @param signedLen Octets signés (tous les octets avant la signature)
+ * @param out Sortie CONFIG_SIGNATURE_LEN octets
+ * @return true si le calcul a réussi
+ */
+bool Config::computeSignature(const uint8_t* data, size_t signedLen, uint8_t* out) const {
+    uint8_t digest[32];
+    const mbedtls_md_info_t* info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    if (info == nullptr) {
+        return false;
+    }
+    if (mbedtls_md_hmac(info, fleetKey, fleetKeyLen, data, signedLen, digest) != 0) {
+        return false;
+    }
+    memcpy(out, digest, CONFIG_SIGNATURE_LEN);
+    return true;
+}
+
+/**
+ * @brief Modifie une valeur avec contrôle de plage
+ * @param cfg Configuration candidate
+ * @param key Clé ConfigKey
+ * @param value Nouvelle valeur
+ * @return false si la clé est inconnue ou la valeur hors plage
+ */
+bool Config::setValue(BoatConfig& cfg, uint8_t key, int32_t value) {
+    switch (key) {
+        case CFG_BROADCAST_INTERVAL_MS:
+            if (value < 100 || value > 10000) return false;
+            cfg.broadcastIntervalMs = value;
+            return true;
+        case CFG_BROADCAST_JITTER_MS:
+            if (value < 0 || value > 5000) return false;
+            cfg.broadcastJitterMs = value;
+            return true;
+        case CFG_WIFI_CHANNEL:
+            if (value < 1 || value > 13) return false;
+            cfg.wifiChannel = value;
+            return true;
+        case CFG_TDMA_SLOT_COUNT:
+            if (value < 0 || value > 100) return false;
+            cfg.tdmaSlotCount = value;
+            return true;
+        case CFG_TDMA_SLOT_INDEX:
+            if (value < 0 || value > 99) return false;
+            cfg.tdmaSlotIndex = value;
+            return true;
+        case CFG_POWER_PROFILE:
+            if (value < 0 || value > 2) return false;
+            cfg.powerProfile = value;
+            return true;
+        case CFG_GNSS_POWER_SAVE:
+            if (value < 0 || value > 1) return false;
+            cfg.gnssPowerSave = value;
+            return true;
+        case CFG_ADAPTIVE_RATE:
+            if (value < 0 || value > 1) return false;
+            cfg.adaptiveRate = value;
+            return true;
+        case CFG_CHANNEL_BUDGET:
+            if (value < 5 || value > 100) return false;
+            cfg.channelBudget = value;
+            return true;
+        case CFG_START_COUNTDOWN_S:
+            if (value < 30 || value > 900) return false;
+            cfg.startCountdownS = value;
+            return true;
+        case CFG_START_WINDOW_S:
+            if (value < 10 || value > 300) return false;
+            cfg.startWindowS = value;
+            return true;
+        case CFG_START_INTERVAL_MS:
+            if (value < 100 || value > 1000) return false;
+            cfg.startIntervalMs = value;
+            return true;
+        case CFG_LINE_COMMITTEE_LAT:
+            if (value < -900000000 || value > 900000000) return false;
+            cfg.lineCommitteeLat = value;
+            return true;
+        case CFG_LINE_COMMITTEE_LON:
+            if (value < -1800000000 || value > 1800000000) return false;
+            cfg.lineCommitteeLon = value;
+            return true;
+        case CFG_LINE_PIN_LAT:
+            if (value < -900000000 || value > 900000000) return false;
+            cfg.linePinLat = value;
+            return true;
+        case CFG_LINE_PIN_LON:
+            if (value < -1800000000 || value > 1800000000) return false;
+            cfg.linePinLon = value;
+            return true;
+        case CFG_TRACK_TOLERANCE_CM:
+            if (value < 0 || value > 5000) return false;
+            cfg.trackToleranceCm = value;
+            return true;
+        case CFG_PROXIMITY_TCPA_S:
+            if (value < 0 || value > 60) return false;
+            cfg.proximityTcpaS = value;
+            return true;
+        case CFG_TIME_BEACON_MS:
+            if (value != 0 && (value < 200 || value > 60000)) return false;
+            cfg.timeBeaconMs = value;
+            return true;
+        case CFG_HOP_CHANNELS:
+            if (value < 0 || (value & ~ChannelHop::VALID_CHANNELS) != 0) return false;
+            cfg.hopChannels = value;
+            return true;
+        case CFG_HOP_GROUPS:
+            if (value < 1 || value > ChannelHop::MAX_CHANNELS) return false;
+            cfg.hopGroups = value;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Lit une valeur de la configuration
+ * @param cfg Configuration
+ * @param key Clé ConfigKey
+ * @return Valeur courante (0 si clé inconnue)
+ */
+int32_t Config::getValue(const BoatConfig& cfg, uint8_t key) {
+    switch (key) {
+        case CFG_BROADCAST_INTERVAL_MS: return cfg.broadcastIntervalMs;
+        case CFG_BROADCAST_JITTER_MS:   return cfg.broadcastJitterMs;
+        case CFG_WIFI_CHANNEL:          return cfg.wifiChannel;
+        case CFG_TDMA_SLOT_COUNT:       return cfg.tdmaSlotCount;
+        case CFG_TDMA_SLOT_INDEX:       return cfg.tdmaSlotIndex;
+        case CFG_POWER_PROFILE:         return cfg.powerProfile;
+        case CFG_GNSS_POWER_SAVE:       return cfg.gnssPowerSave;
+        case CFG_ADAPTIVE_RATE:         return cfg.adaptiveRate;
+        case CFG_CHANNEL_BUDGET:        return cfg.channelBudget;
+        case CFG_START_COUNTDOWN_S:     return cfg.startCountdownS;
+        case CFG_START_WINDOW_S:        return cfg.startWindowS;
+        case CFG_START_INTERVAL_MS:     return cfg.startIntervalMs;
+        case CFG_LINE_COMMITTEE_LAT:    return cfg.lineCommitteeLat;
+        case CFG_LINE_COMMITTEE_LON:    return cfg.lineCommitteeLon;
+        case CFG_LINE_PIN_LAT:          return cfg.linePinLat;
+        case CFG_LINE_PIN_LON:          return cfg.linePinLon;
+        case CFG_TRACK_TOLERANCE_CM:    return cfg.trackToleranceCm;
+        case CFG_PROXIMITY_TCPA_S:      return cfg.proximityTcpaS;
+        case CFG_TIME_BEACON_MS:        return cfg.timeBeaconMs;
+        case CFG_HOP_CHANNELS:          return cfg.hopChannels;
+        case CFG_HOP_GROUPS:            return cfg.hopGroups;
+        default:                        return 0;
+    }
+}
+
+/**
+ * @brief Validation croisée d'une configuration candidate
+ * @param cfg Configuration candidate
+ * @return true si la configuration est cohérente
+ *
+ * @details
+ * - Le jitter doit rester inférieur à la moitié de l'intervalle
+ * - Avec TDMA, l'index de slot doit exister et chaque slot doit
+ *   durer au moins 10 ms (période de loop()), 5 ms dans la fenêtre
+ *   de départ (le loop() attend alors à la milliseconde)
+ * - La fenêtre rapide ne dépasse pas le compte à rebours
+ * - Saut de canal : au moins deux canaux, pas plus de groupes que de
+ *   canaux
+ */
+bool Config::isConsistent(const BoatConfig& cfg) {
+    if (cfg.broadcastJitterMs * 2 > cfg.broadcastIntervalMs) {
+        return false;
+    }
+    if (cfg.tdmaSlotCount > 0) {
+        if (cfg.tdmaSlotIndex >= cfg.tdmaSlotCount) return false;
+        if (cfg.broadcastIntervalMs / cfg.tdmaSlotCount < 10) return false;
+        if (cfg.startIntervalMs / cfg.tdmaSlotCount < 5) return false;  // Start window slots
+    }
+    if (cfg.startWindowS > cfg.startCountdownS) {
+        return false;
+    }
+    ChannelHop hop;
+    if (!hop.configure(cfg.hopChannels, cfg.hopGroups)) {
+        return false;  // Single channel, or more groups than channels
+    }
+    return true;
+}
+
+/**
+ * @brief Écrit la configuration en NVS (un seul blob)
+ * @param cfg Configuration à persister
+ * @return true si l'écriture a réussi
+ *
+ * @details
+ * Un blob unique garantit qu'une coupure d'alimentation pendant
+ * l'écriture laisse soit l'ancienne, soit la nouvelle configuration.
+ */
+bool Config::persist(const BoatConfig& cfg) {
+    uint8_t blob[sizeof(uint32_t) + PERSISTED_KEY_COUNT * sizeof(ConfigDelta)];
+    memcpy(blob, &cfg.version, sizeof(uint32_t));
+    for (size_t i = 0; i < PERSISTED_KEY_COUNT; i++) {
+        ConfigDelta entry = {};
+        entry.key = PERSISTED_KEYS[i];
+        entry.value = getValue(cfg, PERSISTED_KEYS[i]);
+        memcpy(blob + sizeof(uint32_t) + i * sizeof(ConfigDelta), &entry, sizeof(entry));
+    }
+
+    Preferences prefs;
+    if (!prefs.begin(PREF_NAMESPACE, false)) {
+        return false;
+    }
+    size_t written = prefs.putBytes(PREF_CONFIG, blob, sizeof(blob));
+    prefs.end();
+    return written == sizeof(blob);
+}
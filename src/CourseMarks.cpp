@@ -0,0 +1,480 @@
+/**
+ * @file CourseMarks.cpp
+ * @brief Implémentation des marques du parcours (zones, passages, tours)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Coût par fix: une projection, une case de grille, puis au plus les
+ * marques de la case (et celles où le bateau se trouve). Avec 8 marques
+ * au maximum, les masques tiennent sur un octet.
+ */
+
+#include "CourseMarks.h"
+#include "StartSequence.h"
+#include <Preferences.h>
+
+static const char* PREF_NAMESPACE = "boatgps";
+static const char* PREF_COURSE = "course";
+static const uint32_t DAY_MS = 86400000UL;
+
+/**
+ * @brief Constructeur
+ */
+CourseMarks::CourseMarks()
+    : markCount(0), cellMm(MIN_CELL_MM), insideMask(0), hasPrevious(false), prevTod(0), lapMask(0),
+      roundedMask(0), lapStarted(false), lapStartTod(0), laps(0), roundings(0), lastLapMs(0), bestLapMs(0),
+      cyclesSum(0), cyclesMax(0), cyclesCount(0) {
+    memset(&course, 0, sizeof(course));
+    memset(grid, 0, sizeof(grid));
+    gridOrigin.x = 0;
+    gridOrigin.y = 0;
+    prevPoint = gridOrigin;
+}
+
+/**
+ * @brief Charge le parcours enregistré en NVS
+ */
+void CourseMarks::begin() {
+    Preferences prefs;
+    prefs.begin(PREF_NAMESPACE, true);
+    bool found = prefs.getBytes(PREF_COURSE, &course, sizeof(course)) == sizeof(course);
+    prefs.end();
+
+    if (found && course.messageType == MSG_COURSE && build()) {
+        Serial.printf("✓ Course #%u: %u marks loaded\n", course.courseId, markCount);
+    } else {
+        memset(&course, 0, sizeof(course));
+        Serial.println("✓ Course: none (waiting for committee frame)");
+    }
+}
+
+/**
+ * @brief Applique une trame de parcours du comité
+ * @param packet Trame reçue, déjà authentifiée par l'appelant
+ * @return true si le parcours a changé
+ *
+ * @details
+ * Le comité répète la trame : même courseId = répétition ignorée. Un
+ * nouveau parcours remet à zéro les tours (le signal de départ suivant
+ * relance le chronométrage).
+ *
+ * La trame est enregistrée en NVS et survit au redémarrage : main.cpp ne
+ * l'applique que si sa signature (clé de flotte, Config::authenticate())
+ * est bonne. Le comité d'une autre série sur le même canal ne peut donc
+ * ni remplacer ni effacer (count = 0) le parcours.
+ */
+bool CourseMarks::applyCourse(const CoursePacket& packet) {
+    if (packet.courseId == course.courseId && course.messageType == MSG_COURSE) {
+        return false;
+    }
+    if (packet.count > COURSE_MAX_ENTRIES) {
+        Serial.printf("⚠️  Course #%u: %u entries, rejected\n", packet.courseId, packet.count);
+        return false;
+    }
+
+    memcpy(&course, &packet, sizeof(course));
+    build();
+    lapStarted = false;
+    laps = 0;
+    roundings = 0;
+    lastLapMs = 0;
+    bestLapMs = 0;
+
+    Preferences prefs;
+    prefs.begin(PREF_NAMESPACE, false);
+    prefs.putBytes(PREF_COURSE, &course, sizeof(course));
+    prefs.end();
+
+    Serial.printf("🏁 Course #%u: %u marks\n", course.courseId, markCount);
+    return true;
+}
+
+bool CourseMarks::hasCourse() const {
+    return markCount > 0;
+}
+
+/**
+ * @brief Démarre le chronométrage des tours (signal de départ)
+ * @param tod Heure GPS du jour du signal (ms)
+ */
+void CourseMarks::startLaps(uint32_t tod) {
+    lapStarted = true;
+    lapStartTod = tod;
+    roundedMask = 0;
+    laps = 0;
+}
+
+/**
+ * @brief Teste un nouveau fix contre les marques proches
+ * @return Nombre d'événements remplis
+ */
+uint8_t CourseMarks::update(const GPSData& data, uint32_t fixTod, EventPacket* events, uint8_t maxEvents) {
+    if (markCount == 0 || !data.valid || fixTod == 0) {
+        hasPrevious = false;
+        return 0;
+    }
+    uint32_t startCycles = ESP.getCycleCount();
+
+    LocalPoint point = frame.project(Geodesy::toE7(data.latitude), Geodesy::toE7(data.longitude));
+
+    // Candidates: marks of the grid cell, plus the ones the boat is in
+    uint8_t candidates = insideMask;
+    if (point.x >= gridOrigin.x && point.y >= gridOrigin.y) {
+        int32_t cx = (point.x - gridOrigin.x) / cellMm;
+        int32_t cy = (point.y - gridOrigin.y) / cellMm;
+        if (cx < GRID_SIZE && cy < GRID_SIZE) {
+            candidates |= grid[cy * GRID_SIZE + cx];
+        }
+    }
+
+    uint8_t count = 0;
+    for (uint8_t i = 0; candidates != 0; i++, candidates >>= 1) {
+        if (!(candidates & 1)) {
+            continue;
+        }
+        Mark& mark = marks[i];
+        uint8_t bit = 1 << i;
+
+        if (!mark.inside) {
+            if (contains(mark, point, 0)) {
+                mark.inside = true;
+                insideMask |= bit;
+                mark.closestMm = UINT32_MAX;
+                trackClosest(mark, point, fixTod);
+            }
+            continue;
+        }
+
+        trackClosest(mark, point, fixTod);
+        if (contains(mark, point, EXIT_MARGIN_MM)) {
+            continue;
+        }
+
+        // Left the zone with the margin: mark rounded
+        mark.inside = false;
+        insideMask &= ~bit;
+        roundings++;
+        roundedMask |= bit;
+
+        int32_t inLap = lapStarted ? StartSequence::todDiff(mark.closestTod, lapStartTod) : 0;
+        if (count < maxEvents) {
+            fillEvent(events[count++], EVENT_MARK_ROUNDING, mark.id, mark.closestTod, inLap, mark.closest, data.speed);
+        }
+        Serial.printf("🏁 Mark %u rounded (closest %.1f m)", mark.id, mark.closestMm / 1000.0f);
+        if (lapStarted) {
+            Serial.printf(", %.1f s into lap %u", inLap / 1000.0f, laps + 1);
+        }
+        Serial.println();
+
+        if (!mark.lapMark) {
+            continue;
+        }
+        uint8_t others = ((1 << markCount) - 1) & ~lapMask;
+        if (lapStarted && (roundedMask & others) == others) {
+            laps++;
+            lastLapMs = (uint32_t)inLap;
+            bestLapMs = (bestLapMs == 0) ? lastLapMs : min(bestLapMs, lastLapMs);
+            if (count < maxEvents) {
+                fillEvent(events[count++], EVENT_LAP, (uint8_t)min(laps, (uint16_t)255), mark.closestTod,
+                          inLap, mark.closest, data.speed);
+            }
+            Serial.printf("🏁 Lap %u: %.1f s\n", laps, lastLapMs / 1000.0f);
+        }
+        if (!lapStarted || (roundedMask & others) == others) {
+            lapStarted = true;
+            lapStartTod = mark.closestTod;
+            roundedMask = 0;
+        }
+    }
+
+    hasPrevious = true;
+    prevPoint = point;
+    prevTod = fixTod;
+
+    uint32_t cycles = ESP.getCycleCount() - startCycles;
+    cyclesSum += cycles;
+    cyclesMax = max(cyclesMax, cycles);
+    cyclesCount++;
+    return count;
+}
+
+uint16_t CourseMarks::getLaps() const {
+    return laps;
+}
+
+/**
+ * @brief Affiche l'état du parcours (status update)
+ *
+ * @details
+ * Exemple:
+ * Course #12: 4 marks | 7 roundings, 2 laps (last 612.4 s, best 598.0 s) | 95 cycles/fix (max 410)
+ */
+void CourseMarks::printReport() {
+    if (markCount == 0) {
+        Serial.println("Course: none");
+        return;
+    }
+    Serial.printf("Course #%u: %u marks | %u roundings, %u laps", course.courseId, markCount, roundings, laps);
+    if (laps > 0) {
+        Serial.printf(" (last %.1f s, best %.1f s)", lastLapMs / 1000.0f, bestLapMs / 1000.0f);
+    }
+    if (cyclesCount > 0) {
+        Serial.printf(" | %lu cycles/fix (max %lu)", cyclesSum / cyclesCount, cyclesMax);
+    }
+    Serial.println();
+
+    cyclesSum = 0;
+    cyclesMax = 0;
+    cyclesCount = 0;
+}
+
+/**
+ * @brief Construit les marques, leurs emprises et la grille
+ *
+ * @details
+ * Les entrées sont regroupées par markId (ordre du parcours). Une entrée
+ * avec rayon = cercle ; au moins 3 entrées sans rayon = polygone. Toute
+ * autre combinaison est ignorée. La grille couvre l'emprise de toutes les
+ * marques (marge de sortie incluse), cases d'au moins MIN_CELL_MM.
+ */
+bool CourseMarks::build() {
+    markCount = 0;
+    lapMask = 0;
+    insideMask = 0;
+    roundedMask = 0;
+    hasPrevious = false;
+    memset(grid, 0, sizeof(grid));
+
+    uint8_t entries = min(course.count, COURSE_MAX_ENTRIES);
+    if (entries == 0) {
+        return false;
+    }
+    frame.setOrigin(course.marks[0].latitude, course.marks[0].longitude);
+
+    uint8_t vertexCount = 0;
+    for (uint8_t id = 0; id < COURSE_MAX_MARKS; id++) {
+        Mark& mark = marks[markCount];
+        uint8_t n = 0;
+        uint8_t radiusEntries = 0;
+        uint8_t first = vertexCount;
+        int64_t sumX = 0;
+        int64_t sumY = 0;
+        bool lap = false;
+
+        for (uint8_t e = 0; e < entries; e++) {
+            const CourseMark& entry = course.marks[e];
+            if (entry.markId != id) {
+                continue;
+            }
+            LocalPoint p = frame.project(entry.latitude, entry.longitude);
+            vertices[vertexCount++] = p;
+            sumX += p.x;
+            sumY += p.y;
+            n++;
+            if (entry.radiusM > 0) {
+                radiusEntries++;
+                mark.radiusMm = (int32_t)entry.radiusM * 1000;
+            }
+            lap = lap || (entry.flags & COURSE_LAP_MARK);
+        }
+        if (n == 0) {
+            continue;
+        }
+
+        mark.id = id;
+        mark.lapMark = lap;
+        mark.inside = false;
+        mark.center.x = (int32_t)(sumX / n);
+        mark.center.y = (int32_t)(sumY / n);
+        if (n == 1 && radiusEntries == 1) {
+            mark.shape = SHAPE_CIRCLE;
+            mark.vertexCount = 0;
+            vertexCount = first;
+            int32_t extent = mark.radiusMm + EXIT_MARGIN_MM;
+            mark.boxMin = {mark.center.x - extent, mark.center.y - extent};
+            mark.boxMax = {mark.center.x + extent, mark.center.y + extent};
+        } else if (n >= 3 && radiusEntries == 0) {
+            mark.shape = SHAPE_POLYGON;
+            mark.radiusMm = 0;
+            mark.firstVertex = first;
+            mark.vertexCount = n;
+            mark.boxMin = mark.boxMax = vertices[first];
+            for (uint8_t v = first; v < first + n; v++) {
+                mark.boxMin.x = min(mark.boxMin.x, vertices[v].x);
+                mark.boxMin.y = min(mark.boxMin.y, vertices[v].y);
+                mark.boxMax.x = max(mark.boxMax.x, vertices[v].x);
+                mark.boxMax.y = max(mark.boxMax.y, vertices[v].y);
+            }
+            mark.boxMin.x -= EXIT_MARGIN_MM;
+            mark.boxMin.y -= EXIT_MARGIN_MM;
+            mark.boxMax.x += EXIT_MARGIN_MM;
+            mark.boxMax.y += EXIT_MARGIN_MM;
+        } else {
+            Serial.printf("⚠️  Course: mark %u ignored (%u entries, %u with radius)\n", id, n, radiusEntries);
+            vertexCount = first;
+            continue;
+        }
+        if (mark.lapMark) {
+            lapMask |= 1 << markCount;
+        }
+        markCount++;
+    }
+    if (markCount == 0) {
+        return false;
+    }
+    if (lapMask == 0) {
+        marks[0].lapMark = true;
+        lapMask = 1;
+    }
+
+    // Uniform grid over the footprint of all marks
+    LocalPoint low = marks[0].boxMin;
+    LocalPoint high = marks[0].boxMax;
+    for (uint8_t i = 1; i < markCount; i++) {
+        low.x = min(low.x, marks[i].boxMin.x);
+        low.y = min(low.y, marks[i].boxMin.y);
+        high.x = max(high.x, marks[i].boxMax.x);
+        high.y = max(high.y, marks[i].boxMax.y);
+    }
+    gridOrigin = low;
+    int32_t span = max(high.x - low.x, high.y - low.y);
+    cellMm = max(span / GRID_SIZE + 1, (int32_t)MIN_CELL_MM);
+
+    for (uint8_t i = 0; i < markCount; i++) {
+        int32_t x0 = (marks[i].boxMin.x - low.x) / cellMm;
+        int32_t y0 = (marks[i].boxMin.y - low.y) / cellMm;
+        int32_t x1 = min((marks[i].boxMax.x - low.x) / cellMm, (int32_t)GRID_SIZE - 1);
+        int32_t y1 = min((marks[i].boxMax.y - low.y) / cellMm, (int32_t)GRID_SIZE - 1);
+        for (int32_t cy = y0; cy <= y1; cy++) {
+            for (int32_t cx = x0; cx <= x1; cx++) {
+                grid[cy * GRID_SIZE + cx] |= 1 << i;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Point dans la zone d'une marque (élargie de margin)
+ *
+ * @details
+ * Polygone: test de parité (rayon vers l'est) en int64, puis distance aux
+ * côtés en float32 pour la marge.
+ */
+bool CourseMarks::contains(const Mark& mark, const LocalPoint& point, int32_t margin) const {
+    if (point.x < mark.boxMin.x || point.x > mark.boxMax.x ||
+        point.y < mark.boxMin.y || point.y > mark.boxMax.y) {
+        return false;
+    }
+
+    if (mark.shape == SHAPE_CIRCLE) {
+        int64_t dx = point.x - mark.center.x;
+        int64_t dy = point.y - mark.center.y;
+        int64_t limit = (int64_t)mark.radiusMm + margin;
+        return dx * dx + dy * dy <= limit * limit;
+    }
+
+    const LocalPoint* v = &vertices[mark.firstVertex];
+    uint8_t n = mark.vertexCount;
+    bool inside = false;
+    for (uint8_t i = 0, j = n - 1; i < n; j = i++) {
+        if ((v[i].y > point.y) != (v[j].y > point.y)) {
+            int64_t crossX = v[i].x + (int64_t)(v[j].x - v[i].x) * (point.y - v[i].y) / (v[j].y - v[i].y);
+            if (point.x < crossX) {
+                inside = !inside;
+            }
+        }
+    }
+    if (inside || margin == 0) {
+        return inside;
+    }
+
+    float margin2 = (float)margin * margin;
+    for (uint8_t i = 0, j = n - 1; i < n; j = i++) {
+        float ex = (float)(v[i].x - v[j].x);
+        float ey = (float)(v[i].y - v[j].y);
+        float px = (float)(point.x - v[j].x);
+        float py = (float)(point.y - v[j].y);
+        float length2 = ex * ex + ey * ey;
+        float t = (length2 > 0) ? constrain((px * ex + py * ey) / length2, 0.0f, 1.0f) : 0.0f;
+        float dx = px - t * ex;
+        float dy = py - t * ey;
+        if (dx * dx + dy * dy <= margin2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Plus courte distance au centre sur le segment depuis le fix précédent
+ *
+ * @details
+ * Point le plus proche du centre sur le segment [précédent, courant],
+ * instant interpolé linéairement entre les deux fixes.
+ */
+void CourseMarks::trackClosest(Mark& mark, const LocalPoint& point, uint32_t fixTod) {
+    float t = 1.0f;
+    float dx = (float)(point.x - prevPoint.x);
+    float dy = (float)(point.y - prevPoint.y);
+    float length2 = dx * dx + dy * dy;
+    if (hasPrevious && length2 > 0) {
+        float cx = (float)(mark.center.x - prevPoint.x);
+        float cy = (float)(mark.center.y - prevPoint.y);
+        t = constrain((cx * dx + cy * dy) / length2, 0.0f, 1.0f);
+    }
+
+    LocalPoint closest = point;
+    uint32_t tod = fixTod;
+    if (hasPrevious && t < 1.0f) {
+        closest.x = prevPoint.x + (int32_t)(t * dx);
+        closest.y = prevPoint.y + (int32_t)(t * dy);
+        int32_t offset = (int32_t)(t * StartSequence::todDiff(fixTod, prevTod));
+        tod = (prevTod + DAY_MS + offset) % DAY_MS;
+    }
+
+    LocalPoint center = mark.center;
+    uint32_t distance = Geodesy::distanceMm(center, closest);
+    if (distance < mark.closestMm) {
+        mark.closestMm = distance;
+        mark.closestTod = tod;
+        mark.closest = closest;
+    }
+}
+
+/**
+ * @brief Remplit un événement de passage ou de tour
+ */
+void CourseMarks::fillEvent(EventPacket& event, EventType type, uint8_t detail, uint32_t tod, int32_t relativeMs,
+                            const LocalPoint& point, float speed) const {
+    int32_t latE7, lonE7;
+    frame.unproject(point, latE7, lonE7);
+
+    memset(&event, 0, sizeof(event));
+    event.messageType = MSG_EVENT;
+    event.eventType = type;
+    event.detail = detail;
+    event.timeOfDayMs = tod;
+    event.relativeMs = relativeMs;
+    event.latitude = latE7 * 1e-7f;
+    event.longitude = lonE7 * 1e-7f;
+    event.speed = speed;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file CourseSmoother.cpp
+ * @brief Implémentation du lissage circulaire du cap et de la vitesse fond
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Moyennes en mm/s << 8 : un pas de 2 s à 10 Hz (poids 100 / 2100)
+ * déplace encore la moyenne d'un écart de 1 mm/s. Produits en int64
+ * (écart × dt), une division par fix et par moyenne. Le cap lissé vient
+ * de Geodesy::bearingDeci (arc tangente entière).
+ */
+
+#include "CourseSmoother.h"
+
+/**
+ * @brief Constructeur
+ */
+CourseSmoother::CourseSmoother()
+    : hasSample(false), lastMillis(0), eastQ8(0), northQ8(0), speedQ8(0),
+      courseDeci(0), speedCms(0), confidence(0), rawSpeedMmps(0), rawCourseDeci(0),
+      samples(0), restarts(0), cyclesSum(0), cyclesMax(0), cyclesCount(0) {
+}
+
+/**
+ * @brief Ajoute un fix
+ */
+void CourseSmoother::update(const GPSData& data) {
+    uint32_t startCycles = ESP.getCycleCount();
+
+    addSample(Geodesy::knotsToMmps(data.speed), (int32_t)lroundf(data.course * 10.0f), data.fixMillis);
+
+    uint32_t cycles = ESP.getCycleCount() - startCycles;
+    cyclesSum += cycles;
+    cyclesMax = max(cyclesMax, cycles);
+    cyclesCount++;
+}
+
+/**
+ * @brief Ajoute un échantillon brut
+ *
+ * @details
+ * Vecteur vitesse de l'échantillon : v × (sin cap, cos cap), Q15. Le
+ * premier échantillon (ou celui qui suit une coupure) initialise les
+ * moyennes.
+ */
+void CourseSmoother::addSample(int32_t speedMmps, int32_t rawDeci, uint32_t fixMillis) {
+    if (speedMmps < 0) {
+        speedMmps = 0;
+    }
+    rawSpeedMmps = speedMmps;
+    rawCourseDeci = rawDeci;
+    samples++;
+
+    int32_t east = (int32_t)(((int64_t)speedMmps * Geodesy::sinQ15(rawDeci)) >> (15 - FRACTION_BITS));
+    int32_t north = (int32_t)(((int64_t)speedMmps * Geodesy::cosQ15(rawDeci)) >> (15 - FRACTION_BITS));
+    int32_t speed = speedMmps << FRACTION_BITS;
+
+    uint32_t dt = fixMillis - lastMillis;
+    if (!hasSample || dt > GAP_MS) {
+        if (hasSample) {
+            restarts++;
+        }
+        hasSample = true;
+        eastQ8 = east;
+        northQ8 = north;
+        speedQ8 = speed;
+    } else if (dt > 0) {
+        int64_t span = TAU_MS + dt;
+        eastQ8 += (int32_t)((int64_t)(east - eastQ8) * dt / span);
+        northQ8 += (int32_t)((int64_t)(north - northQ8) * dt / span);
+        speedQ8 += (int32_t)((int64_t)(speed - speedQ8) * dt / span);
+    }
+    lastMillis = fixMillis;
+
+    // Outputs: direction and length of the mean vector
+    courseDeci = (uint16_t)Geodesy::bearingDeci(eastQ8, northQ8);
+    speedCms = (uint16_t)min((speedQ8 >> FRACTION_BITS) / 10, (int32_t)65535);
+    uint32_t resultant = isqrt((uint64_t)((int64_t)eastQ8 * eastQ8 + (int64_t)northQ8 * northQ8));
+    if (speedQ8 > 0) {
+        confidence = (uint16_t)min((uint64_t)resultant * 1000 / (uint32_t)speedQ8, (uint64_t)1000);
+    } else {
+        confidence = 0;
+    }
+}
+
+bool CourseSmoother::isCourseValid() const {
+    return hasSample && (speedQ8 >> FRACTION_BITS) >= COURSE_MMPS && confidence >= MIN_CONFIDENCE;
+}
+
+uint16_t CourseSmoother::getCourseDeci() const {
+    return courseDeci;
+}
+
+uint16_t CourseSmoother::getSpeedCms() const {
+    return speedCms;
+}
+
+uint16_t CourseSmoother::getConfidencePermille() const {
+    return confidence;
+}
+
+/**
+ * @brief Oublie l'historique
+ */
+void CourseSmoother::reset() {
+    hasSample = false;
+    eastQ8 = 0;
+    northQ8 = 0;
+    speedQ8 = 0;
+    courseDeci = 0;
+    speedCms = 0;
+    confidence = 0;
+}
+
+/**
+ * @brief Affiche cap et vitesse lissés contre les valeurs brutes (status update)
+ *
+ * @details
+ * Exemple:
+ * Course: COG 214.6° (raw 217.0°), SOG 4.21 kn (raw 4.35), confidence 98% | 1 restart | 95 cycles/fix (max 160)
+ */
+void CourseSmoother::printReport() {
+    static const float CMS_TO_KN = 1.0f / 51.4444f;
+
+    if (!hasSample) {
+        Serial.println("Course: no fix");
+        return;
+    }
+    Serial.print("Course: COG ");
+    if (isCourseValid()) {
+        Serial.printf("%.1f°", courseDeci / 10.0f);
+    } else {
+        Serial.print("---");
+    }
+    Serial.printf(" (raw %.1f°), SOG %.2f kn (raw %.2f), confidence %u%% | %lu restart",
+                  rawCourseDeci / 10.0f, speedCms * CMS_TO_KN, rawSpeedMmps / 514.444f,
+                  (confidence + 5) / 10, restarts);
+    if (cyclesCount > 0) {
+        Serial.printf(" | %lu cycles/fix (max %lu)", cyclesSum / cyclesCount, cyclesMax);
+    }
+    Serial.println();
+
+    cyclesSum = 0;
+    cyclesMax = 0;
+    cyclesCount = 0;
+}
+
+/**
+ * @brief Racine carrée entière (méthode bit à bit, 32 itérations au plus)
+ */
+uint32_t CourseSmoother::isqrt(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
@@ -0,0 +1,225 @@
+/**
+ * @file FixFilter.cpp
+ * @brief Implémentation du rejet des fixes aberrants
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * La vitesse Doppler (RMC) est bien moins sensible au multitrajet que la
+ * position : elle sert de prédiction. Un saut de 20 à 50 m donne un
+ * écart de prédiction de 20 à 50 m, quand le bruit d'un bon fix reste
+ * de l'ordre du mètre. Médiane et MAD sur RESIDUALS valeurs : deux tris
+ * par insertion de 9 entiers par fix.
+ */
+
+#include "FixFilter.h"
+
+/**
+ * @brief Constructeur
+ */
+FixFilter::FixFilter()
+    : hasAnchor(false), anchorMillis(0), anchorVx(0), anchorVy(0), anchorSpeedMmps(0),
+      residualHead(0), residualCount(0), lastGateMm(MIN_GATE_MM),
+      checked(0), rejected(0), positionRejects(0), speedRejects(0), accelRejects(0), reseeds(0),
+      cyclesSum(0), cyclesMax(0), cyclesCount(0) {
+    anchor.x = 0;
+    anchor.y = 0;
+}
+
+/**
+ * @brief Vérifie un nouveau fix
+ * @return Drapeaux FixQuality (FIX_GOOD = accepté)
+ */
+uint8_t FixFilter::check(double latitude, double longitude, float speedKn, float courseDeg, uint32_t fixMillis) {
+    uint32_t startCycles = ESP.getCycleCount();
+    checked++;
+
+    int32_t lat = Geodesy::toE7(latitude);
+    int32_t lon = Geodesy::toE7(longitude);
+    // Bounded before the 32-bit velocity and prediction, still above MAX_SPEED_MMPS; !(<=) also catches NaN
+    if (!(fabsf(speedKn) <= MAX_DOPPLER_KN)) {
+        speedKn = MAX_DOPPLER_KN;
+    }
+    int32_t speedMmps = Geodesy::knotsToMmps(speedKn);
+    int32_t vx;
+    int32_t vy;
+    Geodesy::velocityMmps(speedKn, courseDeg, vx, vy);
+
+    uint32_t dt = fixMillis - anchorMillis;
+    if (hasAnchor && dt == 0) {
+        return FIX_GOOD;  // Same fix
+    }
+    if (!hasAnchor || dt > RESEED_MS) {
+        if (hasAnchor) {
+            reseeds++;
+        }
+        seed(lat, lon, vx, vy, speedMmps, fixMillis);
+        uint32_t cycles = ESP.getCycleCount() - startCycles;
+        cyclesSum += cycles;
+        cyclesMax = max(cyclesMax, cycles);
+        cyclesCount++;
+        return FIX_GOOD;
+    }
+
+    // Prediction from the anchor with the mean Doppler velocity
+    LocalPoint position = frame.project(lat, lon);
+    LocalPoint predicted;
+    predicted.x = anchor.x + (anchorVx + vx) * (int32_t)dt / 2000;
+    predicted.y = anchor.y + (anchorVy + vy) * (int32_t)dt / 2000;
+    uint32_t residual = Geodesy::distanceMm(predicted, position);
+    uint32_t moved = Geodesy::distanceMm(anchor, position);
+
+    // The prediction drifts with time: half the acceleration bound over dt
+    lastGateMm = hampelGate() + (uint32_t)((uint64_t)MAX_ACCEL_MMPS2 * dt * dt / 2000000);
+
+    uint8_t quality = FIX_GOOD;
+    if (residual > lastGateMm) {
+        quality |= FIX_OUTLIER_POSITION;
+    }
+    // Implied speed with the position noise allowed (short periods at 10 Hz)
+    if (speedMmps > MAX_SPEED_MMPS ||
+        (uint64_t)moved * 1000 > (uint64_t)MAX_SPEED_MMPS * dt + (uint64_t)lastGateMm * 1000) {
+        quality |= FIX_OUTLIER_SPEED;
+    }
+    if ((uint64_t)abs(speedMmps - anchorSpeedMmps) * 1000 > (uint64_t)MAX_ACCEL_MMPS2 * dt) {
+        quality |= FIX_OUTLIER_ACCEL;
+    }
+
+    if (quality == FIX_GOOD) {
+        residuals[(residualHead + residualCount) % RESIDUALS] = residual;
+        if (residualCount < RESIDUALS) {
+            residualCount++;
+        } else {
+            residualHead = (residualHead + 1) % RESIDUALS;
+        }
+        anchor = position;
+        anchorMillis = fixMillis;
+        anchorVx = vx;
+        anchorVy = vy;
+        anchorSpeedMmps = speedMmps;
+        if (abs(position.x) > RECENTRE_MM || abs(position.y) > RECENTRE_MM) {
+            frame.setOrigin(lat, lon);
+            anchor.x = 0;
+            anchor.y = 0;
+        }
+    } else {
+        rejected++;
+        if (quality & FIX_OUTLIER_POSITION) positionRejects++;
+        if (quality & FIX_OUTLIER_SPEED) speedRejects++;
+        if (quality & FIX_OUTLIER_ACCEL) accelRejects++;
+    }
+
+    uint32_t cycles = ESP.getCycleCount() - startCycles;
+    cyclesSum += cycles;
+    cyclesMax = max(cyclesMax, cycles);
+    cyclesCount++;
+    return quality;
+}
+
+uint32_t FixFilter::getChecked() const {
+    return checked;
+}
+
+uint32_t FixFilter::getRejected() const {
+    return rejected;
+}
+
+/**
+ * @brief Affiche les rejets (status update)
+ *
+ * @details
+ * Exemple:
+ * Fix filter: 18342 fixes, 12 rejected (0.07%: 9 position, 5 speed, 1 accel), 1 reseed | gate 8.0 m | 420 cycles/fix (max 900)
+ */
+void FixFilter::printReport() {
+    Serial.printf("Fix filter: %lu fixes, %lu rejected", checked, rejected);
+    if (checked > 0) {
+        Serial.printf(" (%.2f%%: %lu position, %lu speed, %lu accel)", rejected * 100.0f / checked,
+                      positionRejects, speedRejects, accelRejects);
+    }
+    Serial.printf(", %lu reseed | gate %.1f m", reseeds, lastGateMm / 1000.0f);
+    if (cyclesCount > 0) {
+        Serial.printf(" | %lu cycles/fix (max %lu)", cyclesSum / cyclesCount, cyclesMax);
+    }
+    Serial.println();
+
+    cyclesSum = 0;
+    cyclesMax = 0;
+    cyclesCount = 0;
+}
+
+/**
+ * @brief Repart du fix courant
+ *
+ * @details
+ * Les écarts précédents sont oubliés : après une perte de fix, le bruit
+ * de la nouvelle solution n'est pas celui de l'ancienne.
+ */
+void FixFilter::seed(int32_t latE7, int32_t lonE7, int32_t vx, int32_t vy, int32_t speedMmps, uint32_t fixMillis) {
+    frame.setOrigin(latE7, lonE7);
+    hasAnchor = true;
+    anchor.x = 0;
+    anchor.y = 0;
+    anchorMillis = fixMillis;
+    anchorVx = vx;
+    anchorVy = vy;
+    anchorSpeedMmps = speedMmps;
+    residualHead = 0;
+    residualCount = 0;
+}
+
+/**
+ * @brief Seuil de Hampel sur les écarts des derniers fixes acceptés (mm)
+ *
+ * @details
+ * 1,4826 × MAD estime l'écart type pour un bruit gaussien, sans être
+ * tiré par les valeurs extrêmes. Calcul entier : 3 × 1,4826 ≈ 89 / 20.
+ */
+uint32_t FixFilter::hampelGate() const {
+    if (residualCount < MIN_RESIDUALS) {
+        return MIN_GATE_MM;
+    }
+
+    uint32_t sorted[RESIDUALS];
+    for (uint8_t i = 0; i < residualCount; i++) {
+        uint32_t value = residuals[(residualHead + i) % RESIDUALS];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+    uint32_t median = sorted[residualCount / 2];
+
+    uint32_t deviations[RESIDUALS];
+    for (uint8_t i = 0; i < residualCount; i++) {
+        uint32_t value = (sorted[i] > median) ? sorted[i] - median : median - sorted[i];
+        uint8_t j = i;
+        while (j > 0 && deviations[j - 1] > value) {
+            deviations[j] = deviations[j - 1];
+            j--;
+        }
+        deviations[j] = value;
+    }
+    uint32_t mad = deviations[residualCount / 2];
+
+    return max(median + mad * 89 / 20, (uint32_t)MIN_GATE_MM);
+}
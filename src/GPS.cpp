@@ -33,9 +33,47 @@
  * - Minimum 4 satellites requis
  * - Âge du fix < 2 secondes
  * - Position valide (isValid)
+ * 
+ * Économie d'énergie du récepteur:
+ * - NEO-6M : UBX CFG-PM2 (période = cadence de broadcast) + CFG-RXM lpMode=1
+ * - AT6668 : aucun mode d'économie du récepteur (pas de mode cyclique
+ *   documenté). Le mode « économie » se limite à $PCAS03 (GGA + RMC
+ *   uniquement) : le récepteur reste en poursuite continue, seule
+ *   l'activité UART et CPU de l'ESP32 baisse. Il est journalisé
+ *   « reduced NMEA » et compté au même courant que la pleine puissance.
+ * - Retour en pleine puissance dès que le HDOP se dégrade ou que le
+ *   bateau accélère, puis attente de POWER_SAVE_HOLDOFF_MS
  */
 
 #include "GPS.h"
+#include <esp_timer.h>
+
+// Nominal receiver currents (datasheets) used for energy-per-fix estimates
+#ifdef CONFIG_IDF_TARGET_ESP32S3
+static const float RECEIVER_FULL_MA = 25.0f;   // AT6668 continuous tracking
+static const float RECEIVER_SAVE_MA = 25.0f;   // AT6668 reduced sentence set: still continuous tracking
+static const char* SAVE_MODE_NAME = "reduced NMEA";  // Not a receiver power mode
+#else
+static const float RECEIVER_FULL_MA = 37.0f;   // NEO-6M continuous tracking
+static const float RECEIVER_SAVE_MA = 11.0f;   // NEO-6M power save mode, 1 Hz
+static const char* SAVE_MODE_NAME = "power save";
+#endif
+
+/**
+ * @brief Jours depuis le 1970-01-01 d'une date du calendrier grégorien
+ *
+ * @details
+ * Indépendant du fuseau horaire (mktime() applique TZ) : sert à l'heure
+ * GPS absolue des balises horaires.
+ */
+static int32_t daysFromCivil(int32_t year, uint32_t month, uint32_t day) {
+    year -= month <= 2;
+    int32_t era = (year >= 0 ? year : year - 399) / 400;
+    uint32_t yearOfEra = (uint32_t)(year - era * 400);
+    uint32_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    uint32_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (int32_t)dayOfEra - 719468;
+}
 
 /**
  * @brief Constructeur de la classe GPS
@@ -48,9 +86,18 @@
  * Serial2 se fait dans begin().
  */
 GPS::GPS(uint8_t rxPin, uint8_t txPin)
-    : rxPin(rxPin), txPin(txPin), gpsSerial(nullptr) {
+    : rxPin(rxPin), txPin(txPin), gpsSerial(nullptr), timeOfDayMs(0), timeSyncMillis(0),
+      lastRxMillis(0), burstStartMillis(0), burstStartUs(0), burstTimed(false), anchorGpsUs(0),
+      anchorLocalUs(0), anchorCount(0), powerMode(GNSS_FULL_POWER), powerSaveAllowed(false),
+      updatePeriodMs(1000), stableFixes(0), powerSaveHoldoff(0), powerModeSince(0),
+      powerSaveExits(0), lastSpeed(0), lastFixMillis(0), fixCount(0),
+      rawCapture(false), rawLineLen(0), rawHead(0), rawCount(0), rawDropped(0) {
+    modeTimeMs[GNSS_FULL_POWER] = 0;
+    modeTimeMs[GNSS_POWER_SAVE] = 0;
     currentData.valid = false;
     currentData.timestamp = 0;
+    currentData.fixMillis = 0;
+    currentData.quality = FIX_GOOD;
 }
 
 /**
@@ -102,11 +149,25 @@ void GPS::update() {
     static uint32_t lastDebug = 0;
     static uint32_t charCount = 0;
     
+    // Detect start of a new NMEA burst (used for wake-up scheduling)
+    uint32_t now = millis();
+    if (gpsSerial->available() > 0) {
+        if (now - lastRxMillis >= BURST_GAP_MS) {
+            burstStartMillis = now;
+            burstStartUs = esp_timer_get_time();
+            burstTimed = false;
+        }
+        lastRxMillis = now;
+    }
+    
     // Feed GPS parser with available data
     while (gpsSerial->available() > 0) {
         char c = gpsSerial->read();
         gps.encode(c);
         charCount++;
+        if (rawCapture) {
+            captureRawChar(c);
+        }
         
         // Debug: Print raw NMEA sentences (DISABLED - uncomment for troubleshooting)
         // Serial.print(c);
@@ -123,6 +184,24 @@ void GPS::update() {
     //     charCount = 0;
     // }
     
+    // Track GPS time of day for slot alignment (TDMA)
+    if (gps.time.isUpdated() && gps.time.isValid()) {
+        // RMC: date and time of one epoch, paired with the first byte of its burst (time beacons)
+        if (!burstTimed && burstStartUs != 0 && gps.date.isUpdated() && gps.date.isValid()) {
+            int64_t seconds = (int64_t)daysFromCivil(gps.date.year(), gps.date.month(), gps.date.day()) * 86400 +
+                              gps.time.hour() * 3600L + gps.time.minute() * 60L + gps.time.second();
+            anchorGpsUs = seconds * 1000000 + gps.time.centisecond() * 10000L;
+            anchorLocalUs = burstStartUs;
+            anchorCount++;
+            burstTimed = true;
+        }
+        timeOfDayMs = ((uint32_t)gps.time.hour() * 3600UL +
+                       (uint32_t)gps.time.minute() * 60UL +
+                       gps.time.second()) * 1000UL +
+                      gps.time.centisecond() * 10UL;
+        timeSyncMillis = millis();
+    }
+    
     // Update current data if location is updated
     if (gps.location.isUpdated()) {
         currentData.latitude = gps.location.lat();
@@ -131,6 +210,7 @@ void GPS::update() {
         currentData.course = gps.course.deg();
         currentData.satellites = gps.satellites.value();
         currentData.age = gps.location.age();
+        currentData.fixMillis = now;
         
         // Récupérer l'heure et la date du GPS
         int year = gps.date.year();
@@ -169,6 +249,15 @@ void GPS::update() {
         // Validate data
         currentData.valid = gps.location.isValid() && 
                            (currentData.satellites >= 4);
+        
+        // Flag position spikes (multipath): still broadcast and logged, marked
+        currentData.quality = currentData.valid
+            ? (FixQuality)filter.check(currentData.latitude, currentData.longitude, currentData.speed,
+                                       currentData.course, now)
+            : FIX_GOOD;
+        
+        fixCount++;
+        updatePowerPolicy(now);
     }
 }
 
@@ -214,3 +303,378 @@ uint8_t GPS::getSatellites() {
 float GPS::getHDOP() {
     return gps.hdop.hdop();
 }
+
+/**
+ * @brief Retourne l'heure UTC courante estimée (ms depuis minuit)
+ * @return Millisecondes depuis 00:00:00 UTC (0 si l'heure GPS est inconnue)
+ * 
+ * @details
+ * Extrapolée avec millis() depuis la dernière trame contenant l'heure.
+ * Le retard entre l'époque GNSS et la réception NMEA est quasi identique
+ * pour tous les bateaux équipés du même module : il s'annule lors de
+ * l'alignement des slots TDMA.
+ */
+uint32_t GPS::getTimeOfDayMs() {
+    if (timeSyncMillis == 0) {
+        return 0;
+    }
+    return (timeOfDayMs + (millis() - timeSyncMillis)) % 86400000UL;
+}
+
+/**
+ * @brief Époque GNSS de la dernière rafale horodatée et heure locale de son premier octet
+ * @param gpsUs Heure GPS (UTC) de l'époque, µs depuis le 1970-01-01
+ * @param localUs esp_timer_get_time() au premier octet de la rafale
+ * @return Nombre d'ancrages depuis le démarrage (0 : aucun, sorties inchangées)
+ *
+ * @details
+ * Un ancrage par rafale, pris sur la trame RMC (date et heure de la même
+ * époque). Si deux rafales se touchent (moins de BURST_GAP_MS de silence),
+ * seule la première époque est ancrée : la suivante n'a pas de début de
+ * rafale propre. L'écart entre l'époque et le premier octet (calcul du
+ * récepteur, UART) est propre au module : voir TimeBeacon.
+ */
+uint32_t GPS::getTimeAnchor(int64_t& gpsUs, int64_t& localUs) const {
+    if (anchorCount > 0) {
+        gpsUs = anchorGpsUs;
+        localUs = anchorLocalUs;
+    }
+    return anchorCount;
+}
+
+/**
+ * @brief Retourne millis() du dernier octet reçu du module GPS
+ */
+uint32_t GPS::getLastRxMillis() const {
+    return lastRxMillis;
+}
+
+/**
+ * @brief Retourne millis() du premier octet de la dernière rafale NMEA
+ * 
+ * @details
+ * Une rafale commence après un silence UART d'au moins BURST_GAP_MS.
+ * La période entre deux débuts de rafale permet de prévoir la suivante.
+ */
+uint32_t GPS::getBurstStartMillis() const {
+    return burstStartMillis;
+}
+
+/**
+ * @brief Règle la période de navigation du récepteur
+ * @param periodMs Période entre deux fixes en millisecondes (100-1000)
+ * 
+ * @details
+ * - NEO-6M : UBX CFG-RATE (measRate, navRate=1, timeRef=GPS). Au-delà
+ *   de 1 Hz, GLL/GSA/GSV/VTG sont coupées (CFG-MSG) : à 9600 bauds, seules
+ *   GGA + RMC tiennent à 5 Hz (maximum du NEO-6M)
+ * - AT6668 : $PCAS02,<ms> (115200 bauds, jusqu'à 10 Hz)
+ */
+void GPS::setUpdateRate(uint16_t periodMs) {
+#ifdef CONFIG_IDF_TARGET_ESP32S3
+    periodMs = constrain(periodMs, (uint16_t)100, (uint16_t)1000);
+    char cmd[16];
+    snprintf(cmd, sizeof(cmd), "PCAS02,%u", periodMs);
+    sendNMEACommand(cmd);
+#else
+    periodMs = constrain(periodMs, (uint16_t)200, (uint16_t)1000);
+    static const uint8_t TRIMMED_SENTENCES[] = {0x01, 0x02, 0x03, 0x05};  // GLL, GSA, GSV, VTG
+    for (uint8_t i = 0; i < sizeof(TRIMMED_SENTENCES); i++) {
+        uint8_t msg[3] = {0xF0, TRIMMED_SENTENCES[i], (uint8_t)(periodMs < 1000 ? 0 : 1)};
+        sendUBX(0x06, 0x01, msg, sizeof(msg));
+    }
+    
+    uint8_t payload[6] = {
+        (uint8_t)(periodMs & 0xFF), (uint8_t)(periodMs >> 8),  // measRate (ms)
+        0x01, 0x00,                                            // navRate (cycles)
+        0x01, 0x00                                             // timeRef (GPS time)
+    };
+    sendUBX(0x06, 0x08, payload, sizeof(payload));
+#endif
+}
+
+/**
+ * @brief Autorise ou interdit l'économie d'énergie automatique
+ * @param allowed Économie autorisée par la configuration
+ * @param updatePeriodMs Période de fix nécessaire à la cadence de broadcast
+ * 
+ * @details
+ * Si l'économie devient interdite, le récepteur repasse immédiatement
+ * en pleine puissance. Sinon, l'entrée se fait dans updatePowerPolicy()
+ * lorsque les conditions de qualité sont réunies.
+ */
+void GPS::setPowerSaveAllowed(bool allowed, uint16_t updatePeriodMs) {
+    bool periodChanged = (updatePeriodMs != this->updatePeriodMs);
+    powerSaveAllowed = allowed;
+    this->updatePeriodMs = updatePeriodMs;
+    
+    if (powerMode == GNSS_POWER_SAVE && (!allowed || periodChanged)) {
+        setPowerMode(GNSS_FULL_POWER);
+    }
+}
+
+/**
+ * @brief Retourne le mode d'énergie du récepteur
+ */
+GnssPowerMode GPS::getPowerMode() const {
+    return powerMode;
+}
+
+/**
+ * @brief Retourne le nombre de fixes reçus depuis le démarrage
+ */
+uint32_t GPS::getFixCount() const {
+    return fixCount;
+}
+
+/**
+ * @brief Courant nominal du récepteur dans le mode courant (mA)
+ */
+float GPS::getReceiverCurrentMa() const {
+    return powerMode == GNSS_POWER_SAVE ? RECEIVER_SAVE_MA : RECEIVER_FULL_MA;
+}
+
+/**
+ * @brief Affiche l'état d'énergie du récepteur (status update)
+ * 
+ * @details
+ * Exemple:
+ * GNSS power: power save | save 82% of time | 3 exits | est. 37.6 mJ/fix (receiver)
+ * 
+ * L'énergie par fix est estimée à partir des courants nominaux du
+ * module (3,3 V) et du temps passé dans chaque mode (AT6668 : même
+ * courant dans les deux modes).
+ */
+void GPS::printPowerReport() {
+    uint32_t now = millis();
+    uint64_t fullMs = modeTimeMs[GNSS_FULL_POWER];
+    uint64_t saveMs = modeTimeMs[GNSS_POWER_SAVE];
+    if (powerMode == GNSS_POWER_SAVE) {
+        saveMs += now - powerModeSince;
+    } else {
+        fullMs += now - powerModeSince;
+    }
+    
+    float totalMs = (float)(fullMs + saveMs);
+    float energyMj = 3.3f * (RECEIVER_FULL_MA * fullMs + RECEIVER_SAVE_MA * saveMs) / 1000.0f;
+    
+    Serial.printf("GNSS power: %s | save %.0f%% of time | %lu exits",
+                  powerMode == GNSS_POWER_SAVE ? SAVE_MODE_NAME : "full power",
+                  totalMs > 0 ? 100.0f * saveMs / totalMs : 0.0f,
+                  powerSaveExits);
+    if (fixCount > 0) {
+        Serial.printf(" | est. %.1f mJ/fix (receiver)\n", energyMj / fixCount);
+    } else {
+        Serial.println();
+    }
+}
+
+/**
+ * @brief Affiche les rejets du filtre de fixes (status update)
+ */
+void GPS::printFilterReport() {
+    filter.printReport();
+}
+
+/**
+ * @brief Envoie un message UBX (calcul du checksum Fletcher)
+ * @param msgClass Classe UBX
+ * @param msgId Identifiant UBX
+ * @param payload Charge utile
+ * @param len Longueur de la charge utile
+ */
+void GPS::sendUBX(uint8_t msgClass, uint8_t msgId, const uint8_t* payload, uint16_t len) {
+    if (gpsSerial == nullptr) {
+        return;
+    }
+    uint8_t header[6] = {0xB5, 0x62, msgClass, msgId, (uint8_t)(len & 0xFF), (uint8_t)(len >> 8)};
+    uint8_t ckA = 0, ckB = 0;
+    for (uint8_t i = 2; i < 6; i++) {
+        ckA += header[i];
+        ckB += ckA;
+    }
+    for (uint16_t i = 0; i < len; i++) {
+        ckA += payload[i];
+        ckB += ckA;
+    }
+    gpsSerial->write(header, sizeof(header));
+    gpsSerial->write(payload, len);
+    gpsSerial->write(ckA);
+    gpsSerial->write(ckB);
+}
+
+/**
+ * @brief Envoie une commande NMEA propriétaire (ex: "PCAS02,1000")
+ * @param body Corps de la commande, sans '$' ni checksum
+ */
+void GPS::sendNMEACommand(const char* body) {
+    if (gpsSerial == nullptr) {
+        return;
+    }
+    uint8_t checksum = 0;
+    for (const char* p = body; *p; p++) {
+        checksum ^= (uint8_t)*p;
+    }
+    gpsSerial->printf("$%s*%02X\r\n", body, checksum);
+}
+
+/**
+ * @brief Change le mode d'énergie du récepteur
+ * @param mode Nouveau mode
+ * 
+ * @details
+ * NEO-6M (u-blox 6):
+ * - CFG-PM2 : updatePeriod = période de broadcast, searchPeriod = 10 s,
+ *   limitation du pic de courant, mise à jour éphémérides
+ * - CFG-RXM : lpMode 1 (Power Save) ou 0 (Max Performance)
+ * 
+ * AT6668 (CASIC), sans mode d'économie du récepteur :
+ * - $PCAS03 : GGA + RMC uniquement (suffisant pour TinyGPS++),
+ *   GGA/GLL/GSA/GSV/RMC/VTG en pleine puissance. Le récepteur reste en
+ *   poursuite continue : seul le trafic UART baisse.
+ */
+void GPS::setPowerMode(GnssPowerMode mode) {
+    uint32_t now = millis();
+    modeTimeMs[powerMode] += now - powerModeSince;
+    powerModeSince = now;
+    powerMode = mode;
+    
+#ifdef CONFIG_IDF_TARGET_ESP32S3
+    if (mode == GNSS_POWER_SAVE) {
+        sendNMEACommand("PCAS03,1,0,0,0,1,0,0,0,0,0,,,0,0,,,,0");
+    } else {
+        sendNMEACommand("PCAS03,1,1,1,1,1,1,0,0,0,0,,,0,0,,,,0");
+    }
+#else
+    if (mode == GNSS_POWER_SAVE) {
+        uint8_t pm2[44] = {0};
+        uint32_t flags = (1UL << 8)    // limitPeakCurrent
+                       | (1UL << 10)   // WaitTimeFix
+                       | (1UL << 12);  // updateEPH
+        uint32_t updatePeriod = updatePeriodMs;
+        uint32_t searchPeriod = 10000;
+        pm2[0] = 0x01;                               // version
+        memcpy(&pm2[4], &flags, sizeof(flags));      // little-endian on ESP32
+        memcpy(&pm2[8], &updatePeriod, sizeof(updatePeriod));
+        memcpy(&pm2[12], &searchPeriod, sizeof(searchPeriod));
+        sendUBX(0x06, 0x3B, pm2, sizeof(pm2));
+    }
+    uint8_t rxm[2] = {0x08, (uint8_t)(mode == GNSS_POWER_SAVE ? 0x01 : 0x00)};
+    sendUBX(0x06, 0x11, rxm, sizeof(rxm));
+#endif
+    
+    Serial.printf("✓ GPS: %s mode\n", mode == GNSS_POWER_SAVE ? SAVE_MODE_NAME : "full power");
+}
+
+/**
+ * @brief Évalue l'entrée/sortie du mode économie à chaque fix
+ * @param now millis() du fix
+ * 
+ * @details
+ * Sortie immédiate si HDOP > POWER_SAVE_EXIT_HDOP ou si la variation de
+ * vitesse dépasse POWER_SAVE_EXIT_ACCEL nœuds/s (départ au lancement,
+ * abattée...). Entrée après POWER_SAVE_STABLE_FIXES fixes consécutifs
+ * avec HDOP < POWER_SAVE_MAX_HDOP et hors période de garde.
+ */
+void GPS::updatePowerPolicy(uint32_t now) {
+    float hdop = gps.hdop.isValid() ? gps.hdop.hdop() : 99.0f;
+    float accel = 0.0f;
+    if (lastFixMillis != 0 && now != lastFixMillis) {
+        accel = fabsf(currentData.speed - lastSpeed) * 1000.0f / (now - lastFixMillis);
+    }
+    lastSpeed = currentData.speed;
+    lastFixMillis = now;
+    
+    if (powerMode == GNSS_POWER_SAVE) {
+        if (!currentData.valid || hdop > POWER_SAVE_EXIT_HDOP || accel > POWER_SAVE_EXIT_ACCEL) {
+            setPowerMode(GNSS_FULL_POWER);
+            powerSaveExits++;
+            powerSaveHoldoff = now + POWER_SAVE_HOLDOFF_MS;
+            stableFixes = 0;
+        }
+        return;
+    }
+    
+    bool good = currentData.valid && hdop < POWER_SAVE_MAX_HDOP && accel <= POWER_SAVE_EXIT_ACCEL;
+    stableFixes = good ? min((uint8_t)(stableFixes + 1), (uint8_t)255) : 0;
+    
+    if (powerSaveAllowed && stableFixes >= POWER_SAVE_STABLE_FIXES &&
+        (int32_t)(now - powerSaveHoldoff) >= 0) {
+        setPowerMode(GNSS_POWER_SAVE);
+    }
+}
+
+/**
+ * @brief Active ou arrête la capture des trames NMEA brutes
+ * @param enabled Capture des trames complètes à partir de maintenant
+ *
+ * @details
+ * La trame en cours de réception est ignorée (capture à partir du
+ * prochain '$'). À l'arrêt, les trames non lues sont abandonnées.
+ */
+void GPS::setRawCapture(bool enabled) {
+    if (enabled == rawCapture) {
+        return;
+    }
+    rawCapture = enabled;
+    rawLineLen = 0;
+    if (!enabled) {
+        rawHead = 0;
+        rawCount = 0;
+    }
+}
+
+/**
+ * @brief Retire la plus ancienne trame capturée
+ * @param out Trame sans CR/LF, terminée par NUL (RAW_SENTENCE_LEN octets)
+ * @return false si aucune trame n'attend
+ */
+bool GPS::readRawSentence(char* out) {
+    if (rawCount == 0) {
+        return false;
+    }
+    memcpy(out, rawQueue[rawHead], RAW_SENTENCE_LEN);
+    rawHead = (rawHead + 1) % RAW_QUEUE;
+    rawCount--;
+    return true;
+}
+
+uint32_t GPS::getRawDropped() const {
+    return rawDropped;
+}
+
+/**
+ * @brief Ajoute un caractère reçu à la trame brute en cours
+ *
+ * @details
+ * Une trame commence par '$' et se termine au '\n'. Trame trop longue :
+ * ignorée. File pleine : la nouvelle trame est perdue et comptée (la
+ * boucle principale vide la file à chaque passage).
+ */
+void GPS::captureRawChar(char c) {
+    if (c == '$') {
+        rawLineLen = 0;
+        rawLine[rawLineLen++] = c;
+        return;
+    }
+    if (rawLineLen == 0) {
+        return;  // Waiting for the start of a sentence
+    }
+    if (c == '\r' || c == '\n') {
+        if (rawCount < RAW_QUEUE) {
+            char* slot = rawQueue[(rawHead + rawCount) % RAW_QUEUE];
+            memcpy(slot, rawLine, rawLineLen);
+            slot[rawLineLen] = '\0';
+            rawCount++;
+        } else {
+            rawDropped++;
+        }
+        rawLineLen = 0;
+        return;
+    }
+    if (rawLineLen < RAW_SENTENCE_LEN - 1) {
+        rawLine[rawLineLen++] = c;
+    } else {
+        rawLineLen = 0;  // Too long: not NMEA
+    }
+}
@@ -0,0 +1,330 @@
+/**
+ * @file Gateway.cpp
+ * @brief Mode station de base : passerelle ESP-NOW vers USB série
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Voir Gateway.h. Le rappel de réception ne fait que copier la trame
+ * dans l'anneau ; l'encadrement, le CRC et l'écriture série se font dans
+ * loop(), sur l'autre cœur de l'ESP32.
+ */
+
+#include "Gateway.h"
+#include <esp_timer.h>
+#include <BoatCodec.h>
+
+// Static member initialization
+Gateway* Gateway::instance = nullptr;
+
+/**
+ * @brief Constructeur de la passerelle
+ */
+Gateway::Gateway()
+    : head(0), tail(0), sniffedRssi(GATEWAY_RSSI_UNKNOWN), sniffedChannel(0), sniffed(false), stagedLen(0),
+      stagedSent(0), stagedRecords(0), lastProgress(0), lastStats(0), channel(1), received(0), ringDropped(0), invalid(0),
+      rssiMissing(0), forwarded(0), serialDropped(0), ringHighWater(0), hopGroup(0), homeChannel(1),
+      beaconClock(true), beaconCoarse(false) {
+    instance = this;
+    memset(sniffedMac, 0, sizeof(sniffedMac));
+}
+
+/**
+ * @brief Prend la réception ESP-NOW en charge
+ * @param channel Canal écouté
+ * @return true si les rappels sont enregistrés
+ *
+ * @details
+ * Communication::begin() a initialisé le WiFi, l'ESP-NOW et le canal.
+ * La passerelle reçoit comme le Display : tous les protocoles (LR et
+ * normaux), sans économie d'énergie du modem (une trame de diffusion
+ * arrivée pendant un sommeil du modem est perdue). Le rappel de
+ * promiscuité ne garde que les trames de gestion.
+ */
+bool Gateway::begin(uint8_t channel) {
+    this->channel = channel;
+    homeChannel = channel;
+    esp_wifi_set_protocol(WIFI_IF_STA, WIFI_PROTOCOL_11B | WIFI_PROTOCOL_11G | WIFI_PROTOCOL_11N | WIFI_PROTOCOL_LR);
+    esp_wifi_set_ps(WIFI_PS_NONE);
+
+    wifi_promiscuous_filter_t filter = {};
+    filter.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT;
+    esp_wifi_set_promiscuous_filter(&filter);
+    esp_wifi_set_promiscuous_rx_cb(onSniff);
+    if (esp_wifi_set_promiscuous(true) != ESP_OK) {
+        Serial.println("⚠️  Gateway: sniffer unavailable, RSSI unknown");
+    }
+
+    esp_now_unregister_recv_cb();
+    if (esp_now_register_recv_cb(onDataRecv) != ESP_OK) {
+        Serial.println("✗ Gateway: Failed to register the receive callback");
+        return false;
+    }
+    lastStats = millis();
+    if (schedule.isEnabled()) {
+        Serial.printf("✓ Gateway: channel hop on %u channels, group %u/%u (home channel until a time beacon)\n",
+                      schedule.getCount(), hopGroup, schedule.getGroups());
+    }
+    Serial.printf("✓ Gateway: channel %d, ring %lu frames, binary records follow\n", channel,
+                  (unsigned long)RING_SIZE);
+    Serial.flush();
+    return true;
+}
+
+/**
+ * @brief Suit le plan de saut de canal
+ * @param channelMask Canaux parcourus (0 = canal fixe)
+ * @param groups Nombre de groupes
+ * @param group Groupe écouté
+ */
+void Gateway::setHop(uint16_t channelMask, uint8_t groups, uint8_t group) {
+    if (!schedule.configure(channelMask, groups)) {
+        schedule.configure(0, 1);
+    }
+    hopGroup = group % schedule.getGroups();
+}
+
+/**
+ * @brief Recopie les trames reçues sur la liaison série
+ * @return true si des enregistrements attendent encore
+ *
+ * @details
+ * Les trames de l'anneau sont encadrées dans le tampon d'envoi tant
+ * qu'elles y tiennent : un seul Serial.write() par lot, au lieu d'un
+ * par trame. Le pilote ne reçoit que la place qu'il annonce libre
+ * (availableForWrite()), loop() ne bloque jamais sur l'USB.
+ */
+bool Gateway::update() {
+    uint32_t now = millis();
+    followSchedule();
+    if (!flushStaging(now)) {
+        return true;
+    }
+
+    if (now - lastStats >= STATS_INTERVAL_MS) {
+        lastStats = now;
+        stageStats();
+    }
+
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    if (h - t > ringHighWater) {
+        ringHighWater = h - t;
+    }
+    while (t != h) {
+        const Record& record = ring[t & (RING_SIZE - 1)];
+        size_t payloadLen = GatewayFrameWire::DATA + record.len;
+        if (stagedLen + GatewayLinkWire::OVERHEAD + payloadLen > STAGING_SIZE) {
+            break;
+        }
+        uint8_t* p = GatewayLink::begin(staging + stagedLen, GATEWAY_RECORD_FRAME, (uint16_t)payloadLen);
+        GatewayLink::put64(p + GatewayFrameWire::TIME_US, record.timeUs);
+        memcpy(p + GatewayFrameWire::MAC, record.mac, 6);
+        p[GatewayFrameWire::RSSI] = (uint8_t)record.rssi;
+        p[GatewayFrameWire::CHANNEL] = record.channel != 0 ? record.channel : channel;
+        memcpy(p + GatewayFrameWire::DATA, record.data, record.len);
+        TimeBeaconPacket beacon;
+        if (schedule.isEnabled() && BoatCodec::decode(record.data, record.len, beacon) == DECODE_OK) {
+            beaconClock.apply(record.mac, beacon, (int64_t)record.timeUs);
+            beaconCoarse.apply(record.mac, beacon, (int64_t)record.timeUs);
+        }
+        stagedLen += GatewayLink::finish(staging + stagedLen);
+        stagedRecords++;
+        t++;
+        tail.store(t, std::memory_order_release);  // Slot free for the callback
+    }
+
+    if (stagedLen == 0) {
+        return false;
+    }
+    lastProgress = now;
+    return !flushStaging(now) || t != h;
+}
+
+/**
+ * @brief Confie au pilote série la partie du lot qui tient
+ * @param now millis()
+ * @return true quand le tampon d'envoi est vide
+ *
+ * @details
+ * Un hôte qui ne lit plus (port fermé, USB débranché) remplit le tampon
+ * du pilote : après STALL_MS sans progrès, le lot est abandonné et ses
+ * trames comptées perdues. Un enregistrement coupé est écarté par le CRC
+ * du lecteur.
+ */
+bool Gateway::flushStaging(uint32_t now) {
+    if (stagedSent == stagedLen) {
+        stagedLen = 0;
+        stagedSent = 0;
+        return true;
+    }
+    int room = Serial.availableForWrite();
+    if (room > 0) {
+        size_t chunk = stagedLen - stagedSent;
+        if ((size_t)room < chunk) {
+            chunk = room;
+        }
+        stagedSent += Serial.write(staging + stagedSent, chunk);
+        lastProgress = now;
+    } else if (now - lastProgress >= STALL_MS) {
+        serialDropped += stagedRecords;
+        stagedRecords = 0;
+        stagedLen = 0;
+        stagedSent = 0;
+        return true;
+    }
+    if (stagedSent < stagedLen) {
+        return false;
+    }
+    forwarded += stagedRecords;
+    stagedRecords = 0;
+    stagedLen = 0;
+    stagedSent = 0;
+    return true;
+}
+
+/**
+ * @brief Ajoute l'enregistrement des compteurs au tampon d'envoi
+ */
+void Gateway::stageStats() {
+    uint8_t* p = GatewayLink::begin(staging + stagedLen, GATEWAY_RECORD_STATS, GatewayStatsWire::SIZE);
+    GatewayLink::put64(p + GatewayStatsWire::TIME_US, esp_timer_get_time());
+    BoatCodec::put32(p + GatewayStatsWire::RECEIVED, received.load(std::memory_order_relaxed));
+    BoatCodec::put32(p + GatewayStatsWire::FORWARDED, forwarded);
+    BoatCodec::put32(p + GatewayStatsWire::RING_DROPPED, ringDropped.load(std::memory_order_relaxed));
+    BoatCodec::put32(p + GatewayStatsWire::SERIAL_DROPPED, serialDropped);
+    BoatCodec::put32(p + GatewayStatsWire::INVALID, invalid.load(std::memory_order_relaxed));
+    BoatCodec::put32(p + GatewayStatsWire::RSSI_MISSING, rssiMissing.load(std::memory_order_relaxed));
+    BoatCodec::put16(p + GatewayStatsWire::RING_HIGH_WATER, (uint16_t)ringHighWater);
+    BoatCodec::put16(p + GatewayStatsWire::RING_SIZE, (uint16_t)RING_SIZE);
+    p[GatewayStatsWire::CHANNEL] = channel;
+    stagedLen += GatewayLink::finish(staging + stagedLen);
+}
+
+/**
+ * @brief Trames perdues à un étage de la passerelle
+ * @return Anneau plein + hôte qui ne lisait pas, depuis le démarrage
+ */
+uint32_t Gateway::getDropped() const {
+    return ringDropped.load(std::memory_order_relaxed) + serialDropped;
+}
+
+/**
+ * @brief Rappel ESP-NOW de réception (pont vers l'instance)
+ */
+void Gateway::onDataRecv(const uint8_t* mac, const uint8_t* data, int len) {
+    if (instance) {
+        instance->handleRecv(mac, data, len);
+    }
+}
+
+/**
+ * @brief Rappel de promiscuité (pont vers l'instance)
+ */
+void Gateway::onSniff(void* buf, wifi_promiscuous_pkt_type_t type) {
+    if (instance && type == WIFI_PKT_MGMT) {
+        instance->handleSniff((const wifi_promiscuous_pkt_t*)buf);
+    }
+}
+
+/**
+ * @brief Copie une trame reçue dans l'anneau
+ * @param mac Adresse MAC de l'émetteur
+ * @param data Données reçues
+ * @param len Longueur des données
+ *
+ * @details
+ * Exécuté dans la tâche WiFi : horodatage en premier, puis une seule
+ * copie dans la case libre. La case n'est publiée (head) qu'une fois
+ * remplie ; anneau plein = trame perdue, sans attente.
+ */
+void Gateway::handleRecv(const uint8_t* mac, const uint8_t* data, int len) {
+    uint64_t timeUs = esp_timer_get_time();
+    received.store(received.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    bool rssiKnown = sniffed && memcmp(sniffedMac, mac, 6) == 0;
+    sniffed = false;
+
+    if (len <= 0 || len > ESP_NOW_MAX_DATA_LEN) {
+        invalid.store(invalid.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= RING_SIZE) {
+        ringDropped.store(ringDropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    Record& record = ring[h & (RING_SIZE - 1)];
+    record.timeUs = timeUs;
+    memcpy(record.mac, mac, 6);
+    record.rssi = rssiKnown ? sniffedRssi : GATEWAY_RSSI_UNKNOWN;
+    record.channel = rssiKnown ? sniffedChannel : 0;
+    if (!rssiKnown) {
+        rssiMissing.store(rssiMissing.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    record.len = (uint8_t)len;
+    memcpy(record.data, data, len);
+    head.store(h + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Retient le RSSI d'une trame d'action ESP-NOW
+ * @param packet Trame 802.11 reçue
+ *
+ * @details
+ * Trame ESP-NOW : trame d'action (0xD0), catégorie fournisseur (127),
+ * OUI Espressif 18:FE:34 ; la MAC source est l'adresse 2 de l'en-tête.
+ * Les balises et autres trames de gestion sont ignorées.
+ */
+void Gateway::handleSniff(const wifi_promiscuous_pkt_t* packet) {
+    const uint8_t* frame = packet->payload;
+    if (packet->rx_ctrl.sig_len < 28 || frame[0] != 0xD0 || frame[24] != 0x7F ||
+        frame[25] != 0x18 || frame[26] != 0xFE || frame[27] != 0x34) {
+        return;
+    }
+    memcpy(sniffedMac, frame + 10, 6);
+    sniffedRssi = (int8_t)packet->rx_ctrl.rssi;
+    sniffedChannel = (uint8_t)packet->rx_ctrl.channel;
+    sniffed = true;
+}
+
+/**
+ * @brief Écoute le canal de la seconde GPS courante
+ *
+ * @details
+ * L'heure corrigée est préférée dès qu'elle existe ; sans balise depuis
+ * HOP_HOLDOVER_US, retour au canal de la clé 3 pour la retrouver.
+ */
+void Gateway::followSchedule() {
+    if (!schedule.isEnabled()) {
+        return;
+    }
+    int64_t localUs = esp_timer_get_time();
+    const BeaconReceiver* clock = nullptr;
+    if (beaconClock.isSynced() && localUs - beaconClock.getClock().getLastSampleUs() < HOP_HOLDOVER_US) {
+        clock = &beaconClock;
+    } else if (beaconCoarse.isSynced() && localUs - beaconCoarse.getClock().getLastSampleUs() < HOP_HOLDOVER_US) {
+        clock = &beaconCoarse;
+    }
+    uint8_t target = clock ? schedule.channelAt(clock->toGpsUs(localUs), hopGroup) : homeChannel;
+    if (target != channel && esp_wifi_set_channel(target, WIFI_SECOND_CHAN_NONE) == ESP_OK) {
+        channel = target;
+    }
+}
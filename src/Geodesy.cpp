@@ -0,0 +1,349 @@
+/**
+ * @file Geodesy.cpp
+ * @brief Implémentation du repère local en virgule fixe
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Projection (φ0 = latitude de l'origine, Δ en 1e-7 degré):
+ * - x0 = Δlon · scaleX, y0 = Δlat · scaleY (Q16, mm)
+ * - x = x0 - x0·y0·tan φ0 / M       (méridiens convergents vers le pôle)
+ * - y = y0 + x0²·tan φ0 / 2N        (un parallèle s'écarte de la tangente)
+ * M et N : rayons de courbure méridien et transverse WGS84 à φ0.
+ * Les produits intermédiaires sont réduits de 16 bits avant la
+ * multiplication par la constante Q48 : pas de débordement int64 jusqu'à
+ * ±100 km de l'origine.
+ */
+
+#include "Geodesy.h"
+
+static const double WGS84_A = 6378137.0;           // Semi-major axis (m)
+static const double WGS84_E2 = 6.69437999014e-3;   // First eccentricity squared
+static const double Q48 = 281474976710656.0;       // 2^48
+
+// sin(0..90°) in Q15, 1° steps (linear interpolation in between)
+static const int16_t SIN_Q15[91] = {
+    0, 572, 1144, 1715, 2286, 2856, 3425, 3993, 4560, 5126,
+    5690, 6252, 6813, 7371, 7927, 8481, 9032, 9580, 10126, 10668,
+    11207, 11743, 12275, 12803, 13328, 13848, 14364, 14876, 15383, 15886,
+    16383, 16876, 17364, 17846, 18323, 18794, 19260, 19720, 20173, 20621,
+    21062, 21497, 21925, 22347, 22762, 23170, 23571, 23964, 24351, 24730,
+    25101, 25465, 25821, 26169, 26509, 26841, 27165, 27481, 27788, 28087,
+    28377, 28659, 28932, 29196, 29451, 29697, 29934, 30162, 30381, 30591,
+    30791, 30982, 31163, 31335, 31498, 31650, 31794, 31927, 32051, 32165,
+    32269, 32364, 32448, 32523, 32587, 32642, 32687, 32722, 32747, 32762,
+    32767
+};
+
+// atan(i / 64) for i = 0..64, in 0.01 degree (linear interpolation in between)
+static const int16_t ATAN_CENTIDEG[65] = {
+    0, 90, 179, 268, 358, 447, 536, 624, 713, 800,
+    888, 975, 1062, 1148, 1234, 1319, 1404, 1488, 1571, 1653,
+    1735, 1817, 1897, 1977, 2056, 2134, 2211, 2287, 2363, 2438,
+    2511, 2584, 2657, 2728, 2798, 2867, 2936, 3003, 3070, 3136,
+    3201, 3264, 3327, 3390, 3451, 3511, 3571, 3629, 3687, 3744,
+    3800, 3855, 3909, 3963, 4016, 4067, 4119, 4169, 4218, 4267,
+    4315, 4363, 4409, 4455, 4500
+};
+
+// ============================================================================
+// LocalFrame
+// ============================================================================
+
+/**
+ * @brief Constructeur
+ */
+LocalFrame::LocalFrame()
+    : originLat(0), originLon(0), valid(false), scaleX(0), scaleY(0), convergenceX(0), convergenceY(0) {
+}
+
+/**
+ * @brief Fixe l'origine et précalcule les facteurs d'échelle
+ * @param latE7 Latitude de l'origine (1e-7 degré)
+ * @param lonE7 Longitude de l'origine (1e-7 degré)
+ *
+ * @details
+ * Mètres par degré à la latitude de l'origine (série WGS84):
+ * - latitude  : 111132.92 - 559.82 cos 2φ + 1.175 cos 4φ
+ * - longitude : 111412.84 cos φ - 93.5 cos 3φ + 0.118 cos 5φ
+ * Un pas de 1e-7 degré vaut donc environ 11.1 mm. Seul appel en double,
+ * une fois par origine.
+ */
+void LocalFrame::setOrigin(int32_t latE7, int32_t lonE7) {
+    originLat = latE7;
+    originLon = lonE7;
+
+    double phi = constrain(latE7 * 1e-7, -89.0, 89.0) * DEG_TO_RAD;
+    double mPerDegLat = 111132.92 - 559.82 * cos(2 * phi) + 1.175 * cos(4 * phi);
+    double mPerDegLon = 111412.84 * cos(phi) - 93.5 * cos(3 * phi) + 0.118 * cos(5 * phi);
+    // m/deg -> mm per 1e-7 deg (x 1e-4), Q16
+    scaleY = (int32_t)lround(mPerDegLat * 1e-4 * 65536.0);
+    scaleX = (int32_t)lround(mPerDegLon * 1e-4 * 65536.0);
+
+    double s2 = sin(phi) * sin(phi);
+    double meridianMm = WGS84_A * (1 - WGS84_E2) / pow(1 - WGS84_E2 * s2, 1.5) * 1000.0;
+    double transverseMm = WGS84_A / sqrt(1 - WGS84_E2 * s2) * 1000.0;
+    convergenceX = (int32_t)lround(tan(phi) / meridianMm * Q48);
+    convergenceY = (int32_t)lround(tan(phi) / (2 * transverseMm) * Q48);
+    valid = true;
+}
+
+bool LocalFrame::hasOrigin() const {
+    return valid;
+}
+
+int32_t LocalFrame::getOriginLat() const {
+    return originLat;
+}
+
+int32_t LocalFrame::getOriginLon() const {
+    return originLon;
+}
+
+/**
+ * @brief Projette une position dans le repère
+ * @return mm est / nord de l'origine
+ */
+LocalPoint LocalFrame::project(int32_t latE7, int32_t lonE7) const {
+    int32_t x = (int32_t)(((int64_t)(lonE7 - originLon) * scaleX) >> 16);
+    int32_t y = (int32_t)(((int64_t)(latE7 - originLat) * scaleY) >> 16);
+
+    LocalPoint point;
+    point.x = x - (int32_t)(((((int64_t)x * y) >> 16) * convergenceX) >> 32);
+    point.y = y + (int32_t)(((((int64_t)x * x) >> 16) * convergenceY) >> 32);
+    return point;
+}
+
+/**
+ * @brief Projette une série de positions
+ */
+void LocalFrame::projectBatch(const int32_t* latE7, const int32_t* lonE7, LocalPoint* out, size_t count) const {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = project(latE7[i], lonE7[i]);
+    }
+}
+
+/**
+ * @brief Reconvertit une position du repère en latitude / longitude
+ *
+ * @details
+ * Inverse du premier ordre des corrections de project(), puis une
+ * correction par une nouvelle projection : l'aller-retour reste sous la
+ * quantification (1e-7 degré) à 10 km de l'origine, jusqu'à 70° de
+ * latitude. Sans la correction, l'écart atteignait 2e-6 degré à 70°.
+ */
+void LocalFrame::unproject(const LocalPoint& point, int32_t& latE7, int32_t& lonE7) const {
+    int32_t y = point.y - (int32_t)(((((int64_t)point.x * point.x) >> 16) * convergenceY) >> 32);
+    int32_t x = point.x + (int32_t)(((((int64_t)point.x * y) >> 16) * convergenceX) >> 32);
+    latE7 = originLat + (int32_t)((int64_t)y * 65536 / scaleY);
+    lonE7 = originLon + (int32_t)((int64_t)x * 65536 / scaleX);
+
+    // One refinement step against project()
+    LocalPoint check = project(latE7, lonE7);
+    latE7 += (int32_t)((int64_t)(point.y - check.y) * 65536 / scaleY);
+    lonE7 += (int32_t)((int64_t)(point.x - check.x) * 65536 / scaleX);
+}
+
+// ============================================================================
+// Geodesy
+// ============================================================================
+
+/**
+ * @brief Degrés vers entier 1e-7 degré
+ */
+int32_t Geodesy::toE7(double degrees) {
+    return (int32_t)lround(degrees * 1e7);
+}
+
+/**
+ * @brief Sinus en Q15
+ * @param deciDeg Angle en dixièmes de degré
+ */
+int32_t Geodesy::sinQ15(int32_t deciDeg) {
+    deciDeg %= 3600;
+    if (deciDeg < 0) deciDeg += 3600;
+    int32_t sign = 1;
+    if (deciDeg >= 1800) {
+        deciDeg -= 1800;
+        sign = -1;
+    }
+    if (deciDeg > 900) {
+        deciDeg = 1800 - deciDeg;
+    }
+    int32_t index = deciDeg / 10;
+    int32_t frac = deciDeg % 10;
+    int32_t value = SIN_Q15[index];
+    if (frac != 0) {
+        value += (SIN_Q15[index + 1] - value) * frac / 10;
+    }
+    return sign * value;
+}
+
+/**
+ * @brief Cosinus en Q15
+ * @param deciDeg Angle en dixièmes de degré
+ */
+int32_t Geodesy::cosQ15(int32_t deciDeg) {
+    return sinQ15(deciDeg + 900);
+}
+
+/**
+ * @brief Cap d'un vecteur (dixièmes de degré, 0 = nord, sens horaire)
+ *
+ * @details
+ * Réduction au premier octant (rapport du petit au grand côté dans
+ * [0, 1], Q16), table de 65 arcs tangentes et interpolation linéaire :
+ * erreur inférieure à 0,02° avant l'arrondi au dixième, sans flottant
+ * ni division flottante.
+ */
+int32_t Geodesy::bearingDeci(int32_t east, int32_t north) {
+    if (east == 0 && north == 0) {
+        return 0;
+    }
+    uint32_t ax = (uint32_t)abs(east);
+    uint32_t ay = (uint32_t)abs(north);
+    bool steep = ax > ay;  // Closer to east-west than to north-south
+    uint32_t small = steep ? ay : ax;
+    uint32_t large = steep ? ax : ay;
+    uint32_t ratio = (uint32_t)(((uint64_t)small << 16) / large);  // Q16, 0..65536
+
+    uint32_t index = ratio >> 10;
+    int32_t angle = ATAN_CENTIDEG[index];
+    if (index < 64) {
+        angle += ((ATAN_CENTIDEG[index + 1] - angle) * (int32_t)(ratio & 1023)) >> 10;
+    }
+    if (steep) {
+        angle = 9000 - angle;
+    }
+
+    // Angle from the north-south axis: back to the quadrant
+    if (north < 0) {
+        angle = 18000 - angle;
+    }
+    if (east < 0) {
+        angle = 36000 - angle;
+    }
+    return ((angle + 5) / 10) % 3600;
+}
+
+/**
+ * @brief Nœuds vers mm/s (1 nœud = 514.444 mm/s)
+ */
+int32_t Geodesy::knotsToMmps(float knots) {
+    return (int32_t)(knots * 514.444f);
+}
+
+/**
+ * @brief Vecteur vitesse à partir de la vitesse et du cap fond
+ */
+void Geodesy::velocityMmps(float speedKnots, float courseDeg, int32_t& vx, int32_t& vy) {
+    int32_t speed = knotsToMmps(speedKnots);
+    int32_t courseDeci = (int32_t)(courseDeg * 10.0f);
+    vx = (speed * sinQ15(courseDeci)) >> 15;
+    vy = (speed * cosQ15(courseDeci)) >> 15;
+}
+
+/**
+ * @brief Distance entre deux points du repère (mm)
+ *
+ * @details
+ * float32 : 24 bits de mantisse, soit une résolution meilleure que 1 mm
+ * jusqu'à 16 km.
+ */
+uint32_t Geodesy::distanceMm(const LocalPoint& a, const LocalPoint& b) {
+    float dx = (float)(b.x - a.x);
+    float dy = (float)(b.y - a.y);
+    return (uint32_t)lroundf(sqrtf(dx * dx + dy * dy));
+}
+
+/**
+ * @brief Distances entre points consécutifs
+ * @return Longueur totale (mm)
+ */
+uint32_t Geodesy::distancesMm(const LocalPoint* points, uint32_t* out, size_t count) {
+    uint32_t total = 0;
+    for (size_t i = 1; i < count; i++) {
+        out[i - 1] = distanceMm(points[i - 1], points[i]);
+        total += out[i - 1];
+    }
+    return total;
+}
+
+/**
+ * @brief Variation de cap signée
+ * @return Degrés dans [-180, 180)
+ */
+float Geodesy::courseDelta(float fromDeg, float toDeg) {
+    float delta = toDeg - fromDeg;
+    if (delta >= 180.0f) delta -= 360.0f;
+    if (delta < -180.0f) delta += 360.0f;
+    return delta;
+}
+
+/**
+ * @brief Distance orthodromique sur la sphère (référence, double)
+ */
+double Geodesy::haversineM(double lat1, double lon1, double lat2, double lon2) {
+    double dLat = (lat2 - lat1) * DEG_TO_RAD;
+    double dLon = (lon2 - lon1) * DEG_TO_RAD;
+    double h = sin(dLat / 2) * sin(dLat / 2) +
+               cos(lat1 * DEG_TO_RAD) * cos(lat2 * DEG_TO_RAD) * sin(dLon / 2) * sin(dLon / 2);
+    return 2 * 6371000.0 * asin(sqrt(h));
+}
+
+/**
+ * @brief Mesure le coût projection + distance contre haversine (démarrage)
+ *
+ * @details
+ * 32 points sur un cercle de 2 km autour d'une origine à 45°N, distance
+ * de chaque point au précédent. Exemple:
+ * Geodesy: 31 cycles/point projection+distance, 8650 haversine (x279)
+ */
+void Geodesy::printBenchmark() {
+    static const size_t COUNT = 32;
+    int32_t lat[COUNT];
+    int32_t lon[COUNT];
+    LocalPoint points[COUNT];
+    uint32_t legs[COUNT];
+
+    LocalFrame frame;
+    frame.setOrigin(450000000, 60000000);
+    for (size_t i = 0; i < COUNT; i++) {
+        int32_t angle = (int32_t)(i * 3600 / COUNT);
+        lat[i] = 450000000 + (cosQ15(angle) * 180) / 32767 * 1000;     // ~2 km
+        lon[i] = 60000000 + (sinQ15(angle) * 254) / 32767 * 1000;
+    }
+
+    uint32_t start = ESP.getCycleCount();
+    frame.projectBatch(lat, lon, points, COUNT);
+    volatile uint32_t total = distancesMm(points, legs, COUNT);
+    uint32_t fixedCycles = ESP.getCycleCount() - start;
+
+    start = ESP.getCycleCount();
+    volatile double reference = 0;
+    for (size_t i = 1; i < COUNT; i++) {
+        reference = reference + haversineM(lat[i - 1] * 1e-7, lon[i - 1] * 1e-7, lat[i] * 1e-7, lon[i] * 1e-7);
+    }
+    uint32_t haversineCycles = ESP.getCycleCount() - start;
+
+    Serial.printf("✓ Geodesy: %lu cycles/point projection+distance, %lu haversine (x%lu), track %.1f m / %.1f m\n",
+                  fixedCycles / COUNT, haversineCycles / (COUNT - 1),
+                  haversineCycles / max(fixedCycles, (uint32_t)1), total / 1000.0f, (double)reference);
+}
@@ -104,5 +104,8 @@ void Logger::logGPSData(const GPSData& data, const uint8_t* macAddress) {
         Serial.printf("%02X", macAddress[i]);
         if (i < 5) Serial.print(":");
     }
+    if (data.quality != FIX_GOOD) {
+        Serial.printf(" | OUTLIER 0x%02X", data.quality);
+    }
     Serial.println();
 }
@@ -0,0 +1,269 @@
+/**
+ * @file ManoeuvreCapture.cpp
+ * @brief Implémentation de la détection des manœuvres et des fenêtres de capture
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Distance perdue: pour une rotation de cap Δ, la bissectrice fait un
+ * angle Δ/2 avec les caps d'entrée et de sortie. À vitesse constante sans
+ * manœuvre, le bateau aurait gagné v × cos(Δ/2) × durée sur cet axe, quel
+ * que soit le bord. Pour un virement, la bissectrice est l'axe du vent :
+ * la mesure est la perte de VMG, sans capteur de vent.
+ */
+
+#include "ManoeuvreCapture.h"
+
+/**
+ * @brief Constructeur
+ */
+ManoeuvreCapture::ManoeuvreCapture()
+    : historyHead(0), historyCount(0), baselineCms(0), hasLast(false),
+      capturing(false), triggerMillis(0), minSpeedCms(0), recoveryMs(-1), settledSince(0),
+      windFromDeci(-1), minAbsWindAngleDeci(1800),
+      windows(0), reported(0), captureMs(0) {
+    memset(&lastRecord, 0, sizeof(lastRecord));
+}
+
+/**
+ * @brief Direction de vent de référence
+ * @param fromDeg Direction d'où vient le vent (degrés), négatif = inconnue
+ */
+void ManoeuvreCapture::setWindDirection(float fromDeg) {
+    windFromDeci = (fromDeg < 0) ? -1 : ((int32_t)lroundf(fromDeg * 10.0f) % 3600);
+}
+
+/**
+ * @brief Traite un nouveau fix
+ * @param data Nouveau fix
+ * @param fixTod Heure GPS du fix (ms depuis minuit, 0 = inconnue)
+ * @param record Rempli quand une manœuvre se termine
+ * @return true si record a été rempli
+ */
+bool ManoeuvreCapture::update(const GPSData& data, uint32_t fixTod, ManoeuvreRecord& record) {
+    if (!data.valid || (hasLast && data.fixMillis == last.fixMillis)) {
+        return false;
+    }
+
+    Sample sample;
+    sample.fixMillis = data.fixMillis;
+    sample.timestamp = data.timestamp;
+    sample.tod = fixTod;
+    sample.latitude = Geodesy::toE7(data.latitude);
+    sample.longitude = Geodesy::toE7(data.longitude);
+    sample.speedCms = (uint16_t)constrain(data.speed * 51.4444f, 0.0f, 65535.0f);
+    sample.courseDeci = (int16_t)(((int32_t)(data.course * 10.0f) % 3600 + 3600) % 3600);
+
+    // Turn rate from the previous fix (course is noise at low speed)
+    float turnRate = 0.0f;
+    uint32_t dt = hasLast ? data.fixMillis - last.fixMillis : 0;
+    if (dt > 0 && dt <= MAX_GAP_MS && sample.speedCms >= COURSE_CMS && last.speedCms >= COURSE_CMS) {
+        turnRate = Geodesy::courseDelta(last.courseDeci / 10.0f, sample.courseDeci / 10.0f) * 1000.0f / dt;
+    }
+    float absRate = fabsf(turnRate);
+
+    bool done = false;
+    if (!capturing) {
+        // Reference speed, only outside manoeuvres
+        if (!hasLast || dt > MAX_GAP_MS) {
+            baselineCms = sample.speedCms;
+            historyCount = 0;
+        } else {
+            baselineCms += ((int32_t)sample.speedCms - (int32_t)baselineCms) * (int32_t)dt / (int32_t)(BASELINE_TAU_MS + dt);
+        }
+        sample.baselineCms = (uint16_t)baselineCms;
+
+        if (historyCount == HISTORY) {
+            historyHead = (historyHead + 1) % HISTORY;
+            historyCount--;
+        }
+        history[(historyHead + historyCount) % HISTORY] = sample;
+        historyCount++;
+
+        bool speedLoss = (uint32_t)sample.speedCms * 10 < baselineCms * 7;
+        if (baselineCms >= MIN_ENTRY_CMS &&
+            (absRate >= TRIGGER_DEG_S || (absRate >= SLOW_TRIGGER_DEG_S && speedLoss))) {
+            open(sample);
+        }
+    } else {
+        minSpeedCms = min(minSpeedCms, sample.speedCms);
+        trackWindAngle(sample.courseDeci);
+
+        bool dropped = (uint32_t)minSpeedCms * 10 < (uint32_t)entry.baselineCms * 9;
+        bool recovered = (uint32_t)sample.speedCms * 10 >= (uint32_t)entry.baselineCms * 9;
+        if (dropped && recovered && recoveryMs < 0) {
+            recoveryMs = (int32_t)(sample.fixMillis - triggerMillis);
+        }
+
+        if (absRate < SETTLED_DEG_S) {
+            if (settledSince == 0) {
+                settledSince = sample.fixMillis;
+            }
+        } else {
+            settledSince = 0;
+        }
+
+        bool settled = settledSince != 0 && sample.fixMillis - settledSince >= SETTLE_MS;
+        if ((settled && (!dropped || recoveryMs >= 0)) || sample.fixMillis - entry.fixMillis >= MAX_CAPTURE_MS ||
+            dt > MAX_GAP_MS) {
+            done = close(sample, record);
+            baselineCms = sample.speedCms;
+            historyCount = 0;
+        }
+    }
+
+    last = sample;
+    hasLast = true;
+    return done;
+}
+
+bool ManoeuvreCapture::isCapturing() const {
+    return capturing;
+}
+
+/**
+ * @brief Construit l'événement temps réel d'une manœuvre
+ *
+ * @details
+ * detail = ManoeuvreKind, relativeMs = temps de relance (-1 si non
+ * relancé), position = début de la fenêtre, speed = vitesse minimale.
+ */
+void ManoeuvreCapture::fillEvent(const ManoeuvreRecord& record, EventPacket& event) const {
+    memset(&event, 0, sizeof(event));
+    event.messageType = MSG_EVENT;
+    event.eventType = EVENT_MANOEUVRE;
+    event.detail = record.kind;
+    event.timeOfDayMs = record.startTod;
+    event.relativeMs = record.recoveryMs;
+    event.latitude = record.latitude * 1e-7f;
+    event.longitude = record.longitude * 1e-7f;
+    event.speed = record.minSpeedCms / 51.4444f;
+}
+
+/**
+ * @brief Affiche les manœuvres (status update)
+ *
+ * @details
+ * Exemple:
+ * Manoeuvres: 12 windows, 9 reported, 96 s captured | last tack -92°: loss 1.4 kn, recovery 5.2 s, lost 3.1 m
+ */
+void ManoeuvreCapture::printReport() {
+    static const char* KIND_NAMES[] = {"turn", "tack", "gybe"};
+    static const float CMS_TO_KN = 1.0f / 51.4444f;
+
+    Serial.printf("Manoeuvres: %u windows, %u reported, %lu s captured%s", windows, reported, captureMs / 1000,
+                  capturing ? " (capturing)" : "");
+    if (reported > 0) {
+        Serial.printf(" | last %s %+.0f°: loss %.1f kn, ", KIND_NAMES[lastRecord.kind],
+                      lastRecord.headingChangeDeci / 10.0f,
+                      (lastRecord.entrySpeedCms - lastRecord.minSpeedCms) * CMS_TO_KN);
+        if (lastRecord.recoveryMs >= 0) {
+            Serial.printf("recovery %.1f s", lastRecord.recoveryMs / 1000.0f);
+        } else {
+            Serial.print("not recovered");
+        }
+        Serial.printf(", lost %.1f m", lastRecord.distanceLostMm / 1000.0f);
+    }
+    Serial.println();
+}
+
+/**
+ * @brief Ouvre une fenêtre au plus ancien fix de moins de PRE_ROLL_MS
+ *
+ * @details
+ * Le déclenchement arrive après le début de la rotation : l'entrée (cap,
+ * vitesse de référence, position) est prise dans l'historique.
+ */
+void ManoeuvreCapture::open(const Sample& trigger) {
+    uint8_t index = 0;
+    while (index < historyCount - 1 &&
+           trigger.fixMillis - history[(historyHead + index) % HISTORY].fixMillis > PRE_ROLL_MS) {
+        index++;
+    }
+    entry = history[(historyHead + index) % HISTORY];
+    triggerMillis = trigger.fixMillis;
+
+    capturing = true;
+    windows++;
+    frame.setOrigin(entry.latitude, entry.longitude);
+    minSpeedCms = entry.speedCms;
+    recoveryMs = -1;
+    settledSince = 0;
+    minAbsWindAngleDeci = 1800;
+    for (uint8_t i = index; i < historyCount; i++) {
+        const Sample& sample = history[(historyHead + i) % HISTORY];
+        minSpeedCms = min(minSpeedCms, sample.speedCms);
+        trackWindAngle(sample.courseDeci);
+    }
+}
+
+/**
+ * @brief Ferme la fenêtre et calcule les mesures
+ * @return true si la rotation de cap justifie un rapport
+ */
+bool ManoeuvreCapture::close(const Sample& exit, ManoeuvreRecord& record) {
+    capturing = false;
+    uint32_t durationMs = exit.fixMillis - entry.fixMillis;
+    captureMs += durationMs;
+
+    float change = Geodesy::courseDelta(entry.courseDeci / 10.0f, exit.courseDeci / 10.0f);
+    int16_t changeDeci = (int16_t)lroundf(change * 10.0f);
+    if (abs(changeDeci) < MIN_CHANGE_DECI) {
+        return false;  // Wobble or bear away: window kept in the log, not reported
+    }
+
+    record.kind = MANOEUVRE_TURN;
+    if (windFromDeci >= 0) {
+        record.kind = (minAbsWindAngleDeci < 900) ? MANOEUVRE_TACK : MANOEUVRE_GYBE;
+    }
+    record.startTimestamp = entry.timestamp;
+    record.startTod = entry.tod;
+    record.durationMs = durationMs;
+    record.headingChangeDeci = changeDeci;
+    record.entrySpeedCms = entry.baselineCms;
+    record.minSpeedCms = minSpeedCms;
+    record.exitSpeedCms = exit.speedCms;
+    record.recoveryMs = recoveryMs;
+    record.latitude = entry.latitude;
+    record.longitude = entry.longitude;
+
+    // Progress on the bisector axis vs. entry speed held on both legs
+    int32_t axisDeci = entry.courseDeci + changeDeci / 2;
+    int32_t halfDeci = abs(changeDeci) / 2;
+    LocalPoint end = frame.project(exit.latitude, exit.longitude);
+    int64_t actualMm = ((int64_t)end.x * Geodesy::sinQ15(axisDeci) + (int64_t)end.y * Geodesy::cosQ15(axisDeci)) >> 15;
+    int64_t idealMm = ((int64_t)entry.baselineCms * 10 * Geodesy::cosQ15(halfDeci) >> 15) * durationMs / 1000;
+    record.distanceLostMm = (int32_t)(idealMm - actualMm);
+
+    reported++;
+    lastRecord = record;
+    return true;
+}
+
+/**
+ * @brief Suit le plus petit angle entre l'étrave et le vent
+ */
+void ManoeuvreCapture::trackWindAngle(int16_t courseDeci) {
+    if (windFromDeci < 0) {
+        return;
+    }
+    float angle = Geodesy::courseDelta(courseDeci / 10.0f, windFromDeci / 10.0f);
+    minAbsWindAngleDeci = min(minAbsWindAngleDeci, (int16_t)lroundf(fabsf(angle) * 10.0f));
+}
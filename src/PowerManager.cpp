@@ -0,0 +1,300 @@
+/**
+ * @file PowerManager.cpp
+ * @brief Implémentation de la gestion d'énergie (DFS + light sleep)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Fréquence CPU:
+ * - esp_pm_configure() (DFS) si CONFIG_PM_ENABLE est actif dans le SDK
+ * - sinon setCpuFrequencyMhz() (fréquence fixe)
+ * 80 MHz est le minimum compatible avec la radio WiFi/ESP-NOW.
+ *
+ * Light sleep (profil ENDURANCE):
+ * - Jamais pendant une rafale NMEA (UART actif depuis < RX_QUIET_MS)
+ * - Réveil timer avant min(prochaine émission, prochaine rafale prévue)
+ * - Réveil GPIO (niveau bas = bit de start) sur la broche RX du GPS en
+ *   secours : les premiers octets reçus pendant le réveil sont perdus,
+ *   d'où l'intérêt de prévoir la rafale suivante
+ * - Serial2 est l'UART2 : le réveil UART matériel n'existe que sur
+ *   UART0/1, le réveil GPIO est donc utilisé
+ * La radio est coupée pendant le light sleep : aucune trame n'est reçue
+ * (config de flotte) tant que le bateau dort.
+ */
+
+#include "PowerManager.h"
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <driver/gpio.h>
+
+// Nominal currents (ESP32 datasheet, 3.3V) used for the estimate in printReport()
+static const float RADIO_RX_MA = 95.0f;      // WiFi/ESP-NOW radio listening
+static const float CPU_240_MA = 50.0f;       // CPU at 240 MHz (on top of radio)
+static const float CPU_80_MA = 25.0f;        // CPU at 80 MHz (on top of radio)
+static const float LIGHT_SLEEP_MA = 0.8f;    // Light sleep, RTC timer + GPIO wake
+
+/**
+ * @brief Constructeur
+ */
+PowerManager::PowerManager()
+    : gps(nullptr), gpsRxPin(0), profile(POWER_PERFORMANCE), dfsActive(false),
+      burstPeriodMs(0), lastBurstStart(0), sleepUs(0), accountingSince(0), accountingFixes(0),
+      timerWakeups(0), gpioWakeups(0), latencySum(0), latencyMax(0), latencyCount(0) {
+}
+
+/**
+ * @brief Initialise la gestion d'énergie
+ * @param gps Instance GPS (activité NMEA pour planifier les réveils)
+ * @param gpsRxPin Broche RX du GPS (source de réveil GPIO)
+ * @param profile Profil initial
+ */
+void PowerManager::begin(GPS* gps, uint8_t gpsRxPin, PowerProfile profile) {
+    this->gps = gps;
+    this->gpsRxPin = gpsRxPin;
+    this->profile = profile;
+    applyFrequency();
+
+    // GPIO wake on UART start bit (line idles high)
+    gpio_wakeup_enable((gpio_num_t)gpsRxPin, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+
+    accountingSince = esp_timer_get_time();
+    accountingFixes = gps->getFixCount();
+    printProfile();
+}
+
+/**
+ * @brief Change le profil d'énergie
+ * @param profile Nouveau profil
+ *
+ * @details
+ * Les statistiques de temps sont remises à zéro pour que le rapport
+ * reflète uniquement le nouveau profil.
+ */
+void PowerManager::setProfile(PowerProfile profile) {
+    if (profile == this->profile) {
+        return;
+    }
+    this->profile = profile;
+    applyFrequency();
+
+    sleepUs = 0;
+    accountingSince = esp_timer_get_time();
+    accountingFixes = (gps != nullptr) ? gps->getFixCount() : 0;
+    timerWakeups = 0;
+    gpioWakeups = 0;
+    printProfile();
+}
+
+/**
+ * @brief Retourne le profil actif
+ */
+PowerProfile PowerManager::getProfile() const {
+    return profile;
+}
+
+/**
+ * @brief Attente de fin de boucle (remplace delay(10))
+ * @param nextDeadline millis() de la prochaine émission radio
+ *
+ * @details
+ * PERFORMANCE / BALANCED : delay(10) comme avant (le DFS, s'il est
+ * actif, baisse la fréquence pendant le delay), raccourci pour ne pas
+ * dépasser l'instant d'émission (slots TDMA courts de la fenêtre de départ).
+ *
+ * ENDURANCE : light sleep jusqu'à WAKE_GUARD_MS avant la première
+ * échéance parmi la prochaine émission et la prochaine rafale NMEA.
+ * Si l'échéance est trop proche, on revient à un delay() court pour
+ * tenir l'instant d'émission à la milliseconde près.
+ */
+void PowerManager::idle(uint32_t nextDeadline) {
+    if (profile != POWER_ENDURANCE || gps == nullptr) {
+        int32_t untilDeadline = (int32_t)(nextDeadline - millis());
+        delay(constrain(untilDeadline, (int32_t)1, (int32_t)LOOP_DELAY_MS));
+        return;
+    }
+
+    uint32_t now = millis();
+
+    // Measure NMEA burst period (EMA 1/4) to predict the next burst
+    uint32_t burstStart = gps->getBurstStartMillis();
+    if (burstStart != lastBurstStart) {
+        if (lastBurstStart != 0) {
+            uint32_t period = burstStart - lastBurstStart;
+            burstPeriodMs = (burstPeriodMs == 0) ? period : (burstPeriodMs * 3 + period) / 4;
+        }
+        lastBurstStart = burstStart;
+    }
+
+    // Never sleep while a burst is being received
+    if (now - gps->getLastRxMillis() < RX_QUIET_MS) {
+        delay(1);
+        return;
+    }
+
+    // Earliest event: next send instant or next predicted NMEA burst.
+    // Unknown period or overdue burst: rely on the GPIO wake-up.
+    int32_t untilDeadline = (int32_t)(nextDeadline - now);
+    int32_t untilBurst = (int32_t)MAX_SLEEP_MS;
+    if (burstPeriodMs > 0) {
+        int32_t predicted = (int32_t)(lastBurstStart + burstPeriodMs - now);
+        if (predicted > 0) {
+            untilBurst = predicted;
+        }
+    }
+    int32_t wait = min(min(untilDeadline, untilBurst), (int32_t)MAX_SLEEP_MS) - (int32_t)WAKE_GUARD_MS;
+
+    if (wait >= (int32_t)MIN_SLEEP_MS) {
+        lightSleep(wait);
+    } else {
+        delay(1);  // Close to an event: poll every ms to hit the send instant
+    }
+}
+
+/**
+ * @brief Enregistre une émission pour la latence fix → air
+ * @param fixMillis millis() du parsing du fix émis
+ * @param sendMillis millis() de l'appel à esp_now_send
+ */
+void PowerManager::recordBroadcast(uint32_t fixMillis, uint32_t sendMillis) {
+    if (fixMillis == 0) {
+        return;
+    }
+    uint32_t latency = sendMillis - fixMillis;
+    latencySum += latency;
+    latencyMax = max(latencyMax, latency);
+    latencyCount++;
+}
+
+/**
+ * @brief Affiche le rapport d'énergie (status update)
+ *
+ * @details
+ * Exemple:
+ * Power: ENDURANCE 80 MHz | sleep 71.3% (timer 412, gpio 3) | est. 28.1 mA | est. 135 mJ/fix |
+ *        fix->air avg 184 ms max 402 ms
+ *
+ * Le courant affiché est une estimation à partir de valeurs nominales
+ * (ESP32 seul, sans module GPS ni LED). L'énergie par fix ajoute le
+ * courant nominal du récepteur GNSS dans son mode courant (3,3 V).
+ * Aucun profil n'a encore été mesuré sur carte (POWER_MANAGEMENT.md) :
+ * seuls le taux de veille et la latence sont des mesures.
+ */
+void PowerManager::printReport() {
+    static const char* PROFILE_NAMES[] = {"PERFORMANCE", "BALANCED", "ENDURANCE"};
+
+    uint64_t elapsedUs = esp_timer_get_time() - accountingSince;
+    float sleepPct = elapsedUs > 0 ? 100.0f * sleepUs / elapsedUs : 0.0f;
+
+    Serial.printf("Power: %s %lu MHz | sleep %.1f%% (timer %lu, gpio %lu) | est. %.1f mA",
+                  PROFILE_NAMES[profile], getCpuFrequencyMhz(), sleepPct,
+                  timerWakeups, gpioWakeups, estimatedCurrentMa());
+    if (gps != nullptr && gps->getFixCount() > accountingFixes) {
+        float totalMa = estimatedCurrentMa() + gps->getReceiverCurrentMa();
+        float energyMj = totalMa * 3.3f * (elapsedUs / 1000000.0f);
+        Serial.printf(" | est. %.0f mJ/fix", energyMj / (gps->getFixCount() - accountingFixes));
+    }
+    if (latencyCount > 0) {
+        Serial.printf(" | fix->air avg %lu ms max %lu ms\n",
+                      latencySum / latencyCount, latencyMax);
+    } else {
+        Serial.println();
+    }
+
+    latencySum = 0;
+    latencyMax = 0;
+    latencyCount = 0;
+}
+
+/**
+ * @brief Affiche le profil appliqué
+ *
+ * @details
+ * En ENDURANCE, rappelle que la radio est coupée pendant la veille : les
+ * trames reçues à ce moment-là sont perdues.
+ */
+void PowerManager::printProfile() {
+    Serial.printf("✓ Power: profile %d, CPU %lu MHz%s\n",
+                  profile, getCpuFrequencyMhz(), dfsActive ? " (DFS)" : "");
+    if (profile == POWER_ENDURANCE) {
+        Serial.println("⚠️  Power: ESP-NOW reception only while awake (config, countdown, wind and "
+                       "other boats partly missed)");
+    }
+}
+
+/**
+ * @brief Applique la fréquence CPU du profil courant
+ *
+ * @details
+ * Essaie d'abord le DFS (esp_pm) : la fréquence descend à 40 MHz
+ * quand aucun verrou n'est tenu (la pile WiFi garde l'APB à 80 MHz
+ * quand elle en a besoin). Sans CONFIG_PM_ENABLE, fréquence fixe.
+ */
+void PowerManager::applyFrequency() {
+    uint32_t maxFreq = (profile == POWER_PERFORMANCE) ? 240 : 80;
+
+#ifdef CONFIG_IDF_TARGET_ESP32S3
+    esp_pm_config_esp32s3_t pmConfig;
+#else
+    esp_pm_config_esp32_t pmConfig;
+#endif
+    pmConfig.max_freq_mhz = maxFreq;
+    pmConfig.min_freq_mhz = (profile == POWER_PERFORMANCE) ? maxFreq : 40;
+    pmConfig.light_sleep_enable = false;  // Light sleep is driven explicitly by idle()
+
+    dfsActive = (esp_pm_configure(&pmConfig) == ESP_OK) && (profile != POWER_PERFORMANCE);
+    if (!dfsActive) {
+        setCpuFrequencyMhz(maxFreq);
+    }
+}
+
+/**
+ * @brief Entre en light sleep
+ * @param durationMs Durée maximale (réveil timer)
+ */
+void PowerManager::lightSleep(uint32_t durationMs) {
+    Serial.flush();  // Pending log bytes would be lost
+
+    int64_t start = esp_timer_get_time();
+    esp_sleep_enable_timer_wakeup((uint64_t)durationMs * 1000ULL);
+    esp_light_sleep_start();
+    sleepUs += esp_timer_get_time() - start;
+
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO) {
+        gpioWakeups++;
+    } else {
+        timerWakeups++;
+    }
+}
+
+/**
+ * @brief Courant moyen estimé (modèle nominal)
+ * @return Courant moyen en mA depuis le dernier changement de profil
+ */
+float PowerManager::estimatedCurrentMa() const {
+    uint64_t elapsedUs = esp_timer_get_time() - accountingSince;
+    if (elapsedUs == 0) {
+        return 0.0f;
+    }
+    float activeMa = RADIO_RX_MA + (profile == POWER_PERFORMANCE ? CPU_240_MA : CPU_80_MA);
+    float sleepRatio = (float)sleepUs / elapsedUs;
+    return activeMa * (1.0f - sleepRatio) + LIGHT_SLEEP_MA * sleepRatio;
+}
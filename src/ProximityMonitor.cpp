@@ -0,0 +1,407 @@
+/**
+ * @file ProximityMonitor.cpp
+ * @brief Implémentation de l'alerte de proximité
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Coût par fix borné: (2 × searchCells + 1)² têtes de liste, plus les
+ * bateaux des seaux parcourus. BUCKETS (256) dépasse les 169 cases de la
+ * recherche la plus large, et un masque de 256 bits fait parcourir chaque
+ * seau une seule fois par fix même si plusieurs cases y tombent : un
+ * bateau est visité au plus une fois, et seuls ceux des cases voisines
+ * sont évalués.
+ * L'expiration des bateaux muets est répartie sur les fixes
+ * (SWEEP_PER_FIX entrées par fix).
+ */
+
+#include "ProximityMonitor.h"
+
+static const int32_t MAX_OFFSET_E7 = 10000000;  // 1° from the frame origin: not a neighbour
+
+/**
+ * @brief Constructeur
+ */
+ProximityMonitor::ProximityMonitor()
+    : boatCount(0), sweepIndex(0), horizonMs(0), searchCells(0),
+      level(PROXIMITY_CLEAR), threatCpaMm(0), threatTcpaMs(0),
+      accepted(0), evicted(0), alerts(0), checksSum(0), checksMax(0), lastChecks(0), lastVisits(0),
+      cyclesSum(0), cyclesMax(0), cyclesCount(0) {
+    for (uint8_t i = 0; i < MAX_BOATS; i++) {
+        boats[i].bucket = FREE;
+        boats[i].next = NONE;
+    }
+    memset(heads, NONE, sizeof(heads));
+    threatName[0] = '\0';
+    setHorizon(10);
+}
+
+/**
+ * @brief Horizon d'alerte
+ * @param tcpaS Temps jusqu'au CPA au-delà duquel un rapprochement est ignoré (s, 0 = pas d'alerte)
+ *
+ * @details
+ * Rayon de recherche: rapprochement maximal sur l'horizon, plus la
+ * distance de CPA. Au-delà de MAX_SEARCH_CELLS (environ 200 m, la portée
+ * ESP-NOW), la recherche est tronquée.
+ */
+void ProximityMonitor::setHorizon(uint8_t tcpaS) {
+    horizonMs = (uint32_t)tcpaS * 1000;
+    uint32_t radiusMm = (uint32_t)MAX_CLOSING_MMPS * tcpaS + CPA_DISTANCE_MM;
+    uint32_t cells = (radiusMm + (1UL << CELL_SHIFT) - 1) >> CELL_SHIFT;
+    searchCells = (uint8_t)min(cells, (uint32_t)MAX_SEARCH_CELLS);
+}
+
+/**
+ * @brief Met à jour la table avec une position reçue
+ * @param mac Adresse MAC de l'émetteur
+ * @param packet Trame reçue
+ * @param receivedAt millis() à la réception
+ * @return true si la position est prise en compte
+ *
+ * @details
+ * Les trames relayées par le Hub (ttl = 0) portent la MAC du Hub et
+ * arrivent en retard : seules les trames reçues en direct comptent, et
+ * un bateau hors de portée radio n'est pas un voisin. Les fixes marqués
+ * aberrants par l'émetteur (quality) sont ignorés. Les répétitions
+ * (même numéro de séquence) sont ignorées ; un numéro plus petit n'est
+ * accepté qu'après STALE_MS (redémarrage de l'émetteur).
+ */
+bool ProximityMonitor::applyBoat(const uint8_t* mac, const GPSBroadcastPacket& packet, uint32_t receivedAt) {
+    if (packet.ttl == 0 || packet.quality != FIX_GOOD || !(packet.speed >= 0.0f && packet.speed <= MAX_SPEED_KN) ||
+        !(fabsf(packet.latitude) <= 90.0f) || !(fabsf(packet.longitude) <= 180.0f)) {
+        return false;
+    }
+
+    uint8_t index = NONE;
+    for (uint8_t i = 0; i < MAX_BOATS; i++) {
+        if (boats[i].bucket != FREE && memcmp(boats[i].mac, mac, 6) == 0) {
+            index = i;
+            break;
+        }
+    }
+    if (index != NONE && (int32_t)(packet.sequenceNumber - boats[index].sequenceNumber) <= 0 &&
+        (int32_t)(receivedAt - boats[index].receivedAt) <= (int32_t)STALE_MS) {
+        return false;
+    }
+
+    int32_t lat = Geodesy::toE7(packet.latitude);
+    int32_t lon = Geodesy::toE7(packet.longitude);
+    if (!frame.hasOrigin()) {
+        frame.setOrigin(lat, lon);
+    }
+    if (llabs((int64_t)lat - frame.getOriginLat()) > MAX_OFFSET_E7 ||
+        llabs((int64_t)lon - frame.getOriginLon()) > MAX_OFFSET_E7) {
+        return false;
+    }
+
+    if (index == NONE) {
+        index = allocate();
+        memcpy(boats[index].mac, mac, 6);
+        boatCount++;
+    }
+    Neighbour& boat = boats[index];
+    memcpy(boat.name, packet.name, sizeof(boat.name) - 1);   // Fixed 18-byte field
+    boat.name[sizeof(boat.name) - 1] = '\0';
+    boat.latitude = lat;
+    boat.longitude = lon;
+    Geodesy::velocityMmps(packet.speed, packet.heading, boat.vx, boat.vy);
+    boat.receivedAt = receivedAt;
+    boat.sequenceNumber = packet.sequenceNumber;
+    place(index);
+    accepted++;
+    return true;
+}
+
+/**
+ * @brief Évalue les voisins pour un nouveau fix
+ * @param data Nouveau fix
+ * @return Niveau d'alerte courant
+ *
+ * @details
+ * Les positions des voisins sont extrapolées à l'instant du fix avec leur
+ * vitesse (réception plus ancienne ou plus récente que le fix). Calcul en
+ * float32 : résolution meilleure que 1 mm jusqu'à 16 km.
+ */
+ProximityLevel ProximityMonitor::update(const GPSData& data) {
+    uint32_t startCycles = ESP.getCycleCount();
+    ProximityLevel previous = level;
+    level = PROXIMITY_CLEAR;
+    threatName[0] = '\0';
+    threatCpaMm = 0;
+    threatTcpaMs = 0;
+    lastChecks = 0;
+    lastVisits = 0;
+    if (!data.valid || horizonMs == 0) {
+        return level;
+    }
+
+    int32_t lat = Geodesy::toE7(data.latitude);
+    int32_t lon = Geodesy::toE7(data.longitude);
+    if (!frame.hasOrigin()) {
+        frame.setOrigin(lat, lon);
+    }
+    LocalPoint own = frame.project(lat, lon);
+    if (abs(own.x) > RECENTRE_MM || abs(own.y) > RECENTRE_MM) {
+        recentre(lat, lon);
+        own.x = 0;
+        own.y = 0;
+    }
+    int32_t ownVx;
+    int32_t ownVy;
+    Geodesy::velocityMmps(data.speed, data.course, ownVx, ownVy);
+
+    // Boats not heard for STALE_MS leave the table, a few slots per fix
+    for (uint8_t i = 0; i < SWEEP_PER_FIX; i++) {
+        Neighbour& boat = boats[sweepIndex];
+        if (boat.bucket != FREE && (int32_t)(data.fixMillis - boat.receivedAt) > (int32_t)STALE_MS) {
+            unlink(sweepIndex);
+            boatCount--;
+        }
+        sweepIndex = (sweepIndex + 1) % MAX_BOATS;
+    }
+
+    static const float CPA2 = (float)CPA_DISTANCE_MM * (float)CPA_DISTANCE_MM;
+    static const float DANGER2 = (float)DANGER_DISTANCE_MM * (float)DANGER_DISTANCE_MM;
+    int16_t ownCellX = cellOf(own.x);
+    int16_t ownCellY = cellOf(own.y);
+    int16_t range = searchCells;
+    uint32_t checks = 0;
+    uint32_t visits = 0;
+    uint64_t walked[BUCKETS / 64] = {0};   // Buckets already walked in this update()
+
+    for (int16_t dy = -range; dy <= range; dy++) {
+        for (int16_t dx = -range; dx <= range; dx++) {
+            uint16_t bucket = bucketOf(ownCellX + dx, ownCellY + dy);
+            uint64_t bit = 1ULL << (bucket & 63);
+            if (walked[bucket >> 6] & bit) {
+                continue;
+            }
+            walked[bucket >> 6] |= bit;
+            for (uint8_t i = heads[bucket]; i != NONE; i = boats[i].next) {
+                const Neighbour& boat = boats[i];
+                visits++;
+                int32_t age = (int32_t)(data.fixMillis - boat.receivedAt);
+                if (abs(boat.cellX - ownCellX) > range || abs(boat.cellY - ownCellY) > range ||
+                    age > (int32_t)STALE_MS) {
+                    continue;
+                }
+                checks++;
+
+                // Relative position at the fix, relative velocity
+                float rx = (float)(boat.position.x - own.x) + boat.vx * (age * 0.001f);
+                float ry = (float)(boat.position.y - own.y) + boat.vy * (age * 0.001f);
+                float vx = (float)(boat.vx - ownVx);
+                float vy = (float)(boat.vy - ownVy);
+                float distance2 = rx * rx + ry * ry;
+                float dot = rx * vx + ry * vy;
+                float speed2 = vx * vx + vy * vy;
+
+                float tcpaS = 0.0f;
+                float cpa2 = distance2;
+                if (dot < 0.0f && speed2 > 0.0f) {
+                    tcpaS = -dot / speed2;
+                    float ex = rx + vx * tcpaS;
+                    float ey = ry + vy * tcpaS;
+                    cpa2 = ex * ex + ey * ey;
+                }
+                uint32_t tcpaMs = (uint32_t)(tcpaS * 1000.0f);
+
+                ProximityLevel candidate = PROXIMITY_CLEAR;
+                if (distance2 < DANGER2) {
+                    candidate = PROXIMITY_DANGER;
+                } else if (tcpaMs > 0 && tcpaMs <= horizonMs && cpa2 < CPA2) {
+                    candidate = (tcpaMs <= DANGER_TCPA_MS) ? PROXIMITY_DANGER : PROXIMITY_CONVERGING;
+                }
+                if (candidate > level || (candidate != PROXIMITY_CLEAR && candidate == level && tcpaMs < threatTcpaMs)) {
+                    level = candidate;
+                    memcpy(threatName, boat.name, sizeof(threatName));
+                    threatCpaMm = (uint32_t)sqrtf(cpa2);
+                    threatTcpaMs = tcpaMs;
+                }
+            }
+        }
+    }
+
+    if (previous == PROXIMITY_CLEAR && level != PROXIMITY_CLEAR) {
+        alerts++;
+    }
+    uint32_t cycles = ESP.getCycleCount() - startCycles;
+    cyclesSum += cycles;
+    cyclesMax = max(cyclesMax, cycles);
+    cyclesCount++;
+    checksSum += checks;
+    checksMax = max(checksMax, checks);
+    lastChecks = checks;
+    lastVisits = visits;
+    return level;
+}
+
+ProximityLevel ProximityMonitor::getLevel() const {
+    return level;
+}
+
+const char* ProximityMonitor::getThreatName() const {
+    return threatName;
+}
+
+uint32_t ProximityMonitor::getThreatCpaMm() const {
+    return threatCpaMm;
+}
+
+uint32_t ProximityMonitor::getThreatTcpaMs() const {
+    return threatTcpaMs;
+}
+
+uint8_t ProximityMonitor::getBoatCount() const {
+    return boatCount;
+}
+
+uint32_t ProximityMonitor::getLastChecks() const {
+    return lastChecks;
+}
+
+uint32_t ProximityMonitor::getLastVisits() const {
+    return lastVisits;
+}
+
+/**
+ * @brief Affiche la table et l'alerte (status update)
+ *
+ * @details
+ * Exemple:
+ * Proximity: 10 s horizon, 47 boats (0 evicted), 3 alerts | converging BOAT12: CPA 4.2 m in 6.1 s | 2.4 CPA/fix (max 7), 1900 cycles/fix (max 4100)
+ */
+void ProximityMonitor::printReport() {
+    if (horizonMs == 0) {
+        Serial.printf("Proximity: alerts off, %u boats\n", boatCount);
+        return;
+    }
+    Serial.printf("Proximity: %lu s horizon, %u boats (%lu evicted), %lu alerts", horizonMs / 1000, boatCount,
+                  evicted, alerts);
+    if (level != PROXIMITY_CLEAR) {
+        Serial.printf(" | %s %s: CPA %.1f m in %.1f s", (level == PROXIMITY_DANGER) ? "DANGER" : "converging",
+                      threatName, threatCpaMm / 1000.0f, threatTcpaMs / 1000.0f);
+    }
+    if (cyclesCount > 0) {
+        Serial.printf(" | %.1f CPA/fix (max %lu), %lu cycles/fix (max %lu)", (float)checksSum / cyclesCount,
+                      checksMax, cyclesSum / cyclesCount, cyclesMax);
+    }
+    Serial.println();
+
+    checksSum = 0;
+    checksMax = 0;
+    cyclesSum = 0;
+    cyclesMax = 0;
+    cyclesCount = 0;
+}
+
+/**
+ * @brief Seau d'une case (mélange des deux coordonnées)
+ */
+uint16_t ProximityMonitor::bucketOf(int16_t cellX, int16_t cellY) {
+    uint32_t hash = (uint32_t)(uint16_t)cellX * 73856093UL ^ (uint32_t)(uint16_t)cellY * 19349663UL;
+    return (uint16_t)((hash ^ (hash >> 16)) & (BUCKETS - 1));
+}
+
+/**
+ * @brief Case d'une coordonnée du repère (arrondi vers -∞)
+ */
+int16_t ProximityMonitor::cellOf(int32_t mm) {
+    return (int16_t)constrain(mm >> CELL_SHIFT, (int32_t)-32768, (int32_t)32767);
+}
+
+void ProximityMonitor::link(uint8_t index) {
+    Neighbour& boat = boats[index];
+    boat.bucket = bucketOf(boat.cellX, boat.cellY);
+    boat.next = heads[boat.bucket];
+    heads[boat.bucket] = index;
+}
+
+void ProximityMonitor::unlink(uint8_t index) {
+    Neighbour& boat = boats[index];
+    uint8_t* slot = &heads[boat.bucket];
+    while (*slot != NONE) {
+        if (*slot == index) {
+            *slot = boat.next;
+            break;
+        }
+        slot = &boats[*slot].next;
+    }
+    boat.bucket = FREE;
+    boat.next = NONE;
+}
+
+/**
+ * @brief Projette un bateau et le change de case si besoin
+ */
+void ProximityMonitor::place(uint8_t index) {
+    Neighbour& boat = boats[index];
+    boat.position = frame.project(boat.latitude, boat.longitude);
+    int16_t cellX = cellOf(boat.position.x);
+    int16_t cellY = cellOf(boat.position.y);
+    if (boat.bucket != FREE && cellX == boat.cellX && cellY == boat.cellY) {
+        return;
+    }
+    if (boat.bucket != FREE) {
+        unlink(index);
+    }
+    boat.cellX = cellX;
+    boat.cellY = cellY;
+    link(index);
+}
+
+/**
+ * @brief Case libre, sinon le bateau entendu il y a le plus longtemps
+ */
+uint8_t ProximityMonitor::allocate() {
+    uint8_t oldest = 0;
+    for (uint8_t i = 0; i < MAX_BOATS; i++) {
+        if (boats[i].bucket == FREE) {
+            return i;
+        }
+        if ((int32_t)(boats[i].receivedAt - boats[oldest].receivedAt) < 0) {
+            oldest = i;
+        }
+    }
+    unlink(oldest);
+    boatCount--;
+    evicted++;
+    return oldest;
+}
+
+/**
+ * @brief Déplace l'origine du repère et reprojette la table (rare : 10 km)
+ */
+void ProximityMonitor::recentre(int32_t latE7, int32_t lonE7) {
+    frame.setOrigin(latE7, lonE7);
+    for (uint8_t i = 0; i < MAX_BOATS; i++) {
+        if (boats[i].bucket == FREE) {
+            continue;
+        }
+        if (llabs((int64_t)boats[i].latitude - latE7) > MAX_OFFSET_E7 ||
+            llabs((int64_t)boats[i].longitude - lonE7) > MAX_OFFSET_E7) {
+            unlink(i);
+            boatCount--;
+        } else {
+            place(i);
+        }
+    }
+}
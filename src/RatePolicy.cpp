@@ -0,0 +1,197 @@
+/**
+ * @file RatePolicy.cpp
+ * @brief Implémentation de la cadence adaptative
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Le taux de virage est calculé entre deux fixes consécutifs à partir du
+ * cap (COG), ramené dans [-180, 180], puis lissé (EMA 1/2). Sous
+ * MIN_COURSE_SPEED le cap GPS n'a pas de sens : le taux est remis à zéro.
+ */
+
+#include "RatePolicy.h"
+#include "Geodesy.h"
+
+/**
+ * @brief Constructeur
+ */
+RatePolicy::RatePolicy()
+    : baseIntervalMs(1000), adaptive(false), budgetDeciHz(20), tdma(false),
+      targetIntervalMs(1000), overrideIntervalMs(0), holdUntil(0), turnRate(0), lastCourse(0), lastFixMillis(0),
+      tokens(0), lastRefill(0), throttled(0) {
+}
+
+/**
+ * @brief Applique la configuration
+ * @param baseIntervalMs Intervalle en route stable
+ * @param adaptive Cadence adaptative activée
+ * @param budgetDeciHz Cadence moyenne maximale par bateau (0,1 Hz)
+ * @param tdma TDMA actif
+ */
+void RatePolicy::configure(uint16_t baseIntervalMs, bool adaptive, uint8_t budgetDeciHz, bool tdma) {
+    this->baseIntervalMs = baseIntervalMs;
+    this->adaptive = adaptive;
+    this->budgetDeciHz = budgetDeciHz;
+    this->tdma = tdma;
+    targetIntervalMs = baseIntervalMs;
+    holdUntil = 0;
+
+    // Start with a full bucket
+    tokens = (uint32_t)budgetDeciHz * BUDGET_BURST_S * TOKEN / 10;
+    lastRefill = millis();
+}
+
+/**
+ * @brief Met à jour la cadence à partir d'un nouveau fix
+ * @param data Fix GPS
+ */
+void RatePolicy::update(const GPSData& data) {
+    refill(millis());
+
+    if (lastFixMillis != 0 && data.fixMillis != lastFixMillis && data.speed >= MIN_COURSE_SPEED) {
+        float delta = Geodesy::courseDelta(lastCourse, data.course);
+        float rate = fabsf(delta) * 1000.0f / (data.fixMillis - lastFixMillis);
+        turnRate = (turnRate + rate) / 2.0f;
+    } else if (data.speed < MIN_COURSE_SPEED) {
+        turnRate = 0.0f;
+    }
+    lastCourse = data.course;
+    lastFixMillis = data.fixMillis;
+
+    if (!adaptive || !data.valid) {
+        targetIntervalMs = baseIntervalMs;
+        return;
+    }
+
+    uint16_t wanted;
+    if (turnRate > MANOEUVRE_TURN_RATE) {
+        wanted = MANOEUVRE_INTERVAL_MS;
+    } else if (data.speed > FAST_SPEED) {
+        wanted = min((uint16_t)FAST_INTERVAL_MS, baseIntervalMs);
+    } else if (data.speed < STATIONARY_SPEED) {
+        wanted = max((uint16_t)STATIONARY_INTERVAL_MS, baseIntervalMs);
+    } else {
+        wanted = baseIntervalMs;
+    }
+
+    // Faster rates apply at once, slower ones only after RATE_HOLD_MS
+    if (wanted <= targetIntervalMs) {
+        if (wanted < baseIntervalMs) {
+            holdUntil = data.fixMillis + RATE_HOLD_MS;
+        }
+        targetIntervalMs = wanted;
+    } else if ((int32_t)(data.fixMillis - holdUntil) >= 0) {
+        targetIntervalMs = wanted;
+    }
+}
+
+/**
+ * @brief Enregistre une émission (un jeton)
+ * @param now millis() de l'émission
+ */
+void RatePolicy::recordBroadcast(uint32_t now) {
+    refill(now);
+    if (tokens >= TOKEN) {
+        tokens -= TOKEN;
+    } else {
+        tokens = 0;
+        throttled++;
+    }
+}
+
+/**
+ * @brief Impose un intervalle (fenêtre coordonnée)
+ * @param intervalMs Intervalle forcé, 0 = politique adaptative
+ */
+void RatePolicy::setOverride(uint16_t intervalMs) {
+    overrideIntervalMs = intervalMs;
+}
+
+/**
+ * @brief Un intervalle forcé est actif
+ */
+bool RatePolicy::hasOverride() const {
+    return overrideIntervalMs != 0;
+}
+
+/**
+ * @brief Intervalle jusqu'à la prochaine émission
+ * @return Intervalle en millisecondes (budget et TDMA appliqués)
+ */
+uint16_t RatePolicy::getIntervalMs() const {
+    if (overrideIntervalMs != 0) {
+        return overrideIntervalMs;
+    }
+    uint16_t interval = targetIntervalMs;
+
+    // Empty bucket: fall back to the average budget rate
+    if (tokens < TOKEN && budgetDeciHz > 0) {
+        interval = max(interval, (uint16_t)(10000 / budgetDeciHz));
+    }
+
+    // TDMA: whole multiples of the base interval keep the slot position
+    if (tdma) {
+        uint16_t periods = (interval + baseIntervalMs - 1) / baseIntervalMs;
+        interval = max((uint16_t)1, periods) * baseIntervalMs;
+    }
+    return interval;
+}
+
+/**
+ * @brief Cadence courante en 0,1 Hz
+ */
+uint8_t RatePolicy::getRateDeciHz() const {
+    uint16_t interval = getIntervalMs();
+    return (uint8_t)min(10000U / interval, 255U);
+}
+
+/**
+ * @brief Taux de virage lissé (°/s)
+ */
+float RatePolicy::getTurnRate() const {
+    return turnRate;
+}
+
+/**
+ * @brief Affiche la cadence (status update)
+ *
+ * @details
+ * Exemple:
+ * Rate: adaptive 5.0 Hz (turn 14.2 deg/s) | budget 2.0 Hz, bucket 12.4 frames, 0 throttled
+ */
+void RatePolicy::printReport() {
+    Serial.printf("Rate: %s %.1f Hz (turn %.1f deg/s) | budget %.1f Hz, bucket %.1f frames, %lu throttled\n",
+                  adaptive ? "adaptive" : "fixed",
+                  getRateDeciHz() / 10.0f, turnRate,
+                  budgetDeciHz / 10.0f, tokens / (float)TOKEN, throttled);
+}
+
+/**
+ * @brief Remplit le seau à jetons
+ * @param now millis() courant
+ */
+void RatePolicy::refill(uint32_t now) {
+    uint32_t elapsed = min(now - lastRefill, (uint32_t)(BUDGET_BURST_S * 1000));
+    lastRefill = now;
+    uint32_t capacity = (uint32_t)budgetDeciHz * BUDGET_BURST_S * TOKEN / 10;
+    // budgetDeciHz / 10 frames per second = budgetDeciHz / 10 tokens per ms
+    tokens = min(tokens + elapsed * budgetDeciHz / 10, capacity);
+}
@@ -0,0 +1,321 @@
+/**
+ * @file SessionStats.cpp
+ * @brief Implémentation des statistiques de session
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Classement virement / empannage: entre deux fixes « établis » (angle
+ * du vent entre 30° et 165° du cap), on retient le plus petit angle du
+ * vent rencontré. S'il est passé sous 90°, l'étrave est passée dans le
+ * vent : virement. Sinon le changement de bord s'est fait vent arrière :
+ * empannage.
+ */
+
+#include "SessionStats.h"
+
+// ============================================================================
+// SpeedWindow
+// ============================================================================
+
+/**
+ * @brief Constructeur
+ * @param windowMs Durée de la fenêtre (ms)
+ */
+SpeedWindow::SpeedWindow(uint32_t windowMs)
+    : windowMs(windowMs), head(0), count(0), sumCms(0) {
+}
+
+/**
+ * @brief Vide la fenêtre
+ */
+void SpeedWindow::clear() {
+    head = 0;
+    count = 0;
+    sumCms = 0;
+}
+
+/**
+ * @brief Ajoute un échantillon et retire ceux sortis de la fenêtre
+ *
+ * @details
+ * Chaque échantillon entre et sort une seule fois : coût amorti O(1).
+ * Anneau plein (cadence supérieure à 10 Hz) : le plus ancien est retiré.
+ */
+void SpeedWindow::push(uint32_t fixMillis, uint16_t speedCms, int16_t courseDeci) {
+    while (count > 0 && (fixMillis - samples[head].fixMillis > windowMs || count == CAPACITY)) {
+        sumCms -= samples[head].speedCms;
+        head = (head + 1) % CAPACITY;
+        count--;
+    }
+    Sample& sample = samples[(head + count) % CAPACITY];
+    sample.fixMillis = fixMillis;
+    sample.speedCms = speedCms;
+    sample.courseDeci = courseDeci;
+    sumCms += speedCms;
+    count++;
+}
+
+uint16_t SpeedWindow::getAverageCms() const {
+    return count > 0 ? (uint16_t)(sumCms / count) : 0;
+}
+
+int16_t SpeedWindow::getOldestCourseDeci() const {
+    return count > 0 ? samples[head].courseDeci : 0;
+}
+
+uint32_t SpeedWindow::getSpanMs() const {
+    if (count < 2) {
+        return 0;
+    }
+    return samples[(head + count - 1) % CAPACITY].fixMillis - samples[head].fixMillis;
+}
+
+// ============================================================================
+// SessionStats
+// ============================================================================
+
+/**
+ * @brief Constructeur
+ */
+SessionStats::SessionStats()
+    : window2s(2000), window10s(10000), windFromDeci(-1) {
+    reset();
+}
+
+/**
+ * @brief Démarre une nouvelle session
+ *
+ * @details
+ * La référence de vent est conservée : elle ne dépend pas de la session.
+ */
+void SessionStats::reset() {
+    lastLat = 0;
+    lastLon = 0;
+    lastFixMillis = 0;
+    startTimestamp = 0;
+    lastTimestamp = 0;
+    movingMs = 0;
+    distanceMm = 0;
+    window2s.clear();
+    window10s.clear();
+    maxSpeedCms = 0;
+    manoeuvres = 0;
+    lastManoeuvreMs = 0;
+    tacks = 0;
+    gybes = 0;
+    side = TACK_UNKNOWN;
+    minAbsWindAngleDeci = 1800;
+    for (uint8_t i = 0; i < 3; i++) {
+        tackMs[i] = 0;
+    }
+}
+
+/**
+ * @brief Direction de vent de référence
+ * @param fromDeg Direction d'où vient le vent (degrés), négatif = inconnue
+ *
+ * @details
+ * Le vent de l'anémomètre varie à chaque mesure : le bord en cours est
+ * conservé tant que la référence bouge de moins de REFERENCE_SHIFT_DECI.
+ * Au-delà (ou changement de source), les bords ne sont plus comparables.
+ */
+void SessionStats::setWindDirection(float fromDeg) {
+    int32_t deci = (fromDeg < 0) ? -1 : ((int32_t)lroundf(fromDeg * 10.0f) % 3600);
+    if (deci == windFromDeci) {
+        return;
+    }
+    bool comparable = deci >= 0 && windFromDeci >= 0 &&
+                      fabsf(Geodesy::courseDelta(windFromDeci / 10.0f, deci / 10.0f)) * 10.0f < REFERENCE_SHIFT_DECI;
+    windFromDeci = deci;
+    if (!comparable) {
+        side = TACK_UNKNOWN;       // Sides are only compared under the same reference
+        minAbsWindAngleDeci = 1800;
+    }
+}
+
+/**
+ * @brief Met à jour les statistiques avec un nouveau fix
+ * @param data Nouveau fix
+ */
+void SessionStats::update(const GPSData& data) {
+    if (!data.valid || data.fixMillis == lastFixMillis) {
+        return;
+    }
+
+    int32_t lat = Geodesy::toE7(data.latitude);
+    int32_t lon = Geodesy::toE7(data.longitude);
+    uint16_t speedCms = (uint16_t)constrain(data.speed * 51.4444f, 0.0f, 65535.0f);
+    int16_t courseDeci = (int16_t)(((int32_t)(data.course * 10.0f) % 3600 + 3600) % 3600);
+
+    if (lastFixMillis == 0) {
+        startTimestamp = data.timestamp;
+        frame.setOrigin(lat, lon);
+    } else {
+        uint32_t dt = data.fixMillis - lastFixMillis;
+        if (dt <= MAX_LEG_MS && speedCms >= MOVING_CMS) {
+            LocalPoint from = frame.project(lastLat, lastLon);
+            LocalPoint to = frame.project(lat, lon);
+            distanceMm += Geodesy::distanceMm(from, to);
+            movingMs += dt;
+            if (side != TACK_UNKNOWN) {
+                tackMs[side] += dt;
+            }
+            if ((uint32_t)abs(to.x) > RECENTRE_MM || (uint32_t)abs(to.y) > RECENTRE_MM) {
+                frame.setOrigin(lat, lon);
+            }
+        }
+    }
+    lastLat = lat;
+    lastLon = lon;
+    lastFixMillis = data.fixMillis;
+    lastTimestamp = data.timestamp;
+
+    // Sliding averages, max on the 2 s average
+    window2s.push(data.fixMillis, speedCms, courseDeci);
+    window10s.push(data.fixMillis, speedCms, courseDeci);
+    if (window2s.getSpanMs() >= 1000) {
+        maxSpeedCms = max(maxSpeedCms, window2s.getAverageCms());
+    }
+
+    if (speedCms < COURSE_CMS) {
+        return;  // Course is noise at this speed
+    }
+
+    // Manoeuvre: large course change over the 10 s window
+    if (window10s.getSpanMs() >= 5000 && data.fixMillis - lastManoeuvreMs >= MANOEUVRE_GAP_MS) {
+        float delta = Geodesy::courseDelta(window10s.getOldestCourseDeci() / 10.0f, courseDeci / 10.0f);
+        if (fabsf(delta) * 10.0f >= MANOEUVRE_DECI) {
+            manoeuvres++;
+            lastManoeuvreMs = data.fixMillis;
+        }
+    }
+
+    // Tack side from the wind angle (> 0 = wind over starboard)
+    if (windFromDeci >= 0) {
+        int16_t angle = (int16_t)lroundf(Geodesy::courseDelta(courseDeci / 10.0f, windFromDeci / 10.0f) * 10.0f);
+        int16_t absAngle = abs(angle);
+        minAbsWindAngleDeci = min(minAbsWindAngleDeci, absAngle);
+        if (absAngle >= SETTLED_MIN_DECI && absAngle <= SETTLED_MAX_DECI) {
+            TackSide current = (angle > 0) ? TACK_STARBOARD : TACK_PORT;
+            if (side != TACK_UNKNOWN && current != side) {
+                if (minAbsWindAngleDeci < 900) {
+                    tacks++;
+                } else {
+                    gybes++;
+                }
+            }
+            side = current;
+            minAbsWindAngleDeci = absAngle;
+        }
+    }
+}
+
+bool SessionStats::hasData() const {
+    return lastFixMillis != 0;
+}
+
+uint32_t SessionStats::getStartTimestamp() const {
+    return startTimestamp;
+}
+
+uint32_t SessionStats::getDurationS() const {
+    return lastTimestamp - startTimestamp;
+}
+
+uint32_t SessionStats::getMovingS() const {
+    return movingMs / 1000;
+}
+
+uint32_t SessionStats::getDistanceM() const {
+    return (uint32_t)(distanceMm / 1000);
+}
+
+uint16_t SessionStats::getSpeed2sCms() const {
+    return window2s.getAverageCms();
+}
+
+uint16_t SessionStats::getSpeed10sCms() const {
+    return window10s.getAverageCms();
+}
+
+uint16_t SessionStats::getMaxSpeedCms() const {
+    return maxSpeedCms;
+}
+
+/**
+ * @brief Vitesse moyenne en mouvement (cm/s)
+ */
+uint16_t SessionStats::getAverageSpeedCms() const {
+    if (movingMs == 0) {
+        return 0;
+    }
+    return (uint16_t)min(distanceMm * 100 / movingMs, (uint64_t)65535);
+}
+
+uint16_t SessionStats::getManoeuvres() const {
+    return manoeuvres;
+}
+
+uint16_t SessionStats::getTacks() const {
+    return tacks;
+}
+
+uint16_t SessionStats::getGybes() const {
+    return gybes;
+}
+
+TackSide SessionStats::getSide() const {
+    return side;
+}
+
+uint32_t SessionStats::getTackTimeS(TackSide side) const {
+    return tackMs[side] / 1000;
+}
+
+/**
+ * @brief Affiche les statistiques (status update)
+ *
+ * @details
+ * Exemple:
+ * Session: 12.41 km in 3733 s (moving 3480 s) | 2s 4.2 kn, 10s 4.0 kn, avg 3.8 kn, max 6.1 kn
+ *          14 manoeuvres, 9 tacks, 4 gybes | starboard 1860 s, port 1620 s (on starboard)
+ */
+void SessionStats::printReport() {
+    static const char* SIDE_NAMES[] = {"unknown", "starboard", "port"};
+    static const float CMS_TO_KN = 1.0f / 51.4444f;
+
+    if (!hasData()) {
+        Serial.println("Session: no fix yet");
+        return;
+    }
+    Serial.printf("Session: %.2f km in %lu s (moving %lu s) | 2s %.1f kn, 10s %.1f kn, avg %.1f kn, max %.1f kn\n",
+                  distanceMm / 1e6f, getDurationS(), getMovingS(),
+                  getSpeed2sCms() * CMS_TO_KN, getSpeed10sCms() * CMS_TO_KN,
+                  getAverageSpeedCms() * CMS_TO_KN, maxSpeedCms * CMS_TO_KN);
+    Serial.printf("         %u manoeuvres", manoeuvres);
+    if (windFromDeci >= 0) {
+        Serial.printf(", %u tacks, %u gybes | starboard %lu s, port %lu s (on %s)",
+                      tacks, gybes, getTackTimeS(TACK_STARBOARD), getTackTimeS(TACK_PORT), SIDE_NAMES[side]);
+    } else {
+        Serial.print(" | tacks: no wind reference");
+    }
+    Serial.println();
+}
@@ -0,0 +1,292 @@
+/**
+ * @file StartLine.cpp
+ * @brief Implémentation de la ligne de départ en virgule fixe
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Repère local (LocalFrame): origine au bateau comité, x vers l'est,
+ * y vers le nord, en millimètres. Les facteurs d'échelle sont calculés une
+ * fois quand la ligne change ; chaque fix ne coûte ensuite que des
+ * multiplications entières.
+ *
+ * Convention de côté: le bateau comité est à tribord de la ligne face au
+ * parcours. La normale (-Ly, Lx)/|L| pointe vers le côté pré-départ.
+ */
+
+#include "StartLine.h"
+#include <Preferences.h>
+
+static const char* PREF_NAMESPACE = "boatgps";
+static const char* PREF_LINE = "start_line";
+
+/**
+ * @brief Constructeur
+ */
+StartLine::StartLine()
+    : valid(false), lineX(0), lineY(0), lengthMm(0), normalX(0), normalY(0), courseSideBearing(0),
+      x(0), y(0), distanceMm(0), closingMmps(0), timeToLineMs(INT32_MAX), ocs(false),
+      cyclesSum(0), cyclesMax(0), cyclesCount(0) {
+    for (uint8_t i = 0; i < 2; i++) {
+        endLat[i] = 0;
+        endLon[i] = 0;
+        endSet[i] = false;
+    }
+}
+
+/**
+ * @brief Charge les extrémités posées au bouton (NVS)
+ */
+void StartLine::begin() {
+    Preferences prefs;
+    int32_t stored[4];
+    prefs.begin(PREF_NAMESPACE, true);
+    bool found = prefs.getBytes(PREF_LINE, stored, sizeof(stored)) == sizeof(stored);
+    prefs.end();
+
+    if (found) {
+        for (uint8_t i = 0; i < 2; i++) {
+            endLat[i] = stored[i * 2];
+            endLon[i] = stored[i * 2 + 1];
+            endSet[i] = (endLat[i] != 0 || endLon[i] != 0);
+        }
+        prepare();
+    }
+    Serial.printf("✓ Start line: %s\n", valid ? "loaded" : "not set (double/triple click to set ends)");
+}
+
+/**
+ * @brief Pose une extrémité à la position donnée (bouton)
+ * @param end Extrémité
+ * @param latitude Latitude (degrés)
+ * @param longitude Longitude (degrés)
+ */
+void StartLine::setEnd(LineEnd end, double latitude, double longitude) {
+    endLat[end] = Geodesy::toE7(latitude);
+    endLon[end] = Geodesy::toE7(longitude);
+    endSet[end] = true;
+    prepare();
+    save();
+    Serial.printf("🏁 Start line: %s end set at %.6f, %.6f%s\n",
+                  end == LINE_COMMITTEE ? "committee" : "pin", latitude, longitude,
+                  valid ? "" : " (waiting for the other end)");
+}
+
+/**
+ * @brief Pose les deux extrémités (config de flotte, trame comité)
+ */
+void StartLine::setLine(int32_t committeeLat, int32_t committeeLon, int32_t pinLat, int32_t pinLon) {
+    if (valid && committeeLat == endLat[LINE_COMMITTEE] && committeeLon == endLon[LINE_COMMITTEE] &&
+        pinLat == endLat[LINE_PIN] && pinLon == endLon[LINE_PIN]) {
+        return;  // Repeated frame
+    }
+    endLat[LINE_COMMITTEE] = committeeLat;
+    endLon[LINE_COMMITTEE] = committeeLon;
+    endLat[LINE_PIN] = pinLat;
+    endLon[LINE_PIN] = pinLon;
+    endSet[LINE_COMMITTEE] = true;
+    endSet[LINE_PIN] = true;
+    prepare();
+}
+
+/**
+ * @brief Ligne utilisable
+ */
+bool StartLine::hasLine() const {
+    return valid;
+}
+
+/**
+ * @brief Calcule distance, vitesse de rapprochement et temps jusqu'à la ligne
+ * @param data Nouveau fix
+ * @param beforeGun true pendant le compte à rebours
+ * @return true si les valeurs sont valides
+ */
+bool StartLine::update(const GPSData& data, bool beforeGun) {
+    if (!valid || !data.valid) {
+        return false;
+    }
+    uint32_t startCycles = ESP.getCycleCount();
+
+    // Projection (1e-7 deg -> mm)
+    LocalPoint point = frame.project(Geodesy::toE7(data.latitude), Geodesy::toE7(data.longitude));
+    x = point.x;
+    y = point.y;
+
+    // Signed distance: projection on the unit normal (Q15)
+    distanceMm = (int32_t)(((int64_t)x * normalX + (int64_t)y * normalY) >> 15);
+
+    // Velocity (mm/s, east/north) from SOG/COG, closing speed along the normal
+    int32_t vx, vy;
+    Geodesy::velocityMmps(data.speed, data.course, vx, vy);
+    closingMmps = -(int32_t)(((int64_t)vx * normalX + (int64_t)vy * normalY) >> 15);
+
+    // Time to line: moving toward the line from either side
+    if (abs(closingMmps) >= MIN_CLOSING_MMPS && (distanceMm > 0) == (closingMmps > 0)) {
+        timeToLineMs = (int32_t)((int64_t)distanceMm * 1000 / closingMmps);
+    } else {
+        timeToLineMs = INT32_MAX;
+    }
+
+    // OCS: course side before the gun, kept after the gun until the boat returns
+    if (beforeGun) {
+        ocs = distanceMm < 0;
+    } else if (distanceMm > 0) {
+        ocs = false;
+    }
+
+    uint32_t cycles = ESP.getCycleCount() - startCycles;
+    cyclesSum += cycles;
+    cyclesMax = max(cyclesMax, cycles);
+    cyclesCount++;
+    return true;
+}
+
+int32_t StartLine::getDistanceMm() const {
+    return distanceMm;
+}
+
+int32_t StartLine::getTimeToLineMs() const {
+    return timeToLineMs;
+}
+
+int32_t StartLine::getClosingMmps() const {
+    return closingMmps;
+}
+
+bool StartLine::isOCS() const {
+    return valid && ocs;
+}
+
+int32_t StartLine::getX() const {
+    return x;
+}
+
+int32_t StartLine::getY() const {
+    return y;
+}
+
+/**
+ * @brief Position d'un point projeté sur la ligne
+ * @return Q16 : 0 = bateau comité, 65536 = bouée
+ */
+int32_t StartLine::alongLineQ16(int32_t px, int32_t py) const {
+    int64_t dot = (int64_t)px * lineX + (int64_t)py * lineY;
+    int64_t length2 = (int64_t)lineX * lineX + (int64_t)lineY * lineY;
+    return (int32_t)(dot * 65536 / length2);
+}
+
+/**
+ * @brief Convertit une position du repère de la ligne en degrés
+ */
+void StartLine::toLatLon(int32_t px, int32_t py, double& latitude, double& longitude) const {
+    LocalPoint point = {px, py};
+    int32_t latE7, lonE7;
+    frame.unproject(point, latE7, lonE7);
+    latitude = latE7 * 1e-7;
+    longitude = lonE7 * 1e-7;
+}
+
+/**
+ * @brief Relèvement de la ligne vers le côté parcours (degrés)
+ */
+float StartLine::getCourseSideBearing() const {
+    return courseSideBearing;
+}
+
+/**
+ * @brief Longueur de la ligne (m)
+ */
+float StartLine::getLengthM() const {
+    return lengthMm / 1000.0f;
+}
+
+/**
+ * @brief Affiche l'état de la ligne (status update)
+ *
+ * @details
+ * Exemple:
+ * Line: 312 m | dist 24.3 m, closing 2.1 m/s, TTL 11.6 s | 412 cycles/fix (max 655)
+ */
+void StartLine::printReport() {
+    if (!valid) {
+        Serial.printf("Line: not set (committee %s, pin %s)\n",
+                      endSet[LINE_COMMITTEE] ? "set" : "-", endSet[LINE_PIN] ? "set" : "-");
+        return;
+    }
+    Serial.printf("Line: %.0f m | dist %.1f m, closing %.1f m/s",
+                  getLengthM(), distanceMm / 1000.0f, closingMmps / 1000.0f);
+    if (timeToLineMs != INT32_MAX) {
+        Serial.printf(", TTL %.1f s", timeToLineMs / 1000.0f);
+    }
+    if (ocs) {
+        Serial.print(" | OCS");
+    }
+    if (cyclesCount > 0) {
+        Serial.printf(" | %lu cycles/fix (max %lu)", cyclesSum / cyclesCount, cyclesMax);
+    }
+    Serial.println();
+
+    cyclesSum = 0;
+    cyclesMax = 0;
+    cyclesCount = 0;
+}
+
+/**
+ * @brief Précalcule le repère local de la ligne
+ */
+void StartLine::prepare() {
+    valid = false;
+    if (!endSet[LINE_COMMITTEE] || !endSet[LINE_PIN]) {
+        return;
+    }
+
+    frame.setOrigin(endLat[LINE_COMMITTEE], endLon[LINE_COMMITTEE]);
+    LocalPoint committee = {0, 0};
+    LocalPoint pin = frame.project(endLat[LINE_PIN], endLon[LINE_PIN]);
+    lineX = pin.x;
+    lineY = pin.y;
+    lengthMm = (int32_t)Geodesy::distanceMm(committee, pin);
+    if (lengthMm < 1000) {
+        return;  // Ends less than 1 m apart: no usable line
+    }
+
+    normalX = (int32_t)((int64_t)-lineY * 32768 / lengthMm);
+    normalY = (int32_t)((int64_t)lineX * 32768 / lengthMm);
+    courseSideBearing = atan2f((float)-normalX, (float)-normalY) * RAD_TO_DEG;
+    if (courseSideBearing < 0) {
+        courseSideBearing += 360.0f;
+    }
+    ocs = false;
+    valid = true;
+}
+
+/**
+ * @brief Enregistre les extrémités en NVS
+ */
+void StartLine::save() {
+    int32_t stored[4] = {
+        endLat[LINE_COMMITTEE], endLon[LINE_COMMITTEE], endLat[LINE_PIN], endLon[LINE_PIN]
+    };
+    Preferences prefs;
+    prefs.begin(PREF_NAMESPACE, false);
+    prefs.putBytes(PREF_LINE, stored, sizeof(stored));
+    prefs.end();
+}
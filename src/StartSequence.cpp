@@ -0,0 +1,303 @@
+/**
+ * @file StartSequence.cpp
+ * @brief Implémentation de la procédure de départ
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * La géométrie (repère local en millimètres, distance signée) vient de
+ * StartLine ; l'interpolation du point et de l'instant de franchissement
+ * se fait en Q16.
+ */
+
+#include "StartSequence.h"
+
+static const uint32_t DAY_MS = 86400000UL;
+
+/**
+ * @brief Constructeur
+ */
+StartSequence::StartSequence()
+    : state(START_IDLE), gunTod(0), countdownS(300), windowS(60), configWindowS(60),
+      burstIntervalMs(200), line(nullptr), hasPrevious(false), prevDistanceMm(0), prevX(0), prevY(0),
+      prevTod(0), crossings(0) {
+}
+
+/**
+ * @brief Associe la ligne de départ
+ * @param line Ligne, mise à jour à chaque fix avant update()
+ */
+void StartSequence::begin(StartLine* line) {
+    this->line = line;
+}
+
+/**
+ * @brief Applique la configuration
+ * @param countdownS Compte à rebours lancé par le bouton (s)
+ * @param windowS Fenêtre rapide avant le signal (s)
+ * @param burstIntervalMs Intervalle d'émission dans la fenêtre (ms)
+ */
+void StartSequence::configure(uint16_t countdownS, uint16_t windowS, uint16_t burstIntervalMs) {
+    this->countdownS = countdownS;
+    this->configWindowS = windowS;
+    this->burstIntervalMs = burstIntervalMs;
+    if (state == START_IDLE) {
+        this->windowS = windowS;
+    }
+}
+
+/**
+ * @brief Appui bouton : lance ou recale le compte à rebours
+ * @param nowTod Heure GPS du jour (ms, 0 = inconnue)
+ * @return true si le compte à rebours a été lancé ou recalé
+ *
+ * @details
+ * Pendant le compte à rebours, le temps restant est arrondi à la minute
+ * la plus proche : un appui au signal des 4 minutes à 4:02 recale à 4:00.
+ */
+bool StartSequence::buttonPressed(uint32_t nowTod) {
+    if (nowTod == 0) {
+        Serial.println("⚠️  Start: GPS time unknown, countdown not started");
+        return false;
+    }
+
+    if (state == START_COUNTDOWN) {
+        int32_t remaining = todDiff(gunTod, nowTod);
+        int32_t rounded = ((remaining + 30000) / 60000) * 60000;
+        gunTod = (nowTod + rounded) % DAY_MS;
+        Serial.printf("🏁 Start: synced, gun in %ld s\n", rounded / 1000);
+        return true;
+    }
+
+    state = START_COUNTDOWN;
+    gunTod = (nowTod + (uint32_t)countdownS * 1000) % DAY_MS;
+    windowS = configWindowS;
+    hasPrevious = false;
+    Serial.printf("🏁 Start: countdown %u s (high rate for the last %u s)\n", countdownS, windowS);
+    return true;
+}
+
+/**
+ * @brief Abandonne la procédure
+ */
+void StartSequence::cancel() {
+    if (state != START_IDLE) {
+        Serial.println("🏁 Start: cancelled");
+    }
+    state = START_IDLE;
+    hasPrevious = false;
+}
+
+/**
+ * @brief Applique une trame de compte à rebours du comité
+ * @param packet Trame reçue, déjà authentifiée par l'appelant
+ * @param nowTod Heure GPS du jour (ms)
+ *
+ * @details
+ * Le comité répète la trame pendant la procédure : seuls les changements
+ * (heure du signal, ligne) sont affichés. Une trame dont le signal est
+ * passé depuis plus de POST_START_MS est ignorée.
+ *
+ * main.cpp n'appelle cette fonction que pour une trame signée avec la clé
+ * de flotte (Config::authenticate()). Une annulation ne vaut que pour la
+ * procédure dont elle porte l'heure du signal : une annulation signée
+ * enregistrée puis rediffusée n'arrête pas une procédure suivante.
+ *
+ * Les extrémités de la ligne arrivent en 1e-7 degré, la résolution du
+ * calcul de StartLine : aucune conversion.
+ */
+void StartSequence::applyCountdown(const StartCountdownPacket& packet, uint32_t nowTod) {
+    if (packet.flags & START_FLAG_CANCEL) {
+        if (state != START_IDLE && packet.gunTimeOfDayMs == gunTod) {
+            cancel();
+        }
+        return;
+    }
+    if (nowTod == 0 || packet.gunTimeOfDayMs >= DAY_MS) {
+        return;
+    }
+
+    int32_t sinceGun = todDiff(nowTod, packet.gunTimeOfDayMs);
+    if (sinceGun > (int32_t)POST_START_MS) {
+        return;
+    }
+
+    bool changed = (state == START_IDLE) || (gunTod != packet.gunTimeOfDayMs);
+    gunTod = packet.gunTimeOfDayMs;
+    state = (sinceGun >= 0) ? START_RACING : START_COUNTDOWN;
+    windowS = packet.windowS > 0 ? packet.windowS : configWindowS;
+
+    if ((packet.flags & START_FLAG_HAS_LINE) && line != nullptr) {
+        line->setLine(packet.committeeLat, packet.committeeLon, packet.pinLat, packet.pinLon);
+    }
+
+    if (changed) {
+        Serial.printf("🏁 Start: committee countdown, gun in %ld s, window %u s%s\n",
+                      -sinceGun / 1000, windowS,
+                      (line != nullptr && line->hasLine()) ? ", line set" : "");
+    }
+}
+
+/**
+ * @brief Fait évoluer l'état (signal, fin de fenêtre)
+ * @param nowTod Heure GPS du jour (ms)
+ */
+void StartSequence::tick(uint32_t nowTod) {
+    if (state == START_IDLE || nowTod == 0) {
+        return;
+    }
+    int32_t sinceGun = todDiff(nowTod, gunTod);
+    if (state == START_COUNTDOWN && sinceGun >= 0) {
+        state = START_RACING;
+        Serial.println("🏁 Start: GUN");
+    } else if (state == START_RACING && sinceGun > (int32_t)POST_START_MS) {
+        state = START_IDLE;
+        hasPrevious = false;
+        Serial.println("🏁 Start: window closed, normal rate");
+    }
+}
+
+/**
+ * @brief Traite un fix et détecte le franchissement de la ligne
+ * @param data Nouveau fix
+ * @param fixTod Heure GPS du jour du fix (ms)
+ * @param event Événement rempli en cas de franchissement
+ * @return true si la ligne a été franchie
+ */
+bool StartSequence::update(const GPSData& data, uint32_t fixTod, EventPacket& event) {
+    if (line == nullptr || !line->hasLine() || state == START_IDLE || !data.valid || fixTod == 0) {
+        hasPrevious = false;
+        return false;
+    }
+
+    int32_t distance = line->getDistanceMm();
+    int32_t x = line->getX();
+    int32_t y = line->getY();
+
+    bool crossed = false;
+    if (hasPrevious && ((prevDistanceMm > 0) != (distance > 0)) && prevDistanceMm != distance) {
+        // Intersection with the line, interpolated between the two fixes (Q16)
+        int32_t f = (int32_t)((int64_t)prevDistanceMm * 65536 / (prevDistanceMm - distance));
+        int32_t ix = prevX + (int32_t)(((int64_t)(x - prevX) * f) >> 16);
+        int32_t iy = prevY + (int32_t)(((int64_t)(y - prevY) * f) >> 16);
+        int32_t along = line->alongLineQ16(ix, iy);
+
+        if (along >= 0 && along <= 65536) {
+            int32_t offset = (int32_t)(((int64_t)todDiff(fixTod, prevTod) * f) >> 16);
+            uint32_t eventTod = (prevTod + DAY_MS + offset) % DAY_MS;
+            double latitude, longitude;
+            line->toLatLon(ix, iy, latitude, longitude);
+
+            memset(&event, 0, sizeof(event));
+            event.messageType = MSG_EVENT;
+            event.eventType = EVENT_LINE_CROSSING;
+            event.detail = (distance <= 0) ? 1 : 0;
+            event.timeOfDayMs = eventTod;
+            event.relativeMs = todDiff(eventTod, gunTod);
+            event.latitude = latitude;
+            event.longitude = longitude;
+            event.speed = data.speed;
+            crossings++;
+            crossed = true;
+
+            Serial.printf("🏁 Line crossing #%lu: %s at gun %+.2f s%s\n",
+                          crossings,
+                          event.detail ? "to course side" : "back to pre-start side",
+                          event.relativeMs / 1000.0f,
+                          (event.detail && event.relativeMs < 0) ? " (OCS)" : "");
+        }
+    }
+
+    hasPrevious = true;
+    prevDistanceMm = distance;
+    prevX = x;
+    prevY = y;
+    prevTod = fixTod;
+    return crossed;
+}
+
+/**
+ * @brief Fenêtre rapide active
+ * @param nowTod Heure GPS du jour (ms)
+ */
+bool StartSequence::isBurst(uint32_t nowTod) const {
+    if (state == START_IDLE || nowTod == 0) {
+        return false;
+    }
+    int32_t toGun = todDiff(gunTod, nowTod);
+    return toGun <= (int32_t)windowS * 1000 && toGun >= -(int32_t)POST_START_MS;
+}
+
+/**
+ * @brief Intervalle d'émission dans la fenêtre rapide (ms)
+ */
+uint16_t StartSequence::getBurstIntervalMs() const {
+    return burstIntervalMs;
+}
+
+/**
+ * @brief État courant
+ */
+StartState StartSequence::getState() const {
+    return state;
+}
+
+/**
+ * @brief Temps restant avant le signal (ms, négatif après)
+ * @param nowTod Heure GPS du jour (ms)
+ */
+int32_t StartSequence::getTimeToGunMs(uint32_t nowTod) const {
+    return todDiff(gunTod, nowTod);
+}
+
+/**
+ * @brief Affiche l'état du départ (status update)
+ *
+ * @details
+ * Exemple:
+ * Start: COUNTDOWN gun in 42 s (HIGH RATE 200 ms) | 0 crossings
+ */
+void StartSequence::printReport(uint32_t nowTod) {
+    static const char* STATE_NAMES[] = {"IDLE", "COUNTDOWN", "RACING"};
+
+    if (state == START_IDLE) {
+        Serial.printf("Start: IDLE | %lu crossings\n", crossings);
+        return;
+    }
+    Serial.printf("Start: %s gun in %ld s", STATE_NAMES[state], getTimeToGunMs(nowTod) / 1000);
+    if (isBurst(nowTod)) {
+        Serial.printf(" (HIGH RATE %u ms)", burstIntervalMs);
+    }
+    Serial.printf(" | %lu crossings\n", crossings);
+}
+
+/**
+ * @brief Différence signée entre deux heures du jour
+ * @param a Heure du jour (ms)
+ * @param b Heure du jour (ms)
+ * @return a - b ramené dans [-12 h, 12 h)
+ */
+int32_t StartSequence::todDiff(uint32_t a, uint32_t b) {
+    int32_t diff = (int32_t)((a + DAY_MS - b) % DAY_MS);
+    if (diff >= (int32_t)(DAY_MS / 2)) {
+        diff -= (int32_t)DAY_MS;
+    }
+    return diff;
+}
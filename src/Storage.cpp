@@ -32,10 +32,15 @@
  *  "sequenceNumber":42,"gpsTimestamp":1234567890,
  *  "latitude":43.123456,"longitude":2.654321,"speed":4.5,
  *  "heading":285.0,"satellites":8}
+ * ("quality" added for fixes flagged by FixFilter)
  * 
  * Automatic file rotation:
  * - New file every MAX_RECORDS (1000 by default)
  * - Or every MAX_FILE_SIZE bytes (1 MB by default)
+ * 
+ * Session summary (type 7, same statistics as the telemetry frame) written
+ * at the end of each file on rotation ("final": false) and when the
+ * session is ended ("final": true).
  */
 
 #include "Storage.h"
@@ -50,6 +55,11 @@
 // Static constants
 const char* Storage::FILE_PREFIX = "/gps_";
 const char* Storage::FILE_EXTENSION = ".json";
+const char* Storage::TRACK_PREFIX = "/trk_";
+const char* Storage::TRACK_EXTENSION = ".csv";
+const char* Storage::NMEA_PREFIX = "/nmea_";
+const char* Storage::NMEA_EXTENSION = ".nmea";
+const uint8_t Storage::MESSAGE_TYPE;  // Bound by reference by ArduinoJson (needed without -Os)
 
 /**
  * @brief Constructor for Storage class
@@ -59,7 +69,8 @@ const char* Storage::FILE_EXTENSION = ".json";
  * SD card must be initialized by calling begin() before use.
  */
 Storage::Storage() 
-    : sdAvailable(false), fileCreated(false), currentFileSize(0), recordCount(0) {
+    : sdAvailable(false), fileCreated(false), currentFileSize(0), recordCount(0), sessionStats(nullptr),
+      windPerformance(nullptr), courseSmoother(nullptr) {
 }
 
 /**
@@ -139,6 +150,9 @@ void Storage::writeGPSData(const GPSData& data, const uint8_t* macAddress, uint3
         if (createLogFile(macAddress, data)) {
             fileCreated = true;
             Logger::info("✓ Log file created: " + currentFileName);
+            sessionBaseName = currentFileName.substring(strlen(FILE_PREFIX),
+                                                        currentFileName.length() - strlen(FILE_EXTENSION));
+            createTrackFile();
         } else {
             return;
         }
@@ -169,6 +183,29 @@ void Storage::writeGPSData(const GPSData& data, const uint8_t* macAddress, uint3
     boat["speed"] = data.speed;
     boat["heading"] = data.course;
     boat["satellites"] = data.satellites;
+    if (data.quality != FIX_GOOD) {
+        boat["quality"] = data.quality;  // FixQuality flags: outlier kept in the log, marked
+    }
+    if (courseSmoother != nullptr) {
+        boat["smoothedSpeed"] = courseSmoother->getSpeedCms() / 51.4444f;  // knots, as "speed"
+        if (courseSmoother->isCourseValid()) {
+            boat["smoothedHeading"] = courseSmoother->getCourseDeci() / 10.0f;
+        }
+    }
+    
+    // True wind and performance (anemometer heard), speeds in knots
+    if (windPerformance != nullptr && windPerformance->hasWind(data.fixMillis)) {
+        static const float CMS_TO_KN = 1.0f / 51.4444f;
+        JsonObject wind = doc["wind"].to<JsonObject>();
+        wind["twd"] = windPerformance->getDirectionDeci() / 10.0f;
+        wind["tws"] = windPerformance->getSpeedCms() * CMS_TO_KN;
+        if (windPerformance->isValid()) {
+            wind["twa"] = windPerformance->getAngleDeci() / 10.0f;
+            wind["vmg"] = windPerformance->getVmgCms() * CMS_TO_KN;
+            wind["target"] = windPerformance->getTargetCms() * CMS_TO_KN;
+            wind["polar"] = windPerformance->getPolarPermille() / 10.0f;
+        }
+    }
     
     // Serialize to file (one JSON object per line)
     serializeJson(doc, logFile);
@@ -179,6 +216,198 @@ void Storage::writeGPSData(const GPSData& data, const uint8_t* macAddress, uint3
     recordCount++;
 }
 
+/**
+ * @brief Write event to the current log file
+ * @param event Event as broadcast (EventPacket)
+ * @param timestamp GPS timestamp of the fix that triggered the event
+ * 
+ * @details
+ * Same line-oriented format as the GPS records, with type = MSG_EVENT:
+ * {"timestamp":..., "type":6, "event":{"eventType":1, "detail":1, ...}}
+ * Events before the first valid fix are not logged (no file yet).
+ */
+void Storage::writeEvent(const EventPacket& event, uint32_t timestamp) {
+    if (!sdAvailable || !fileCreated || !logFile) {
+        return;
+    }
+    
+    JsonDocument doc;
+    doc["timestamp"] = timestamp;
+    doc["type"] = MSG_EVENT;
+    
+    JsonObject obj = doc["event"].to<JsonObject>();
+    obj["eventType"] = event.eventType;
+    obj["eventSequence"] = event.eventSequence;
+    obj["detail"] = event.detail;
+    obj["timeOfDayMs"] = event.timeOfDayMs;
+    obj["relativeMs"] = event.relativeMs;
+    obj["latitude"] = event.latitude;
+    obj["longitude"] = event.longitude;
+    obj["speed"] = event.speed;
+    
+    serializeJson(doc, logFile);
+    logFile.println();
+    logFile.flush();
+    
+    currentFileSize = logFile.size();
+    recordCount++;
+}
+
+/**
+ * @brief Write the metrics of a manoeuvre
+ * @param record Completed manoeuvre
+ * @param eventSequence Sequence of the matching EventPacket
+ * 
+ * @details
+ * {"timestamp":..., "type":6, "manoeuvre":{"eventSequence":12, "kind":"tack",
+ *  "durationMs":7400, "headingChange":-92.0, "entrySpeed":4.1, "minSpeed":2.7,
+ *  "exitSpeed":3.9, "speedLoss":1.4, "recoveryMs":5200, "distanceLost":3.1, ...}}
+ * Speeds in knots, distance in metres.
+ */
+void Storage::writeManoeuvre(const ManoeuvreRecord& record, uint16_t eventSequence) {
+    if (!sdAvailable || !fileCreated || !logFile) {
+        return;
+    }
+    static const char* KIND_NAMES[] = {"turn", "tack", "gybe"};
+    static const float CMS_TO_KN = 1.0f / 51.4444f;
+    
+    JsonDocument doc;
+    doc["timestamp"] = record.startTimestamp;
+    doc["type"] = MSG_EVENT;
+    
+    JsonObject obj = doc["manoeuvre"].to<JsonObject>();
+    obj["eventSequence"] = eventSequence;
+    obj["kind"] = KIND_NAMES[record.kind];
+    obj["timeOfDayMs"] = record.startTod;
+    obj["durationMs"] = record.durationMs;
+    obj["headingChange"] = record.headingChangeDeci / 10.0f;
+    obj["entrySpeed"] = record.entrySpeedCms * CMS_TO_KN;
+    obj["minSpeed"] = record.minSpeedCms * CMS_TO_KN;
+    obj["exitSpeed"] = record.exitSpeedCms * CMS_TO_KN;
+    obj["speedLoss"] = ((int32_t)record.entrySpeedCms - record.minSpeedCms) * CMS_TO_KN;
+    obj["recoveryMs"] = record.recoveryMs;
+    obj["distanceLost"] = record.distanceLostMm / 1000.0f;
+    obj["latitude"] = record.latitude * 1e-7;
+    obj["longitude"] = record.longitude * 1e-7;
+    
+    serializeJson(doc, logFile);
+    logFile.println();
+    logFile.flush();
+    
+    currentFileSize = logFile.size();
+    recordCount++;
+}
+
+/**
+ * @brief Append a raw NMEA sentence to the capture file
+ * @param sentence Sentence without CR/LF
+ * 
+ * @details
+ * One file per session, opened on the first captured sentence:
+ * /nmea_MACADDRESS_YYYY-MM-DD_HH-MM-SS.nmea (plain NMEA, replayable).
+ * Flushed once per fix (RMC sentence) rather than per sentence.
+ */
+void Storage::writeRawNmea(const char* sentence) {
+    if (!sdAvailable || !fileCreated) {
+        return;
+    }
+    if (!nmeaFile) {
+        nmeaFileName = sessionFileName(NMEA_PREFIX, NMEA_EXTENSION);
+        nmeaFile = SD.open(nmeaFileName.c_str(), FILE_APPEND);
+        if (!nmeaFile) {
+            return;
+        }
+        Logger::info("✓ NMEA capture file: " + nmeaFileName);
+    }
+    nmeaFile.print(sentence);
+    nmeaFile.print("\r\n");
+    if (strstr(sentence, "RMC,") != nullptr) {
+        nmeaFile.flush();
+    }
+}
+
+/**
+ * @brief Attach the session statistics
+ * @param stats Session statistics (nullptr = no summary)
+ */
+void Storage::setSessionStats(const SessionStats* stats) {
+    sessionStats = stats;
+}
+
+/**
+ * @brief Attach the wind / performance values
+ * @param performance Wind performance (nullptr = no wind fields)
+ */
+void Storage::setWindPerformance(const WindPerformance* performance) {
+    windPerformance = performance;
+}
+
+/**
+ * @brief Attach the smoothed course / speed
+ * @param smoother Course smoother (nullptr = raw values only)
+ */
+void Storage::setCourseSmoother(const CourseSmoother* smoother) {
+    courseSmoother = smoother;
+}
+
+/**
+ * @brief Write the session summary to the current log file
+ * @param final true at the end of the session, false on rotation
+ * 
+ * @details
+ * {"timestamp":..., "type":7, "summary":{"final":true, "startTimestamp":...,
+ *  "durationS":..., "distanceM":..., "avgSpeed":3.8, "maxSpeed":6.1, ...}}
+ * Speeds in knots, like the GPS records.
+ */
+void Storage::writeSessionSummary(bool final) {
+    if (!sdAvailable || !fileCreated || !logFile || sessionStats == nullptr || !sessionStats->hasData()) {
+        return;
+    }
+    static const float CMS_TO_KN = 1.0f / 51.4444f;
+    
+    JsonDocument doc;
+    doc["timestamp"] = sessionStats->getStartTimestamp() + sessionStats->getDurationS();
+    doc["type"] = MSG_TELEMETRY;
+    
+    JsonObject obj = doc["summary"].to<JsonObject>();
+    obj["final"] = final;
+    obj["startTimestamp"] = sessionStats->getStartTimestamp();
+    obj["durationS"] = sessionStats->getDurationS();
+    obj["movingS"] = sessionStats->getMovingS();
+    obj["distanceM"] = sessionStats->getDistanceM();
+    obj["avgSpeed"] = sessionStats->getAverageSpeedCms() * CMS_TO_KN;
+    obj["maxSpeed"] = sessionStats->getMaxSpeedCms() * CMS_TO_KN;
+    obj["manoeuvres"] = sessionStats->getManoeuvres();
+    obj["tacks"] = sessionStats->getTacks();
+    obj["gybes"] = sessionStats->getGybes();
+    obj["starboardS"] = sessionStats->getTackTimeS(TACK_STARBOARD);
+    obj["portS"] = sessionStats->getTackTimeS(TACK_PORT);
+    
+    serializeJson(doc, logFile);
+    logFile.println();
+    logFile.flush();
+    
+    currentFileSize = logFile.size();
+    recordCount++;
+}
+
+/**
+ * @brief End the session
+ * 
+ * @details
+ * Writes the final summary and closes the file. The next valid fix
+ * creates a new file (new session).
+ */
+void Storage::endSession() {
+    writeSessionSummary(true);
+    closeFile();
+    closeTrackFile();
+    if (nmeaFile) {
+        nmeaFile.close();
+    }
+    fileCreated = false;
+}
+
 /**
  * @brief Check if SD card storage is available
  * @return true if SD card is mounted and working
@@ -298,6 +527,7 @@ bool Storage::createLogFile(const uint8_t* macAddress, const GPSData& data) {
  */
 void Storage::rotateFile(const GPSData& data) {
     Logger::info("🔄 Rotating storage file...");
+    writeSessionSummary(false);
     closeFile();
     
     // Create new file with new timestamp
@@ -311,3 +541,109 @@ void Storage::rotateFile(const GPSData& data) {
     createLogFile(dummyMac, data);
     Logger::info("✓ New log file: " + currentFileName);
 }
+
+/**
+ * @brief Feed a fix to the simplified track
+ * @param data New fix
+ * 
+ * @details
+ * Called on every fix: the simplification needs the full-rate track, the
+ * JSON log only has the broadcast fixes. Fixes before the first log file
+ * of the session are ignored.
+ */
+void Storage::writeTrackPoint(const GPSData& data) {
+    if (!sdAvailable || !trackFile || !data.valid) {
+        return;
+    }
+    TrackPoint points[2];
+    uint8_t count = track.push(data, points);
+    for (uint8_t i = 0; i < count; i++) {
+        writeTrackLine(points[i]);
+    }
+    if (count > 0) {
+        trackFile.flush();
+    }
+}
+
+/**
+ * @brief Simplified track tolerance
+ * @param toleranceCm Maximum error (cm, 0 = every fix)
+ */
+void Storage::setTrackTolerance(uint16_t toleranceCm) {
+    track.setTolerance(toleranceCm);
+}
+
+/**
+ * @brief Print simplified track report
+ */
+void Storage::printTrackReport() {
+    if (trackFile) {
+        track.printReport();
+    }
+}
+
+/**
+ * @brief Open the simplified track file of the session
+ * @return true if file created successfully
+ * 
+ * @details
+ * Named after the first log file of the session: /trk_MACADDRESS_YYYY-MM-DD_HH-MM-SS.csv
+ * The track is not rotated with the log file: one file per session.
+ * CSV header: timestamp,latitude,longitude,speed,heading
+ */
+bool Storage::createTrackFile() {
+    trackFileName = sessionFileName(TRACK_PREFIX, TRACK_EXTENSION);
+    trackFile = SD.open(trackFileName.c_str(), FILE_WRITE);
+    if (!trackFile) {
+        Logger::error("Failed to create: " + trackFileName);
+        return false;
+    }
+    trackFile.println("timestamp,latitude,longitude,speed,heading");
+    track.reset();
+    Logger::info("✓ Track file created: " + trackFileName);
+    return true;
+}
+
+/**
+ * @brief Session file name with another prefix and extension
+ * 
+ * @details
+ * Built from the first log file of the session (the track and NMEA files
+ * are not rotated with the log): /gps_X.json -> /trk_X.csv, /nmea_X.nmea
+ */
+String Storage::sessionFileName(const char* prefix, const char* extension) const {
+    return String(prefix) + sessionBaseName + extension;
+}
+
+/**
+ * @brief Close the simplified track file
+ */
+void Storage::closeTrackFile() {
+    if (!trackFile) {
+        return;
+    }
+    TrackPoint last;
+    if (track.flush(last)) {
+        writeTrackLine(last);
+    }
+    trackFile.close();
+    Logger::info("✓ Track file closed: " + trackFileName + " (" + String(track.getPointsOut()) + " of " +
+                 String(track.getPointsIn()) + " fixes, max error " + String(track.getMaxErrorMm() / 1000.0f, 2) + " m)");
+}
+
+/**
+ * @brief Append one point to the simplified track
+ * 
+ * @details
+ * One CSV line, speed in knots like the JSON log:
+ * 1732545000,45.1234567,-1.2345678,4.21,215.3
+ */
+void Storage::writeTrackLine(const TrackPoint& point) {
+    char line[64];
+    snprintf(line, sizeof(line), "%lu,%s%ld.%07ld,%s%ld.%07ld,%.2f,%.1f",
+             (unsigned long)point.timestamp,
+             point.latitude < 0 ? "-" : "", labs(point.latitude) / 10000000L, labs(point.latitude) % 10000000L,
+             point.longitude < 0 ? "-" : "", labs(point.longitude) / 10000000L, labs(point.longitude) % 10000000L,
+             point.speedCms / 51.4444f, point.courseDeci / 10.0f);
+    trackFile.println(line);
+}
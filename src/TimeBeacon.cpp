@@ -0,0 +1,246 @@
+/**
+ * @file TimeBeacon.cpp
+ * @brief Balise horaire GPS disciplinée par le récepteur GNSS
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Les échantillons d'horloge viennent des ancrages du GPS, la balise et
+ * sa correction de Communication (rappel d'envoi). Voir TIME_BEACON.md.
+ */
+
+#include "TimeBeacon.h"
+#include <esp_timer.h>
+
+// GNSS epoch to first byte of its NMEA burst (receiver computation, UART FIFO threshold).
+// Not documented for the NEO-6M nor the AT6668: 0 until measured against a PPS output,
+// the broadcast time is late by this delay (see TIME_BEACON.md)
+const int64_t TimeBeacon::NMEA_LATENCY_US = 0;
+
+/**
+ * @brief Constructeur : balise désactivée, horloge non synchronisée
+ */
+TimeBeacon::TimeBeacon()
+    : clock(ClockEstimator::ENVELOPE), intervalMs(0), nextBeacon(0), sequence(0), anchorCount(0),
+      bucketOpen(false), bucketStartUs(0), bucketLocalUs(0), bucketOffsetUs(0), lastStampUs(0),
+      stampPending(false), sent(0), corrections(0), rejected(0), correctionSumUs(0), correctionMaxUs(0),
+      correctionCount(0) {
+}
+
+/**
+ * @brief Règle l'intervalle des balises
+ * @param intervalMs Intervalle (0 = désactivée)
+ *
+ * @details
+ * La première balise part un intervalle plus tard. L'horloge reste
+ * disciplinée balise désactivée.
+ */
+void TimeBeacon::setInterval(uint16_t intervalMs) {
+    if (intervalMs != this->intervalMs) {
+        this->intervalMs = intervalMs;
+        nextBeacon = millis() + intervalMs;
+    }
+}
+
+/**
+ * @brief Indique si la balise est émise
+ */
+bool TimeBeacon::isEnabled() const {
+    return intervalMs > 0;
+}
+
+/**
+ * @brief Prend le nouvel ancrage du GPS
+ * @param gps Récepteur GPS
+ *
+ * @details
+ * Échantillon = heure GPS du premier octet (époque + NMEA_LATENCY_US)
+ * moins son heure locale. Le retard de loop() ne fait que diminuer cet
+ * écart : sur chaque période, seul l'écart le plus grand est gardé, puis
+ * l'estimateur en mode enveloppe suit les plus grands.
+ */
+void TimeBeacon::update(const GPS& gps) {
+    int64_t gpsUs = 0;
+    int64_t localUs = 0;
+    uint32_t count = gps.getTimeAnchor(gpsUs, localUs);
+    if (count == anchorCount) {
+        return;
+    }
+    anchorCount = count;
+    int64_t offsetUs = gpsUs + NMEA_LATENCY_US - localUs;
+    
+    if (bucketOpen && localUs - bucketStartUs >= SAMPLE_PERIOD_US) {
+        if (!clock.addSample(bucketLocalUs, bucketOffsetUs)) {
+            rejected++;
+        }
+        bucketOpen = false;
+    }
+    if (!bucketOpen) {
+        bucketOpen = true;
+        bucketStartUs = localUs;
+        bucketLocalUs = localUs;
+        bucketOffsetUs = offsetUs;
+    } else if (offsetUs > bucketOffsetUs) {
+        bucketLocalUs = localUs;
+        bucketOffsetUs = offsetUs;
+    }
+}
+
+/**
+ * @brief Correction de la dernière balise
+ * @param comm Radio
+ * @return Fin d'émission moins horodatage (µs), TIME_BEACON_NO_CORRECTION si inconnue
+ *
+ * @details
+ * Les deux instants passent par la même horloge disciplinée : la
+ * correction ne dépend que de son écart sur quelques millisecondes.
+ */
+int32_t TimeBeacon::takeCorrection(Communication& comm) {
+    int64_t txUs = 0;
+    bool pending = stampPending;
+    stampPending = false;
+    if (!comm.getTimedSendUs(txUs) || !pending) {
+        return TIME_BEACON_NO_CORRECTION;
+    }
+    int64_t correction = clock.toReference(txUs) - lastStampUs;
+    if (correction < 0 || correction > BeaconReceiver::MAX_CORRECTION_US) {
+        return TIME_BEACON_NO_CORRECTION;
+    }
+    corrections++;
+    correctionSumUs += correction;
+    correctionCount++;
+    if (correction > correctionMaxUs) {
+        correctionMaxUs = (int32_t)correction;
+    }
+    return (int32_t)correction;
+}
+
+/**
+ * @brief Émet la balise à son heure
+ * @param comm Radio
+ * @param now millis() courant
+ * @return true si une balise est partie
+ *
+ * @details
+ * L'horodatage est la dernière opération avant l'envoi. Horloge non
+ * synchronisée : aucune balise, la suivante ne porte pas de correction.
+ */
+bool TimeBeacon::service(Communication& comm, uint32_t now) {
+    if (intervalMs == 0 || (int32_t)(now - nextBeacon) < 0) {
+        return false;
+    }
+    nextBeacon += intervalMs;
+    if ((int32_t)(now - nextBeacon) >= 0) {
+        nextBeacon = now + intervalMs;  // Late (long blocking call): no burst of beacons
+    }
+    
+    int32_t correction = takeCorrection(comm);
+    int64_t localUs = esp_timer_get_time();
+    TimeSyncState state = getState(localUs);
+    if (state == TIME_UNSYNCED) {
+        return false;
+    }
+    
+    uint32_t accuracy = clock.getUncertaintyUs();
+    if (state == TIME_HOLDOVER) {
+        accuracy += (uint32_t)((localUs - clock.getLastSampleUs()) / 1000000 * HOLDOVER_DRIFT_PPM);
+    }
+    
+    TimeBeaconPacket beacon;
+    memset(&beacon, 0, sizeof(beacon));
+    beacon.messageType = MSG_TIME_BEACON;
+    beacon.state = state;
+    beacon.sequence = ++sequence;
+    beacon.correctionUs = correction;
+    beacon.accuracyUs = (uint16_t)min(accuracy, (uint32_t)65535);
+    
+    int64_t stamp = clock.toReference(esp_timer_get_time());
+    beacon.gpsSeconds = (uint32_t)(stamp / 1000000);
+    beacon.gpsMicros = (uint32_t)(stamp % 1000000);
+    if (!comm.sendTimedFrame((const uint8_t*)&beacon, sizeof(beacon))) {
+        return false;
+    }
+    lastStampUs = stamp;
+    stampPending = true;
+    sent++;
+    return true;
+}
+
+/**
+ * @brief Retourne millis() de la prochaine balise
+ */
+uint32_t TimeBeacon::getNextBeacon() const {
+    return nextBeacon;
+}
+
+/**
+ * @brief État de l'horloge à un instant local
+ * @param localUs esp_timer_get_time()
+ * @return TIME_GNSS, TIME_HOLDOVER ou TIME_UNSYNCED
+ */
+TimeSyncState TimeBeacon::getState(int64_t localUs) const {
+    if (!clock.isValid()) {
+        return TIME_UNSYNCED;
+    }
+    // The last sample waits for the end of its period: one period older than the last anchor
+    int64_t age = localUs - clock.getLastSampleUs();
+    if (age < HOLDOVER_AFTER_US + SAMPLE_PERIOD_US) {
+        return TIME_GNSS;
+    }
+    return age < HOLDOVER_MAX_US ? TIME_HOLDOVER : TIME_UNSYNCED;
+}
+
+/**
+ * @brief Heure GPS d'un instant local
+ * @param localUs esp_timer_get_time()
+ * @param gpsUs Heure GPS (UTC), µs depuis le 1970-01-01
+ * @return false si l'horloge n'est pas synchronisée
+ */
+bool TimeBeacon::getGpsTimeUs(int64_t localUs, int64_t& gpsUs) const {
+    if (getState(localUs) == TIME_UNSYNCED) {
+        return false;
+    }
+    gpsUs = clock.toReference(localUs);
+    return true;
+}
+
+/**
+ * @brief Affiche l'état de l'horloge et des balises (rien si désactivée)
+ */
+void TimeBeacon::printReport() {
+    if (intervalMs == 0) {
+        return;
+    }
+    static const char* STATE_NAMES[] = {"unsynced", "GNSS", "holdover"};
+    TimeSyncState state = getState(esp_timer_get_time());
+    Serial.printf("Time beacon: %u ms, clock %s, %u samples, drift %+.1f ppm, ±%lu us (%lu rejected) | %lu sent, "
+                  "%lu corrected",
+                  intervalMs, STATE_NAMES[state], clock.getCount(), clock.getDriftPpm(), clock.getUncertaintyUs(),
+                  rejected, sent, corrections);
+    if (correctionCount > 0) {
+        Serial.printf(", TX wait avg %lu us max %ld us", (uint32_t)(correctionSumUs / correctionCount),
+                      correctionMaxUs);
+    }
+    Serial.println();
+    
+    correctionSumUs = 0;
+    correctionMaxUs = 0;
+    correctionCount = 0;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file TrackSimplifier.cpp
+ * @brief Implémentation de la simplification de trace en flux
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Le repère local n'est recentré qu'à plus de 10 km de son origine, sur
+ * un point conservé (aucun fix en attente à reprojeter). Distance au
+ * segment (et non à la droite) : un bateau qui revient sur ses pas après
+ * l'ancre n'est pas confondu avec le segment.
+ */
+
+#include "TrackSimplifier.h"
+
+/**
+ * @brief Constructeur
+ */
+TrackSimplifier::TrackSimplifier()
+    : toleranceMm(2000), pointsIn(0), pointsOut(0), maxErrorMm(0),
+      cyclesSum(0), cyclesMax(0), cyclesCount(0) {
+    reset();
+}
+
+/**
+ * @brief Tolérance d'erreur
+ * @param toleranceCm Distance maximale d'un fix abandonné à la trace conservée (cm, 0 = tous les fixes)
+ */
+void TrackSimplifier::setTolerance(uint16_t toleranceCm) {
+    toleranceMm = (uint32_t)toleranceCm * 10;
+}
+
+/**
+ * @brief Démarre une nouvelle trace
+ *
+ * @details
+ * Les fixes en attente sont abandonnés : appeler flush() avant pour
+ * conserver la fin de la trace précédente.
+ */
+void TrackSimplifier::reset() {
+    hasAnchor = false;
+    anchorFixMillis = 0;
+    pendingCount = 0;
+    windowErrorMm = 0;
+}
+
+/**
+ * @brief Ajoute un fix
+ * @param data Nouveau fix
+ * @param out Points à conserver (place pour 2 : les fixes de part et d'autre d'un trou)
+ * @return Nombre de points remplis dans out
+ */
+uint8_t TrackSimplifier::push(const GPSData& data, TrackPoint* out) {
+    uint32_t startCycles = ESP.getCycleCount();
+    uint8_t count = 0;
+
+    TrackPoint point;
+    point.timestamp = data.timestamp;
+    point.fixMillis = data.fixMillis;
+    point.latitude = Geodesy::toE7(data.latitude);
+    point.longitude = Geodesy::toE7(data.longitude);
+    point.speedCms = (uint16_t)constrain(data.speed * 51.4444f, 0.0f, 65535.0f);
+    point.courseDeci = (uint16_t)(((int32_t)(data.course * 10.0f) % 3600 + 3600) % 3600);
+    pointsIn++;
+
+    bool first = !hasAnchor;
+    if (first) {
+        frame.setOrigin(point.latitude, point.longitude);
+        hasAnchor = true;
+    }
+    LocalPoint local = frame.project(point.latitude, point.longitude);
+    uint32_t lastMillis = (pendingCount > 0) ? pending[pendingCount - 1].fixMillis : anchorFixMillis;
+
+    if (first || toleranceMm == 0) {
+        keep(point, local, out[count++]);
+    } else if (point.fixMillis - lastMillis > MAX_GAP_MS) {
+        // No segment across a fix gap: both ends are kept
+        if (pendingCount > 0) {
+            keep(pending[pendingCount - 1], pendingPoints[pendingCount - 1], out[count++]);
+        }
+        keep(point, frame.project(point.latitude, point.longitude), out[count++]);
+    } else {
+        float error = windowError(local);
+        if (pendingCount == WINDOW_SIZE || error > toleranceMm) {
+            keep(pending[pendingCount - 1], pendingPoints[pendingCount - 1], out[count++]);
+            local = frame.project(point.latitude, point.longitude);
+            error = 0.0f;
+        }
+        pending[pendingCount] = point;
+        pendingPoints[pendingCount] = local;
+        pendingCount++;
+        windowErrorMm = (uint32_t)error;
+    }
+
+    uint32_t cycles = ESP.getCycleCount() - startCycles;
+    cyclesSum += cycles;
+    cyclesMax = max(cyclesMax, cycles);
+    cyclesCount++;
+    return count;
+}
+
+/**
+ * @brief Dernier fix en attente, en fin de trace
+ * @param out Point à conserver
+ * @return true si out doit être écrit
+ */
+bool TrackSimplifier::flush(TrackPoint& out) {
+    if (pendingCount == 0) {
+        return false;
+    }
+    keep(pending[pendingCount - 1], pendingPoints[pendingCount - 1], out);
+    return true;
+}
+
+uint32_t TrackSimplifier::getPointsIn() const {
+    return pointsIn;
+}
+
+uint32_t TrackSimplifier::getPointsOut() const {
+    return pointsOut;
+}
+
+uint32_t TrackSimplifier::getMaxErrorMm() const {
+    return maxErrorMm;
+}
+
+/**
+ * @brief Affiche la simplification (status update)
+ *
+ * @details
+ * Exemple:
+ * Track: 1.5 m tolerance | 18342 fixes -> 611 points (30.0:1), max error 1.42 m | 2100 cycles/fix (max 9800)
+ */
+void TrackSimplifier::printReport() {
+    if (toleranceMm == 0) {
+        Serial.printf("Track: every fix kept (%lu points)\n", pointsOut);
+        return;
+    }
+    Serial.printf("Track: %.1f m tolerance | %lu fixes -> %lu points", toleranceMm / 1000.0f, pointsIn, pointsOut);
+    if (pointsOut > 0) {
+        Serial.printf(" (%.1f:1), max error %.2f m", (float)pointsIn / pointsOut, maxErrorMm / 1000.0f);
+    }
+    if (cyclesCount > 0) {
+        Serial.printf(" | %lu cycles/fix (max %lu)", cyclesSum / cyclesCount, cyclesMax);
+    }
+    Serial.println();
+
+    cyclesSum = 0;
+    cyclesMax = 0;
+    cyclesCount = 0;
+}
+
+/**
+ * @brief Conserve un point : il devient l'ancre
+ *
+ * @details
+ * Si le point est la fin flottante de la fenêtre, windowErrorMm est
+ * l'erreur réelle des fixes abandonnés par rapport au segment conservé.
+ */
+void TrackSimplifier::keep(const TrackPoint& point, const LocalPoint& local, TrackPoint& out) {
+    out = point;
+    maxErrorMm = max(maxErrorMm, windowErrorMm);
+    anchor = local;
+    if (abs(local.x) > RECENTRE_MM || abs(local.y) > RECENTRE_MM) {
+        frame.setOrigin(point.latitude, point.longitude);
+        anchor.x = 0;
+        anchor.y = 0;
+    }
+    anchorFixMillis = point.fixMillis;
+    pendingCount = 0;
+    windowErrorMm = 0;
+    pointsOut++;
+}
+
+/**
+ * @brief Plus grande distance des fixes en attente au segment ancre -> fin (mm)
+ *
+ * @details
+ * Comparaison sur les carrés ; arrêt dès qu'un fix dépasse la tolérance.
+ */
+float TrackSimplifier::windowError(const LocalPoint& end) const {
+    float dx = (float)(end.x - anchor.x);
+    float dy = (float)(end.y - anchor.y);
+    float length2 = dx * dx + dy * dy;
+    float tolerance2 = (float)toleranceMm * (float)toleranceMm;
+    float worst2 = 0.0f;
+
+    for (uint8_t i = 0; i < pendingCount; i++) {
+        float px = (float)(pendingPoints[i].x - anchor.x);
+        float py = (float)(pendingPoints[i].y - anchor.y);
+        float t = (length2 > 0.0f) ? (px * dx + py * dy) / length2 : 0.0f;
+        t = constrain(t, 0.0f, 1.0f);
+        float ex = px - t * dx;
+        float ey = py - t * dy;
+        float d2 = ex * ex + ey * ey;
+        if (d2 > worst2) {
+            worst2 = d2;
+            if (worst2 > tolerance2) {
+                break;
+            }
+        }
+    }
+    return sqrtf(worst2);
+}
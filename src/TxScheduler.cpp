@@ -0,0 +1,313 @@
+/**
+ * @file TxScheduler.cpp
+ * @brief Implémentation de l'ordonnanceur d'émission par classes de trafic
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Files fixes (pas d'allocation) : un réservoir de POOL_SIZE trames
+ * découpé en une file circulaire par classe, dans l'ordre de POLICIES.
+ *
+ * Seau à jetons : TOKEN unités par microseconde d'antenne, rempli de
+ * budgetUsPerS par seconde jusqu'à burstUs. Une trame ne part que si le
+ * seau contient toute sa durée : le budget moyen est respecté sur la
+ * durée de burstUs, une trame de fond isolée part sans attendre.
+ *
+ * Les classes de fond ne retiennent jamais une classe plus prioritaire :
+ * une trame de contrôle ou de télémétrie retenue par son budget laisse
+ * passer les autres.
+ * Les positions n'ont ni budget ni plus d'une trame en attente devant
+ * elles au pilote, en plus de celle en cours d'émission (IN_FLIGHT_LIVE).
+ */
+
+#include "TxScheduler.h"
+
+// Live positions are replaced by the next fix, control frames are not: the
+// oldest position is dropped, a new event is refused when the queue is full.
+// Control burst: 4 events sent at once with their 2 repeats (12 x 2.7 ms).
+// Time beacons need no budget: one per beacon period in a queue of one.
+const TxScheduler::Policy TxScheduler::POLICIES[TX_CLASS_COUNT] = {
+    // name        depth  dropOldest  inFlightMax                    budget us/s  burst us
+    {"live",        2,     true,       TxScheduler::IN_FLIGHT_LIVE,   0,           0},
+    {"control",     8,     false,      TxScheduler::IN_FLIGHT_MAX,    60000,       40000},
+    {"time",        1,     true,       TxScheduler::IN_FLIGHT_MAX,    0,           0},
+    {"telemetry",   2,     true,       TxScheduler::IN_FLIGHT_MAX,    40000,       20000},
+};
+
+static const int64_t TOKEN = 1000;               // One microsecond of airtime in bucket units
+static const uint32_t LR_PREAMBLE_US = 400;      // 802.11 LR frame: preamble and header
+static const uint32_t LR_US_PER_BYTE = 32;       // 250 kbit/s
+static const uint32_t FRAME_OVERHEAD = 43;       // 802.11 + ESP-NOW headers, FCS
+
+/**
+ * @brief Constructeur : files vides, seaux pleins
+ */
+TxScheduler::TxScheduler() : peeked(TX_LIVE), nextId(1) {
+    uint8_t next = 0;
+    for (uint8_t c = 0; c < TX_CLASS_COUNT; c++) {
+        first[c] = next;
+        next += POLICIES[c].depth;
+        head[c] = 0;
+        count[c] = 0;
+        tokensUs[c] = (int64_t)POLICIES[c].burstUs * TOKEN;
+        lastRefillUs[c] = 0;
+        holding[c] = false;
+        memset(&stats[c], 0, sizeof(stats[c]));
+    }
+}
+
+/**
+ * @brief Range une trame dans la file de sa classe
+ * @param txClass Classe de trafic
+ * @param data Octets de la trame
+ * @param len Longueur (1 à 250)
+ * @param timed Heure du rappel d'envoi demandée (balise horaire)
+ * @param nowUs Heure courante
+ * @return Identifiant de la trame, 0 si elle est refusée (longueur, file
+ *         de contrôle pleine)
+ */
+uint32_t TxScheduler::push(TxClass txClass, const uint8_t* data, size_t len, bool timed, int64_t nowUs) {
+    if (txClass >= TX_CLASS_COUNT || len == 0 || len > sizeof(pool[0].data)) {
+        return 0;
+    }
+    const Policy& policy = POLICIES[txClass];
+    stats[txClass].queued++;
+    if (count[txClass] == policy.depth) {
+        stats[txClass].dropped++;
+        if (!policy.dropOldest) {
+            return 0;
+        }
+        head[txClass] = (head[txClass] + 1) % policy.depth;
+        count[txClass]--;
+        holding[txClass] = false;
+    }
+    TxFrame& frame = pool[first[txClass] + (head[txClass] + count[txClass]) % policy.depth];
+    memcpy(frame.data, data, len);
+    frame.len = (uint8_t)len;
+    frame.txClass = txClass;
+    frame.timed = timed;
+    frame.queuedUs = nowUs;
+    frame.id = nextId;
+    nextId = (nextId == UINT32_MAX) ? 1 : nextId + 1;
+    count[txClass]++;
+    return frame.id;
+}
+
+/**
+ * @brief Prochaine trame permise sur la radio
+ * @param nowUs Heure courante
+ * @param inFlight Trames confiées au pilote, sans rappel d'envoi
+ * @return Trame en tête de sa file, nullptr si aucune ne peut partir
+ */
+const TxFrame* TxScheduler::peek(int64_t nowUs, uint8_t inFlight) {
+    for (uint8_t c = 0; c < TX_CLASS_COUNT; c++) {
+        if (count[c] == 0 || inFlight >= POLICIES[c].inFlightMax) {
+            continue;
+        }
+        if (POLICIES[c].budgetUsPerS != 0) {
+            refill(c, nowUs);
+            if (tokensUs[c] < (int64_t)airtimeUs(front(c).len) * TOKEN) {
+                if (!holding[c]) {
+                    holding[c] = true;
+                    stats[c].throttled++;
+                }
+                continue;
+            }
+        }
+        peeked = (TxClass)c;
+        return &front(c);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Retire la trame rendue par peek()
+ * @param nowUs Heure courante
+ * @param sent true si le pilote l'a acceptée (durée d'antenne décomptée)
+ * @return Classe de la trame
+ */
+TxClass TxScheduler::pop(int64_t nowUs, bool sent) {
+    uint8_t c = peeked;
+    if (count[c] == 0) {
+        return peeked;
+    }
+    TxFrame& frame = front(c);
+    TxClassStats& s = stats[c];
+    if (sent) {
+        uint32_t airtime = airtimeUs(frame.len);
+        uint32_t waitUs = (uint32_t)(nowUs - frame.queuedUs);
+        s.sent++;
+        s.airtimeUs += airtime;
+        s.waitSumUs += waitUs;
+        if (waitUs > s.waitMaxUs) {
+            s.waitMaxUs = waitUs;
+        }
+        if (POLICIES[c].budgetUsPerS != 0) {
+            tokensUs[c] -= (int64_t)airtime * TOKEN;
+        }
+    } else {
+        s.failed++;
+    }
+    head[c] = (head[c] + 1) % POLICIES[c].depth;
+    count[c]--;
+    holding[c] = false;
+    return peeked;
+}
+
+/**
+ * @brief Note le rappel d'envoi d'une trame
+ * @param txClass Classe de la trame
+ * @param latencyUs Du rangement au rappel d'envoi
+ */
+void TxScheduler::recordDone(TxClass txClass, int64_t latencyUs) {
+    if (txClass >= TX_CLASS_COUNT || latencyUs < 0) {
+        return;
+    }
+    TxClassStats& s = stats[txClass];
+    s.done++;
+    s.doneSumUs += (uint64_t)latencyUs;
+    if ((uint32_t)latencyUs > s.doneMaxUs) {
+        s.doneMaxUs = (uint32_t)latencyUs;
+    }
+}
+
+/**
+ * @brief Des trames attendent
+ */
+bool TxScheduler::hasPending() const {
+    for (uint8_t c = 0; c < TX_CLASS_COUNT; c++) {
+        if (count[c] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Une trame attend encore dans sa file
+ * @param id Identifiant rendu par push()
+ */
+bool TxScheduler::isQueued(uint32_t id) const {
+    for (uint8_t c = 0; c < TX_CLASS_COUNT; c++) {
+        for (uint8_t i = 0; i < count[c]; i++) {
+            if (pool[first[c] + (head[c] + i) % POLICIES[c].depth].id == id) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Heure à laquelle une trame en attente pourra partir au plus tard
+ * @param nowUs Heure courante
+ * @return nowUs si une trame n'attend que le pilote, INT64_MAX si aucune n'attend
+ */
+int64_t TxScheduler::getNextReleaseUs(int64_t nowUs) {
+    int64_t next = INT64_MAX;
+    for (uint8_t c = 0; c < TX_CLASS_COUNT; c++) {
+        if (count[c] == 0) {
+            continue;
+        }
+        uint32_t budget = POLICIES[c].budgetUsPerS;
+        if (budget == 0) {
+            return nowUs;
+        }
+        refill(c, nowUs);
+        int64_t missing = (int64_t)airtimeUs(front(c).len) * TOKEN - tokensUs[c];
+        int64_t at = nowUs;
+        if (missing > 0) {
+            // budget us of airtime per second = budget * TOKEN units per 1000000 us
+            at += (missing * 1000000 + (int64_t)budget * TOKEN - 1) / ((int64_t)budget * TOKEN);
+        }
+        if (at < next) {
+            next = at;
+        }
+    }
+    return next;
+}
+
+/**
+ * @brief Compteurs d'une classe
+ */
+const TxClassStats& TxScheduler::getStats(TxClass txClass) const {
+    return stats[txClass < TX_CLASS_COUNT ? txClass : TX_LIVE];
+}
+
+/**
+ * @brief Nom d'une classe pour les rapports
+ */
+const char* TxScheduler::getClassName(TxClass txClass) {
+    return txClass < TX_CLASS_COUNT ? POLICIES[txClass].name : "?";
+}
+
+/**
+ * @brief Durée d'antenne d'une trame ESP-NOW longue portée
+ * @param len Longueur des données ESP-NOW
+ * @return Durée en microsecondes (préambule, en-têtes 802.11 et ESP-NOW, FCS)
+ */
+uint32_t TxScheduler::airtimeUs(size_t len) {
+    return LR_PREAMBLE_US + (uint32_t)(len + FRAME_OVERHEAD) * LR_US_PER_BYTE;
+}
+
+/**
+ * @brief Affiche une ligne par classe ayant émis ou perdu des trames
+ */
+void TxScheduler::printReport() {
+    for (uint8_t c = 0; c < TX_CLASS_COUNT; c++) {
+        const TxClassStats& s = stats[c];
+        if (s.queued == 0) {
+            continue;
+        }
+        Serial.printf("TX %s: %lu sent, %lu dropped, %lu failed, airtime %lu ms | wait avg %.1f max %.1f ms, "
+                      "done avg %.1f max %.1f ms",
+                      POLICIES[c].name, s.sent, s.dropped, s.failed, (uint32_t)(s.airtimeUs / 1000),
+                      s.sent ? s.waitSumUs / 1000.0 / s.sent : 0.0, s.waitMaxUs / 1000.0,
+                      s.done ? s.doneSumUs / 1000.0 / s.done : 0.0, s.doneMaxUs / 1000.0);
+        if (POLICIES[c].budgetUsPerS != 0) {
+            Serial.printf(" | budget %lu ms/s, %lu throttled", POLICIES[c].budgetUsPerS / 1000, s.throttled);
+        }
+        Serial.println();
+    }
+}
+
+/**
+ * @brief Remplit le seau d'une classe
+ * @param c Classe
+ * @param nowUs Heure courante
+ */
+void TxScheduler::refill(uint8_t c, int64_t nowUs) {
+    int64_t elapsed = nowUs - lastRefillUs[c];
+    lastRefillUs[c] = nowUs;
+    if (elapsed <= 0) {
+        return;
+    }
+    int64_t capacity = (int64_t)POLICIES[c].burstUs * TOKEN;
+    // budgetUsPerS us of airtime per second = budgetUsPerS / 1000 bucket units per us
+    int64_t gain = elapsed >= 1000000 ? capacity : elapsed * POLICIES[c].budgetUsPerS / 1000;
+    tokensUs[c] = tokensUs[c] + gain < capacity ? tokensUs[c] + gain : capacity;
+}
+
+/**
+ * @brief Trame en tête de la file d'une classe
+ */
+TxFrame& TxScheduler::front(uint8_t c) {
+    return pool[first[c] + head[c]];
+}
@@ -0,0 +1,244 @@
+/**
+ * @file WindPerformance.cpp
+ * @brief Implémentation du vent réel et de la performance (TWA, VMG, polaire)
+ * @author OpenSailingRC Contributors
+ * @date 2025
+ * @version 1.0.5
+ *
+ * @copyright Copyright (c) 2025 OpenSailingRC
+ * @license GNU General Public License v3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @details
+ * Polaire: grille uniforme TWS 0-20 nœuds (pas de 2 nœuds) × |TWA| 0-180°
+ * (pas de 15°), vitesses cibles en 0,1 nœud (143 octets en flash). Valeurs
+ * indicatives pour un voilier radiocommandé de type IOM ; à remplacer par
+ * la polaire mesurée de la classe. Au-delà de 20 nœuds, la dernière
+ * colonne s'applique.
+ */
+
+#include "WindPerformance.h"
+
+static const uint16_t POLAR_TWS_STEP = 20;      // 2 kn (0.1 kn units)
+static const uint16_t POLAR_TWA_STEP = 150;     // 15° (0.1 deg units)
+static const uint8_t POLAR_TWS_COLS = 11;       // 0, 2, ... 20 kn
+static const uint8_t POLAR_TWA_ROWS = 13;       // 0, 15, ... 180°
+
+// Target boat speed (0.1 kn), rows = |TWA|, columns = TWS
+static const uint8_t POLAR_DECI_KN[POLAR_TWA_ROWS][POLAR_TWS_COLS] = {
+    //  0   2   4   6   8  10  12  14  16  18  20 kn
+    {   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },   //   0°
+    {   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 },   //  15°
+    {   0,  3,  6,  8, 10, 11, 12, 12, 12, 12, 12 },   //  30°
+    {   0,  6, 11, 15, 18, 20, 21, 22, 22, 22, 22 },   //  45°
+    {   0,  7, 13, 17, 20, 22, 24, 25, 25, 25, 25 },   //  60°
+    {   0,  8, 14, 18, 21, 24, 25, 26, 27, 27, 27 },   //  75°
+    {   0,  8, 14, 19, 22, 25, 27, 28, 29, 29, 29 },   //  90°
+    {   0,  8, 14, 19, 22, 25, 27, 29, 30, 30, 30 },   // 105°
+    {   0,  7, 13, 18, 22, 25, 27, 29, 30, 31, 31 },   // 120°
+    {   0,  6, 12, 16, 20, 23, 26, 28, 30, 31, 32 },   // 135°
+    {   0,  5, 10, 14, 18, 21, 24, 27, 29, 30, 31 },   // 150°
+    {   0,  4,  9, 13, 16, 19, 22, 25, 27, 28, 29 },   // 165°
+    {   0,  4,  8, 12, 15, 18, 21, 24, 26, 27, 28 }    // 180°
+};
+
+static const uint32_t DECI_KN_TO_CMS_Q8 = 1317; // 5.1444 cm/s per 0.1 kn, Q8
+
+/**
+ * @brief Constructeur
+ */
+WindPerformance::WindPerformance()
+    : windNorth(0), windEast(0), windSpeedKn(0),
+      lastSampleMs(0), sampleCount(0), lastSequence(0),
+      directionDeci(0), speedCms(0), speedDeciKn(0),
+      valid(false), angleDeci(0), vmgCms(0), targetCms(0), polarPermille(0),
+      cyclesSum(0), cyclesMax(0), cyclesCount(0) {
+}
+
+/**
+ * @brief Ajoute une mesure de l'anémomètre au vent lissé
+ * @param packet Trame reçue
+ * @param receivedAt millis() à la réception
+ * @return true si la trame est valide
+ *
+ * @details
+ * Moyenne exponentielle vectorielle, coefficient dt / (tau + dt) : la
+ * constante de temps ne dépend pas de la cadence de l'anémomètre. Après
+ * une perte du vent, la première mesure est reprise telle quelle.
+ */
+bool WindPerformance::applyAnemometer(const AnemometerPacket& packet, uint32_t receivedAt) {
+    float speed = packet.windSpeed;
+    float direction = packet.windDirection;
+    if (!(speed >= 0.0f && speed * 51.4444f <= MAX_WIND_CMS) || !(direction >= 0.0f && direction <= 360.0f)) {
+        return false;
+    }
+    if (sampleCount > 0 && packet.sequenceNumber == lastSequence) {
+        return false;  // Repeated frame
+    }
+
+    float rad = direction * (float)DEG_TO_RAD;
+    float north = speed * cosf(rad);
+    float east = speed * sinf(rad);
+    if (!hasWind(receivedAt)) {
+        windNorth = north;
+        windEast = east;
+        windSpeedKn = speed;
+    } else {
+        float dt = (float)(receivedAt - lastSampleMs);
+        float alpha = dt / ((float)WIND_TAU_MS + dt);
+        windNorth += alpha * (north - windNorth);
+        windEast += alpha * (east - windEast);
+        windSpeedKn += alpha * (speed - windSpeedKn);
+    }
+    lastSampleMs = receivedAt;
+    lastSequence = packet.sequenceNumber;
+    sampleCount++;
+
+    // Direction from the vector average, speed from the scalar average
+    // (a shifty breeze must not read lighter than it is)
+    float smoothedDeg = atan2f(windEast, windNorth) * (float)RAD_TO_DEG;
+    if (smoothedDeg < 0.0f) {
+        smoothedDeg += 360.0f;
+    }
+    directionDeci = (uint16_t)(lroundf(smoothedDeg * 10.0f) % 3600);
+    speedCms = (uint16_t)lroundf(windSpeedKn * 51.4444f);
+    speedDeciKn = (uint16_t)lroundf(windSpeedKn * 10.0f);
+    return true;
+}
+
+bool WindPerformance::hasWind(uint32_t now) const {
+    return sampleCount > 0 && (int32_t)(now - lastSampleMs) <= (int32_t)WIND_TIMEOUT_MS;
+}
+
+/**
+ * @brief Calcule TWA, VMG et pourcentage de polaire pour un nouveau fix
+ * @param data Nouveau fix
+ */
+void WindPerformance::update(const GPSData& data) {
+    uint32_t startCycles = ESP.getCycleCount();
+
+    uint16_t boatCms = (uint16_t)constrain(data.speed * 51.4444f, 0.0f, 65535.0f);
+    valid = data.valid && hasWind(data.fixMillis) && boatCms >= COURSE_CMS;
+    if (!valid) {
+        return;
+    }
+
+    int32_t courseDeci = (int32_t)(data.course * 10.0f);
+    int32_t angle = ((int32_t)directionDeci - courseDeci + 1800) % 3600;
+    if (angle < 0) {
+        angle += 3600;
+    }
+    angleDeci = (int16_t)(angle - 1800);
+    vmgCms = (int16_t)(((int32_t)boatCms * Geodesy::cosQ15(angleDeci)) >> 15);
+    targetCms = targetSpeedCms(speedDeciKn, (uint16_t)abs(angleDeci));
+    polarPermille = (targetCms > 0) ? (uint16_t)min((uint32_t)boatCms * 1000 / targetCms, (uint32_t)65535) : 0;
+
+    uint32_t cycles = ESP.getCycleCount() - startCycles;
+    cyclesSum += cycles;
+    cyclesMax = max(cyclesMax, cycles);
+    cyclesCount++;
+}
+
+/**
+ * @brief Vitesse cible de la polaire, interpolation bilinéaire en virgule fixe
+ *
+ * @details
+ * Poids Q8 sur chaque axe : le résultat intermédiaire est en 0,1 nœud Q16
+ * (au plus 255 << 16), converti en cm/s sans débordement 32 bits.
+ */
+uint16_t WindPerformance::targetSpeedCms(uint16_t twsDeciKn, uint16_t absAngleDeci) {
+    uint32_t col = twsDeciKn / POLAR_TWS_STEP;
+    uint32_t fx = (uint32_t)(twsDeciKn % POLAR_TWS_STEP) * 256 / POLAR_TWS_STEP;
+    if (col >= POLAR_TWS_COLS - 1) {
+        col = POLAR_TWS_COLS - 2;
+        fx = 256;
+    }
+    uint32_t row = absAngleDeci / POLAR_TWA_STEP;
+    uint32_t fy = (uint32_t)(absAngleDeci % POLAR_TWA_STEP) * 256 / POLAR_TWA_STEP;
+    if (row >= POLAR_TWA_ROWS - 1) {
+        row = POLAR_TWA_ROWS - 2;
+        fy = 256;
+    }
+
+    const uint8_t* low = POLAR_DECI_KN[row];
+    const uint8_t* high = POLAR_DECI_KN[row + 1];
+    uint32_t lowQ8 = low[col] * (256 - fx) + low[col + 1] * fx;
+    uint32_t highQ8 = high[col] * (256 - fx) + high[col + 1] * fx;
+    uint32_t q16 = lowQ8 * (256 - fy) + highQ8 * fy;
+    return (uint16_t)(((q16 >> 8) * DECI_KN_TO_CMS_Q8) >> 16);
+}
+
+bool WindPerformance::isValid() const {
+    return valid;
+}
+
+uint16_t WindPerformance::getDirectionDeci() const {
+    return directionDeci;
+}
+
+uint16_t WindPerformance::getSpeedCms() const {
+    return speedCms;
+}
+
+int16_t WindPerformance::getAngleDeci() const {
+    return angleDeci;
+}
+
+int16_t WindPerformance::getVmgCms() const {
+    return vmgCms;
+}
+
+uint16_t WindPerformance::getTargetCms() const {
+    return targetCms;
+}
+
+uint16_t WindPerformance::getPolarPermille() const {
+    return polarPermille;
+}
+
+/**
+ * @brief Affiche le vent et la performance (status update)
+ *
+ * @details
+ * Exemple:
+ * Wind: 215.0° 8.4 kn (2 s ago, 124 frames) | TWA -42.0°, VMG 2.1 kn, 87% of 2.5 kn | 140 cycles/fix (max 310)
+ */
+void WindPerformance::printReport() {
+    static const float CMS_TO_KN = 1.0f / 51.4444f;
+    uint32_t now = millis();
+
+    if (!hasWind(now)) {
+        if (sampleCount > 0) {
+            Serial.printf("Wind: lost (last frame %lu s ago)\n", (now - lastSampleMs) / 1000);
+        } else {
+            Serial.println("Wind: no anemometer");
+        }
+        return;
+    }
+    Serial.printf("Wind: %.1f° %.1f kn (%lu s ago, %lu frames)", directionDeci / 10.0f, speedCms * CMS_TO_KN,
+                  (now - lastSampleMs) / 1000, sampleCount);
+    if (valid) {
+        Serial.printf(" | TWA %.1f°, VMG %.1f kn, %u%% of %.1f kn", angleDeci / 10.0f, vmgCms * CMS_TO_KN,
+                      (polarPermille + 5) / 10, targetCms * CMS_TO_KN);
+    }
+    if (cyclesCount > 0) {
+        Serial.printf(" | %lu cycles/fix (max %lu)", cyclesSum / cyclesCount, cyclesMax);
+    }
+    Serial.println();
+
+    cyclesSum = 0;
+    cyclesMax = 0;
+    cyclesCount = 0;
+}
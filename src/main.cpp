@@ -32,7 +32,7 @@
  * 
  * Communication: ESP-NOW broadcast (FF:FF:FF:FF:FF:FF)
  * Range: 100-200m line of sight
- * Broadcast frequency: 1 Hz (configurable)
+ * Broadcast frequency: 1 Hz (configurable over the air, see Config)
  */
 
 #include <M5Unified.h>
@@ -42,6 +42,20 @@
 #include "Communication.h"
 #include "Logger.h"
 #include "Storage.h"
+#include "Config.h"
+#include "PowerManager.h"
+#include "RatePolicy.h"
+#include "StartLine.h"
+#include "StartSequence.h"
+#include "SessionStats.h"
+#include "CourseMarks.h"
+#include "WindPerformance.h"
+#include "CourseSmoother.h"
+#include "ManoeuvreCapture.h"
+#include "ProximityMonitor.h"
+#include "TimeBeacon.h"
+#include "ChannelHopper.h"
+#include "Gateway.h"
 
 // ============================================================================
 // CONFIGURATION
@@ -60,9 +74,16 @@ const uint8_t GPS_TX_PIN = 19;             // GPIO19 for GPS TX
 const uint8_t LED_PIN = 27;                // RGB LED on GPIO27 (Atom Lite)
 #endif
 
-const uint32_t BROADCAST_INTERVAL_BASE = 1000;  // Base broadcast interval (1 second)
-const uint32_t BROADCAST_JITTER_MS = 100;       // ±100ms random jitter to avoid collisions between boats
+// Broadcast interval, jitter, channel and TDMA slots come from Config (NVS / fleet config frames)
 const uint32_t STATUS_INTERVAL = 5000;           // Status update every 5 seconds
+const uint32_t CONFIG_ACK_MAX_DELAY_MS = 300;    // Config ACK spread over 0-300ms to avoid collisions
+const uint32_t CHANNEL_SWITCH_TIMEOUT_MS = 500;  // Channel change applied even if its ACK never left
+const uint32_t START_CANCEL_HOLD_MS = 2000;      // Button hold that cancels the start sequence
+const uint8_t EVENT_REPEATS = 2;                 // Event frames repeated with the next broadcasts
+const uint8_t EVENT_QUEUE = 4;                   // Events being repeated at the same time
+const uint32_t SESSION_END_HOLD_MS = 5000;       // Button hold that ends the session (summary, new log file)
+const uint32_t STATS_TELEMETRY_MS = 5000;        // Telemetry period outside the start sequence
+const uint16_t CAPTURE_GNSS_PERIOD_MS = 100;     // Receiver fix period in manoeuvre windows (NEO-6M: 200 ms)
 
 // SD Storage configuration based on build flags
 #ifdef DISABLE_SD_STORAGE
@@ -71,6 +92,13 @@ const bool ENABLE_SD_STORAGE = false;      // AtomS3 Lite: No SD card
 const bool ENABLE_SD_STORAGE = true;       // Atom GPS Base: SD card available
 #endif
 
+// Base-station mode (ESP-NOW to USB gateway): build flag, else NVS key "mode" = "gateway"
+#ifdef GATEWAY_MODE
+const bool GATEWAY_BUILD = true;
+#else
+const bool GATEWAY_BUILD = false;
+#endif
+
 // LED Configuration
 const uint8_t LED_COUNT = 1;               // One RGB LED
 CRGB leds[LED_COUNT];
@@ -119,6 +147,20 @@ void sendUBX(const uint8_t *msg, uint8_t len) {
 GPS gps(GPS_RX_PIN, GPS_TX_PIN);
 Communication comm;
 Storage storage;
+Config config;
+PowerManager power;
+RatePolicy ratePolicy;
+StartLine startLine;
+StartSequence startSequence;
+SessionStats sessionStats;
+CourseMarks courseMarks;
+WindPerformance windPerformance;
+CourseSmoother courseSmoother;
+ManoeuvreCapture manoeuvreCapture;
+ProximityMonitor proximity;
+TimeBeacon timeBeacon;
+ChannelHopper channelHopper;
+Gateway gateway;
 Preferences preferences;
 
 // ============================================================================
@@ -126,9 +168,26 @@ Preferences preferences;
 // ============================================================================
 String boatName = ""; // Boat name from preferences or MAC address
 uint32_t lastBroadcast = 0;
+uint32_t nextBroadcast = 0;        // millis() of the next scheduled broadcast
 uint32_t lastStatus = 0;
 uint32_t validPacketCount = 0;
 uint32_t invalidPacketCount = 0;
+uint8_t localMAC[6];
+ConfigAckPacket pendingAck;        // Config ACK waiting for its random send delay
+uint32_t pendingAckAt = 0;         // millis() when pendingAck must be sent (0 = none)
+uint8_t pendingChannel = 0;        // Channel of a config push, applied once its ACK has left (0 = none)
+uint32_t pendingChannelAckId = 0;  // Frame id of that ACK (Communication::isTxDone())
+uint32_t pendingChannelAt = 0;     // millis() after which the channel is applied anyway
+uint32_t lastFixMillis = 0;        // fixMillis of the last fix given to ratePolicy
+uint16_t gnssPeriodMs = 1000;      // Fix period currently configured on the receiver
+EventPacket pendingEvents[EVENT_QUEUE];        // Recent events, repeated with the next broadcasts
+uint8_t pendingEventRepeats[EVENT_QUEUE] = {0};  // Remaining repeats of each pending event
+uint8_t nextEventSlot = 0;         // Slot of the next event (oldest overwritten)
+uint16_t eventSequence = 0;        // Shared by all event sources (receivers drop repeats)
+StartState previousStartState = START_IDLE;     // To detect the gun for lap timing
+uint32_t lastTelemetry = 0;        // millis() of the last telemetry frame
+bool sessionEndHandled = false;    // Long hold already processed (until release)
+bool gatewayMode = false;          // Base station: frames to USB, no GPS, no broadcast
 
 // ============================================================================
 // LED STATUS INDICATORS
@@ -144,7 +203,9 @@ uint32_t invalidPacketCount = 0;
  * - Blue (0x0000FF)   : Initialization in progress
  * - Yellow (0xFFFF00) : Waiting for GPS fix
  * - Green (0x00FF00)  : Valid GPS data, transmission OK
- * - Red (0xFF0000)    : Critical error
+ * - Orange (0xFF6000) : Converging boat (proximity alert)
+ * - Cyan (0x00FFFF)   : Gateway mode, frames forwarded to USB
+ * - Red (0xFF0000)    : Imminent closest approach, steady (critical error: blinking)
  * - Off (0x000000)    : Inactive
  */
 void setStatusLED(uint32_t color) {
@@ -170,10 +231,183 @@ void blinkLED(uint32_t color, int times = 1) {
     }
 }
 
+/**
+ * @brief Status LED color with a valid fix
+ * @param burst Start window (high rate)
+ * @return Proximity alert color, else cyan in the start window, else green
+ */
+uint32_t fixLEDColor(bool burst) {
+    switch (proximity.getLevel()) {
+        case PROXIMITY_DANGER:
+            return 0xFF0000;
+        case PROXIMITY_CONVERGING:
+            return 0xFF6000;
+        default:
+            return burst ? 0x00FFFF : 0x00FF00;
+    }
+}
+
+// ============================================================================
+// BROADCAST RATE
+// ============================================================================
+
+/**
+ * @brief Apply the current broadcast interval to the radio and GNSS receiver
+ * 
+ * @details
+ * - The rate is announced in every GPSBroadcastPacket
+ * - The receiver fix period follows the broadcast interval below 1 s
+ * - GNSS power save is only allowed at 1 Hz or slower: the receiver
+ *   update period then follows the broadcast interval
+ * - In a manoeuvre capture window the receiver runs at its fastest rate
+ *   whatever the broadcast interval (logged, not broadcast)
+ */
+void applyBroadcastRate() {
+    const BoatConfig& cfg = config.get();
+    uint16_t interval = ratePolicy.getIntervalMs();
+    comm.setRateDeciHz(ratePolicy.getRateDeciHz());
+    
+    bool capturing = manoeuvreCapture.isCapturing();
+    uint16_t period = capturing ? CAPTURE_GNSS_PERIOD_MS : min(interval, (uint16_t)1000);
+    if (period != gnssPeriodMs) {
+        gnssPeriodMs = period;
+        gps.setUpdateRate(period);
+    }
+    gps.setPowerSaveAllowed(cfg.gnssPowerSave && interval >= 1000 && !capturing, interval);
+}
+
+/**
+ * @brief Reconfigure the rate policy from the active config
+ */
+void applyRateConfig() {
+    const BoatConfig& cfg = config.get();
+    ratePolicy.configure(cfg.broadcastIntervalMs, cfg.adaptiveRate, cfg.channelBudget,
+                         cfg.tdmaSlotCount > 0);
+    startSequence.configure(cfg.startCountdownS, cfg.startWindowS, cfg.startIntervalMs);
+    if (cfg.lineCommitteeLat != 0 || cfg.lineCommitteeLon != 0 || cfg.linePinLat != 0 || cfg.linePinLon != 0) {
+        startLine.setLine(cfg.lineCommitteeLat, cfg.lineCommitteeLon, cfg.linePinLat, cfg.linePinLon);
+    }
+    if (ratePolicy.hasOverride()) {
+        ratePolicy.setOverride(cfg.startIntervalMs);
+    }
+    storage.setTrackTolerance(cfg.trackToleranceCm);
+    proximity.setHorizon(cfg.proximityTcpaS);
+    timeBeacon.setInterval(cfg.timeBeaconMs);
+    channelHopper.configure(cfg.hopChannels, cfg.hopGroups, cfg.tdmaSlotIndex, cfg.wifiChannel);
+    applyBroadcastRate();
+}
+
+/**
+ * @brief Send an event at once, log it, and queue its repeats
+ * @param event Event filled by its source (eventSequence assigned here)
+ * @param timestamp GPS timestamp of the fix that triggered the event
+ */
+void publishEvent(EventPacket& event, uint32_t timestamp) {
+    event.eventSequence = ++eventSequence;
+    comm.sendFrame((const uint8_t*)&event, sizeof(event), TX_CONTROL);
+    
+    pendingEvents[nextEventSlot] = event;
+    pendingEventRepeats[nextEventSlot] = EVENT_REPEATS;
+    nextEventSlot = (nextEventSlot + 1) % EVENT_QUEUE;
+    
+    if (ENABLE_SD_STORAGE) {
+        storage.writeEvent(event, timestamp);
+    }
+}
+
+/**
+ * @brief Send the telemetry frame (start line, session stats, wind) following a position broadcast
+ * @param gpsTime Current GPS time of day (ms)
+ */
+void sendTelemetry(uint32_t gpsTime) {
+    BoatTelemetryPacket telemetry;
+    memset(&telemetry, 0, sizeof(telemetry));
+    telemetry.messageType = MSG_TELEMETRY;
+    telemetry.version = TELEMETRY_VERSION;
+    telemetry.sequenceNumber = comm.getSequenceNumber();
+    telemetry.timeToLineMs = INT32_MAX;
+    
+    if (startLine.hasLine()) {
+        telemetry.flags |= TELEMETRY_HAS_LINE;
+        if (startLine.isOCS()) {
+            telemetry.flags |= TELEMETRY_OCS;
+        }
+        telemetry.lineDistanceCm = startLine.getDistanceMm() / 10;
+        telemetry.timeToLineMs = startLine.getTimeToLineMs();
+        telemetry.closingCms = (int16_t)constrain(startLine.getClosingMmps() / 10, (int32_t)-32768, (int32_t)32767);
+    }
+    if (startSequence.getState() != START_IDLE) {
+        telemetry.flags |= TELEMETRY_COUNTDOWN;
+        telemetry.timeToGunMs = startSequence.getTimeToGunMs(gpsTime);
+    }
+    
+    // Session statistics
+    if (sessionStats.getSide() == TACK_STARBOARD) {
+        telemetry.flags |= TELEMETRY_STARBOARD;
+    } else if (sessionStats.getSide() == TACK_PORT) {
+        telemetry.flags |= TELEMETRY_PORT;
+    }
+    telemetry.speed2sCms = sessionStats.getSpeed2sCms();
+    telemetry.distanceM = sessionStats.getDistanceM();
+    telemetry.speed10sCms = sessionStats.getSpeed10sCms();
+    telemetry.maxSpeedCms = sessionStats.getMaxSpeedCms();
+    telemetry.tacks = (uint8_t)min(sessionStats.getTacks(), (uint16_t)255);
+    telemetry.gybes = (uint8_t)min(sessionStats.getGybes(), (uint16_t)255);
+    telemetry.starboardS = (uint16_t)min(sessionStats.getTackTimeS(TACK_STARBOARD), (uint32_t)65535);
+    telemetry.portS = (uint16_t)min(sessionStats.getTackTimeS(TACK_PORT), (uint32_t)65535);
+    
+    // True wind and performance
+    if (windPerformance.hasWind(millis())) {
+        telemetry.flags |= TELEMETRY_WIND;
+        telemetry.twdDeci = windPerformance.getDirectionDeci();
+        telemetry.twsCms = windPerformance.getSpeedCms();
+        if (windPerformance.isValid()) {
+            telemetry.flags |= TELEMETRY_PERFORMANCE;
+            telemetry.twaDeci = windPerformance.getAngleDeci();
+            telemetry.vmgCms = windPerformance.getVmgCms();
+            telemetry.targetCms = windPerformance.getTargetCms();
+            telemetry.polarPermille = windPerformance.getPolarPermille();
+        }
+    }
+    
+    // Smoothed course and speed
+    telemetry.sogCms = courseSmoother.getSpeedCms();
+    telemetry.cogConfidence = courseSmoother.getConfidencePermille();
+    if (courseSmoother.isCourseValid()) {
+        telemetry.flags |= TELEMETRY_COURSE;
+        telemetry.cogDeci = courseSmoother.getCourseDeci();
+    }
+    comm.sendFrame((const uint8_t*)&telemetry, sizeof(telemetry), TX_TELEMETRY);
+}
+
 // ============================================================================
 // SETUP
 // ============================================================================
 
+/**
+ * @brief Base-station mode: ESP-NOW to USB gateway
+ *
+ * @details
+ * Listens on the configured channel (or follows the channel hopping
+ * schedule on the time beacons) and forwards every frame of the fleet to
+ * the serial link (see Gateway.h). No GPS, no SD card, no broadcast. A
+ * critical error blinks red and stops, as in setup().
+ */
+void setupGateway() {
+    Serial.println("Gateway mode: ESP-NOW to USB");
+    config.begin();
+    const BoatConfig& cfg = config.get();
+    gateway.setHop(cfg.hopChannels, cfg.hopGroups, cfg.tdmaSlotIndex);
+    if (!comm.begin(cfg.wifiChannel) || !gateway.begin(cfg.wifiChannel)) {
+        Serial.println("✗ Gateway initialization failed!");
+        blinkLED(0xFF0000, 5);  // Red blink = error
+        while(1) delay(1000);
+    }
+    
+    // Cyan LED: forwarding
+    setStatusLED(0x00FFFF);
+}
+
 /**
  * @brief System initialization
  * 
@@ -183,16 +417,28 @@ void blinkLED(uint32_t color, int times = 1) {
  * 2. M5Stack (AtomS3 Lite configuration)
  * 3. FastLED (status RGB LED)
  * 4. GPS (Serial2 on GPIO5/6 or GPIO22/19)
- * 5. ESP-NOW (broadcast communication)
+ * 5. Config (NVS) + ESP-NOW (broadcast communication)
  * 6. Logger (logging system)
  * 7. Storage (SD card if available)
+ * 8. Power management (profile from Config)
  * 
  * In case of critical error (GPS or ESP-NOW), the system
  * displays a blinking red LED and stops.
+ *
+ * In gateway mode, the serial link gets a large TX buffer at
+ * Gateway::SERIAL_BAUD and setup stops after ESP-NOW (setupGateway()).
  */
 void setup() {
-    // Initialize serial first for debugging
-    Serial.begin(115200);
+    // Initialize serial first for debugging (gateway: binary records, large TX buffer)
+    preferences.begin("boatgps", true); // Read-only
+    gatewayMode = GATEWAY_BUILD || preferences.getString("mode", "") == "gateway";
+    preferences.end();
+    if (gatewayMode) {
+        Serial.setTxBufferSize(Gateway::SERIAL_TX_BUFFER);
+        Serial.begin(Gateway::SERIAL_BAUD);
+    } else {
+        Serial.begin(115200);
+    }
     
     // Wait for USB Serial to be ready (ESP32-S3 with USB CDC)
     unsigned long startMillis = millis();
@@ -211,6 +457,7 @@ void setup() {
     cfg.internal_mic = false;       // AtomS3 Lite doesn't have microphone
     
     M5.begin(cfg);
+    M5.BtnA.setHoldThresh(START_CANCEL_HOLD_MS);  // Long press cancels the start sequence
     
     // Initialize FastLED for AtomS3 Lite RGB LED
     FastLED.addLeds<WS2812, LED_PIN, GRB>(leds, LED_COUNT);
@@ -227,6 +474,11 @@ void setup() {
     // Blue LED: Initialization
     setStatusLED(0x0000FF);
     
+    if (gatewayMode) {
+        setupGateway();
+        return;
+    }
+    
     // Initialize GPS
     Serial.println("1. Initializing GPS...");
     if (!gps.begin()) {
@@ -242,14 +494,15 @@ void setup() {
     // Initialize Communication
     Serial.println();
     Serial.println("2. Initializing ESP-NOW...");
-    if (!comm.begin()) {
+    config.begin();
+    if (!comm.begin(config.get().wifiChannel)) {
         Serial.println("✗ Communication initialization failed!");
         blinkLED(0xFF0000, 5);  // Red blink = error
         while(1) delay(1000);
     }
     
     // Get MAC address
-    uint8_t mac[6];
+    uint8_t* mac = localMAC;
     comm.getLocalMAC(mac);
     
     // Load boat name from preferences (M5Burner)
@@ -288,10 +541,23 @@ void setup() {
         if (!storage.begin(true)) {
             Serial.println("⚠️  SD card initialization warning (continuing anyway)");
         }
+        storage.setSessionStats(&sessionStats);
+        storage.setWindPerformance(&windPerformance);
+        storage.setCourseSmoother(&courseSmoother);
     } else {
         Serial.println("✓ SD storage disabled (AtomS3 Lite configuration)");
     }
     
+    // Initialize power management (CPU frequency, light sleep)
+    Serial.println();
+    Serial.println("5. Initializing Power management...");
+    power.begin(&gps, GPS_RX_PIN, (PowerProfile)config.get().powerProfile);
+    Geodesy::printBenchmark();
+    startLine.begin();
+    startSequence.begin(&startLine);
+    courseMarks.begin();
+    applyRateConfig();
+    
     Serial.println();
     Serial.println("==========================================");
     Serial.println("  System Ready - Waiting for GPS fix...");
@@ -302,6 +568,177 @@ void setup() {
     setStatusLED(0xFFFF00);
 }
 
+// ============================================================================
+// FLEET CONFIGURATION
+// ============================================================================
+
+void scheduleNextBroadcast(uint32_t currentTime);
+
+/**
+ * @brief Process frames received from ESP-NOW
+ * 
+ * @details
+ * Config frames are verified and applied by Config; the ACK of an
+ * authenticated frame (none otherwise) is delayed by a random 0-300ms so that a whole fleet answering the same
+ * broadcast does not collide. Course, countdown and anemometer frames go to
+ * their modules, positions of the other boats to the proximity table.
+ * Course and countdown frames are applied only when signed with the fleet key, like config frames.
+ * Other message types are ignored.
+ */
+void handleReceivedFrames() {
+    ReceivedFrame frame;
+    while (comm.receive(frame)) {
+        if (frame.len < 1) {
+            continue;
+        }
+        
+        switch ((int8_t)frame.data[0]) {
+            case MSG_BOAT: {
+                if (frame.len < sizeof(GPSBroadcastPacket)) {
+                    break;
+                }
+                GPSBroadcastPacket boat;
+                memcpy(&boat, frame.data, sizeof(boat));
+                proximity.applyBoat(frame.mac, boat, frame.receivedAt);
+                break;
+            }
+            case MSG_CONFIG_PUSH: {
+                uint8_t previousChannel = config.get().wifiChannel;
+                ConfigStatus status = config.applyPush(frame, localMAC, pendingAck);
+                if (!Config::isAcknowledged(status)) {
+                    // Unauthenticated frames are only counted (status report): no log flood
+                    if (status != CONFIG_NOT_ADDRESSED && config.getRejectedFrames() == 1) {
+                        Serial.printf("⚙️  Config frame ignored: status %d, no ack\n", status);
+                    }
+                    break;
+                }
+                
+                Serial.printf("⚙️  Config v%lu: status %d (active v%lu)\n",
+                             pendingAck.requestedVersion, status, pendingAck.activeVersion);
+                pendingAckAt = millis() + random(1, CONFIG_ACK_MAX_DELAY_MS);
+                
+                // ACK is sent on the current channel, the new one is applied after its send callback
+                if (config.get().wifiChannel != previousChannel) {
+                    comm.sendFrame((const uint8_t*)&pendingAck, sizeof(pendingAck), TX_CONTROL,
+                                   &pendingChannelAckId);
+                    pendingAckAt = 0;
+                    pendingChannel = config.get().wifiChannel;
+                    pendingChannelAt = millis() + CHANNEL_SWITCH_TIMEOUT_MS;
+                }
+                if (status == CONFIG_APPLIED || status == CONFIG_PERSIST_FAILED) {
+                    power.setProfile((PowerProfile)config.get().powerProfile);
+                    applyRateConfig();
+                    scheduleNextBroadcast(millis());
+                }
+                break;
+            }
+            case MSG_COURSE: {
+                if (frame.len < sizeof(CoursePacket)) {
+                    break;
+                }
+                CoursePacket coursePacket;
+                memcpy(&coursePacket, frame.data, sizeof(coursePacket));
+                // Another fleet on the channel or a stray sender: counted, the saved course stays
+                if (!config.authenticate(frame.data, offsetof(CoursePacket, signature), coursePacket.signature)) {
+                    break;
+                }
+                courseMarks.applyCourse(coursePacket);
+                break;
+            }
+            case MSG_ANEMOMETER: {
+                if (frame.len < sizeof(AnemometerPacket)) {
+                    break;
+                }
+                AnemometerPacket anemometer;
+                memcpy(&anemometer, frame.data, sizeof(anemometer));
+                windPerformance.applyAnemometer(anemometer, frame.receivedAt);
+                break;
+            }
+            case MSG_START_COUNTDOWN: {
+                if (frame.len < sizeof(StartCountdownPacket)) {
+                    break;
+                }
+                StartCountdownPacket countdown;
+                memcpy(&countdown, frame.data, sizeof(countdown));
+                // Unsigned: could cancel the start, move the gun or the line of the whole fleet
+                if (!config.authenticate(frame.data, offsetof(StartCountdownPacket, signature), countdown.signature)) {
+                    break;
+                }
+                startSequence.applyCountdown(countdown, gps.getTimeOfDayMs());
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    
+    if (pendingAckAt != 0 && (int32_t)(millis() - pendingAckAt) >= 0) {
+        comm.sendFrame((const uint8_t*)&pendingAck, sizeof(pendingAck), TX_CONTROL);
+        pendingAckAt = 0;
+    }
+}
+
+/**
+ * @brief Apply the channel of a config push once its ACK has left
+ * 
+ * @details
+ * esp_now_send() is asynchronous and the ACK may still wait in the
+ * control queue: switching at once would send it on the new channel, or
+ * not at all. The channel changes after the ACK send callback, or after
+ * CHANNEL_SWITCH_TIMEOUT_MS. The channel hopper is held meanwhile (it
+ * would move the radio to the new home channel).
+ */
+void applyPendingChannel() {
+    if (pendingChannel == 0) {
+        return;
+    }
+    if (!comm.isTxDone(pendingChannelAckId) && (int32_t)(millis() - pendingChannelAt) < 0) {
+        return;
+    }
+    comm.setChannel(pendingChannel);
+    pendingChannel = 0;
+}
+
+/**
+ * @brief Compute the next broadcast instant
+ * @param currentTime Current millis()
+ * 
+ * @details
+ * - TDMA (tdmaSlotCount > 0, GPS time known): each boat transmits at the
+ *   start of its own slot, aligned on the GPS time of day. In the start
+ *   window the slot table is compressed into the short start interval.
+ * - Otherwise: base interval with random jitter to avoid collisions
+ * 
+ * The interval comes from ratePolicy (speed / turn rate, channel budget).
+ * With TDMA it is a whole multiple of the configured interval, so the
+ * slot position is kept. The jitter is limited to a quarter of the
+ * interval at high rates.
+ * 
+ * The instant is computed once per period so that PowerManager can sleep
+ * until just before it.
+ */
+void scheduleNextBroadcast(uint32_t currentTime) {
+    const BoatConfig& cfg = config.get();
+    uint32_t gpsTime = gps.getTimeOfDayMs();
+    uint32_t interval = ratePolicy.getIntervalMs();
+    
+    if (cfg.tdmaSlotCount > 0 && gpsTime != 0) {
+        uint32_t period = ratePolicy.hasOverride() ? interval : cfg.broadcastIntervalMs;
+        uint32_t slotWidth = period / cfg.tdmaSlotCount;
+        uint32_t slotStart = cfg.tdmaSlotIndex * slotWidth;
+        uint32_t wait = (slotStart + period - gpsTime % period) % period;
+        if (wait < period / 2) {
+            wait += period;  // Keep at least half an interval between frames
+        }
+        nextBroadcast = currentTime + wait + (interval - period);
+        return;
+    }
+    
+    uint32_t maxJitter = min((uint32_t)cfg.broadcastJitterMs, interval / 4);
+    uint32_t jitter = random(0, maxJitter * 2 + 1);  // 0-200ms random offset by default
+    nextBroadcast = currentTime + interval - maxJitter + jitter;
+}
+
 // ============================================================================
 // LOOP
 // ============================================================================
@@ -311,21 +748,31 @@ void setup() {
  * 
  * @details
  * Operating cycle:
- * 1. Update M5Stack (button handling)
- * 2. Update GPS (continuous NMEA parsing)
- * 3. Check broadcast interval (1 Hz by default)
- * 4. If GPS valid:
+ * 1. Update M5Stack (button: start countdown / sync, hold = cancel)
+ * 2. Update GPS (continuous NMEA parsing), channel of the current GPS second
+ *    (or of a config push, once its ACK has left), queued frames to the radio
+ *    (priority by traffic class, airtime budgets)
+ * 3. Process received frames (fleet config, start countdown)
+ * 4. Adapt broadcast rate on each new plausible fix (speed, turn rate, budget,
+ *    start window), start line metrics, detect start line crossings,
+ *    session statistics, mark roundings and laps, proximity alerts
+ * 5. Check broadcast instant (jitter or TDMA slot, not at a channel hop)
+ * 6. If GPS valid:
  *    - Broadcast ESP-NOW with retry (4 attempts)
  *    - Serial log with sequence number
  *    - SD save (if enabled)
  *    - Green LED (transmission OK)
- * 5. If GPS invalid:
+ * 7. If GPS invalid:
  *    - Yellow LED (waiting for fix)
  *    - Status display (satellite count, HDOP)
- * 6. Status report every 5 seconds
+ * 8. GPS time beacon when enabled (fleet config)
+ * 9. Status report every 5 seconds
  * 
  * Status LED:
  * - Green  : Valid data, transmission OK
+ * - Cyan   : Valid data, start window (high rate)
+ * - Orange : Converging boat, CPA within the alert horizon
+ * - Red    : CPA within 3 s, or a boat closer than 3 m
  * - Yellow : Waiting for GPS fix (< 4 satellites)
  */
 void loop() {
@@ -334,25 +781,179 @@ void loop() {
     // Update M5Stack
     M5.update();
     
-    // Update GPS data
+    // Base station: only forward frames (wait 1 ms when the ring is empty)
+    if (gatewayMode) {
+        if (!gateway.update()) {
+            delay(1);
+        }
+        return;
+    }
+    
+    // Start sequence: advance to the gun / end of window
+    uint32_t gpsTime = gps.getTimeOfDayMs();
+    startSequence.tick(gpsTime);
+    
+    // Gun (button countdown or committee frame): lap timing starts
+    if (startSequence.getState() != previousStartState) {
+        previousStartState = startSequence.getState();
+        if (previousStartState == START_RACING) {
+            courseMarks.startLaps((gpsTime + 86400000UL + startSequence.getTimeToGunMs(gpsTime)) % 86400000UL);
+        }
+    }
+    
+    // Coordinated high-rate window around the gun
+    bool burst = startSequence.isBurst(gpsTime);
+    if (burst != ratePolicy.hasOverride()) {
+        ratePolicy.setOverride(burst ? config.get().startIntervalMs : 0);
+        applyBroadcastRate();
+        scheduleNextBroadcast(currentTime);
+    }
+    
+    // Update GPS data (time anchor to the beacon clock), raw NMEA of the capture window to the SD card
     gps.update();
+    timeBeacon.update(gps);
+    applyPendingChannel();
+    if (pendingChannel == 0) {
+        channelHopper.update(comm, timeBeacon);
+    }
+    comm.service();
+    if (ENABLE_SD_STORAGE) {
+        char sentence[GPS::RAW_SENTENCE_LEN];
+        while (gps.readRawSentence(sentence)) {
+            storage.writeRawNmea(sentence);
+        }
+    }
     
     // Get current GPS data
     GPSData data = gps.getData();
     
-    // Check if it's time to broadcast (with random jitter to avoid collisions)
-    uint32_t jitter = random(0, BROADCAST_JITTER_MS * 2);  // 0-200ms random offset
-    if (currentTime - lastBroadcast >= (BROADCAST_INTERVAL_BASE - BROADCAST_JITTER_MS + jitter)) {
+    // Button: click = countdown / sync to the minute, double click = committee
+    // end, triple click = pin end (current position), hold = cancel
+    if (M5.BtnA.wasDecideClickCount()) {
+        switch (M5.BtnA.getClickCount()) {
+            case 1:
+                startSequence.buttonPressed(gpsTime);
+                break;
+            case 2:
+                if (data.valid) {
+                    startLine.setEnd(LINE_COMMITTEE, data.latitude, data.longitude);
+                }
+                break;
+            case 3:
+                if (data.valid) {
+                    startLine.setEnd(LINE_PIN, data.latitude, data.longitude);
+                }
+                break;
+        }
+    } else if (M5.BtnA.wasHold()) {
+        startSequence.cancel();
+    }
+    
+    // Long hold: end of session (summary record, next fix opens a new log file)
+    if (M5.BtnA.pressedFor(SESSION_END_HOLD_MS)) {
+        if (!sessionEndHandled) {
+            sessionEndHandled = true;
+            Serial.println("🏁 Session ended");
+            sessionStats.printReport();
+            if (ENABLE_SD_STORAGE) {
+                storage.endSession();
+            }
+            sessionStats.reset();
+        }
+    } else if (!M5.BtnA.isPressed()) {
+        sessionEndHandled = false;
+    }
+    
+    // Apply fleet configuration frames, send pending ACK
+    handleReceivedFrames();
+    
+    // Adapt the broadcast rate on each new fix. Outliers flagged by the fix
+    // filter are broadcast and logged (marked) but feed no analysis.
+    bool newFix = data.fixMillis != lastFixMillis;
+    lastFixMillis = data.fixMillis;
+    if (newFix && data.quality != FIX_GOOD && manoeuvreCapture.isCapturing() && ENABLE_SD_STORAGE) {
+        storage.writeGPSData(data, localMAC, comm.getSequenceNumber());
+    }
+    if (newFix && data.quality == FIX_GOOD) {
+        courseSmoother.update(data);
+        uint16_t previousInterval = ratePolicy.getIntervalMs();
+        ratePolicy.update(data);
+        applyBroadcastRate();
+        
+        // Faster rate: bring the pending broadcast forward (TDMA keeps its slots)
+        if (ratePolicy.getIntervalMs() < previousInterval && config.get().tdmaSlotCount == 0) {
+            scheduleNextBroadcast(lastBroadcast);
+        }
+        
+        // Line crossing, mark rounding, lap: sent at once, then repeated with the next broadcasts
+        uint32_t fixTime = (gpsTime != 0) ? (gpsTime + 86400000UL - (currentTime - data.fixMillis)) % 86400000UL : 0;
+        startLine.update(data, startSequence.getState() == START_COUNTDOWN);
+        windPerformance.update(data);
+        
+        // Tack sides: anemometer wind, else the start line bearing
+        float windFrom = -1.0f;
+        if (windPerformance.hasWind(data.fixMillis)) {
+            windFrom = windPerformance.getDirectionDeci() / 10.0f;
+        } else if (startLine.hasLine()) {
+            windFrom = startLine.getCourseSideBearing();
+        }
+        sessionStats.setWindDirection(windFrom);
+        sessionStats.update(data);
+        if (ENABLE_SD_STORAGE) {
+            storage.writeTrackPoint(data);
+        }
+        
+        // Manoeuvre windows: fastest GNSS rate, every fix and raw NMEA logged
+        bool wasCapturing = manoeuvreCapture.isCapturing();
+        ManoeuvreRecord manoeuvre;
+        manoeuvreCapture.setWindDirection(windFrom);
+        if (manoeuvreCapture.update(data, fixTime, manoeuvre)) {
+            EventPacket event;
+            manoeuvreCapture.fillEvent(manoeuvre, event);
+            publishEvent(event, manoeuvre.startTimestamp);
+            if (ENABLE_SD_STORAGE) {
+                storage.writeManoeuvre(manoeuvre, event.eventSequence);
+            }
+        }
+        if (manoeuvreCapture.isCapturing() != wasCapturing) {
+            gps.setRawCapture(manoeuvreCapture.isCapturing() && ENABLE_SD_STORAGE && storage.isAvailable());
+            applyBroadcastRate();
+        }
+        if (manoeuvreCapture.isCapturing() && ENABLE_SD_STORAGE) {
+            storage.writeGPSData(data, localMAC, comm.getSequenceNumber());
+        }
+        EventPacket events[2];
+        if (startSequence.update(data, fixTime, events[0])) {
+            publishEvent(events[0], data.timestamp);
+        }
+        uint8_t markEvents = courseMarks.update(data, fixTime, events, 2);
+        for (uint8_t i = 0; i < markEvents; i++) {
+            publishEvent(events[i], data.timestamp);
+        }
+        
+        // Converging boats: LED at once, without waiting for the next broadcast
+        ProximityLevel previousLevel = proximity.getLevel();
+        ProximityLevel level = proximity.update(data);
+        if (level != previousLevel) {
+            setStatusLED(fixLEDColor(burst));
+            if (level > previousLevel) {
+                Serial.printf("⚠️  Proximity: %s, CPA %.1f m in %.1f s\n", proximity.getThreatName(),
+                             proximity.getThreatCpaMm() / 1000.0f, proximity.getThreatTcpaMs() / 1000.0f);
+            }
+        }
+    }
+    
+    // Check if it's time to broadcast (random jitter or TDMA slot), never across a channel hop
+    if ((int32_t)(currentTime - nextBroadcast) >= 0 && channelHopper.canTransmit(timeBeacon)) {
         lastBroadcast = currentTime;
+        scheduleNextBroadcast(currentTime);
         
         // Only broadcast if GPS data is valid
         if (gps.isValid()) {
-            // Green LED: Valid data
-            setStatusLED(0x00FF00);
+            // Green LED: Valid data (cyan in the start window, proximity alert first)
+            setStatusLED(fixLEDColor(burst));
             
-            // Get MAC address
-            uint8_t mac[6];
-            comm.getLocalMAC(mac);
+            const uint8_t* mac = localMAC;
             
             // Broadcast GPS data with boat name and 1 retry (2 total attempts)
             // Reduced from 4 retries to minimize channel congestion with multiple boats
@@ -360,6 +961,23 @@ void loop() {
             
             if (success) {
                 validPacketCount++;
+                power.recordBroadcast(data.fixMillis, currentTime);
+                ratePolicy.recordBroadcast(currentTime);
+                
+                for (uint8_t i = 0; i < EVENT_QUEUE; i++) {
+                    if (pendingEventRepeats[i] > 0) {
+                        comm.sendFrame((const uint8_t*)&pendingEvents[i], sizeof(pendingEvents[i]), TX_CONTROL);
+                        pendingEventRepeats[i]--;
+                    }
+                }
+                
+                // Telemetry, matched to the position by sequence number: with each
+                // broadcast around the start, every STATS_TELEMETRY_MS otherwise
+                if (startLine.hasLine() || startSequence.getState() != START_IDLE ||
+                    currentTime - lastTelemetry >= STATS_TELEMETRY_MS) {
+                    lastTelemetry = currentTime;
+                    sendTelemetry(gpsTime);
+                }
                 
                 // Get sequence number after broadcast
                 uint32_t seqNum = comm.getSequenceNumber();
@@ -368,8 +986,9 @@ void loop() {
                 Serial.printf("[SEQ #%lu] ", seqNum);
                 Logger::logGPSData(data, mac);
                 
-                // Save to SD card with sequence number (if enabled)
-                if (ENABLE_SD_STORAGE) {
+                // Save to SD card with sequence number (if enabled, every fix is
+                // already logged in a manoeuvre window)
+                if (ENABLE_SD_STORAGE && !manoeuvreCapture.isCapturing()) {
                     storage.writeGPSData(data, mac, seqNum);
                 }
             }
@@ -385,6 +1004,11 @@ void loop() {
         }
     }
     
+    // GPS time beacon (fleet config key 20), TX wait of the previous one included
+    if (channelHopper.canTransmit(timeBeacon)) {
+        timeBeacon.service(comm, currentTime);
+    }
+    
     // Status update
     if (currentTime - lastStatus >= STATUS_INTERVAL) {
         lastStatus = currentTime;
@@ -398,9 +1022,29 @@ void loop() {
                      gps.getHDOP());
         Serial.printf("Packets: %lu valid, %lu invalid\n",
                      validPacketCount, invalidPacketCount);
+        Serial.printf("Config: v%lu, %u ms, channel %d, TDMA %d/%d (RX dropped: %lu, unauthenticated: %lu)\n",
+                     config.get().version, config.get().broadcastIntervalMs,
+                     config.get().wifiChannel, config.get().tdmaSlotIndex,
+                     config.get().tdmaSlotCount, comm.getRxDropped(), config.getRejectedFrames());
+        power.printReport();
+        gps.printPowerReport();
+        gps.printFilterReport();
+        courseSmoother.printReport();
+        ratePolicy.printReport();
+        startLine.printReport();
+        sessionStats.printReport();
+        manoeuvreCapture.printReport();
+        windPerformance.printReport();
+        courseMarks.printReport();
+        proximity.printReport();
+        timeBeacon.printReport();
+        channelHopper.printReport();
+        comm.printTxReport();
+        startSequence.printReport(gpsTime);
         
         if (storage.isAvailable()) {
             Serial.printf("SD Storage: %s\n", storage.getCurrentFileName().c_str());
+            storage.printTrackReport();
         } else {
             Serial.println("SD Storage: Disabled");
         }
@@ -414,6 +1058,19 @@ void loop() {
         Serial.println();
     }
     
-    // Small delay to prevent overwhelming the system
-    delay(10);
+    // Wait for next iteration (delay or light sleep depending on power profile)
+    uint32_t wakeAt = nextBroadcast;
+    if (timeBeacon.isEnabled() && (int32_t)(timeBeacon.getNextBeacon() - wakeAt) < 0) {
+        wakeAt = timeBeacon.getNextBeacon();
+    }
+    if (channelHopper.isEnabled() && (int32_t)(channelHopper.getNextHop(currentTime) - wakeAt) < 0) {
+        wakeAt = channelHopper.getNextHop(currentTime);
+    }
+    if (comm.hasPendingTx() && (int32_t)(comm.getNextTx(currentTime) - wakeAt) < 0) {
+        wakeAt = comm.getNextTx(currentTime);
+    }
+    if (pendingChannel != 0 && (int32_t)(currentTime + 10 - wakeAt) < 0) {
+        wakeAt = currentTime + 10;  // Config ACK on air for a few ms, then the channel change
+    }
+    power.idle(wakeAt);
 }
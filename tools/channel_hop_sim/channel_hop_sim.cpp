@@ -0,0 +1,457 @@
+/**
+ * Simulation de la capacité du saut de canal (outil PC)
+ *
+ * Instructions :
+ * 1. Compiler : pio run -e native-channel-hop-sim
+ *    (programme : .pio/build/native-channel-hop-sim/program)
+ * 2. Sans option : flottes de 10 à 60 bateaux à 10 Hz, un point d'accès
+ *    chargé à 30 % sur le canal 1, chaque flotte sur canal fixe puis en
+ *    saut sur 1, 6 et 11 (un groupe, puis trois groupes)
+ * 3. --boats, --rate-hz, --channels, --groups, --ap-channel, --ap-load :
+ *    une seule configuration (voir CHANNEL_HOP.md)
+ *
+ * Monte-Carlo avec le plan du firmware (lib/BoatProtocol/ChannelHop.h) :
+ * chaque bateau diffuse ses positions (trame LR de 48 octets) avec la
+ * gigue du firmware, à travers un accès au canal CSMA (écoute, DIFS,
+ * délai aléatoire). Deux trames qui démarrent dans le même slot se
+ * détruisent. Le point d'accès est une station de plus, qui écoute aussi
+ * le canal. Les horloges des bateaux et des récepteurs ont l'erreur des
+ * balises horaires (TIME_BEACON.md), les récepteurs changent de canal
+ * avec le retard de leur loop().
+ *
+ * Une trame est livrée si au moins un récepteur l'entend en entier : un
+ * récepteur par groupe (hub ou Display qui suit ce groupe).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <deque>
+#include <queue>
+#include <random>
+#include <vector>
+#include "BoatProtocol.h"
+#include "ChannelHop.h"
+
+static const char* USAGE =
+    "Usage: %s [options]\n"
+    "  --runs N             Draws per configuration (default 10)\n"
+    "  --duration S         Simulated time per draw (default 60 s)\n"
+    "  --seed N             Random seed (default 1)\n"
+    "  --clock-us N         Clock error of boats and receivers, standard deviation (default 400)\n"
+    "One configuration instead of the table:\n"
+    "  --boats N            Fleet size (default 20)\n"
+    "  --rate-hz N          Position rate of each boat (default 10)\n"
+    "  --channels MASK      Hop channels, bit n = channel n (default 0x842 = 1, 6, 11; 0 = fixed channel 1)\n"
+    "  --groups N           Groups spread over the channels (default 1)\n"
+    "  --ap-channel N       Channel of a busy access point (default 1, 0 = none)\n"
+    "  --ap-load PCT        Airtime used by the access point (default 30)\n";
+
+// ---- Model (802.11 DSSS timings, ESP-NOW LR frame sizes, orders of magnitude) ----
+static const int64_t GPS_EPOCH_US = 1750000000LL * 1000000;   // Arbitrary GPS date of the draws
+static const int64_t LR_PREAMBLE_US = 400;         // 802.11 LR frame: preamble and header
+static const int64_t LR_US_PER_BYTE = 32;          // 250 kbit/s
+static const int64_t FRAME_OVERHEAD = 43;          // 802.11 + ESP-NOW headers, FCS
+static const int64_t SLOT_US = 20;                 // Two starts in the same slot collide
+static const int64_t DIFS_US = 50;
+static const uint32_t CW_SLOTS = 31;               // Random backoff 0-31 slots
+static const size_t QUEUE_DEPTH = 4;               // ESP-NOW TX queue: further frames refused
+static const int64_t AP_FRAME_US = 1500;           // Access point data frame and its ACK
+static const int64_t LISTENER_LATENCY_US = 1000;   // Receiver loop(): hop after its GPS second
+static const int64_t JITTER_MAX_US = 100000;       // Config broadcastJitterMs, at most interval / 4
+
+struct Mode {
+    const char* name;
+    uint16_t channelMask;   // 0 = fixed channel
+    uint8_t groups;
+};
+
+struct Setup {
+    uint32_t boats;
+    double rateHz;
+    uint8_t apChannel;
+    double apLoadPct;
+};
+
+static const Mode MODES[] = {
+    {"channel 1", 0, 1},
+    {"hop 1/6/11", 0x0842, 1},
+    {"hop 1/6/11, 3 groups", 0x0842, 3},
+};
+
+static const uint32_t FLEETS[] = {10, 20, 40, 60};
+
+/**
+ * @brief Totals over the draws of one configuration
+ */
+struct Totals {
+    uint64_t offered = 0;
+    uint64_t delivered = 0;
+    uint64_t collided = 0;
+    uint64_t offChannel = 0;
+    uint64_t queueFull = 0;
+    double seconds = 0;
+    std::vector<double> waitsUs;
+
+    double pct(uint64_t n) const {
+        return offered ? 100.0 * n / offered : 0;
+    }
+
+    double waitPercentile(double p) {
+        if (waitsUs.empty()) {
+            return 0;
+        }
+        size_t index = (size_t)(p * (waitsUs.size() - 1));
+        std::nth_element(waitsUs.begin(), waitsUs.begin() + index, waitsUs.end());
+        return waitsUs[index];
+    }
+};
+
+struct Transmission {
+    int64_t start;
+    int64_t end;
+    uint32_t node;
+    uint8_t channel;
+    bool collided;
+};
+
+struct Event {
+    int64_t time;
+    uint32_t node;
+    bool arrival;
+
+    bool operator>(const Event& other) const {
+        return time > other.time;
+    }
+};
+
+struct Node {
+    bool accessPoint;
+    uint8_t group;
+    double clockErrorUs;          // Local GPS time minus true time
+    std::deque<int64_t> queue;    // Arrival times of the waiting frames
+    bool attemptPending;
+};
+
+static uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static int64_t airtimeUs(size_t len) {
+    return LR_PREAMBLE_US + (int64_t)(len + FRAME_OVERHEAD) * LR_US_PER_BYTE;
+}
+
+/**
+ * @brief One draw of one configuration
+ */
+class Draw {
+public:
+    Draw(const Setup& setup, const Mode& mode, double clockSigmaUs, uint64_t seed)
+        : setup(setup), engine(seed), seed(seed) {
+        hopping = schedule.configure(mode.channelMask, mode.groups) && schedule.isEnabled();
+        std::normal_distribution<double> clock(0, clockSigmaUs);
+        for (uint32_t i = 0; i < setup.boats; i++) {
+            nodes.push_back({false, (uint8_t)(i % schedule.getGroups()), clock(engine), {}, false});
+        }
+        if (setup.apChannel != 0 && setup.apLoadPct > 0) {
+            apNode = (uint32_t)nodes.size();
+            nodes.push_back({true, 0, 0, {}, false});
+        }
+        for (uint8_t g = 0; g < (hopping ? schedule.getGroups() : 1); g++) {
+            listenerGroups.push_back(g);
+            listenerErrors.push_back(clock(engine));
+        }
+    }
+
+    void run(int64_t durationUs, Totals& totals) {
+        int64_t interval = (int64_t)(1e6 / setup.rateHz);
+        int64_t jitter = std::min(JITTER_MAX_US, interval / 4);
+        for (uint32_t i = 0; i < setup.boats; i++) {
+            int64_t phase = uniformUs(0, interval);
+            for (int64_t t = phase; t < durationUs; t += interval) {
+                events.push({std::max((int64_t)0, t + uniformUs(-jitter, jitter)), i, true});
+                totals.offered++;
+            }
+        }
+        if (apNode != UINT32_MAX) {
+            events.push({nextApArrival(0), apNode, true});
+        }
+
+        while (!events.empty()) {
+            Event e = events.top();
+            events.pop();
+            if (e.time >= durationUs) {
+                if (!nodes[e.node].accessPoint && e.arrival) {
+                    totals.offered--;  // Jitter pushed it past the end
+                }
+                continue;
+            }
+            if (e.arrival) {
+                arrive(e.node, e.time, totals);
+            } else {
+                attempt(e.node, e.time, totals);
+            }
+        }
+
+        for (const Transmission& tx : transmissions) {
+            if (nodes[tx.node].accessPoint) {
+                continue;
+            }
+            if (tx.collided) {
+                totals.collided++;
+            } else if (heard(tx)) {
+                totals.delivered++;
+            } else {
+                totals.offChannel++;
+            }
+        }
+        // Frames still queued at the end are neither delivered nor lost
+        for (const Node& node : nodes) {
+            if (!node.accessPoint) {
+                totals.offered -= node.queue.size();
+            }
+        }
+        totals.seconds += durationUs / 1e6;
+    }
+
+private:
+    const Setup& setup;
+    std::mt19937_64 engine;
+    uint64_t seed;
+    ChannelHop schedule;
+    bool hopping = false;
+    std::vector<Node> nodes;
+    uint32_t apNode = UINT32_MAX;
+    std::vector<uint8_t> listenerGroups;
+    std::vector<double> listenerErrors;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    std::vector<Transmission> transmissions;
+    std::vector<size_t> recent[ChannelHop::MAX_CHANNELS + 1];   // Transmissions that may still be on air
+
+    int64_t uniformUs(int64_t a, int64_t b) {
+        return std::uniform_int_distribution<int64_t>(a, b)(engine);
+    }
+
+    int64_t backoffUs() {
+        return DIFS_US + (int64_t)std::uniform_int_distribution<uint32_t>(0, CW_SLOTS)(engine) * SLOT_US;
+    }
+
+    int64_t nextApArrival(int64_t t) {
+        double rate = setup.apLoadPct / 100.0 / AP_FRAME_US;
+        return t + (int64_t)std::exponential_distribution<double>(rate)(engine) + 1;
+    }
+
+    /**
+     * @brief Channel a boat transmits on: its loop() switches before sending (ChannelHopper)
+     */
+    uint8_t boatChannel(const Node& node, int64_t t) const {
+        if (node.accessPoint) {
+            return setup.apChannel;
+        }
+        if (!hopping) {
+            return 1;
+        }
+        return schedule.channelAt(GPS_EPOCH_US + t + (int64_t)node.clockErrorUs, node.group);
+    }
+
+    /**
+     * @brief Channel a receiver listens on: hop some time after its own GPS second
+     */
+    uint8_t listenerChannel(size_t listener, int64_t t) const {
+        if (!hopping) {
+            return 1;
+        }
+        int64_t local = GPS_EPOCH_US + t + (int64_t)listenerErrors[listener];
+        int64_t second = local / ChannelHop::DWELL_US;
+        uint64_t h = mix(seed ^ mix(listener * 0x100000001ULL + (uint64_t)second));
+        int64_t latency = (int64_t)(h % (uint64_t)LISTENER_LATENCY_US);
+        if (local - second * ChannelHop::DWELL_US < latency) {
+            local -= ChannelHop::DWELL_US;  // Not switched yet
+        }
+        return schedule.channelAt(local, listenerGroups[listener]);
+    }
+
+    bool heard(const Transmission& tx) const {
+        for (size_t l = 0; l < listenerGroups.size(); l++) {
+            if (listenerChannel(l, tx.start) == tx.channel && listenerChannel(l, tx.end) == tx.channel) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void arrive(uint32_t id, int64_t t, Totals& totals) {
+        Node& node = nodes[id];
+        if (node.accessPoint) {
+            events.push({nextApArrival(t), id, true});
+        }
+        if (node.queue.size() >= QUEUE_DEPTH) {
+            if (!node.accessPoint) {
+                totals.queueFull++;
+            }
+            return;
+        }
+        node.queue.push_back(t);
+        if (!node.attemptPending) {
+            node.attemptPending = true;
+            events.push({t + backoffUs(), id, false});
+        }
+    }
+
+    void attempt(uint32_t id, int64_t t, Totals& totals) {
+        Node& node = nodes[id];
+        if (node.queue.empty()) {
+            node.attemptPending = false;
+            return;
+        }
+        // No transmission within the guard of a hop (boat clock)
+        if (hopping && !node.accessPoint) {
+            int64_t local = GPS_EPOCH_US + t + (int64_t)node.clockErrorUs;
+            if (ChannelHop::inGuard(local)) {
+                int64_t hop = (local + ChannelHop::GUARD_US) / ChannelHop::DWELL_US * ChannelHop::DWELL_US;
+                events.push({t + hop + ChannelHop::GUARD_US - local, id, false});
+                return;
+            }
+        }
+
+        uint8_t channel = boatChannel(node, t);
+        std::vector<size_t>& onAir = recent[channel];
+        onAir.erase(std::remove_if(onAir.begin(), onAir.end(),
+                                   [&](size_t i) { return transmissions[i].end <= t; }),
+                    onAir.end());
+        int64_t busyUntil = 0;
+        for (size_t i : onAir) {
+            if (transmissions[i].start <= t - SLOT_US) {
+                busyUntil = std::max(busyUntil, transmissions[i].end);
+            }
+        }
+        if (busyUntil > 0) {
+            events.push({busyUntil + backoffUs(), id, false});
+            return;
+        }
+
+        int64_t air = node.accessPoint ? AP_FRAME_US : airtimeUs(sizeof(GPSBroadcastPacket));
+        Transmission tx = {t, t + air, id, channel, false};
+        for (size_t i : onAir) {
+            transmissions[i].collided = true;  // Started within the last slot: not sensed
+            tx.collided = true;
+        }
+        onAir.push_back(transmissions.size());
+        transmissions.push_back(tx);
+        if (!node.accessPoint) {
+            totals.waitsUs.push_back((double)(t - node.queue.front()));
+        }
+        node.queue.pop_front();
+        if (node.queue.empty()) {
+            node.attemptPending = false;
+        } else {
+            events.push({tx.end + backoffUs(), id, false});
+        }
+    }
+};
+
+static void runConfiguration(const Setup& setup, const Mode& mode, uint32_t runs, int64_t durationUs,
+                             double clockSigmaUs, uint64_t seed) {
+    Totals totals;
+    for (uint32_t i = 0; i < runs; i++) {
+        Draw draw(setup, mode, clockSigmaUs, mix(seed + i));
+        draw.run(durationUs, totals);
+    }
+    printf("  %-22s offered %6.0f/s  delivered %6.0f/s  lost %5.1f%% (collision %5.1f%%, off channel %4.2f%%, "
+           "queue full %5.1f%%)  TX wait p95 %5.1f ms\n",
+           mode.name, totals.offered / totals.seconds, totals.delivered / totals.seconds,
+           100.0 - totals.pct(totals.delivered), totals.pct(totals.collided), totals.pct(totals.offChannel),
+           totals.pct(totals.queueFull), totals.waitPercentile(0.95) / 1000.0);
+}
+
+static void printSetup(const Setup& setup) {
+    printf("%u boats at %.0f Hz, ", setup.boats, setup.rateHz);
+    if (setup.apChannel != 0 && setup.apLoadPct > 0) {
+        printf("access point on channel %u (%.0f%% airtime)\n", setup.apChannel, setup.apLoadPct);
+    } else {
+        printf("no access point\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t runs = 10;
+    double durationS = 60;
+    uint64_t seed = 1;
+    double clockSigmaUs = 400;
+    Setup custom = {20, 10, 1, 30};
+    Mode customMode = {"custom", 0x0842, 1};
+    bool single = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            printf(USAGE, argv[0]);
+            return 0;
+        }
+        if (value == nullptr) {
+            fprintf(stderr, USAGE, argv[0]);
+            return 2;
+        }
+        i++;
+        if (strcmp(arg, "--runs") == 0) {
+            runs = (uint32_t)atoi(value);
+        } else if (strcmp(arg, "--duration") == 0) {
+            durationS = atof(value);
+        } else if (strcmp(arg, "--seed") == 0) {
+            seed = strtoull(value, nullptr, 10);
+        } else if (strcmp(arg, "--clock-us") == 0) {
+            clockSigmaUs = atof(value);
+        } else if (strcmp(arg, "--boats") == 0) {
+            custom.boats = (uint32_t)atoi(value);
+            single = true;
+        } else if (strcmp(arg, "--rate-hz") == 0) {
+            custom.rateHz = atof(value);
+            single = true;
+        } else if (strcmp(arg, "--channels") == 0) {
+            customMode.channelMask = (uint16_t)strtoul(value, nullptr, 0);
+            single = true;
+        } else if (strcmp(arg, "--groups") == 0) {
+            customMode.groups = (uint8_t)atoi(value);
+            single = true;
+        } else if (strcmp(arg, "--ap-channel") == 0) {
+            custom.apChannel = (uint8_t)atoi(value);
+            single = true;
+        } else if (strcmp(arg, "--ap-load") == 0) {
+            custom.apLoadPct = atof(value);
+            single = true;
+        } else {
+            fprintf(stderr, USAGE, argv[0]);
+            return 2;
+        }
+    }
+    ChannelHop check;
+    if (runs == 0 || durationS <= 0 || custom.boats == 0 || custom.rateHz <= 0 || custom.rateHz > 50 ||
+        custom.apChannel > 13 || custom.apLoadPct < 0 || custom.apLoadPct > 90 ||
+        !check.configure(customMode.channelMask, customMode.groups)) {
+        fprintf(stderr, USAGE, argv[0]);
+        return 2;
+    }
+
+    int64_t durationUs = (int64_t)(durationS * 1e6);
+    printf("channel_hop_sim: %u draws of %.0f s per configuration, clocks ±%.0f us (1 sigma), "
+           "one receiver per group\n\n", runs, durationS, clockSigmaUs);
+    if (single) {
+        printSetup(custom);
+        runConfiguration(custom, customMode, runs, durationUs, clockSigmaUs, seed);
+        return 0;
+    }
+    for (uint32_t boats : FLEETS) {
+        Setup setup = {boats, 10, 1, 30};
+        printSetup(setup);
+        for (const Mode& mode : MODES) {
+            runConfiguration(setup, mode, runs, durationUs, clockSigmaUs, seed);
+        }
+        printf("\n");
+    }
+    return 0;
+}
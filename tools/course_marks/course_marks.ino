@@ -0,0 +1,115 @@
+/**
+ * Diffusion du parcours (marques) pour OpenSailingRC-BoatGPS
+ *
+ * Instructions :
+ * 1. Renseigner FLEET_KEY (identique à la clé "fleet_key" des bateaux) ;
+ *    les bateaux ignorent une trame mal signée
+ * 2. Renseigner les marques dans MARKS (ordre du parcours = markId)
+ *    - Bouée : une entrée avec un rayon (m) = cercle de passage
+ *    - Porte / zone d'arrivée : au moins 3 entrées avec rayon 0 et le
+ *      même markId = polygone (sommets dans l'ordre)
+ *    - COURSE_LAP_MARK sur la marque qui termine un tour (marque 0 sinon)
+ * 3. Changer COURSE_ID à chaque nouveau parcours (les bateaux ignorent
+ *    les répétitions d'un même parcours)
+ * 4. Flasher ce programme sur n'importe quel ESP32 (Atom, AtomS3...)
+ * 5. La trame est rediffusée toutes les 2 secondes ; les bateaux
+ *    l'enregistrent et la conservent après redémarrage
+ *
+ * Les structures ci-dessous sont alignées avec
+ * lib/BoatProtocol/src/BoatProtocol.h du firmware BoatGPS (CoursePacket,
+ * type 8).
+ */
+
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <mbedtls/md.h>
+
+struct CourseMark {
+  int32_t latitude;          // 1e-7 degré
+  int32_t longitude;         // 1e-7 degré
+  uint16_t radiusM;          // Rayon du cercle (m), 0 = sommet de polygone
+  uint8_t markId;            // Ordre du parcours (0-7)
+  uint8_t flags;             // 0x01 = marque de tour
+};
+
+struct CoursePacket {
+  int8_t messageType;        // 8
+  uint8_t count;
+  uint16_t courseId;
+  CourseMark marks[16];
+  uint8_t signature[16];     // HMAC-SHA256 tronqué, clé de flotte
+};
+
+const uint8_t COURSE_LAP_MARK = 0x01;
+
+// ============================================
+// CONFIGURATION : Modifier ici
+// ============================================
+const char* FLEET_KEY = "change-me";      // Max 32 caractères
+const uint16_t COURSE_ID = 1;             // À changer à chaque nouveau parcours
+const uint8_t CURRENT_CHANNEL = 1;        // Canal actuel des bateaux
+
+const CourseMark MARKS[] = {
+  // Bouée au vent, cercle de 20 m
+  {431234560, 51234560, 20, 0, 0},
+  // Porte sous le vent (zone de 4 sommets), termine le tour
+  {431200000, 51230000, 0, 1, COURSE_LAP_MARK},
+  {431200000, 51240000, 0, 1, COURSE_LAP_MARK},
+  {431196000, 51240000, 0, 1, COURSE_LAP_MARK},
+  {431196000, 51230000, 0, 1, COURSE_LAP_MARK},
+};
+// ============================================
+
+CoursePacket packet;
+uint8_t broadcastAddr[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+
+  Serial.println("\n===========================================");
+  Serial.println("Diffusion du parcours");
+  Serial.println("===========================================\n");
+
+  memset(&packet, 0, sizeof(packet));
+  packet.messageType = 8;
+  packet.courseId = COURSE_ID;
+  packet.count = sizeof(MARKS) / sizeof(MARKS[0]);
+  if (packet.count > 16) {
+    Serial.println("ERREUR : 16 entrées maximum");
+    packet.count = 16;
+  }
+  memcpy(packet.marks, MARKS, packet.count * sizeof(CourseMark));
+
+  // Sign: HMAC-SHA256 over all bytes before signature, truncated to 16 bytes
+  uint8_t digest[32];
+  mbedtls_md_hmac(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256),
+                  (const unsigned char*)FLEET_KEY, strlen(FLEET_KEY),
+                  (const unsigned char*)&packet, offsetof(CoursePacket, signature),
+                  digest);
+  memcpy(packet.signature, digest, sizeof(packet.signature));
+
+  // ESP-NOW (Long Range, same channel as the boats)
+  WiFi.mode(WIFI_STA);
+  WiFi.disconnect();
+  esp_wifi_set_protocol(WIFI_IF_STA, WIFI_PROTOCOL_11B | WIFI_PROTOCOL_11G | WIFI_PROTOCOL_11N | WIFI_PROTOCOL_LR);
+  esp_wifi_set_channel(CURRENT_CHANNEL, WIFI_SECOND_CHAN_NONE);
+  if (esp_now_init() != ESP_OK) {
+    Serial.println("ERREUR : ESP-NOW init");
+    return;
+  }
+
+  esp_now_peer_info_t peerInfo = {};
+  memcpy(peerInfo.peer_addr, broadcastAddr, 6);
+  peerInfo.channel = 0;
+  peerInfo.encrypt = false;
+  esp_now_add_peer(&peerInfo);
+
+  Serial.printf("Parcours #%u : %u entrées, %d octets\n", COURSE_ID, packet.count, sizeof(packet));
+}
+
+void loop() {
+  esp_now_send(broadcastAddr, (uint8_t*)&packet, sizeof(packet));
+  delay(2000);
+}
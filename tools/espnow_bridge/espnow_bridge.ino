@@ -0,0 +1,141 @@
+/**
+ * Pont série -> ESP-NOW pour OpenSailingRC-BoatGPS
+ *
+ * Instructions :
+ * 1. Flasher ce programme sur n'importe quel ESP32 (Atom, AtomS3...)
+ * 2. Brancher la carte en USB et lancer tools/log_replay avec
+ *    --bridge /dev/ttyUSB0 --baud 921600 (voir LOG_REPLAY.md)
+ * 3. Chaque trame reçue sur le port série est diffusée telle quelle en
+ *    ESP-NOW (adresse de broadcast), sur le canal qu'elle indique
+ *
+ * Trame série (hôte -> pont) :
+ *   0xA5 0x5A <canal> <longueur> <données> <XOR de canal, longueur, données>
+ *
+ * Les trames diffusées portent la MAC de ce pont : un récepteur distingue
+ * les bateaux par le nom contenu dans la trame. Une ligne de statistiques
+ * repart vers l'hôte toutes les 5 secondes (affichée par log_replay).
+ */
+
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+
+// ============================================
+// CONFIGURATION : Modifier ici
+// ============================================
+const unsigned long BRIDGE_BAUD = 921600;  // Identique à --baud de log_replay
+const uint8_t DEFAULT_CHANNEL = 1;         // Canal avant la première trame
+// ============================================
+
+const uint8_t SYNC1 = 0xA5;
+const uint8_t SYNC2 = 0x5A;
+
+enum State { WAIT_SYNC1, WAIT_SYNC2, READ_CHANNEL, READ_LENGTH, READ_DATA, READ_CHECKSUM };
+
+uint8_t broadcastAddr[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+State state = WAIT_SYNC1;
+uint8_t frameChannel = 0;
+uint8_t frameLength = 0;
+uint8_t frameData[250];
+uint8_t received = 0;
+uint8_t checksum = 0;
+uint8_t currentChannel = DEFAULT_CHANNEL;
+
+uint32_t sent = 0;
+uint32_t sendErrors = 0;
+uint32_t badFrames = 0;
+unsigned long lastReport = 0;
+
+void sendFrame() {
+  if (frameChannel >= 1 && frameChannel <= 13 && frameChannel != currentChannel) {
+    esp_wifi_set_channel(frameChannel, WIFI_SECOND_CHAN_NONE);
+    currentChannel = frameChannel;
+  }
+  // File d'émission pleine : on attend qu'elle se vide plutôt que perdre la trame
+  esp_err_t result;
+  while ((result = esp_now_send(broadcastAddr, frameData, frameLength)) == ESP_ERR_ESPNOW_NO_MEM) {
+    delay(1);
+  }
+  if (result == ESP_OK) {
+    sent++;
+  } else {
+    sendErrors++;
+  }
+}
+
+void receiveByte(uint8_t byte) {
+  switch (state) {
+    case WAIT_SYNC1:
+      if (byte == SYNC1) {
+        state = WAIT_SYNC2;
+      }
+      break;
+    case WAIT_SYNC2:
+      state = (byte == SYNC2) ? READ_CHANNEL : (byte == SYNC1 ? WAIT_SYNC2 : WAIT_SYNC1);
+      break;
+    case READ_CHANNEL:
+      frameChannel = byte;
+      checksum = byte;
+      state = READ_LENGTH;
+      break;
+    case READ_LENGTH:
+      if (byte == 0 || byte > sizeof(frameData)) {
+        badFrames++;
+        state = WAIT_SYNC1;
+        break;
+      }
+      frameLength = byte;
+      checksum ^= byte;
+      received = 0;
+      state = READ_DATA;
+      break;
+    case READ_DATA:
+      frameData[received++] = byte;
+      checksum ^= byte;
+      if (received == frameLength) {
+        state = READ_CHECKSUM;
+      }
+      break;
+    case READ_CHECKSUM:
+      if (byte == checksum) {
+        sendFrame();
+      } else {
+        badFrames++;
+      }
+      state = WAIT_SYNC1;
+      break;
+  }
+}
+
+void setup() {
+  Serial.setRxBufferSize(8192);
+  Serial.begin(BRIDGE_BAUD);
+
+  WiFi.mode(WIFI_STA);
+  WiFi.disconnect();
+  esp_wifi_set_protocol(WIFI_IF_STA, WIFI_PROTOCOL_11B | WIFI_PROTOCOL_11G | WIFI_PROTOCOL_11N | WIFI_PROTOCOL_LR);
+  esp_wifi_set_channel(DEFAULT_CHANNEL, WIFI_SECOND_CHAN_NONE);
+  if (esp_now_init() != ESP_OK) {
+    Serial.println("bridge: ERREUR ESP-NOW init");
+    return;
+  }
+
+  esp_now_peer_info_t peerInfo = {};
+  memcpy(peerInfo.peer_addr, broadcastAddr, 6);
+  peerInfo.channel = 0;  // Canal courant : suit esp_wifi_set_channel()
+  peerInfo.encrypt = false;
+  esp_now_add_peer(&peerInfo);
+
+  Serial.printf("bridge: pret, %lu bauds, MAC %s\n", BRIDGE_BAUD, WiFi.macAddress().c_str());
+}
+
+void loop() {
+  while (Serial.available()) {
+    receiveByte(Serial.read());
+  }
+  if (millis() - lastReport >= 5000) {
+    lastReport = millis();
+    Serial.printf("bridge: %lu envoyees, %lu erreurs, %lu trames invalides, canal %u\n",
+                  sent, sendErrors, badFrames, currentChannel);
+  }
+}
@@ -0,0 +1,49 @@
+/**
+ * Vérifications des modules du firmware sur PC : outils communs
+ *
+ * Chaque fichier <module>_checks.cpp déclare ici sa suite et l'ajoute à
+ * SUITES dans firmware_checks.cpp.
+ */
+
+#ifndef FIRMWARE_CHECKS_H
+#define FIRMWARE_CHECKS_H
+
+#include <stdint.h>
+
+/**
+ * @brief Count one check, print the failure
+ */
+void expect(bool condition, const char* what);
+
+/**
+ * @brief Count one check: |value - target| <= tolerance, print both values on failure
+ */
+void expectNear(double value, double target, double tolerance, const char* what);
+
+/**
+ * @brief Monotonic host clock (s)
+ */
+double nowS();
+
+/**
+ * @brief Iterations of the timing loops (--iterations, 0 = no timing)
+ */
+uint32_t benchIterations();
+
+/**
+ * @brief NMEA log replayed by the track_simplifier suite (--track)
+ */
+const char* trackPath();
+
+static const char* const DEFAULT_TRACK_PATH = "tools/firmware_checks/data/track_5hz.nmea";
+
+void checkCourseSmoother();
+void checkFixFilter();
+void checkGeodesy();
+void checkProximity();
+void checkStartLine();
+void checkTrackSimplifier();
+void checkTxScheduler();
+void checkWindPerformance();
+
+#endif // FIRMWARE_CHECKS_H
@@ -0,0 +1,183 @@
+/**
+ * Vérifications de CourseSmoother (src/CourseSmoother.cpp) : passage du
+ * nord, bateau arrêté et constante de temps
+ *
+ * Les échantillons sont donnés à addSample() (vitesse en mm/s, cap en
+ * 0,1°) ; seul le benchmark passe par update() et GPSData.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include "checks.h"
+#include "CourseSmoother.h"
+
+static const int32_t SPEED_MMPS = 2500;             // About 5 knots
+static const double TAU_S = 2.0;                    // CourseSmoother::TAU_MS
+
+/**
+ * @brief Signed difference a - b of two courses (0.1 deg, -1800..1799)
+ */
+static int32_t courseDiff(int32_t a, int32_t b) {
+    return ((a - b) % 3600 + 5400) % 3600 - 1800;
+}
+
+static void checkAlternation() {
+    // 359 / 1 degree alternation: north, never south, full confidence
+    CourseSmoother smoother;
+    uint32_t t = 1000;
+    bool north = true;
+    for (uint32_t i = 0; i < 100; i++, t += 200) {
+        smoother.addSample(SPEED_MMPS, (i & 1) ? 10 : 3590, t);
+        north = north && abs(courseDiff(smoother.getCourseDeci(), 0)) <= 10;
+    }
+    expect(north, "359 / 1 alternation: every output within 1 degree of north");
+    expect(abs(courseDiff(smoother.getCourseDeci(), 0)) <= 1, "359 / 1 alternation smoothed to 0");
+    expect(smoother.getConfidencePermille() > 990 && smoother.isCourseValid(),
+           "359 / 1 alternation: confidence > 99%");
+}
+
+static void checkStep() {
+    // Step 355 -> 5 degrees: the short way through north, settles on 5
+    CourseSmoother smoother;
+    uint32_t t = 1000;
+    for (uint32_t i = 0; i < 50; i++, t += 200) {
+        smoother.addSample(SPEED_MMPS, 3550, t);
+    }
+    bool shortArc = true;
+    int32_t previous = smoother.getCourseDeci();
+    bool monotonic = true;
+    for (uint32_t i = 0; i < 100; i++, t += 200) {
+        smoother.addSample(SPEED_MMPS, 50, t);
+        int32_t course = smoother.getCourseDeci();
+        shortArc = shortArc && courseDiff(course, 3550) >= 0 && courseDiff(course, 50) <= 0;
+        monotonic = monotonic && courseDiff(course, previous) >= 0;
+        previous = course;
+    }
+    expect(shortArc, "355 -> 5 step: stays between 355 and 5 through north");
+    expect(monotonic, "355 -> 5 step: turns one way only");
+    expect(abs(courseDiff(smoother.getCourseDeci(), 50)) <= 1, "355 -> 5 step: settles on 5");
+}
+
+static void checkSlowTurns() {
+    // 1 degree/s through north at 10 Hz, both ways: 0.1 degree per fix, lag of rate x tau
+    for (int32_t direction = 1; direction >= -1; direction -= 2) {
+        CourseSmoother smoother;
+        int32_t start = direction > 0 ? 3400 : 200;
+        uint32_t t = 1000;
+        for (uint32_t i = 0; i < 100; i++, t += 100) {
+            smoother.addSample(SPEED_MMPS, start, t);
+        }
+        int32_t previous = smoother.getCourseDeci();
+        int32_t maxStep = 0;
+        int32_t maxLagError = 0;
+        for (uint32_t i = 1; i <= 400; i++, t += 100) {
+            int32_t raw = (start + direction * (int32_t)i + 3600) % 3600;
+            smoother.addSample(SPEED_MMPS, raw, t);
+            int32_t course = smoother.getCourseDeci();
+            maxStep = std::max(maxStep, abs(courseDiff(course, previous)));
+            if (i > 100) {   // Steady turn after 5 time constants
+                maxLagError = std::max(maxLagError, abs(courseDiff(course, raw - direction * 20)));
+            }
+            previous = course;
+        }
+        printf("CourseSmoother: slow turn %s through north | max step %.1f deg/fix, lag error %.1f deg\n",
+               direction > 0 ? "340 -> 20" : "20 -> 340", maxStep / 10.0, maxLagError / 10.0);
+        expect(maxStep <= 2, direction > 0 ? "slow turn 340 -> 20: no step > 0.2 degree per fix"
+                                           : "slow turn 20 -> 340: no step > 0.2 degree per fix");
+        expect(maxLagError <= 3, direction > 0 ? "slow turn 340 -> 20: lags by rate x tau"
+                                               : "slow turn 20 -> 340: lags by rate x tau");
+    }
+}
+
+static void checkStopped() {
+    std::mt19937_64 engine(42);
+    std::uniform_int_distribution<int32_t> course(0, 3599);
+
+    // Boat stopped, random course: never valid
+    CourseSmoother stopped;
+    bool invalid = true;
+    uint32_t t = 1000;
+    for (uint32_t i = 0; i < 200; i++, t += 200) {
+        stopped.addSample(100, course(engine), t);
+        invalid = invalid && !stopped.isCourseValid();
+    }
+    expect(invalid, "stopped, random course: course never valid");
+
+    // Steady course, then the boat stops: invalid within 3 time constants
+    CourseSmoother stopping;
+    for (uint32_t i = 0; i < 50; i++, t += 200) {
+        stopping.addSample(SPEED_MMPS, 900, t);
+    }
+    expect(stopping.isCourseValid(), "steady course valid");
+    for (uint32_t i = 0; i < 30; i++, t += 200) {
+        stopping.addSample(0, course(engine), t);
+    }
+    expect(!stopping.isCourseValid(), "stopped for 6 s: course invalid");
+    expect(stopping.getCourseDeci() == 900, "stopped fixes do not move the course");
+}
+
+static void checkTimeConstant() {
+    // Speed step 1 -> 3 m/s: time to 63 % of the step at 1, 5 and 10 Hz
+    static const uint32_t PERIODS_MS[] = {1000, 200, 100};
+    printf("CourseSmoother: 63%% of a speed step after");
+    for (uint32_t periodMs : PERIODS_MS) {
+        CourseSmoother smoother;
+        uint32_t t = 1000;
+        for (uint32_t i = 0; i < 20; i++, t += periodMs) {
+            smoother.addSample(1000, 900, t);
+        }
+        uint32_t stepAt = t - periodMs;
+        double target = (1000 + 2000 * (1 - exp(-1.0))) / 10.0;   // cm/s
+        while (smoother.getSpeedCms() < target && t - stepAt < 10000) {
+            smoother.addSample(3000, 900, t);
+            t += periodMs;
+        }
+        double reachedS = (t - periodMs - stepAt) * 0.001;
+        printf(" %.1f s at %lu Hz%s", reachedS, (unsigned long)(1000 / periodMs), periodMs == 100 ? "\n" : ",");
+
+        char what[64];
+        snprintf(what, sizeof(what), "time constant at %lu Hz", (unsigned long)(1000 / periodMs));
+        expect(reachedS >= TAU_S && reachedS <= TAU_S + periodMs * 0.001, what);
+        snprintf(what, sizeof(what), "course steady through a speed step, %lu Hz", (unsigned long)(1000 / periodMs));
+        expect(smoother.getCourseDeci() == 900, what);
+    }
+}
+
+static void benchmark() {
+    uint32_t n = benchIterations();
+    if (n == 0) {
+        return;
+    }
+    static const uint32_t SAMPLES = 1024;
+    static GPSData fixes[SAMPLES];
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        memset(&fixes[i], 0, sizeof(GPSData));
+        fixes[i].speed = 3 + (i % 40) / 10.0f;
+        fixes[i].course = (float)((i * 7) % 3600) / 10.0f;
+        fixes[i].valid = true;
+    }
+    CourseSmoother smoother;
+    uint64_t checksum = 0;
+    double start = nowS();
+    for (uint32_t i = 0; i < n; i++) {
+        fixes[i % SAMPLES].fixMillis = 1000 + i * 100;
+        smoother.update(fixes[i % SAMPLES]);
+        checksum += smoother.getCourseDeci();
+    }
+    double elapsed = nowS() - start;
+    printf("CourseSmoother::update(): %.1f ns/fix on this host (check %llu)\n", elapsed * 1e9 / n,
+           (unsigned long long)(checksum & 0xFFFF));
+}
+
+void checkCourseSmoother() {
+    checkAlternation();
+    checkStep();
+    checkSlowTurns();
+    checkStopped();
+    checkTimeConstant();
+    benchmark();
+}
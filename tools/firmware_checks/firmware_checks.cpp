@@ -0,0 +1,119 @@
+/**
+ * Vérification des modules du firmware sur PC (outil PC)
+ *
+ * Instructions :
+ * 1. Compiler : pio run -e native-firmware-checks
+ *    (programme : .pio/build/native-firmware-checks/program)
+ * 2. Lancer depuis la racine du dépôt :
+ *    program [--suite NOM] [--iterations N] [--track LOG.nmea]
+ * 3. Chaque suite appelle le code du firmware (src/) sur des cas
+ *    construits à la main, puis mesure son coût sur le PC (boucle de
+ *    --iterations appels, 0 = pas de mesure) ; code de sortie 1 si une
+ *    vérification échoue
+ *
+ * Arduino-ESP32 est remplacé par les bibliothèques du simulateur
+ * (sim/include, voir SIMULATOR.md). Le compteur de cycles du simulateur
+ * ne compte pas le temps de calcul : les coûts sont mesurés ici en
+ * nanosecondes sur le PC, à comparer entre versions du code et non au
+ * rapport d'état de l'ESP32.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "checks.h"
+
+static const char* USAGE =
+    "Usage: %s [options]\n"
+    "  --suite NAME         Run one suite only (default all)\n"
+    "  --iterations N       Calls per timing loop (default 200000, 0 = no timing)\n"
+    "  --track FILE         NMEA log replayed by track_simplifier (default %s)\n";
+
+struct Suite {
+    const char* name;
+    void (*run)();
+};
+
+static const Suite SUITES[] = {
+    {"course_smoother", checkCourseSmoother},
+    {"fix_filter", checkFixFilter},
+    {"geodesy", checkGeodesy},
+    {"proximity", checkProximity},
+    {"start_line", checkStartLine},
+    {"track_simplifier", checkTrackSimplifier},
+    {"tx_scheduler", checkTxScheduler},
+    {"wind_performance", checkWindPerformance},
+};
+
+static unsigned failures = 0;
+static unsigned checks = 0;
+static uint32_t iterations = 200000;
+static const char* track = DEFAULT_TRACK_PATH;
+
+void expect(bool condition, const char* what) {
+    checks++;
+    if (!condition) {
+        failures++;
+        fprintf(stderr, "FAILED: %s\n", what);
+    }
+}
+
+void expectNear(double value, double target, double tolerance, const char* what) {
+    checks++;
+    if (!(value >= target - tolerance && value <= target + tolerance)) {
+        failures++;
+        fprintf(stderr, "FAILED: %s (%.6g, expected %.6g +/- %.3g)\n", what, value, target, tolerance);
+    }
+}
+
+double nowS() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+uint32_t benchIterations() {
+    return iterations;
+}
+
+const char* trackPath() {
+    return track;
+}
+
+int main(int argc, char** argv) {
+    const char* only = nullptr;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "--suite") == 0 && hasValue) {
+            only = argv[++i];
+        } else if (strcmp(arg, "--iterations") == 0 && hasValue) {
+            iterations = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(arg, "--track") == 0 && hasValue) {
+            track = argv[++i];
+        } else {
+            fprintf(stderr, USAGE, argv[0], DEFAULT_TRACK_PATH);
+            return strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    bool found = false;
+    for (const Suite& suite : SUITES) {
+        if (only != nullptr && strcmp(only, suite.name) != 0) {
+            continue;
+        }
+        found = true;
+        unsigned failuresBefore = failures;
+        unsigned checksBefore = checks;
+        suite.run();
+        printf("%s: %u checks, %u failed\n", suite.name, checks - checksBefore, failures - failuresBefore);
+    }
+    if (!found) {
+        fprintf(stderr, "Unknown suite: %s\n", only);
+        return 1;
+    }
+
+    printf("checks: %u passed, %u failed\n", checks - failures, failures);
+    return failures > 0 ? 1 : 0;
+}
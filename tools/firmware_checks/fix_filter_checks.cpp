@@ -0,0 +1,204 @@
+/**
+ * Vérifications de FixFilter (src/FixFilter.cpp) : sauts de multitrajet
+ * sur une trace de 30 min
+ *
+ * Trace au près à 5 nœuds, virement toutes les 20 s (cap 45° / 315°,
+ * vitesse réduite de moitié pendant le virement), bruit de position
+ * corrélé (Gauss-Markov, 1 m, constante de temps 60 s), vitesse et cap
+ * Doppler bruités (0,05 m/s, 2°). 0,5 % des fixes sont déplacés de 20 à
+ * 50 m dans une direction au hasard. Chaque saut doit être marqué, aucun
+ * autre fix ne doit l'être, à 1, 5 et 10 Hz.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "checks.h"
+#include "FixFilter.h"
+
+static const double ORIGIN_LAT = 43.25;
+static const double ORIGIN_LON = 5.30;
+static const double KNOT_MPS = 1852.0 / 3600.0;
+static const double DURATION_S = 1800.0;
+static const double TACK_PERIOD_S = 20.0;
+static const double TACK_S = 4.0;                   // Heading change and speed dip
+static const double SPEED_MPS = 5 * KNOT_MPS;
+static const double NOISE_M = 1.0;
+static const double NOISE_TAU_S = 60.0;
+static const double JUMP_RATE = 0.005;
+static const double JUMP_MIN_M = 20.0;
+static const double JUMP_MAX_M = 50.0;
+
+struct TraceFix {
+    double latitude;
+    double longitude;
+    float speedKn;
+    float courseDeg;
+    uint32_t fixMillis;
+    bool jump;
+};
+
+/**
+ * @brief Position east / north of the origin (m), WGS84 radii of curvature
+ */
+static void offsetToLatLon(double eastM, double northM, double& latitude, double& longitude) {
+    const double a = 6378137.0;
+    const double e2 = 6.69437999014e-3;
+    double phi = ORIGIN_LAT * M_PI / 180.0;
+    double w = 1.0 - e2 * sin(phi) * sin(phi);
+    double meridian = a * (1.0 - e2) / pow(w, 1.5);
+    double normal = a / sqrt(w);
+    latitude = ORIGIN_LAT + northM / meridian * 180.0 / M_PI;
+    longitude = ORIGIN_LON + eastM / (normal * cos(phi)) * 180.0 / M_PI;
+}
+
+/**
+ * @brief True heading (degrees) and speed (m/s) at t: 45 / 315 alternating, smooth turn and speed dip
+ */
+static void profile(double t, double& heading, double& speed) {
+    double phase = fmod(t, TACK_PERIOD_S);
+    bool port = (uint32_t)(t / TACK_PERIOD_S) % 2 == 1;
+    double from = port ? 315.0 : 45.0;
+    double turn = port ? 90.0 : -90.0;
+    if (phase < TACK_S) {
+        double progress = (1 - cos(M_PI * phase / TACK_S)) / 2;
+        heading = fmod(from + turn * progress + 360.0, 360.0);
+        speed = SPEED_MPS * (1 - 0.5 * sin(M_PI * phase / TACK_S));
+    } else {
+        heading = fmod(from + turn + 360.0, 360.0);
+        speed = SPEED_MPS;
+    }
+}
+
+static std::vector<TraceFix> makeTrace(uint32_t periodMs, uint64_t seed) {
+    std::mt19937_64 engine(seed);
+    std::normal_distribution<double> gauss(0, 1);
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    std::vector<TraceFix> trace;
+    double dt = periodMs * 0.001;
+    double a = exp(-dt / NOISE_TAU_S);
+    double b = NOISE_M * sqrt(1 - a * a);
+    double x = 0, y = 0;
+    double noiseX = NOISE_M * gauss(engine);
+    double noiseY = NOISE_M * gauss(engine);
+    for (uint32_t t = 0; t <= (uint32_t)(DURATION_S * 1000); t += periodMs) {
+        double heading, speed;
+        profile(t * 0.001, heading, speed);
+        noiseX = a * noiseX + b * gauss(engine);
+        noiseY = a * noiseY + b * gauss(engine);
+
+        TraceFix fix;
+        fix.jump = t > 0 && uniform(engine) < JUMP_RATE;
+        double jumpX = 0, jumpY = 0;
+        if (fix.jump) {
+            double distance = JUMP_MIN_M + (JUMP_MAX_M - JUMP_MIN_M) * uniform(engine);
+            double bearing = 2 * M_PI * uniform(engine);
+            jumpX = distance * sin(bearing);
+            jumpY = distance * cos(bearing);
+        }
+        offsetToLatLon(x + noiseX + jumpX, y + noiseY + jumpY, fix.latitude, fix.longitude);
+        fix.speedKn = (float)(fmax(speed + 0.05 * gauss(engine), 0.0) / KNOT_MPS);
+        fix.courseDeg = (float)fmod(heading + 2.0 * gauss(engine) + 360.0, 360.0);
+        fix.fixMillis = 1000 + t;
+        trace.push_back(fix);
+
+        // Integrate the true track to the next fix in 10 ms steps
+        for (uint32_t s = 0; s < periodMs; s += 10) {
+            profile((t + s) * 0.001, heading, speed);
+            x += speed * sin(heading * M_PI / 180.0) * 0.01;
+            y += speed * cos(heading * M_PI / 180.0) * 0.01;
+        }
+    }
+    return trace;
+}
+
+static void checkTrace() {
+    printf("FixFilter: rate | fixes | jumps flagged | false rejects "
+           "(30 min, tacks every 20 s, 1 m correlated noise)\n");
+    static const uint32_t PERIODS_MS[] = {1000, 200, 100};
+    for (uint32_t periodMs : PERIODS_MS) {
+        std::vector<TraceFix> trace = makeTrace(periodMs, 42 + periodMs);
+        FixFilter filter;
+        uint32_t jumps = 0;
+        uint32_t flagged = 0;
+        uint32_t falseRejects = 0;
+        for (const TraceFix& fix : trace) {
+            uint8_t quality = filter.check(fix.latitude, fix.longitude, fix.speedKn, fix.courseDeg, fix.fixMillis);
+            jumps += fix.jump;
+            flagged += fix.jump && quality != FIX_GOOD;
+            falseRejects += !fix.jump && quality != FIX_GOOD;
+        }
+        printf("FixFilter: %2lu Hz | %5zu | %3lu / %3lu | %lu\n", (unsigned long)(1000 / periodMs), trace.size(),
+               (unsigned long)flagged, (unsigned long)jumps, (unsigned long)falseRejects);
+
+        char what[64];
+        snprintf(what, sizeof(what), "%lu Hz: every jump flagged", (unsigned long)(1000 / periodMs));
+        expect(jumps > 0 && flagged == jumps, what);
+        snprintf(what, sizeof(what), "%lu Hz: no false reject", (unsigned long)(1000 / periodMs));
+        expect(falseRejects == 0, what);
+        expect(filter.getChecked() == trace.size() && filter.getRejected() == flagged + falseRejects,
+               "checked / rejected counters");
+    }
+}
+
+static void checkFlags() {
+    // Straight run north at 5 knots, 5 Hz, no noise
+    FixFilter filter;
+    double northM = 0;
+    uint32_t t = 1000;
+    for (uint32_t i = 0; i < 20; i++, t += 200, northM += SPEED_MPS * 0.2) {
+        double lat, lon;
+        offsetToLatLon(0, northM, lat, lon);
+        filter.check(lat, lon, 5, 0, t);
+    }
+    double lat, lon;
+    offsetToLatLon(0, northM, lat, lon);
+    expect(filter.check(lat, lon, 35, 0, t) & FIX_OUTLIER_SPEED, "35 knots Doppler: speed flag");
+    expect(filter.check(lat, lon, 2000, 0, t + 4800) & FIX_OUTLIER_SPEED, "2000 knots Doppler, 5 s: speed flag");
+
+    offsetToLatLon(0, northM + 2 * SPEED_MPS * 0.2, lat, lon);
+    expect(filter.check(lat, lon, 13, 0, t + 400) & FIX_OUTLIER_ACCEL, "+4 m/s in 0.2 s: acceleration flag");
+    offsetToLatLon(30, northM + 2 * SPEED_MPS * 0.2, lat, lon);
+    expect(filter.check(lat, lon, 5, 0, t + 400) & FIX_OUTLIER_POSITION, "30 m sideways: position flag");
+
+    // Rejected run: restart 5 s after the last accepted fix (t - 200)
+    bool rejectedRun = true;
+    offsetToLatLon(200, northM, lat, lon);
+    for (uint32_t dt = 600; dt <= 4800; dt += 200) {
+        rejectedRun = rejectedRun && filter.check(lat, lon, 0, 0, t + dt) != FIX_GOOD;
+    }
+    expect(rejectedRun, "200 m away: rejected up to 5 s after the last accepted fix");
+    expect(filter.check(lat, lon, 0, 0, t + 5000) == FIX_GOOD, "restart after 5 s of rejects");
+}
+
+static void benchmark() {
+    uint32_t n = benchIterations();
+    if (n == 0) {
+        return;
+    }
+    std::vector<TraceFix> trace = makeTrace(200, 7);
+    FixFilter filter;
+    uint64_t checksum = 0;
+    uint32_t rounds = std::max<uint32_t>(n / trace.size(), 1);
+    double start = nowS();
+    for (uint32_t r = 0; r < rounds; r++) {
+        for (const TraceFix& fix : trace) {
+            // Successive rounds 10 s apart: the filter restarts once per round
+            uint32_t fixMillis = fix.fixMillis + r * (uint32_t)(DURATION_S * 1000 + 10000);
+            checksum += filter.check(fix.latitude, fix.longitude, fix.speedKn, fix.courseDeg, fixMillis);
+        }
+    }
+    double elapsed = nowS() - start;
+    printf("FixFilter::check(): %.1f ns/fix on this host (check %llu)\n",
+           elapsed * 1e9 / ((double)rounds * trace.size()), (unsigned long long)checksum);
+}
+
+void checkFixFilter() {
+    checkTrace();
+    checkFlags();
+    benchmark();
+}
@@ -0,0 +1,258 @@
+/**
+ * Vérifications de Geodesy (src/Geodesy.cpp) : repère local en virgule
+ * fixe contre la géodésique WGS84 et haversine, en double précision
+ *
+ * Pour chaque rayon du tableau de Geodesy.h (500 m à 10 km) et chaque
+ * latitude d'origine de -70° à 70°, des paires de points tirées dans le
+ * disque sont projetées par LocalFrame. La distance (Geodesy::distanceMm)
+ * et le cap (Geodesy::bearingDeci) entre les points projetés sont
+ * comparés à la géodésique de Vincenty (référence) ; haversine en double,
+ * sur la même paire, donne l'erreur de la sphère. Les positions sont
+ * arrondies à 1e-7 degré avant les deux calculs, comme celles du GPS.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include "checks.h"
+#include "Geodesy.h"
+
+static const double WGS_A = 6378137.0;
+static const double WGS_F = 1 / 298.257223563;
+static const double RAD = M_PI / 180.0;
+
+/**
+ * @brief Radius around the origin and documented maximum errors (Geodesy.h)
+ */
+struct RadiusCase {
+    double radiusM;
+    double maxErrorMm;
+    double maxBearingDeg;
+};
+
+static const RadiusCase RADII[] = {
+    {500, 5, 0.1},
+    {2000, 10, 0.15},
+    {5000, 25, 0.2},
+    {10000, 110, 0.3},
+};
+
+static const double MIN_BEARING_LEG_M = 100;         // Shorter legs: bearing limited by the 1 mm grid
+static const int PAIRS_PER_CASE = 2000;
+
+static uint32_t rngState = 12345;
+
+static double uniform() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return (rngState >> 8) / 16777216.0;
+}
+
+/**
+ * @brief Vincenty inverse on the WGS84 ellipsoid
+ * @param azimuthDeg Output initial azimuth at point 1 (degrees, clockwise from north)
+ * @return Geodesic distance (m)
+ */
+static double vincentyM(double lat1, double lon1, double lat2, double lon2, double& azimuthDeg) {
+    double b = WGS_A * (1 - WGS_F);
+    double u1 = atan((1 - WGS_F) * tan(lat1 * RAD));
+    double u2 = atan((1 - WGS_F) * tan(lat2 * RAD));
+    double l = (lon2 - lon1) * RAD;
+    double sinU1 = sin(u1), cosU1 = cos(u1), sinU2 = sin(u2), cosU2 = cos(u2);
+
+    double lambda = l;
+    double sinSigma = 0, cosSigma = 1, sigma = 0, cos2Alpha = 1, cos2SigmaM = 0;
+    for (int i = 0; i < 200; i++) {
+        double sinLambda = sin(lambda), cosLambda = cos(lambda);
+        sinSigma = sqrt(pow(cosU2 * sinLambda, 2) + pow(cosU1 * sinU2 - sinU1 * cosU2 * cosLambda, 2));
+        if (sinSigma == 0) {
+            azimuthDeg = 0;
+            return 0;
+        }
+        cosSigma = sinU1 * sinU2 + cosU1 * cosU2 * cosLambda;
+        sigma = atan2(sinSigma, cosSigma);
+        double sinAlpha = cosU1 * cosU2 * sinLambda / sinSigma;
+        cos2Alpha = 1 - sinAlpha * sinAlpha;
+        cos2SigmaM = cos2Alpha != 0 ? cosSigma - 2 * sinU1 * sinU2 / cos2Alpha : 0;
+        double c = WGS_F / 16 * cos2Alpha * (4 + WGS_F * (4 - 3 * cos2Alpha));
+        double previous = lambda;
+        lambda = l + (1 - c) * WGS_F * sinAlpha *
+                 (sigma + c * sinSigma * (cos2SigmaM + c * cosSigma * (-1 + 2 * cos2SigmaM * cos2SigmaM)));
+        if (fabs(lambda - previous) < 1e-13) {
+            break;
+        }
+    }
+    double uSq = cos2Alpha * (WGS_A * WGS_A - b * b) / (b * b);
+    double bigA = 1 + uSq / 16384 * (4096 + uSq * (-768 + uSq * (320 - 175 * uSq)));
+    double bigB = uSq / 1024 * (256 + uSq * (-128 + uSq * (74 - 47 * uSq)));
+    double deltaSigma = bigB * sinSigma * (cos2SigmaM + bigB / 4 * (cosSigma * (-1 + 2 * cos2SigmaM * cos2SigmaM) -
+                        bigB / 6 * cos2SigmaM * (-3 + 4 * sinSigma * sinSigma) * (-3 + 4 * cos2SigmaM * cos2SigmaM)));
+    azimuthDeg = atan2(cosU2 * sin(lambda), cosU1 * sinU2 - sinU1 * cosU2 * cos(lambda)) / RAD;
+    if (azimuthDeg < 0) {
+        azimuthDeg += 360;
+    }
+    return b * bigA * (sigma - deltaSigma);
+}
+
+/**
+ * @brief Random point in the disk of the given radius around the origin (1e-7 deg)
+ */
+static void pointInDisk(double originLat, double originLon, double radiusM, int32_t& latE7, int32_t& lonE7) {
+    double r = radiusM * sqrt(uniform());
+    double theta = 2 * M_PI * uniform();
+    double mPerDegLat = 111132.92 - 559.82 * cos(2 * originLat * RAD);
+    double mPerDegLon = 111412.84 * cos(originLat * RAD);
+    latE7 = Geodesy::toE7(originLat + r * cos(theta) / mPerDegLat);
+    lonE7 = Geodesy::toE7(originLon + r * sin(theta) / mPerDegLon);
+}
+
+static double angleError(double a, double b) {
+    double delta = fmod(a - b + 540.0, 360.0) - 180.0;
+    return fabs(delta);
+}
+
+static void checkAccuracy() {
+    printf("Geodesy: radius | max distance error fixed / haversine | max bearing error (legs >= %.0f m)\n",
+           MIN_BEARING_LEG_M);
+    for (const RadiusCase& radius : RADII) {
+        double maxFixedMm = 0;
+        double maxHaversineMm = 0;
+        double maxBearingDeg = 0;
+        for (int latitude = -70; latitude <= 70; latitude += 10) {
+            double originLat = latitude + 0.123;
+            double originLon = 5.3;
+            LocalFrame frame;
+            frame.setOrigin(Geodesy::toE7(originLat), Geodesy::toE7(originLon));
+
+            for (int i = 0; i < PAIRS_PER_CASE; i++) {
+                int32_t lat1, lon1, lat2, lon2;
+                pointInDisk(originLat, originLon, radius.radiusM, lat1, lon1);
+                pointInDisk(originLat, originLon, radius.radiusM, lat2, lon2);
+                LocalPoint a = frame.project(lat1, lon1);
+                LocalPoint b = frame.project(lat2, lon2);
+
+                double azimuth;
+                double reference = vincentyM(lat1 * 1e-7, lon1 * 1e-7, lat2 * 1e-7, lon2 * 1e-7, azimuth);
+                double fixedMm = Geodesy::distanceMm(a, b);
+                double haversineM = Geodesy::haversineM(lat1 * 1e-7, lon1 * 1e-7, lat2 * 1e-7, lon2 * 1e-7);
+                maxFixedMm = fmax(maxFixedMm, fabs(fixedMm - reference * 1000));
+                maxHaversineMm = fmax(maxHaversineMm, fabs(haversineM - reference) * 1000);
+
+                if (reference >= MIN_BEARING_LEG_M) {
+                    double bearing = Geodesy::bearingDeci(b.x - a.x, b.y - a.y) / 10.0;
+                    maxBearingDeg = fmax(maxBearingDeg, angleError(bearing, azimuth));
+                }
+            }
+        }
+        printf("Geodesy: %5.0f m | %5.1f mm / %8.1f mm | %.3f deg\n", radius.radiusM, maxFixedMm, maxHaversineMm,
+               maxBearingDeg);
+
+        char what[80];
+        snprintf(what, sizeof(what), "distance error within %.0f m of the origin", radius.radiusM);
+        expectNear(maxFixedMm, 0, radius.maxErrorMm, what);
+        snprintf(what, sizeof(what), "bearing error within %.0f m of the origin", radius.radiusM);
+        expectNear(maxBearingDeg, 0, radius.maxBearingDeg, what);
+    }
+}
+
+static void checkRoundTrip() {
+    // unproject() inverts project() to the 1e-7 degree step within 10 km
+    int32_t worst = 0;
+    for (int latitude = -70; latitude <= 70; latitude += 35) {
+        LocalFrame frame;
+        frame.setOrigin(Geodesy::toE7(latitude + 0.5), Geodesy::toE7(-3.2));
+        for (int i = 0; i < PAIRS_PER_CASE; i++) {
+            int32_t latE7, lonE7, backLat, backLon;
+            pointInDisk(latitude + 0.5, -3.2, 10000, latE7, lonE7);
+            frame.unproject(frame.project(latE7, lonE7), backLat, backLon);
+            worst = std::max(worst, std::max(abs(backLat - latE7), abs(backLon - lonE7)));
+        }
+    }
+    expect(worst <= 1, "project() / unproject() round trip within 1e-7 degree");
+}
+
+static void checkAngles() {
+    // Table of whole degrees, linear interpolation: 2 LSB at most
+    int32_t worstSin = 0;
+    for (int32_t deci = -3600; deci <= 7200; deci++) {
+        double angle = deci / 10.0 * RAD;
+        worstSin = std::max(worstSin, abs(Geodesy::sinQ15(deci) - (int32_t)lround(sin(angle) * 32767)));
+        worstSin = std::max(worstSin, abs(Geodesy::cosQ15(deci) - (int32_t)lround(cos(angle) * 32767)));
+    }
+    expect(worstSin <= 2, "sinQ15 / cosQ15 within 2 LSB of the double sine, any angle");
+
+    // Every 0.1 degree step comes back exact
+    double worstStep = 0;
+    for (int32_t deci = 0; deci < 3600; deci++) {
+        double angle = deci / 10.0 * RAD;
+        int32_t east = (int32_t)lround(sin(angle) * 1000000);
+        int32_t north = (int32_t)lround(cos(angle) * 1000000);
+        worstStep = fmax(worstStep, angleError(Geodesy::bearingDeci(east, north) / 10.0, deci / 10.0));
+    }
+    expectNear(worstStep, 0, 1e-9, "bearingDeci on every 0.1 degree step");
+
+    // Any angle: 0.05 degree rounding plus the table error (< 0.02 degree)
+    double worstAny = 0;
+    for (int i = 0; i < 100000; i++) {
+        double degrees = uniform() * 360;
+        int32_t east = (int32_t)lround(sin(degrees * RAD) * 1000000);
+        int32_t north = (int32_t)lround(cos(degrees * RAD) * 1000000);
+        worstAny = fmax(worstAny, angleError(Geodesy::bearingDeci(east, north) / 10.0, degrees));
+    }
+    expectNear(worstAny, 0, 0.07, "bearingDeci on any angle");
+    expect(Geodesy::bearingDeci(0, 0) == 0, "bearingDeci of a null vector");
+    expect(Geodesy::bearingDeci(-1, 1000000) >= 3599 || Geodesy::bearingDeci(-1, 1000000) == 0,
+           "bearingDeci just west of north");
+    expectNear(Geodesy::courseDelta(359, 1), 2, 1e-4, "courseDelta through north");
+    expectNear(Geodesy::courseDelta(1, 359), -2, 1e-4, "courseDelta back through north");
+}
+
+static void benchmark() {
+    uint32_t n = benchIterations();
+    if (n == 0) {
+        return;
+    }
+    // Same track as Geodesy::printBenchmark(): 32 points on a 2 km circle at 45 degrees north
+    static const size_t COUNT = 32;
+    int32_t lat[COUNT];
+    int32_t lon[COUNT];
+    LocalPoint points[COUNT];
+    uint32_t legs[COUNT];
+    LocalFrame frame;
+    frame.setOrigin(450000000, 60000000);
+    for (size_t i = 0; i < COUNT; i++) {
+        int32_t angle = (int32_t)(i * 3600 / COUNT);
+        lat[i] = 450000000 + (Geodesy::cosQ15(angle) * 180) / 32767 * 1000;
+        lon[i] = 60000000 + (Geodesy::sinQ15(angle) * 254) / 32767 * 1000;
+    }
+
+    uint32_t rounds = std::max<uint32_t>(n / COUNT, 1);
+    uint64_t fixedTotal = 0;
+    double start = nowS();
+    for (uint32_t r = 0; r < rounds; r++) {
+        lat[r % COUNT] ^= 1;   // Keep the compiler from hoisting the loop body
+        frame.projectBatch(lat, lon, points, COUNT);
+        fixedTotal += Geodesy::distancesMm(points, legs, COUNT);
+    }
+    double fixedNs = (nowS() - start) * 1e9 / ((double)rounds * COUNT);
+
+    double haversineTotal = 0;
+    start = nowS();
+    for (uint32_t r = 0; r < rounds; r++) {
+        lat[r % COUNT] ^= 1;
+        for (size_t i = 1; i < COUNT; i++) {
+            haversineTotal += Geodesy::haversineM(lat[i - 1] * 1e-7, lon[i - 1] * 1e-7, lat[i] * 1e-7, lon[i] * 1e-7);
+        }
+    }
+    double haversineNs = (nowS() - start) * 1e9 / ((double)rounds * (COUNT - 1));
+
+    printf("Geodesy: %.1f ns/point projection+distance, %.1f ns haversine (x%.1f) on this host (check %.0f / %.0f)\n",
+           fixedNs, haversineNs, haversineNs / fixedNs, fixedTotal / 1000.0 / rounds, haversineTotal / rounds);
+}
+
+void checkGeodesy() {
+    checkAccuracy();
+    checkRoundTrip();
+    checkAngles();
+    benchmark();
+}
@@ -0,0 +1,339 @@
+/**
+ * Vérifications de ProximityMonitor (src/ProximityMonitor.cpp) : flotte
+ * de 100 bateaux et route de collision
+ *
+ * Flotte : 100 bateaux sur un plan d'eau de 600 × 600 m, 1 à 3 m/s, caps
+ * au hasard, rebond sur les bords, une position toutes les 200 ms chacun,
+ * pendant 10 min ; le bateau suivi est l'un d'eux (fix à 5 Hz). À chaque
+ * fix, le niveau d'alerte du firmware (hachage spatial) est comparé à un
+ * calcul de CPA en double sur toute la flotte ; le nombre de CPA calculés
+ * et d'entrées de la table parcourues par le firmware est relevé.
+ *
+ * Route de collision : deux bateaux à 4 nœuds à angle droit vers le même
+ * point ; le temps jusqu'au CPA est relevé au premier fix en convergence
+ * et au premier fix en danger.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include "checks.h"
+#include "ProximityMonitor.h"
+
+static const double ORIGIN_LAT = 43.25;
+static const double ORIGIN_LON = 5.30;
+static const double KNOT_MPS = 1852.0 / 3600.0;
+static const uint32_t FLEET = 100;
+static const double AREA_M = 600.0;
+static const uint32_t PERIOD_MS = 200;              // Own fixes and broadcasts of every boat
+static const uint32_t TICK_MS = 20;
+static const uint32_t DURATION_MS = 600000;
+static const double HORIZON_S = 10.0;               // Default configuration key 19
+static const double CPA_M = 10.0;                   // ProximityMonitor::CPA_DISTANCE_MM
+static const double DANGER_M = 3.0;                 // ProximityMonitor::DANGER_DISTANCE_MM
+static const double DANGER_TCPA_S = 3.0;            // ProximityMonitor::DANGER_TCPA_MS
+static const double MARGIN_M = 0.1;                 // Velocity to 0.1 degree, positions as float degrees
+static const double MARGIN_S = 0.05;
+
+struct SimBoat {
+    double x;                      // m east of the origin
+    double y;                      // m north
+    double speed;                  // m/s
+    double heading;                // degrees
+    uint32_t phaseMs;              // Broadcast phase in the period
+    uint32_t sequence;
+    GPSBroadcastPacket sent;       // Last position broadcast
+    uint32_t sentAt;
+};
+
+/**
+ * @brief Position east / north of the origin (m), WGS84 radii of curvature
+ */
+static void offsetToLatLon(double eastM, double northM, double& latitude, double& longitude) {
+    const double a = 6378137.0;
+    const double e2 = 6.69437999014e-3;
+    double phi = ORIGIN_LAT * M_PI / 180.0;
+    double w = 1.0 - e2 * sin(phi) * sin(phi);
+    double meridian = a * (1.0 - e2) / pow(w, 1.5);
+    double normal = a / sqrt(w);
+    latitude = ORIGIN_LAT + northM / meridian * 180.0 / M_PI;
+    longitude = ORIGIN_LON + eastM / (normal * cos(phi)) * 180.0 / M_PI;
+}
+
+/**
+ * @brief Inverse of offsetToLatLon (m)
+ */
+static void latLonToOffset(double latitude, double longitude, double& eastM, double& northM) {
+    const double a = 6378137.0;
+    const double e2 = 6.69437999014e-3;
+    double phi = ORIGIN_LAT * M_PI / 180.0;
+    double w = 1.0 - e2 * sin(phi) * sin(phi);
+    double meridian = a * (1.0 - e2) / pow(w, 1.5);
+    double normal = a / sqrt(w);
+    northM = (latitude - ORIGIN_LAT) * M_PI / 180.0 * meridian;
+    eastM = (longitude - ORIGIN_LON) * M_PI / 180.0 * normal * cos(phi);
+}
+
+static void macOf(uint32_t index, uint8_t mac[6]) {
+    const uint8_t base[6] = {0x02, 0x00, 0x00, 0x00, (uint8_t)(index >> 8), (uint8_t)index};
+    memcpy(mac, base, 6);
+}
+
+static GPSBroadcastPacket broadcast(SimBoat& boat, uint32_t index, uint32_t nowMs) {
+    GPSBroadcastPacket packet;
+    memset(&packet, 0, sizeof(packet));
+    packet.messageType = 1;
+    snprintf(packet.name, sizeof(packet.name), "BOAT%02lu", (unsigned long)index);
+    packet.sequenceNumber = ++boat.sequence;
+    packet.gpsTimestamp = nowMs;
+    double lat, lon;
+    offsetToLatLon(boat.x, boat.y, lat, lon);
+    packet.latitude = (float)lat;
+    packet.longitude = (float)lon;
+    packet.speed = (float)(boat.speed / KNOT_MPS);
+    packet.heading = (float)boat.heading;
+    packet.satellites = 9;
+    packet.ttl = 1;
+    packet.quality = FIX_GOOD;
+    return packet;
+}
+
+static GPSData ownFix(const SimBoat& boat, uint32_t nowMs) {
+    GPSData data;
+    memset(&data, 0, sizeof(data));
+    offsetToLatLon(boat.x, boat.y, data.latitude, data.longitude);
+    data.speed = (float)(boat.speed / KNOT_MPS);
+    data.course = (float)boat.heading;
+    data.satellites = 9;
+    data.valid = true;
+    data.fixMillis = nowMs;
+    return data;
+}
+
+static void advance(SimBoat& boat, double dtS) {
+    double rad = boat.heading * M_PI / 180.0;
+    boat.x += boat.speed * sin(rad) * dtS;
+    boat.y += boat.speed * cos(rad) * dtS;
+}
+
+/**
+ * @brief Straight run, heading reflected on the edges of the area
+ */
+static void move(SimBoat& boat, double dtS) {
+    advance(boat, dtS);
+    if (boat.x < 0 || boat.x > AREA_M) {
+        boat.x = fmin(fmax(boat.x, 0.0), AREA_M);
+        boat.heading = fmod(360.0 - boat.heading, 360.0);
+    }
+    if (boat.y < 0 || boat.y > AREA_M) {
+        boat.y = fmin(fmax(boat.y, 0.0), AREA_M);
+        boat.heading = fmod(540.0 - boat.heading, 360.0);
+    }
+}
+
+/**
+ * @brief Alert level of one neighbour in double, as received (-1 = too close to a threshold to compare)
+ */
+static int referenceLevel(const GPSData& own, const GPSBroadcastPacket& sent, uint32_t sentAt) {
+    double ox, oy, bx, by;
+    latLonToOffset(own.latitude, own.longitude, ox, oy);
+    latLonToOffset(sent.latitude, sent.longitude, bx, by);
+    double age = ((int32_t)(own.fixMillis - sentAt)) * 0.001;
+    double bvx = sent.speed * KNOT_MPS * sin(sent.heading * M_PI / 180.0);
+    double bvy = sent.speed * KNOT_MPS * cos(sent.heading * M_PI / 180.0);
+    double rx = bx + bvx * age - ox;
+    double ry = by + bvy * age - oy;
+    double vx = bvx - own.speed * KNOT_MPS * sin(own.course * M_PI / 180.0);
+    double vy = bvy - own.speed * KNOT_MPS * cos(own.course * M_PI / 180.0);
+    double distance = hypot(rx, ry);
+    double dot = rx * vx + ry * vy;
+    double speed2 = vx * vx + vy * vy;
+    double tcpa = (dot < 0 && speed2 > 0) ? -dot / speed2 : 0;
+    double cpa = hypot(rx + vx * tcpa, ry + vy * tcpa);
+
+    if (fabs(distance - DANGER_M) < MARGIN_M || fabs(cpa - CPA_M) < MARGIN_M || fabs(tcpa - HORIZON_S) < MARGIN_S ||
+        fabs(tcpa - DANGER_TCPA_S) < MARGIN_S || (tcpa > 0 && tcpa < MARGIN_S)) {
+        return -1;
+    }
+    if (distance < DANGER_M) {
+        return PROXIMITY_DANGER;
+    }
+    if (tcpa > 0 && tcpa <= HORIZON_S && cpa < CPA_M) {
+        return tcpa <= DANGER_TCPA_S ? PROXIMITY_DANGER : PROXIMITY_CONVERGING;
+    }
+    return PROXIMITY_CLEAR;
+}
+
+static void checkFleet() {
+    std::mt19937_64 engine(42);
+    std::uniform_real_distribution<double> position(0, AREA_M);
+    std::uniform_real_distribution<double> speed(1.0, 3.0);
+    std::uniform_real_distribution<double> heading(0, 360);
+    std::uniform_int_distribution<uint32_t> phase(1, PERIOD_MS / TICK_MS - 1);
+
+    SimBoat boats[FLEET];
+    for (uint32_t i = 0; i < FLEET; i++) {
+        boats[i].x = position(engine);
+        boats[i].y = position(engine);
+        boats[i].speed = speed(engine);
+        boats[i].heading = heading(engine);
+        boats[i].phaseMs = phase(engine) * TICK_MS;
+        boats[i].sequence = 0;
+        boats[i].sentAt = 0;
+    }
+    SimBoat& own = boats[0];   // Boat 0 runs the monitor and never hears itself
+
+    ProximityMonitor monitor;
+    monitor.setHorizon((uint8_t)HORIZON_S);
+    uint64_t checksSum = 0;
+    uint32_t checksMax = 0;
+    uint64_t visitsSum = 0;
+    uint32_t visitsMax = 0;
+    uint32_t fixes = 0;
+    uint32_t mismatches = 0;
+    uint32_t compared = 0;
+    uint32_t alerting = 0;
+    uint32_t heard = 0;
+    for (uint32_t t = TICK_MS; t <= DURATION_MS; t += TICK_MS) {
+        for (uint32_t i = 0; i < FLEET; i++) {
+            move(boats[i], TICK_MS * 0.001);
+        }
+        for (uint32_t i = 1; i < FLEET; i++) {
+            if (t % PERIOD_MS == boats[i].phaseMs) {
+                uint8_t mac[6];
+                macOf(i, mac);
+                boats[i].sent = broadcast(boats[i], i, t);
+                boats[i].sentAt = t;
+                heard += monitor.applyBoat(mac, boats[i].sent, t);
+            }
+        }
+        if (t % PERIOD_MS != 0 || t < PERIOD_MS * 2) {
+            continue;   // Own fix once every boat has been heard
+        }
+
+        GPSData data = ownFix(own, t);
+        ProximityLevel level = monitor.update(data);
+        fixes++;
+        checksSum += monitor.getLastChecks();
+        checksMax = std::max(checksMax, monitor.getLastChecks());
+        visitsSum += monitor.getLastVisits();
+        visitsMax = std::max(visitsMax, monitor.getLastVisits());
+
+        int reference = PROXIMITY_CLEAR;
+        bool borderline = false;
+        for (uint32_t i = 1; i < FLEET; i++) {
+            int boatLevel = referenceLevel(data, boats[i].sent, boats[i].sentAt);
+            borderline = borderline || boatLevel < 0;
+            reference = std::max(reference, boatLevel);
+        }
+        if (!borderline) {
+            compared++;
+            mismatches += (int)level != reference;
+            alerting += reference != PROXIMITY_CLEAR;
+        }
+    }
+
+    double average = (double)checksSum / fixes;
+    double averageVisits = (double)visitsSum / fixes;
+    printf("ProximityMonitor: %lu boats on %.0f x %.0f m, %lu fixes | %.1f CPA/fix (max %lu), "
+           "%.1f entries walked/fix (max %lu), %lu alert fixes, %lu / %lu levels differ from all pairs\n",
+           (unsigned long)FLEET, AREA_M, AREA_M, (unsigned long)fixes, average, (unsigned long)checksMax,
+           averageVisits, (unsigned long)visitsMax, (unsigned long)alerting, (unsigned long)mismatches,
+           (unsigned long)compared);
+    expect(heard == (DURATION_MS / PERIOD_MS) * (FLEET - 1), "fleet: every position accepted");
+    expect(monitor.getBoatCount() == FLEET - 1, "fleet: every boat in the table");
+    expect(compared > fixes * 3 / 4 && alerting > 0, "fleet: levels compared, alerts seen");
+    expect(mismatches == 0, "fleet: spatial hash level equals the all-pairs level");
+    expect(average < FLEET / 4 && checksMax < FLEET / 2, "fleet: CPA per fix well below the fleet size");
+    expect(visitsMax < FLEET - 1, "fleet: fewer entries walked per fix than a scan of the table");
+}
+
+static void checkCollision() {
+    // Own boat north from 150 m south, intruder west from 150 m east, both 4 knots: contact at the origin
+    const double speedMps = 4 * KNOT_MPS;
+    const double startM = 150.0;
+    SimBoat own = {0, -startM, speedMps, 0, 0, 0, {}, 0};
+    SimBoat intruder = {startM, 0, speedMps, 270, 100, 0, {}, 0};
+    uint8_t mac[6];
+    macOf(1, mac);
+
+    ProximityMonitor monitor;
+    monitor.setHorizon((uint8_t)HORIZON_S);
+    double convergingTcpa = -1;
+    double convergingTruth = -1;
+    double dangerTcpa = -1;
+    double dangerTruth = -1;
+    double worstCpaM = 0;
+    for (uint32_t t = TICK_MS; t * 0.001 * speedMps < startM - 1; t += TICK_MS) {
+        advance(own, TICK_MS * 0.001);
+        advance(intruder, TICK_MS * 0.001);
+        if (t % PERIOD_MS == intruder.phaseMs) {
+            monitor.applyBoat(mac, broadcast(intruder, 1, t), t);
+        }
+        if (t % PERIOD_MS != 0) {
+            continue;
+        }
+        ProximityLevel level = monitor.update(ownFix(own, t));
+        double truth = (startM - t * 0.001 * speedMps) / speedMps;
+        if (level != PROXIMITY_CLEAR) {
+            worstCpaM = fmax(worstCpaM, monitor.getThreatCpaMm() / 1000.0);
+        }
+        if (level == PROXIMITY_CONVERGING && convergingTcpa < 0) {
+            convergingTcpa = monitor.getThreatTcpaMs() / 1000.0;
+            convergingTruth = truth;
+        }
+        if (level == PROXIMITY_DANGER && dangerTcpa < 0) {
+            dangerTcpa = monitor.getThreatTcpaMs() / 1000.0;
+            dangerTruth = truth;
+        }
+    }
+
+    printf("ProximityMonitor: collision course at 4 kn | converging at %.1f s to CPA (true %.1f s), "
+           "danger at %.1f s (true %.1f s), CPA <= %.2f m\n",
+           convergingTcpa, convergingTruth, dangerTcpa, dangerTruth, worstCpaM);
+    expect(convergingTcpa > HORIZON_S - 0.5 && convergingTcpa <= HORIZON_S, "collision: converging at the horizon");
+    expect(dangerTcpa > DANGER_TCPA_S - 0.5 && dangerTcpa <= DANGER_TCPA_S, "collision: danger at 3 s");
+    expectNear(convergingTcpa, convergingTruth, 0.2, "collision: time to CPA when converging");
+    expectNear(dangerTcpa, dangerTruth, 0.2, "collision: time to CPA in danger");
+    expect(worstCpaM < 1.0, "collision: CPA distance close to 0");
+}
+
+static void benchmark() {
+    uint32_t n = benchIterations();
+    if (n == 0) {
+        return;
+    }
+    // Fleet of 99 boats frozen at t = 10 s, own fixes anywhere on the area
+    std::mt19937_64 engine(7);
+    std::uniform_real_distribution<double> position(0, AREA_M);
+    ProximityMonitor monitor;
+    for (uint32_t i = 1; i < FLEET; i++) {
+        SimBoat boat = {position(engine), position(engine), 2.0, (double)(i * 37 % 360), 0, 0, {}, 0};
+        uint8_t mac[6];
+        macOf(i, mac);
+        monitor.applyBoat(mac, broadcast(boat, i, 10000), 10000);
+    }
+    static const uint32_t SAMPLES = 1024;
+    static GPSData fixes[SAMPLES];
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        SimBoat boat = {position(engine), position(engine), 2.0, (double)(i * 53 % 360), 0, 0, {}, 0};
+        fixes[i] = ownFix(boat, 10000);
+    }
+
+    uint64_t checksum = 0;
+    double start = nowS();
+    for (uint32_t i = 0; i < n; i++) {
+        checksum += monitor.update(fixes[i % SAMPLES]) + monitor.getLastChecks();
+    }
+    double elapsed = nowS() - start;
+    printf("ProximityMonitor::update(): %.1f ns/fix on this host, 99 boats (check %llu)\n", elapsed * 1e9 / n,
+           (unsigned long long)checksum);
+}
+
+void checkProximity() {
+    checkFleet();
+    checkCollision();
+    benchmark();
+}
@@ -0,0 +1,192 @@
+/**
+ * Vérifications de StartLine (src/StartLine.cpp) : distance signée,
+ * vitesse de rapprochement, temps jusqu'à la ligne et OCS
+ *
+ * Ligne de 300 m est-ouest au large de Marseille. Bateau comité à l'est
+ * et bouée à l'ouest : L = (-300 m, 0), normale (-Ly, Lx)/|L| = (0, -1),
+ * côté pré-départ au sud. Ordre inverse : côté pré-départ au nord.
+ * Les positions sont calculées ici en double (rayons de courbure WGS84),
+ * indépendamment du repère local du firmware.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "checks.h"
+#include "StartLine.h"
+
+static const double ORIGIN_LAT = 43.25;
+static const double ORIGIN_LON = 5.30;
+static const double LINE_M = 300.0;
+static const double KNOT_MMPS = 1852000.0 / 3600.0;
+
+/**
+ * @brief Position east / north of the committee end (m), WGS84 radii of curvature
+ */
+static void offsetToLatLon(double eastM, double northM, double& latitude, double& longitude) {
+    const double a = 6378137.0;
+    const double e2 = 6.69437999014e-3;
+    double phi = ORIGIN_LAT * M_PI / 180.0;
+    double w = 1.0 - e2 * sin(phi) * sin(phi);
+    double meridian = a * (1.0 - e2) / pow(w, 1.5);
+    double normal = a / sqrt(w);
+    latitude = ORIGIN_LAT + northM / meridian * 180.0 / M_PI;
+    longitude = ORIGIN_LON + eastM / (normal * cos(phi)) * 180.0 / M_PI;
+}
+
+static GPSData fixAt(double eastM, double northM, float knots, float course) {
+    GPSData data;
+    memset(&data, 0, sizeof(data));
+    offsetToLatLon(eastM, northM, data.latitude, data.longitude);
+    data.speed = knots;
+    data.course = course;
+    data.satellites = 9;
+    data.valid = true;
+    return data;
+}
+
+/**
+ * @brief Line with the pin west (pre-start side south) or east (pre-start side north)
+ */
+static void setLine(StartLine& line, bool pinWest) {
+    double pinLat, pinLon;
+    offsetToLatLon(pinWest ? -LINE_M : LINE_M, 0, pinLat, pinLon);
+    line.setLine(Geodesy::toE7(ORIGIN_LAT), Geodesy::toE7(ORIGIN_LON), Geodesy::toE7(pinLat), Geodesy::toE7(pinLon));
+}
+
+static void checkGeometry() {
+    StartLine line;
+    expect(!line.hasLine(), "no line before both ends are set");
+    expect(!line.update(fixAt(-150, -50, 5, 0), true), "update refused without a line");
+
+    double lat, lon;
+    offsetToLatLon(-0.5, 0, lat, lon);
+    line.setLine(Geodesy::toE7(ORIGIN_LAT), Geodesy::toE7(ORIGIN_LON), Geodesy::toE7(lat), Geodesy::toE7(lon));
+    expect(!line.hasLine(), "ends 0.5 m apart: no usable line");
+
+    setLine(line, true);
+    expect(line.hasLine(), "line set");
+    expectNear(line.getLengthM(), LINE_M, 0.05, "line length");
+    expectNear(line.getCourseSideBearing(), 0, 0.1, "pin west: course side north");
+
+    GPSData invalid = fixAt(-150, -50, 5, 0);
+    invalid.valid = false;
+    expect(!line.update(invalid, true), "invalid fix refused");
+
+    setLine(line, false);
+    expectNear(line.getCourseSideBearing(), 180, 0.1, "pin east: course side south");
+}
+
+static void checkPinOrders() {
+    // Same boat, 50 m south of the middle of the line, heading north at 5 knots
+    for (int pinWest = 1; pinWest >= 0; pinWest--) {
+        StartLine line;
+        setLine(line, pinWest);
+        double east = pinWest ? -150 : 150;
+        expect(line.update(fixAt(east, -50, 5, 0), true), "update with a line");
+
+        double sign = pinWest ? 1 : -1;   // Pre-start side south with the pin west
+        char what[64];
+        snprintf(what, sizeof(what), "distance, pin %s", pinWest ? "west" : "east");
+        expectNear(line.getDistanceMm(), sign * 50000, 20, what);
+        snprintf(what, sizeof(what), "closing speed, pin %s", pinWest ? "west" : "east");
+        expectNear(line.getClosingMmps(), sign * 5 * KNOT_MMPS, 3, what);
+        snprintf(what, sizeof(what), "time to line, pin %s", pinWest ? "west" : "east");
+        expectNear(line.getTimeToLineMs(), 50000 / (5 * KNOT_MMPS) * 1000, 30, what);
+        snprintf(what, sizeof(what), "OCS before the gun, pin %s", pinWest ? "west" : "east");
+        expect(line.isOCS() == !pinWest, what);
+        snprintf(what, sizeof(what), "middle of the line, pin %s", pinWest ? "west" : "east");
+        expectNear(line.alongLineQ16(line.getX(), line.getY()), 32768, 16, what);
+    }
+}
+
+static void checkClosingAndTimeToLine() {
+    StartLine line;
+    setLine(line, true);
+
+    // Oblique approach: closing speed is the component along the normal
+    line.update(fixAt(-150, -50, 5, 60), true);
+    expectNear(line.getClosingMmps(), 5 * KNOT_MMPS * 0.5, 5, "closing speed at 60 degrees from the normal");
+    expectNear(line.getTimeToLineMs(), 50000 / (5 * KNOT_MMPS * 0.5) * 1000, 80, "time to line at 60 degrees");
+
+    // Boat on the line, crossing: the line itself is only known to 1e-7 degree (11 mm).
+    // Pre-start side is strictly > 0, OCS strictly < 0: exactly 0 is neither, with no time to line
+    line.update(fixAt(-150, 0, 5, 0), true);
+    int32_t onLine = line.getDistanceMm();
+    expectNear(onLine, 0, 20, "boat on the line: distance");
+    expect(line.isOCS() == (onLine < 0), "boat on the line: OCS only on the course side");
+    if (onLine > 0) {
+        expectNear(line.getTimeToLineMs(), 0, 10, "boat on the line: time to line");
+    } else {
+        expect(line.getTimeToLineMs() == INT32_MAX, "boat on the line, already across: time to line undefined");
+    }
+
+    // Stopped, drifting slower than MIN_CLOSING_MMPS, sailing along the line, sailing away
+    line.update(fixAt(-150, -50, 0, 0), true);
+    expect(line.getClosingMmps() == 0, "stopped boat: no closing speed");
+    expect(line.getTimeToLineMs() == INT32_MAX, "stopped boat: time to line undefined");
+    line.update(fixAt(-150, -50, 0.05f, 0), true);
+    expect(line.getTimeToLineMs() == INT32_MAX, "drifting boat (26 mm/s): time to line undefined");
+    line.update(fixAt(-150, -50, 5, 90), true);
+    expectNear(line.getClosingMmps(), 0, 2, "sailing along the line: no closing speed");
+    expect(line.getTimeToLineMs() == INT32_MAX, "sailing along the line: time to line undefined");
+    line.update(fixAt(-150, -50, 5, 180), true);
+    expect(line.getClosingMmps() < 0, "sailing away: negative closing speed");
+    expect(line.getTimeToLineMs() == INT32_MAX, "sailing away: time to line undefined");
+}
+
+static void checkOverTheLine() {
+    StartLine line;
+    setLine(line, true);
+
+    // 20 m on the course side before the gun, coming back south at 4 knots
+    line.update(fixAt(-100, 20, 4, 180), true);
+    expectNear(line.getDistanceMm(), -20000, 20, "over the line: negative distance");
+    expect(line.isOCS(), "over the line before the gun: OCS");
+    expectNear(line.getClosingMmps(), -4 * KNOT_MMPS, 3, "returning: closing speed toward the pre-start side");
+    expectNear(line.getTimeToLineMs(), 20000 / (4 * KNOT_MMPS) * 1000, 30, "returning: time to line");
+
+    // Gun fired while still over: OCS kept until the boat is back on the pre-start side
+    line.update(fixAt(-100, 10, 4, 180), false);
+    expect(line.isOCS(), "still over after the gun: OCS kept");
+    line.update(fixAt(-100, -5, 4, 0), false);
+    expect(!line.isOCS(), "back on the pre-start side: OCS cleared");
+    line.update(fixAt(-100, 30, 4, 0), false);
+    expect(!line.isOCS(), "start after the gun: not OCS");
+
+    // Pre-start side before the gun: never OCS
+    line.update(fixAt(-100, -1, 4, 0), true);
+    expect(!line.isOCS(), "1 m below the line before the gun: not OCS");
+}
+
+static void benchmark() {
+    uint32_t n = benchIterations();
+    if (n == 0) {
+        return;
+    }
+    static const uint32_t SAMPLES = 1024;
+    static GPSData fixes[SAMPLES];
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        fixes[i] = fixAt(-400 + (i * 7919 % 800), -100 + (i * 104729 % 200), (i % 80) / 10.0f, (i * 37) % 360);
+    }
+    StartLine line;
+    setLine(line, true);
+
+    int64_t checksum = 0;
+    double start = nowS();
+    for (uint32_t i = 0; i < n; i++) {
+        line.update(fixes[i % SAMPLES], true);
+        checksum += (int64_t)line.getDistanceMm() + line.getTimeToLineMs();
+    }
+    double elapsed = nowS() - start;
+    printf("StartLine::update(): %.1f ns/fix on this host (check %lld)\n", elapsed * 1e9 / n,
+           (long long)(checksum & 0xFFFF));
+}
+
+void checkStartLine() {
+    checkGeometry();
+    checkPinOrders();
+    checkClosingAndTimeToLine();
+    checkOverTheLine();
+    benchmark();
+}
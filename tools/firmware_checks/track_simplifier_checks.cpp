@@ -0,0 +1,246 @@
+/**
+ * Vérifications de TrackSimplifier (src/TrackSimplifier.cpp) : rejeu
+ * d'un log NMEA
+ *
+ * Par défaut, data/track_5hz.nmea : un tour de parcours au vent arrière
+ * de 3 min 18 s à 5 Hz (RMC), virements et empannages, bruit GPS corrélé
+ * (marche aléatoire de 1,2 m, constante de temps 60 s) et une perte de
+ * fix de 4 s. Aucun log enregistré n'est disponible dans le dépôt :
+ * l'échantillon est synthétique. Un log nmea_*.nmea de la carte SD se
+ * rejoue de la même façon avec --track.
+ *
+ * Pour chaque tolérance, l'erreur de chaque fix abandonné est recalculée
+ * ici en double, contre le segment conservé qui l'encadre, et comparée à
+ * la tolérance et à l'erreur maximale mesurée par le firmware.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "checks.h"
+#include "TrackSimplifier.h"
+
+static const uint32_t GAP_MS = 2000;                // TrackSimplifier::MAX_GAP_MS
+static const uint16_t TOLERANCES_CM[] = {50, 100, 200, 500};
+static const double MIN_RATIO_2M = 8.0;             // Compression expected at the default 2 m tolerance
+
+/**
+ * @brief Days since 1970-01-01 of a civil date
+ */
+static int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    unsigned yoe = (unsigned)(y - era * 400);
+    unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+static double nmeaDegrees(const char* field, const char* hemisphere) {
+    double value = atof(field);
+    double degrees = floor(value / 100);
+    degrees += (value - degrees * 100) / 60;
+    return (*hemisphere == 'S' || *hemisphere == 'W') ? -degrees : degrees;
+}
+
+/**
+ * @brief Valid RMC sentences of an NMEA log as fixes (other sentences ignored)
+ */
+static bool readTrack(const char* path, std::vector<GPSData>& fixes) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    char line[128];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        char* star = strchr(line, '*');
+        if (line[0] != '$' || star == nullptr || strncmp(line + 3, "RMC,", 4) != 0) {
+            continue;
+        }
+        uint8_t checksum = 0;
+        for (const char* c = line + 1; c < star; c++) {
+            checksum ^= (uint8_t)*c;
+        }
+        if (strtoul(star + 1, nullptr, 16) != checksum) {
+            continue;
+        }
+        *star = '\0';
+
+        const char* fields[13] = {};
+        size_t count = 0;
+        for (char* p = line; p != nullptr && count < 13; count++) {
+            fields[count] = p;
+            p = strchr(p, ',');
+            if (p != nullptr) {
+                *p++ = '\0';
+            }
+        }
+        if (count < 10 || fields[2][0] != 'A' || strlen(fields[9]) != 6) {
+            continue;
+        }
+
+        double timeOfDay = atof(fields[1]);
+        int hh = (int)(timeOfDay / 10000);
+        int mm = (int)(timeOfDay / 100) % 100;
+        double ss = fmod(timeOfDay, 100);
+        unsigned date = (unsigned)atoi(fields[9]);
+        int64_t days = daysFromCivil(2000 + date % 100, (date / 100) % 100, date / 10000);
+
+        GPSData data;
+        memset(&data, 0, sizeof(data));
+        data.latitude = nmeaDegrees(fields[3], fields[4]);
+        data.longitude = nmeaDegrees(fields[5], fields[6]);
+        data.speed = (float)atof(fields[7]);
+        data.course = (float)atof(fields[8]);
+        data.timestamp = (uint32_t)(days * 86400 + hh * 3600 + mm * 60 + (int)ss);
+        data.fixMillis = (uint32_t)(days * 86400000 + (int64_t)lround((hh * 3600 + mm * 60 + ss) * 1000));
+        data.satellites = 9;
+        data.valid = true;
+        fixes.push_back(data);
+    }
+    fclose(file);
+    return true;
+}
+
+/**
+ * @brief Distance of a fix to the segment a -> b (m), local plane in double around a
+ */
+static double segmentDistanceM(const GPSData& a, const GPSData& b, const GPSData& p) {
+    // Fixes are compared as the firmware stores them: 1e-7 degree
+    double latA = Geodesy::toE7(a.latitude) * 1e-7;
+    double lonA = Geodesy::toE7(a.longitude) * 1e-7;
+    double phi = latA * M_PI / 180;
+    double mPerDegLat = 111132.92 - 559.82 * cos(2 * phi) + 1.175 * cos(4 * phi);
+    double mPerDegLon = 111412.84 * cos(phi) - 93.5 * cos(3 * phi) + 0.118 * cos(5 * phi);
+    double bx = (Geodesy::toE7(b.longitude) * 1e-7 - lonA) * mPerDegLon;
+    double by = (Geodesy::toE7(b.latitude) * 1e-7 - latA) * mPerDegLat;
+    double px = (Geodesy::toE7(p.longitude) * 1e-7 - lonA) * mPerDegLon;
+    double py = (Geodesy::toE7(p.latitude) * 1e-7 - latA) * mPerDegLat;
+    double length2 = bx * bx + by * by;
+    double t = length2 > 0 ? fmin(fmax((px * bx + py * by) / length2, 0.0), 1.0) : 0.0;
+    return hypot(px - t * bx, py - t * by);
+}
+
+/**
+ * @brief Run the simplifier over the track, return the indices of the kept fixes
+ */
+static std::vector<size_t> simplify(TrackSimplifier& simplifier, const std::vector<GPSData>& fixes) {
+    std::vector<size_t> kept;
+    size_t next = 0;   // Kept points are real fixes: match them by fix time, in order
+    auto record = [&](const TrackPoint& point) {
+        while (next < fixes.size() && fixes[next].fixMillis != point.fixMillis) {
+            next++;
+        }
+        if (next < fixes.size()) {
+            kept.push_back(next++);
+        } else {
+            kept.push_back(SIZE_MAX);
+        }
+    };
+    TrackPoint out[2];
+    for (const GPSData& data : fixes) {
+        uint8_t count = simplifier.push(data, out);
+        for (uint8_t i = 0; i < count; i++) {
+            record(out[i]);
+        }
+    }
+    if (simplifier.flush(out[0])) {
+        record(out[0]);
+    }
+    return kept;
+}
+
+static void checkReplay(const std::vector<GPSData>& fixes) {
+    TrackSimplifier every;
+    every.setTolerance(0);
+    expect(simplify(every, fixes).size() == fixes.size(), "tolerance 0 keeps every fix");
+
+    printf("TrackSimplifier: %zu fixes | tolerance -> points (ratio), max error replayed / firmware\n", fixes.size());
+    for (uint16_t toleranceCm : TOLERANCES_CM) {
+        TrackSimplifier simplifier;
+        simplifier.setTolerance(toleranceCm);
+        std::vector<size_t> kept = simplify(simplifier, fixes);
+
+        char what[96];
+        bool ordered = !kept.empty() && kept.front() == 0 && kept.back() == fixes.size() - 1;
+        for (size_t i = 1; i < kept.size(); i++) {
+            ordered = ordered && kept[i] != SIZE_MAX && kept[i] > kept[i - 1];
+        }
+        snprintf(what, sizeof(what), "%.1f m: kept points are real fixes in order, both ends", toleranceCm / 100.0);
+        expect(ordered, what);
+        if (!ordered) {
+            continue;
+        }
+
+        // Error of every dropped fix to the kept segment around it
+        double worstM = 0;
+        std::vector<bool> isKept(fixes.size(), false);
+        isKept[kept.front()] = true;
+        for (size_t k = 1; k < kept.size(); k++) {
+            for (size_t i = kept[k - 1] + 1; i < kept[k]; i++) {
+                worstM = fmax(worstM, segmentDistanceM(fixes[kept[k - 1]], fixes[kept[k]], fixes[i]));
+            }
+            isKept[kept[k]] = true;
+        }
+        // Both ends of a fix gap are kept
+        bool gapsKept = true;
+        for (size_t i = 1; i < fixes.size(); i++) {
+            if (fixes[i].fixMillis - fixes[i - 1].fixMillis > GAP_MS) {
+                gapsKept = gapsKept && isKept[i - 1] && isKept[i];
+            }
+        }
+        double ratio = (double)fixes.size() / kept.size();
+        double firmwareM = simplifier.getMaxErrorMm() / 1000.0;
+        printf("TrackSimplifier: %.1f m -> %zu points (%.1f:1), max error %.3f m / %.3f m\n", toleranceCm / 100.0,
+               kept.size(), ratio, worstM, firmwareM);
+
+        snprintf(what, sizeof(what), "%.1f m: every dropped fix within the tolerance", toleranceCm / 100.0);
+        expectNear(worstM, 0, toleranceCm / 100.0 + 0.005, what);
+        snprintf(what, sizeof(what), "%.1f m: firmware max error matches the replay", toleranceCm / 100.0);
+        expectNear(firmwareM, worstM, 0.01, what);
+        snprintf(what, sizeof(what), "%.1f m: both ends of a fix gap kept", toleranceCm / 100.0);
+        expect(gapsKept, what);
+        expect(simplifier.getPointsIn() == fixes.size() && simplifier.getPointsOut() == kept.size(),
+               "points in / out counters");
+        if (toleranceCm == 200 && strcmp(trackPath(), DEFAULT_TRACK_PATH) == 0) {
+            expect(ratio >= MIN_RATIO_2M, "2 m: compression of the sample track");
+        }
+    }
+}
+
+static void benchmark(const std::vector<GPSData>& fixes) {
+    uint32_t n = benchIterations();
+    if (n == 0 || fixes.empty()) {
+        return;
+    }
+    TrackSimplifier simplifier;
+    simplifier.setTolerance(200);
+    TrackPoint out[2];
+    uint64_t kept = 0;
+    uint32_t rounds = std::max<uint32_t>(n / fixes.size(), 1);
+    double start = nowS();
+    for (uint32_t r = 0; r < rounds; r++) {
+        simplifier.reset();
+        for (const GPSData& data : fixes) {
+            kept += simplifier.push(data, out);
+        }
+    }
+    double elapsed = nowS() - start;
+    printf("TrackSimplifier::push(): %.1f ns/fix on this host, 2.0 m tolerance (check %llu)\n",
+           elapsed * 1e9 / ((double)rounds * fixes.size()), (unsigned long long)kept);
+}
+
+void checkTrackSimplifier() {
+    std::vector<GPSData> fixes;
+    bool read = readTrack(trackPath(), fixes);
+    expect(read && fixes.size() > 100, "track log read");
+    if (!read || fixes.size() <= 100) {
+        return;
+    }
+    checkReplay(fixes);
+    benchmark(fixes);
+}
@@ -0,0 +1,242 @@
+/**
+ * Vérifications de TxScheduler (src/TxScheduler.cpp) : priorité stricte,
+ * limites en vol, files pleines et seaux à jetons
+ *
+ * Le pilote ESP-NOW est remplacé par le paramètre inFlight de peek() ;
+ * une trame est « envoyée » par pop(now, true). Tailles des trames du
+ * firmware : position 48 octets, événement 28, télémétrie 56.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "checks.h"
+#include "TxScheduler.h"
+
+static const size_t LIVE_LEN = 48;
+static const size_t EVENT_LEN = 28;
+static const size_t TELEMETRY_LEN = 56;
+
+static uint32_t pushFrame(TxScheduler& scheduler, TxClass txClass, size_t len, int64_t nowUs) {
+    uint8_t data[250];
+    memset(data, txClass, sizeof(data));
+    return scheduler.push(txClass, data, len, txClass == TX_TIME, nowUs);
+}
+
+/**
+ * @brief Send every frame allowed now with an empty radio, return how many
+ */
+static uint32_t drain(TxScheduler& scheduler, int64_t nowUs) {
+    uint32_t sent = 0;
+    while (scheduler.peek(nowUs, 0) != nullptr) {
+        scheduler.pop(nowUs, true);
+        sent++;
+    }
+    return sent;
+}
+
+static void checkPriority() {
+    TxScheduler scheduler;
+    pushFrame(scheduler, TX_TELEMETRY, TELEMETRY_LEN, 0);
+    pushFrame(scheduler, TX_TIME, 20, 0);
+    pushFrame(scheduler, TX_CONTROL, EVENT_LEN, 0);
+    pushFrame(scheduler, TX_LIVE, LIVE_LEN, 0);
+
+    static const TxClass ORDER[] = {TX_LIVE, TX_CONTROL, TX_TIME, TX_TELEMETRY};
+    bool ordered = true;
+    for (TxClass expected : ORDER) {
+        const TxFrame* frame = scheduler.peek(10, 0);
+        ordered = ordered && frame != nullptr && frame->txClass == expected;
+        ordered = ordered && scheduler.pop(10, true) == expected;
+    }
+    expect(ordered, "strict priority: live, control, time, telemetry");
+    expect(!scheduler.hasPending() && scheduler.peek(10, 0) == nullptr, "queues empty after draining");
+    expect(scheduler.getNextReleaseUs(10) == INT64_MAX, "no release time without waiting frames");
+
+    // A position pushed after background frames still goes first
+    pushFrame(scheduler, TX_CONTROL, EVENT_LEN, 20);
+    pushFrame(scheduler, TX_TELEMETRY, TELEMETRY_LEN, 20);
+    pushFrame(scheduler, TX_LIVE, LIVE_LEN, 30);
+    const TxFrame* frame = scheduler.peek(40, 0);
+    expect(frame != nullptr && frame->txClass == TX_LIVE, "late position overtakes waiting background frames");
+    expect(frame != nullptr && frame->queuedUs == 30, "frame keeps its queue time");
+}
+
+static void checkInFlight() {
+    TxScheduler scheduler;
+    pushFrame(scheduler, TX_CONTROL, EVENT_LEN, 0);
+    pushFrame(scheduler, TX_TIME, 20, 0);
+    pushFrame(scheduler, TX_TELEMETRY, TELEMETRY_LEN, 0);
+    expect(scheduler.peek(0, TxScheduler::IN_FLIGHT_MAX) == nullptr, "background classes wait at 2 frames in flight");
+    const TxFrame* frame = scheduler.peek(0, TxScheduler::IN_FLIGHT_MAX - 1);
+    expect(frame != nullptr && frame->txClass == TX_CONTROL, "background classes go below 2 frames in flight");
+
+    pushFrame(scheduler, TX_LIVE, LIVE_LEN, 0);
+    frame = scheduler.peek(0, TxScheduler::IN_FLIGHT_MAX);
+    expect(frame != nullptr && frame->txClass == TX_LIVE, "position goes with 2 frames in flight");
+    expect(scheduler.peek(0, TxScheduler::IN_FLIGHT_LIVE) == nullptr, "position waits at 3 frames in flight");
+    expect(scheduler.getNextReleaseUs(5) == 5, "next release now while a frame only waits for the radio");
+}
+
+static void checkFullQueues() {
+    // Live, depth 2: the oldest position is dropped
+    TxScheduler scheduler;
+    uint32_t first = pushFrame(scheduler, TX_LIVE, LIVE_LEN, 0);
+    uint32_t second = pushFrame(scheduler, TX_LIVE, LIVE_LEN, 1);
+    uint32_t third = pushFrame(scheduler, TX_LIVE, LIVE_LEN, 2);
+    expect(first != 0 && second != 0 && third != 0, "live: every position accepted");
+    expect(!scheduler.isQueued(first) && scheduler.isQueued(second) && scheduler.isQueued(third),
+           "live full: oldest position dropped");
+    const TxFrame* frame = scheduler.peek(3, 0);
+    expect(frame != nullptr && frame->id == second, "live: oldest remaining position first");
+    expect(scheduler.getStats(TX_LIVE).dropped == 1, "live: drop counted");
+
+    // Control, depth 8: the new frame is refused, the queued ones stay
+    uint32_t ids[8];
+    bool accepted = true;
+    for (uint8_t i = 0; i < 8; i++) {
+        ids[i] = pushFrame(scheduler, TX_CONTROL, EVENT_LEN, 10 + i);
+        accepted = accepted && ids[i] != 0;
+    }
+    expect(accepted, "control: 8 frames accepted");
+    expect(pushFrame(scheduler, TX_CONTROL, EVENT_LEN, 20) == 0, "control full: new frame refused");
+    bool kept = true;
+    for (uint32_t id : ids) {
+        kept = kept && scheduler.isQueued(id);
+    }
+    expect(kept, "control full: queued frames kept");
+    expect(scheduler.getStats(TX_CONTROL).dropped == 1, "control: refusal counted");
+
+    // Time, depth 1: the new beacon replaces the old one
+    uint32_t beacon = pushFrame(scheduler, TX_TIME, 20, 30);
+    uint32_t newer = pushFrame(scheduler, TX_TIME, 20, 40);
+    expect(!scheduler.isQueued(beacon) && scheduler.isQueued(newer), "time full: new beacon replaces the old one");
+
+    expect(pushFrame(scheduler, TX_TELEMETRY, 0, 50) == 0, "empty frame refused");
+    expect(pushFrame(scheduler, TX_TELEMETRY, 251, 50) == 0, "frame above 250 bytes refused");
+}
+
+static void checkBucket() {
+    // Telemetry: 40 ms/s, burst 20 ms; a 56-byte frame is 3568 us
+    uint32_t airtime = TxScheduler::airtimeUs(TELEMETRY_LEN);
+    expect(airtime == 400 + (56 + 43) * 32, "airtime of a 56-byte frame");
+
+    TxScheduler scheduler;
+    int64_t now = 1000000;
+    uint32_t sent = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+        pushFrame(scheduler, TX_TELEMETRY, TELEMETRY_LEN, now);
+        sent += drain(scheduler, now);
+    }
+    expect(sent == 20000 / airtime, "telemetry burst: 5 frames at once");
+    expect(scheduler.getStats(TX_TELEMETRY).dropped == 1, "telemetry held: the oldest frame replaced");
+
+    // Throttled frame counted once, however often it is peeked
+    uint32_t throttled = scheduler.getStats(TX_TELEMETRY).throttled;
+    scheduler.peek(now, 0);
+    scheduler.peek(now, 0);
+    expect(scheduler.getStats(TX_TELEMETRY).throttled == throttled && throttled >= 1,
+           "throttle counted once per frame");
+
+    // A throttled telemetry frame lets control and live frames go
+    pushFrame(scheduler, TX_CONTROL, EVENT_LEN, now);
+    pushFrame(scheduler, TX_LIVE, LIVE_LEN, now);
+    expect(drain(scheduler, now) == 2, "throttled telemetry does not hold other classes");
+
+    // Release time: 20000 - 5 x 3568 = 2160 us left, 1408 us missing at 40 us/ms -> 35200 us
+    int64_t release = scheduler.getNextReleaseUs(now);
+    expect(release == now + 35200, "next release when the bucket holds the frame airtime");
+    expect(scheduler.peek(release - 1, 0) == nullptr, "frame still held 1 us before the release");
+    const TxFrame* frame = scheduler.peek(release, 0);
+    expect(frame != nullptr && frame->txClass == TX_TELEMETRY, "frame released at the release time");
+    scheduler.pop(release, true);
+    expect(scheduler.getNextReleaseUs(release) == release + 89200, "next frame waits for a full frame airtime");
+
+    // Control: 60 ms/s, burst 40 ms; 14 events of 2672 us leave 2592 us, 80 us missing at 60 us/ms
+    TxScheduler control;
+    for (uint8_t i = 0; i < 15; i++) {
+        pushFrame(control, TX_CONTROL, EVENT_LEN, now);
+        drain(control, now);
+    }
+    expect(control.getStats(TX_CONTROL).sent == 14, "control burst: 14 events at once");
+    release = control.getNextReleaseUs(now);
+    expect(release == now + 1334, "control release rounded up to the next microsecond");
+    expect(control.peek(release - 1, 0) == nullptr, "event still held 1 us before the release");
+    expect(control.peek(release, 0) != nullptr, "event released at the release time");
+}
+
+static void checkRates() {
+    // Telemetry asked at 20 Hz for 10 s: budget plus the initial burst
+    TxScheduler telemetry;
+    int64_t start = 1000000;
+    for (int64_t t = start; t < start + 10000000; t += 1000) {
+        if ((t - start) % 50000 == 0) {
+            pushFrame(telemetry, TX_TELEMETRY, TELEMETRY_LEN, t);
+        }
+        drain(telemetry, t);
+    }
+    const TxClassStats& stats = telemetry.getStats(TX_TELEMETRY);
+    printf("TxScheduler: telemetry at 20 Hz for 10 s | %lu sent, %.1f ms/s airtime, %lu replaced\n",
+           (unsigned long)stats.sent, stats.airtimeUs / 10000.0, (unsigned long)stats.dropped);
+    expect(stats.airtimeUs <= 40000 * 10 + 20000, "telemetry airtime within budget and burst");
+    expect(stats.sent == (40000 * 10 + 20000) / TxScheduler::airtimeUs(TELEMETRY_LEN), "telemetry uses its budget");
+
+    // Runaway event source: 8 events every 100 ms for 10 s
+    TxScheduler control;
+    uint32_t refused = 0;
+    for (int64_t t = start; t < start + 10000000; t += 1000) {
+        if ((t - start) % 100000 == 0) {
+            for (uint8_t i = 0; i < 8; i++) {
+                refused += pushFrame(control, TX_CONTROL, EVENT_LEN, t) == 0;
+            }
+        }
+        drain(control, t);
+    }
+    const TxClassStats& events = control.getStats(TX_CONTROL);
+    printf("TxScheduler: 80 events/s for 10 s | %lu sent, %.1f ms/s airtime, %lu refused\n",
+           (unsigned long)events.sent, events.airtimeUs / 10000.0, (unsigned long)refused);
+    expect(events.airtimeUs <= 60000 * 10 + 40000, "control airtime within budget and burst");
+    expect(refused > 0 && refused == events.dropped, "control: excess events refused, never dropped silently");
+
+    // Normal worst case: 4 events sent at once, then their 2 repeats, all without throttling
+    TxScheduler burst;
+    for (uint8_t i = 0; i < 12; i++) {
+        pushFrame(burst, TX_CONTROL, EVENT_LEN, start);
+        drain(burst, start);
+    }
+    expect(burst.getStats(TX_CONTROL).sent == 12 && burst.getStats(TX_CONTROL).throttled == 0,
+           "4 events and their repeats pass in the control burst");
+}
+
+static void benchmark() {
+    uint32_t n = benchIterations();
+    if (n == 0) {
+        return;
+    }
+    static const TxClass MIX[] = {TX_LIVE, TX_CONTROL, TX_LIVE, TX_TELEMETRY, TX_LIVE, TX_TIME};
+    TxScheduler scheduler;
+    uint8_t data[TELEMETRY_LEN] = {};
+    uint64_t checksum = 0;
+    double start = nowS();
+    for (uint32_t i = 0; i < n; i++) {
+        int64_t now = (int64_t)i * 20000;
+        TxClass txClass = MIX[i % (sizeof(MIX) / sizeof(MIX[0]))];
+        scheduler.push(txClass, data, txClass == TX_LIVE ? LIVE_LEN : TELEMETRY_LEN, false, now);
+        const TxFrame* frame = scheduler.peek(now, 0);
+        if (frame != nullptr) {
+            checksum += frame->len;
+            scheduler.pop(now, true);
+        }
+    }
+    double elapsed = nowS() - start;
+    printf("TxScheduler::push() + peek() + pop(): %.1f ns/frame on this host (check %llu)\n", elapsed * 1e9 / n,
+           (unsigned long long)checksum);
+}
+
+void checkTxScheduler() {
+    checkPriority();
+    checkInFlight();
+    checkFullQueues();
+    checkBucket();
+    checkRates();
+    benchmark();
+}
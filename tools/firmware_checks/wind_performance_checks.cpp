@@ -0,0 +1,160 @@
+/**
+ * Vérifications de WindPerformance (src/WindPerformance.cpp) : vent
+ * lissé, TWA, VMG et polaire
+ *
+ * Le lissage est vérifié contre la constante de temps de 10 s à deux
+ * cadences d'anémomètre, la polaire sur ses nœuds et entre eux, le calcul
+ * par fix contre le cosinus en double.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "checks.h"
+#include "WindPerformance.h"
+
+static const double KNOT_CMS = 51.4444;
+
+static AnemometerPacket anemometer(uint32_t sequence, float knots, float direction) {
+    AnemometerPacket packet;
+    memset(&packet, 0, sizeof(packet));
+    packet.messageType = MSG_ANEMOMETER;
+    strcpy(packet.anemometerId, "WIND1");
+    packet.sequenceNumber = sequence;
+    packet.windSpeed = knots;
+    packet.windDirection = direction;
+    return packet;
+}
+
+static GPSData fix(float knots, float course, uint32_t fixMillis) {
+    GPSData data;
+    memset(&data, 0, sizeof(data));
+    data.latitude = 43.25;
+    data.longitude = 5.3;
+    data.speed = knots;
+    data.course = course;
+    data.valid = true;
+    data.fixMillis = fixMillis;
+    return data;
+}
+
+static void checkWindFrames() {
+    WindPerformance wind;
+    expect(!wind.hasWind(0), "no wind before the first frame");
+    expect(!wind.applyAnemometer(anemometer(1, 150, 90), 1000), "150 knots rejected");
+    expect(!wind.applyAnemometer(anemometer(1, 10, -5), 1000), "negative direction rejected");
+    expect(!wind.applyAnemometer(anemometer(1, NAN, 90), 1000), "NaN speed rejected");
+
+    expect(wind.applyAnemometer(anemometer(1, 10, 90), 1000), "valid frame");
+    expect(wind.getDirectionDeci() == 900 && wind.getSpeedCms() == 514, "first frame taken as is");
+    expect(!wind.applyAnemometer(anemometer(1, 20, 270), 1500), "repeated sequence number ignored");
+    expect(wind.getDirectionDeci() == 900, "repeated frame leaves the wind unchanged");
+
+    expect(wind.hasWind(31000), "wind known 30 s after the last frame");
+    expect(!wind.hasWind(31001), "wind lost after 30 s");
+    wind.applyAnemometer(anemometer(2, 6, 180), 40000);
+    expect(wind.getDirectionDeci() == 1800 && wind.getSpeedCms() == 309, "first frame after a loss taken as is");
+}
+
+static void checkSmoothing() {
+    // Direction averaged on the vector: 350 and 10 degrees give north, never south
+    WindPerformance wind;
+    for (uint32_t i = 0; i < 100; i++) {
+        wind.applyAnemometer(anemometer(i + 1, 10, (i & 1) ? 10.0f : 350.0f), 1000 + i * 1000);
+    }
+    uint16_t direction = wind.getDirectionDeci();
+    expect(direction <= 10 || direction >= 3590, "350 / 10 degree alternation smoothed to north");
+
+    // Speed step 10 -> 20 knots: 63 % of the step after one time constant, at 1 and 5 frames/s
+    for (uint32_t periodMs = 1000; periodMs >= 200; periodMs /= 5) {
+        WindPerformance step;
+        step.applyAnemometer(anemometer(1, 10, 200), 0);
+        uint32_t sequence = 2;
+        for (uint32_t t = periodMs; t <= 10000; t += periodMs) {
+            step.applyAnemometer(anemometer(sequence++, 20, 200), t);
+        }
+        char what[64];
+        snprintf(what, sizeof(what), "speed 10 s after a step, %lu ms frames", (unsigned long)periodMs);
+        expectNear(step.getSpeedCms() / KNOT_CMS, 10 + 10 * (1 - exp(-1.0)), 0.35, what);
+        snprintf(what, sizeof(what), "direction steady through a speed step, %lu ms frames", (unsigned long)periodMs);
+        expect(step.getDirectionDeci() == 2000, what);
+    }
+}
+
+static void checkPolar() {
+    // Grid nodes (table in 0.1 kn): 8 kn / 90 degrees = 2.2 kn, 20 kn / 180 degrees = 2.8 kn
+    expectNear(WindPerformance::targetSpeedCms(80, 900), 2.2 * KNOT_CMS, 1, "polar node 8 kn / 90 degrees");
+    expectNear(WindPerformance::targetSpeedCms(200, 1800), 2.8 * KNOT_CMS, 1, "polar node 20 kn / 180 degrees");
+    expect(WindPerformance::targetSpeedCms(0, 900) == 0, "no wind: no target");
+    expect(WindPerformance::targetSpeedCms(100, 100) == 0, "inside the no-go zone: no target");
+
+    // Halfway between nodes: mean of the neighbours
+    expectNear(WindPerformance::targetSpeedCms(90, 900), (2.2 + 2.5) / 2 * KNOT_CMS, 1, "polar between 8 and 10 kn");
+    expectNear(WindPerformance::targetSpeedCms(80, 975), (2.2 + 2.2) / 2 * KNOT_CMS, 1,
+               "polar between 90 and 105 degrees");
+    expectNear(WindPerformance::targetSpeedCms(90, 975), (2.2 + 2.5 + 2.2 + 2.5) / 4 * KNOT_CMS, 1,
+               "polar between four nodes");
+
+    // Beyond 20 knots: last column
+    expect(WindPerformance::targetSpeedCms(300, 900) == WindPerformance::targetSpeedCms(200, 900),
+           "above 20 kn: last column");
+}
+
+static void checkPerFix() {
+    WindPerformance wind;
+    wind.applyAnemometer(anemometer(1, 8, 0), 1000);
+
+    // Heading 315, wind from the north: 45 degrees over starboard, upwind
+    wind.update(fix(4, 315, 1500));
+    expect(wind.isValid(), "fix with wind is valid");
+    expect(wind.getAngleDeci() == 450, "TWA > 0 with the wind over starboard");
+    expectNear(wind.getVmgCms(), 4 * KNOT_CMS * cos(M_PI / 4), 2, "VMG upwind");
+    expectNear(wind.getTargetCms(), 1.8 * KNOT_CMS, 1, "target at 8 kn / 45 degrees");
+    expectNear(wind.getPolarPermille(), 4 / 1.8 * 1000, 15, "polar ratio");
+
+    // Heading 160: wind 160 degrees over port, downwind
+    wind.update(fix(4, 160, 2000));
+    expect(wind.getAngleDeci() == -1600, "TWA < 0 with the wind over port");
+    expectNear(wind.getVmgCms(), 4 * KNOT_CMS * cos(160 * M_PI / 180), 2, "VMG downwind is negative");
+
+    // Course 359.9 with the wind from 0: no jump through north
+    wind.update(fix(4, 359.9f, 2500));
+    expect(wind.getAngleDeci() == 1, "TWA through north");
+
+    wind.update(fix(0.8f, 315, 3000));
+    expect(!wind.isValid(), "below 1 knot: no TWA");
+    wind.update(fix(4, 315, 31001));
+    expect(!wind.isValid(), "wind lost: no TWA");
+}
+
+static void benchmark() {
+    uint32_t n = benchIterations();
+    if (n == 0) {
+        return;
+    }
+    static const uint32_t SAMPLES = 1024;
+    static GPSData fixes[SAMPLES];
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        fixes[i] = fix(1 + (i % 60) / 10.0f, (i * 37) % 360, 1000);
+    }
+    WindPerformance wind;
+    wind.applyAnemometer(anemometer(1, 9, 215), 1000);
+
+    int64_t checksum = 0;
+    double start = nowS();
+    for (uint32_t i = 0; i < n; i++) {
+        wind.update(fixes[i % SAMPLES]);
+        checksum += wind.getVmgCms() + wind.getPolarPermille();
+    }
+    double elapsed = nowS() - start;
+    printf("WindPerformance::update(): %.1f ns/fix on this host (check %lld)\n", elapsed * 1e9 / n,
+           (long long)(checksum & 0xFFFF));
+}
+
+void checkWindPerformance() {
+    checkWindFrames();
+    checkSmoothing();
+    checkPolar();
+    checkPerFix();
+    benchmark();
+}
@@ -0,0 +1,156 @@
+/**
+ * Diffusion d'une configuration de flotte pour OpenSailingRC-BoatGPS
+ *
+ * Instructions :
+ * 1. Renseigner FLEET_KEY (identique à la clé "fleet_key" des bateaux)
+ * 2. Incrémenter CONFIG_VERSION à chaque nouvelle configuration
+ * 3. Modifier la liste DELTAS (et TARGETS pour viser certains bateaux)
+ * 4. Flasher ce programme sur n'importe quel ESP32 (Atom, AtomS3...)
+ * 5. Ouvrir le Serial Monitor (115200 baud) : la trame est rediffusée
+ *    toutes les 2 secondes et les ACK des bateaux sont affichés
+ *
+ * Les structures ci-dessous sont alignées avec
+ * lib/BoatProtocol/src/BoatProtocol.h et include/Config.h du firmware
+ * BoatGPS.
+ */
+
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <mbedtls/md.h>
+
+// ============================================
+// CONFIGURATION : Modifier ici
+// ============================================
+const char* FLEET_KEY = "change-me";      // Max 32 caractères
+const uint32_t CONFIG_VERSION = 1;        // Doit augmenter à chaque envoi
+const uint8_t CURRENT_CHANNEL = 1;        // Canal actuel des bateaux
+
+// Bateaux visés (vide = tous les bateaux)
+const uint8_t TARGETS[][6] = {
+  // {0xD0, 0xCF, 0x13, 0x0F, 0xD9, 0xDC},
+};
+
+// Clés (voir ConfigKey dans include/Config.h) :
+//  1 = intervalle broadcast (ms)      2 = jitter (ms)
+//  3 = canal WiFi                     4 = nombre de slots TDMA
+//  5 = slot du bateau                 6 = slot = valeur + rang dans TARGETS
+//  7 = profil d'énergie (0/1/2)       8 = économie récepteur GNSS (0/1)
+//  9 = cadence adaptative (0/1)       10 = budget canal (0,1 Hz par bateau)
+// 11 = compte à rebours bouton (s)    12 = fenêtre rapide (s)
+// 13 = intervalle fenêtre rapide (ms)
+// 14/15 = ligne, comité lat/lon     16/17 = ligne, bouée lat/lon (1e-7 degré)
+// 18 = tolérance trace simplifiée (cm)
+// 19 = horizon alerte de proximité (s, 0 = désactivée)
+// 20 = intervalle balise horaire GPS (ms, 0 = désactivée)
+// 21 = canaux du saut de canal (masque, bit n = canal n, 0x0842 = 1, 6, 11)
+// 22 = groupes du saut de canal
+const int32_t DELTAS[][2] = {
+  {1, 500},    // 2 Hz
+  {2, 50},     // ±50 ms
+};
+// ============================================
+
+struct ConfigDelta {
+  uint8_t key;
+  uint8_t reserved[3];
+  int32_t value;
+};
+
+struct ConfigPushPacket {
+  int8_t messageType;        // 3
+  uint8_t targetCount;
+  uint8_t deltaCount;
+  uint8_t reserved;
+  uint32_t configVersion;
+  uint8_t targets[8][6];
+  ConfigDelta deltas[12];
+  uint8_t signature[16];
+};
+
+struct ConfigAckPacket {
+  int8_t messageType;        // 4
+  uint8_t status;
+  uint8_t reserved[2];
+  uint32_t requestedVersion;
+  uint32_t activeVersion;
+};
+
+const char* STATUS_NAMES[] = {
+  "APPLIED", "ALREADY_APPLIED", "BAD_SIGNATURE", "STALE_VERSION",
+  "INVALID_VALUE", "NO_KEY", "PERSIST_FAILED"
+};
+
+ConfigPushPacket packet;
+uint8_t broadcastAddr[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+void onDataRecv(const uint8_t* mac, const uint8_t* data, int len) {
+  if (len != sizeof(ConfigAckPacket) || data[0] != 4) {
+    return;
+  }
+  ConfigAckPacket ack;
+  memcpy(&ack, data, sizeof(ack));
+  Serial.printf("ACK %02X:%02X:%02X:%02X:%02X:%02X  v%lu -> %s (active v%lu)\n",
+                mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
+                ack.requestedVersion,
+                ack.status < 7 ? STATUS_NAMES[ack.status] : "?",
+                ack.activeVersion);
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+
+  Serial.println("\n===========================================");
+  Serial.println("Diffusion configuration de flotte");
+  Serial.println("===========================================\n");
+
+  // Build packet
+  memset(&packet, 0, sizeof(packet));
+  packet.messageType = 3;
+  packet.targetCount = sizeof(TARGETS) / 6;
+  packet.deltaCount = sizeof(DELTAS) / sizeof(DELTAS[0]);
+  packet.configVersion = CONFIG_VERSION;
+  if (packet.targetCount > 8 || packet.deltaCount > 12) {
+    Serial.println("ERREUR : 8 cibles et 12 deltas maximum");
+    return;
+  }
+  memcpy(packet.targets, TARGETS, sizeof(TARGETS));
+  for (uint8_t i = 0; i < packet.deltaCount; i++) {
+    packet.deltas[i].key = DELTAS[i][0];
+    packet.deltas[i].value = DELTAS[i][1];
+  }
+
+  // Sign: HMAC-SHA256 over all bytes before signature, truncated to 16 bytes
+  uint8_t digest[32];
+  mbedtls_md_hmac(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256),
+                  (const unsigned char*)FLEET_KEY, strlen(FLEET_KEY),
+                  (const unsigned char*)&packet, offsetof(ConfigPushPacket, signature),
+                  digest);
+  memcpy(packet.signature, digest, sizeof(packet.signature));
+
+  // ESP-NOW (Long Range, same channel as the boats)
+  WiFi.mode(WIFI_STA);
+  WiFi.disconnect();
+  esp_wifi_set_protocol(WIFI_IF_STA, WIFI_PROTOCOL_11B | WIFI_PROTOCOL_11G | WIFI_PROTOCOL_11N | WIFI_PROTOCOL_LR);
+  esp_wifi_set_channel(CURRENT_CHANNEL, WIFI_SECOND_CHAN_NONE);
+  if (esp_now_init() != ESP_OK) {
+    Serial.println("ERREUR : ESP-NOW init");
+    return;
+  }
+  esp_now_register_recv_cb(onDataRecv);
+
+  esp_now_peer_info_t peerInfo = {};
+  memcpy(peerInfo.peer_addr, broadcastAddr, 6);
+  peerInfo.channel = 0;
+  peerInfo.encrypt = false;
+  esp_now_add_peer(&peerInfo);
+
+  Serial.printf("Version %lu, %d cible(s), %d delta(s), %d octets\n",
+                packet.configVersion, packet.targetCount, packet.deltaCount, sizeof(packet));
+}
+
+void loop() {
+  esp_now_send(broadcastAddr, (uint8_t*)&packet, sizeof(packet));
+  delay(2000);
+}
@@ -0,0 +1,321 @@
+/**
+ * Lecteur de la passerelle ESP-NOW -> USB pour OpenSailingRC-BoatGPS (outil PC)
+ *
+ * Instructions :
+ * 1. Compiler : pio run -e native-gateway-reader
+ *    (programme : .pio/build/native-gateway-reader/program)
+ * 2. Passerelle réelle : --device /dev/ttyACM0 (AtomS3) ou /dev/ttyUSB0
+ *    --baud 921600 (Atom), firmware en mode passerelle (voir GATEWAY.md)
+ * 3. Simulateur : --file FICHIER, sortie --console-out du simulateur
+ *    lancé avec --nvs boatgps.mode=gateway
+ * 4. --capture FICHIER : trames au format de capture du simulateur,
+ *    rejouables par log_replay (heure = heure de réception)
+ *
+ * Affiche les compteurs de la passerelle (pertes à chaque étage), puis
+ * par émetteur : trames, RSSI, numéros de séquence manquants des
+ * positions (pertes radio que la passerelle ne voit pas).
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <map>
+#include <string>
+#include "BoatCodec.h"
+#include "FileRadio.h"
+#include "GatewayLink.h"
+#include "SerialPort.h"
+
+static const char* USAGE =
+    "Usage: %s (--device DEV | --file FILE) [options]\n"
+    "  --device DEV         Gateway on a serial device (Ctrl-C to stop)\n"
+    "  --baud N             Device speed (default 921600; ignored by USB CDC)\n"
+    "  --file FILE          Recorded gateway output (simulator --console-out, - = stdin)\n"
+    "  --capture FILE       Received frames in the simulator capture format\n"
+    "  --duration S         Stop after S seconds (device)\n"
+    "  --report S           Gateway counters period (default 5 s, 0 = end only)\n";
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void onInterrupt(int) {
+    interrupted = 1;
+}
+
+static void usage(const char* program, int code) {
+    fprintf(code == 0 ? stdout : stderr, USAGE, program);
+    exit(code);
+}
+
+/**
+ * @brief Frames of one sender
+ */
+struct Sender {
+    std::string name;
+    uint32_t frames = 0;
+    uint32_t positions = 0;
+    uint32_t lastSequence = 0;
+    uint32_t missing = 0;              // Sequence numbers never received
+    uint32_t repeats = 0;              // Sequence number not above the last one
+    uint32_t rssiCount = 0;
+    int32_t rssiSum = 0;
+    int8_t rssiMin = 127;
+    int8_t rssiMax = -128;
+};
+
+/**
+ * @brief Last counters record of the gateway
+ */
+struct GatewayCounters {
+    bool valid = false;
+    uint64_t timeUs = 0;
+    uint32_t received = 0;
+    uint32_t forwarded = 0;
+    uint32_t ringDropped = 0;
+    uint32_t serialDropped = 0;
+    uint32_t invalid = 0;
+    uint32_t rssiMissing = 0;
+    uint16_t ringHighWater = 0;
+    uint16_t ringSize = 0;
+    uint8_t channel = 0;
+};
+
+static std::map<std::string, Sender> senders;
+static GatewayCounters counters;
+static GatewayCounters reported;       // At the previous report (rate)
+static uint32_t records = 0;
+static uint64_t firstUs = 0;
+static uint64_t lastUs = 0;
+static FILE* capture = nullptr;
+
+static std::string macText(const uint8_t* mac) {
+    char text[18];
+    snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    return text;
+}
+
+static void applyFrame(const uint8_t* payload, size_t len) {
+    if (len < GatewayFrameWire::DATA) {
+        return;
+    }
+    SimFrame frame;
+    frame.timeUs = GatewayLink::get64(payload + GatewayFrameWire::TIME_US);
+    memcpy(frame.mac, payload + GatewayFrameWire::MAC, 6);
+    frame.channel = payload[GatewayFrameWire::CHANNEL];
+    frame.len = (uint8_t)(len - GatewayFrameWire::DATA);
+    memcpy(frame.data, payload + GatewayFrameWire::DATA, frame.len);
+    int8_t rssi = (int8_t)payload[GatewayFrameWire::RSSI];
+
+    if (records == 0) {
+        firstUs = frame.timeUs;
+    }
+    records++;
+    lastUs = frame.timeUs;
+
+    Sender& sender = senders[macText(frame.mac)];
+    sender.frames++;
+    if (rssi != GATEWAY_RSSI_UNKNOWN) {
+        sender.rssiCount++;
+        sender.rssiSum += rssi;
+        sender.rssiMin = rssi < sender.rssiMin ? rssi : sender.rssiMin;
+        sender.rssiMax = rssi > sender.rssiMax ? rssi : sender.rssiMax;
+    }
+    GPSBroadcastPacket packet;
+    if (BoatCodec::decode(frame.data, frame.len, packet) == DECODE_OK && packet.ttl > 0) {
+        if (sender.positions > 0) {
+            if (packet.sequenceNumber > sender.lastSequence) {
+                sender.missing += packet.sequenceNumber - sender.lastSequence - 1;
+            } else {
+                sender.repeats++;
+            }
+        }
+        if (sender.positions == 0 || packet.sequenceNumber > sender.lastSequence) {
+            sender.lastSequence = packet.sequenceNumber;
+        }
+        sender.positions++;
+        sender.name = packet.name;
+    }
+
+    if (capture != nullptr) {
+        char line[600];
+        FileRadio::formatFrame(frame, line, sizeof(line));
+        fputs(line, capture);
+        fputc('\n', capture);
+    }
+}
+
+static void applyStats(const uint8_t* payload, size_t len) {
+    if (len < GatewayStatsWire::SIZE) {
+        return;
+    }
+    counters.valid = true;
+    counters.timeUs = GatewayLink::get64(payload + GatewayStatsWire::TIME_US);
+    counters.received = BoatCodec::get32(payload + GatewayStatsWire::RECEIVED);
+    counters.forwarded = BoatCodec::get32(payload + GatewayStatsWire::FORWARDED);
+    counters.ringDropped = BoatCodec::get32(payload + GatewayStatsWire::RING_DROPPED);
+    counters.serialDropped = BoatCodec::get32(payload + GatewayStatsWire::SERIAL_DROPPED);
+    counters.invalid = BoatCodec::get32(payload + GatewayStatsWire::INVALID);
+    counters.rssiMissing = BoatCodec::get32(payload + GatewayStatsWire::RSSI_MISSING);
+    counters.ringHighWater = BoatCodec::get16(payload + GatewayStatsWire::RING_HIGH_WATER);
+    counters.ringSize = BoatCodec::get16(payload + GatewayStatsWire::RING_SIZE);
+    counters.channel = payload[GatewayStatsWire::CHANNEL];
+}
+
+static void printCounters() {
+    if (!counters.valid) {
+        fprintf(stderr, "gateway: no counters record yet\n");
+        return;
+    }
+    double seconds = (counters.timeUs - reported.timeUs) / 1e6;
+    fprintf(stderr,
+            "gateway %.1f s: channel %u, %u received (%.0f/s), %u forwarded | dropped: ring %u, serial %u | "
+            "%u invalid, %u without RSSI | ring high water %u/%u\n",
+            counters.timeUs / 1e6, counters.channel, counters.received,
+            seconds > 0 ? (counters.received - reported.received) / seconds : 0.0, counters.forwarded,
+            counters.ringDropped, counters.serialDropped, counters.invalid, counters.rssiMissing,
+            counters.ringHighWater, counters.ringSize);
+    reported = counters;
+}
+
+static void printSummary(const GatewayLink::Parser& parser) {
+    double seconds = (lastUs - firstUs) / 1e6;
+    fprintf(stderr, "gateway_reader: %u frames from %zu senders over %.1f s (%.0f frames/s), "
+                    "%u bytes outside records, %u bad records\n",
+            records, senders.size(), seconds, seconds > 0 ? records / seconds : 0.0, parser.getSkipped(),
+            parser.getCrcErrors());
+    uint32_t missing = 0;
+    for (const auto& entry : senders) {
+        const Sender& sender = entry.second;
+        missing += sender.missing;
+        if (senders.size() > 20) {
+            continue;
+        }
+        fprintf(stderr, "  %s %-17s %6u frames", entry.first.c_str(), sender.name.c_str(), sender.frames);
+        if (sender.positions > 0) {
+            fprintf(stderr, ", %u positions, %u missing, %u repeats", sender.positions, sender.missing,
+                    sender.repeats);
+        }
+        if (sender.rssiCount > 0) {
+            fprintf(stderr, ", RSSI %.0f dBm (%d to %d)", (double)sender.rssiSum / sender.rssiCount, sender.rssiMin,
+                    sender.rssiMax);
+        }
+        fputc('\n', stderr);
+    }
+    if (senders.size() > 20) {
+        fprintf(stderr, "  (%zu senders, details omitted)\n", senders.size());
+    }
+    fprintf(stderr, "  position sequence numbers missing: %u\n", missing);
+    reported = GatewayCounters();
+    printCounters();
+}
+
+int main(int argc, char** argv) {
+    const char* devicePath = nullptr;
+    const char* filePath = nullptr;
+    const char* capturePath = nullptr;
+    unsigned long baud = 921600;
+    double durationS = 0;
+    double reportS = 5;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            usage(argv[0], 0);
+        } else if (strcmp(arg, "--device") == 0 && hasValue) {
+            devicePath = argv[++i];
+        } else if (strcmp(arg, "--baud") == 0 && hasValue) {
+            baud = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(arg, "--file") == 0 && hasValue) {
+            filePath = argv[++i];
+        } else if (strcmp(arg, "--capture") == 0 && hasValue) {
+            capturePath = argv[++i];
+        } else if (strcmp(arg, "--duration") == 0 && hasValue) {
+            durationS = atof(argv[++i]);
+        } else if (strcmp(arg, "--report") == 0 && hasValue) {
+            reportS = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            usage(argv[0], 1);
+        }
+    }
+    if ((devicePath == nullptr) == (filePath == nullptr)) {
+        fprintf(stderr, "One input: --device or --file\n");
+        usage(argv[0], 1);
+    }
+
+    int fd;
+    if (devicePath != nullptr) {
+        fd = SerialPort::open(devicePath, baud, O_RDONLY | O_NOCTTY);
+    } else if (strcmp(filePath, "-") == 0) {
+        fd = STDIN_FILENO;
+    } else {
+        fd = ::open(filePath, O_RDONLY);
+        if (fd < 0) {
+            fprintf(stderr, "Cannot open %s: %s\n", filePath, strerror(errno));
+        }
+    }
+    if (fd < 0) {
+        return 1;
+    }
+    if (capturePath != nullptr) {
+        capture = strcmp(capturePath, "-") == 0 ? stdout : fopen(capturePath, "w");
+        if (capture == nullptr) {
+            fprintf(stderr, "Cannot create %s\n", capturePath);
+            return 1;
+        }
+    }
+    signal(SIGINT, onInterrupt);
+    signal(SIGTERM, onInterrupt);
+
+    GatewayLink::Parser parser;
+    uint8_t buffer[16384];
+    uint64_t startUs = SerialPort::monotonicUs();
+    uint64_t nextReportUs = startUs + (uint64_t)(reportS * 1e6);
+    while (!interrupted) {
+        uint64_t now = SerialPort::monotonicUs();
+        if (durationS > 0 && now - startUs >= (uint64_t)(durationS * 1e6)) {
+            break;
+        }
+        if (devicePath != nullptr && reportS > 0 && now >= nextReportUs) {
+            nextReportUs += (uint64_t)(reportS * 1e6);
+            printCounters();
+        }
+        if (devicePath != nullptr) {
+            struct pollfd waiting = {fd, POLLIN, 0};
+            if (poll(&waiting, 1, 100) <= 0) {
+                continue;
+            }
+        }
+        ssize_t count = read(fd, buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            if (count < 0) {
+                fprintf(stderr, "Read error: %s\n", strerror(errno));
+            }
+            break;
+        }
+        for (ssize_t i = 0; i < count; i++) {
+            if (!parser.push(buffer[i])) {
+                continue;
+            }
+            if (parser.type() == GATEWAY_RECORD_FRAME) {
+                applyFrame(parser.payload(), parser.length());
+            } else if (parser.type() == GATEWAY_RECORD_STATS) {
+                applyStats(parser.payload(), parser.length());
+            }
+        }
+    }
+
+    if (capture != nullptr && capture != stdout) {
+        fclose(capture);
+    }
+    printSummary(parser);
+    return 0;
+}
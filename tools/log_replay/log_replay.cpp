@@ -0,0 +1,544 @@
+/**
+ * Rejeu de logs en trames ESP-NOW pour OpenSailingRC-BoatGPS (outil PC)
+ *
+ * Instructions :
+ * 1. Compiler : pio run -e native-log-replay
+ *    (programme : .pio/build/native-log-replay/program)
+ * 2. Choisir les logs : --json gps_*.json (log SD d'un bateau, un par
+ *    bateau) et/ou --capture FICHIER (trames capturées par le simulateur,
+ *    rejouées à l'octet près, tous les bateaux du fichier)
+ * 3. Réseau : --udp 239.255.0.42:5042, reçu par le simulateur
+ *    (--radio-udp) et les outils du même groupe (voir SIMULATOR.md)
+ * 4. Radio réelle : --bridge /dev/ttyUSB0 --baud 921600 sur un ESP32
+ *    flashé avec tools/espnow_bridge
+ *
+ * Les bateaux gardent leurs écarts de temps d'origine ; --speed accélère
+ * le rejeu (1 à 100), --clones multiplie la flotte pour les essais de
+ * charge. L'échéancier est une roue de temporisation
+ * (sim/include/TimerWheel.h) : voir LOG_REPLAY.md.
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "BoatCodec.h"
+#include "FileRadio.h"
+#include "SerialPort.h"
+#include "TimerWheel.h"
+#include "UdpRadio.h"
+
+static const char* USAGE =
+    "Usage: %s [options]\n"
+    "Logs (repeatable, at least one):\n"
+    "  --json FILE[,NAME]   SD log gps_<MAC>_*.json of one boat (name: MAC by default)\n"
+    "  --capture FILE       Simulator radio capture (--radio-out), frames replayed byte for byte\n"
+    "Replay:\n"
+    "  --speed X            Replay speed, 1 to 100 (default 1)\n"
+    "  --channel N          WiFi channel of the frames built from JSON logs (default 1)\n"
+    "  --clones N           N extra copies of each boat (MAC and name changed, spread over 1 s)\n"
+    "  --loop               Start again at the end of the logs\n"
+    "  --duration S         Stop after S seconds\n"
+    "Output (none: scheduling only, for benchmarks):\n"
+    "  --udp G:PORT         UDP multicast group of the simulator (--radio-udp)\n"
+    "  --bridge DEVICE      ESP32 running tools/espnow_bridge\n"
+    "  --baud N             Bridge speed (default 921600)\n"
+    "  --report S           Statistics period (default 5 s)\n";
+
+static const uint32_t TICK_US = 1000;            // Timer wheel tick
+static const uint64_t SPIN_US = 50;              // Closer than this to the due time: sent without sleeping
+static const uint64_t LATE_US = 1000;            // Lateness counted as late
+static const uint64_t LOOP_GAP_US = 1000000;     // Pause between two passes of --loop (log time)
+static const uint64_t CLONE_SPREAD_US = 1000000; // Clones spread over one second
+static const uint8_t BRIDGE_SYNC[2] = {0xA5, 0x5A};
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void onInterrupt(int) {
+    interrupted = 1;
+}
+
+static void usage(const char* program, int code) {
+    fprintf(code == 0 ? stdout : stderr, USAGE, program);
+    exit(code);
+}
+
+/**
+ * @brief Frames of one sender, in log time
+ */
+struct BoatStream {
+    std::string label;
+    std::vector<SimFrame> frames;      // timeUs: time in the log (absolute for JSON, virtual for captures)
+    uint64_t originUs;                 // Log time of the replay start (shared by the logs of the same kind)
+    uint64_t shiftUs;                  // Clone offset (replay time)
+    size_t next;
+    uint32_t pass;
+};
+
+/**
+ * @brief Number after "key": in a JSON line (ArduinoJson output, no spaces)
+ */
+static bool jsonNumber(const char* line, const char* key, double& value) {
+    char pattern[40];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char* found = strstr(line, pattern);
+    if (found == nullptr) {
+        return false;
+    }
+    char* end;
+    value = strtod(found + strlen(pattern), &end);
+    return end != found + strlen(pattern);
+}
+
+/**
+ * @brief MAC of a log file name gps_D0CF130FD9DC_... (Storage::generateFilename)
+ */
+static bool macFromFileName(const char* path, uint8_t mac[6]) {
+    const char* base = strrchr(path, '/');
+    base = (base != nullptr) ? base + 1 : path;
+    if (strncmp(base, "gps_", 4) != 0 || strlen(base) < 16) {
+        return false;
+    }
+    for (int i = 0; i < 6; i++) {
+        char byte[3] = {base[4 + 2 * i], base[5 + 2 * i], 0};
+        if (!isxdigit((unsigned char)byte[0]) || !isxdigit((unsigned char)byte[1])) {
+            return false;
+        }
+        mac[i] = (uint8_t)strtoul(byte, nullptr, 16);
+    }
+    return true;
+}
+
+/**
+ * @brief Boat frames of a JSON log, built like Communication::broadcastGPSData()
+ *
+ * The log keeps whole seconds: the records of one second are spread
+ * evenly over it, and the announced rate (rateDeciHz) is their number
+ * per second (or the inverse of the gap for slower logs).
+ */
+static bool loadJson(const char* spec, uint8_t channel, BoatStream& stream) {
+    std::string path = spec;
+    std::string name;
+    size_t comma = path.find(',');
+    if (comma != std::string::npos) {
+        name = path.substr(comma + 1);
+        path.resize(comma);
+    }
+    uint8_t mac[6];
+    if (!macFromFileName(path.c_str(), mac)) {
+        fprintf(stderr, "%s: no MAC in the file name (gps_<MAC>_<date>.json expected)\n", path.c_str());
+        return false;
+    }
+    if (name.empty()) {
+        char macStr[18];
+        snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4],
+                 mac[5]);
+        name = macStr;
+    }
+    FILE* file = fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        fprintf(stderr, "Cannot open %s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    std::vector<GPSBroadcastPacket> packets;
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        const char* boat = strstr(line, "\"boat\":");
+        double type, timestamp, sequence, latitude, longitude, speed, heading, satellites;
+        double quality = 0;
+        if (boat == nullptr || !jsonNumber(line, "type", type) || type != MSG_BOAT ||
+            !jsonNumber(boat, "gpsTimestamp", timestamp) || !jsonNumber(boat, "sequenceNumber", sequence) ||
+            !jsonNumber(boat, "latitude", latitude) || !jsonNumber(boat, "longitude", longitude) ||
+            !jsonNumber(boat, "speed", speed) || !jsonNumber(boat, "heading", heading) ||
+            !jsonNumber(boat, "satellites", satellites)) {
+            continue;  // Events, manoeuvres, summaries, truncated last line
+        }
+        jsonNumber(boat, "quality", quality);
+
+        GPSBroadcastPacket packet;
+        memset(&packet, 0, sizeof(packet));
+        packet.messageType = MSG_BOAT;
+        strncpy(packet.name, name.c_str(), sizeof(packet.name) - 1);
+        packet.sequenceNumber = (uint32_t)sequence;
+        packet.gpsTimestamp = (uint32_t)timestamp;
+        packet.latitude = (float)latitude;
+        packet.longitude = (float)longitude;
+        packet.speed = (float)speed;
+        packet.heading = (float)heading;
+        packet.satellites = (uint8_t)satellites;
+        packet.ttl = 1;
+        packet.quality = (uint8_t)quality;
+        packets.push_back(packet);
+    }
+    fclose(file);
+    if (packets.empty()) {
+        fprintf(stderr, "%s: no boat record\n", path.c_str());
+        return false;
+    }
+
+    stream.label = name;
+    for (size_t first = 0; first < packets.size();) {
+        uint32_t second = packets[first].gpsTimestamp;
+        size_t count = 1;
+        while (first + count < packets.size() && packets[first + count].gpsTimestamp == second) {
+            count++;
+        }
+        uint8_t rateDeciHz;
+        if (count > 1) {
+            rateDeciHz = (uint8_t)(count * 10 > 255 ? 255 : count * 10);
+        } else if (first + 1 < packets.size() && packets[first + 1].gpsTimestamp > second) {
+            rateDeciHz = (uint8_t)lround(10.0 / (packets[first + 1].gpsTimestamp - second));
+        } else {
+            rateDeciHz = (first > 0) ? stream.frames.back().data[BoatWire::RATE] : 10;
+        }
+        for (size_t i = 0; i < count; i++) {
+            GPSBroadcastPacket& packet = packets[first + i];
+            packet.rateDeciHz = rateDeciHz;
+            SimFrame frame;
+            frame.timeUs = (uint64_t)second * 1000000ULL + i * 1000000ULL / count;
+            frame.channel = channel;
+            memcpy(frame.mac, mac, 6);
+            frame.len = (uint8_t)BoatCodec::encode(packet, frame.data, sizeof(frame.data));
+            stream.frames.push_back(frame);
+        }
+        first += count;
+    }
+    return true;
+}
+
+/**
+ * @brief Frames of a simulator capture, one stream per sender
+ */
+static bool loadCapture(const char* path, std::vector<BoatStream>& streams) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    size_t firstStream = streams.size();
+    char line[640];
+    unsigned lineNumber = 0;
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        lineNumber++;
+        size_t len = strcspn(line, "\r\n");
+        line[len] = 0;
+        if (len == 0 || line[0] == '#') {
+            continue;
+        }
+        SimFrame frame;
+        if (!FileRadio::parseFrame(line, frame)) {
+            fprintf(stderr, "%s:%u: malformed frame\n", path, lineNumber);
+            fclose(file);
+            return false;
+        }
+        size_t s = firstStream;
+        while (s < streams.size() && memcmp(streams[s].frames[0].mac, frame.mac, 6) != 0) {
+            s++;
+        }
+        if (s == streams.size()) {
+            char label[40];
+            snprintf(label, sizeof(label), "%02x:%02x:%02x:%02x:%02x:%02x", frame.mac[0], frame.mac[1], frame.mac[2],
+                     frame.mac[3], frame.mac[4], frame.mac[5]);
+            streams.push_back(BoatStream());
+            streams.back().label = label;
+        }
+        streams[s].frames.push_back(frame);
+    }
+    fclose(file);
+    if (streams.size() == firstStream) {
+        fprintf(stderr, "%s: no frame\n", path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Copy k of a boat: MAC + k on the last three bytes, name suffix "~k" on boat frames
+ */
+static BoatStream makeClone(const BoatStream& original, uint32_t k, uint32_t clones) {
+    BoatStream clone = original;
+    char suffix[12];
+    snprintf(suffix, sizeof(suffix), "~%u", k);
+    clone.label += suffix;
+    clone.shiftUs = original.shiftUs + (uint64_t)k * CLONE_SPREAD_US / (clones + 1);
+    for (SimFrame& frame : clone.frames) {
+        uint32_t low = ((uint32_t)frame.mac[3] << 16 | frame.mac[4] << 8 | frame.mac[5]) + k;
+        frame.mac[3] = (uint8_t)(low >> 16);
+        frame.mac[4] = (uint8_t)(low >> 8);
+        frame.mac[5] = (uint8_t)low;
+        if (frame.len >= BoatWire::SIZE && frame.data[BoatWire::TYPE] == MSG_BOAT) {
+            char* name = (char*)frame.data + BoatWire::NAME;
+            size_t keep = strnlen(name, sizeof(GPSBroadcastPacket::name) - 1);
+            keep = std::min(keep, sizeof(GPSBroadcastPacket::name) - 1 - strlen(suffix));
+            memcpy(name + keep, suffix, strlen(suffix) + 1);
+        }
+    }
+    return clone;
+}
+
+/**
+ * @brief Frame on the serial line of tools/espnow_bridge
+ */
+static bool sendToBridge(int fd, const SimFrame& frame) {
+    uint8_t buffer[2 + 2 + 250 + 1];
+    buffer[0] = BRIDGE_SYNC[0];
+    buffer[1] = BRIDGE_SYNC[1];
+    buffer[2] = frame.channel;
+    buffer[3] = frame.len;
+    uint8_t checksum = frame.channel ^ frame.len;
+    for (uint8_t i = 0; i < frame.len; i++) {
+        buffer[4 + i] = frame.data[i];
+        checksum ^= frame.data[i];
+    }
+    buffer[4 + frame.len] = checksum;
+    return SerialPort::writeAll(fd, buffer, 5 + frame.len);
+}
+
+/**
+ * @brief Lines sent back by the bridge, copied to stderr
+ */
+static void echoBridge(int fd, std::string& pending) {
+    char buffer[256];
+    struct pollfd readable = {fd, POLLIN, 0};
+    while (poll(&readable, 1, 0) > 0 && (readable.revents & POLLIN) != 0) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n <= 0) {
+            break;
+        }
+        pending.append(buffer, (size_t)n);
+    }
+    size_t end;
+    while ((end = pending.find('\n')) != std::string::npos) {
+        std::string line = pending.substr(0, end);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        fprintf(stderr, "%s\n", line.c_str());
+        pending.erase(0, end + 1);
+    }
+}
+
+/**
+ * @brief Scheduling accuracy over a window or the whole replay
+ */
+struct ReplayStats {
+    uint64_t frames = 0;
+    uint64_t late = 0;
+    uint64_t latenessSumUs = 0;
+    uint64_t maxLatenessUs = 0;
+
+    void add(uint64_t latenessUs) {
+        frames++;
+        latenessSumUs += latenessUs;
+        if (latenessUs > maxLatenessUs) {
+            maxLatenessUs = latenessUs;
+        }
+        if (latenessUs > LATE_US) {
+            late++;
+        }
+    }
+
+    void print(const char* label, double seconds) const {
+        fprintf(stderr, "%s: %llu frames in %.1f s = %.0f frames/s, lateness mean %.3f ms, max %.3f ms, %llu > 1 ms\n",
+                label, (unsigned long long)frames, seconds, seconds > 0 ? frames / seconds : 0,
+                frames > 0 ? latenessSumUs / 1000.0 / frames : 0, maxLatenessUs / 1000.0, (unsigned long long)late);
+    }
+};
+
+int main(int argc, char** argv) {
+    std::vector<const char*> jsonSpecs;
+    std::vector<const char*> capturePaths;
+    double speed = 1;
+    unsigned channel = 1;
+    unsigned clones = 0;
+    bool loop = false;
+    double durationS = 0;
+    const char* udpAddress = nullptr;
+    const char* bridgePath = nullptr;
+    unsigned long baud = 921600;
+    double reportS = 5;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            usage(argv[0], 0);
+        } else if (strcmp(arg, "--json") == 0 && hasValue) {
+            jsonSpecs.push_back(argv[++i]);
+        } else if (strcmp(arg, "--capture") == 0 && hasValue) {
+            capturePaths.push_back(argv[++i]);
+        } else if (strcmp(arg, "--speed") == 0 && hasValue) {
+            speed = atof(argv[++i]);
+        } else if (strcmp(arg, "--channel") == 0 && hasValue) {
+            channel = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(arg, "--clones") == 0 && hasValue) {
+            clones = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(arg, "--loop") == 0) {
+            loop = true;
+        } else if (strcmp(arg, "--duration") == 0 && hasValue) {
+            durationS = atof(argv[++i]);
+        } else if (strcmp(arg, "--udp") == 0 && hasValue) {
+            udpAddress = argv[++i];
+        } else if (strcmp(arg, "--bridge") == 0 && hasValue) {
+            bridgePath = argv[++i];
+        } else if (strcmp(arg, "--baud") == 0 && hasValue) {
+            baud = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(arg, "--report") == 0 && hasValue) {
+            reportS = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            usage(argv[0], 1);
+        }
+    }
+    if (jsonSpecs.empty() && capturePaths.empty()) {
+        fprintf(stderr, "No log: --json or --capture\n");
+        usage(argv[0], 1);
+    }
+    if (speed < 1 || speed > 100 || channel < 1 || channel > 14 || clones > 65535 || reportS <= 0) {
+        fprintf(stderr, "Bad value: --speed 1 to 100, --channel 1 to 14, --clones 0 to 65535\n");
+        return 1;
+    }
+
+    // Logs: JSON streams share the earliest GPS time, captures the virtual time 0
+    std::vector<BoatStream> streams;
+    uint64_t jsonOriginUs = UINT64_MAX;
+    for (const char* spec : jsonSpecs) {
+        streams.push_back(BoatStream());
+        if (!loadJson(spec, (uint8_t)channel, streams.back())) {
+            return 1;
+        }
+        jsonOriginUs = std::min(jsonOriginUs, streams.back().frames[0].timeUs);
+    }
+    size_t jsonStreams = streams.size();
+    for (const char* path : capturePaths) {
+        if (!loadCapture(path, streams)) {
+            return 1;
+        }
+    }
+    uint64_t spanUs = 0;
+    for (size_t s = 0; s < streams.size(); s++) {
+        streams[s].originUs = (s < jsonStreams) ? jsonOriginUs : 0;
+        streams[s].shiftUs = 0;
+        streams[s].next = 0;
+        streams[s].pass = 0;
+        spanUs = std::max(spanUs, streams[s].frames.back().timeUs - streams[s].originUs);
+    }
+    size_t originals = streams.size();
+    for (uint32_t k = 1; k <= clones; k++) {
+        for (size_t s = 0; s < originals; s++) {
+            streams.push_back(makeClone(streams[s], k, clones));
+        }
+    }
+    uint64_t periodUs = spanUs + LOOP_GAP_US;  // --loop: the fleet restarts together
+
+    size_t frameCount = 0;
+    for (const BoatStream& stream : streams) {
+        frameCount += stream.frames.size();
+    }
+    fprintf(stderr, "log_replay: %zu senders (%zu from logs), %zu frames over %.1f s, x%g = %.1f s\n", streams.size(),
+            originals, frameCount, spanUs / 1e6, speed, spanUs / 1e6 / speed);
+    for (size_t s = 0; s < originals; s++) {
+        fprintf(stderr, "  %s: %zu frames\n", streams[s].label.c_str(), streams[s].frames.size());
+    }
+
+    UdpRadio radio;
+    if (udpAddress != nullptr && !radio.open(udpAddress)) {
+        return 1;
+    }
+    int bridgeFd = -1;
+    if (bridgePath != nullptr) {
+        bridgeFd = SerialPort::open(bridgePath, baud, O_RDWR);  // Blocking writes: the line paces the replay
+        if (bridgeFd < 0) {
+            return 1;
+        }
+    }
+    signal(SIGINT, onInterrupt);
+    signal(SIGTERM, onInterrupt);
+
+    // One pending event per stream: its next frame, in replay time (µs since the start)
+    TimerWheel wheel(TICK_US);
+    auto dueUs = [&](const BoatStream& stream) {
+        const SimFrame& frame = stream.frames[stream.next];
+        double logUs = (double)(frame.timeUs - stream.originUs) + (double)stream.pass * periodUs;
+        return (uint64_t)(logUs / speed) + stream.shiftUs;
+    };
+    for (uint32_t s = 0; s < streams.size(); s++) {
+        wheel.schedule(s, dueUs(streams[s]));
+    }
+
+    uint64_t startUs = SerialPort::monotonicUs();
+    uint64_t endUs = (durationS > 0) ? (uint64_t)(durationS * 1e6) : UINT64_MAX;
+    uint64_t reportUs = (uint64_t)(reportS * 1e6);
+    uint64_t nextReportUs = reportUs;
+    uint64_t windowStartUs = 0;
+    ReplayStats window;
+    ReplayStats total;
+    std::vector<TimerWheel::Event> fired;
+    std::string bridgeLine;
+    bool writeError = false;
+
+    while (wheel.size() > 0 && !interrupted && !writeError) {
+        uint64_t tickUs = wheel.currentTickUs();
+        if (tickUs >= endUs) {
+            break;
+        }
+        if (startUs + tickUs > SerialPort::monotonicUs()) {
+            SerialPort::sleepUntilUs(startUs + tickUs);
+        }
+        wheel.advance(fired);
+        for (const TimerWheel::Event& event : fired) {
+            BoatStream& stream = streams[event.id];
+            uint64_t now = SerialPort::monotonicUs() - startUs;
+            if (event.dueUs > now + SPIN_US) {
+                SerialPort::sleepUntilUs(startUs + event.dueUs);
+                now = SerialPort::monotonicUs() - startUs;
+            }
+            const SimFrame& frame = stream.frames[stream.next];
+            if (udpAddress != nullptr) {
+                radio.transmit(frame);
+            }
+            if (bridgeFd >= 0 && !sendToBridge(bridgeFd, frame)) {
+                fprintf(stderr, "Bridge write error: %s\n", strerror(errno));
+                writeError = true;
+            }
+            uint64_t latenessUs = (now > event.dueUs) ? now - event.dueUs : 0;
+            window.add(latenessUs);
+            total.add(latenessUs);
+
+            stream.next++;
+            if (stream.next == stream.frames.size() && loop) {
+                stream.next = 0;
+                stream.pass++;
+            }
+            if (stream.next < stream.frames.size()) {
+                wheel.schedule(event.id, dueUs(stream));
+            }
+        }
+        if (bridgeFd >= 0) {
+            echoBridge(bridgeFd, bridgeLine);
+        }
+        if (tickUs >= nextReportUs) {
+            window.print("log_replay", (tickUs - windowStartUs) / 1e6);
+            window = ReplayStats();
+            windowStartUs = tickUs;
+            nextReportUs += reportUs;
+        }
+    }
+
+    double elapsedS = (SerialPort::monotonicUs() - startUs) / 1e6;
+    total.print("log_replay total", elapsedS);
+    if (bridgeFd >= 0) {
+        close(bridgeFd);
+    }
+    return writeError ? 1 : 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * Générateur NMEA synthétique pour OpenSailingRC-BoatGPS (outil PC)
+ *
+ * Instructions :
+ * 1. Compiler : pio run -e native-nmea-gen
+ *    (programme : .pio/build/native-nmea-gen/program)
+ * 2. Choisir la trajectoire : log enregistré (--log) ou parcours
+ *    paramétrique (--legs), puis la cadence, le talker, les phrases et
+ *    les défauts (voir --help et NMEA_GENERATOR.md)
+ * 3. Simulateur : écrire un fichier (--out) et le passer à --nmea
+ * 4. Carte réelle : --serial /dev/ttyUSB0 --baud 9600 sur l'adaptateur
+ *    USB-série branché à la place du GPS (RX du firmware), en temps réel
+ *
+ * La bibliothèque (Trajectory, NmeaGenerator) est dans
+ * sim/include/NmeaGenerator.h.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "NmeaGenerator.h"
+#include "SerialPort.h"
+
+static const char* USAGE =
+    "Usage: %s [options]\n"
+    "%s"
+    "Output:\n"
+    "  --out FILE           Output file (default: standard output)\n"
+    "  --serial DEVICE      Serial port (USB bridge), implies --realtime\n"
+    "  --baud N             Serial port speed (default 9600)\n"
+    "  --realtime           Send each epoch at its time\n";
+
+static void usage(const char* program, int code) {
+    fprintf(code == 0 ? stdout : stderr, USAGE, program, NmeaGenOptions::USAGE);
+    exit(code);
+}
+
+int main(int argc, char** argv) {
+    NmeaGenOptions options;
+    const char* outPath = nullptr;
+    const char* serialPath = nullptr;
+    unsigned long baud = 9600;
+    bool realtime = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        int parsed = options.parse(argc, argv, i);
+        if (parsed < 0) {
+            fprintf(stderr, "Bad value for %s\n", arg);
+            usage(argv[0], 1);
+        } else if (parsed > 0) {
+            continue;
+        } else if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            usage(argv[0], 0);
+        } else if (strcmp(arg, "--out") == 0 && hasValue) {
+            outPath = argv[++i];
+        } else if (strcmp(arg, "--serial") == 0 && hasValue) {
+            serialPath = argv[++i];
+            realtime = true;
+        } else if (strcmp(arg, "--baud") == 0 && hasValue) {
+            baud = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(arg, "--realtime") == 0) {
+            realtime = true;
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            usage(argv[0], 1);
+        }
+    }
+
+    Trajectory trajectory;
+    NmeaGenerator generator(trajectory);
+    if (!options.apply(trajectory, generator)) {
+        return 1;
+    }
+
+    int fd = STDOUT_FILENO;
+    if (serialPath != nullptr) {
+        fd = SerialPort::open(serialPath, baud, O_WRONLY);
+    } else if (outPath != nullptr) {
+        fd = open(outPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            fprintf(stderr, "Cannot create %s: %s\n", outPath, strerror(errno));
+        }
+    }
+    if (fd < 0) {
+        return 1;
+    }
+
+    uint64_t startUs = SerialPort::monotonicUs();
+    std::string epoch;
+    double timeS = 0;
+    while (generator.next(epoch, timeS)) {
+        if (realtime) {
+            SerialPort::sleepUntilUs(startUs + (uint64_t)(timeS * 1e6));
+        }
+        if (!SerialPort::writeAll(fd, epoch.data(), epoch.size())) {
+            fprintf(stderr, "Write error: %s\n", strerror(errno));
+            return 1;
+        }
+    }
+    if (fd != STDOUT_FILENO) {
+        close(fd);
+    }
+
+    // Line load: 10 bits per byte at the baud rate of the receiver UART
+    const NmeaGenerator::Counters& counters = generator.getCounters();
+    double duration = trajectory.getDuration();
+    double load = duration > 0 ? counters.bytes * 10.0 / duration / baud * 100.0 : 0;
+    fprintf(stderr,
+            "nmea_gen: %.1f s, %u epochs at %.0f Hz, %u sentences (%u dropped, %u bad checksum, %u truncated, "
+            "%u glitches), %llu bytes = %.0f%% of %lu baud\n",
+            duration, counters.epochs, 1000.0 / generator.getPeriodMs(), counters.sentences, counters.dropped,
+            counters.badChecksums, counters.truncated, counters.glitches, (unsigned long long)counters.bytes, load, baud);
+    if (load > 100) {
+        fprintf(stderr, "nmea_gen: the stream does not fit in %lu baud, the receiver UART would fall behind\n", baud);
+    }
+    return 0;
+}
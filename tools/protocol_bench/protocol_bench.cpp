@@ -0,0 +1,428 @@
+/**
+ * Vérification et banc de mesure du codec BoatProtocol (outil PC)
+ *
+ * Instructions :
+ * 1. Compiler : pio run -e native-protocol-bench
+ *    (programme : .pio/build/native-protocol-bench/program)
+ * 2. Lancer : program [--seconds S] [--batch N]
+ * 3. Le programme vérifie d'abord chaque type de trame et chaque version
+ *    (aller-retour encodage / décodage, identité avec la structure du
+ *    firmware, rejets), puis mesure le décodage par lot ; code de sortie
+ *    1 si une vérification échoue
+ *
+ * La bibliothèque est dans lib/BoatProtocol (voir BOAT_PROTOCOL.md).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include "BoatCodec.h"
+
+static const char* USAGE =
+    "Usage: %s [options]\n"
+    "  --seconds S          Duration of each measurement (default 1)\n"
+    "  --batch N            Frames per decodeBatch() call (default 256)\n";
+
+static const size_t SAMPLE_FRAMES = 4096;   // Distinct frames cycled by the benchmark (fits in L2)
+
+static unsigned failures = 0;
+static unsigned checks = 0;
+
+static void expect(bool condition, const char* what) {
+    checks++;
+    if (!condition) {
+        failures++;
+        fprintf(stderr, "FAILED: %s\n", what);
+    }
+}
+
+static double nowS() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool littleEndianHost() {
+    uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+/**
+ * @brief Sample messages of every type, filled with distinct non-zero values
+ */
+static GPSBroadcastPacket sampleBoat(uint32_t i) {
+    GPSBroadcastPacket p;
+    memset(&p, 0, sizeof(p));
+    p.messageType = MSG_BOAT;
+    snprintf(p.name, sizeof(p.name), "FRA%u", i % 1000);
+    p.sequenceNumber = 1000 + i;
+    p.gpsTimestamp = 1780000000 + i;
+    p.latitude = 43.5f + i * 1e-5f;
+    p.longitude = 7.0f - i * 1e-5f;
+    p.speed = 5.25f;
+    p.heading = (float)(i % 360);
+    p.satellites = 9;
+    p.ttl = 1;
+    p.rateDeciHz = 50;
+    p.quality = (uint8_t)(i & 3);
+    return p;
+}
+
+static BoatTelemetryPacket sampleTelemetry(uint32_t i, uint8_t version) {
+    BoatTelemetryPacket p;
+    memset(&p, 0, sizeof(p));
+    p.messageType = MSG_TELEMETRY;
+    p.version = version;
+    p.flags = 0xA5;
+    p.sequenceNumber = 1000 + i;
+    p.lineDistanceCm = -1234567;
+    p.timeToLineMs = 42000;
+    p.timeToGunMs = -5000;
+    p.closingCms = -321;
+    if (version >= 2) {
+        p.speed2sCms = 270;
+        p.distanceM = 12345;
+        p.speed10sCms = 265;
+        p.maxSpeedCms = 410;
+        p.tacks = 7;
+        p.gybes = 3;
+        p.starboardS = 600;
+        p.portS = 540;
+    }
+    if (version >= 3) {
+        p.twdDeci = 2715;
+        p.twaDeci = -452;
+        p.twsCms = 650;
+        p.vmgCms = -180;
+        p.targetCms = 300;
+        p.polarPermille = 930;
+    }
+    if (version >= 4) {
+        p.cogDeci = 1234;
+        p.sogCms = 268;
+        p.cogConfidence = 987;
+    }
+    return p;
+}
+
+static void fillMessages(std::vector<BoatMessage>& messages) {
+    BoatMessage m;
+    memset(&m, 0, sizeof(m));
+
+    m.type = MSG_BOAT;
+    m.boat = sampleBoat(1);
+    messages.push_back(m);
+    m.boat.rateDeciHz = 0;  // Older firmware
+    m.boat.quality = 0;
+    messages.push_back(m);
+
+    memset(&m, 0, sizeof(m));
+    m.type = MSG_ANEMOMETER;
+    m.anemometer.messageType = MSG_ANEMOMETER;
+    strcpy(m.anemometer.anemometerId, "ANEMO-COMITE");
+    m.anemometer.sequenceNumber = 77;
+    m.anemometer.windSpeed = 12.5f;
+    m.anemometer.windDirection = 275.0f;
+    messages.push_back(m);
+
+    memset(&m, 0, sizeof(m));
+    m.type = MSG_CONFIG_PUSH;
+    m.configPush.messageType = MSG_CONFIG_PUSH;
+    m.configPush.targetCount = 2;
+    m.configPush.deltaCount = 3;
+    m.configPush.configVersion = 9;
+    for (uint8_t i = 0; i < 6; i++) {
+        m.configPush.targets[0][i] = (uint8_t)(0xD0 + i);
+        m.configPush.targets[1][i] = (uint8_t)(0x10 + i);
+    }
+    m.configPush.deltas[0].key = 1;
+    m.configPush.deltas[0].value = 500;
+    m.configPush.deltas[1].key = 14;
+    m.configPush.deltas[1].value = -435000000;
+    m.configPush.deltas[2].key = 3;
+    m.configPush.deltas[2].value = 6;
+    for (uint8_t i = 0; i < CONFIG_SIGNATURE_LEN; i++) {
+        m.configPush.signature[i] = (uint8_t)(0x80 | i);
+    }
+    messages.push_back(m);
+
+    memset(&m, 0, sizeof(m));
+    m.type = MSG_CONFIG_ACK;
+    m.configAck.messageType = MSG_CONFIG_ACK;
+    m.configAck.status = 3;
+    m.configAck.requestedVersion = 9;
+    m.configAck.activeVersion = 8;
+    messages.push_back(m);
+
+    memset(&m, 0, sizeof(m));
+    m.type = MSG_START_COUNTDOWN;
+    m.countdown.messageType = MSG_START_COUNTDOWN;
+    m.countdown.flags = START_FLAG_HAS_LINE;
+    m.countdown.windowS = 180;
+    m.countdown.gunTimeOfDayMs = 43200000;
+    m.countdown.committeeLat = 435100000;
+    m.countdown.committeeLon = 70100000;
+    m.countdown.pinLat = 435105000;
+    m.countdown.pinLon = 70095000;
+    for (uint8_t i = 0; i < CONFIG_SIGNATURE_LEN; i++) {
+        m.countdown.signature[i] = (uint8_t)(0xA0 | i);
+    }
+    messages.push_back(m);
+
+    memset(&m, 0, sizeof(m));
+    m.type = MSG_EVENT;
+    m.event.messageType = MSG_EVENT;
+    m.event.eventType = EVENT_LINE_CROSSING;
+    m.event.eventSequence = 513;
+    m.event.detail = 1;
+    m.event.timeOfDayMs = 43201234;
+    m.event.relativeMs = -250;
+    m.event.latitude = 43.5101f;
+    m.event.longitude = 7.0099f;
+    m.event.speed = 4.5f;
+    messages.push_back(m);
+
+    for (uint8_t version = 1; version <= TELEMETRY_VERSION; version++) {
+        memset(&m, 0, sizeof(m));
+        m.type = MSG_TELEMETRY;
+        m.telemetry = sampleTelemetry(1, version);
+        messages.push_back(m);
+    }
+
+    memset(&m, 0, sizeof(m));
+    m.type = MSG_COURSE;
+    m.course.messageType = MSG_COURSE;
+    m.course.count = 3;
+    m.course.courseId = 4242;
+    for (uint8_t i = 0; i < 3; i++) {
+        m.course.marks[i].latitude = 435000000 + i * 1000;
+        m.course.marks[i].longitude = -70000000 - i * 1000;
+        m.course.marks[i].radiusM = (uint16_t)(10 * i);
+        m.course.marks[i].markId = i;
+        m.course.marks[i].flags = (i == 2) ? COURSE_LAP_MARK : 0;
+    }
+    for (uint8_t i = 0; i < CONFIG_SIGNATURE_LEN; i++) {
+        m.course.signature[i] = (uint8_t)(0xC0 | i);
+    }
+    messages.push_back(m);
+
+    memset(&m, 0, sizeof(m));
+    m.type = MSG_TIME_BEACON;
+    m.timeBeacon.messageType = MSG_TIME_BEACON;
+    m.timeBeacon.state = TIME_GNSS;
+    m.timeBeacon.sequence = 513;
+    m.timeBeacon.gpsSeconds = 1750000000u;
+    m.timeBeacon.gpsMicros = 999999;
+    m.timeBeacon.correctionUs = TIME_BEACON_NO_CORRECTION;
+    m.timeBeacon.accuracyUs = 120;
+    messages.push_back(m);
+}
+
+/**
+ * @brief Bytes of the packet as the firmware sends it (memcpy of the structure)
+ */
+static size_t firmwareBytes(const BoatMessage& m, uint8_t* out) {
+    switch (m.type) {
+        case MSG_BOAT: memcpy(out, &m.boat, sizeof(m.boat)); return sizeof(m.boat);
+        case MSG_ANEMOMETER: memcpy(out, &m.anemometer, sizeof(m.anemometer)); return sizeof(m.anemometer);
+        case MSG_CONFIG_PUSH: memcpy(out, &m.configPush, sizeof(m.configPush)); return sizeof(m.configPush);
+        case MSG_CONFIG_ACK: memcpy(out, &m.configAck, sizeof(m.configAck)); return sizeof(m.configAck);
+        case MSG_START_COUNTDOWN: memcpy(out, &m.countdown, sizeof(m.countdown)); return sizeof(m.countdown);
+        case MSG_EVENT: memcpy(out, &m.event, sizeof(m.event)); return sizeof(m.event);
+        case MSG_TELEMETRY:
+            memcpy(out, &m.telemetry, sizeof(m.telemetry));
+            return TelemetryWire::size(m.telemetry.version);
+        case MSG_COURSE: memcpy(out, &m.course, sizeof(m.course)); return sizeof(m.course);
+        case MSG_TIME_BEACON: memcpy(out, &m.timeBeacon, sizeof(m.timeBeacon)); return sizeof(m.timeBeacon);
+        default: return 0;
+    }
+}
+
+static void runChecks() {
+    std::vector<BoatMessage> messages;
+    fillMessages(messages);
+    char what[96];
+
+    for (const BoatMessage& message : messages) {
+        uint8_t frame[BOAT_PROTOCOL_MAX_FRAME];
+        uint8_t again[BOAT_PROTOCOL_MAX_FRAME];
+        size_t len = BoatCodec::encode(message, frame, sizeof(frame));
+        snprintf(what, sizeof(what), "type %d: encode", message.type);
+        expect(len > 0, what);
+
+        // Same bytes as the structure sent by the firmware (samples are zeroed, padding included)
+        if (littleEndianHost()) {
+            uint8_t raw[BOAT_PROTOCOL_MAX_FRAME];
+            size_t rawLen = firmwareBytes(message, raw);
+            snprintf(what, sizeof(what), "type %d: encode == firmware memcpy", message.type);
+            expect(rawLen == len && memcmp(raw, frame, len) == 0, what);
+        }
+
+        BoatMessage decoded;
+        snprintf(what, sizeof(what), "type %d: decode", message.type);
+        expect(BoatCodec::decode(frame, len, decoded) == DECODE_OK && decoded.type == message.type, what);
+        snprintf(what, sizeof(what), "type %d: round trip", message.type);
+        expect(BoatCodec::encode(decoded, again, sizeof(again)) == len && memcmp(frame, again, len) == 0, what);
+
+        snprintf(what, sizeof(what), "type %d: truncated frame rejected", message.type);
+        expect(BoatCodec::decode(frame, len - 1, decoded) == DECODE_TOO_SHORT && decoded.type == 0, what);
+        snprintf(what, sizeof(what), "type %d: encode into a short buffer", message.type);
+        expect(BoatCodec::encode(message, frame, len - 1) == 0, what);
+    }
+
+    // Typed decoders, rejected frames
+    uint8_t frame[BOAT_PROTOCOL_MAX_FRAME];
+    GPSBroadcastPacket boat = sampleBoat(2);
+    size_t len = BoatCodec::encode(boat, frame, sizeof(frame));
+    EventPacket event;
+    expect(BoatCodec::decode(frame, len, event) == DECODE_WRONG_TYPE, "boat frame given to the event decoder");
+    frame[BoatWire::NAME + 17] = 'X';
+    expect(BoatCodec::decode(frame, len, boat) == DECODE_OK && boat.name[17] == '\0', "name always terminated");
+    BoatMessage message;
+    expect(BoatCodec::decode(frame, 0, message) == DECODE_EMPTY, "empty frame");
+    frame[0] = 42;
+    expect(BoatCodec::decode(frame, len, message) == DECODE_UNKNOWN_TYPE, "unknown type");
+
+    memset(&message, 0, sizeof(message));
+    message.type = MSG_COURSE;
+    message.course.messageType = MSG_COURSE;
+    len = BoatCodec::encode(message, frame, sizeof(frame));
+    frame[CourseWire::COUNT] = COURSE_MAX_ENTRIES + 1;
+    expect(BoatCodec::decode(frame, len, message) == DECODE_BAD_COUNT, "course count beyond the array");
+
+    // Telemetry: version 0, older versions read by this one, newer version read with the known fields
+    BoatTelemetryPacket telemetry = sampleTelemetry(3, 2);
+    len = BoatCodec::encode(telemetry, frame, sizeof(frame));
+    expect(len == TelemetryWire::SIZE_V2, "telemetry v2 size");
+    BoatTelemetryPacket read;
+    expect(BoatCodec::decode(frame, len, read) == DECODE_OK && read.version == 2 && read.tacks == 7 && read.twdDeci == 0,
+           "telemetry v2 decoded, later fields 0");
+    frame[TelemetryWire::VERSION] = 0;
+    expect(BoatCodec::decode(frame, len, read) == DECODE_BAD_VERSION, "telemetry version 0");
+    telemetry = sampleTelemetry(4, TELEMETRY_VERSION);
+    len = BoatCodec::encode(telemetry, frame, sizeof(frame));
+    frame[TelemetryWire::VERSION] = TELEMETRY_VERSION + 1;
+    memset(frame + len, 0x5A, 8);  // Fields of a future version
+    expect(BoatCodec::decode(frame, len + 8, read) == DECODE_OK && read.version == TELEMETRY_VERSION + 1 &&
+               read.cogConfidence == telemetry.cogConfidence,
+           "newer telemetry version read with the known fields");
+    expect(BoatCodec::decode(frame, len - 1, read) == DECODE_TOO_SHORT, "newer telemetry version truncated");
+
+    // Batch: counters per status
+    FrameView views[3];
+    uint8_t good[BOAT_PROTOCOL_MAX_FRAME];
+    uint8_t unknown[4] = {99, 0, 0, 0};
+    size_t goodLen = BoatCodec::encode(sampleBoat(5), good, sizeof(good));
+    views[0] = {good, goodLen};
+    views[1] = {unknown, sizeof(unknown)};
+    views[2] = {good, 10};
+    BoatMessage out[3];
+    uint32_t rejected[8] = {0};
+    size_t decoded = BoatCodec::decodeBatch(views, 3, out, rejected);
+    expect(decoded == 1 && out[0].type == MSG_BOAT && out[1].type == 0 && rejected[DECODE_UNKNOWN_TYPE] == 1 &&
+               rejected[DECODE_TOO_SHORT] == 1,
+           "batch decode with rejected frames");
+}
+
+/**
+ * @brief Frames/s of decodeBatch() over a fleet-like mix
+ */
+static void benchmark(double seconds, size_t batch) {
+    // Mix of a race: one position and one telemetry frame per fix, some events and wind
+    std::vector<uint8_t> storage(SAMPLE_FRAMES * BOAT_PROTOCOL_MAX_FRAME);
+    std::vector<FrameView> frames(SAMPLE_FRAMES);
+    for (size_t i = 0; i < SAMPLE_FRAMES; i++) {
+        uint8_t* data = &storage[i * BOAT_PROTOCOL_MAX_FRAME];
+        size_t len;
+        if (i % 20 == 19) {
+            EventPacket event;
+            memset(&event, 0, sizeof(event));
+            event.messageType = MSG_EVENT;
+            event.eventSequence = (uint16_t)i;
+            len = BoatCodec::encode(event, data, BOAT_PROTOCOL_MAX_FRAME);
+        } else if (i % 20 == 18) {
+            AnemometerPacket wind;
+            memset(&wind, 0, sizeof(wind));
+            wind.messageType = MSG_ANEMOMETER;
+            wind.sequenceNumber = (uint32_t)i;
+            len = BoatCodec::encode(wind, data, BOAT_PROTOCOL_MAX_FRAME);
+        } else if (i % 2 == 0) {
+            len = BoatCodec::encode(sampleBoat((uint32_t)i), data, BOAT_PROTOCOL_MAX_FRAME);
+        } else {
+            len = BoatCodec::encode(sampleTelemetry((uint32_t)i, TELEMETRY_VERSION), data, BOAT_PROTOCOL_MAX_FRAME);
+        }
+        frames[i].data = data;
+        frames[i].len = len;
+    }
+    std::vector<BoatMessage> out(batch);
+    uint64_t total = 0;
+    uint64_t decoded = 0;
+    uint64_t checksum = 0;
+    size_t next = 0;
+    double start = nowS();
+    double elapsed = 0;
+    do {
+        for (int repeat = 0; repeat < 64; repeat++) {
+            size_t count = batch < SAMPLE_FRAMES - next ? batch : SAMPLE_FRAMES - next;
+            decoded += BoatCodec::decodeBatch(&frames[next], count, &out[0]);
+            checksum += (uint32_t)out[0].type + out[count - 1].boat.sequenceNumber;  // Keeps the work observable
+            total += count;
+            next = (next + count) % SAMPLE_FRAMES;
+        }
+        elapsed = nowS() - start;
+    } while (elapsed < seconds);
+    printf("decodeBatch: %llu frames in %.2f s = %.2f M frames/s, %.1f ns/frame, batch %zu (%llu decoded, check %llu)\n",
+           (unsigned long long)total, elapsed, total / elapsed / 1e6, elapsed * 1e9 / total, batch,
+           (unsigned long long)decoded, (unsigned long long)(checksum & 0xFFFF));
+
+    // Encoder of the position frame (log replay, simulators)
+    GPSBroadcastPacket boat = sampleBoat(7);
+    total = 0;
+    checksum = 0;
+    start = nowS();
+    do {
+        for (size_t i = 0; i < SAMPLE_FRAMES; i++) {
+            boat.sequenceNumber++;
+            boat.latitude += 1e-6f;
+            uint8_t* frame = &storage[i * BOAT_PROTOCOL_MAX_FRAME];
+            checksum += BoatCodec::encode(boat, frame, BOAT_PROTOCOL_MAX_FRAME);
+            total++;
+        }
+        checksum += storage[BoatWire::SEQUENCE];
+        elapsed = nowS() - start;
+    } while (elapsed < seconds);
+    printf("encode(GPSBroadcastPacket): %.2f M frames/s, %.1f ns/frame (check %llu)\n", total / elapsed / 1e6,
+           elapsed * 1e9 / total, (unsigned long long)(checksum & 0xFFFF));
+}
+
+int main(int argc, char** argv) {
+    double seconds = 1;
+    size_t batch = 256;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "--seconds") == 0 && hasValue) {
+            seconds = atof(argv[++i]);
+        } else if (strcmp(arg, "--batch") == 0 && hasValue) {
+            batch = strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, USAGE, argv[0]);
+            return strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (batch == 0 || batch > SAMPLE_FRAMES) {
+        fprintf(stderr, "--batch: 1 to %zu\n", SAMPLE_FRAMES);
+        return 1;
+    }
+
+    runChecks();
+    printf("checks: %u passed, %u failed (%s host)\n", checks - failures, failures,
+           littleEndianHost() ? "little-endian" : "big-endian");
+    if (failures > 0) {
+        return 1;
+    }
+    benchmark(seconds, batch);
+    return 0;
+}
@@ -8,6 +8,8 @@
  * 4. Reflasher le firmware BoatGPS v1.0.5
  * 
  * Le nom sera conservé en mémoire NVS.
+ * MODE = "gateway" passe le firmware en station de base (passerelle
+ * ESP-NOW vers USB, voir GATEWAY.md) ; "" revient au mode bateau.
  */
 
 #include <Preferences.h>
@@ -16,6 +18,7 @@
 // CONFIGURATION : Modifier le nom ici
 // ============================================
 const char* BOAT_NAME = "FRA001";  // Max 17 caractères
+const char* MODE = "";             // "" = bateau, "gateway" = station de base
 // ============================================
 
 Preferences preferences;
@@ -46,11 +49,16 @@ void setup() {
   // Écrire la nouvelle valeur
   preferences.putString("boat_name", BOAT_NAME);
   
+  // Mode du firmware
+  preferences.putString("mode", MODE);
+  
   // Vérifier l'écriture
   String newName = preferences.getString("boat_name", "");
+  String newMode = preferences.getString("mode", "");
   preferences.end();
   
   Serial.printf("Nouveau nom : '%s'\n", newName.c_str());
+  Serial.printf("Mode : '%s'\n", newMode.length() > 0 ? newMode.c_str() : "bateau");
   
   if (newName == String(BOAT_NAME)) {
     Serial.println("\n✅ Configuration réussie !");
@@ -0,0 +1,113 @@
+/**
+ * Diffusion d'un compte à rebours de départ pour OpenSailingRC-BoatGPS
+ *
+ * Instructions :
+ * 1. Renseigner FLEET_KEY (identique à la clé "fleet_key" des bateaux) ;
+ *    les bateaux ignorent une trame mal signée
+ * 2. Renseigner GUN_TIME_UTC (heure GPS du signal de départ, UTC)
+ * 3. Renseigner les extrémités de la ligne en 1e-7 degré (ou
+ *    HAS_LINE = false)
+ * 4. Flasher ce programme sur n'importe quel ESP32 (Atom, AtomS3...)
+ * 5. Ouvrir le Serial Monitor (115200 baud) : la trame est rediffusée
+ *    toutes les secondes. Envoyer 'c' pour annuler la procédure.
+ *
+ * La structure ci-dessous est alignée avec
+ * lib/BoatProtocol/src/BoatProtocol.h du firmware BoatGPS
+ * (StartCountdownPacket, type 5).
+ */
+
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <mbedtls/md.h>
+
+// ============================================
+// CONFIGURATION : Modifier ici
+// ============================================
+const char* FLEET_KEY = "change-me";      // Max 32 caractères
+const uint8_t GUN_HOUR = 14;              // Heure du signal (UTC)
+const uint8_t GUN_MINUTE = 30;
+const uint8_t GUN_SECOND = 0;
+const uint16_t WINDOW_S = 0;              // 0 = fenêtre configurée sur les bateaux
+const uint8_t CURRENT_CHANNEL = 1;        // Canal actuel des bateaux
+
+const bool HAS_LINE = true;
+const int32_t COMMITTEE_LAT = 431234560;  // Bateau comité (tribord), 1e-7 degré
+const int32_t COMMITTEE_LON = 51234560;
+const int32_t PIN_LAT = 431237890;        // Bouée (bâbord)
+const int32_t PIN_LON = 51212340;
+// ============================================
+
+struct StartCountdownPacket {
+  int8_t messageType;        // 5
+  uint8_t flags;             // 0x01 = annulation, 0x02 = ligne valide
+  uint16_t windowS;
+  uint32_t gunTimeOfDayMs;
+  int32_t committeeLat;      // 1e-7 degré
+  int32_t committeeLon;
+  int32_t pinLat;
+  int32_t pinLon;
+  uint8_t signature[16];     // HMAC-SHA256 tronqué, clé de flotte
+};
+
+StartCountdownPacket packet;
+uint8_t broadcastAddr[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+// Sign: HMAC-SHA256 over all bytes before signature, truncated to 16 bytes
+void signPacket() {
+  uint8_t digest[32];
+  mbedtls_md_hmac(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256),
+                  (const unsigned char*)FLEET_KEY, strlen(FLEET_KEY),
+                  (const unsigned char*)&packet, offsetof(StartCountdownPacket, signature),
+                  digest);
+  memcpy(packet.signature, digest, sizeof(packet.signature));
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+
+  Serial.println("\n===========================================");
+  Serial.println("Diffusion compte à rebours de départ");
+  Serial.println("===========================================\n");
+
+  memset(&packet, 0, sizeof(packet));
+  packet.messageType = 5;
+  packet.flags = HAS_LINE ? 0x02 : 0x00;
+  packet.windowS = WINDOW_S;
+  packet.gunTimeOfDayMs = ((uint32_t)GUN_HOUR * 3600UL + GUN_MINUTE * 60UL + GUN_SECOND) * 1000UL;
+  packet.committeeLat = COMMITTEE_LAT;
+  packet.committeeLon = COMMITTEE_LON;
+  packet.pinLat = PIN_LAT;
+  packet.pinLon = PIN_LON;
+  signPacket();
+
+  // ESP-NOW (Long Range, same channel as the boats)
+  WiFi.mode(WIFI_STA);
+  WiFi.disconnect();
+  esp_wifi_set_protocol(WIFI_IF_STA, WIFI_PROTOCOL_11B | WIFI_PROTOCOL_11G | WIFI_PROTOCOL_11N | WIFI_PROTOCOL_LR);
+  esp_wifi_set_channel(CURRENT_CHANNEL, WIFI_SECOND_CHAN_NONE);
+  if (esp_now_init() != ESP_OK) {
+    Serial.println("ERREUR : ESP-NOW init");
+    return;
+  }
+
+  esp_now_peer_info_t peerInfo = {};
+  memcpy(peerInfo.peer_addr, broadcastAddr, 6);
+  peerInfo.channel = 0;
+  peerInfo.encrypt = false;
+  esp_now_add_peer(&peerInfo);
+
+  Serial.printf("Signal à %02d:%02d:%02d UTC, %d octets\n",
+                GUN_HOUR, GUN_MINUTE, GUN_SECOND, sizeof(packet));
+}
+
+void loop() {
+  if (Serial.available() && Serial.read() == 'c') {
+    packet.flags |= 0x01;
+    signPacket();
+    Serial.println("Annulation diffusée");
+  }
+  esp_now_send(broadcastAddr, (uint8_t*)&packet, sizeof(packet));
+  delay(1000);
+}
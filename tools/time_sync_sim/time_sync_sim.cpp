@@ -0,0 +1,375 @@
+/**
+ * Simulation de la précision des balises horaires GPS (outil PC)
+ *
+ * Instructions :
+ * 1. Compiler : pio run -e native-time-sync-sim
+ *    (programme : .pio/build/native-time-sync-sim/program)
+ * 2. Sans option : tableau de scénarios (canal calme, chargé, pertes,
+ *    balise lente, GNSS 10 Hz, boucle lente, perte du GNSS), 100 tirages
+ *    de 10 minutes chacun
+ * 3. --beacon-ms, --gnss-hz, --loop-ms, --busy, --loss, --drift-ppm,
+ *    --ramp-ppm-min, --outage-s :
+ *    un seul scénario avec ces valeurs (voir TIME_BEACON.md)
+ *
+ * Monte-Carlo avec le code du firmware et des récepteurs
+ * (lib/BoatProtocol/TimeSync.h, BoatCodec.h) : le bateau discipline son
+ * horloge sur les rafales NMEA comme TimeBeacon, émet ses balises à
+ * travers une file d'émission et un canal modélisés, le récepteur les
+ * suit avec et sans les corrections d'émission. Les erreurs sont mesurées
+ * toutes les 100 ms contre l'heure vraie, après une minute de mise en
+ * route.
+ *
+ * Le retard NMEA du module est supposé calibré (NMEA_LATENCY_US) : une
+ * erreur de calibration s'ajoute telle quelle à tous les résultats
+ * (--calibration-us).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "BoatCodec.h"
+#include "TimeSync.h"
+
+static const char* USAGE =
+    "Usage: %s [options]\n"
+    "  --runs N             Draws per scenario (default 100)\n"
+    "  --duration S         Simulated time per draw (default 600 s)\n"
+    "  --seed N             Random seed (default 1)\n"
+    "  --calibration-us N   Error of NMEA_LATENCY_US, added to every result (default 0)\n"
+    "One scenario instead of the table:\n"
+    "  --beacon-ms N        Beacon interval (default 1000)\n"
+    "  --gnss-hz N          Fix rate (default 1)\n"
+    "  --loop-ms N          Largest delay of loop() to see a NMEA burst (default 2)\n"
+    "  --busy PCT           Beacons waiting for another frame on the channel (default 10)\n"
+    "  --loss PCT           Beacons lost at the receiver (default 2)\n"
+    "  --drift-ppm N        Crystal tolerance of boat and receiver (default 20)\n"
+    "  --ramp-ppm-min N     Drift change of the boat crystal, warming up or cooling (default 0)\n"
+    "  --outage-s N         GNSS lost for N s in the middle of each draw (default 0)\n";
+
+// ---- Model (values from data sheets and ESP-NOW LR frame sizes, orders of magnitude) ----
+static const int64_t GPS_EPOCH_US = 1750000000LL * 1000000;   // Arbitrary GPS date of the draws
+static const int64_t NMEA_LATENCY_US = 45000;      // Epoch to first byte: constant part (compensated)
+static const int64_t NMEA_JITTER_US = 300;         // Epoch to first byte: receiver jitter
+static const double LOOP_STALL_PROB = 0.05;        // loop() blocked (SD write, log line)
+static const int64_t LOOP_STALL_US = 20000;
+static const int64_t SEND_CALL_US = 60;            // Stamp to frame in the WiFi task
+static const int64_t BACKOFF_MAX_US = 300;         // DIFS + random backoff
+static const int64_t LR_PREAMBLE_US = 400;         // 802.11 LR frame: preamble and header
+static const int64_t LR_US_PER_BYTE = 32;          // 250 kbit/s
+static const int64_t FRAME_OVERHEAD = 43;          // 802.11 + ESP-NOW headers, FCS
+static const double OWN_FRAME_PROB = 0.2;          // Beacon queued behind the boat's position frame
+static const int64_t CALLBACK_MIN_US = 20;         // Send / receive callback latency
+static const int64_t CALLBACK_MAX_US = 200;
+static const double RX_TASK_DELAY_PROB = 0.05;     // Receiver WiFi task busy
+static const int64_t RX_TASK_DELAY_US = 2000;
+static const int64_t WARMUP_US = 60000000;
+static const int64_t EVAL_STEP_US = 100000;
+static const int64_t SAMPLE_PERIOD_US = 900000;    // TimeBeacon::SAMPLE_PERIOD_US
+
+struct Scenario {
+    const char* name;
+    uint32_t beaconMs;
+    uint32_t gnssHz;
+    uint32_t loopMs;
+    uint32_t busyPct;
+    uint32_t lossPct;
+    double driftPpm;
+    double rampPpmPerMin;
+    uint32_t outageS;
+};
+
+static const Scenario SCENARIOS[] = {
+    {"quiet channel", 1000, 1, 2, 10, 2, 20, 0, 0},
+    {"busy channel", 1000, 1, 2, 60, 10, 20, 0, 0},
+    {"25% loss", 1000, 1, 2, 10, 25, 20, 0, 0},
+    {"beacon every 5 s", 5000, 1, 2, 10, 2, 20, 0, 0},
+    {"10 Hz GNSS", 1000, 10, 2, 10, 2, 20, 0, 0},
+    {"light sleep loop", 1000, 1, 30, 10, 2, 20, 0, 0},
+    {"60 s GNSS outage, warming", 1000, 1, 2, 10, 2, 20, 2, 60},
+};
+
+/**
+ * @brief Absolute errors of one estimator (µs)
+ */
+struct Errors {
+    std::vector<double> values;
+    uint64_t unsynced = 0;
+
+    void add(int64_t error) {
+        values.push_back((double)(error < 0 ? -error : error));
+    }
+
+    double percentile(double p) {
+        if (values.empty()) {
+            return 0;
+        }
+        size_t index = (size_t)(p * (values.size() - 1));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+    double withinPct(double limit) const {
+        if (values.empty()) {
+            return 0;
+        }
+        size_t n = 0;
+        for (double v : values) {
+            n += v <= limit;
+        }
+        return 100.0 * n / values.size();
+    }
+};
+
+/**
+ * @brief Local clock: offset since boot, crystal drift and its change with temperature
+ */
+struct LocalClock {
+    int64_t offsetUs;
+    double drift;
+    double ramp;  // Drift change per µs
+
+    int64_t at(int64_t trueUs) const {
+        double t = (double)trueUs;
+        return trueUs + (int64_t)(t * drift + 0.5 * ramp * t * t) + offsetUs;
+    }
+};
+
+class Random {
+public:
+    explicit Random(uint64_t seed) : engine(seed) {}
+    double uniform(double a, double b) {
+        return std::uniform_real_distribution<double>(a, b)(engine);
+    }
+    int64_t uniformUs(int64_t a, int64_t b) {
+        return (int64_t)uniform((double)a, (double)b);
+    }
+    bool chance(double p) {
+        return uniform(0, 1) < p;
+    }
+
+private:
+    std::mt19937_64 engine;
+};
+
+static int64_t airtimeUs(size_t len) {
+    return LR_PREAMBLE_US + (int64_t)(len + FRAME_OVERHEAD) * LR_US_PER_BYTE;
+}
+
+/**
+ * @brief One draw: boat and receiver over duration, errors every EVAL_STEP_US
+ */
+static void runDraw(const Scenario& s, int64_t durationUs, int64_t calibrationUs, Random& rnd, Errors& boat,
+                    Errors& corrected, Errors& raw) {
+    double ramp = (rnd.uniform(0, 1) < 0.5 ? -s.rampPpmPerMin : s.rampPpmPerMin) * 1e-6 / 60e6;
+    LocalClock boatClock = {rnd.uniformUs(1000000, 100000000), rnd.uniform(-s.driftPpm, s.driftPpm) * 1e-6, ramp};
+    LocalClock rxClock = {rnd.uniformUs(1000000, 100000000), rnd.uniform(-s.driftPpm, s.driftPpm) * 1e-6, 0};
+    ClockEstimator boatEstimate(ClockEstimator::ENVELOPE);
+    BeaconReceiver withCorrections(true);
+    BeaconReceiver withoutCorrections(false);
+    static const uint8_t MAC[6] = {0x02, 0, 0, 0, 0, 0x01};
+
+    int64_t fixPeriod = 1000000 / s.gnssHz;
+    int64_t nextFix = rnd.uniformUs(0, fixPeriod);
+    int64_t nextBeacon = rnd.uniformUs(0, (int64_t)s.beaconMs * 1000);
+    int64_t nextEval = WARMUP_US;
+    int64_t outageStart = durationUs / 2;
+    int64_t outageEnd = outageStart + (int64_t)s.outageS * 1000000;
+    bool bucketOpen = false;
+    int64_t bucketStart = 0, bucketLocal = 0, bucketOffset = 0;
+    uint16_t sequence = 0;
+    int32_t pendingCorrection = TIME_BEACON_NO_CORRECTION;
+
+    while (true) {
+        int64_t t = std::min(nextFix, std::min(nextBeacon, nextEval));
+        if (t >= durationUs) {
+            break;
+        }
+        if (t == nextFix && t >= outageStart && t < outageEnd) {
+            nextFix += fixPeriod;
+        } else if (t == nextFix) {
+            // First byte seen by loop(): epoch + receiver latency + detection delay (TimeBeacon::update)
+            int64_t firstByte = t + NMEA_LATENCY_US + rnd.uniformUs(0, NMEA_JITTER_US);
+            int64_t seen = firstByte + rnd.uniformUs(0, (int64_t)s.loopMs * 1000);
+            if (rnd.chance(LOOP_STALL_PROB)) {
+                seen += rnd.uniformUs(0, LOOP_STALL_US);
+            }
+            int64_t local = boatClock.at(seen);
+            int64_t offset = GPS_EPOCH_US + t + NMEA_LATENCY_US + calibrationUs - local;
+            if (bucketOpen && local - bucketStart >= SAMPLE_PERIOD_US) {
+                boatEstimate.addSample(bucketLocal, bucketOffset);
+                bucketOpen = false;
+            }
+            if (!bucketOpen) {
+                bucketOpen = true;
+                bucketStart = bucketLocal = local;
+                bucketOffset = offset;
+            } else if (offset > bucketOffset) {
+                bucketLocal = local;
+                bucketOffset = offset;
+            }
+            nextFix += fixPeriod;
+        } else if (t == nextBeacon) {
+            nextBeacon += (int64_t)s.beaconMs * 1000;
+            if (!boatEstimate.isValid()) {
+                pendingCorrection = TIME_BEACON_NO_CORRECTION;
+                continue;
+            }
+            TimeBeaconPacket beacon;
+            memset(&beacon, 0, sizeof(beacon));
+            beacon.messageType = MSG_TIME_BEACON;
+            beacon.state = TIME_GNSS;
+            beacon.sequence = ++sequence;
+            beacon.correctionUs = pendingCorrection;
+            int64_t stamp = boatEstimate.toReference(boatClock.at(t));
+            beacon.gpsSeconds = (uint32_t)(stamp / 1000000);
+            beacon.gpsMicros = (uint32_t)(stamp % 1000000);
+            uint8_t frame[BOAT_PROTOCOL_MAX_FRAME];
+            size_t len = BoatCodec::encode(beacon, frame, sizeof(frame));
+
+            // TX queue and channel, then send callback on the boat, receive callback on the receiver
+            int64_t start = t + SEND_CALL_US;
+            if (rnd.chance(OWN_FRAME_PROB)) {
+                start += airtimeUs(sizeof(GPSBroadcastPacket)) + rnd.uniformUs(0, BACKOFF_MAX_US);
+            }
+            if (rnd.chance(s.busyPct / 100.0)) {
+                start += rnd.uniformUs(0, airtimeUs(BOAT_PROTOCOL_MAX_FRAME));
+            }
+            int64_t txEnd = start + rnd.uniformUs(0, BACKOFF_MAX_US) + airtimeUs(len);
+            int64_t sentCallback = txEnd + rnd.uniformUs(CALLBACK_MIN_US, CALLBACK_MAX_US);
+            pendingCorrection = (int32_t)(boatEstimate.toReference(boatClock.at(sentCallback)) - stamp);
+
+            if (!rnd.chance(s.lossPct / 100.0)) {
+                int64_t received = txEnd + rnd.uniformUs(CALLBACK_MIN_US, CALLBACK_MAX_US);
+                if (rnd.chance(RX_TASK_DELAY_PROB)) {
+                    received += rnd.uniformUs(0, RX_TASK_DELAY_US);
+                }
+                TimeBeaconPacket decoded;
+                if (BoatCodec::decode(frame, len, decoded) == DECODE_OK) {
+                    withCorrections.apply(MAC, decoded, rxClock.at(received));
+                    withoutCorrections.apply(MAC, decoded, rxClock.at(received));
+                }
+            }
+        } else {
+            int64_t truth = GPS_EPOCH_US + t;
+            if (boatEstimate.isValid()) {
+                boat.add(boatEstimate.toReference(boatClock.at(t)) - truth);
+            } else {
+                boat.unsynced++;
+            }
+            if (withCorrections.isSynced()) {
+                corrected.add(withCorrections.toGpsUs(rxClock.at(t)) - truth);
+            } else {
+                corrected.unsynced++;
+            }
+            if (withoutCorrections.isSynced()) {
+                raw.add(withoutCorrections.toGpsUs(rxClock.at(t)) - truth);
+            } else {
+                raw.unsynced++;
+            }
+            nextEval += EVAL_STEP_US;
+        }
+    }
+}
+
+static void printRow(const char* what, Errors& e) {
+    printf("  %-26s p50 %6.0f  p95 %6.0f  p99 %6.0f  max %6.0f us | <1 ms %6.2f%%", what, e.percentile(0.5),
+           e.percentile(0.95), e.percentile(0.99), e.percentile(1.0), e.withinPct(1000));
+    if (e.unsynced > 0) {
+        printf(" (%llu unsynced)", (unsigned long long)e.unsynced);
+    }
+    printf("\n");
+}
+
+static void runScenario(const Scenario& s, uint32_t runs, int64_t durationUs, int64_t calibrationUs, uint64_t seed) {
+    Errors boat, corrected, raw;
+    Random rnd(seed);
+    for (uint32_t i = 0; i < runs; i++) {
+        runDraw(s, durationUs, calibrationUs, rnd, boat, corrected, raw);
+    }
+    printf("%s: beacon %u ms, GNSS %u Hz, loop %u ms, busy %u%%, loss %u%%, crystals ±%.0f ppm, ramp %.1f ppm/min, "
+           "GNSS outage %u s\n",
+           s.name, s.beaconMs, s.gnssHz, s.loopMs, s.busyPct, s.lossPct, s.driftPpm, s.rampPpmPerMin, s.outageS);
+    printRow("boat clock", boat);
+    printRow("receiver, corrected", corrected);
+    printRow("receiver, stamp only", raw);
+}
+
+int main(int argc, char** argv) {
+    uint32_t runs = 100;
+    double durationS = 600;
+    uint64_t seed = 1;
+    int64_t calibrationUs = 0;
+    Scenario custom = {"custom", 1000, 1, 2, 10, 2, 20, 0, 0};
+    bool single = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            printf(USAGE, argv[0]);
+            return 0;
+        }
+        if (value == nullptr) {
+            fprintf(stderr, USAGE, argv[0]);
+            return 2;
+        }
+        i++;
+        if (strcmp(arg, "--runs") == 0) {
+            runs = (uint32_t)atoi(value);
+        } else if (strcmp(arg, "--duration") == 0) {
+            durationS = atof(value);
+        } else if (strcmp(arg, "--seed") == 0) {
+            seed = strtoull(value, nullptr, 10);
+        } else if (strcmp(arg, "--calibration-us") == 0) {
+            calibrationUs = atoll(value);
+        } else if (strcmp(arg, "--beacon-ms") == 0) {
+            custom.beaconMs = (uint32_t)atoi(value);
+            single = true;
+        } else if (strcmp(arg, "--gnss-hz") == 0) {
+            custom.gnssHz = (uint32_t)atoi(value);
+            single = true;
+        } else if (strcmp(arg, "--loop-ms") == 0) {
+            custom.loopMs = (uint32_t)atoi(value);
+            single = true;
+        } else if (strcmp(arg, "--busy") == 0) {
+            custom.busyPct = (uint32_t)atoi(value);
+            single = true;
+        } else if (strcmp(arg, "--loss") == 0) {
+            custom.lossPct = (uint32_t)atoi(value);
+            single = true;
+        } else if (strcmp(arg, "--drift-ppm") == 0) {
+            custom.driftPpm = atof(value);
+            single = true;
+        } else if (strcmp(arg, "--ramp-ppm-min") == 0) {
+            custom.rampPpmPerMin = atof(value);
+            single = true;
+        } else if (strcmp(arg, "--outage-s") == 0) {
+            custom.outageS = (uint32_t)atoi(value);
+            single = true;
+        } else {
+            fprintf(stderr, USAGE, argv[0]);
+            return 2;
+        }
+    }
+    if (runs == 0 || durationS * 1e6 <= WARMUP_US || custom.beaconMs < 100 || custom.gnssHz == 0 ||
+        custom.gnssHz > 10 || custom.busyPct > 100 || custom.lossPct > 100) {
+        fprintf(stderr, USAGE, argv[0]);
+        return 2;
+    }
+
+    int64_t durationUs = (int64_t)(durationS * 1e6);
+    printf("time_sync_sim: %u draws of %.0f s per scenario, errors every %lld ms after %lld s\n\n", runs, durationS,
+           (long long)(EVAL_STEP_US / 1000), (long long)(WARMUP_US / 1000000));
+    if (single) {
+        runScenario(custom, runs, durationUs, calibrationUs, seed);
+        return 0;
+    }
+    for (const Scenario& s : SCENARIOS) {
+        runScenario(s, runs, durationUs, calibrationUs, seed);
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,661 @@
+/**
+ * Récepteur GPS virtuel pour OpenSailingRC-BoatGPS (outil PC)
+ *
+ * Instructions :
+ * 1. Compiler : pio run -e native-virtual-gps
+ *    (programme : .pio/build/native-virtual-gps/program)
+ * 2. Lancer : program --legs 0:15:60,90:15:60 --rate 10 --baud 115200
+ *    --radio-udp 239.255.0.42:5042 ; le pseudo-terminal créé est affiché
+ *    et lié à /tmp/boatgps-gps
+ * 3. Simulateur : program --gps-device /tmp/boatgps-gps
+ *    --radio-udp 239.255.0.42:5042 (voir SIMULATOR.md)
+ * 4. Carte réelle : --serial /dev/ttyUSB0 sur l'adaptateur USB-série
+ *    branché à la place du GPS (RX et TX du firmware)
+ *
+ * Le flux est émis au débit de la ligne (10 bits par octet), l'heure
+ * d'envoi de chaque époque est connue à la microseconde ; les commandes
+ * du firmware (UBX, PCAS) sont appliquées et acquittées comme par le
+ * récepteur. Avec --radio-udp, les trames du simulateur sont rapprochées
+ * des époques pour mesurer la latence fix -> antenne (VIRTUAL_GPS.md).
+ */
+
+#include <algorithm>
+#include <deque>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include "BoatCodec.h"
+#include "NmeaGenerator.h"
+#include "SerialPort.h"
+#include "UdpRadio.h"
+
+static const char* USAGE =
+    "Usage: %s [options]\n"
+    "%s"
+    "Port:\n"
+    "  --link PATH          Symlink to the pseudo-terminal (default /tmp/boatgps-gps)\n"
+    "  --serial DEVICE      Serial port (USB bridge) instead of a pseudo-terminal\n"
+    "  --baud N             Line speed (default 9600; 115200 for the AT6668)\n"
+    "Measurement:\n"
+    "  --send-log FILE      Send time of each epoch\n"
+    "  --radio-udp G:PORT   Receive the simulator frames and measure fix-to-air latency\n"
+    "  --latency-log FILE   One line per matched frame\n"
+    "  --report S           Latency report period (default 10 s)\n"
+    "  --duration S         Stop after S seconds (default: end of the trajectory + 3 s)\n";
+
+static const char* DEFAULT_LINK = "/tmp/boatgps-gps";
+static const uint64_t LINGER_US = 3000000;        // Frames still in flight after the last epoch
+static const uint64_t EPOCH_MEMORY_US = 5000000;  // Epochs kept for matching
+static const double MATCH_TOLERANCE_M = 0.5;      // Float position of the packet: 1.7 m at worst, ~0.1 m here
+static const size_t MAX_UBX_PAYLOAD = 512;
+
+// NMEA sentence of each UBX CFG-MSG id in class 0xF0
+static const struct {
+    uint8_t id;
+    uint16_t sentence;
+} UBX_NMEA_IDS[] = {
+    {0x00, NMEA_GGA}, {0x01, NMEA_GLL}, {0x02, NMEA_GSA}, {0x03, NMEA_GSV},
+    {0x04, NMEA_RMC}, {0x05, NMEA_VTG}, {0x08, NMEA_ZDA},
+};
+
+// Field order of $PCAS03 (CASIC): GGA, GLL, GSA, GSV, RMC, VTG, ZDA...
+static const uint16_t PCAS03_FIELDS[] = {NMEA_GGA, NMEA_GLL, NMEA_GSA, NMEA_GSV, NMEA_RMC, NMEA_VTG, NMEA_ZDA};
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void onInterrupt(int) {
+    interrupted = 1;
+}
+
+static void usage(const char* program, int code) {
+    fprintf(code == 0 ? stdout : stderr, USAGE, program, NmeaGenOptions::USAGE);
+    exit(code);
+}
+
+static uint64_t realtimeUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief Époque envoyée, en attente de rapprochement
+ */
+struct SentEpoch {
+    double timeS;
+    double latitude;
+    double longitude;
+    uint64_t startOffset;   // Position in the byte stream
+    uint64_t endOffset;
+    uint64_t firstByteUs;   // Monotonic, 0 = not sent yet
+    uint64_t lastByteUs;
+};
+
+/**
+ * @brief Latences d'une fenêtre de rapport
+ */
+struct LatencyStats {
+    std::vector<uint32_t> samples;  // µs
+    uint32_t unmatched = 0;
+
+    void print(const char* label) {
+        if (samples.empty()) {
+            fprintf(stderr, "%s: no frame matched (%u unmatched)\n", label, unmatched);
+            return;
+        }
+        std::vector<uint32_t> sorted(samples);
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0;
+        for (uint32_t value : sorted) {
+            sum += value;
+        }
+        fprintf(stderr,
+                "%s: %zu frames, fix-to-air min %.1f ms, median %.1f ms, p95 %.1f ms, max %.1f ms, mean %.1f ms "
+                "(%u unmatched)\n",
+                label, sorted.size(), sorted.front() / 1000.0, sorted[sorted.size() / 2] / 1000.0,
+                sorted[std::min(sorted.size() - 1, sorted.size() * 95 / 100)] / 1000.0,
+                sorted.back() / 1000.0, sum / sorted.size() / 1000.0, unmatched);
+    }
+};
+
+/**
+ * @brief Récepteur : flux NMEA rythmé, commandes du firmware, acquittements
+ */
+class VirtualReceiver {
+public:
+    VirtualReceiver(NmeaGenerator& generator, int64_t startUtcMs, int fd, unsigned long baud, uint64_t startUs)
+        : generator(generator), startUtcMs(startUtcMs), fd(fd), byteUs(10e6 / baud), startUs(startUs), wireClockUs(startUs),
+          queuedBytes(0), sentBytes(0), ubxState(0), ubxLength(0), inNmea(false),
+          acks(0), naks(0), nmeaCommands(0), stalls(0) {}
+
+    /**
+     * @brief Ajoute une époque au flux (à son heure)
+     */
+    void queueEpoch(const std::string& epoch, double timeS, const TrackPoint& point) {
+        uint64_t now = SerialPort::monotonicUs();
+        if (pending.empty()) {
+            wireClockUs = std::max(wireClockUs, now);  // Idle line
+        }
+        SentEpoch sent;
+        sent.timeS = timeS;
+        sent.latitude = point.latitude;
+        sent.longitude = point.longitude;
+        sent.startOffset = queuedBytes;
+        sent.endOffset = queuedBytes + epoch.size();
+        sent.firstByteUs = 0;
+        sent.lastByteUs = 0;
+        epochs.push_back(sent);
+        queue(epoch.data(), epoch.size());
+    }
+
+    /**
+     * @brief Envoie les octets dus au débit de la ligne
+     * @return Heure monotone du prochain octet dû (UINT64_MAX : rien en attente)
+     */
+    uint64_t pump() {
+        if (pending.empty()) {
+            return UINT64_MAX;
+        }
+        uint64_t now = SerialPort::monotonicUs();
+        if (now < wireClockUs) {
+            return wireClockUs;
+        }
+        size_t due = std::min(pending.size(), (size_t)((now - wireClockUs) / byteUs) + 1);
+        ssize_t written = write(fd, pending.data(), due);
+        if (written <= 0) {
+            if (written < 0 && errno != EAGAIN && errno != EINTR && errno != EIO) {
+                fprintf(stderr, "Write error: %s\n", strerror(errno));
+            }
+            stalls++;  // Nobody reads the pseudo-terminal: retry in 1 ms
+            wireClockUs = now + 1000;
+            return wireClockUs;
+        }
+        uint64_t sentTime = SerialPort::monotonicUs();
+        pending.erase(0, (size_t)written);
+        sentBytes += (uint64_t)written;
+        wireClockUs += (uint64_t)(written * byteUs);
+        for (SentEpoch& epoch : epochs) {
+            if (epoch.firstByteUs == 0 && epoch.startOffset < sentBytes) {
+                epoch.firstByteUs = sentTime;
+            }
+            if (epoch.lastByteUs == 0 && epoch.endOffset <= sentBytes) {
+                epoch.lastByteUs = sentTime;
+                logSend(epoch);
+            }
+        }
+        return pending.empty() ? UINT64_MAX : wireClockUs;
+    }
+
+    /**
+     * @brief Lit les commandes du firmware
+     */
+    void readCommands() {
+        uint8_t buffer[256];
+        for (;;) {
+            ssize_t len = read(fd, buffer, sizeof(buffer));
+            if (len <= 0) {
+                return;
+            }
+            for (ssize_t i = 0; i < len; i++) {
+                parse(buffer[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Époque la plus proche d'une position, commencée avant arrivalUs
+     * @return nullptr si aucune à moins de MATCH_TOLERANCE_M
+     *
+     * @details
+     * Le firmware peut émettre dès la RMC, avant la fin de l'époque : seul
+     * le premier octet est exigé.
+     */
+    const SentEpoch* match(double latitude, double longitude, uint64_t arrivalUs, double& distanceM) const {
+        const SentEpoch* best = nullptr;
+        distanceM = 1e9;
+        double cosLat = cos(latitude * M_PI / 180.0);
+        for (const SentEpoch& epoch : epochs) {
+            if (epoch.firstByteUs == 0 || epoch.firstByteUs > arrivalUs) {
+                continue;
+            }
+            double dy = (epoch.latitude - latitude) * 111195.0;
+            double dx = (epoch.longitude - longitude) * 111195.0 * cosLat;
+            double distance = sqrt(dx * dx + dy * dy);
+            if (distance < distanceM) {
+                distanceM = distance;
+                best = &epoch;
+            }
+        }
+        return (distanceM <= MATCH_TOLERANCE_M) ? best : nullptr;
+    }
+
+    /**
+     * @brief Oublie les époques trop anciennes pour être rapprochées
+     */
+    void forget(uint64_t nowUs) {
+        while (!epochs.empty() && epochs.front().lastByteUs != 0 && epochs.front().lastByteUs + EPOCH_MEMORY_US < nowUs) {
+            epochs.pop_front();
+        }
+    }
+
+    bool idle() const {
+        return pending.empty();
+    }
+
+    void setSendLog(FILE* file) {
+        sendLog = file;
+    }
+
+    void printSummary() const {
+        fprintf(stderr, "virtual_gps: %llu bytes sent, commands %u UBX acknowledged, %u UBX rejected, %u NMEA",
+                (unsigned long long)sentBytes, acks, naks, nmeaCommands);
+        if (stalls > 0) {
+            fprintf(stderr, " | %u stalls (nobody reading)", stalls);
+        }
+        fprintf(stderr, "\n");
+    }
+
+private:
+    NmeaGenerator& generator;
+    int64_t startUtcMs;
+    int fd;
+    double byteUs;
+    uint64_t startUs;
+    uint64_t wireClockUs;           // Time the next byte leaves
+    std::string pending;
+    uint64_t queuedBytes;
+    uint64_t sentBytes;
+    std::deque<SentEpoch> epochs;
+    FILE* sendLog = nullptr;
+
+    uint8_t ubxState;               // 0 idle, 1 sync 2, 2 header, 3 payload + checksum
+    uint8_t ubxHeader[4];
+    size_t ubxLength;
+    std::vector<uint8_t> ubxFrame;
+    bool inNmea;
+    std::string nmeaLine;
+
+    uint32_t acks;
+    uint32_t naks;
+    uint32_t nmeaCommands;
+    uint32_t stalls;
+
+    void queue(const void* data, size_t len) {
+        pending.append((const char*)data, len);
+        queuedBytes += len;
+    }
+
+    void logSend(const SentEpoch& epoch) {
+        if (sendLog == nullptr) {
+            return;
+        }
+        // Monotonic to wall clock, for comparison with other tools
+        uint64_t offset = realtimeUs() - SerialPort::monotonicUs();
+        fprintf(sendLog, "%lld %llu %llu %llu %.7f %.7f\n",
+                (long long)(startUtcMs + llround(epoch.timeS * 1000)),
+                (unsigned long long)(epoch.firstByteUs + offset), (unsigned long long)(epoch.lastByteUs + offset),
+                (unsigned long long)(epoch.endOffset - epoch.startOffset), epoch.latitude, epoch.longitude);
+    }
+
+    void logCommand(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        fprintf(stderr, "[%10.6f] ", (SerialPort::monotonicUs() - startUs) / 1e6);
+        va_list args;
+        va_start(args, format);
+        vfprintf(stderr, format, args);
+        va_end(args);
+        fprintf(stderr, "\n");
+    }
+
+    void parse(uint8_t c) {
+        switch (ubxState) {
+            case 1:
+                ubxState = (c == 0x62) ? 2 : 0;
+                ubxFrame.clear();
+                return;
+            case 2:
+                ubxHeader[ubxFrame.size()] = c;
+                ubxFrame.push_back(c);
+                if (ubxFrame.size() == 4) {
+                    ubxLength = ubxHeader[2] | (ubxHeader[3] << 8);
+                    ubxState = (ubxLength <= MAX_UBX_PAYLOAD) ? 3 : 0;
+                }
+                return;
+            case 3:
+                ubxFrame.push_back(c);
+                if (ubxFrame.size() == 4 + ubxLength + 2) {
+                    ubxState = 0;
+                    handleUbx();
+                }
+                return;
+            default:
+                break;
+        }
+        if (c == 0xB5) {
+            ubxState = 1;
+            inNmea = false;
+        } else if (c == '$') {
+            inNmea = true;
+            nmeaLine.assign(1, '$');
+        } else if (inNmea) {
+            if (c == '\r' || c == '\n') {
+                inNmea = false;
+                handleNmea();
+            } else if (nmeaLine.size() < 120) {
+                nmeaLine += (char)c;
+            }
+        }
+    }
+
+    /**
+     * @brief Commande UBX : CFG acquittée (ACK-ACK) si prise en charge, sinon ACK-NAK
+     */
+    void handleUbx() {
+        uint8_t ckA = 0;
+        uint8_t ckB = 0;
+        for (size_t i = 0; i < 4 + ubxLength; i++) {
+            ckA += ubxFrame[i];
+            ckB += ckA;
+        }
+        uint8_t cls = ubxFrame[0];
+        uint8_t id = ubxFrame[1];
+        if (ckA != ubxFrame[4 + ubxLength] || ckB != ubxFrame[5 + ubxLength]) {
+            logCommand("UBX %02X-%02X bad checksum, ignored", cls, id);
+            return;
+        }
+        if (cls != 0x06) {
+            logCommand("UBX %02X-%02X (%zu bytes) ignored", cls, id, ubxLength);
+            return;
+        }
+
+        const uint8_t* payload = ubxFrame.data() + 4;
+        bool accepted = true;
+        if (id == 0x08 && ubxLength >= 2) {
+            uint16_t measRate = payload[0] | (payload[1] << 8);
+            accepted = (measRate >= 20);
+            if (accepted) {
+                generator.setPeriodMs(measRate);
+            }
+            logCommand("UBX CFG-RATE %u ms", measRate);
+        } else if (id == 0x01 && (ubxLength == 3 || ubxLength == 8) && payload[0] == 0xF0) {
+            uint8_t rate = (ubxLength == 3) ? payload[2] : payload[3];  // 8 bytes: rate per port, UART1 second
+            uint16_t sentence = 0;
+            for (const auto& entry : UBX_NMEA_IDS) {
+                if (entry.id == payload[1]) {
+                    sentence = entry.sentence;
+                }
+            }
+            if (sentence != 0) {
+                uint16_t mask = generator.getSentences();
+                generator.setSentences(rate > 0 ? (mask | sentence) : (mask & ~sentence));
+            }
+            logCommand("UBX CFG-MSG F0-%02X rate %u", payload[1], rate);
+        } else if (id == 0x01) {
+            logCommand("UBX CFG-MSG %02X-%02X (not NMEA, no effect)", payload[0], ubxLength > 1 ? payload[1] : 0);
+        } else if (ubxLength > 0 && (id == 0x00 || id == 0x04 || id == 0x09 || id == 0x11 || id == 0x24 || id == 0x3B)) {
+            logCommand("UBX CFG %02X (%zu bytes, accepted, no effect)", id, ubxLength);
+        } else {
+            accepted = false;
+            logCommand("UBX CFG %02X (%zu bytes, %s)", id, ubxLength, ubxLength == 0 ? "poll not supported" : "unsupported");
+        }
+
+        uint8_t ack[10] = {0xB5, 0x62, 0x05, (uint8_t)(accepted ? 0x01 : 0x00), 0x02, 0x00, cls, id, 0, 0};
+        for (int i = 2; i < 8; i++) {
+            ack[8] += ack[i];
+            ack[9] += ack[8];
+        }
+        queue(ack, sizeof(ack));
+        if (accepted) {
+            acks++;
+        } else {
+            naks++;
+        }
+    }
+
+    /**
+     * @brief Commande NMEA CASIC ($PCAS) : appliquée, sans réponse (le protocole n'en a pas)
+     */
+    void handleNmea() {
+        size_t star = nmeaLine.find('*');
+        if (star == std::string::npos || star + 3 > nmeaLine.size()) {
+            logCommand("NMEA %s (no checksum, ignored)", nmeaLine.c_str());
+            return;
+        }
+        uint8_t checksum = 0;
+        for (size_t i = 1; i < star; i++) {
+            checksum ^= (uint8_t)nmeaLine[i];
+        }
+        if (strtoul(nmeaLine.substr(star + 1, 2).c_str(), nullptr, 16) != checksum) {
+            logCommand("NMEA %s (bad checksum, ignored)", nmeaLine.c_str());
+            return;
+        }
+        nmeaCommands++;
+        std::string body = nmeaLine.substr(1, star - 1);
+        if (body.compare(0, 7, "PCAS02,") == 0) {
+            unsigned long periodMs = strtoul(body.c_str() + 7, nullptr, 10);
+            if (periodMs >= 20) {
+                generator.setPeriodMs((uint32_t)periodMs);
+            }
+            logCommand("NMEA %s: period %lu ms", nmeaLine.c_str(), periodMs);
+        } else if (body.compare(0, 7, "PCAS03,") == 0) {
+            uint16_t mask = generator.getSentences();
+            size_t position = 7;
+            for (uint16_t sentence : PCAS03_FIELDS) {
+                size_t comma = body.find(',', position);
+                std::string field = body.substr(position, comma == std::string::npos ? std::string::npos : comma - position);
+                if (!field.empty()) {  // Empty field: unchanged
+                    mask = (strtoul(field.c_str(), nullptr, 10) > 0) ? (mask | sentence) : (mask & ~sentence);
+                }
+                if (comma == std::string::npos) {
+                    break;
+                }
+                position = comma + 1;
+            }
+            generator.setSentences(mask);
+            logCommand("NMEA %s: sentences 0x%02X", nmeaLine.c_str(), mask);
+        } else {
+            logCommand("NMEA %s (no effect)", nmeaLine.c_str());
+        }
+    }
+};
+
+/**
+ * @brief Pseudo-terminal : le maître pour l'outil, l'esclave pour le firmware
+ * @return Descripteur du maître, -1 en cas d'erreur
+ */
+static int openPseudoTerminal(const char* linkPath, int& slaveFd) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        perror("posix_openpt");
+        return -1;
+    }
+    const char* slavePath = ptsname(master);
+    // Kept open: no hangup when the firmware closes or restarts; raw mode, no echo of its commands
+    slaveFd = open(slavePath, O_RDWR | O_NOCTTY);
+    if (slaveFd < 0 || !SerialPort::configure(slaveFd, 9600)) {
+        fprintf(stderr, "Cannot configure %s\n", slavePath);
+        return -1;
+    }
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+    unlink(linkPath);
+    if (symlink(slavePath, linkPath) != 0) {
+        fprintf(stderr, "Cannot link %s: %s\n", linkPath, strerror(errno));
+    }
+    fprintf(stderr, "virtual_gps: %s -> %s\n", linkPath, slavePath);
+    return master;
+}
+
+int main(int argc, char** argv) {
+    NmeaGenOptions options;
+    const char* linkPath = DEFAULT_LINK;
+    const char* serialPath = nullptr;
+    const char* sendLogPath = nullptr;
+    const char* radioAddress = nullptr;
+    const char* latencyLogPath = nullptr;
+    unsigned long baud = 9600;
+    double reportS = 10;
+    double durationS = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        int parsed = options.parse(argc, argv, i);
+        if (parsed < 0) {
+            fprintf(stderr, "Bad value for %s\n", arg);
+            usage(argv[0], 1);
+        } else if (parsed > 0) {
+            continue;
+        } else if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            usage(argv[0], 0);
+        } else if (strcmp(arg, "--link") == 0 && hasValue) {
+            linkPath = argv[++i];
+        } else if (strcmp(arg, "--serial") == 0 && hasValue) {
+            serialPath = argv[++i];
+        } else if (strcmp(arg, "--baud") == 0 && hasValue) {
+            baud = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(arg, "--send-log") == 0 && hasValue) {
+            sendLogPath = argv[++i];
+        } else if (strcmp(arg, "--radio-udp") == 0 && hasValue) {
+            radioAddress = argv[++i];
+        } else if (strcmp(arg, "--latency-log") == 0 && hasValue) {
+            latencyLogPath = argv[++i];
+        } else if (strcmp(arg, "--report") == 0 && hasValue) {
+            reportS = atof(argv[++i]);
+        } else if (strcmp(arg, "--duration") == 0 && hasValue) {
+            durationS = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            usage(argv[0], 1);
+        }
+    }
+    if (baud == 0 || reportS <= 0) {
+        usage(argv[0], 1);
+    }
+
+    Trajectory trajectory;
+    NmeaGenerator generator(trajectory);
+    if (!options.apply(trajectory, generator)) {
+        return 1;
+    }
+
+    int slaveFd = -1;
+    int fd = (serialPath != nullptr) ? SerialPort::open(serialPath, baud, O_RDWR | O_NONBLOCK)
+                                     : openPseudoTerminal(linkPath, slaveFd);
+    if (fd < 0) {
+        return 1;
+    }
+    FILE* sendLog = nullptr;
+    FILE* latencyLog = nullptr;
+    if (sendLogPath != nullptr && (sendLog = fopen(sendLogPath, "w")) == nullptr) {
+        fprintf(stderr, "Cannot create %s: %s\n", sendLogPath, strerror(errno));
+        return 1;
+    }
+    if (latencyLogPath != nullptr && (latencyLog = fopen(latencyLogPath, "w")) == nullptr) {
+        fprintf(stderr, "Cannot create %s: %s\n", latencyLogPath, strerror(errno));
+        return 1;
+    }
+    UdpRadio radio;
+    if (radioAddress != nullptr && !radio.open(radioAddress)) {
+        return 1;
+    }
+    signal(SIGINT, onInterrupt);
+    signal(SIGTERM, onInterrupt);
+
+    uint64_t startUs = SerialPort::monotonicUs();
+    VirtualReceiver receiver(generator, trajectory.getStartUtcMs(), fd, baud, startUs);
+    receiver.setSendLog(sendLog);
+    LatencyStats window;
+    LatencyStats total;
+    uint64_t nextReportUs = startUs + (uint64_t)(reportS * 1e6);
+    uint64_t endUs = (durationS > 0) ? startUs + (uint64_t)(durationS * 1e6) : UINT64_MAX;
+
+    std::string epoch;
+    double timeS = 0;
+    bool hasEpoch = generator.next(epoch, timeS);
+    uint64_t lastEpochUs = startUs;
+    while (!interrupted) {
+        uint64_t now = SerialPort::monotonicUs();
+        if (now >= endUs) {
+            break;
+        }
+        if (hasEpoch && now >= startUs + (uint64_t)(timeS * 1e6)) {
+            receiver.queueEpoch(epoch, timeS, generator.getLastPoint());
+            lastEpochUs = now;
+            hasEpoch = generator.next(epoch, timeS);
+        }
+        if (!hasEpoch && durationS <= 0 && receiver.idle() && now > lastEpochUs + LINGER_US) {
+            break;
+        }
+        uint64_t wakeUs = std::min(receiver.pump(), nextReportUs);
+        if (hasEpoch) {
+            wakeUs = std::min(wakeUs, startUs + (uint64_t)(timeS * 1e6));
+        }
+
+        receiver.readCommands();
+        SimFrame frame;
+        while (radio.poll(now, frame)) {
+            GPSBroadcastPacket packet;
+            if (BoatCodec::decode(frame.data, frame.len, packet) != DECODE_OK) {
+                continue;  // Other message types
+            }
+            uint64_t arrivalUs = SerialPort::monotonicUs();
+            double distanceM;
+            const SentEpoch* matched = receiver.match(packet.latitude, packet.longitude, arrivalUs, distanceM);
+            if (matched == nullptr) {
+                window.unmatched++;
+                total.unmatched++;
+                continue;
+            }
+            uint32_t latencyUs = (uint32_t)(arrivalUs - matched->firstByteUs);  // Line time of the fix included
+            window.samples.push_back(latencyUs);
+            total.samples.push_back(latencyUs);
+            if (latencyLog != nullptr) {
+                fprintf(latencyLog, "%.6f %lu %.2f %u %.2f\n", (arrivalUs - startUs) / 1e6,
+                        (unsigned long)packet.sequenceNumber, matched->timeS, latencyUs, distanceM);
+            }
+        }
+        receiver.forget(now);
+
+        if (now >= nextReportUs) {
+            if (radioAddress != nullptr) {
+                window.print("latency");
+            }
+            window = LatencyStats();
+            nextReportUs += (uint64_t)(reportS * 1e6);
+        }
+
+        // Sleep until the next byte, epoch or report, woken by a command or a frame
+        struct pollfd fds[2] = {{fd, POLLIN, 0}, {radio.getFd(), POLLIN, 0}};
+        now = SerialPort::monotonicUs();
+        if (wakeUs > now) {
+            uint64_t waitUs = std::min(wakeUs - now, (uint64_t)100000);
+            struct timespec timeout = {(time_t)(waitUs / 1000000), (long)(waitUs % 1000000) * 1000};
+            ppoll(fds, radioAddress != nullptr ? 2 : 1, &timeout, nullptr);
+        }
+    }
+
+    receiver.printSummary();
+    if (radioAddress != nullptr) {
+        total.print("virtual_gps latency");
+    }
+    if (sendLog != nullptr) {
+        fclose(sendLog);
+    }
+    if (latencyLog != nullptr) {
+        fclose(latencyLog);
+    }
+    if (serialPath == nullptr) {
+        unlink(linkPath);
+        close(slaveFd);
+    }
+    close(fd);
+    return 0;
+}